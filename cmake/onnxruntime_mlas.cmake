@@ -16,6 +16,8 @@ onnxruntime_add_static_library(onnxruntime_mlas
   ${MLAS_SRC_DIR}/threading.cpp
   ${MLAS_SRC_DIR}/sgemm.cpp
   ${MLAS_SRC_DIR}/halfgemm.cpp
+  ${MLAS_SRC_DIR}/sparsegemm.cpp
+  ${MLAS_SRC_DIR}/sbgemm.cpp
   ${MLAS_SRC_DIR}/qgemm.cpp
   ${MLAS_SRC_DIR}/qdwconv.cpp
   ${MLAS_SRC_DIR}/convolve.cpp
@@ -26,6 +28,7 @@ onnxruntime_add_static_library(onnxruntime_mlas
   ${MLAS_SRC_DIR}/snchwc.cpp
   ${MLAS_SRC_DIR}/activate.cpp
   ${MLAS_SRC_DIR}/logistic.cpp
+  ${MLAS_SRC_DIR}/transcendental.cpp
   ${MLAS_SRC_DIR}/tanh.cpp
   ${MLAS_SRC_DIR}/erf.cpp
   ${MLAS_SRC_DIR}/compute.cpp
@@ -168,8 +171,16 @@ function(setup_mlas_source_for_windows)
 
     target_sources(onnxruntime_mlas PRIVATE
       ${MLAS_SRC_DIR}/dgemm.cpp
+      ${MLAS_SRC_DIR}/sgemm_jit.cpp
       ${mlas_platform_srcs_avx}
       ${mlas_platform_srcs_avx2}
+      ${MLAS_SRC_DIR}/halfgemm_kernel_avx2.cpp
+      ${MLAS_SRC_DIR}/sparsegemm_kernel_avx2.cpp
+      ${MLAS_SRC_DIR}/sparsegemm_kernel_avx512f.cpp
+      ${MLAS_SRC_DIR}/sgemm_small_kernel_avx2.cpp
+      ${MLAS_SRC_DIR}/sgemm_small_kernel_avx512f.cpp
+      ${MLAS_SRC_DIR}/transcendental_kernel_avx2.cpp
+      ${MLAS_SRC_DIR}/transcendental_kernel_avx512f.cpp
       ${MLAS_SRC_DIR}/qgemm_kernel_amx.cpp
       ${MLAS_SRC_DIR}/qgemm_kernel_avx2.cpp
       ${MLAS_SRC_DIR}/qgemm_kernel_sse.cpp
@@ -178,6 +189,7 @@ function(setup_mlas_source_for_windows)
       ${MLAS_SRC_DIR}/sqnbitgemm_kernel_avx2.cpp
       ${MLAS_SRC_DIR}/sqnbitgemm_kernel_avx512.cpp
       ${MLAS_SRC_DIR}/sqnbitgemm_kernel_avx512vnni.cpp
+      ${MLAS_SRC_DIR}/sqnbitgemm_kernel_amx.cpp
       ${MLAS_SRC_DIR}/amd64/QgemmU8S8KernelAmx.asm
       ${MLAS_SRC_DIR}/amd64/QgemmU8S8KernelAvx2.asm
       ${MLAS_SRC_DIR}/amd64/QgemmU8U8KernelAvx2.asm
@@ -572,6 +584,10 @@ else()
           ${MLAS_SRC_DIR}/intrinsics/avx2/qladd_avx2.cpp
           ${MLAS_SRC_DIR}/intrinsics/avx2/qdwconv_avx2.cpp
           ${MLAS_SRC_DIR}/sqnbitgemm_kernel_avx2.cpp
+          ${MLAS_SRC_DIR}/halfgemm_kernel_avx2.cpp
+          ${MLAS_SRC_DIR}/sparsegemm_kernel_avx2.cpp
+          ${MLAS_SRC_DIR}/sgemm_small_kernel_avx2.cpp
+          ${MLAS_SRC_DIR}/transcendental_kernel_avx2.cpp
         )
         if(CMAKE_CXX_COMPILER_VERSION GREATER_EQUAL 13.1 AND NOT(APPLE))
           set(mlas_platform_srcs_avx2
@@ -598,6 +614,9 @@ endif()
           ${MLAS_SRC_DIR}/x86_64/SpoolKernelAvx512F.S
           ${MLAS_SRC_DIR}/x86_64/TransKernelAvx512F.S
           ${MLAS_SRC_DIR}/intrinsics/avx512/quantize_avx512f.cpp
+          ${MLAS_SRC_DIR}/sparsegemm_kernel_avx512f.cpp
+          ${MLAS_SRC_DIR}/sgemm_small_kernel_avx512f.cpp
+          ${MLAS_SRC_DIR}/transcendental_kernel_avx512f.cpp
         )
         set_source_files_properties(${mlas_platform_srcs_avx512f} PROPERTIES COMPILE_FLAGS "-mavx512f")
 
@@ -620,6 +639,7 @@ endif()
           ${MLAS_SRC_DIR}/dwconv.cpp
           ${MLAS_SRC_DIR}/dgemm.cpp
           ${MLAS_SRC_DIR}/pooling_fp16.cpp
+          ${MLAS_SRC_DIR}/sgemm_jit.cpp
           ${MLAS_SRC_DIR}/qgemm_kernel_avx2.cpp
           ${mlas_platform_srcs_sse2}
           ${mlas_platform_srcs_avx}
@@ -642,10 +662,32 @@ endif()
 	        ${MLAS_SRC_DIR}/x86_64/QgemmU8S8KernelAmxCommon.S
             ${MLAS_SRC_DIR}/qgemm_kernel_amx.cpp
             ${MLAS_SRC_DIR}/x86_64/QgemmU8S8KernelAmx.S
+            ${MLAS_SRC_DIR}/sqnbitgemm_kernel_amx.cpp
             )
           set_source_files_properties(${MLAS_SRC_DIR}/qgemm_kernel_amx.cpp PROPERTIES COMPILE_FLAGS "-mavx2 -mavx512bw -mavx512dq -mavx512vl -mavx512f")
+          set_source_files_properties(${MLAS_SRC_DIR}/sqnbitgemm_kernel_amx.cpp PROPERTIES COMPILE_FLAGS "-mavx2 -mavx512bw -mavx512dq -mavx512vl -mavx512f")
           set_source_files_properties(${MLAS_SRC_DIR}/x86_64/QgemmU8S8KernelAmx.S PROPERTIES COMPILE_FLAGS "-mavx2 -mavx512bw -mavx512dq -mavx512vl -mavx512f")
         endif()
+        if(NOT APPLE AND (NOT "${CMAKE_CXX_COMPILER_ID}" STREQUAL "GNU" OR CMAKE_CXX_COMPILER_VERSION VERSION_GREATER_EQUAL "10"))
+          set(mlas_platform_srcs
+            ${mlas_platform_srcs}
+            ${MLAS_SRC_DIR}/sbgemm_kernel_avx512bf16.cpp
+            ${MLAS_SRC_DIR}/sbgemm_kernel_amx.cpp
+            )
+          set_source_files_properties(${MLAS_SRC_DIR}/sbgemm_kernel_avx512bf16.cpp PROPERTIES COMPILE_FLAGS "-mavx512f -mavx512bw -mavx512dq -mavx512vl -mavx512bf16")
+          set_source_files_properties(${MLAS_SRC_DIR}/sbgemm_kernel_amx.cpp PROPERTIES COMPILE_FLAGS "-mavx512f -mavx512bw -mavx512dq -mavx512vl -mavx512bf16")
+          set_property(SOURCE ${MLAS_SRC_DIR}/platform.cpp APPEND PROPERTY COMPILE_DEFINITIONS MLAS_SBGEMM_AVX512BF16_SUPPORTED)
+        endif()
+        # The AVX512-FP16 half gemm kernel is only built by GCC and Clang, MSVC builds use the AVX2 half gemm kernel.
+        if(NOT APPLE AND (("${CMAKE_CXX_COMPILER_ID}" STREQUAL "GNU" AND CMAKE_CXX_COMPILER_VERSION VERSION_GREATER_EQUAL "12") OR
+                          ("${CMAKE_CXX_COMPILER_ID}" MATCHES "Clang" AND CMAKE_CXX_COMPILER_VERSION VERSION_GREATER_EQUAL "14")))
+          set(mlas_platform_srcs
+            ${mlas_platform_srcs}
+            ${MLAS_SRC_DIR}/halfgemm_kernel_avx512fp16.cpp
+            )
+          set_source_files_properties(${MLAS_SRC_DIR}/halfgemm_kernel_avx512fp16.cpp PROPERTIES COMPILE_FLAGS "-mavx512f -mavx512bw -mavx512dq -mavx512vl -mavx512fp16")
+          set_property(SOURCE ${MLAS_SRC_DIR}/platform.cpp APPEND PROPERTY COMPILE_DEFINITIONS MLAS_HALFGEMM_AVX512FP16_SUPPORTED)
+        endif()
 
         if(ONNXRUNTIME_MLAS_MULTI_ARCH)
           onnxruntime_add_static_library(onnxruntime_mlas_x86_64 ${mlas_platform_srcs})
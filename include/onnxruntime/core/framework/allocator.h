@@ -20,16 +20,21 @@ struct OrtArenaCfg {
                   initial_chunk_size_bytes(-1),
                   max_dead_bytes_per_chunk(-1),
                   initial_growth_chunk_size_bytes(-1),
-                  max_power_of_two_extend_bytes(-1) {}
+                  max_power_of_two_extend_bytes(-1),
+                  thread_cache_max_block_size(-1),
+                  idle_shrink_ms(-1) {}
   OrtArenaCfg(size_t max_mem, int arena_extend_strategy, int initial_chunk_size_bytes,
               int max_dead_bytes_per_chunk, int initial_growth_chunk_size_bytes,
-              int64_t max_power_of_two_extend_bytes)
+              int64_t max_power_of_two_extend_bytes, int64_t thread_cache_max_block_size = -1,
+              int64_t idle_shrink_ms = -1)
       : max_mem(max_mem),
         arena_extend_strategy(arena_extend_strategy),
         initial_chunk_size_bytes(initial_chunk_size_bytes),
         max_dead_bytes_per_chunk(max_dead_bytes_per_chunk),
         initial_growth_chunk_size_bytes(initial_growth_chunk_size_bytes),
-        max_power_of_two_extend_bytes(max_power_of_two_extend_bytes) {}
+        max_power_of_two_extend_bytes(max_power_of_two_extend_bytes),
+        thread_cache_max_block_size(thread_cache_max_block_size),
+        idle_shrink_ms(idle_shrink_ms) {}
 
   size_t max_mem;                         // use 0 to allow ORT to choose the default
   int arena_extend_strategy;              // use -1 to allow ORT to choose the default, 0 = kNextPowerOfTwo, 1 = kSameAsRequested
@@ -37,6 +42,8 @@ struct OrtArenaCfg {
   int max_dead_bytes_per_chunk;           // use -1 to allow ORT to choose the default
   int initial_growth_chunk_size_bytes;    // use -1 to allow ORT to choose the default
   int64_t max_power_of_two_extend_bytes;  // use -1 to allow ORT to choose the default
+  int64_t thread_cache_max_block_size;    // use -1 to allow ORT to choose the default, 0 = no per-thread cache
+  int64_t idle_shrink_ms;                 // use -1 to allow ORT to choose the default, 0 = never release idle regions
 };
 
 namespace onnxruntime {
@@ -129,6 +129,24 @@ class OpKernel {
     return Status::OK();
   }
 
+  // Override this function along with RestorePrePackState() to let the session skip PrePack() when pre-packed
+  // buffers of the weight were saved by an earlier session (see kOrtSessionOptionsPrepackedWeightsCacheFile).
+  // Return a version of the layout of the pre-packed buffers for the input, larger than 0, and change it whenever
+  // PrePack() changes that layout so that buffers saved with the previous one are not used.
+  // @param input_idx: The input index of the tensor in this kernel
+  virtual int GetPrePackFormatVersion(int /*input_idx*/) const {
+    return 0;
+  }
+
+  // Called instead of PrePack() for a weight whose pre-packed buffers are provided by UseSharedPrePackedBuffers()
+  // right after. Set up the state that PrePack() derives from the weight (e.g. its shape) other than the buffers.
+  // Only called if GetPrePackFormatVersion() returns a version for the input.
+  // @param tensor: The initialized constant tensor
+  // @param input_idx: The input index of the tensor in this kernel
+  virtual Status RestorePrePackState(const Tensor& /*tensor*/, int /*input_idx*/) {
+    ORT_NOT_IMPLEMENTED(__FUNCTION__, " is not implemented");
+  }
+
   const OrtDevice GetDevice(OrtMemType mem_type) const;
   const OpKernelInfo& Info() const {
     return *op_kernel_info_;
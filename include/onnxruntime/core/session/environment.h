@@ -5,6 +5,7 @@
 
 #include <atomic>
 #include <memory>
+#include <mutex>
 #include "core/common/common.h"
 #include "core/common/status.h"
 #include "core/platform/threadpool.h"
@@ -13,6 +14,7 @@
 
 struct OrtThreadingOptions;
 namespace onnxruntime {
+class SharedInitializerRegistry;
 /** TODO: remove this class
    Provides the runtime environment for onnxruntime.
    Create one instance for the duration of execution.
@@ -88,6 +90,12 @@ class Environment {
    */
   Status CreateAndRegisterAllocatorV2(const std::string& provider_type, const OrtMemoryInfo& mem_info, const std::unordered_map<std::string, std::string>& options, const OrtArenaCfg* arena_cfg = nullptr);
 
+  /**
+   * Returns the registry deduplicating the initializers of the sessions in this env by content.
+   * Sessions use it if "session.share_initializers_across_sessions" is set.
+   */
+  SharedInitializerRegistry& GetSharedInitializerRegistry() const;
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Environment);
   Status Initialize(std::unique_ptr<logging::LoggingManager> logging_manager,
@@ -99,5 +107,9 @@ class Environment {
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
   bool create_global_thread_pools_{false};
   std::vector<AllocatorPtr> shared_allocators_;
+
+  // created on first use
+  mutable std::mutex shared_initializer_registry_mutex_;
+  mutable std::shared_ptr<SharedInitializerRegistry> shared_initializer_registry_;
 };
 }  // namespace onnxruntime
@@ -305,6 +305,7 @@ ORT_RUNTIME_CLASS(OpAttr);
 ORT_RUNTIME_CLASS(Logger);
 ORT_RUNTIME_CLASS(ShapeInferContext);
 ORT_RUNTIME_CLASS(LoraAdapter);
+ORT_RUNTIME_CLASS(ContinuousBatcher);
 
 #ifdef _WIN32
 typedef _Return_type_success_(return == 0) OrtStatus* OrtStatusPtr;
@@ -2810,6 +2811,13 @@ struct OrtApi {
    *  Use -1 to allow ORT to choose the default 1GB for max_power_of_two_extend_bytes.
    *  Ultimately, the allocation size is determined by the allocation memory request.
    *  Further allocation sizes are governed by the arena extend strategy.
+   * "thread_cache_max_block_size": Allocations up to this size (rounded up to a power of two, at most 64KB) are
+   *  served from per-thread caches in front of the arena so that they don't contend on the arena lock.
+   *  Use 0 or -1 to disable the per-thread caches (the default).
+   * "idle_shrink_ms": Allocation regions of the arena that have not been used for this many milliseconds are
+   *  released by a background thread, so that the memory taken by a spike in usage is returned. A region is released
+   *  after being idle for one to two such windows. The same regions as for arena shrinkage are considered.
+   *  Use 0 or -1 to keep idle regions (the default).
    *
    * \param[in] arena_config_keys Keys to configure the arena
    * \param[in] arena_config_values Values to configure the arena
@@ -4756,6 +4764,126 @@ struct OrtApi {
    */
   ORT_API2_STATUS(SetEpDynamicOptions, _Inout_ OrtSession* sess, _In_reads_(kv_len) const char* const* keys,
                   _In_reads_(kv_len) const char* const* values, _In_ size_t kv_len);
+
+  /// @}
+  /// \name OrtContinuousBatcher
+  /// @{
+
+  /** \brief Create an OrtContinuousBatcher
+   *
+   * The continuous batcher generates tokens greedily for many prompts with a decoder-only model on CPU. The
+   * requests join the batch as soon as a slot is free and leave it as soon as they are finished, between decoding
+   * steps, instead of running a fixed batch from the first to the last token.
+   *
+   * The model inputs shall be input_ids, attention_mask, optionally position_ids, and past_key_values.<i>.key /
+   * past_key_values.<i>.value of shape (batch_size, kv_num_heads, past_sequence_length, head_size), with the
+   * outputs logits and present.<i>.key / present.<i>.value. The present state is bound to the buffer of the
+   * past state, which GroupQueryAttention updates in place. The attention mask of each row is right padded.
+   *
+   * \param[in] session Session of the model. It must outlive the OrtContinuousBatcher.
+   * \param[in] max_slots Maximum number of requests decoded together.
+   * \param[in] max_length Maximum number of tokens of a request, prompt included. The KV cache holds
+   *            max_slots * max_length tokens.
+   * \param[in] eos_token_id The generation of a request stops after this token. -1 if there is none.
+   * \param[out] out A pointer to a newly created OrtContinuousBatcher instance. Must be released with
+   *                  OrtApi::ReleaseContinuousBatcher.
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   */
+  ORT_API2_STATUS(CreateContinuousBatcher, _In_ OrtSession* session, _In_ size_t max_slots, _In_ size_t max_length,
+                  _In_ int64_t eos_token_id, _Outptr_ OrtContinuousBatcher** out);
+
+  /** \brief Release an ::OrtContinuousBatcher obtained from OrtApi::CreateContinuousBatcher
+   */
+  ORT_CLASS_RELEASE(ContinuousBatcher);
+
+  /** \brief Queue a prompt
+   *
+   * Can be called from any thread, including while OrtApi::ContinuousBatcherStep runs.
+   *
+   * \param[in] batcher OrtContinuousBatcher instance
+   * \param[in] prompt Token ids of the prompt.
+   * \param[in] prompt_length Number of tokens of the prompt, less than max_length.
+   * \param[in] max_new_tokens Maximum number of tokens generated for the prompt.
+   * \param[out] request_id Id of the request in the tokens returned by OrtApi::ContinuousBatcherStep.
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   */
+  ORT_API2_STATUS(ContinuousBatcherEnqueue, _Inout_ OrtContinuousBatcher* batcher,
+                  _In_reads_(prompt_length) const int32_t* prompt, _In_ size_t prompt_length,
+                  _In_ size_t max_new_tokens, _Out_ int64_t* request_id);
+
+  /** \brief Cancel a request
+   *
+   * A queued request is removed, an active request leaves its slot at the start of the next step.
+   * Can be called from any thread.
+   *
+   * \param[in] batcher OrtContinuousBatcher instance
+   * \param[in] request_id Id returned by OrtApi::ContinuousBatcherEnqueue.
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   */
+  ORT_API2_STATUS(ContinuousBatcherCancel, _Inout_ OrtContinuousBatcher* batcher, _In_ int64_t request_id);
+
+  /** \brief Run one generation step
+   *
+   * Decodes one token for each active request in one batch, then admits queued requests into the slots that
+   * were free at the start of the step and runs their prompts, which yields their first token. A slot freed by the
+   * decoding step is reused by the next step, so at most one token per slot, max_slots tokens in total, is returned.
+   * Must not be called concurrently for the same batcher.
+   *
+   * \param[in] batcher OrtContinuousBatcher instance
+   * \param[out] request_ids Buffer of max_slots elements, receives the request of each token.
+   * \param[out] tokens Buffer of max_slots elements, receives the tokens.
+   * \param[out] finished Buffer of max_slots elements, set to 1 for the last token of a request and 0 otherwise.
+   * \param[out] num_tokens Number of tokens returned.
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   */
+  ORT_API2_STATUS(ContinuousBatcherStep, _Inout_ OrtContinuousBatcher* batcher, _Out_ int64_t* request_ids,
+                  _Out_ int32_t* tokens, _Out_ int* finished, _Out_ size_t* num_tokens);
+
+  /** \brief Get the number of queued and active requests
+   *
+   * \param[in] batcher OrtContinuousBatcher instance
+   * \param[out] out Number of requests that are not finished yet.
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   */
+  ORT_API2_STATUS(ContinuousBatcherGetRequestCount, _In_ const OrtContinuousBatcher* batcher, _Out_ size_t* out);
+
+  /// @}
+  /// \name OrtSession
+  /// @{
+
+  /** \brief Get the statistics of the dynamic batching of OrtApi::RunAsync requests
+   *
+   * Dynamic batching is enabled with the "session.dynamic_batching.max_batch_size" session config entry.
+   * The histograms are written to the given buffers. Entries beyond the length of a histogram are set to 0 and the
+   * buckets that don't fit in a buffer are not returned.
+   *
+   * \param[in] session OrtSession instance
+   * \param[out] num_requests Number of requests run.
+   * \param[out] num_batches Number of batches run.
+   * \param[out] num_unbatched_requests Number of requests run on their own because they could not be batched.
+   * \param[out] batch_size_histogram Buffer receiving the number of batches per number of rows along the batch
+   *              axis, from 0 to the maximum batch size. May be nullptr if batch_size_histogram_length is 0.
+   * \param[in] batch_size_histogram_length Number of elements of batch_size_histogram.
+   * \param[out] queue_delay_histogram Buffer receiving the number of requests that waited less than 1 us before
+   *              their batch started in the first bucket and [2^(i-1), 2^i) us in bucket i. The histogram has 25
+   *              buckets, the last one holds all longer delays. May be nullptr if queue_delay_histogram_length is 0.
+   * \param[in] queue_delay_histogram_length Number of elements of queue_delay_histogram.
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   */
+  ORT_API2_STATUS(SessionGetDynamicBatchingStats, _In_ const OrtSession* session, _Out_ int64_t* num_requests,
+                  _Out_ int64_t* num_batches, _Out_ int64_t* num_unbatched_requests,
+                  _Out_writes_(batch_size_histogram_length) int64_t* batch_size_histogram,
+                  _In_ size_t batch_size_histogram_length,
+                  _Out_writes_(queue_delay_histogram_length) int64_t* queue_delay_histogram,
+                  _In_ size_t queue_delay_histogram_length);
+
+  /// @}
 };
 
 /*
@@ -509,6 +509,7 @@ ORT_DEFINE_RELEASE(ThreadingOptions);
 ORT_DEFINE_RELEASE(Env);
 ORT_DEFINE_RELEASE(RunOptions);
 ORT_DEFINE_RELEASE(LoraAdapter);
+ORT_DEFINE_RELEASE(ContinuousBatcher);
 ORT_DEFINE_RELEASE(Session);
 ORT_DEFINE_RELEASE(SessionOptions);
 ORT_DEFINE_RELEASE(TensorTypeAndShapeInfo);
@@ -1184,6 +1185,34 @@ struct Session : detail::SessionImpl<OrtSession> {
   UnownedSession GetUnowned() const { return UnownedSession{this->p_}; }
 };
 
+/** \brief Wrapper around ::OrtContinuousBatcher
+ *
+ * Greedy generation with continuous batching over a decoder-only model with a static KV cache.
+ */
+struct ContinuousBatcher : detail::Base<OrtContinuousBatcher> {
+  using Base = detail::Base<OrtContinuousBatcher>;
+  using Base::Base;
+
+  /// A token returned by Step
+  struct Token {
+    int64_t request_id;
+    int32_t token;
+    bool finished;  ///< The last token of the request
+  };
+
+  explicit ContinuousBatcher(std::nullptr_t) {}  ///< Create an empty ContinuousBatcher object, must be assigned a valid one to be used
+  ContinuousBatcher(Session& session, size_t max_slots, size_t max_length,
+                    int64_t eos_token_id);  ///< Wraps OrtApi::CreateContinuousBatcher
+
+  int64_t Enqueue(const int32_t* prompt, size_t prompt_length, size_t max_new_tokens);  ///< Wraps OrtApi::ContinuousBatcherEnqueue
+  void Cancel(int64_t request_id);                                                      ///< Wraps OrtApi::ContinuousBatcherCancel
+  std::vector<Token> Step();                                                            ///< Wraps OrtApi::ContinuousBatcherStep
+  size_t GetRequestCount() const;                                                       ///< Wraps OrtApi::ContinuousBatcherGetRequestCount
+
+ private:
+  size_t max_slots_{};
+};
+
 namespace detail {
 template <typename T>
 struct MemoryInfoImpl : Base<T> {
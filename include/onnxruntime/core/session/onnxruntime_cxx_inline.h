@@ -1144,6 +1144,43 @@ inline Session::Session(const Env& env, const void* model_data, size_t model_dat
                                                                             prepacked_weights_container, &this->p_));
 }
 
+inline ContinuousBatcher::ContinuousBatcher(Session& session, size_t max_slots, size_t max_length,
+                                            int64_t eos_token_id)
+    : max_slots_{max_slots} {
+  ThrowOnError(GetApi().CreateContinuousBatcher(session, max_slots, max_length, eos_token_id, &this->p_));
+}
+
+inline int64_t ContinuousBatcher::Enqueue(const int32_t* prompt, size_t prompt_length, size_t max_new_tokens) {
+  int64_t request_id;
+  ThrowOnError(GetApi().ContinuousBatcherEnqueue(this->p_, prompt, prompt_length, max_new_tokens, &request_id));
+  return request_id;
+}
+
+inline void ContinuousBatcher::Cancel(int64_t request_id) {
+  ThrowOnError(GetApi().ContinuousBatcherCancel(this->p_, request_id));
+}
+
+inline std::vector<ContinuousBatcher::Token> ContinuousBatcher::Step() {
+  std::vector<int64_t> request_ids(max_slots_);
+  std::vector<int32_t> tokens(max_slots_);
+  std::vector<int> finished(max_slots_);
+  size_t num_tokens = 0;
+  ThrowOnError(GetApi().ContinuousBatcherStep(this->p_, request_ids.data(), tokens.data(), finished.data(),
+                                              &num_tokens));
+  std::vector<Token> result;
+  result.reserve(num_tokens);
+  for (size_t i = 0; i < num_tokens; ++i) {
+    result.push_back({request_ids[i], tokens[i], finished[i] != 0});
+  }
+  return result;
+}
+
+inline size_t ContinuousBatcher::GetRequestCount() const {
+  size_t out;
+  ThrowOnError(GetApi().ContinuousBatcherGetRequestCount(this->p_, &out));
+  return out;
+}
+
 inline AllocatedStringPtr ModelMetadata::GetProducerNameAllocated(OrtAllocator* allocator) const {
   char* out;
   ThrowOnError(GetApi().ModelMetadataGetProducerName(p_, allocator, &out));
@@ -20,6 +20,53 @@
 // If the config value is set to "1" then the prepacking is disabled, otherwise prepacking is enabled (default value)
 static const char* const kOrtSessionOptionsConfigDisablePrepacking = "session.disable_prepacking";
 
+// Path of a file used to persist the weights pre-packed by the CPU kernels (see OpKernel::PrePack) across sessions.
+// If the file exists and was created by the same ORT version on a machine with the same CPU features, the pre-packed
+// weights are memory-mapped from it instead of being packed again, which reduces the session start-up time and lets
+// the sessions using the file share their memory. Otherwise the weights are pre-packed as usual and the file is
+// (re)written once the session state is finalized.
+// Only the kernels that can restore their state without PrePack use the file (e.g. MatMul and Gemm for float).
+// The weights are looked up by the path, size and modification time of the model file and the name and shape of the
+// initializer, so the file must be deleted if the weights change without the model file changing (e.g. when they are
+// stored as external data).
+// Weights shared via a user supplied PrepackedWeightsContainer are not written to the file.
+// The default is an empty string, which disables the cache.
+static const char* const kOrtSessionOptionsPrepackedWeightsCacheFile = "session.prepacked_weights_cache_file";
+
+// Maximum number of memory patterns cached per graph when the memory pattern optimization is enabled.
+// Once the limit is reached the least recently used pattern is evicted.
+// The default value is "0", which means the number of cached patterns is not limited.
+static const char* const kOrtSessionOptionsMemoryPatternCacheCapacity = "session.memory_pattern_cache_capacity";
+
+// If set to a value greater than "1", every input dimension is rounded up to a multiple of this value when looking up
+// the memory pattern for the input shapes, so inputs with similar shapes (e.g. varying sequence lengths) share one
+// pre-planned block. The pattern of a bucket grows to the largest sizes seen for it.
+// The default value is "0", which looks up the memory patterns by the exact input shapes.
+static const char* const kOrtSessionOptionsMemoryPatternShapeBucketSize = "session.memory_pattern_shape_bucket_size";
+
+// Enables dynamic batching of the requests submitted via RunAsync if set to a value greater than "0".
+// Requests with the same RunOptions instance, input and output names, and CPU tensor inputs whose shapes only differ
+// along the batch axis are concatenated along it, run as one batch of at most this many rows, and the outputs are
+// split along the batch axis before the callback of each request is invoked. Other requests are run on their own.
+// The default value is "0", which runs every RunAsync request on its own.
+static const char* const kOrtSessionOptionsDynamicBatchingMaxBatchSize = "session.dynamic_batching.max_batch_size";
+
+// Maximum time in microseconds the oldest queued request waits for more requests before its batch is run.
+// The default value is "1000".
+static const char* const kOrtSessionOptionsDynamicBatchingMaxQueueDelayUs =
+    "session.dynamic_batching.max_queue_delay_us";
+
+// Axis along which the inputs and outputs of the batched requests are concatenated and split.
+// The default value is "0".
+static const char* const kOrtSessionOptionsDynamicBatchingBatchAxis = "session.dynamic_batching.batch_axis";
+
+// Selects the executor used for the main graph when the execution mode is ORT_PARALLEL.
+// "0": the nodes of each logic stream of the execution plan are run in order on the inter-op thread pool. [DEFAULT]
+// "1": every node is run as soon as the nodes it depends on are done. Ready nodes are run on the intra-op thread pool,
+//      whose workers steal queued nodes from each other, and the nodes on the longest path to the graph outputs are
+//      preferred. Used if the main graph only has CPU nodes, otherwise the setting is ignored.
+static const char* const kOrtSessionOptionsConfigUseWorkStealingExecutor = "session.use_work_stealing_executor";
+
 // A value of "1" means allocators registered in the env will be used. "0" means the allocators created in the session
 // will be used. Use this to override the usage of env allocators on a per session level.
 static const char* const kOrtSessionOptionsConfigUseEnvAllocators = "session.use_env_allocators";
@@ -135,6 +182,26 @@ static const char* const kOrtSessionOptionsConfigUseORTModelBytesDirectly = "ses
 static const char* const kOrtSessionOptionsConfigUseORTModelBytesForInitializers =
     "session.use_ort_model_bytes_for_initializers";
 
+/// <summary>
+/// Key for mapping an ORT format model file into memory instead of reading it into a buffer when the session is
+/// created from a file path. The initializers use the mapped bytes directly, and the sessions of the process that
+/// load the same file share the mapping, so N sessions of a model cost one copy of it in the page cache.
+/// The file must not be modified while a session using it exists.
+/// "0": default, the file is read into a buffer that is freed once the session is initialized.
+/// "1": the file is memory mapped.
+/// </summary>
+static const char* const kOrtSessionOptionsConfigMapORTModelFile = "session.map_ort_model_file";
+
+// Key for sharing the constant initializers of identical content across the sessions created with the same
+// environment, so that e.g. the weights fine-tuned variants of a model have in common are held once.
+// The initializers are looked up by content hash when the session is initialized, and the kernels of all sessions
+// sharing an initializer share its pre-packed forms too. An initializer is freed once no session uses it anymore.
+// Only CPU initializers of 1KB or more are shared. Initializers with external data are memory mapped instead.
+// "0": default, the initializers are not shared.
+// "1": the initializers are shared.
+static const char* const kOrtSessionOptionsShareInitializersAcrossSessions =
+    "session.share_initializers_across_sessions";
+
 // This should only be specified when exporting an ORT format model for use on a different platform.
 // If the ORT format model will be used on ARM platforms set to "1". For other platforms set to "0"
 // Available since version 1.11.
@@ -206,6 +273,8 @@ static const char* const kNodePartitionConfigFile = "session.node_partition_conf
 // To ease the configuration, an "interval" is also allowed:
 // e.g. 1-8;8-16;17-24
 // orders that the 1st thread runs on first eight processors, 2nd thread runs on next eight processors, and so forth.
+// A thread can also be attached to all processors of a NUMA node, with NUMA node ids starting from 0:
+// e.g. numa:0;numa:0;numa:1;numa:1
 // Note:
 // 1. Once set, the number of thread affinities must equal to intra_op_num_threads - 1, since ort does not set affinity on the main thread which
 //    is started and managed by the calling app;
@@ -214,6 +283,16 @@ static const char* const kNodePartitionConfigFile = "session.node_partition_conf
 //    Hence 64-65 is an invalid configuration, because a windows thread cannot be attached to processors across group boundary.
 static const char* const kOrtSessionOptionsConfigIntraOpThreadAffinities = "session.intra_op_thread_affinities";
 
+// Makes the session NUMA aware if set to "1". Used on machines with more than one NUMA node that has processors.
+// 1. If session.intra_op_thread_affinities is not set, the threads of the intra-op thread pool of the session are split
+//    into one contiguous partition per NUMA node and each thread is attached to the processors of its node.
+// 2. The pages of the CPU initializers and pre-packed weights of at least 1MB are interleaved across the NUMA nodes
+//    (Linux only), so that the threads on every node read them at the same bandwidth instead of all reading from
+//    the node that loaded them. Only the memory allocated by the session is moved: initializers supplied by the
+//    user, shared across sessions or stored as external data are left where they are.
+// The default value is "0".
+static const char* const kOrtSessionOptionsConfigNumaAware = "session.numa_aware";
+
 // This option will dump out the model to assist debugging any issues with layout transformation,
 // and is primarily intended for developer usage. It is only relevant if an execution provider that requests
 // NHWC layout is enabled such as NNAPI, XNNPACK or QNN.
@@ -278,6 +357,39 @@ static const char* const kOrtSessionOptionShareEpContexts = "ep.share_ep_context
 // - "1": Gemm FastMath mode is enabled.
 static const char* const kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16 = "mlas.enable_gemm_fastmath_arm64_bfloat16";
 
+// Gemm fastmath mode for x64 Linux, uses the AVX512-BF16 or AMX-BF16 instructions when the CPU supports them.
+// Option values:
+// - "0": Gemm FastMath mode is not enabled. [DEFAULT]
+// - "1": Gemm FastMath mode is enabled.
+static const char* const kOrtSessionOptionsMlasGemmFastMathX64Bfloat16 = "mlas.enable_gemm_fastmath_x64_bfloat16";
+
+// Generates SGEMM kernels specialized for the matrix shape at runtime on x64 CPUs with AVX2 or AVX512F.
+// Only row blocks of up to four rows use the generated kernels, which mainly benefits single token decoding.
+// Option values:
+// - "0": The statically compiled kernels are used. [DEFAULT]
+// - "1": Runtime generated kernels are used when the CPU supports them.
+static const char* const kOrtSessionOptionsMlasEnableJitKernels = "mlas.enable_jit_kernels";
+
+// Enables TunableOp for the CPU EP. MatMul and Conv then segment the work across threads with the partitioning
+// tuned for the shape instead of the MLAS heuristic. Tuning results embedded in the model metadata are loaded when
+// the session is created, which enables TunableOp as well.
+// Option values:
+// - "0": The MLAS heuristic is used. [DEFAULT]
+// - "1": Tuned partitionings are used for the shapes that have tuning results.
+static const char* const kOrtSessionOptionsCpuTunableOpEnable = "session.cpu_tunable_op_enable";
+
+// Tunes the shapes without tuning results on their first run, requires session.cpu_tunable_op_enable.
+// The results are read with InferenceSession::GetTuningResults and can be embedded in the model metadata with
+// onnxruntime/python/tools/offline_tuning.py.
+// Option values:
+// - "0": Shapes without tuning results use the MLAS heuristic. [DEFAULT]
+// - "1": Shapes without tuning results are tuned.
+static const char* const kOrtSessionOptionsCpuTunableOpTuningEnable = "session.cpu_tunable_op_tuning_enable";
+
+// Upper bound of the time in milliseconds spent profiling each candidate partitioning while tuning a shape.
+// If not provided or not positive, the number of profiling iterations is only limited by the TunableOp default.
+static const char* const kOrtSessionOptionsCpuTunableOpMaxTuningDurationMs = "session.cpu_tunable_op_max_tuning_duration_ms";
+
 // When converting DQ + MatMul -> MatMulNBits, the accuracy level of the MatMulNBits is controlled by this option.
 // Refer to MatMulNBits op schema for more details.
 // If not provided, default is 4.
@@ -164,6 +164,10 @@ struct GroupQueryAttentionParameters {
   AttentionQkvFormat past_kv_format;
   int zeros_count;
   int* zero_ptr;
+  bool paged_kv_cache;          // past and present kv are pages of a shared pool addressed by a block table
+  int kv_block_size;            // number of tokens per page of the paged kv cache
+  int num_kv_blocks;            // number of pages in the pool of the paged kv cache
+  int max_blocks_per_sequence;  // number of columns of the block table
 };
 
 // Parameters for sparse attention.
@@ -10,6 +10,8 @@
 #include "contrib_ops/cpu/bert/attention_common.h"
 #include "core/common/safeint.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/env.h"
+#include "core/platform/env_var_utils.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -34,6 +36,9 @@ class GQAAttentionBase {
     use_smooth_softmax_ = info.GetAttrOrDefault<int64_t>("smooth_softmax", 0) == 1;
 
     local_window_size_ = has_local ? static_cast<int>(info.GetAttrOrDefault<int64_t>("local_window_size", -1)) : -1;
+
+    l2_cache_size_ = Env::Default().GetL2CacheSize();
+    disable_flash_ = ParseEnvironmentVariableWithDefault<bool>(attention::kDisableFlashAttention, false);
   }
 
   int num_heads_;     // number of attention heads of Q
@@ -46,6 +51,9 @@ class GQAAttentionBase {
 
   bool use_smooth_softmax_;
 
+  bool disable_flash_;  // whether to use the reference path instead of MlasFlashAttention
+  int l2_cache_size_;
+
   template <typename T>
   Status ApplyAttention(const T* Q,                                 // Q data with shape BxNxSxH
                         const T* K,                                 // K data with shape BxN_kvxSxH
@@ -56,6 +64,7 @@ class GQAAttentionBase {
                         Tensor* present_key,                        // present K output tensor (if separating present KV)
                         Tensor* present_value,                      // present V output tensor (if separating present KV)
                         const Tensor* seqlens_k,                    // past sequence lengths tensor
+                        const Tensor* block_table,                  // block table of the paged KV cache (optional)
                         GroupQueryAttentionParameters& parameters,  // attention parameters
                         AllocatorPtr allocator,                     // allocator for temporary tensors
                         OpKernelContext* context) const {
@@ -68,12 +77,22 @@ class GQAAttentionBase {
 
     auto* tp = context->GetOperatorThreadPool();
 
+    if (block_table != nullptr) {
+      return ApplyPagedAttention(Q, K, V, past_key, past_value, output, present_key, present_value, seqlens_k,
+                                 block_table, parameters, allocator, tp);
+    }
+
     int seqlen_past_kv_cache = 0;
     if (past_key != nullptr && past_value != nullptr) {
       seqlen_past_kv_cache = static_cast<int>(past_key->Shape().GetDims()[2]);
     }
     int seqlen_present_kv_cache = static_cast<int>(present_key->Shape().GetDims()[2]);
 
+    if (!disable_flash_ && l2_cache_size_ > 0) {
+      return ApplyFlashAttention(Q, K, V, past_key, past_value, output, present_key, present_value, seqlens_k,
+                                 seqlen_past_kv_cache, seqlen_present_kv_cache, parameters, allocator, tp);
+    }
+
     // Compute the attention score.
     size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * seqlen_present_kv_cache * sizeof(float);
     auto attention_probs = allocator->Alloc(bytes);
@@ -103,6 +122,117 @@ class GQAAttentionBase {
   }
 
  private:
+  // Appends the new keys and values to the KV cache, then computes the attention of all the query heads with
+  // MlasFlashAttention, which tiles Q*K' and applies the online softmax so that the BxNxSxT attention probs
+  // are never materialized.
+  template <typename T>
+  Status ApplyFlashAttention(const T* Q,                                 // Q data with shape BxNxSxH
+                             const T* K,                                 // K data with shape BxN_kvxSxH
+                             const T* V,                                 // V data with shape BxN_kvxSxH
+                             const Tensor* past_key,                     // past K input tensor
+                             const Tensor* past_value,                   // past V input tensor
+                             Tensor* output,                             // output tensor
+                             Tensor* present_key,                        // present K output tensor
+                             Tensor* present_value,                      // present V output tensor
+                             const Tensor* seqlens_k,                    // past sequence lengths tensor
+                             int seqlen_past_kv_cache,                   // sequence length of past state
+                             int seqlen_present_kv_cache,                // sequence length of present state
+                             GroupQueryAttentionParameters& parameters,  // attention parameters
+                             AllocatorPtr allocator,                     // allocator for temporary buffers
+                             ThreadPool* tp) const {
+    const bool is_prompt = parameters.is_first_prompt;
+    const int batch_size = parameters.batch_size;
+    const int sequence_length = parameters.sequence_length;
+    const int head_size = parameters.head_size;
+    const bool packed_qkv = parameters.is_packed_qkv;
+    const int32_t* seqlens_k_data = seqlens_k->Data<int32_t>();
+
+    const T* past_key_data = past_key != nullptr ? past_key->Data<T>() : nullptr;
+    T* present_key_data = present_key->MutableData<T>();
+    const T* past_value_data = past_value != nullptr ? past_value->Data<T>() : nullptr;
+    T* present_value_data = present_value->MutableData<T>();
+    const bool past_present_share_buffer = past_key_data == present_key_data && past_value_data == present_value_data;
+
+    const ptrdiff_t packed_batch_stride =
+        packed_qkv ? SafeInt<ptrdiff_t>(num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size
+                   : SafeInt<ptrdiff_t>(0);
+    const T* k = packed_qkv ? Q + num_heads_ * sequence_length * head_size : K;
+    const T* v = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * sequence_length * head_size : V;
+    const size_t kv_input_chunk_length = SafeInt<size_t>(sequence_length) * head_size;
+    const size_t past_buff_chunk_length = SafeInt<size_t>(seqlen_past_kv_cache) * head_size;
+    const size_t present_buff_chunk_length = SafeInt<size_t>(seqlen_present_kv_cache) * head_size;
+
+    if (!past_present_share_buffer) {
+      const size_t present_bytes = SafeInt<size_t>(batch_size) * kv_num_heads_ * present_buff_chunk_length * sizeof(T);
+      memset(static_cast<void*>(present_key_data), 0, present_bytes);
+      memset(static_cast<void*>(present_value_data), 0, present_bytes);
+    }
+
+    // Number of valid keys of each batch, which are the first ones of the present buffers.
+    std::vector<int32_t> total_seqlens(batch_size);
+
+    TensorOpCost unit_cost;
+    unit_cost.bytes_loaded = static_cast<double>(2 * present_buff_chunk_length * sizeof(T));
+    unit_cost.bytes_stored = unit_cost.bytes_loaded;
+    unit_cost.compute_cycles = 0.0;
+    ThreadPool::TryParallelFor(
+        tp, SafeInt<ptrdiff_t>(batch_size) * kv_num_heads_, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          for (std::ptrdiff_t i = begin; i != end; ++i) {
+            const size_t batch_index = i / kv_num_heads_;
+            const size_t head_index = i % kv_num_heads_;
+            const size_t total_seqlen = static_cast<size_t>(seqlens_k_data[batch_index]) + 1;
+            const size_t past_seqlen = is_prompt ? 0 : total_seqlen - sequence_length;
+            const size_t past_chunk_length = past_seqlen * head_size;
+            if (head_index == 0) {
+              total_seqlens[batch_index] = static_cast<int32_t>(total_seqlen);
+            }
+
+            const size_t input_offset =
+                packed_qkv ? static_cast<size_t>(packed_batch_stride) * batch_index + kv_input_chunk_length * head_index
+                           : kv_input_chunk_length * i;
+            ConcatStateChunkGQA(past_key_data, k + input_offset, present_key_data, present_buff_chunk_length,
+                                past_buff_chunk_length, past_chunk_length, kv_input_chunk_length,
+                                past_present_share_buffer, i);
+            ConcatStateChunkGQA(past_value_data, v + input_offset, present_value_data, present_buff_chunk_length,
+                                past_buff_chunk_length, past_chunk_length, kv_input_chunk_length,
+                                past_present_share_buffer, i);
+          }
+        });
+
+    MlasFlashAttentionThreadedArgs args;
+    args.batch_size = batch_size;
+    args.num_heads = num_heads_;
+    args.kv_num_heads = kv_num_heads_;
+    args.q_sequence_length = sequence_length;
+    args.kv_sequence_length = seqlen_present_kv_cache;
+    args.kv_valid_lengths = total_seqlens.data();
+    args.qk_head_size = head_size;
+    args.v_head_size = head_size;
+    args.scale = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+    SetFlashAttentionBlockSizes(args, l2_cache_size_);
+    args.thread_count = ThreadPool::DegreeOfParallelism(tp);
+    args.type = std::is_same<T, float>::value ? MlasFlashAttentionFloat32 : MlasFlashAttentionFloat16;
+    // query row i attends to the keys up to past_seqlen + i of its batch
+    args.is_causal = true;
+    args.local_window_size = local_window_size_ > 0 ? local_window_size_ : -1;
+    args.softcap = softcap_;
+    args.smooth_softmax = use_smooth_softmax_;
+    args.query_batch_stride = static_cast<size_t>(packed_batch_stride);
+    args.buffer_size_per_thread = MlasFlashAttentionGetBufferSizePerThread(
+        args.type, static_cast<size_t>(args.q_block_size), static_cast<size_t>(args.kv_block_size),
+        static_cast<size_t>(args.qk_head_size), static_cast<size_t>(args.v_head_size));
+    IAllocatorUniquePtr<void> buffer =
+        IAllocator::MakeUniquePtr<void>(allocator, args.buffer_size_per_thread * args.thread_count);
+    args.buffer = reinterpret_cast<float*>(buffer.get());
+    args.query = Q;
+    args.key = present_key_data;
+    args.value = present_value_data;
+    args.output = output->MutableData<T>();
+
+    MlasFlashAttention(&args, tp);
+    return Status::OK();
+  }
+
   // Helper function to compute the attention probs. It does 2 things:
   //  attention_probs(B, N, S, T) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, T, H -> B, N, H, T)
   //  attention_probs(B, N, S, T) = Softmax(attention_probs)
@@ -214,45 +344,52 @@ class GQAAttentionBase {
                                           output, static_cast<int>(present_buffer_sequence_length), nullptr);
         }
 
-        // compute Softmax
-        float* output_softmax = output;
-        for (size_t seq = 0; seq < sequence_length; seq++) {
-          size_t seq_causal_length = past_seqlen + seq + 1;
-          if (local_window_size_ > 0 && seq_causal_length > static_cast<size_t>(local_window_size_) + 1) {
-            for (size_t total_seq_id = 0; total_seq_id < seq_causal_length - local_window_size_ - 1; total_seq_id++) {
-              output_softmax[total_seq_id] = 0.f;
-            }
-            if (softcap_ > 0.f) {
-              ComputeAttentionSoftcapInplace(output_softmax + seq_causal_length - local_window_size_ - 1,
-                                             local_window_size_ + 1, softcap_);
-            }
-            if (use_smooth_softmax_) {
-              ComputeSmoothSoftmaxInplace(output_softmax + seq_causal_length - local_window_size_ - 1, 1,
-                                          local_window_size_ + 1, nullptr);
-            } else {
-              ComputeAttentionSoftmaxInplace(output_softmax + seq_causal_length - local_window_size_ - 1, 1,
-                                             local_window_size_ + 1, nullptr);
-            }
-          } else {
-            if (softcap_ > 0.f) {
-              ComputeAttentionSoftcapInplace(output_softmax, static_cast<int>(seq_causal_length), softcap_);
-            }
-            if (use_smooth_softmax_) {
-              ComputeSmoothSoftmaxInplace(output_softmax, 1, static_cast<int>(seq_causal_length), nullptr);
-            } else {
-              ComputeAttentionSoftmaxInplace(output_softmax, 1, static_cast<int>(seq_causal_length), nullptr);
-            }
-          }
-
-          // set causal [seq_causal_length, total_seqlen) to 0.f
-          for (size_t total_seq_id = seq_causal_length; total_seq_id < total_seqlen; total_seq_id++) {
-            output_softmax[total_seq_id] = 0.f;
-          }
+        ComputeCausalSoftmax(output, sequence_length, past_seqlen, total_seqlen, present_buffer_sequence_length);
+      }
+    });
+  }
 
-          output_softmax += present_buffer_sequence_length;
+  // Applies softcap, the local window and the causal mask to the Q*K' rows of one head, then computes softmax in place.
+  void ComputeCausalSoftmax(float* output_softmax,                        // Q*K' rows with size SxT
+                            const size_t sequence_length,                 // sequence length of Q (S)
+                            const size_t past_seqlen,                     // past sequence length of the batch
+                            const size_t total_seqlen,                    // total sequence length of the batch
+                            const size_t present_buffer_sequence_length) const {  // row stride of Q*K'
+    for (size_t seq = 0; seq < sequence_length; seq++) {
+      size_t seq_causal_length = past_seqlen + seq + 1;
+      if (local_window_size_ > 0 && seq_causal_length > static_cast<size_t>(local_window_size_) + 1) {
+        for (size_t total_seq_id = 0; total_seq_id < seq_causal_length - local_window_size_ - 1; total_seq_id++) {
+          output_softmax[total_seq_id] = 0.f;
+        }
+        if (softcap_ > 0.f) {
+          ComputeAttentionSoftcapInplace(output_softmax + seq_causal_length - local_window_size_ - 1,
+                                         local_window_size_ + 1, softcap_);
+        }
+        if (use_smooth_softmax_) {
+          ComputeSmoothSoftmaxInplace(output_softmax + seq_causal_length - local_window_size_ - 1, 1,
+                                      local_window_size_ + 1, nullptr);
+        } else {
+          ComputeAttentionSoftmaxInplace(output_softmax + seq_causal_length - local_window_size_ - 1, 1,
+                                         local_window_size_ + 1, nullptr);
+        }
+      } else {
+        if (softcap_ > 0.f) {
+          ComputeAttentionSoftcapInplace(output_softmax, static_cast<int>(seq_causal_length), softcap_);
+        }
+        if (use_smooth_softmax_) {
+          ComputeSmoothSoftmaxInplace(output_softmax, 1, static_cast<int>(seq_causal_length), nullptr);
+        } else {
+          ComputeAttentionSoftmaxInplace(output_softmax, 1, static_cast<int>(seq_causal_length), nullptr);
         }
       }
-    });
+
+      // set causal [seq_causal_length, total_seqlen) to 0.f
+      for (size_t total_seq_id = seq_causal_length; total_seq_id < total_seqlen; total_seq_id++) {
+        output_softmax[total_seq_id] = 0.f;
+      }
+
+      output_softmax += present_buffer_sequence_length;
+    }
   }
 
   template <typename T>
@@ -369,6 +506,213 @@ class GQAAttentionBase {
                                    SafeInt<size_t>(sequence_length) * batch_size * num_heads_ * head_size);
     }
   }
+
+  // Addresses the tokens of a paged KV cache. The pool has shape (num_blocks, N_kv, block_size, H) and row b of the
+  // block table lists the pages holding tokens [0, block_size), [block_size, 2 x block_size), ... of sequence b.
+  struct PagedKVCache {
+    const int32_t* block_table;
+    size_t max_blocks_per_sequence;
+    size_t block_size;
+    size_t head_size;
+    size_t kv_num_heads;
+
+    // Offset of the token at position pos of KV head kv_head of sequence b. The tokens of one page are contiguous.
+    size_t Offset(size_t b, size_t kv_head, size_t pos) const {
+      const size_t block = static_cast<size_t>(block_table[b * max_blocks_per_sequence + pos / block_size]);
+      return ((block * kv_num_heads + kv_head) * block_size + pos % block_size) * head_size;
+    }
+  };
+
+  // Attention over a paged KV cache: the new K and V tokens are written to their pages, then every head computes
+  // Q*K', softmax and softmax*V page by page, so sequences only hold the pages they use from a shared pool.
+  template <typename T>
+  Status ApplyPagedAttention(const T* Q,                                       // Q data with shape BxNxSxH
+                             const T* K,                                       // K data with shape BxN_kvxSxH
+                             const T* V,                                       // V data with shape BxN_kvxSxH
+                             const Tensor* past_key,                           // past K pool
+                             const Tensor* past_value,                         // past V pool
+                             Tensor* output,                                   // output tensor
+                             Tensor* present_key,                              // present K pool
+                             Tensor* present_value,                            // present V pool
+                             const Tensor* seqlens_k,                          // past sequence lengths tensor
+                             const Tensor* block_table,                        // block table of the pools
+                             const GroupQueryAttentionParameters& parameters,  // attention parameters
+                             AllocatorPtr allocator,                           // allocator for temporary buffers
+                             ThreadPool* tp) const {                           // thread pool
+    const bool is_prompt = parameters.is_first_prompt;
+    const size_t batch_size = parameters.batch_size;
+    const size_t sequence_length = parameters.sequence_length;
+    const size_t head_size = parameters.head_size;
+    const size_t hidden_size = parameters.hidden_size;
+    const bool packed_qkv = parameters.is_packed_qkv;
+    const size_t present_buffer_sequence_length = parameters.seqlen_present_kv_cache;
+    const int32_t* seqlens_k_data = seqlens_k->Data<int32_t>();
+
+    PagedKVCache cache;
+    cache.block_table = block_table->Data<int32_t>();
+    cache.max_blocks_per_sequence = parameters.max_blocks_per_sequence;
+    cache.block_size = parameters.kv_block_size;
+    cache.head_size = head_size;
+    cache.kv_num_heads = kv_num_heads_;
+
+    // Without a shared buffer the present pool starts as a copy of the past pool.
+    T* present_key_data = present_key->MutableData<T>();
+    T* present_value_data = present_value->MutableData<T>();
+    if (past_key->DataRaw() != present_key->DataRaw()) {
+      memcpy(present_key_data, past_key->Data<T>(), past_key->SizeInBytes());
+    }
+    if (past_value->DataRaw() != present_value->DataRaw()) {
+      memcpy(present_value_data, past_value->Data<T>(), past_value->SizeInBytes());
+    }
+
+    const ptrdiff_t packed_batch_stride =
+        packed_qkv ? SafeInt<ptrdiff_t>(num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size
+                   : SafeInt<ptrdiff_t>(0);
+    const size_t kv_num_heads_factor = num_heads_ / kv_num_heads_;
+    const size_t chunk_length = sequence_length * head_size;  // S x H
+    const T* k_input = packed_qkv ? Q + num_heads_ * chunk_length : K;
+    const T* v_input = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * chunk_length : V;
+
+    // Write the new tokens of every KV head to their pages.
+    TensorOpCost copy_cost;
+    copy_cost.bytes_loaded = static_cast<double>(2 * chunk_length * sizeof(T));
+    copy_cost.bytes_stored = copy_cost.bytes_loaded;
+    copy_cost.compute_cycles = 0;
+    ThreadPool::TryParallelFor(tp, batch_size * kv_num_heads_, copy_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const size_t batch_index = i / kv_num_heads_;
+        const size_t kv_head_index = i % kv_num_heads_;
+        const size_t total_seqlen = static_cast<size_t>(seqlens_k_data[batch_index]) + 1;
+        const size_t past_seqlen = is_prompt ? 0 : total_seqlen - sequence_length;
+        const size_t new_seqlen = std::min(sequence_length, total_seqlen - past_seqlen);  // skip right padding
+        const size_t input_offset = packed_qkv ? packed_batch_stride * batch_index + chunk_length * kv_head_index
+                                               : chunk_length * i;
+        for (size_t seq = 0; seq < new_seqlen; seq++) {
+          const size_t offset = cache.Offset(batch_index, kv_head_index, past_seqlen + seq);
+          memcpy(present_key_data + offset, k_input + input_offset + seq * head_size, head_size * sizeof(T));
+          memcpy(present_value_data + offset, v_input + input_offset + seq * head_size, head_size * sizeof(T));
+        }
+      }
+    });
+
+    size_t probs_bytes =
+        SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * present_buffer_sequence_length * sizeof(float);
+    auto attention_probs = allocator->Alloc(probs_bytes);
+    BufferUniquePtr probs_buffer(attention_probs, BufferDeleter(allocator));
+
+    size_t output_fp32_bytes = 0;
+    if constexpr (std::is_same<T, MLFloat16>::value) {
+      output_fp32_bytes = SafeInt<size_t>(sequence_length) * batch_size * num_heads_ * head_size * sizeof(float);
+    }
+    auto output_fp32 = allocator->Alloc(output_fp32_bytes);
+    BufferUniquePtr output_fp32_buffer(output_fp32, BufferDeleter(allocator));
+
+    T* output_data = output->MutableData<T>();
+    const float alpha = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+
+    // The cost of both Gemms
+    TensorOpCost unit_cost;
+    unit_cost.compute_cycles =
+        static_cast<double>(SafeInt<ptrdiff_t>(4) * sequence_length * head_size * present_buffer_sequence_length);
+    unit_cost.bytes_loaded =
+        static_cast<double>((sequence_length + 2 * present_buffer_sequence_length) * head_size * sizeof(T));
+    unit_cost.bytes_stored = static_cast<double>(sequence_length * (present_buffer_sequence_length + head_size) *
+                                                 sizeof(float));
+
+    ThreadPool::TryParallelFor(tp, batch_size * num_heads_, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const size_t batch_index = i / num_heads_;
+        const size_t head_index = i % num_heads_;
+        const size_t kv_head_index = head_index / kv_num_heads_factor;
+        const size_t total_seqlen = static_cast<size_t>(seqlens_k_data[batch_index]) + 1;
+        const size_t past_seqlen = is_prompt ? 0 : total_seqlen - sequence_length;
+        const size_t block_size = cache.block_size;
+        const size_t num_blocks = (total_seqlen + block_size - 1) / block_size;
+
+        // Pages left of the local window of the first query are masked for every query, skip them.
+        size_t first_block = 0;
+        if (local_window_size_ > 0 && past_seqlen > static_cast<size_t>(local_window_size_)) {
+          first_block = (past_seqlen - local_window_size_) / block_size;
+        }
+        const size_t first_token = first_block * block_size;
+
+        const T* q = packed_qkv ? Q + packed_batch_stride * batch_index + chunk_length * head_index
+                                : Q + chunk_length * i;
+        float* probs = static_cast<float*>(attention_probs) +
+                       SafeInt<ptrdiff_t>(i) * sequence_length * present_buffer_sequence_length;
+
+        // Compute Q*K' page by page
+        //                     each page
+        // A: Q                S x H
+        // B: K'               H x block_size
+        // C: attention_probs  S x block_size
+        if constexpr (std::is_same<T, float>::value) {
+          for (size_t block = first_block; block < num_blocks; block++) {
+            const size_t token = block * block_size;
+            const size_t count = std::min(block_size, total_seqlen - token);
+            const float* k = present_key_data + cache.Offset(batch_index, kv_head_index, token);
+            math::GemmEx<float, ThreadPool>(CblasNoTrans, CblasTrans, sequence_length, count, head_size, alpha, q,
+                                            static_cast<int>(head_size), k, static_cast<int>(head_size), 0.0f,
+                                            probs + token, static_cast<int>(present_buffer_sequence_length), nullptr);
+          }
+          ComputeCausalSoftmax(probs, sequence_length, past_seqlen, total_seqlen, present_buffer_sequence_length);
+
+          // Compute attention_probs x V page by page, accumulating into the output.
+          float* output_current = output_data + (batch_index * sequence_length * num_heads_ + head_index) * head_size;
+          for (size_t block = first_block; block < num_blocks; block++) {
+            const size_t token = block * block_size;
+            const size_t count = std::min(block_size, total_seqlen - token);
+            const float* v = present_value_data + cache.Offset(batch_index, kv_head_index, token);
+            math::GemmEx<float, ThreadPool>(CblasNoTrans, CblasNoTrans, sequence_length, head_size, count, 1.f,
+                                            probs + token, static_cast<int>(present_buffer_sequence_length), v,
+                                            static_cast<int>(head_size), block == first_block ? 0.0f : 1.0f,
+                                            output_current, static_cast<int>(hidden_size), nullptr);
+          }
+        } else {
+          // Gather the pages into one fp32 buffer, then run a single Gemm for K and one for V.
+          const size_t gathered_seqlen = total_seqlen - first_token;
+          size_t bytes = head_size * (sequence_length + gathered_seqlen) * sizeof(float);
+          auto q_kv_fp32 = allocator->Alloc(bytes);
+          BufferUniquePtr scratch_buffer(q_kv_fp32, BufferDeleter(allocator));
+
+          float* q_fp32 = static_cast<float*>(q_kv_fp32);
+          MlasConvertHalfToFloatBuffer(q, q_fp32, head_size * sequence_length);
+
+          float* kv_fp32 = q_fp32 + head_size * sequence_length;
+          auto gather_pages = [&](const T* pool) {
+            for (size_t block = first_block; block < num_blocks; block++) {
+              const size_t token = block * block_size;
+              const size_t count = std::min(block_size, total_seqlen - token);
+              MlasConvertHalfToFloatBuffer(pool + cache.Offset(batch_index, kv_head_index, token),
+                                           kv_fp32 + (token - first_token) * head_size, count * head_size);
+            }
+          };
+
+          gather_pages(present_key_data);
+          math::GemmEx<float, ThreadPool>(CblasNoTrans, CblasTrans, sequence_length, gathered_seqlen, head_size, alpha,
+                                          q_fp32, static_cast<int>(head_size), kv_fp32, static_cast<int>(head_size),
+                                          0.0f, probs + first_token, static_cast<int>(present_buffer_sequence_length),
+                                          nullptr);
+          ComputeCausalSoftmax(probs, sequence_length, past_seqlen, total_seqlen, present_buffer_sequence_length);
+
+          gather_pages(present_value_data);
+          float* output_fp32_current = static_cast<float*>(output_fp32) +
+                                       (batch_index * sequence_length * num_heads_ + head_index) * head_size;
+          math::GemmEx<float, ThreadPool>(CblasNoTrans, CblasNoTrans, sequence_length, head_size, gathered_seqlen, 1.f,
+                                          probs + first_token, static_cast<int>(present_buffer_sequence_length),
+                                          kv_fp32, static_cast<int>(head_size), 0.0f, output_fp32_current,
+                                          static_cast<int>(hidden_size), nullptr);
+        }
+      }
+    });
+
+    if constexpr (std::is_same<T, MLFloat16>::value) {
+      MlasConvertFloatToHalfBuffer(static_cast<float*>(output_fp32),
+                                   output_data,
+                                   SafeInt<size_t>(sequence_length) * batch_size * num_heads_ * head_size);
+    }
+    return Status::OK();
+  }
 };
 
 }  // namespace contrib
@@ -24,10 +24,15 @@ Status CheckInputs(const Tensor* query,
                    const Tensor* seqlens_k,
                    const Tensor* total_seqlen,
                    float scale,
-                   float softcap) {
+                   float softcap,
+                   const Tensor* block_table = nullptr) {
   // Note: Here S* is seqlen_past_kv_cache, S+ is seqlen_present_kv_cache
   //     past_key                   : (B, N_k, S*, H) or (B, N_k, S+, H) or nullptr
   //     past_value                 : (B, N_k, S*, H) or (B, N_k, S+, H) or nullptr
+  // paged kv cache:
+  //     past_key                   : (num_blocks, N_k, block_size, H)
+  //     past_value                 : (num_blocks, N_k, block_size, H)
+  //     block_table                : (B, max_blocks_per_sequence)
   // no packing for q/k/v:
   //     query            (Q)       : (B, S, D) or (B, S, (D_q + 2 D_kv))
   //     key              (K)       : (B, S, D_kv) or nullptr
@@ -108,9 +113,67 @@ Status CheckInputs(const Tensor* query,
     kv_hidden_size = head_size * kv_num_heads;
   }
 
+  const auto& seqlens_k_dim = seqlens_k->Shape().GetDims();
+  if (seqlens_k_dim.size() != 1 || seqlens_k_dim[0] != batch_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "seqlens_k must be shape (batch_size).");
+  }
+
   // Check past-present KV
   int32_t past_sequence_length = 0;
-  if (past_key != nullptr && past_value != nullptr) {
+  const bool paged_kv_cache = block_table != nullptr;
+  int kv_block_size = 0;
+  int num_kv_blocks = 0;
+  int max_blocks_per_sequence = 0;
+  if (paged_kv_cache) {
+    if (past_key == nullptr || past_value == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'past_key' and 'past_value' shall be present when 'block_table' is given.");
+    }
+    const auto& past_key_dims = past_key->Shape().GetDims();
+    if (past_key_dims.size() != 4 || past_key->Shape() != past_value->Shape()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'past_key' and 'past_value' shall have the same 4D shape "
+                             "(num_blocks, kv_num_heads, block_size, head_size) for the paged kv cache.");
+    }
+    if (past_key_dims[1] != kv_num_heads || past_key_dims[3] != head_size) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'past_key' of the paged kv cache shall have kv_num_heads and head_size in "
+                             "dimension 1 and 3.");
+    }
+    num_kv_blocks = static_cast<int>(past_key_dims[0]);
+    kv_block_size = static_cast<int>(past_key_dims[2]);
+    if (kv_block_size <= 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Block size of the paged kv cache shall be positive.");
+    }
+
+    const auto& block_table_dims = block_table->Shape().GetDims();
+    if (block_table_dims.size() != 2 || block_table_dims[0] != batch_size) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'block_table' is expected to have shape (batch_size, max_blocks_per_sequence).");
+    }
+    max_blocks_per_sequence = static_cast<int>(block_table_dims[1]);
+
+    // The blocks of each sequence are gathered on the host, validate the ones covering the total sequence length.
+    const int32_t* block_table_data = block_table->Data<int32_t>();
+    const int32_t* seqlens_k_data = seqlens_k->Data<int32_t>();
+    for (int b = 0; b < batch_size; b++) {
+      const int total_seqlen = seqlens_k_data[b] + 1;
+      const int num_blocks = (total_seqlen + kv_block_size - 1) / kv_block_size;
+      if (total_seqlen <= 0 || num_blocks > max_blocks_per_sequence) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Total sequence length ", total_seqlen, " of batch ", b,
+                               " does not fit in the block table.");
+      }
+      for (int i = 0; i < num_blocks; i++) {
+        const int32_t block = block_table_data[b * max_blocks_per_sequence + i];
+        if (block < 0 || block >= num_kv_blocks) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                                 "Input 'block_table' has out of range block ", block, " for batch ", b);
+        }
+      }
+    }
+  } else if (past_key != nullptr && past_value != nullptr) {
     const auto& past_key_dims = past_key->Shape().GetDims();
     const auto& past_value_dims = past_value->Shape().GetDims();
 
@@ -168,19 +231,24 @@ Status CheckInputs(const Tensor* query,
                            "Input 'past_key' and 'past_value' shall be both present or both absent.");
   }
 
-  const auto& seqlens_k_dim = seqlens_k->Shape().GetDims();
-  if (seqlens_k_dim.size() != 1 && seqlens_k_dim[0] != batch_size) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
-                           "seqlens_k must be shape (batch_size).");
-  }
-
   // Set present sequence length from input total_seqlen tensor
   if (!onnxruntime::IsScalarOr1ElementVector(total_seqlen)) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                            "total_sequence_length tensor must be of one element.");
   }
   int total_sequence_length = *((*total_seqlen).template Data<int32_t>());
-  int present_sequence_length = std::max(total_sequence_length, past_sequence_length);
+  // The attention probs of the paged kv cache are only as long as the longest sequence of the batch.
+  int present_sequence_length = paged_kv_cache ? total_sequence_length
+                                               : std::max(total_sequence_length, past_sequence_length);
+  if (paged_kv_cache) {
+    const int32_t* seqlens_k_data = seqlens_k->Data<int32_t>();
+    for (int b = 0; b < batch_size; b++) {
+      if (seqlens_k_data[b] >= total_sequence_length) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "seqlens_k of batch ", b, " exceeds total_sequence_length - 1.");
+      }
+    }
+  }
 
   int rotary_dim = 0;
   if (cos_cache != nullptr && sin_cache != nullptr) {
@@ -260,6 +328,10 @@ Status CheckInputs(const Tensor* query,
     output_parameters->softcap = softcap;
     output_parameters->qkv_format = qkv_format;
     output_parameters->past_kv_format = past_kv_format;
+    output_parameters->paged_kv_cache = paged_kv_cache;
+    output_parameters->kv_block_size = kv_block_size;
+    output_parameters->num_kv_blocks = num_kv_blocks;
+    output_parameters->max_blocks_per_sequence = max_blocks_per_sequence;
   }
 
   return Status::OK();
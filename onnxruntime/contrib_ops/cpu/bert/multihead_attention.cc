@@ -147,62 +147,79 @@ Status MultiHeadAttention<T>::Compute(OpKernelContext* context) const {
 
   if (std::is_same_v<T, float> &&
       !disable_flash_ &&
-      !is_unidirectional_ &&
+      (!is_unidirectional_ || q_sequence_length == kv_sequence_length) &&
       key_padding_mask == nullptr &&
       attn_bias == nullptr &&
-      past_key == nullptr &&
-      past_value == nullptr &&
-      present_k == nullptr &&
-      present_v == nullptr &&
+      (past_key == nullptr) == (past_value == nullptr) &&
+      (present_k == nullptr) == (present_v == nullptr) &&
       l2_cache_size_ > 0) {
+    auto* tp = context->GetOperatorThreadPool();
+
+    // With past state or present outputs, the new keys and values are appended to the past ones first,
+    // then the kernel attends over the whole cache.
+    const float* k_data = K.Get<Tensor>().Data<float>();
+    const float* v_data = V.Get<Tensor>().Data<float>();
+    IAllocatorUniquePtr<float> kv_cache;
+    if (past_key != nullptr || present_k != nullptr) {
+      const size_t present_k_size = SafeInt<size_t>(batch_size) * num_heads_ * total_kv_sequence_length * qk_head_size;
+      const size_t present_v_size = SafeInt<size_t>(batch_size) * num_heads_ * total_kv_sequence_length * v_head_size;
+      float* present_k_data;
+      float* present_v_data;
+      if (present_k != nullptr) {
+        present_k_data = present_k->MutableData<float>();
+        present_v_data = present_v->MutableData<float>();
+      } else {
+        kv_cache = IAllocator::MakeUniquePtr<float>(allocator, present_k_size + present_v_size);
+        present_k_data = kv_cache.get();
+        present_v_data = present_k_data + present_k_size;
+      }
+
+      const int past_sequence_length = total_kv_sequence_length - kv_sequence_length;
+      const float* past_k_data = past_key != nullptr ? past_key->Data<float>() : nullptr;
+      const float* past_v_data = past_value != nullptr ? past_value->Data<float>() : nullptr;
+      const double cost = static_cast<double>(total_kv_sequence_length) * (qk_head_size + v_head_size);
+      ThreadPool::TryParallelFor(
+          tp, static_cast<std::ptrdiff_t>(batch_size) * num_heads_, cost,
+          [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+            for (std::ptrdiff_t i = begin; i != end; ++i) {
+              ConcatStateChunk(past_k_data, k_data + i * kv_sequence_length * qk_head_size, present_k_data,
+                               static_cast<size_t>(past_sequence_length) * qk_head_size,
+                               static_cast<size_t>(total_kv_sequence_length) * qk_head_size, i);
+              ConcatStateChunk(past_v_data, v_data + i * kv_sequence_length * v_head_size, present_v_data,
+                               static_cast<size_t>(past_sequence_length) * v_head_size,
+                               static_cast<size_t>(total_kv_sequence_length) * v_head_size, i);
+            }
+          });
+      k_data = present_k_data;
+      v_data = present_v_data;
+    }
+
     MlasFlashAttentionThreadedArgs args;
     args.batch_size = batch_size;
     args.num_heads = num_heads_;
     args.q_sequence_length = q_sequence_length;
-    args.kv_sequence_length = kv_sequence_length;
+    args.kv_sequence_length = total_kv_sequence_length;
     args.qk_head_size = qk_head_size;
     args.v_head_size = v_head_size;
     args.scale = (scale_ == 0.0f) ? 1.0f / sqrt(static_cast<float>(qk_head_size)) : scale_;
-    /*
-      q_block_size, kv_block_size correspond to Br, Bc in the FlashAttention paper.
-      Let M = l2_cache_size / sizeof(float)
-      In the FlashAttention kernel, there are 5 big matrices that we need to keep in L2 cache:
-        slice of Q -- [Br, qk_head_size]
-        slice of K -- [Bc, qk_head_size]
-        slice of V -- [Bc, v_head_size]
-        result of QK -- [Br, Bc]
-        temporary output (same shape as QKV) -- [Br, v_head_size]
-      The total size of these matrices is (Br + Bc) * (qk_head_size + v_head_size) + Br * Bc
-      By taking Bc = M / (4 * (qk_head_size + v_head_size)), and Br = min(Bc, qk_head_size + v_head_size), we have
-        (Br + Bc) * (qk_head_size + v_head_size) + Br * Bc
-        <= 2 * Bc * (qk_head_size + v_head_size) + Br * Bc
-        <= 2 * Bc * (qk_head_size + v_head_size) + M/4
-        <= 2 * M/4 + M/4 = M * (3/4)
-
-      We leave 1/4 of the L2 cache for
-        1. storing small tensors l and m
-        2. instruction (code)
-    */
-    args.kv_block_size = l2_cache_size_ / (static_cast<int>(sizeof(float)) * 4 * (qk_head_size + v_head_size));
-    args.kv_block_size = std::max(args.kv_block_size, 1);  // avoid kv_block_size = 0
-    args.q_block_size = std::min(args.kv_block_size, qk_head_size + v_head_size);
-    args.kv_block_size = std::min(args.kv_block_size, kv_sequence_length);  // No point to have kv_block_size > kv_sequence_length
-    args.q_block_size = std::min(args.q_block_size, q_sequence_length);     // No point to have q_block_size > q_sequence_length
+    SetFlashAttentionBlockSizes(args, l2_cache_size_);
 
-    auto* tp = context->GetOperatorThreadPool();
     args.thread_count = concurrency::ThreadPool::DegreeOfParallelism(tp);
-    args.buffer_size_per_thread = (static_cast<size_t>(args.q_block_size) * 2 +
-                                   static_cast<size_t>(args.q_block_size) * static_cast<size_t>(args.kv_block_size) +
-                                   static_cast<size_t>(args.q_block_size) * static_cast<size_t>(args.v_head_size)) *
-                                  sizeof(float);
+    args.type = MlasFlashAttentionFloat32;
+    // the causal mask of MultiHeadAttention matches the one of MLAS when the new key and query lengths are equal:
+    // query row i attends to the keys up to past_sequence_length + i
+    args.is_causal = is_unidirectional_;
+    args.buffer_size_per_thread = MlasFlashAttentionGetBufferSizePerThread(
+        args.type, static_cast<size_t>(args.q_block_size), static_cast<size_t>(args.kv_block_size),
+        static_cast<size_t>(args.qk_head_size), static_cast<size_t>(args.v_head_size));
     size_t buffer_bytes = args.buffer_size_per_thread * args.thread_count;
     IAllocatorUniquePtr<void> buffer = IAllocator::MakeUniquePtr<void>(allocator, buffer_bytes);
 
     args.buffer = reinterpret_cast<float*>(buffer.get());
 
     args.query = Q.Get<Tensor>().Data<float>();
-    args.key = K.Get<Tensor>().Data<float>();
-    args.value = V.Get<Tensor>().Data<float>();
+    args.key = k_data;
+    args.value = v_data;
     args.output = output->MutableData<float>();
 
     MlasFlashAttention(&args, tp);
@@ -3,17 +3,59 @@
 
 #include "core/providers/cpu/math/gemm.h"
 
+#include <type_traits>
+
 namespace onnxruntime {
 namespace contrib {
 
 constexpr const char* ACTIVATION_NAME_PREFIX = "activation_";
 constexpr size_t ACTIVATION_NAME_PREFIX_LEN = 11;
 
+namespace {
+
+// Converts the activations that MLAS can apply in the SGEMM epilogue into a MLAS_ACTIVATION.
+bool GetEpilogueActivation(const OpKernelInfo& info, const std::string& activation_type, MLAS_ACTIVATION& activation) {
+  if (activation_type == "Relu") {
+    activation.ActivationKind = MlasReluActivation;
+  } else if (activation_type == "LeakyRelu") {
+    activation.ActivationKind = MlasLeakyReluActivation;
+    activation.Parameters.LeakyRelu.alpha = info.GetAttrOrDefault<float>("activation_alpha", 0.01f);
+  } else if (activation_type == "Tanh") {
+    activation.ActivationKind = MlasTanhActivation;
+  } else if (activation_type == "Sigmoid") {
+    activation.ActivationKind = MlasLogisticActivation;
+  } else if (activation_type == "HardSigmoid") {
+    activation.ActivationKind = MlasHardSigmoidActivation;
+    activation.Parameters.HardSigmoid.alpha = info.GetAttrOrDefault<float>("activation_alpha", 0.2f);
+    activation.Parameters.HardSigmoid.beta = info.GetAttrOrDefault<float>("activation_beta", 0.5f);
+  } else if (activation_type == "Gelu") {
+    activation.ActivationKind = MlasGeluActivation;
+  } else if (activation_type == "FastGelu") {
+    activation.ActivationKind = MlasFastGeluActivation;
+  } else if (activation_type == "QuickGelu") {
+    activation.ActivationKind = MlasSiluActivation;
+    activation.Parameters.Silu.alpha = info.GetAttrOrDefault<float>("activation_alpha", 1.702f);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
 template <typename T>
 class FusedGemm final : public Gemm<T> {
  public:
   FusedGemm(const OpKernelInfo& info) : Gemm<T>(info) {
     std::string activation = info.GetAttrOrDefault<std::string>("activation", "");
+    if constexpr (std::is_same_v<T, float>) {
+      MLAS_ACTIVATION epilogue_activation;
+      if (GetEpilogueActivation(info, activation, epilogue_activation)) {
+        this->epilogue_activation_ = epilogue_activation;
+        return;
+      }
+    }
+
     NodeAttributes attrs;
     for (const auto& p : info.node().GetAttributes()) {
       if (p.first.size() > ACTIVATION_NAME_PREFIX_LEN && p.first.compare(0, ACTIVATION_NAME_PREFIX_LEN, ACTIVATION_NAME_PREFIX) == 0) {
@@ -13,6 +13,7 @@
 #include "contrib_ops/cpu/transformers/beam_search_scorer.h"
 #include "contrib_ops/cpu/transformers/generation_device_helper.h"
 #include "contrib_ops/cpu/transformers/sampling_cpu_helper.h"
+#include "contrib_ops/cpu/transformers/top_k_selection.h"
 #include "contrib_ops/cpu/transformers/subgraph_t5_decoder.h"
 #include "contrib_ops/cpu/transformers/subgraph_gpt.h"
 
@@ -20,6 +21,9 @@ namespace onnxruntime {
 namespace contrib {
 namespace GenerationCpuDeviceHelper {
 
+// Rows shorter than this are left to the core TopK implementation.
+constexpr int64_t kTopKSelectionMinRowSize = 4096;
+
 Status TopK(const Tensor* input, const int axis, const unsigned k, bool largest, bool sorted,
             AllocatorPtr allocator,
             Stream* /*stream*/,
@@ -27,6 +31,25 @@ Status TopK(const Tensor* input, const int axis, const unsigned k, bool largest,
             Tensor& output_values,
             Tensor& output_indices) {
   if (input->IsDataType<float>()) {
+    // Beam search selects 2 * num_beams candidates from num_beams * vocab_size scores per batch: filter the row by a
+    // threshold then only sort the candidates, instead of keeping a heap over the whole row.
+    const TensorShape& input_shape = input->Shape();
+    const int64_t num_dims = static_cast<int64_t>(input_shape.NumDimensions());
+    if (largest && num_dims > 0 && (axis == -1 || axis == num_dims - 1) && k > 1) {
+      const int64_t cols = input_shape[onnxruntime::narrow<size_t>(num_dims - 1)];
+      const int64_t min_cols = static_cast<int64_t>(k * transformers::top_k_selection::kMinRowSizeToK);
+      if (cols >= kTopKSelectionMinRowSize && min_cols <= cols) {
+        TensorShape output_shape = input_shape;
+        output_shape[onnxruntime::narrow<size_t>(num_dims - 1)] = k;
+        output_values = Tensor(input->DataType(), output_shape, allocator);
+        output_indices = Tensor(DataTypeImpl::GetType<int64_t>(), output_shape, allocator);
+        transformers::SelectTopKRows<float>(input->Data<float>(), input_shape.SizeToDimension(num_dims - 1), cols, k,
+                                            threadpool, output_values.MutableData<float>(),
+                                            output_indices.MutableData<int64_t>());
+        return Status::OK();
+      }
+    }
+
     return GetTopK<float>(input, axis, k, largest, sorted, allocator, threadpool, output_values, output_indices);
   }
 
@@ -90,8 +90,8 @@ struct ISamplingState {
   size_t temp_storage_bytes;
   std::default_random_engine generator;
 
-  gsl::span<T> sorted_scores;
-  gsl::span<T> cumulative_probs;
+  gsl::span<int32_t> top_indices;
+  gsl::span<T> probs;
 };
 
 struct ISequences {
@@ -113,6 +113,11 @@ class GreedySearch : public IControlFlowKernel {
   std::unique_ptr<GptSubgraph> init_run_gpt_subgraph_;
   std::unique_ptr<GptSubgraph> gpt_subgraph_;
 
+  // Relevant only for GPT2 with speculative decoding
+  // The draft_gpt_subgraph_ (if the `draft_decoder` attribute is present) proposes tokens
+  // that the gpt_subgraph_ verifies in one run.
+  std::unique_ptr<GptSubgraph> draft_gpt_subgraph_;
+
   // Relevant only for T5
   // Same concept as above.
   // The encoder will be used for the first run and the decoder will
@@ -123,12 +128,16 @@ class GreedySearch : public IControlFlowKernel {
   // FeedsFetchesManager* encoder_feeds_fetches_manager_;
   FeedsFetchesManager* decoder_feeds_fetches_manager_;
   FeedsFetchesManager* init_run_decoder_feeds_fetches_manager_;
+  FeedsFetchesManager* draft_decoder_feeds_fetches_manager_ = nullptr;
 
   IConsoleDumper* dumper_;
 
   GreedySearchParameters parameters_;
 
   bool has_init_decoder_ = false;
+
+  bool has_draft_decoder_ = false;
+  int num_speculative_tokens_ = 0;
 };
 
 }  // namespace transformers
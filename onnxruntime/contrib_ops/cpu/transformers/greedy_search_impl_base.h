@@ -49,8 +49,8 @@ struct SamplingState : public ISamplingState<T> {
       }
     } else {
       // TODO: Some buffer can be reused for CPU
-      this->sorted_scores = AllocateBuffer<T>(cpu_allocator, sorted_scores_buffer_, SafeInt<size_t>(total_count), stream);
-      this->cumulative_probs = AllocateBuffer<T>(cpu_allocator, cumulative_probs_buffer_, SafeInt<size_t>(total_count), stream);
+      this->top_indices = AllocateBuffer<int32_t>(cpu_allocator, top_indices_buffer_, SafeInt<size_t>(total_count), stream);
+      this->probs = AllocateBuffer<T>(cpu_allocator, probs_buffer_, SafeInt<size_t>(total_count), stream);
     }
   }
 
@@ -66,8 +66,8 @@ struct SamplingState : public ISamplingState<T> {
   IAllocatorUniquePtr<void> h_sampled_all_buffer_;
   IAllocatorUniquePtr<void> d_indices_buffer_;
   IAllocatorUniquePtr<void> d_presence_mask_buffer_;
-  IAllocatorUniquePtr<void> sorted_scores_buffer_;
-  IAllocatorUniquePtr<void> cumulative_probs_buffer_;
+  IAllocatorUniquePtr<void> top_indices_buffer_;
+  IAllocatorUniquePtr<void> probs_buffer_;
 };
 
 template <typename T>
@@ -3,10 +3,12 @@
 
 #pragma once
 #include <algorithm>
+#include <cstring>
 #include <vector>
 
 #include "core/common/span_utils.h"
 #include "contrib_ops/cpu/transformers/greedy_search_impl_base.h"
+#include "contrib_ops/cpu/transformers/greedy_search_parameters.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -79,12 +81,55 @@ class GreedySearchGpt : public GreedySearchBase<T, ParametersT> {
   }
 #endif
 
+  // Enable speculative decoding after the first decoding run: the draft subgraph proposes up to
+  // num_speculative_tokens tokens one by one, then the GPT subgraph runs once over all of them. The proposed tokens
+  // are accepted while they match the tokens generated from the logits of the GPT subgraph, so the sequences are
+  // the same as without a draft subgraph.
+  Status InitializeSpeculativeDecoding(const SessionState* draft_decoder_session_state,
+                                       GptSubgraph* draft_gpt_subgraph,
+                                       const FeedsFetchesManager* draft_feeds_fetches_manager,
+                                       int num_speculative_tokens);
+
   // Execute beam search in iterations util stopping criteria is reached.
   // In each iteration, GPT subgraph is called, and next token for each sequence is generated.
   Status Execute(const FeedsFetchesManager* init_run_feeds_fetches_manager,
                  const FeedsFetchesManager& feeds_fetches_manager);
 
  private:
+  // Generate the remaining tokens with speculative decoding. The feeds are ready for the decoder subgraph run
+  // over the last token of the sequence.
+  Status ExecuteSpeculativeDecoding(const FeedsFetchesManager& feeds_fetches_manager,
+                                    std::vector<OrtValue>& feeds,
+                                    GreedySearchState<T>& greedy_state,
+                                    ISamplingState<T>& sampling_state,
+                                    int& current_length,
+                                    int& iteration_counter);
+
+  // Set input_ids, position_ids and attention_mask for a subgraph run over tokens that follow past_length tokens.
+  void SetSpeculativeFeeds(gsl::span<const int32_t> tokens,
+                           int past_length,
+                           int position_offset,
+                           gsl::span<const int32_t> prompt_attention_mask,
+                           std::vector<OrtValue>& feeds);
+
+  // Feed the present state of a subgraph run to its past state inputs, keeping the first past_length positions.
+  // This rolls back the KV cache of the tokens that were rejected.
+  void UpdateSpeculativePastState(const GptSubgraph& subgraph,
+                                  const std::vector<OrtValue>& fetches,
+                                  std::vector<OrtValue>& feeds,
+                                  int past_length);
+
+  // Keep the first past_length positions of the past state inputs of a subgraph.
+  void TruncateSpeculativePastState(const GptSubgraph& subgraph,
+                                    std::vector<OrtValue>& feeds,
+                                    int past_length);
+
+  // State of shape (2, batch_size, num_heads, sequence_length, head_size) with its first past_length positions.
+  OrtValue KeepPastPositions(const OrtValue& state, int past_length);
+
+  // Token with the largest logit in the last position of the logits of batch_size 1.
+  static int32_t ArgMaxLastPosition(const Tensor& logits);
+
   // Prepare the inputs for first inference of subgraph
   Status CreateInitialFeeds(gsl::span<int32_t>& sequence_lengths,
                             OrtValue& expanded_input_ids,
@@ -116,8 +161,290 @@ class GreedySearchGpt : public GreedySearchBase<T, ParametersT> {
 
   const void* cuda_device_prop_ = nullptr;
   int cuda_device_arch_ = 0;
+
+  // Speculative decoding
+  const SessionState* draft_decoder_session_state_ = nullptr;
+  GptSubgraph* draft_gpt_subgraph_ = nullptr;
+  const FeedsFetchesManager* draft_feeds_fetches_manager_ = nullptr;
+  int num_speculative_tokens_ = 0;
+  int32_t num_draft_tokens_ = 0;
+  int32_t num_accepted_draft_tokens_ = 0;
 };
 
+template <typename T, typename ParametersT>
+Status GreedySearchGpt<T, ParametersT>::InitializeSpeculativeDecoding(
+    const SessionState* draft_decoder_session_state,
+    GptSubgraph* draft_gpt_subgraph,
+    const FeedsFetchesManager* draft_feeds_fetches_manager,
+    int num_speculative_tokens) {
+  ORT_RETURN_IF(this->IsCuda(), "Speculative decoding is only supported on CPU");
+  ORT_RETURN_IF(this->parameters_->batch_size != 1,
+                "Speculative decoding requires batch_size 1, got ", this->parameters_->batch_size);
+  ORT_RETURN_IF(gpt_subgraph_.past_present_share_buffer_ || draft_gpt_subgraph->past_present_share_buffer_,
+                "Speculative decoding does not support past_present_share_buffer");
+  ORT_RETURN_IF(draft_gpt_subgraph->vocab_size != this->parameters_->vocab_size,
+                "draft_decoder subgraph vocabulary size ", draft_gpt_subgraph->vocab_size,
+                " shall be same as decoder subgraph vocabulary size ", this->parameters_->vocab_size);
+
+  draft_decoder_session_state_ = draft_decoder_session_state;
+  draft_gpt_subgraph_ = draft_gpt_subgraph;
+  draft_feeds_fetches_manager_ = draft_feeds_fetches_manager;
+  num_speculative_tokens_ = num_speculative_tokens;
+  return Status::OK();
+}
+
+template <typename T, typename ParametersT>
+void GreedySearchGpt<T, ParametersT>::SetSpeculativeFeeds(gsl::span<const int32_t> tokens,
+                                                          int past_length,
+                                                          int position_offset,
+                                                          gsl::span<const int32_t> prompt_attention_mask,
+                                                          std::vector<OrtValue>& feeds) {
+  const int64_t sequence_length = static_cast<int64_t>(tokens.size());
+  const int64_t total_length = past_length + sequence_length;
+  auto int32_type = DataTypeImpl::GetType<int32_t>();
+
+  OrtValue input_ids;
+  Tensor::InitOrtValue(int32_type, TensorShape({1, sequence_length}), this->temp_space_allocator_, input_ids);
+  gsl::copy(tokens, input_ids.GetMutable<Tensor>()->MutableDataAsSpan<int32_t>());
+
+  OrtValue position_ids;
+  Tensor::InitOrtValue(int32_type, TensorShape({1, sequence_length}), this->temp_space_allocator_, position_ids);
+  int32_t* position_data = position_ids.GetMutable<Tensor>()->MutableData<int32_t>();
+  for (int64_t i = 0; i < sequence_length; i++) {
+    position_data[i] = static_cast<int32_t>(past_length + i + position_offset);
+  }
+
+  // The generated tokens are never masked.
+  OrtValue attention_mask;
+  Tensor::InitOrtValue(int32_type, TensorShape({1, total_length}), this->temp_space_allocator_, attention_mask);
+  int32_t* mask_data = attention_mask.GetMutable<Tensor>()->MutableData<int32_t>();
+  std::copy(prompt_attention_mask.begin(), prompt_attention_mask.end(), mask_data);
+  std::fill(mask_data + prompt_attention_mask.size(), mask_data + total_length, 1);
+
+  feeds[0] = input_ids;
+  feeds[1] = position_ids;
+  feeds[2] = attention_mask;
+}
+
+template <typename T, typename ParametersT>
+void GreedySearchGpt<T, ParametersT>::UpdateSpeculativePastState(const GptSubgraph& subgraph,
+                                                                 const std::vector<OrtValue>& fetches,
+                                                                 std::vector<OrtValue>& feeds,
+                                                                 int past_length) {
+  for (int layer = 0; layer < subgraph.num_layers; layer++) {
+    const OrtValue& present_value = fetches[static_cast<size_t>(subgraph.GetFirstPresentOutputIndex()) + layer];
+    feeds[static_cast<size_t>(subgraph.GetFirstPastInputIndex()) + layer] = KeepPastPositions(present_value,
+                                                                                              past_length);
+  }
+}
+
+template <typename T, typename ParametersT>
+void GreedySearchGpt<T, ParametersT>::TruncateSpeculativePastState(const GptSubgraph& subgraph,
+                                                                   std::vector<OrtValue>& feeds,
+                                                                   int past_length) {
+  for (int layer = 0; layer < subgraph.num_layers; layer++) {
+    OrtValue& past_value = feeds[static_cast<size_t>(subgraph.GetFirstPastInputIndex()) + layer];
+    past_value = KeepPastPositions(past_value, past_length);
+  }
+}
+
+template <typename T, typename ParametersT>
+OrtValue GreedySearchGpt<T, ParametersT>::KeepPastPositions(const OrtValue& state, int past_length) {
+  const Tensor& source_tensor = state.Get<Tensor>();
+  const TensorShape& source_shape = source_tensor.Shape();
+  if (source_shape[3] == past_length) {
+    return state;
+  }
+
+  TensorShape past_shape = source_shape;
+  past_shape[3] = past_length;
+  OrtValue past_value;
+  Tensor::InitOrtValue(source_tensor.DataType(), past_shape, this->temp_space_allocator_, past_value);
+
+  const size_t num_rows = SafeInt<size_t>(source_shape.SizeToDimension(3));
+  const size_t source_row_bytes = SafeInt<size_t>(source_shape.SizeFromDimension(3)) * source_tensor.DataType()->Size();
+  const size_t past_row_bytes = SafeInt<size_t>(past_shape.SizeFromDimension(3)) * source_tensor.DataType()->Size();
+  const char* source = static_cast<const char*>(source_tensor.DataRaw());
+  char* target = static_cast<char*>(past_value.GetMutable<Tensor>()->MutableDataRaw());
+  for (size_t row = 0; row < num_rows; row++) {
+    memcpy(target + row * past_row_bytes, source + row * source_row_bytes, past_row_bytes);
+  }
+  return past_value;
+}
+
+template <typename T, typename ParametersT>
+int32_t GreedySearchGpt<T, ParametersT>::ArgMaxLastPosition(const Tensor& logits) {
+  // Logits shape is (1, sequence_length, vocab_size).
+  const int64_t vocab_size = logits.Shape()[2];
+  const int64_t offset = (logits.Shape()[1] - 1) * vocab_size;
+
+  if (logits.IsDataType<float>()) {
+    const float* scores = logits.Data<float>() + offset;
+    return static_cast<int32_t>(std::max_element(scores, scores + vocab_size) - scores);
+  }
+
+  const MLFloat16* scores = logits.Data<MLFloat16>() + offset;
+  return static_cast<int32_t>(std::max_element(scores, scores + vocab_size,
+                                               [](MLFloat16 a, MLFloat16 b) { return a.ToFloat() < b.ToFloat(); }) -
+                              scores);
+}
+
+template <typename T, typename ParametersT>
+Status GreedySearchGpt<T, ParametersT>::ExecuteSpeculativeDecoding(const FeedsFetchesManager& feeds_fetches_manager,
+                                                                   std::vector<OrtValue>& feeds,
+                                                                   GreedySearchState<T>& greedy_state,
+                                                                   ISamplingState<T>& sampling_state,
+                                                                   int& current_length,
+                                                                   int& iteration_counter) {
+  const ParametersT* parameters = this->parameters_;
+  const int prompt_length = parameters->sequence_length;
+
+  // Padding of the prompt has no position, so the token at index i of the sequence has position i + position_offset.
+  // The attention mask of the prompt is kept for all runs.
+  const int position_offset = greedy_state.sequence_lengths[0] - prompt_length;
+  std::vector<int32_t> prompt_attention_mask(feeds[2].Get<Tensor>().Data<int32_t>(),
+                                             feeds[2].Get<Tensor>().Data<int32_t>() + prompt_length);
+
+  // Run the prompt through the draft subgraph to fill its past state.
+  std::vector<OrtValue> draft_feeds;
+  std::vector<OrtValue> draft_fetches;
+  IAllocatorUniquePtr<char> draft_buffer;
+  {
+    const Tensor& input_ids = this->context_.GetInputOrtValue(0)->Get<Tensor>();
+    int32_t draft_sequence_length = 0;
+    gsl::span<int32_t> draft_sequence_lengths(&draft_sequence_length, 1);
+    OrtValue draft_input_ids;
+    ORT_RETURN_IF_ERROR(draft_gpt_subgraph_->CreateInitialFeeds(input_ids,
+                                                                this->implicit_inputs_,
+                                                                parameters->num_beams,
+                                                                parameters->pad_token_id,
+                                                                draft_sequence_lengths,
+                                                                draft_input_ids,
+                                                                this->context_.GetInputOrtValue(6),
+                                                                draft_feeds,
+                                                                this->create_inputs_func_,
+                                                                this->add_to_feeds_func_,
+                                                                draft_buffer,
+                                                                this->ort_stream_));
+  }
+  ORT_RETURN_IF_ERROR(utils::ExecuteSubgraph(*draft_decoder_session_state_,
+                                             *draft_feeds_fetches_manager_,
+                                             draft_feeds,
+                                             draft_fetches,
+                                             {},
+                                             ExecutionMode::ORT_SEQUENTIAL,
+                                             this->context_.GetTerminateFlag(),
+                                             this->context_.Logger(),
+                                             this->ort_stream_));
+  int draft_past_length = prompt_length;
+  UpdateSpeculativePastState(*draft_gpt_subgraph_, draft_fetches, draft_feeds, draft_past_length);
+  draft_fetches.clear();
+
+  // All the tokens but the last one of the sequence are in the past state of the decoder subgraph.
+  int past_length = current_length - 1;
+  std::vector<int32_t> draft_tokens;
+  std::vector<int32_t> verify_tokens;
+  std::vector<OrtValue> fetches;
+  while (current_length < parameters->max_length) {
+    // A decoder run over the proposed tokens generates one token more than the accepted ones.
+    const int num_draft_tokens = std::min(num_speculative_tokens_, parameters->max_length - current_length - 1);
+    gsl::span<const int32_t> sequence = greedy_state.sequences.GetSequence(0);
+    verify_tokens.assign(sequence.begin() + past_length, sequence.end());
+
+    // The first draft run catches up with the tokens generated since its last run.
+    draft_tokens.clear();
+    std::vector<int32_t> draft_input(sequence.begin() + draft_past_length, sequence.end());
+    for (int i = 0; i < num_draft_tokens; i++) {
+      SetSpeculativeFeeds(draft_input, draft_past_length, position_offset, prompt_attention_mask, draft_feeds);
+#ifdef DEBUG_NODE_INPUTS_OUTPUTS
+      const_cast<SessionState*>(draft_decoder_session_state_)->IncrementGraphExecutionCounter();
+#endif
+      ORT_RETURN_IF_ERROR(utils::ExecuteSubgraph(*draft_decoder_session_state_,
+                                                 *draft_feeds_fetches_manager_,
+                                                 draft_feeds,
+                                                 draft_fetches,
+                                                 {},
+                                                 ExecutionMode::ORT_SEQUENTIAL,
+                                                 this->context_.GetTerminateFlag(),
+                                                 this->context_.Logger(),
+                                                 this->ort_stream_));
+
+      draft_tokens.push_back(ArgMaxLastPosition(draft_fetches[0].Get<Tensor>()));
+      draft_past_length += static_cast<int>(draft_input.size());
+      UpdateSpeculativePastState(*draft_gpt_subgraph_, draft_fetches, draft_feeds, draft_past_length);
+      draft_fetches.clear();
+      draft_input.assign(1, draft_tokens.back());
+    }
+
+    // Verify the proposed tokens with one decoder run.
+    verify_tokens.insert(verify_tokens.end(), draft_tokens.begin(), draft_tokens.end());
+    SetSpeculativeFeeds(verify_tokens, past_length, position_offset, prompt_attention_mask, feeds);
+#ifdef DEBUG_NODE_INPUTS_OUTPUTS
+    const_cast<SessionState&>(this->decoder_session_state_).IncrementGraphExecutionCounter();
+#endif
+    ORT_RETURN_IF_ERROR(utils::ExecuteSubgraph(this->decoder_session_state_,
+                                               feeds_fetches_manager,
+                                               feeds,
+                                               fetches,
+                                               {},
+                                               ExecutionMode::ORT_SEQUENTIAL,
+                                               this->context_.GetTerminateFlag(),
+                                               this->context_.Logger(),
+                                               this->ort_stream_));
+
+    // Generate the tokens position by position, as the logits processors need the sequence up to each position.
+    Tensor* logits = fetches[0].GetMutable<Tensor>();
+    const int64_t vocab_size = logits->Shape()[2];
+    int num_accepted = 0;
+    bool eos_meet = false;
+    for (int i = 0; i <= num_draft_tokens; i++) {
+      OrtValue position_logits;
+      Tensor::InitOrtValue(logits->DataType(), TensorShape({1, 1, vocab_size}),
+                           logits->MutableData<T>() + i * vocab_size, logits->Location(), position_logits);
+
+      gsl::span<int32_t> next_tokens;
+      ORT_RETURN_IF_ERROR(this->GenerateNextToken(position_logits,
+                                                  next_tokens,
+                                                  greedy_state,
+                                                  sampling_state,
+                                                  ++iteration_counter,
+                                                  parameters->eos_token_id));
+      if (greedy_state.eos_meet[0]) {
+        eos_meet = true;
+        break;
+      }
+
+      ++current_length;
+      if (i == num_draft_tokens || next_tokens[0] != draft_tokens[i]) {
+        break;
+      }
+      ++num_accepted;
+    }
+
+    num_draft_tokens_ += num_draft_tokens;
+    num_accepted_draft_tokens_ += num_accepted;
+    if (eos_meet) {
+      break;
+    }
+
+    // Roll back the past state of the rejected tokens.
+    past_length = current_length - 1;
+    UpdateSpeculativePastState(gpt_subgraph_, fetches, feeds, past_length);
+    fetches.clear();
+
+    // The draft subgraph has seen the proposed tokens up to the last one, so its past state also holds the rejected
+    // ones.
+    if (draft_past_length > past_length) {
+      draft_past_length = past_length;
+      TruncateSpeculativePastState(*draft_gpt_subgraph_, draft_feeds, draft_past_length);
+    }
+  }
+
+  LOGS(this->context_.Logger(), VERBOSE) << "Speculative decoding accepted " << num_accepted_draft_tokens_
+                                         << " of " << num_draft_tokens_ << " draft tokens";
+  return Status::OK();
+}
+
 template <typename T, typename ParametersT>
 Status GreedySearchGpt<T, ParametersT>::CreateInitialFeeds(gsl::span<int32_t>& sequence_lengths,
                                                            OrtValue& expanded_input_ids,
@@ -374,6 +701,13 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
     } else {
       fetches.clear();
     }
+
+    // After the first run, the draft subgraph proposes the tokens for the remaining runs.
+    if (draft_gpt_subgraph_ != nullptr && current_length < parameters->max_length) {
+      ORT_RETURN_IF_ERROR(ExecuteSpeculativeDecoding(feeds_fetches_manager, feeds, greedy_state, sampling_state,
+                                                     current_length, iteration_counter));
+      break;
+    }
   }
 
   // Copy the sequences to output
@@ -386,12 +720,23 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
     gsl::copy(sequence_source, batch_output);
   }
 
+  if (std::is_same<ParametersT, GreedySearchParameters>::value) {
+    Tensor* speculative_stats = this->context_.Output(1, TensorShape({2}));
+    if (speculative_stats != nullptr) {
+      int32_t* stats = speculative_stats->MutableData<int32_t>();
+      stats[0] = num_draft_tokens_;
+      stats[1] = num_accepted_draft_tokens_;
+    }
+  }
+
 #ifdef DEBUG_GENERATION
   // Debug the one step filtered logits for sampling
   int64_t filtered_logits_dims[] = {parameters->batch_size, parameters->vocab_size};
   TensorShape filtered_logits_shape(&filtered_logits_dims[0],
                                     sizeof(filtered_logits_dims) / sizeof(filtered_logits_dims[0]));
-  Tensor* filtered_logits = this->context_.Output(1, filtered_logits_shape);
+  Tensor* filtered_logits = std::is_same<ParametersT, SamplingParameters>::value
+                                ? this->context_.Output(1, filtered_logits_shape)
+                                : nullptr;
   if (filtered_logits != nullptr) {
     gsl::span<float> filtered_logits_span = filtered_logits->MutableDataAsSpan<float>();
     for (int batch_id = 0; batch_id < parameters->batch_size; ++batch_id) {
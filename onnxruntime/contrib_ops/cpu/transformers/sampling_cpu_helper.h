@@ -2,58 +2,12 @@
 // Licensed under the MIT License.
 #pragma once
 
+#include "contrib_ops/cpu/transformers/top_k_selection.h"
+
 namespace onnxruntime {
 namespace contrib {
 namespace SamplingCpuHelper {
 
-template <typename T>
-void filter_scores(std::vector<size_t>& sorted_indice,
-                   gsl::span<T>& next_token_score,
-                   const transformers::IGenerationParameters* parameters,
-                   size_t chunk_offset,
-                   size_t offset) {
-  size_t real_index = sorted_indice[chunk_offset + offset];
-  next_token_score[chunk_offset + real_index] = (T)parameters->filter_value;
-}
-
-template <typename T>
-void cumulate_and_filter_custom(gsl::span<T>& next_token_scores,
-                                gsl::span<T>& cumulative_probs,
-                                const transformers::IGenerationParameters* parameters,
-                                std::vector<size_t>& sorted_indices) {
-  for (size_t i = 0; i < static_cast<size_t>(parameters->batch_size); i++) {
-    size_t offset = i * parameters->vocab_size;
-    if (cumulative_probs[offset] > parameters->top_p) {
-      filter_scores(sorted_indices, next_token_scores, parameters, offset, 1);
-    }
-    for (size_t j = 1; j < static_cast<size_t>(parameters->vocab_size) - 1; j++) {
-      cumulative_probs[j + offset] += cumulative_probs[j + offset - 1];
-      if (cumulative_probs[j + offset] > parameters->top_p) {
-        filter_scores(sorted_indices, next_token_scores, parameters, offset, j + 1);
-      }
-    }
-  }
-}
-
-template <typename T>
-void cumulate_and_filter(gsl::span<T>& next_token_scores,
-                         gsl::span<T>& cumulative_probs,
-                         const transformers::IGenerationParameters* parameters,
-                         std::vector<size_t>& sorted_indices) {
-  for (size_t i = 0; i < static_cast<size_t>(parameters->batch_size); i++) {
-    size_t offset = i * parameters->vocab_size;
-    if (cumulative_probs[offset] <= 1 - parameters->top_p) {
-      filter_scores(sorted_indices, next_token_scores, parameters, offset, 0);
-    }
-    for (size_t j = 1; j < static_cast<size_t>(parameters->vocab_size) - static_cast<size_t>(parameters->min_tokens_to_keep); j++) {
-      cumulative_probs[j + offset] += cumulative_probs[j + offset - 1];
-      if (cumulative_probs[j + offset] <= 1 - parameters->top_p) {
-        filter_scores(sorted_indices, next_token_scores, parameters, offset, j);
-      }
-    }
-  }
-}
-
 template <typename T>
 Status Sample(AllocatorPtr& allocator,
               onnxruntime::concurrency::ThreadPool* thread_pool,
@@ -64,55 +18,51 @@ Status Sample(AllocatorPtr& allocator,
               const IConsoleDumper* dumper) {
   ORT_UNUSED_PARAMETER(dumper);
 
-  gsl::span<T>& sorted_scores = sampling_state->sorted_scores;
-  memcpy(sorted_scores.data(), next_token_scores.data(), next_token_scores.size_bytes());
-  std::vector<size_t> sorted_indices(static_cast<size_t>(parameters->batch_size) * static_cast<size_t>(parameters->vocab_size));
-
-  std::function<bool(T, T)> predicator;
-  if (parameters->custom_sampling) {
-    predicator = std::greater<T>();
-  } else {
-    predicator = std::less<T>();
-  }
-
-  // TODO: This could be optimized with allocated buffer and handwritten sort algorithm
-  for (size_t i = 0; i < static_cast<size_t>(parameters->batch_size); i++) {
-    auto indices_begin = sorted_indices.begin() + i * parameters->vocab_size;
-    auto indices_end = sorted_indices.begin() + (i + 1) * parameters->vocab_size;
-    gsl::span<T> next_token_score = next_token_scores.subspan(i * parameters->vocab_size, parameters->vocab_size);
-    std::iota(indices_begin, indices_end, 0);
-    std::sort(indices_begin, indices_end,
-              [&next_token_score, &predicator](size_t i1, size_t i2) {
-                return predicator(next_token_score[i1], next_token_score[i2]);
-              });
-
-    std::sort(sorted_scores.begin() + i * parameters->vocab_size,
-              sorted_scores.begin() + (i + 1) * parameters->vocab_size,
-              predicator);
-  }
-
-#ifdef DEBUG_GENERATION
-  dumper->Print("sorted_scores", sorted_scores.data(), parameters->batch_size, parameters->vocab_size);
-  dumper->Print("sorted_indices", sorted_indices.data(), parameters->batch_size, parameters->vocab_size);
-#endif
-
-  gsl::span<T>& cumulative_probs = sampling_state->cumulative_probs;
+  const size_t batch_size = static_cast<size_t>(parameters->batch_size);
+  const size_t vocab_size = static_cast<size_t>(parameters->vocab_size);
 
+  gsl::span<T>& probs = sampling_state->probs;
   ORT_RETURN_IF_ERROR(SoftmaxCPU<T>(parameters->batch_size,
                                     parameters->vocab_size,
-                                    sorted_scores.data(),
-                                    cumulative_probs.data(),
+                                    next_token_scores.data(),
+                                    probs.data(),
                                     false,
                                     thread_pool));
 
-  if (parameters->custom_sampling) {
-    cumulate_and_filter_custom(next_token_scores, cumulative_probs, parameters, sorted_indices);
-  } else {
-    cumulate_and_filter(next_token_scores, cumulative_probs, parameters, sorted_indices);
-  }
+  // Only the tokens kept by top-p filtering are selected and sorted, instead of the whole vocabulary.
+  // Standard sampling keeps the tokens whose more probable tokens have a total probability less than top_p, and at
+  // least min_tokens_to_keep tokens but the least probable one. Custom sampling keeps the most probable token and the
+  // tokens whose more probable tokens have a total probability not more than top_p.
+  const bool keep_equal = parameters->custom_sampling;
+  const size_t min_tokens_to_keep =
+      parameters->custom_sampling
+          ? 1
+          : std::min(static_cast<size_t>(std::max(parameters->min_tokens_to_keep, 0)), vocab_size - 1);
+
+  gsl::span<int32_t>& top_indices = sampling_state->top_indices;
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(batch_size),
+      [&](std::ptrdiff_t i) {
+        const size_t offset = static_cast<size_t>(i) * vocab_size;
+        gsl::span<T> row_scores = next_token_scores.subspan(offset, vocab_size);
+        gsl::span<T> row_probs = probs.subspan(offset, vocab_size);
+        gsl::span<int32_t> row_indices = top_indices.subspan(offset, vocab_size);
+
+        const size_t num_kept = transformers::SelectTopP<T>(row_probs, parameters->top_p, keep_equal,
+                                                            min_tokens_to_keep, row_indices);
+
+        // The probabilities are not needed anymore: keep the scores of the selected tokens there while the row is
+        // filtered.
+        for (size_t j = 0; j < num_kept; j++) {
+          row_probs[j] = row_scores[row_indices[j]];
+        }
+        std::fill(row_scores.begin(), row_scores.end(), static_cast<T>(parameters->filter_value));
+        for (size_t j = 0; j < num_kept; j++) {
+          row_scores[row_indices[j]] = row_probs[j];
+        }
+      });
 
 #ifdef DEBUG_GENERATION
-  dumper->Print("cumulative_probs after filtering", cumulative_probs.data(), parameters->batch_size, parameters->vocab_size);
   dumper->Print("next_token_scores after filtering", next_token_scores.data(), parameters->batch_size, parameters->vocab_size);
 #endif
 
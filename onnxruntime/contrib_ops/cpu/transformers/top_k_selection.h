@@ -0,0 +1,168 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include <gsl/gsl>
+#include "core/common/common.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+// Selection of the largest scores of a vocabulary sized row for the top-k and top-p filtering of the generation
+// ops. Only the few scores that can be in the result are sorted, instead of the whole row.
+namespace top_k_selection {
+
+// A row shorter than this ratio of k is fully selected instead of filtered by a threshold first.
+constexpr size_t kMinRowSizeToK = 16;
+
+// The threshold is taken from a prefix of the row with this ratio of the row size.
+constexpr size_t kThresholdSampleRatio = 16;
+
+// Tokens selected by the first top-p pass, multiplied by kTopPGrowth until the top-p mass is reached.
+constexpr size_t kTopPInitialTokens = 64;
+constexpr size_t kTopPGrowth = 4;
+
+}  // namespace top_k_selection
+
+// Writes the indices of the k largest scores to the first k entries of `indices`, in descending order of score and
+// ascending order of index for equal scores. `indices` is a scratch buffer of at least scores.size() entries.
+template <typename T>
+void SelectTopK(gsl::span<const T> scores, size_t k, gsl::span<int32_t> indices) {
+  const size_t n = scores.size();
+  k = std::min(k, n);
+  ORT_ENFORCE(indices.size() >= n, "indices buffer is smaller than the row");
+  if (k == 0) {
+    return;
+  }
+
+  const auto greater = [&scores](int32_t a, int32_t b) {
+    return scores[a] > scores[b] || (scores[a] == scores[b] && a < b);
+  };
+
+  size_t num_candidates = n;
+  if (k * top_k_selection::kMinRowSizeToK <= n) {
+    // The k-th largest score of a prefix of the row is not larger than the k-th largest score of the row, so any
+    // score below it cannot be selected. The prefix is large enough to leave a few times k candidates.
+    const size_t sample_size = std::max(k * top_k_selection::kMinRowSizeToK / 4,
+                                        n / top_k_selection::kThresholdSampleRatio);
+    std::iota(indices.begin(), indices.begin() + sample_size, 0);
+    std::nth_element(indices.begin(), indices.begin() + (k - 1), indices.begin() + sample_size, greater);
+    const T threshold = scores[indices[k - 1]];
+
+    // Branch free compaction of the candidates.
+    const T* data = scores.data();
+    int32_t* candidates = indices.data();
+    num_candidates = 0;
+    for (size_t i = 0; i < n; i++) {
+      candidates[num_candidates] = static_cast<int32_t>(i);
+      num_candidates += static_cast<size_t>(data[i] >= threshold);
+    }
+  } else {
+    std::iota(indices.begin(), indices.begin() + n, 0);
+  }
+
+  if (num_candidates > k) {
+    std::nth_element(indices.begin(), indices.begin() + (k - 1), indices.begin() + num_candidates, greater);
+  }
+  std::sort(indices.begin(), indices.begin() + k, greater);
+}
+
+// Selects the most probable tokens kept by top-p filtering, and returns their number. Their indices are written to
+// the first entries of `indices` in descending order of probability.
+// A token is kept while the total probability of the more probable tokens is less than top_p, or not more than
+// top_p when `keep_equal` is true. The first min_tokens_to_keep tokens are kept in any case.
+// `indices` is a scratch buffer of at least probs.size() entries.
+template <typename T>
+size_t SelectTopP(gsl::span<const T> probs, float top_p, bool keep_equal, size_t min_tokens_to_keep,
+                  gsl::span<int32_t> indices) {
+  const size_t n = probs.size();
+  min_tokens_to_keep = std::min(min_tokens_to_keep, n);
+  ORT_ENFORCE(indices.size() >= n, "indices buffer is smaller than the row");
+
+  // Scans the sorted indices [begin, end) and sets the number of kept tokens once a token is filtered.
+  T cumulative_prob = 0;
+  size_t num_kept = n;
+  const auto scan = [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      const bool filtered = keep_equal ? cumulative_prob > top_p : cumulative_prob >= top_p;
+      if (filtered) {
+        num_kept = std::max(i, min_tokens_to_keep);
+        return true;
+      }
+      cumulative_prob += probs[indices[i]];
+    }
+    return false;
+  };
+
+  // The order of the selection does not depend on k, so a larger selection starts with the previous one.
+  size_t k = std::min(n, std::max(top_k_selection::kTopPInitialTokens, min_tokens_to_keep));
+  size_t num_scanned = 0;
+  while (k * top_k_selection::kMinRowSizeToK <= n) {
+    SelectTopK(probs, k, indices);
+    if (scan(num_scanned, k)) {
+      return num_kept;
+    }
+    num_scanned = k;
+    k *= top_k_selection::kTopPGrowth;
+  }
+
+  // Once the candidates are no longer a small part of the row, a threshold does not filter much: split the row in
+  // blocks of growing size, and only sort the blocks until the top-p mass is reached. The probabilities are copied
+  // next to their indices, which is faster to sort than indices alone.
+  std::vector<std::pair<T, int32_t>> sorted(n);
+  for (size_t i = 0; i < n; i++) {
+    sorted[i] = {probs[i], static_cast<int32_t>(i)};
+  }
+  const auto greater = [](const std::pair<T, int32_t>& a, const std::pair<T, int32_t>& b) {
+    return a.first > b.first || (a.first == b.first && a.second < b.second);
+  };
+
+  cumulative_prob = 0;
+  size_t begin = 0;
+  while (begin < n) {
+    const size_t end = std::min(n, std::max(k, begin * 2));
+    if (end < n) {
+      std::nth_element(sorted.begin() + begin, sorted.begin() + (end - 1), sorted.end(), greater);
+    }
+    std::sort(sorted.begin() + begin, sorted.begin() + end, greater);
+    for (size_t i = begin; i < end; i++) {
+      indices[i] = sorted[i].second;
+    }
+    if (scan(begin, end)) {
+      return num_kept;
+    }
+    begin = end;
+  }
+  return n;
+}
+
+// Top k of each row of a (rows, cols) matrix, in descending order of score. The rows are selected in parallel.
+template <typename T>
+void SelectTopKRows(const T* scores, int64_t rows, int64_t cols, size_t k,
+                    concurrency::ThreadPool* thread_pool, T* top_scores, int64_t* top_indices) {
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(rows),
+      [&](std::ptrdiff_t row) {
+        std::vector<int32_t> indices(static_cast<size_t>(cols));
+        gsl::span<const T> row_scores(scores + row * cols, static_cast<size_t>(cols));
+        SelectTopK(row_scores, k, gsl::make_span(indices));
+        T* row_top_scores = top_scores + static_cast<size_t>(row) * k;
+        int64_t* row_top_indices = top_indices + static_cast<size_t>(row) * k;
+        for (size_t i = 0; i < k; i++) {
+          row_top_scores[i] = row_scores[indices[i]];
+          row_top_indices[i] = indices[i];
+        }
+      });
+}
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
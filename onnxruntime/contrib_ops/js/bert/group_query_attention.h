@@ -34,6 +34,14 @@ class GroupQueryAttention : public JsKernel, GQAAttentionBase {
                                static_cast<int32_t>(use_smooth_softmax_),
                                static_cast<int32_t>(local_window_size_));
   }
+
+  Status ComputeInternal(OpKernelContext* context) const override {
+    if (context->Input<Tensor>(9) != nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "The paged kv cache (block_table) is only supported on CPU.");
+    }
+
+    return JsKernel::ComputeInternal(context);
+  }
 };
 
 }  // namespace js
@@ -159,6 +159,9 @@ Status GroupQueryAttention<T>::ComputeInternal(OpKernelContext* ctx) const {
   const Tensor* total_seqlen = ctx->Input<Tensor>(6);
   const Tensor* cos_cache = ctx->Input<Tensor>(7);
   const Tensor* sin_cache = ctx->Input<Tensor>(8);
+  if (ctx->Input<Tensor>(9) != nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "The paged kv cache (block_table) is only supported on CPU.");
+  }
 
   auto& device_prop = GetDeviceProp();
   std::call_once(
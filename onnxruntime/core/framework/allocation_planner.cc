@@ -372,6 +372,12 @@ class PlannerImpl {
       }
     }
 
+    // an in-place update is only safe once the other consumers of the input are done, which depends on the order
+    // the nodes run in
+    if (context_->IsParallelExecutionEnabled()) {
+      return false;
+    }
+
     const auto& inplace_map = ci.kernel_def->MayInplace();
     for (auto& pair : inplace_map) {
       if (pair.second == output_arg_num) {
@@ -1537,7 +1543,7 @@ class PlannerImpl {
               }
             }
           }
-        } else if (!context_->IsParallelExecutionEnabled() &&
+        } else if ((!context_->IsParallelExecutionEnabled() || context_->GetEnableAliasReuseInParallel()) &&
                    FindReusableInput(graph_viewer_, *pnode, static_cast<int>(output_arg_def_index),
                                      &reused, &is_strided_tensor)) {
           // Re-using inputs is applicable for tensors, sequence tensors,
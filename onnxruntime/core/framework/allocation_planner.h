@@ -46,15 +46,21 @@ class ISequentialPlannerContext {
   virtual ExecutionOrder GetExecutionOrder() const { return ExecutionOrder::DEFAULT; }
 
   virtual bool GetEnableMemoryReuse() const { return true; }
+
+  // If it returns true, the outputs of kernels that alias an input (e.g. Reshape) reuse the input buffer even when
+  // parallel execution is enabled. In-place updates and the reuse of dead buffers stay disabled.
+  virtual bool GetEnableAliasReuseInParallel() const { return false; }
   virtual ~ISequentialPlannerContext() = default;
 };
 
 class SequentialPlannerContext : public ISequentialPlannerContext {
  public:
-  SequentialPlannerContext(ExecutionMode execution_mode, ExecutionOrder execution_order, bool enable_memory_reuse)
+  SequentialPlannerContext(ExecutionMode execution_mode, ExecutionOrder execution_order, bool enable_memory_reuse,
+                           bool enable_alias_reuse_in_parallel = false)
       : execution_mode_(execution_mode),
         execution_order_(execution_order),
-        enable_memory_reuse_(enable_memory_reuse) {
+        enable_memory_reuse_(enable_memory_reuse),
+        enable_alias_reuse_in_parallel_(enable_alias_reuse_in_parallel) {
   }
 
   const ONNX_NAMESPACE::TensorShapeProto* GetShape(const onnxruntime::NodeArg& arg) const override {
@@ -67,10 +73,13 @@ class SequentialPlannerContext : public ISequentialPlannerContext {
 
   bool GetEnableMemoryReuse() const override { return enable_memory_reuse_; }
 
+  bool GetEnableAliasReuseInParallel() const override { return enable_alias_reuse_in_parallel_; }
+
  private:
   ExecutionMode execution_mode_ = ExecutionMode::ORT_SEQUENTIAL;
   ExecutionOrder execution_order_ = ExecutionOrder::DEFAULT;
   bool enable_memory_reuse_ = true;
+  bool enable_alias_reuse_in_parallel_ = false;
 };
 
 #ifdef ORT_ENABLE_STREAM
@@ -22,6 +22,11 @@ struct AllocatorStats {
                                   // is known. Certain allocator may return 0 to indicate the limit is
                                   // unknown.
   int64_t bytes_limit;
+  int64_t num_thread_cache_hits;     // Allocations served from a per-thread cache without taking the arena lock.
+  int64_t num_thread_cache_misses;   // Allocations that had to refill a per-thread cache.
+  int64_t num_idle_region_releases;  // Number of arena regions released after being idle for the idle shrink window.
+  int64_t idle_released_bytes;       // Total bytes of the arena regions released after being idle.
+  int64_t recent_max_bytes_in_use;   // The maximum bytes in use during the last idle shrink window.
 
   AllocatorStats() { Clear(); }
 
@@ -35,6 +40,11 @@ struct AllocatorStats {
     this->max_alloc_size = 0;
     this->bytes_limit = 0;
     this->total_allocated_bytes = 0;
+    this->num_thread_cache_hits = 0;
+    this->num_thread_cache_misses = 0;
+    this->num_idle_region_releases = 0;
+    this->idle_released_bytes = 0;
+    this->recent_max_bytes_in_use = 0;
   }
 
   std::string DebugString() const {
@@ -47,7 +57,12 @@ struct AllocatorStats {
        << "NumReserves:              " << this->num_reserves << "\n"
        << "NumArenaExtensions:       " << this->num_arena_extensions << "\n"
        << "NumArenaShrinkages:       " << this->num_arena_shrinkages << "\n"
-       << "MaxAllocSize:             " << this->max_alloc_size << "\n";
+       << "MaxAllocSize:             " << this->max_alloc_size << "\n"
+       << "NumThreadCacheHits:       " << this->num_thread_cache_hits << "\n"
+       << "NumThreadCacheMisses:     " << this->num_thread_cache_misses << "\n"
+       << "NumIdleRegionReleases:    " << this->num_idle_region_releases << "\n"
+       << "IdleReleasedBytes:        " << this->idle_released_bytes << "\n"
+       << "RecentMaxInUse:           " << this->recent_max_bytes_in_use << "\n";
     return ss.str();
   }
 };
@@ -34,6 +34,12 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
     int64_t max_power_of_two_extend_bytes = info.arena_cfg.max_power_of_two_extend_bytes == -1
                                                 ? BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES
                                                 : info.arena_cfg.max_power_of_two_extend_bytes;
+    int64_t thread_cache_max_block_size = info.arena_cfg.thread_cache_max_block_size == -1
+                                              ? BFCArena::DEFAULT_THREAD_CACHE_MAX_BLOCK_SIZE
+                                              : info.arena_cfg.thread_cache_max_block_size;
+    int64_t idle_shrink_ms = info.arena_cfg.idle_shrink_ms == -1
+                                 ? BFCArena::DEFAULT_IDLE_SHRINK_MS
+                                 : info.arena_cfg.idle_shrink_ms;
     ArenaExtendStrategy arena_extend_str;
     switch (info.arena_cfg.arena_extend_strategy) {
       case static_cast<int>(ArenaExtendStrategy::kSameAsRequested):
@@ -70,7 +76,9 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
                                      initial_chunk_size_bytes,
                                      max_dead_bytes_per_chunk,
                                      initial_growth_chunk_size_bytes,
-                                     max_power_of_two_extend_bytes));
+                                     max_power_of_two_extend_bytes,
+                                     thread_cache_max_block_size,
+                                     idle_shrink_ms));
     }
   } else {
     return device_allocator;
@@ -0,0 +1,325 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/arena_thread_cache.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "core/framework/bfc_arena.h"
+
+namespace onnxruntime {
+
+// Tracks the thread caches each thread created and which ArenaThreadCache instances are still alive, so that a
+// thread can release its caches when it exits and stale entries of destroyed arenas are never dereferenced.
+struct ArenaThreadCacheRegistry {
+  struct Entry {
+    uint64_t owner_id;
+    ArenaThreadCache* owner;
+    ArenaThreadCache::ThreadCache* thread_cache;
+  };
+
+  struct ThreadEntries {
+    std::vector<Entry> entries;
+
+    ~ThreadEntries() {
+      std::lock_guard<std::mutex> lock(Mutex());
+      for (const auto& entry : entries) {
+        // an owner can't be destroyed while the mutex is held as it unregisters first
+        if (LiveIds().count(entry.owner_id) != 0) {
+          entry.owner->ReleaseThreadCache(entry.thread_cache);
+        }
+      }
+    }
+  };
+
+  // intentionally leaked so they outlive the thread_local ThreadEntries of the main thread
+  static std::mutex& Mutex() {
+    static auto* mutex = new std::mutex();
+    return *mutex;
+  }
+
+  static std::unordered_set<uint64_t>& LiveIds() {
+    static auto* live_ids = new std::unordered_set<uint64_t>();
+    return *live_ids;
+  }
+
+  static ThreadEntries& CurrentThread() {
+    thread_local ThreadEntries thread_entries;
+    return thread_entries;
+  }
+
+  static uint64_t Register() {
+    static std::atomic<uint64_t> next_id{1};
+    const uint64_t id = next_id++;
+    std::lock_guard<std::mutex> lock(Mutex());
+    LiveIds().insert(id);
+    return id;
+  }
+
+  static void Unregister(uint64_t id) {
+    std::lock_guard<std::mutex> lock(Mutex());
+    LiveIds().erase(id);
+  }
+
+  static void AddToCurrentThread(const Entry& entry) {
+    std::lock_guard<std::mutex> lock(Mutex());
+    auto& entries = CurrentThread().entries;
+    const auto& live_ids = LiveIds();
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [&live_ids](const Entry& e) { return live_ids.count(e.owner_id) == 0; }),
+                  entries.end());
+    entries.push_back(entry);
+  }
+};
+
+ArenaThreadCache::ArenaThreadCache(BFCArena& arena, size_t max_block_size)
+    : arena_(arena),
+      id_(ArenaThreadCacheRegistry::Register()),
+      slab_table_(std::make_unique<SlabTableEntry[]>(kSlabTableSize)) {
+  max_block_size = std::clamp(max_block_size, kMinBlockSize, kMaxBlockSize);
+  num_size_classes_ = 1;
+  while (SizeClassBlockSize(num_size_classes_ - 1) < max_block_size) {
+    ++num_size_classes_;
+  }
+
+  max_block_size_ = SizeClassBlockSize(num_size_classes_ - 1);
+}
+
+ArenaThreadCache::~ArenaThreadCache() {
+  // The slabs are part of the arena's regions which are released by the arena itself
+  ArenaThreadCacheRegistry::Unregister(id_);
+}
+
+int ArenaThreadCache::SizeClassForSize(size_t size) const {
+  int size_class = 0;
+  while (SizeClassBlockSize(size_class) < size) {
+    ++size_class;
+  }
+
+  return size_class;
+}
+
+size_t ArenaThreadCache::MagazineCapacity(int size_class) const {
+  // cache up to 64KB per size class and thread, but at least a few blocks of the larger sizes
+  constexpr size_t kMagazineBytes = 64 * 1024;
+  return std::clamp<size_t>(kMagazineBytes / SizeClassBlockSize(size_class), 4, 128);
+}
+
+size_t ArenaThreadCache::SlabTableIndex(uintptr_t key, size_t probe) {
+  // Fibonacci hashing spreads the consecutive slab indices of a slab group over the table
+  constexpr uint64_t kGoldenRatio = 0x9E3779B97F4A7C15ull;
+  const auto hash = static_cast<size_t>((static_cast<uint64_t>(key) * kGoldenRatio) >> (64 - kSlabTableBits));
+  return (hash + probe) & (kSlabTableSize - 1);
+}
+
+int ArenaThreadCache::LookupSizeClass(const void* p) const {
+  const uintptr_t key = reinterpret_cast<uintptr_t>(p) / kSlabSize + 1;
+  for (size_t probe = 0; probe < kSlabTableSize; ++probe) {
+    const SlabTableEntry& entry = slab_table_[SlabTableIndex(key, probe)];
+    const uintptr_t entry_key = entry.key.load(std::memory_order_acquire);
+    if (entry_key == key) {
+      return entry.size_class;
+    }
+
+    if (entry_key == 0) {
+      break;
+    }
+  }
+
+  return -1;
+}
+
+ArenaThreadCache::ThreadCache& ArenaThreadCache::GetThreadCache() {
+  // no lock is needed to read the entries of the current thread as only the current thread modifies them
+  for (const auto& entry : ArenaThreadCacheRegistry::CurrentThread().entries) {
+    if (entry.owner_id == id_) {
+      return *entry.thread_cache;
+    }
+  }
+
+  auto thread_cache = std::make_unique<ThreadCache>();
+  for (int c = 0; c < num_size_classes_; ++c) {
+    thread_cache->magazines[c].reserve(MagazineCapacity(c));
+  }
+
+  ThreadCache* result = thread_cache.get();
+  {
+    std::lock_guard<std::mutex> lock(thread_caches_mutex_);
+    thread_caches_.push_back(std::move(thread_cache));
+  }
+
+  ArenaThreadCacheRegistry::AddToCurrentThread({id_, this, result});
+  return *result;
+}
+
+void* ArenaThreadCache::Alloc(size_t size) {
+  if (size == 0 || size > max_block_size_) {
+    return nullptr;
+  }
+
+  const int size_class = SizeClassForSize(size);
+  ThreadCache& thread_cache = GetThreadCache();
+  auto& magazine = thread_cache.magazines[size_class];
+
+  if (!magazine.empty()) {
+    thread_cache.hits.store(thread_cache.hits.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  } else {
+    thread_cache.misses.store(thread_cache.misses.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    Refill(size_class, magazine, std::max<size_t>(1, MagazineCapacity(size_class) / 2));
+    if (magazine.empty()) {
+      return nullptr;
+    }
+  }
+
+  void* p = magazine.back();
+  magazine.pop_back();
+  return p;
+}
+
+bool ArenaThreadCache::Free(void* p) {
+  const int size_class = LookupSizeClass(p);
+  if (size_class < 0) {
+    return false;
+  }
+
+  auto& magazine = GetThreadCache().magazines[size_class];
+  const size_t capacity = MagazineCapacity(size_class);
+  if (magazine.size() >= capacity) {
+    Drain(size_class, magazine, capacity / 2);
+  }
+
+  magazine.push_back(p);
+  return true;
+}
+
+size_t ArenaThreadCache::BlockSize(const void* p) const {
+  const int size_class = LookupSizeClass(p);
+  return size_class < 0 ? 0 : SizeClassBlockSize(size_class);
+}
+
+void ArenaThreadCache::GetStats(AllocatorStats& stats) const {
+  std::lock_guard<std::mutex> lock(thread_caches_mutex_);
+  stats.num_thread_cache_hits += released_hits_;
+  stats.num_thread_cache_misses += released_misses_;
+  for (const auto& thread_cache : thread_caches_) {
+    stats.num_thread_cache_hits += thread_cache->hits.load(std::memory_order_relaxed);
+    stats.num_thread_cache_misses += thread_cache->misses.load(std::memory_order_relaxed);
+  }
+}
+
+size_t ArenaThreadCache::NumThreadCaches() const {
+  std::lock_guard<std::mutex> lock(thread_caches_mutex_);
+  return thread_caches_.size();
+}
+
+void ArenaThreadCache::ReleaseThreadCache(ThreadCache* thread_cache) {
+  for (int c = 0; c < num_size_classes_; ++c) {
+    auto& magazine = thread_cache->magazines[c];
+    Drain(c, magazine, magazine.size());
+  }
+
+  std::lock_guard<std::mutex> lock(thread_caches_mutex_);
+  released_hits_ += thread_cache->hits.load(std::memory_order_relaxed);
+  released_misses_ += thread_cache->misses.load(std::memory_order_relaxed);
+  thread_caches_.erase(std::find_if(thread_caches_.begin(), thread_caches_.end(),
+                                    [thread_cache](const std::unique_ptr<ThreadCache>& t) {
+                                      return t.get() == thread_cache;
+                                    }));
+}
+
+void ArenaThreadCache::FlushCurrentThread() {
+  for (const auto& entry : ArenaThreadCacheRegistry::CurrentThread().entries) {
+    if (entry.owner_id == id_) {
+      for (int c = 0; c < num_size_classes_; ++c) {
+        auto& magazine = entry.thread_cache->magazines[c];
+        Drain(c, magazine, magazine.size());
+      }
+    }
+  }
+}
+
+void ArenaThreadCache::Refill(int size_class, std::vector<void*>& magazine, size_t count) {
+  CentralFreeList& central = central_[size_class];
+  const size_t block_size = SizeClassBlockSize(size_class);
+
+  std::lock_guard<std::mutex> lock(central.mutex);
+
+  const size_t from_free_list = std::min(count, central.blocks.size());
+  magazine.insert(magazine.end(), central.blocks.end() - from_free_list, central.blocks.end());
+  central.blocks.resize(central.blocks.size() - from_free_list);
+
+  for (size_t i = from_free_list; i < count; ++i) {
+    if (central.carve_ptr == central.carve_end) {
+      char* slab = NewSlab(size_class);
+      if (slab == nullptr) {
+        break;
+      }
+
+      central.carve_ptr = slab;
+      central.carve_end = slab + kSlabSize;
+    }
+
+    magazine.push_back(central.carve_ptr);
+    central.carve_ptr += block_size;
+  }
+}
+
+void ArenaThreadCache::Drain(int size_class, std::vector<void*>& magazine, size_t count) {
+  CentralFreeList& central = central_[size_class];
+  count = std::min(count, magazine.size());
+
+  std::lock_guard<std::mutex> lock(central.mutex);
+  central.blocks.insert(central.blocks.end(), magazine.end() - count, magazine.end());
+  magazine.resize(magazine.size() - count);
+}
+
+char* ArenaThreadCache::NewSlab(int size_class) {
+  std::lock_guard<std::mutex> lock(slab_mutex_);
+
+  if (free_slabs_.empty()) {
+    if (num_slabs_ + kSlabsPerGroup + 1 > kMaxSlabs) {
+      return nullptr;
+    }
+
+    // over-allocate by one slab so that kSlabsPerGroup slabs aligned to kSlabSize fit in the chunk
+    constexpr size_t kGroupBytes = (kSlabsPerGroup + 1) * kSlabSize;
+    void* group = nullptr;
+    ORT_TRY {
+      group = arena_.AllocateRawInternal(kGroupBytes, false, nullptr, false, nullptr);
+    }
+    ORT_CATCH(const std::exception&) {
+      // the arena is out of memory. the caller falls back to the arena so the failure is reported for the
+      // actual request.
+    }
+
+    if (group == nullptr) {
+      return nullptr;
+    }
+
+    const uintptr_t group_begin = reinterpret_cast<uintptr_t>(group);
+    const uintptr_t group_end = group_begin + kGroupBytes;
+    for (uintptr_t slab = (group_begin + kSlabSize - 1) / kSlabSize * kSlabSize; slab + kSlabSize <= group_end;
+         slab += kSlabSize) {
+      free_slabs_.push_back(reinterpret_cast<char*>(slab));
+    }
+  }
+
+  char* slab = free_slabs_.back();
+  free_slabs_.pop_back();
+
+  const uintptr_t key = reinterpret_cast<uintptr_t>(slab) / kSlabSize + 1;
+  for (size_t probe = 0;; ++probe) {
+    SlabTableEntry& entry = slab_table_[SlabTableIndex(key, probe)];
+    if (entry.key.load(std::memory_order_relaxed) == 0) {
+      entry.size_class = size_class;
+      entry.key.store(key, std::memory_order_release);
+      break;
+    }
+  }
+
+  ++num_slabs_;
+  return slab;
+}
+
+}  // namespace onnxruntime
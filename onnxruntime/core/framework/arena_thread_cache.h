@@ -0,0 +1,137 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/allocator_stats.h"
+
+namespace onnxruntime {
+
+class BFCArena;
+
+// A front-end for BFCArena that serves small allocations from per-thread caches of fixed size blocks so that
+// they don't contend on the lock of the arena.
+//
+// Blocks are carved from slabs of kSlabSize bytes that are aligned to kSlabSize, so the size class of a pointer
+// is found with a lock-free lookup of its slab in a fixed size table. Each thread keeps a magazine of free blocks
+// per size class. An empty magazine is refilled in bulk from the central free list of its size class, and a full
+// magazine returns half of its blocks to it. Only the central free lists and slab creation take a lock.
+//
+// Slabs are taken from the arena in groups and are returned to it only when the arena is destroyed, so the memory
+// held by the cache is not released by BFCArena::Shrink(). The cache of a thread is released when the thread exits,
+// and its blocks are returned to the central free lists.
+class ArenaThreadCache {
+ public:
+  static constexpr size_t kMinBlockSize = 64;
+  static constexpr size_t kMaxBlockSize = 64 * 1024;
+  static constexpr size_t kSlabSize = 256 * 1024;
+
+  // Blocks of up to `max_block_size` bytes (rounded up to a power of two and capped at kMaxBlockSize)
+  // are served by the cache.
+  ArenaThreadCache(BFCArena& arena, size_t max_block_size);
+  ~ArenaThreadCache();
+
+  size_t MaxBlockSize() const { return max_block_size_; }
+
+  // Returns nullptr if `size` is not served by the cache or the cache has run out of slabs.
+  // The caller should fall back to the arena in that case.
+  void* Alloc(size_t size);
+
+  // Returns false if `p` was not allocated by the cache.
+  bool Free(void* p);
+
+  // Returns the size of the block `p` points to, or 0 if `p` was not allocated by the cache.
+  size_t BlockSize(const void* p) const;
+
+  // Adds the cache hit/miss counters of all threads to `stats`.
+  void GetStats(AllocatorStats& stats) const;
+
+  // Returns the blocks cached by the calling thread to the central free lists.
+  void FlushCurrentThread();
+
+  // Returns the number of threads that have a cache and have not exited.
+  size_t NumThreadCaches() const;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ArenaThreadCache);
+
+ private:
+  static constexpr int kMaxSizeClasses = 11;  // 64 bytes .. 64KB
+  static constexpr int kSlabTableBits = 16;
+  static constexpr size_t kSlabTableSize = size_t{1} << kSlabTableBits;
+  // keep the table at most half full so probes stay short
+  static constexpr size_t kMaxSlabs = kSlabTableSize / 2;
+  static constexpr size_t kSlabsPerGroup = 8;
+
+  struct ThreadCache {
+    std::array<std::vector<void*>, kMaxSizeClasses> magazines;
+    // only written by the owning thread
+    std::atomic<int64_t> hits{0};
+    std::atomic<int64_t> misses{0};
+  };
+
+  struct alignas(64) CentralFreeList {
+    std::mutex mutex;
+    std::vector<void*> blocks;
+    // unused part of the slab blocks of this size class are currently carved from
+    char* carve_ptr = nullptr;
+    char* carve_end = nullptr;
+  };
+
+  struct SlabTableEntry {
+    // slab index (address / kSlabSize) + 1, 0 for an empty entry
+    std::atomic<uintptr_t> key{0};
+    int size_class = -1;
+  };
+
+  int SizeClassForSize(size_t size) const;
+  size_t SizeClassBlockSize(int size_class) const { return kMinBlockSize << size_class; }
+  size_t MagazineCapacity(int size_class) const;
+
+  static size_t SlabTableIndex(uintptr_t key, size_t probe);
+  int LookupSizeClass(const void* p) const;
+
+  ThreadCache& GetThreadCache();
+
+  // Moves up to `count` blocks of `size_class` from the central free list into `magazine`.
+  void Refill(int size_class, std::vector<void*>& magazine, size_t count);
+
+  // Moves `count` blocks from the back of `magazine` to the central free list of `size_class`.
+  void Drain(int size_class, std::vector<void*>& magazine, size_t count);
+
+  // Returns the blocks of an exiting thread to the central free lists and destroys its cache.
+  void ReleaseThreadCache(ThreadCache* thread_cache);
+
+  // Takes a free slab (allocating a new group from the arena if needed) and assigns it to `size_class`.
+  // Returns nullptr if no more slabs can be created.
+  char* NewSlab(int size_class);
+
+  BFCArena& arena_;
+  const uint64_t id_;
+  size_t max_block_size_;
+  int num_size_classes_;
+
+  std::array<CentralFreeList, kMaxSizeClasses> central_;
+
+  std::mutex slab_mutex_;
+  std::vector<char*> free_slabs_;
+  size_t num_slabs_ = 0;
+  std::unique_ptr<SlabTableEntry[]> slab_table_;
+
+  mutable std::mutex thread_caches_mutex_;
+  std::vector<std::unique_ptr<ThreadCache>> thread_caches_;
+  // hit/miss counters of the released thread caches
+  int64_t released_hits_ = 0;
+  int64_t released_misses_ = 0;
+
+  friend struct ArenaThreadCacheRegistry;
+};
+
+}  // namespace onnxruntime
@@ -3,6 +3,7 @@
 
 #include "core/framework/allocator.h"
 #include "core/framework/bfc_arena.h"
+#include <chrono>
 #include <type_traits>
 
 namespace onnxruntime {
@@ -12,7 +13,9 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
                    int initial_chunk_size_bytes,
                    int max_dead_bytes_per_chunk,
                    int initial_growth_chunk_size_bytes,
-                   int64_t max_power_of_two_extend_bytes)
+                   int64_t max_power_of_two_extend_bytes,
+                   int64_t thread_cache_max_block_size,
+                   int64_t idle_shrink_ms)
     : IAllocator(OrtMemoryInfo(resource_allocator->Info().name,
                                OrtAllocatorType::OrtArenaAllocator,
                                resource_allocator->Info().device,
@@ -25,14 +28,17 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
       initial_chunk_size_bytes_(initial_chunk_size_bytes),
       max_dead_bytes_per_chunk_(max_dead_bytes_per_chunk),
       initial_growth_chunk_size_bytes_(initial_growth_chunk_size_bytes),
-      max_power_of_two_extend_bytes_(max_power_of_two_extend_bytes) {
+      max_power_of_two_extend_bytes_(max_power_of_two_extend_bytes),
+      idle_shrink_ms_(std::max<int64_t>(idle_shrink_ms, 0)) {
   LOGS_DEFAULT(INFO) << "Creating BFCArena for " << device_allocator_->Info().name
                      << " with following configs: initial_chunk_size_bytes: " << initial_chunk_size_bytes_
                      << " max_dead_bytes_per_chunk: " << max_dead_bytes_per_chunk_
                      << " initial_growth_chunk_size_bytes: " << initial_growth_chunk_size_bytes_
                      << " max_power_of_two_extend_bytes: " << max_power_of_two_extend_bytes_
                      << " memory limit: " << total_memory
-                     << " arena_extend_strategy: " << static_cast<int32_t>(arena_extend_strategy);
+                     << " arena_extend_strategy: " << static_cast<int32_t>(arena_extend_strategy)
+                     << " thread_cache_max_block_size: " << thread_cache_max_block_size
+                     << " idle_shrink_ms: " << idle_shrink_ms;
 
   // static_cast<std::underlying_type_t<ArenaExtendStrategy>>(arena_extend_strategy); doesn't work on this compiler
 
@@ -75,9 +81,29 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
       ORT_ENFORCE(BinForSize(bin_size * 2) != BinFromIndex(b));
     }
   }
+
+  if (thread_cache_max_block_size > 0) {
+    thread_cache_ = std::make_unique<ArenaThreadCache>(*this, static_cast<size_t>(thread_cache_max_block_size));
+  }
+
+  if (idle_shrink_ms_ > 0) {
+    idle_shrink_thread_ = std::thread(&BFCArena::IdleShrinkLoop, this);
+  }
 }
 
 BFCArena::~BFCArena() {
+  if (idle_shrink_thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(idle_shrink_mutex_);
+      idle_shrink_stop_ = true;
+    }
+    idle_shrink_cv_.notify_one();
+    idle_shrink_thread_.join();
+  }
+
+  // the slabs of the thread cache are released with the regions below
+  thread_cache_.reset();
+
   for (const auto& region : region_manager_.regions()) {
     device_allocator_->Free(region.ptr());
   }
@@ -213,6 +239,9 @@ Status BFCArena::Extend(size_t rounded_bytes) {
                      << static_cast<void*>(static_cast<char*>(mem_addr) + bytes);
   region_manager_.AddAllocationRegion(mem_addr, bytes, stats_.num_arena_extensions);
   stats_.num_arena_extensions += 1;
+  if (idle_shrink_ms_ > 0) {
+    region_manager_.set_last_use_tick(mem_addr, idle_shrink_tick_);
+  }
 
   // Create one large chunk for the whole memory space that will
   // be chunked later.
@@ -269,6 +298,13 @@ size_t BFCArena::RoundedBytes(size_t bytes) {
 }
 
 void* BFCArena::Alloc(size_t size) {
+  if (thread_cache_ != nullptr) {
+    void* p = thread_cache_->Alloc(size);
+    if (p != nullptr) {
+      return p;
+    }
+  }
+
   return AllocateRawInternal(size, false, nullptr, false, nullptr);
 }
 
@@ -289,10 +325,19 @@ void* BFCArena::Reserve(size_t size) {
   stats_.max_alloc_size = std::max<size_t>(static_cast<size_t>(stats_.max_alloc_size), size);
   stats_.max_bytes_in_use = std::max<int64_t>(static_cast<int64_t>(stats_.max_bytes_in_use), stats_.bytes_in_use);
   stats_.total_allocated_bytes += size;
+  window_max_bytes_in_use_ = std::max(window_max_bytes_in_use_, stats_.bytes_in_use);
   return ptr;
 }
 
 size_t BFCArena::RequestedSize(const void* ptr) {
+  // the thread cache doesn't track the requested size, so report the size of the block
+  if (thread_cache_ != nullptr) {
+    size_t block_size = thread_cache_->BlockSize(ptr);
+    if (block_size != 0) {
+      return block_size;
+    }
+  }
+
   std::lock_guard<std::mutex> lock(lock_);
   BFCArena::ChunkHandle h = region_manager_.get_handle(ptr);
   ORT_ENFORCE(h != kInvalidChunkHandle);
@@ -301,6 +346,13 @@ size_t BFCArena::RequestedSize(const void* ptr) {
 }
 
 size_t BFCArena::AllocatedSize(const void* ptr) {
+  if (thread_cache_ != nullptr) {
+    size_t block_size = thread_cache_->BlockSize(ptr);
+    if (block_size != 0) {
+      return block_size;
+    }
+  }
+
   std::lock_guard<std::mutex> lock(lock_);
   BFCArena::ChunkHandle h = region_manager_.get_handle(ptr);
   ORT_ENFORCE(h != kInvalidChunkHandle);
@@ -379,6 +431,9 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
 void BFCArena::GetStats(AllocatorStats* stats) {
   std::lock_guard<std::mutex> lock(lock_);
   *stats = stats_;
+  if (thread_cache_ != nullptr) {
+    thread_cache_->GetStats(*stats);
+  }
 }
 
 BFCArena::Chunk* BFCArena::SplitFreeChunkFromBin(BFCArena::Bin::FreeChunkSet* free_chunks,
@@ -410,6 +465,9 @@ BFCArena::Chunk* BFCArena::SplitFreeChunkFromBin(BFCArena::Bin::FreeChunkSet* fr
       std::max(stats_.max_bytes_in_use, stats_.bytes_in_use);
   stats_.max_alloc_size =
       std::max<int64_t>(stats_.max_alloc_size, static_cast<int64_t>(chunk->size));
+  if (idle_shrink_ms_ > 0) {
+    RecordIdleShrinkUse(chunk->ptr);
+  }
   return chunk;
 }
 
@@ -448,6 +506,9 @@ BFCArena::Chunk* BFCArena::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
     // if find some available chunk, make sure mark it as "being used" before return
     other_stream_candidate->allocation_id = next_allocation_id_++;
     other_stream_candidate->bin_num = kInvalidBinNum;
+    if (idle_shrink_ms_ > 0) {
+      RecordIdleShrinkUse(other_stream_candidate->ptr);
+    }
   }
 
   return other_stream_candidate;
@@ -496,6 +557,11 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
+
+  if (thread_cache_ != nullptr && thread_cache_->Free(p)) {
+    return;
+  }
+
   std::lock_guard<std::mutex> lock(lock_);
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
@@ -508,6 +574,42 @@ void BFCArena::Free(void* p) {
   }
 }
 
+bool BFCArena::IsRegionInUse(void* region_ptr) {
+  ChunkHandle h = region_manager_.get_handle(region_ptr);
+  while (h != kInvalidChunkHandle) {
+    const Chunk* c = ChunkFromHandle(h);
+    if (c->in_use()) {
+      return true;
+    }
+    h = c->next;
+  }
+
+  return false;
+}
+
+void BFCArena::FreeRegion(void* region_ptr, size_t region_size) {
+  stats_.num_arena_shrinkages += 1;
+  stats_.total_allocated_bytes -= region_size;
+
+  LOGS_DEFAULT(VERBOSE) << device_allocator_->Info().name << " BFC Arena shrunk by "
+                        << region_size << " bytes. "
+                        << " The total allocated bytes is now " << stats_.total_allocated_bytes;
+
+  ChunkHandle h = region_manager_.get_handle(region_ptr);
+  ChunkHandle temp = h;
+  while (h != kInvalidChunkHandle) {
+    const Chunk* c = ChunkFromHandle(h);
+    temp = c->next;
+    RemoveFreeChunkFromBin(h);
+    DeleteChunk(h);
+    h = temp;
+  }
+
+  device_allocator_->Free(region_ptr);
+  region_manager_.RemoveAllocationRegion(region_ptr);
+  stats_.num_arena_extensions--;
+}
+
 Status BFCArena::Shrink() {
   std::lock_guard<std::mutex> lock(lock_);
   auto num_regions = region_manager_.regions().size();
@@ -523,56 +625,72 @@ Status BFCArena::Shrink() {
     }
   }
 
-  size_t i = 0;
-  for (void* region_ptr : region_ptrs) {
-    bool deallocate_region = true;
-    ChunkHandle region_begin_chunk = region_manager_.get_handle(region_ptr);
-    ChunkHandle h = region_begin_chunk;
-    while (h != kInvalidChunkHandle) {
-      const Chunk* c = ChunkFromHandle(h);
-      if (c->in_use()) {
-        // at-least one used chunk found in the allocation region -
-        // so we cannot deallocate it
-        deallocate_region = false;
-        break;
-      }
-      h = c->next;
+  for (size_t i = 0; i < region_ptrs.size(); ++i) {
+    // at-least one used chunk found in the allocation region - so we cannot deallocate it
+    if (!IsRegionInUse(region_ptrs[i])) {
+      FreeRegion(region_ptrs[i], region_sizes[i]);
     }
+  }
 
-    if (deallocate_region) {
-      auto shrink_size = region_sizes[i];
-      stats_.num_arena_shrinkages += 1;
-      stats_.total_allocated_bytes -= shrink_size;
+  // Will affect how the arena grows if the arena extend strategy is kNextPowerOfTwo
+  // In case the extend strategy is kSameAsRequested, the arena growth is exactly the size of the memory request itself
+  curr_region_allocation_bytes_ = initial_growth_chunk_size_bytes_;
 
-      LOGS_DEFAULT(VERBOSE) << device_allocator_->Info().name << " BFC Arena shrunk by "
-                            << shrink_size << " bytes. "
-                            << " The total allocated bytes is now " << stats_.total_allocated_bytes;
+  return Status::OK();
+}
 
-      h = region_begin_chunk;
-      ChunkHandle temp = region_begin_chunk;
-      while (h != kInvalidChunkHandle) {
-        const Chunk* c = ChunkFromHandle(h);
-        temp = c->next;
-        RemoveFreeChunkFromBin(h);
-        DeleteChunk(h);
-        h = temp;
-      }
+Status BFCArena::ReleaseIdleRegions() {
+  std::lock_guard<std::mutex> lock(lock_);
+  std::vector<void*> region_ptrs;
+  std::vector<size_t> region_sizes;
 
-      device_allocator_->Free(region_ptr);
-      region_manager_.RemoveAllocationRegion(region_ptr);
-      stats_.num_arena_extensions--;
+  for (const auto& region : region_manager_.regions()) {
+    // a region used during the current window, or in use since, is not idle
+    if ((consider_first_allocation_region_for_shrinkage_ || region.id() != 0) &&
+        region.last_use_tick() < idle_shrink_tick_) {
+      region_ptrs.push_back(region.ptr());
+      region_sizes.push_back(region.memory_size());
     }
+  }
 
-    ++i;
+  bool released = false;
+  for (size_t i = 0; i < region_ptrs.size(); ++i) {
+    if (!IsRegionInUse(region_ptrs[i])) {
+      FreeRegion(region_ptrs[i], region_sizes[i]);
+      stats_.num_idle_region_releases += 1;
+      stats_.idle_released_bytes += static_cast<int64_t>(region_sizes[i]);
+      released = true;
+    }
   }
 
-  // Will affect how the arena grows if the arena extend strategy is kNextPowerOfTwo
-  // In case the extend strategy is kSameAsRequested, the arena growth is exactly the size of the memory request itself
-  curr_region_allocation_bytes_ = initial_growth_chunk_size_bytes_;
+  if (released) {
+    curr_region_allocation_bytes_ = initial_growth_chunk_size_bytes_;
+  }
+
+  stats_.recent_max_bytes_in_use = window_max_bytes_in_use_;
+  window_max_bytes_in_use_ = stats_.bytes_in_use;
+  ++idle_shrink_tick_;
 
   return Status::OK();
 }
 
+void BFCArena::RecordIdleShrinkUse(const void* ptr) {
+  region_manager_.set_last_use_tick(ptr, idle_shrink_tick_);
+  window_max_bytes_in_use_ = std::max(window_max_bytes_in_use_, stats_.bytes_in_use);
+}
+
+void BFCArena::IdleShrinkLoop() {
+  std::unique_lock<std::mutex> lock(idle_shrink_mutex_);
+  while (!idle_shrink_cv_.wait_for(lock, std::chrono::milliseconds(idle_shrink_ms_),
+                                   [this]() { return idle_shrink_stop_; })) {
+    auto status = ReleaseIdleRegions();
+    if (!status.IsOK()) {
+      LOGS_DEFAULT(WARNING) << "Failed to release idle regions of BFCArena for " << device_allocator_->Info().name
+                            << ": " << status.ErrorMessage();
+    }
+  }
+}
+
 void BFCArena::DeallocateRawInternal(void* ptr) {
   // Find the chunk from the ptr.
   BFCArena::ChunkHandle h = region_manager_.get_handle(ptr);
@@ -658,6 +776,9 @@ void BFCArena::FreeAndMaybeCoalesce(BFCArena::ChunkHandle h) {
 
   // Updates the stats.
   stats_.bytes_in_use -= c->size;
+  if (idle_shrink_ms_ > 0) {
+    RecordIdleShrinkUse(c->ptr);
+  }
 
   // This chunk is no longer in-use, consider coalescing the chunk
   // with adjacent chunks.
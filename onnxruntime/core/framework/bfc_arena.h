@@ -16,9 +16,11 @@ limitations under the License.
 
 #pragma once
 #include <array>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <thread>
 
 #include "onnxruntime_config.h"
 
@@ -29,6 +31,7 @@ limitations under the License.
 
 #include <mutex>
 #include "core/framework/arena_extend_strategy.h"
+#include "core/framework/arena_thread_cache.h"
 #include "core/framework/allocator.h"
 
 #include "core/framework/stream_handles.h"
@@ -61,6 +64,8 @@ class BFCArena : public IAllocator {
   static const int DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES = 2 * 1024 * 1024;
   static const int64_t DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES = 1024 * 1024 * 1024;  // 1GB
   static const size_t DEFAULT_MAX_MEM = std::numeric_limits<size_t>::max();
+  static const int64_t DEFAULT_THREAD_CACHE_MAX_BLOCK_SIZE = 0;  // disabled
+  static const int64_t DEFAULT_IDLE_SHRINK_MS = 0;               // disabled
 
   enum ArenaType {
     BaseArena,
@@ -73,7 +78,9 @@ class BFCArena : public IAllocator {
            int initial_chunk_size_bytes = DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
            int max_dead_bytes_per_chunk = DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
            int initial_growth_chunk_size_bytes = DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
-           int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES);
+           int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+           int64_t thread_cache_max_block_size = DEFAULT_THREAD_CACHE_MAX_BLOCK_SIZE,
+           int64_t idle_shrink_ms = DEFAULT_IDLE_SHRINK_MS);
 
   ~BFCArena() override;
 
@@ -86,13 +93,19 @@ class BFCArena : public IAllocator {
   void Free(void* p) override;
 
   // Frees all allocation regions in which no chunk is in use.
-  // Does not free any reserved chunks.
+  // Does not free any reserved chunks, nor the slabs of the per-thread cache (see ArenaThreadCache).
   // Resets the size that the arena will grow by in the next allocation to
   // `initial_growth_chunk_size_bytes_` but ultimately all
   // future allocation sizes are determined by the arena growth strategy
   // and the allocation request.
   Status Shrink();
 
+  // Frees the allocation regions in which no chunk is in use and that have not been used since the previous call.
+  // Usage is only tracked if the arena was created with idle_shrink_ms > 0, in which case a background thread calls
+  // this every idle_shrink_ms milliseconds, so that a region is freed once it has been idle for one to two windows.
+  // The same regions as for Shrink() are considered.
+  Status ReleaseIdleRegions();
+
   void* Reserve(size_t size) override;
 
   void GetStats(AllocatorStats* stats) override;
@@ -259,6 +272,8 @@ class BFCArena : public IAllocator {
     void* end_ptr() const { return end_ptr_; }
     size_t memory_size() const { return memory_size_; }
     int64_t id() const { return id_; }
+    int64_t last_use_tick() const { return last_use_tick_; }
+    void set_last_use_tick(int64_t tick) { last_use_tick_ = tick; }
     ChunkHandle get_handle(const void* p) const {
       return handles_[IndexFor(p)];
     }
@@ -271,6 +286,7 @@ class BFCArena : public IAllocator {
       std::swap(memory_size_, other.memory_size_);
       std::swap(end_ptr_, other.end_ptr_);
       std::swap(id_, other.id_);
+      std::swap(last_use_tick_, other.last_use_tick_);
       std::swap(handles_, other.handles_);
     }
 
@@ -289,6 +305,9 @@ class BFCArena : public IAllocator {
     // A unique identifier for this allocation region
     // (May be used by the client to track which allocation region was allocated first, second, and so on)
     int64_t id_ = -1;
+    // The idle shrink tick during which a chunk of this region was last allocated or freed.
+    // Only maintained if idle shrinking is enabled.
+    int64_t last_use_tick_ = 0;
 
     // Array of size "memory_size / kMinAllocationSize".  It is
     // indexed by (p-base) / kMinAllocationSize, contains ChunkHandle
@@ -333,6 +352,8 @@ class BFCArena : public IAllocator {
     }
     void erase(const void* p) { return MutableRegionFor(p)->erase(p); }
 
+    void set_last_use_tick(const void* p, int64_t tick) { MutableRegionFor(p)->set_last_use_tick(tick); }
+
     const std::vector<AllocationRegion>& regions() const { return regions_; }
 
    private:
@@ -392,6 +413,19 @@ class BFCArena : public IAllocator {
 
   BFCArena::ChunkHandle Coalesce(ChunkHandle h);
 
+  // Returns true if a chunk of the allocation region starting at 'region_ptr' is in use.
+  bool IsRegionInUse(void* region_ptr);
+
+  // Frees the allocation region starting at 'region_ptr', which must not have a chunk in use.
+  // Requires lock_ to be held.
+  void FreeRegion(void* region_ptr, size_t region_size);
+
+  // Records that a chunk at 'ptr' was allocated or freed, and the high-water mark of the current idle shrink window.
+  // Requires lock_ to be held and idle shrinking to be enabled.
+  void RecordIdleShrinkUse(const void* ptr);
+
+  void IdleShrinkLoop();
+
   // Adds the chunk 'h' to the proper free bin.
   void InsertFreeChunkIntoBin(ChunkHandle h);
 
@@ -514,6 +548,26 @@ class BFCArena : public IAllocator {
   // is to be considered for shrinkage or not.
   bool consider_first_allocation_region_for_shrinkage_;
 
+  // Serves small allocations from per-thread caches without taking lock_.
+  // nullptr unless enabled with thread_cache_max_block_size. Used by Alloc() only, so allocations made on a stream
+  // by StreamAwareArena are not cached.
+  std::unique_ptr<ArenaThreadCache> thread_cache_;
+
+  // Period of the background thread releasing idle regions. 0 if idle shrinking is disabled.
+  const int64_t idle_shrink_ms_;
+  // Number of idle shrink windows that have passed. Guarded by lock_.
+  int64_t idle_shrink_tick_ = 0;
+  // Maximum bytes in use during the current idle shrink window. Guarded by lock_.
+  int64_t window_max_bytes_in_use_ = 0;
+
+  std::mutex idle_shrink_mutex_;
+  std::condition_variable idle_shrink_cv_;
+  bool idle_shrink_stop_ = false;
+  std::thread idle_shrink_thread_;
+
+  // ArenaThreadCache takes its slabs from the arena via AllocateRawInternal()
+  friend class ArenaThreadCache;
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BFCArena);
 };
 #ifdef ORT_ENABLE_STREAM
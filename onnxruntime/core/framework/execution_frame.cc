@@ -406,11 +406,21 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
 
     // if there are some traditional ml value type in inputs disable the memory pattern optimization.
     if (all_tensors) {
-      mem_patterns_ = session_state.GetMemoryPatternGroup(feeds, feed_mlvalue_idxs, inferred_shapes_);
+      bool needs_replan = false;
+      mem_pattern_entry_ = session_state.GetMemoryPatternGroup(feeds, feed_mlvalue_idxs, needs_replan);
       // if no existing patterns, generate one in this execution frame
-      if (!mem_patterns_) {
+      if (!mem_pattern_entry_) {
         planner_.emplace(*session_state.GetExecutionPlan());
       } else {
+        mem_patterns_ = &mem_pattern_entry_->patterns;
+        inferred_shapes_ = &mem_pattern_entry_->inferred_shapes;
+
+        // an earlier execution with the same key needed larger blocks. trace this execution as well so that the
+        // pattern is regenerated with the larger of the planned and the actual sizes.
+        if (needs_replan) {
+          planner_.emplace(*session_state.GetExecutionPlan());
+        }
+
         // pre-allocate the big chunk requested in memory pattern.
         // all the internal kernel's input/output tensors will be allocated on these buffer.
         buffers_.reserve(mem_patterns_->locations.size());
@@ -548,14 +558,23 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
       if (block) {
         auto it = buffers_.find(location);
         if (it != buffers_.end()) {
-          // if the block is not correct, log message then fall back to default behavior
-          if (block->size_ == size) {
+          // if the block is not correct, log message then fall back to default behavior.
+          // with shape buckets the pattern is shared by different shapes, so a larger block can be used as well.
+          if (block->size_ == size ||
+              (block->size_ > size && session_state_.UsesMemoryPatternShapeBuckets())) {
             void* buffer = it->second.get();
             auto status = AllocateTensorWithPreAllocateBufferHelper(
                 ort_value, static_cast<void*>(static_cast<char*>(buffer) + block->offset_), element_type, location,
                 shape);
+            if (status.IsOK()) {
+              TraceAllocate(ort_value_index, block->size_);
+            }
             return status;
           } else {
+            if (block->size_ < size && session_state_.UsesMemoryPatternShapeBuckets()) {
+              mem_pattern_too_small_.store(true, std::memory_order_relaxed);
+            }
+
             // the block size may vary especially if the model has NonZero ops, or different sequence lengths are
             // fed in, so use VERBOSE as the log level as it's expected.
             // TODO: Should we reuse the block if the size is large enough? Would probably need to allow it
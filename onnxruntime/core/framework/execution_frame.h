@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -11,6 +13,7 @@
 #include "core/common/status.h"
 #include "core/framework/iexecutor.h"
 #include "core/framework/ort_value.h"
+#include "core/framework/mem_pattern_cache.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/ort_value_pattern_planner.h"
 #include "core/framework/sequential_execution_plan.h"
@@ -166,6 +169,11 @@ class ExecutionFrame final : public IExecutionFrame {
     return planner_.has_value();
   }
 
+  // Returns true if a tensor needed a larger block than the cached memory pattern planned for it.
+  bool IsMemoryPatternTooSmall() const {
+    return mem_pattern_too_small_.load(std::memory_order_relaxed);
+  }
+
   // This function try retrieve the inferred shapes for the given NodeArg index.
   // If the retrival is successful, this function returns true and false otherwise.
   bool TryGetInferredShape(int index, TensorShape& shape) const override;
@@ -231,8 +239,13 @@ class ExecutionFrame final : public IExecutionFrame {
   // If we already have cached memory pattern on these input shapes
   // Use this mem pattern that create a big chunk for all the internal
   // kernel's input/output tensors.
+  // The cache entry is held so that it stays valid if it is evicted from the cache during the execution.
+  std::shared_ptr<const MemoryPatternCache::Entry> mem_pattern_entry_;
   const MemoryPatternGroup* mem_patterns_;
 
+  // Set if a tensor didn't fit in the block the (shape bucketed) memory pattern planned for it.
+  std::atomic<bool> mem_pattern_too_small_{false};
+
   // If no cached memory pattern, and we enable the memory pattern optimization
   // use this planner_ to trace the memory allocation in current executor.
   std::optional<OrtValuePatternPlanner> planner_;
@@ -243,7 +256,7 @@ class ExecutionFrame final : public IExecutionFrame {
   // Given the input shapes of the executed graph, ExecutionFrame tries inferring
   // all symbolic shapes. inferred_shapes_[i] is the shape of OrtValue indexed
   // by i, if the key i exists.
-  // inferred_shapes_ is generated together with mem_patterns_.
+  // inferred_shapes_ is generated together with mem_patterns_ and points into mem_pattern_entry_.
   // It is never updated after creation
   const InlinedHashMap<int, TensorShape>* inferred_shapes_{nullptr};
 
@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+
+#include "core/common/hash_combine.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+MemoryPatternCache::MemoryPatternCache(size_t capacity, int64_t shape_bucket_size)
+    : capacity_(capacity), shape_bucket_size_(shape_bucket_size) {
+  if (capacity_ > 0) {
+    slots_.reserve(capacity_);
+  }
+}
+
+int64_t MemoryPatternCache::CalculateKey(gsl::span<const OrtValue> tensor_inputs) const {
+  size_t key = 0;
+  for (const auto& input : tensor_inputs) {
+    const auto dims = input.Get<Tensor>().Shape().GetDims();
+    // include the rank so that e.g. {2, 3} and {2}, {3} for two inputs don't collide
+    HashCombine(dims.size(), key);
+    for (auto dim : dims) {
+      if (UsesShapeBuckets() && dim > 0) {
+        dim = (dim + shape_bucket_size_ - 1) / shape_bucket_size_ * shape_bucket_size_;
+      }
+
+      HashCombine(dim, key);
+    }
+  }
+
+  return static_cast<int64_t>(key);
+}
+
+std::shared_ptr<const MemoryPatternCache::Entry> MemoryPatternCache::Find(int64_t key, bool& needs_replan) {
+  needs_replan = false;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = slots_.find(key);
+  if (it == slots_.end()) {
+    ++stats_.num_misses;
+    return nullptr;
+  }
+
+  ++stats_.num_hits;
+  lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+  needs_replan = it->second.needs_replan;
+  return it->second.entry;
+}
+
+std::shared_ptr<const MemoryPatternCache::Entry> MemoryPatternCache::Insert(int64_t key, Entry&& entry) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = slots_.find(key);
+  if (it != slots_.end()) {
+    // Another execution may have added the entry in the meantime. Only replace it if it was marked for re-planning
+    // as the new pattern covers the sizes of the old one in that case.
+    if (it->second.needs_replan) {
+      it->second.entry = std::make_shared<const Entry>(std::move(entry));
+      it->second.needs_replan = false;
+      ++stats_.num_replans;
+    }
+
+    return it->second.entry;
+  }
+
+  if (capacity_ > 0 && slots_.size() >= capacity_) {
+    slots_.erase(lru_.back());
+    lru_.pop_back();
+    ++stats_.num_evictions;
+  }
+
+  lru_.push_front(key);
+  Slot& slot = slots_[key];
+  slot.entry = std::make_shared<const Entry>(std::move(entry));
+  slot.lru_it = lru_.begin();
+  return slot.entry;
+}
+
+void MemoryPatternCache::MarkForReplan(int64_t key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = slots_.find(key);
+  if (it != slots_.end()) {
+    it->second.needs_replan = true;
+  }
+}
+
+MemoryPatternCache::Stats MemoryPatternCache::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Stats stats = stats_;
+  stats.num_entries = slots_.size();
+  return stats;
+}
+
+}  // namespace onnxruntime
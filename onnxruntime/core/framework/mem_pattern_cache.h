@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+
+#include <gsl/gsl>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/tensor_shape.h"
+
+namespace onnxruntime {
+
+// Cache of the memory patterns generated by the executions of a graph, keyed on the shapes of the graph inputs.
+//
+// If a shape bucket size is set, every input dimension is rounded up to a multiple of it before the key is computed,
+// so inputs whose shapes only differ slightly (e.g. in the sequence length) share one pattern. The blocks of a shared
+// pattern may be larger than the tensors placed in them. When an execution finds a block that is too small, the
+// entry is marked for re-planning and the next execution with the same key traces the larger of the planned and the
+// actual sizes, so the pattern of a bucket only grows until it covers all shapes seen in it.
+//
+// If a capacity is set, the least recently used entry is evicted once the cache is full. The entries are shared with
+// the execution frames using them, so an entry that is evicted or replaced stays valid until the last frame is done.
+class MemoryPatternCache {
+ public:
+  struct Entry {
+    MemoryPatternGroup patterns;
+    // shapes of the values resolved from the symbolic input dimensions. only populated in training builds, and only
+    // when the cache is keyed on the exact shapes.
+    InlinedHashMap<int, TensorShape> inferred_shapes;
+  };
+
+  struct Stats {
+    int64_t num_hits = 0;
+    int64_t num_misses = 0;
+    int64_t num_evictions = 0;
+    int64_t num_replans = 0;
+    size_t num_entries = 0;
+  };
+
+  // A `capacity` of 0 means the cache is unbounded. A `shape_bucket_size` of 0 or 1 keys the cache on the exact shapes.
+  MemoryPatternCache(size_t capacity, int64_t shape_bucket_size);
+
+  bool UsesShapeBuckets() const { return shape_bucket_size_ > 1; }
+
+  // Computes the key for `tensor_inputs`. All inputs must be tensors.
+  int64_t CalculateKey(gsl::span<const OrtValue> tensor_inputs) const;
+
+  // Returns the entry for `key` and marks it as most recently used, or nullptr if there is none.
+  // `needs_replan` is set if the entry should be traced again so that its pattern can grow.
+  std::shared_ptr<const Entry> Find(int64_t key, bool& needs_replan);
+
+  // Adds `entry` for `key`. An existing entry is only replaced if it was marked for re-planning.
+  // Returns the entry stored for `key`.
+  std::shared_ptr<const Entry> Insert(int64_t key, Entry&& entry);
+
+  // Marks the entry for `key` so that the next execution using it traces the allocations again.
+  void MarkForReplan(int64_t key);
+
+  Stats GetStats() const;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MemoryPatternCache);
+
+ private:
+  struct Slot {
+    std::shared_ptr<const Entry> entry;
+    std::list<int64_t>::iterator lru_it;
+    bool needs_replan = false;
+  };
+
+  const size_t capacity_;
+  const int64_t shape_bucket_size_;
+
+  mutable std::mutex mutex_;
+  InlinedHashMap<int64_t, Slot> slots_;
+  // keys in the order of use, most recently used first
+  std::list<int64_t> lru_;
+  Stats stats_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,220 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/peak_memory_estimator.h"
+
+#include <algorithm>
+#include <optional>
+
+#include "core/common/safeint.h"
+#include "core/framework/allocator.h"
+#include "core/framework/data_types.h"
+#include "core/framework/ort_value_pattern_planner.h"
+#include "core/framework/session_state.h"
+
+namespace onnxruntime {
+
+namespace {
+
+Status ResolveDimParams(const GraphViewer& graph_viewer,
+                        const InlinedHashMap<std::string, TensorShape>& input_shapes,
+                        InlinedHashMap<std::string, int64_t>& dim_values) {
+  for (const auto* input : graph_viewer.GetInputs()) {
+    auto it = input_shapes.find(input->Name());
+    ORT_RETURN_IF(it == input_shapes.end(), "No shape was given for graph input ", input->Name());
+
+    const auto* shape = input->Shape();
+    if (shape == nullptr) {
+      continue;
+    }
+
+    const TensorShape& input_shape = it->second;
+    ORT_RETURN_IF(shape->dim_size() != static_cast<int>(input_shape.NumDimensions()),
+                  "The shape given for graph input ", input->Name(), " has rank ", input_shape.NumDimensions(),
+                  " but the input has rank ", shape->dim_size());
+
+    for (int k = 0, end = shape->dim_size(); k < end; ++k) {
+      const auto& dim = shape->dim(k);
+      if (dim.has_dim_param()) {
+        auto result = dim_values.insert({dim.dim_param(), input_shape[k]});
+        ORT_RETURN_IF(result.first->second != input_shape[k],
+                      "Conflicting values ", result.first->second, " and ", input_shape[k],
+                      " given for symbolic dimension ", dim.dim_param());
+      } else if (dim.has_dim_value()) {
+        ORT_RETURN_IF(dim.dim_value() != input_shape[k],
+                      "The shape given for graph input ", input->Name(), " is ", input_shape,
+                      " but dimension ", k, " of the input is ", dim.dim_value());
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+// Returns the number of elements of `arg`, or nothing if its shape can't be resolved.
+std::optional<size_t> ResolveNumElements(const NodeArg& arg,
+                                         const InlinedHashMap<std::string, int64_t>& dim_values) {
+  const auto* shape = arg.Shape();
+  if (shape == nullptr) {
+    return std::nullopt;
+  }
+
+  SafeInt<size_t> num_elements = 1;
+  for (const auto& dim : shape->dim()) {
+    if (dim.has_dim_value()) {
+      num_elements *= dim.dim_value();
+    } else if (dim.has_dim_param()) {
+      auto it = dim_values.find(dim.dim_param());
+      if (it == dim_values.end()) {
+        return std::nullopt;
+      }
+
+      num_elements *= it->second;
+    } else {
+      return std::nullopt;
+    }
+  }
+
+  return static_cast<size_t>(num_elements);
+}
+
+}  // namespace
+
+Status EstimatePeakMemory(const SessionState& session_state,
+                          const InlinedHashMap<std::string, TensorShape>& input_shapes,
+                          size_t num_largest_values,
+                          PeakMemoryEstimate& estimate) {
+  const auto* exec_plan = session_state.GetExecutionPlan();
+  ORT_RETURN_IF(exec_plan == nullptr, "The session state has no execution plan.");
+
+  const auto& graph_viewer = session_state.GetGraphViewer();
+  const auto& ort_value_name_idx_map = session_state.GetOrtValueNameIdxMap();
+  const auto& allocation_plan = exec_plan->allocation_plan;
+
+  InlinedHashMap<std::string, int64_t> dim_values;
+  ORT_RETURN_IF_ERROR(ResolveDimParams(graph_viewer, input_shapes, dim_values));
+
+  estimate = PeakMemoryEstimate{};
+  InlinedHashMap<OrtDevice, size_t> device_to_usage_idx;
+  auto get_device_usage = [&](const OrtDevice& device) -> PeakMemoryEstimate::DeviceUsage& {
+    auto result = device_to_usage_idx.insert({device, estimate.devices.size()});
+    if (result.second) {
+      auto& usage = estimate.devices.emplace_back();
+      usage.device = device;
+      auto allocator = session_state.GetAllocator(device);
+      if (allocator != nullptr) {
+        usage.allocator_name = allocator->Info().name;
+      }
+    }
+
+    return estimate.devices[result.first->second];
+  };
+
+  for (const auto& entry : session_state.GetInitializedTensors()) {
+    if (entry.second.IsTensor()) {
+      const auto& tensor = entry.second.Get<Tensor>();
+      get_device_usage(tensor.Location().device).initializer_bytes += tensor.SizeInBytes();
+    }
+  }
+
+  // replay the allocations and releases of the plan. the pattern planner lays the buffers out like the memory
+  // pattern does.
+  OrtValuePatternPlanner pattern_planner(*exec_plan);
+  InlinedHashMap<OrtDevice, size_t> live_bytes;
+  std::vector<size_t> value_bytes(allocation_plan.size(), 0);
+  std::vector<bool> is_traced(allocation_plan.size(), false);
+  std::vector<size_t> ref_counts;
+  ref_counts.reserve(exec_plan->release_actions.size());
+  for (const auto& action : exec_plan->release_actions) {
+    ref_counts.push_back(action.ref_count);
+  }
+
+  std::vector<PeakMemoryEstimate::ValueUsage> values;
+  const auto& execution_order =
+      graph_viewer.GetNodesInTopologicalOrder(session_state.GetSessionOptions().execution_order);
+  for (NodeIndex node_index : execution_order) {
+    const Node* node = graph_viewer.GetNode(node_index);
+
+    for (const auto* output : node->OutputDefs()) {
+      if (!output->Exists()) {
+        continue;
+      }
+
+      int value_idx;
+      ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(output->Name(), value_idx));
+      const auto& value_plan = allocation_plan[value_idx];
+      if (value_plan.alloc_kind != AllocKind::kAllocate && value_plan.alloc_kind != AllocKind::kAllocateOutput) {
+        continue;
+      }
+
+      // the size of non-tensor values and of the elements of string tensors is only known at runtime
+      std::optional<size_t> num_elements;
+      const DataTypeImpl* element_type = nullptr;
+      if (value_plan.value_type != nullptr && value_plan.value_type->IsTensorType()) {
+        element_type = static_cast<const TensorTypeBase*>(value_plan.value_type)->GetElementType();
+        if (element_type != DataTypeImpl::GetType<std::string>()) {
+          num_elements = ResolveNumElements(*output, dim_values);
+        }
+      }
+
+      if (!num_elements.has_value()) {
+        estimate.unresolved_values.push_back(output->Name());
+        continue;
+      }
+
+      size_t bytes = 0;
+      ORT_RETURN_IF_NOT(IAllocator::CalcMemSizeForArrayWithAlignment<kAllocAlignment>(*num_elements,
+                                                                                      element_type->Size(), &bytes),
+                        "Size overflow for ", output->Name());
+
+      ORT_RETURN_IF_ERROR(pattern_planner.TraceAllocation(value_idx, bytes));
+      value_bytes[value_idx] = bytes;
+      is_traced[value_idx] = true;
+      values.push_back({output->Name(), value_plan.location, bytes});
+
+      size_t& device_live_bytes = live_bytes[value_plan.location];
+      device_live_bytes += bytes;
+      auto& device_usage = get_device_usage(value_plan.location);
+      device_usage.peak_live_bytes = std::max(device_usage.peak_live_bytes, device_live_bytes);
+    }
+
+    size_t total_live_bytes = 0;
+    for (const auto& entry : live_bytes) {
+      total_live_bytes += entry.second;
+    }
+
+    estimate.nodes.push_back({node_index, node->Name(), node->OpType(), total_live_bytes});
+
+    for (size_t action_idx : exec_plan->node_release_list[node_index]) {
+      if (--ref_counts[action_idx] != 0) {
+        continue;
+      }
+
+      const auto value_idx = static_cast<int>(exec_plan->release_actions[action_idx].value_index);
+      if (is_traced[value_idx]) {
+        ORT_RETURN_IF_ERROR(pattern_planner.TraceFree(value_idx));
+        live_bytes[allocation_plan[value_idx].location] -= value_bytes[value_idx];
+      }
+    }
+  }
+
+  MemoryPatternGroup patterns;
+  ORT_RETURN_IF_ERROR(pattern_planner.GeneratePatterns(patterns));
+  for (size_t i = 0; i < patterns.locations.size(); ++i) {
+    if (patterns.patterns[i].PeakSize() != 0) {
+      get_device_usage(patterns.locations[i]).planned_peak_bytes = patterns.patterns[i].PeakSize();
+    }
+  }
+
+  const size_t num_largest = std::min(num_largest_values, values.size());
+  std::partial_sort(values.begin(), values.begin() + num_largest, values.end(),
+                    [](const PeakMemoryEstimate::ValueUsage& a, const PeakMemoryEstimate::ValueUsage& b) {
+                      return a.bytes > b.bytes;
+                    });
+  values.resize(num_largest);
+  estimate.largest_values = std::move(values);
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
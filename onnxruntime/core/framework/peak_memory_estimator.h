@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/ortdevice.h"
+#include "core/framework/tensor_shape.h"
+#include "core/graph/basic_types.h"
+
+namespace onnxruntime {
+
+class SessionState;
+
+struct PeakMemoryEstimate {
+  struct DeviceUsage {
+    OrtDevice device;
+    // name of the session's allocator for the device
+    std::string allocator_name;
+    // bytes of the initializers on the device
+    size_t initializer_bytes{0};
+    // maximum of the bytes of the activations and outputs that are alive at the same time
+    size_t peak_live_bytes{0};
+    // size of the buffer the memory pattern planner lays these out in. at least peak_live_bytes due to fragmentation.
+    size_t planned_peak_bytes{0};
+  };
+
+  struct NodeUsage {
+    NodeIndex node_index;
+    std::string node_name;
+    std::string op_type;
+    // bytes of the activations and outputs alive on all devices once the node's outputs are allocated
+    size_t live_bytes{0};
+  };
+
+  struct ValueUsage {
+    std::string name;
+    OrtDevice device;
+    size_t bytes{0};
+  };
+
+  std::vector<DeviceUsage> devices;
+  // in execution order
+  std::vector<NodeUsage> nodes;
+  // the largest activations and outputs, largest first
+  std::vector<ValueUsage> largest_values;
+  // activations and outputs whose size could not be determined from the input shapes. they are not included above,
+  // so the estimate is a lower bound if this is not empty.
+  std::vector<std::string> unresolved_values;
+};
+
+// Estimates the memory used to run the main graph of `session_state` with inputs of the given shapes, without
+// running any kernel. The symbolic dimensions of the inferred shapes are resolved from `input_shapes`, and the
+// allocations and releases of the execution plan are replayed in execution order. Buffers re-used by the plan are
+// counted once. The memory used by the kernels internally and by subgraphs of control flow nodes is not included.
+// `num_largest_values` is the maximum number of entries in PeakMemoryEstimate::largest_values.
+Status EstimatePeakMemory(const SessionState& session_state,
+                          const InlinedHashMap<std::string, TensorShape>& input_shapes,
+                          size_t num_largest_values,
+                          PeakMemoryEstimate& estimate);
+
+}  // namespace onnxruntime
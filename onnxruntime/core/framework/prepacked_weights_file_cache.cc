@@ -0,0 +1,369 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/prepacked_weights_file_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "core/common/cpuid_info.h"
+#include "core/common/logging/logging.h"
+#include "core/common/safeint.h"
+#include "core/framework/allocator_utils.h"
+#include "core/framework/murmurhash3.h"
+#include "core/framework/tensor.h"
+#include "core/graph/graph.h"
+#include "onnxruntime_config.h"
+
+namespace onnxruntime {
+
+namespace {
+
+constexpr char kFileMagic[8] = {'O', 'R', 'T', 'P', 'P', 'W', 'C', '1'};
+
+// pre-packed buffers are consumed directly from the mapping so keep them at least as aligned as the buffers
+// returned by the CPU allocator
+constexpr size_t kBufferAlignment = 64;
+
+// MurmurHash3 takes an int length so hash large initializers in chunks, chaining the state
+void HashBytes(const void* data, size_t len, uint32_t (&hash)[4]) {
+  constexpr size_t kMaxChunk = size_t{1} << 30;
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  while (len > 0) {
+    const size_t chunk = std::min(len, kMaxChunk);
+    MurmurHash3::x86_128(bytes, static_cast<int>(chunk), hash[0], &hash);
+    bytes += chunk;
+    len -= chunk;
+  }
+}
+
+void HashString(const std::string& str, uint32_t (&hash)[4]) {
+  // include the length so that adjacent strings can't be confused
+  const uint64_t len = str.size();
+  HashBytes(&len, sizeof(len), hash);
+  HashBytes(str.data(), str.size(), hash);
+}
+
+std::string GenerateFingerprint(const ConfigOptions& config_options) {
+  const auto& cpuid_info = CPUIDInfo::GetCPUIDInfo();
+  std::ostringstream ss;
+  ss << "ort:" << ORT_VERSION << ";isa:"
+     << cpuid_info.HasSSE3() << cpuid_info.HasSSE4_1() << cpuid_info.HasAVX() << cpuid_info.HasAVX2()
+     << cpuid_info.HasF16C() << cpuid_info.HasAVX512f() << cpuid_info.HasAVX512Skylake()
+     << cpuid_info.HasAVX512_BF16() << cpuid_info.HasAMX_BF16()
+     << cpuid_info.HasArmNeonDot() << cpuid_info.HasArmNeon_I8MM() << cpuid_info.HasArmSVE_I8MM()
+     << cpuid_info.HasArmNeon_BF16();
+
+  // MLAS options may change the packed layout (e.g. the bfloat16 fastmath mode) so they are part of the fingerprint
+  std::map<std::string, std::string> mlas_options;
+  for (const auto& [key, value] : config_options.configurations) {
+    if (key.rfind("mlas.", 0) == 0) {
+      mlas_options.emplace(key, value);
+    }
+  }
+
+  for (const auto& [key, value] : mlas_options) {
+    ss << ";" << key << "=" << value;
+  }
+
+  return ss.str();
+}
+
+// Identifies the model file by its absolute path, size and modification time, so that the initializers of the model
+// can be identified by name. Returns an empty string if the model wasn't loaded from a file.
+std::string GenerateModelId(const std::filesystem::path& model_path) {
+  if (model_path.empty()) {
+    return {};
+  }
+
+  std::error_code ec;
+  const auto absolute_path = std::filesystem::absolute(model_path, ec);
+  if (ec) {
+    return {};
+  }
+
+  const auto file_size = std::filesystem::file_size(absolute_path, ec);
+  if (ec) {
+    return {};
+  }
+
+  const auto write_time = std::filesystem::last_write_time(absolute_path, ec);
+  if (ec) {
+    return {};
+  }
+
+  std::ostringstream ss;
+  ss << PathToUTF8String(absolute_path.native()) << ":" << file_size << ":"
+     << write_time.time_since_epoch().count();
+  return ss.str();
+}
+
+void AppendUInt64(std::string& out, uint64_t value) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void AppendString(std::string& out, const std::string& value) {
+  AppendUInt64(out, value.size());
+  out.append(value);
+}
+
+// Bounds checked reader over the mapped file
+class FileReader {
+ public:
+  FileReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+  bool ReadUInt64(uint64_t& value) {
+    if (size_ - offset_ < sizeof(value)) return false;
+    memcpy(&value, data_ + offset_, sizeof(value));
+    offset_ += sizeof(value);
+    return true;
+  }
+
+  bool ReadString(std::string& value) {
+    uint64_t len = 0;
+    if (!ReadUInt64(len) || size_ - offset_ < len) return false;
+    value.assign(data_ + offset_, static_cast<size_t>(len));
+    offset_ += static_cast<size_t>(len);
+    return true;
+  }
+
+  bool ReadMagic() {
+    if (size_ < sizeof(kFileMagic) || memcmp(data_, kFileMagic, sizeof(kFileMagic)) != 0) return false;
+    offset_ = sizeof(kFileMagic);
+    return true;
+  }
+
+ private:
+  const char* data_;
+  size_t size_;
+  size_t offset_ = 0;
+};
+
+}  // namespace
+
+PrepackedWeightsFileCache::PrepackedWeightsFileCache(const Env& env, const PathString& file_path,
+                                                     std::string fingerprint, std::string model_id,
+                                                     const logging::Logger& logger)
+    : env_(env),
+      file_path_(file_path),
+      fingerprint_(std::move(fingerprint)),
+      model_id_(std::move(model_id)),
+      logger_(logger) {
+  AllocatorCreationInfo device_info{[](int) { return std::make_unique<CPUAllocator>(); }, 0, false};
+  allocator_ = CreateAllocator(device_info);
+}
+
+Status PrepackedWeightsFileCache::Create(const Env& env, const PathString& file_path,
+                                         const std::filesystem::path& model_path,
+                                         const ConfigOptions& config_options, const logging::Logger& logger,
+                                         std::unique_ptr<PrepackedWeightsFileCache>& cache) {
+  ORT_RETURN_IF(file_path.empty(), "A path is required for the pre-packed weights cache file.");
+
+  cache.reset(new PrepackedWeightsFileCache(env, file_path, GenerateFingerprint(config_options),
+                                            GenerateModelId(model_path), logger));
+  return cache->Load();
+}
+
+Status PrepackedWeightsFileCache::Load() {
+  std::error_code ec;
+  if (!std::filesystem::exists(std::filesystem::path(file_path_), ec)) {
+    LOGS(logger_, INFO) << "Pre-packed weights cache file " << PathToUTF8String(file_path_)
+                        << " doesn't exist. It will be created.";
+    return Status::OK();
+  }
+
+  size_t file_length = 0;
+  ORT_RETURN_IF_ERROR(env_.GetFileLength(file_path_.c_str(), file_length));
+  if (file_length == 0) {
+    return Status::OK();
+  }
+
+  Env::MappedMemoryPtr mapped_file;
+  ORT_RETURN_IF_ERROR(env_.MapFileIntoMemory(file_path_.c_str(), 0, file_length, mapped_file));
+
+  FileReader reader(mapped_file.get(), file_length);
+  std::string fingerprint;
+  uint64_t num_entries = 0;
+  if (!reader.ReadMagic() || !reader.ReadString(fingerprint) || !reader.ReadUInt64(num_entries)) {
+    LOGS(logger_, WARNING) << "Ignoring invalid pre-packed weights cache file " << PathToUTF8String(file_path_);
+    return Status::OK();
+  }
+
+  if (fingerprint != fingerprint_) {
+    LOGS(logger_, WARNING) << "Ignoring pre-packed weights cache file " << PathToUTF8String(file_path_)
+                           << " as it was created for a different configuration. Created for: '" << fingerprint
+                           << "' Current: '" << fingerprint_ << "'";
+    return Status::OK();
+  }
+
+  std::map<std::string, PrePackedWeights> weights;
+  for (uint64_t i = 0; i < num_entries; ++i) {
+    std::string key;
+    uint64_t num_buffers = 0;
+    bool valid = reader.ReadString(key) && reader.ReadUInt64(num_buffers);
+
+    PrePackedWeights entry;
+    for (uint64_t b = 0; valid && b < num_buffers; ++b) {
+      uint64_t offset = 0;
+      uint64_t size = 0;
+      valid = reader.ReadUInt64(offset) && reader.ReadUInt64(size) &&
+              offset <= file_length && size <= file_length - offset;
+      if (valid) {
+        // the mapping is owned by the cache so the buffers must not be freed by their users
+        void* buffer = size == 0 ? nullptr : mapped_file.get() + offset;
+        entry.buffers_.emplace_back(buffer, [](void*) {});
+        entry.buffer_sizes_.push_back(static_cast<size_t>(size));
+      }
+    }
+
+    if (!valid) {
+      LOGS(logger_, WARNING) << "Ignoring truncated pre-packed weights cache file " << PathToUTF8String(file_path_);
+      return Status::OK();
+    }
+
+    weights.emplace(std::move(key), std::move(entry));
+  }
+
+  mapped_file_ = std::move(mapped_file);
+  weights_ = std::move(weights);
+  num_loaded_weights_ = weights_.size();
+
+  LOGS(logger_, INFO) << "Loaded " << num_loaded_weights_ << " pre-packed weights from "
+                      << PathToUTF8String(file_path_);
+
+  return Status::OK();
+}
+
+std::string PrepackedWeightsFileCache::GenerateKey(const Node& node, int input_idx, const Tensor& weight,
+                                                   int format_version) const {
+  uint32_t hash[4] = {0, 0, 0, 0};
+
+  // The packed layout can depend on the types of the other inputs (e.g. the signedness of the activations for
+  // QLinearConv) and on the node attributes (e.g. transB for Gemm), so both are part of the key.
+  auto hash_defs = [&hash](const auto& defs) {
+    for (const auto* def : defs) {
+      const std::string* type = def->Exists() ? def->Type() : nullptr;
+      HashString(type != nullptr ? *type : std::string(), hash);
+    }
+  };
+
+  hash_defs(node.InputDefs());
+  hash_defs(node.OutputDefs());
+
+  std::map<std::string, const ONNX_NAMESPACE::AttributeProto*> sorted_attributes;
+  for (const auto& [name, attribute] : node.GetAttributes()) {
+    sorted_attributes.emplace(name, &attribute);
+  }
+
+  for (const auto& [name, attribute] : sorted_attributes) {
+    HashString(name, hash);
+    HashString(attribute->SerializeAsString(), hash);
+  }
+
+  const auto dims = weight.Shape().GetDims();
+  HashBytes(dims.data(), dims.size_bytes(), hash);
+  const int32_t elem_type = weight.GetElementType();
+  HashBytes(&elem_type, sizeof(elem_type), hash);
+
+  // the initializers of a model file are identified by name, the others by their contents
+  if (!model_id_.empty()) {
+    HashString(model_id_, hash);
+    HashString(node.InputDefs()[input_idx]->Name(), hash);
+  } else {
+    HashBytes(weight.DataRaw(), weight.SizeInBytes(), hash);
+  }
+
+  std::ostringstream ss;
+  ss << node.Domain() << ":" << node.OpType() << ":" << node.SinceVersion() << ":" << input_idx << ":v"
+     << format_version << ":" << std::hex << hash[0] << hash[1] << hash[2] << hash[3];
+  return ss.str();
+}
+
+const PrePackedWeights* PrepackedWeightsFileCache::GetWeight(const std::string& key) const {
+  auto iter = weights_.find(key);
+  return iter != weights_.end() ? &iter->second : nullptr;
+}
+
+const PrePackedWeights& PrepackedWeightsFileCache::AddWeight(const std::string& key, PrePackedWeights&& weights) {
+  ORT_ENFORCE(weights.buffers_.size() == weights.buffer_sizes_.size());
+  auto result = weights_.insert_or_assign(key, std::move(weights));
+  has_new_weights_ = true;
+  return result.first->second;
+}
+
+Status PrepackedWeightsFileCache::Save() const {
+  // index: magic, fingerprint, entry count, and per entry the key and the offset/size of each buffer
+  size_t index_size = sizeof(kFileMagic) + sizeof(uint64_t) + fingerprint_.size() + sizeof(uint64_t);
+  for (const auto& [key, entry] : weights_) {
+    index_size += sizeof(uint64_t) + key.size() + sizeof(uint64_t) + entry.buffers_.size() * 2 * sizeof(uint64_t);
+  }
+
+  auto align = [](size_t offset) { return (offset + kBufferAlignment - 1) / kBufferAlignment * kBufferAlignment; };
+
+  std::string index;
+  index.reserve(index_size);
+  index.append(kFileMagic, sizeof(kFileMagic));
+  AppendString(index, fingerprint_);
+  AppendUInt64(index, weights_.size());
+
+  SafeInt<size_t> data_offset = align(index_size);
+  for (const auto& [key, entry] : weights_) {
+    AppendString(index, key);
+    AppendUInt64(index, entry.buffers_.size());
+    for (size_t b = 0; b < entry.buffers_.size(); ++b) {
+      const size_t size = entry.buffers_[b] != nullptr ? entry.buffer_sizes_[b] : 0;
+      AppendUInt64(index, size == 0 ? 0 : static_cast<size_t>(data_offset));
+      AppendUInt64(index, size);
+      if (size != 0) {
+        data_offset = align(data_offset + size);
+      }
+    }
+  }
+
+  ORT_ENFORCE(index.size() == index_size);
+
+  const std::filesystem::path file_path(file_path_);
+  std::filesystem::path temp_path(file_path);
+  temp_path += ORT_TSTR(".tmp") + ToPathString(std::to_string(env_.GetSelfPid()));
+
+  {
+    std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+    ORT_RETURN_IF_NOT(out.good(), "Failed to open ", temp_path.string(), " for writing.");
+
+    const std::vector<char> padding(kBufferAlignment, 0);
+    size_t written = index.size();
+    out.write(index.data(), index.size());
+    for (const auto& [key, entry] : weights_) {
+      for (size_t b = 0; b < entry.buffers_.size(); ++b) {
+        const size_t size = entry.buffers_[b] != nullptr ? entry.buffer_sizes_[b] : 0;
+        if (size == 0) {
+          continue;
+        }
+
+        out.write(padding.data(), align(written) - written);
+        out.write(static_cast<const char*>(entry.buffers_[b].get()), size);
+        written = align(written) + size;
+      }
+    }
+
+    ORT_RETURN_IF_NOT(out.good(), "Failed to write the pre-packed weights cache file ", temp_path.string());
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(temp_path, file_path, ec);
+  if (ec) {
+    std::filesystem::remove(temp_path, ec);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to replace the pre-packed weights cache file ",
+                           file_path.string(), ": ", ec.message());
+  }
+
+  LOGS(logger_, INFO) << "Saved " << weights_.size() << " pre-packed weights to " << PathToUTF8String(file_path_);
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "core/common/common.h"
+#include "core/common/path_string.h"
+#include "core/framework/allocator.h"
+#include "core/framework/config_options.h"
+#include "core/framework/prepacked_weights.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+class Node;
+class Tensor;
+
+namespace logging {
+class Logger;
+}
+
+// Persists the buffers produced by OpKernel::PrePack() into a sidecar file so that sessions created later on the
+// same machine can memory-map the pre-packed buffers instead of packing the weights again. Only kernels that report a
+// pre-packed format version via OpKernel::GetPrePackFormatVersion() use the file: for a weight found in it the kernel
+// gets RestorePrePackState() and the mapped buffers via UseSharedPrePackedBuffers() instead of PrePack().
+//
+// Entries are keyed on the model file (path, size and modification time), the initializer name and shape, the node's
+// kernel (domain, op type, since version, input/output types and attributes), the input index and the kernel's
+// pre-packed format version. The contents of the initializer are only hashed if the model wasn't loaded from a file.
+// The file header records the ORT version, the CPU features reported by CPUIDInfo and the 'mlas.*' session options.
+// A file written under a different configuration is ignored and rewritten.
+class PrepackedWeightsFileCache final {
+ public:
+  // Creates the cache and maps the contents of `file_path` if it exists and is compatible.
+  // A missing or incompatible file is not an error. The cache simply starts empty in that case.
+  // `model_path` is the path of the model file the session was loaded from, or empty if it wasn't loaded from a file.
+  static Status Create(const Env& env, const PathString& file_path, const std::filesystem::path& model_path,
+                       const ConfigOptions& config_options, const logging::Logger& logger,
+                       std::unique_ptr<PrepackedWeightsFileCache>& cache);
+
+  // Generates the lookup key for the pre-packed form of `weight` when consumed as input `input_idx` of `node`
+  // by a kernel with pre-packed format `format_version`.
+  std::string GenerateKey(const Node& node, int input_idx, const Tensor& weight, int format_version) const;
+
+  // Returns the allocator that PrePack() should use for weights that are going to be added to the cache.
+  AllocatorPtr GetAllocator() const { return allocator_; }
+
+  // Returns the pre-packed weights for `key`, or nullptr if the cache doesn't contain them.
+  const PrePackedWeights* GetWeight(const std::string& key) const;
+
+  // Takes ownership of pre-packed weights produced in this session so they are written out by Save(). They replace
+  // the entry loaded for `key` if there is one.
+  const PrePackedWeights& AddWeight(const std::string& key, PrePackedWeights&& weights);
+
+  size_t GetNumberOfLoadedWeights() const { return num_loaded_weights_; }
+
+  // Returns true if weights were added since the file was loaded and the file needs to be rewritten.
+  bool HasNewWeights() const { return has_new_weights_; }
+
+  // Writes all entries to a temporary file next to the cache file and renames it into place, so that the
+  // mapping held by this or any other process stays valid.
+  Status Save() const;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PrepackedWeightsFileCache);
+
+ private:
+  PrepackedWeightsFileCache(const Env& env, const PathString& file_path, std::string fingerprint,
+                            std::string model_id, const logging::Logger& logger);
+
+  Status Load();
+
+  const Env& env_;
+  const PathString file_path_;
+  const std::string fingerprint_;
+  // identifies the model file, empty if the initializers have to be hashed instead
+  const std::string model_id_;
+  const logging::Logger& logger_;
+
+  AllocatorPtr allocator_;
+
+  // the mapping must outlive the entries in weights_ that point into it
+  Env::MappedMemoryPtr mapped_file_;
+
+  // std::map so that the file contents are deterministic
+  std::map<std::string, PrePackedWeights> weights_;
+  size_t num_loaded_weights_ = 0;
+  bool has_new_weights_ = false;
+};
+
+}  // namespace onnxruntime
@@ -15,6 +15,7 @@
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/utils.h"
+#include "core/framework/work_stealing_executor.h"
 
 #if defined DEBUG_NODE_INPUTS_OUTPUTS
 #include "core/framework/debug_node_inputs_outputs_utils.h"
@@ -565,23 +566,31 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
 
   SessionScope session_scope(session_state, ctx.GetExecutionFrame());
 
-  auto* tp = single_thread_mode ? nullptr : session_state.GetInterOpThreadPool();
-
-  for (size_t i = 0; i < execution_plan->execution_plan.size(); ++i) {
-    if (execution_plan->execution_plan[i]->steps_.empty()) {
-      // execution context is initialized with number of valid streams
-      // for invalid stream (0 steps), it doesn't count in number of tasks
-      // so don't need to invoke CompleteTask here
-      // ctx.CompleteTask();
-    } else {
-      concurrency::ThreadPool::Schedule(tp, [i, &ctx, &terminate_flag, &session_scope]() {
-        RunSince(i, ctx, session_scope, terminate_flag, 0);
-      });
+  const auto* work_stealing_plan = session_state.GetWorkStealingExecutionPlan();
+  auto* intra_op_tp = session_state.GetThreadPool();
+  if (work_stealing_plan && !single_thread_mode && !only_execute_path_to_fetches &&
+      concurrency::ThreadPool::DegreeOfParallelism(intra_op_tp) > 1) {
+    ORT_RETURN_IF_ERROR(ExecuteWithWorkStealing(ctx, *work_stealing_plan, intra_op_tp, session_scope, terminate_flag));
+  } else {
+    auto* tp = single_thread_mode ? nullptr : session_state.GetInterOpThreadPool();
+
+    for (size_t i = 0; i < execution_plan->execution_plan.size(); ++i) {
+      if (execution_plan->execution_plan[i]->steps_.empty()) {
+        // execution context is initialized with number of valid streams
+        // for invalid stream (0 steps), it doesn't count in number of tasks
+        // so don't need to invoke CompleteTask here
+        // ctx.CompleteTask();
+      } else {
+        concurrency::ThreadPool::Schedule(tp, [i, &ctx, &terminate_flag, &session_scope]() {
+          RunSince(i, ctx, session_scope, terminate_flag, 0);
+        });
+      }
     }
+
+    ctx.WaitAll();
+    ORT_RETURN_IF_ERROR(ctx.TaskStatus());
   }
 
-  ctx.WaitAll();
-  ORT_RETURN_IF_ERROR(ctx.TaskStatus());
   ORT_RETURN_IF_ERROR(ctx.GetExecutionFrame().GetOutputs(fetches));
   if (ctx.GetExecutionFrame().HasMemoryPatternPlanner()) {
     bool all_tensors = true;
@@ -597,6 +606,9 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
       ORT_RETURN_IF_ERROR(ctx.GetExecutionFrame().GeneratePatterns(mem_patterns));
       ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(feeds, std::move(mem_patterns)));
     }
+  } else if (ctx.GetExecutionFrame().IsMemoryPatternTooSmall()) {
+    // the next execution with these input shapes re-plans the pattern with the larger sizes
+    session_state.MarkMemoryPatternGroupForReplan(feeds);
   }
 
   return Status::OK();
@@ -7,13 +7,16 @@
 
 #include <mutex>
 #include "core/common/logging/logging.h"
+#include "core/common/parse_string.h"
 #include "core/common/safeint.h"
 #include "core/flatbuffers/schema/ort.fbs.h"
 #include "core/framework/allocator.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/ort_value_pattern_planner.h"
+#include "core/framework/prepacked_weights_file_cache.h"
 #include "core/framework/session_state_utils.h"
+#include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
 #include "core/providers/cpu/controlflow/utils.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
@@ -71,7 +74,8 @@ SessionState::SessionState(Graph& graph,
                            profiling::Profiler& profiler,
                            const SessionOptions& sess_options,
                            PrepackedWeightsContainer* prepacked_weights_container,
-                           AllocatorMap* parent_allocators)
+                           AllocatorMap* parent_allocators,
+                           SharedInitializerRegistry* shared_initializer_registry)
     : graph_(graph),
       execution_providers_(execution_providers),
       logger_(logger),
@@ -81,7 +85,8 @@ SessionState::SessionState(Graph& graph,
       data_transfer_mgr_(data_transfer_mgr),
       external_data_loader_mgr_(external_data_loader_mgr),
       sess_options_(sess_options),
-      prepacked_weights_container_(prepacked_weights_container)
+      prepacked_weights_container_(prepacked_weights_container),
+      shared_initializer_registry_(shared_initializer_registry)
 #ifdef ORT_ENABLE_STREAM
       ,
       stream_handles_registry_(std::make_unique<StreamCommandHandleRegistryImpl>())
@@ -89,6 +94,11 @@ SessionState::SessionState(Graph& graph,
 {
   enable_mem_pattern_ = sess_options_.enable_mem_pattern &&
                         sess_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL;
+  mem_pattern_cache_ = std::make_unique<MemoryPatternCache>(
+      ParseStringWithClassicLocale<size_t>(
+          sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsMemoryPatternCacheCapacity, "0")),
+      ParseStringWithClassicLocale<int64_t>(
+          sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsMemoryPatternShapeBucketSize, "0")));
   if (parent_allocators) {
     allocators_ = parent_allocators;
   } else {
@@ -358,6 +368,20 @@ NameMLValMap SessionState::GetInitializedTensors(const std::unordered_set<std::s
 }
 #endif
 
+void SessionState::InterleaveInitializersAcrossNumaNodes() {
+  for (int ort_value_index : session_allocated_initializers_) {
+    auto entry = constant_initialized_tensors_.find(ort_value_index);
+    if (entry == constant_initialized_tensors_.end() || !entry->second.IsTensor()) {
+      continue;
+    }
+
+    Tensor& tensor = *entry->second.GetMutable<Tensor>();
+    if (tensor.Location().device.Type() == OrtDevice::CPU && tensor.SizeInBytes() >= kNumaInterleaveMinBytes) {
+      InterleaveAcrossNumaNodes(tensor.MutableDataRaw(), tensor.SizeInBytes(), logger_);
+    }
+  }
+}
+
 void SessionState::CleanInitializedTensorsFromGraph() {
   graph_.CleanAllInitializedTensors();
 }
@@ -386,6 +410,47 @@ static Status KernelUseSharedPrePackedBuffers(OpKernel& kernel, int input_idx,
   return Status::OK();
 }
 
+// Minimum size of the weights spread over the NUMA nodes. Smaller ones are cheap to read from a remote node.
+static constexpr size_t kNumaInterleaveMinBytes = 1 << 20;
+
+static bool IsNumaInterleavingEnabled(const SessionOptions& session_options) {
+  return session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigNumaAware, "0") == "1" &&
+         Env::Default().GetNumaNodeProcessors().size() > 1;
+}
+
+static void InterleaveAcrossNumaNodes(void* p, size_t size, const logging::Logger& logger) {
+  auto status = Env::Default().InterleaveMemoryAcrossNumaNodes(p, size);
+  if (!status.IsOK()) {
+    LOGS(logger, VERBOSE) << "Failed to interleave " << size << " bytes across the NUMA nodes: "
+                          << status.ErrorMessage();
+  }
+}
+
+namespace {
+// Interleaves the large buffers it allocates across the NUMA nodes, so that the pre-packed weights are read at
+// the same bandwidth by the intra-op threads of every node.
+class NumaInterleavingAllocator : public IAllocator {
+ public:
+  NumaInterleavingAllocator(AllocatorPtr allocator, const logging::Logger& logger)
+      : IAllocator(allocator->Info()), allocator_(std::move(allocator)), logger_(logger) {}
+
+  void* Alloc(size_t size) override {
+    void* p = allocator_->Alloc(size);
+    if (p != nullptr && size >= kNumaInterleaveMinBytes) {
+      InterleaveAcrossNumaNodes(p, size, logger_);
+    }
+
+    return p;
+  }
+
+  void Free(void* p) override { allocator_->Free(p); }
+
+ private:
+  AllocatorPtr allocator_;
+  const logging::Logger& logger_;
+};
+}  // namespace
+
 static std::string GenerateKeyForPrepackedWeightsMap(const std::string& op_type,
                                                      const PrePackedWeights& pre_packed_weights) {
   std::ostringstream ss_1;
@@ -398,7 +463,9 @@ static std::string GenerateKeyForPrepackedWeightsMap(const std::string& op_type,
 
 Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                                        const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map) {
-  auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map](
+  const bool interleave_across_numa_nodes = IsNumaInterleavingEnabled(sess_options_);
+  auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map,
+                                     interleave_across_numa_nodes](
                                         bool should_cache_prepacked_weights_for_shared_initializers) -> Status {
     for (auto& node : GetGraphViewer().Nodes()) {
       auto kernel = GetMutableKernel(node.Index());
@@ -420,12 +487,23 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
 
                 auto iter = initializers_to_share_map.find(input_name);
                 bool is_shared_initializer = (iter != initializers_to_share_map.end());
+                PrepackedWeightsContainer* weights_container =
+                    should_cache_prepacked_weights_for_shared_initializers ? prepacked_weights_container_ : nullptr;
+
+                // the pre-packed forms of an initializer shared across sessions through the registry are cached
+                // in its entry
+                std::unique_lock<std::mutex> shared_initializer_lock;
+                if (auto shared = st->shared_initializers_.find(input_name); shared != st->shared_initializers_.end()) {
+                  is_shared_initializer = true;
+                  weights_container = &shared->second->prepacked_weights;
+                  shared_initializer_lock = std::unique_lock<std::mutex>(weights_container->mutex_);
+                }
 
                 // Caching pre-packed weights is limited to shared initializers associated with the CPU EP for now
-                if (is_shared_initializer && should_cache_prepacked_weights_for_shared_initializers &&
+                if (is_shared_initializer && weights_container != nullptr &&
                     node.GetExecutionProviderType() == kCpuExecutionProvider) {  // caching of pre-packed weights' turned ON
 
-                  AllocatorPtr allocator_for_caching = prepacked_weights_container_->GetOrCreateAllocator(CPU);
+                  AllocatorPtr allocator_for_caching = weights_container->GetOrCreateAllocator(CPU);
                   ORT_ENFORCE(allocator_for_caching.get() != nullptr);
 
                   PrePackedWeights weights_to_be_filled_in;
@@ -438,7 +516,12 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
                                                       is_packed,
                                                       &weights_to_be_filled_in));
 
-                  if (is_packed) {
+                  // kernels that can't share their pre-packed weights keep them internally. that is only expected
+                  // for the initializers shared through the registry, as the user didn't ask for them to be shared.
+                  const bool kept_by_kernel = shared_initializer_lock.owns_lock() &&
+                                              weights_to_be_filled_in.buffers_.empty();
+
+                  if (is_packed && !kept_by_kernel) {
                     // BUG CHECK: Ensure that the kernel has filled in the pre-packed weight to be cached if the weight was pre-packed
                     ORT_ENFORCE(weights_to_be_filled_in.buffers_.size() > 0, "The kernel corresponding to the node ", node.Name(),
                                 " doesn't have an implementation that can cache computed pre-packed weights");
@@ -455,31 +538,64 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
                     const std::string& prepacked_weights_container_key = GenerateKeyForPrepackedWeightsMap(op_type,
                                                                                                            weights_to_be_filled_in);
 
-                    bool container_contains_packed_weight = prepacked_weights_container_->HasWeight(prepacked_weights_container_key);
+                    bool container_contains_packed_weight = weights_container->HasWeight(prepacked_weights_container_key);
 
                     if (container_contains_packed_weight) {
                       LOGS(logger_, INFO) << "Using cached version of pre-packed weight for constant initializer: " << input_name
                                           << " used in the node: " << node.Name() << " which is of op type: " << node.OpType();
 
                       ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
-                                                                          prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
+                                                                          weights_container->GetWeight(prepacked_weights_container_key),
                                                                           node.Name()));
 
                       ++used_shared_pre_packed_weights_counter_;
                     } else {  // container doesn't contain the pre-packed weight - so write into it for sharing across kernel instances
 
-                      if (!prepacked_weights_container_->WriteWeight(prepacked_weights_container_key, std::move(weights_to_be_filled_in))) {
+                      if (!weights_container->WriteWeight(prepacked_weights_container_key, std::move(weights_to_be_filled_in))) {
                         return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Unable to write the provided PrePackedWeights instance into the container");
                       }
 
                       ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
-                                                                          prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
+                                                                          weights_container->GetWeight(prepacked_weights_container_key),
                                                                           node.Name()));
                     }
                   }
 
+                } else if (PrepackedWeightsFileCache* file_cache = GetPrepackedWeightsFileCache();
+                           file_cache != nullptr && node.GetExecutionProviderType() == kCpuExecutionProvider &&
+                           kernel->GetPrePackFormatVersion(input_idx) > 0) {
+                  // caching of pre-packed weights' in a file turned ON, and supported by the kernel
+                  const std::string key = file_cache->GenerateKey(node, input_idx, const_initialized_tensor,
+                                                                  kernel->GetPrePackFormatVersion(input_idx));
+                  if (const PrePackedWeights* cached_weights = file_cache->GetWeight(key); cached_weights != nullptr) {
+                    LOGS(logger_, VERBOSE) << "Using pre-packed weight from file for constant initializer: "
+                                           << input_name << " used in the node: " << node.Name();
+
+                    ORT_RETURN_IF_ERROR(kernel->RestorePrePackState(const_initialized_tensor, input_idx));
+                    ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx, *cached_weights,
+                                                                        node.Name()));
+                    is_packed = true;
+                    ++used_file_pre_packed_weights_counter_;
+                  } else {
+                    PrePackedWeights weights_to_be_filled_in;
+                    ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx,
+                                                        file_cache->GetAllocator(),
+                                                        is_packed,
+                                                        &weights_to_be_filled_in));
+
+                    // kernels that don't support sharing their pre-packed weights keep them internally
+                    if (is_packed && !weights_to_be_filled_in.buffers_.empty()) {
+                      ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(
+                          *kernel, input_idx, file_cache->AddWeight(key, std::move(weights_to_be_filled_in)),
+                          node.Name()));
+                    }
+                  }
                 } else {  // caching of pre-packed weights' turned OFF
                   AllocatorPtr session_cpu_alloc = GetAllocator(kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault));
+                  if (interleave_across_numa_nodes && session_cpu_alloc->Info().device.Type() == OrtDevice::CPU) {
+                    session_cpu_alloc = std::make_shared<NumaInterleavingAllocator>(std::move(session_cpu_alloc),
+                                                                                    logger_);
+                  }
                   ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx,
                                                       session_cpu_alloc,  // use allocator tied to this session
                                                       is_packed,
@@ -525,14 +641,6 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
   }
 }
 
-static int64_t CalculateMemoryPatternsKey(const gsl::span<const OrtValue>& tensor_inputs) {
-  int64_t key = 0;
-  for (const auto& input : tensor_inputs) {
-    for (auto dim : input.Get<Tensor>().Shape().GetDims()) key ^= dim;
-  }
-  return key;
-}
-
 #ifdef ENABLE_TRAINING
 namespace {
 Status ResolveDimParams(const GraphViewer& graph,
@@ -767,38 +875,50 @@ Status SessionState::GeneratePatternGroupCache(gsl::span<const OrtValue> tensor_
 
 #endif
 
-// MemoryPatternGroup pointer is cached. It only inserted upon creation
-// and is not updated if already present.
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
+// The cache entries are shared with the execution frames, so an entry stays valid for the whole execution even if
+// it is evicted or replaced in the meantime.
+std::shared_ptr<const MemoryPatternCache::Entry> SessionState::GetMemoryPatternGroup(
     gsl::span<const OrtValue> tensor_inputs,
     gsl::span<const int> feed_mlvalue_idxs,
-    const InlinedHashMap<int, TensorShape>*& out_inferred_shapes) const {
-  out_inferred_shapes = nullptr;
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
-  std::lock_guard<std::mutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
+    bool& needs_replan) const {
+  const bool profiling_enabled = profiler_.IsEnabled();
+  TimePoint start_time;
+  if (profiling_enabled) {
+    start_time = profiler_.Start();
+  }
+
+  const int64_t key = mem_pattern_cache_->CalculateKey(tensor_inputs);
+  auto entry = mem_pattern_cache_->Find(key, needs_replan);
+  const bool hit = entry != nullptr;
+  if (!hit) {
 #ifdef ENABLE_TRAINING
-    MemoryPatternGroup mem_patterns;
-    InlinedHashMap<int, TensorShape> inferred_shapes;
-    if (GeneratePatternGroupCache(tensor_inputs, feed_mlvalue_idxs, mem_patterns, inferred_shapes).IsOK()) {
-      auto patt_insert = mem_patterns_.insert_or_assign(key, std::move(mem_patterns));
-      auto ptr = &patt_insert.first->second;
-      auto shape_insert = shape_patterns_.insert_or_assign(key, std::move(inferred_shapes));
-      out_inferred_shapes = &shape_insert.first->second;
-      return ptr;
+    MemoryPatternCache::Entry new_entry;
+    if (GeneratePatternGroupCache(tensor_inputs, feed_mlvalue_idxs, new_entry.patterns,
+                                  new_entry.inferred_shapes)
+            .IsOK()) {
+      // the inferred shapes only hold for the exact input shapes, not for the other shapes of the bucket
+      if (mem_pattern_cache_->UsesShapeBuckets()) {
+        new_entry.inferred_shapes.clear();
+      }
+      entry = mem_pattern_cache_->Insert(key, std::move(new_entry));
     }
 #else
     ORT_UNUSED_PARAMETER(feed_mlvalue_idxs);
 #endif
-    return nullptr;
   }
 
-  auto patt_hit = shape_patterns_.find(key);
-  if (patt_hit != shape_patterns_.cend()) {
-    out_inferred_shapes = &patt_hit->second;
+  if (profiling_enabled) {
+    const auto stats = mem_pattern_cache_->GetStats();
+    profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "MemoryPatternCache_lookup", start_time,
+                                    {{"hit", hit ? "1" : "0"},
+                                     {"num_hits", std::to_string(stats.num_hits)},
+                                     {"num_misses", std::to_string(stats.num_misses)},
+                                     {"num_evictions", std::to_string(stats.num_evictions)},
+                                     {"num_replans", std::to_string(stats.num_replans)},
+                                     {"num_entries", std::to_string(stats.num_entries)}});
   }
-  return &it->second;
+
+  return entry;
 }
 
 void SessionState::ResolveMemoryPatternFlag() {
@@ -849,14 +969,16 @@ void SessionState::ResolveMemoryPatternFlag() {
 
 Status SessionState::UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
                                                    MemoryPatternGroup mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
-
-  std::lock_guard<std::mutex> lock(mem_patterns_lock_);
-  // Do not update if present, as the pointer to the existing one is cached
-  mem_patterns_.emplace(key, std::move(mem_patterns));
+  MemoryPatternCache::Entry entry;
+  entry.patterns = std::move(mem_patterns);
+  mem_pattern_cache_->Insert(mem_pattern_cache_->CalculateKey(tensor_inputs), std::move(entry));
   return Status::OK();
 }
 
+void SessionState::MarkMemoryPatternGroupForReplan(gsl::span<const OrtValue> tensor_inputs) const {
+  mem_pattern_cache_->MarkForReplan(mem_pattern_cache_->CalculateKey(tensor_inputs));
+}
+
 bool SessionState::GetEnableMemoryPattern() const { return enable_mem_pattern_; }
 
 bool SessionState::GetEnableMemoryReuse() const { return sess_options_.enable_mem_reuse; }
@@ -1049,7 +1171,8 @@ Status SessionState::CreateSubgraphSessionState() {
           std::make_unique<SessionState>(*subgraph, execution_providers_,
                                          thread_pool_, inter_op_thread_pool_, data_transfer_mgr_,
                                          external_data_loader_mgr_, logger_, profiler_, sess_options_,
-                                         prepacked_weights_container_, allocators_);
+                                         prepacked_weights_container_, allocators_,
+                                         shared_initializer_registry_);
 
       // Pass fused function manager to subgraph
       subgraph_session_state->fused_funcs_mgr_.SetFusedFuncs(fused_funcs_mgr_);
@@ -1186,10 +1309,35 @@ Status SessionState::FinalizeSessionState(const std::basic_string<PATH_CHAR_TYPE
   ORT_RETURN_IF_ERROR(VerifyEachNodeIsAssignedToAnEp(graph_, logger_, execution_providers_));
   ORT_RETURN_IF_ERROR(PopulateKernelCreateInfo(kernel_registry_manager, saving_ort_format));
 
+  const PathString prepacked_weights_file = ToPathString(
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsPrepackedWeightsCacheFile, ""));
+  if (!prepacked_weights_file.empty() &&
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDisablePrepacking, "0") != "1") {
+    ORT_RETURN_IF_ERROR(PrepackedWeightsFileCache::Create(Env::Default(), prepacked_weights_file, graph_.ModelPath(),
+                                                          sess_options_.config_options, logger_,
+                                                          prepacked_weights_file_cache_));
+  }
+
   InlinedHashMap<std::string, size_t> constant_initializers_use_count;
   ComputeConstantInitializerUseCount(graph_, constant_initializers_use_count);
-  return FinalizeSessionStateImpl(graph_location, kernel_registry_manager, nullptr, sess_options_,
-                                  remove_initializers, constant_initializers_use_count);
+  ORT_RETURN_IF_ERROR(FinalizeSessionStateImpl(graph_location, kernel_registry_manager, nullptr, sess_options_,
+                                               remove_initializers, constant_initializers_use_count));
+
+  if (prepacked_weights_file_cache_ && prepacked_weights_file_cache_->HasNewWeights()) {
+    // failing to update the cache only costs start-up time in later sessions so don't fail this one
+    auto status = prepacked_weights_file_cache_->Save();
+    if (!status.IsOK()) {
+      LOGS(logger_, WARNING) << "Failed to save the pre-packed weights cache file: " << status.ErrorMessage();
+    }
+  }
+
+  return Status::OK();
+}
+
+PrepackedWeightsFileCache* SessionState::GetPrepackedWeightsFileCache() const {
+  const SessionState* root = this;
+  while (root->parent_ != nullptr) root = root->parent_;
+  return root->prepacked_weights_file_cache_.get();
 }
 
 static Status Index(const OrtValueNameIdxMap& ort_value_name_idx_map,
@@ -1378,9 +1526,17 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   SubgraphsKernelCreateInfoMaps subgraphs_kernel_create_info_maps;
   AccumulateAllNestedSubgraphsInfo(*this, "", 0, subgraphs_kernel_create_info_maps);
 
+  // only the main graph is run in parallel, subgraphs are run on the thread executing their parent node
+  const bool use_work_stealing_executor =
+      parent_node == nullptr && session_options.execution_mode == ExecutionMode::ORT_PARALLEL &&
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseWorkStealingExecutor, "0") == "1";
+
+  // the work stealing executor releases a buffer once all the consumers of the values in it are done, so aliased
+  // outputs can keep sharing the buffer of their input
   SequentialPlannerContext context(session_options.execution_mode,
                                    session_options.execution_order,
-                                   session_options.enable_mem_reuse);
+                                   session_options.enable_mem_reuse,
+                                   use_work_stealing_executor);
 
 #ifdef _WIN32
 
@@ -1409,6 +1565,16 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
                                               p_seq_exec_plan_);
   ORT_RETURN_IF_ERROR(status);
 
+  if (use_work_stealing_executor) {
+    work_stealing_plan_ = WorkStealingExecutionPlan::Create(*graph_viewer_, *p_seq_exec_plan_, ort_value_name_idx_map_,
+                                                            kernel_create_info_map_);
+    if (!work_stealing_plan_) {
+      LOGS(logger_, WARNING) << "The work stealing executor only runs graphs whose nodes are all on CPU and that "
+                                "only share buffers between aliased values. "
+                                "Running the logic streams of the execution plan instead.";
+    }
+  }
+
   // Record the allocation plan
 
   // Uncomment the below to dump the allocation plan to std::cout
@@ -1475,20 +1641,47 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   }
 #endif
 
+  // the initializers shared across sessions are handed to SaveInitializedTensors like the ones supplied by the user
+  const SessionOptions* initializer_session_options = &session_options;
+  SessionOptions session_options_with_shared_initializers;
+  if (shared_initializer_registry_ != nullptr &&
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsShareInitializersAcrossSessions, "0") == "1") {
+    ORT_RETURN_IF_ERROR(session_state_utils::ShareInitializersAcrossSessions(
+        Env::Default(), graph_location, *graph_viewer_, ort_value_name_idx_map_, *p_seq_exec_plan_, session_options,
+        logger_, *shared_initializer_registry_, shared_initializers_));
+
+    if (!shared_initializers_.empty()) {
+      session_options_with_shared_initializers = session_options;
+      for (const auto& name_and_entry : shared_initializers_) {
+        session_options_with_shared_initializers.initializers_to_share_map[name_and_entry.first] =
+            &name_and_entry.second->value;
+      }
+
+      initializer_session_options = &session_options_with_shared_initializers;
+    }
+  }
+
   ORT_RETURN_IF_ERROR(
       session_state_utils::SaveInitializedTensors(
           Env::Default(), graph_location, *graph_viewer_,
           GetAllocator(OrtDevice()),
           ort_value_name_idx_map_, initializer_allocation_order, *tensor_allocator,
-          [this, remove_initializers](const std::string& name, int idx, const OrtValue& value, const OrtCallback& d,
-                                      bool constant, bool sparse) -> Status {
+          [this, remove_initializers, initializer_session_options](const std::string& name, int idx,
+                                                                    const OrtValue& value, const OrtCallback& d,
+                                                                    bool constant, bool sparse) -> Status {
             ORT_RETURN_IF_ERROR(AddInitializedTensor(idx, value, &d, constant, sparse));
+            // the data of the other initializers is owned by the user, a file mapping or another session
+            const ONNX_NAMESPACE::TensorProto* tensor_proto = nullptr;
+            if (initializer_session_options->initializers_to_share_map.count(name) == 0 &&
+                graph_.GetInitializedTensor(name, tensor_proto) && !utils::HasExternalData(*tensor_proto)) {
+              session_allocated_initializers_.insert(idx);
+            }
             if (remove_initializers) {
               graph_.RemoveInitializedTensor(name);
             }
             return Status::OK();
           },
-          logger_, data_transfer_mgr_, external_data_loader_mgr_, *p_seq_exec_plan_, session_options,
+          logger_, data_transfer_mgr_, external_data_loader_mgr_, *p_seq_exec_plan_, *initializer_session_options,
           memory_profile_func, name_to_buffered_tensor_));
 
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
@@ -1510,6 +1703,11 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
                                                           session_options.initializers_to_share_map));
   }
 
+  // the initializers that were not replaced by pre-packed weights are read by the kernels as is
+  if (IsNumaInterleavingEnabled(session_options)) {
+    InterleaveInitializersAcrossNumaNodes();
+  }
+
   ORT_RETURN_IF_ERROR(
       session_state_utils::SaveInputOutputNamesToNodeMapping(*graph_viewer_, *this, valid_outer_scope_node_args));
 
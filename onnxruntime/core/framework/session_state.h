@@ -26,9 +26,12 @@
 #include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/prepacked_weights_container.h"
+#include "core/framework/prepacked_weights_file_cache.h"
+#include "core/framework/shared_initializer_registry.h"
 #include "core/framework/fuse_nodes_funcs.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
+#include "core/framework/mem_pattern_cache.h"
 #include "core/framework/ort_value.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
@@ -45,6 +48,7 @@
 #include "core/framework/stream_handles.h"
 #ifdef ENABLE_TRAINING
 #include "core/framework/program_region.h"
+#include "core/framework/work_stealing_executor.h"
 #endif
 
 namespace onnxruntime {
@@ -99,7 +103,8 @@ class SessionState {
                profiling::Profiler& profiler,
                const SessionOptions& sess_options,
                PrepackedWeightsContainer* prepacked_weights_container = nullptr,
-               AllocatorMap* parent_allocators = nullptr);
+               AllocatorMap* parent_allocators = nullptr,
+               SharedInitializerRegistry* shared_initializer_registry = nullptr);
 
   ~SessionState() {
     for (auto& kvp : deleter_for_initialized_tensors_) {
@@ -194,6 +199,9 @@ class SessionState {
 
   const std::vector<AllocPlanPerValue>& GetPerValueAllocPlan() const;
 
+  // plan for the work stealing executor. nullptr if it is not enabled or can't run the graph.
+  const WorkStealingExecutionPlan* GetWorkStealingExecutionPlan() const { return work_stealing_plan_.get(); }
+
   /**
   Get the logger for this session.
   Falls back to returning Logging::LoggingManager::DefaultLogger if SetLogger has not been called.
@@ -217,16 +225,15 @@ class SessionState {
   /**
   Get cached memory pattern based on input shapes
   Must be called only when all values contain tensors
-  In training scenarios, the cache may be updated so
-  the callers would receive a copy of inferred shapes
-  made under mutex being held. In inference scenarios,
-  it is not mutable, we do not obtain a lock and simply get a pointer
-  w/o copying a hashtable
+  The returned entry is shared with the cache, so it remains valid while the caller holds it
+  even if it is evicted from the cache.
+  `needs_replan` is set if the caller should trace the allocations again and update the cache,
+  as an earlier execution with the same key needed larger blocks than the pattern provides.
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(
+  std::shared_ptr<const MemoryPatternCache::Entry> GetMemoryPatternGroup(
       gsl::span<const OrtValue> tensor_inputs,
       gsl::span<const int> feed_mlvalue_idxs,
-      const InlinedHashMap<int, TensorShape>*& inferred_shapes) const;
+      bool& needs_replan) const;
 
   /**
   Set generated memory pattern with a given input shapes.
@@ -236,6 +243,19 @@ class SessionState {
   Status UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
                                        MemoryPatternGroup mem_patterns) const;
 
+  /**
+  Mark the memory pattern for the given input shapes to be re-planned by the next execution using it.
+  */
+  void MarkMemoryPatternGroupForReplan(gsl::span<const OrtValue> tensor_inputs) const;
+
+  /**
+  Returns true if the memory patterns are shared by inputs whose shapes round up to the same shape bucket,
+  in which case the planned blocks may be larger than the tensors placed in them.
+  */
+  bool UsesMemoryPatternShapeBuckets() const { return mem_pattern_cache_->UsesShapeBuckets(); }
+
+  MemoryPatternCache::Stats GetMemoryPatternCacheStats() const { return mem_pattern_cache_->GetStats(); }
+
   bool GetUseDeterministicCompute() const { return sess_options_.use_deterministic_compute; }
 
   /**
@@ -333,6 +353,10 @@ class SessionState {
     return used_shared_pre_packed_weights_counter_;
   }
 
+  size_t GetUsedFilePrePackedWeightCounter() const {
+    return used_file_pre_packed_weights_counter_;
+  }
+
   const KernelCreateInfoMap& GetKernelCreateInfoMap() const {
     return kernel_create_info_map_;
   }
@@ -384,6 +408,10 @@ class SessionState {
   Status PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                            const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map);
 
+  // Spreads the pages of the large constant CPU initializers that the session allocated over the NUMA nodes
+  // (see kOrtSessionOptionsConfigNumaAware).
+  void InterleaveInitializersAcrossNumaNodes();
+
   SessionState* GetMutableSubgraphSessionState(onnxruntime::NodeIndex index, const std::string& attribute_name);
 
   Status CreateSubgraphSessionState();
@@ -411,6 +439,19 @@ class SessionState {
       InlinedHashMap<int, TensorShape>& inferred_shapes) const;
 #endif
 
+  // Returns the cache of pre-packed weights persisted to disk. Owned by the root session state. nullptr if disabled.
+  PrepackedWeightsFileCache* GetPrepackedWeightsFileCache() const;
+
+  // Pre-packed weights persisted to disk (see kOrtSessionOptionsPrepackedWeightsCacheFile).
+  // Only set in the root session state. The kernels may reference buffers mapped from the file so this must be
+  // destroyed after the kernels of this and all subgraph session states.
+  std::unique_ptr<PrepackedWeightsFileCache> prepacked_weights_file_cache_;
+
+  // Initializers shared with other sessions through the registry, keyed by name
+  // (see kOrtSessionOptionsShareInitializersAcrossSessions). The kernels may reference the pre-packed weights held
+  // by the entries so this must be destroyed after the kernels.
+  InlinedHashMap<std::string, std::shared_ptr<SharedInitializerRegistry::Entry>> shared_initializers_;
+
   // KernelCreateInfo for each node so we do kernel lookup once
   KernelCreateInfoMap kernel_create_info_map_;
 
@@ -468,6 +509,9 @@ class SessionState {
   std::unordered_map<int, OrtValue> initialized_tensors_;  // key is ort_value_index
   // subset of initialized_tensors_ that are constant and cannot be overridden at runtime
   std::unordered_map<int, OrtValue> constant_initialized_tensors_;
+  // subset of initialized_tensors_ deserialized to memory allocated by the session, rather than memory of the user,
+  // a file mapping or another session
+  InlinedHashSet<int> session_allocated_initializers_;
 
 #if !defined(DISABLE_SPARSE_TENSORS)
   // This is an auxiliary lookup to check if the OrtValue was actually a sparse tensor
@@ -482,6 +526,7 @@ class SessionState {
   InlinedHashMap<int, OrtCallback> deleter_for_initialized_tensors_;
   InlinedVector<BufferUniquePtr> weights_buffers_;
   std::optional<SequentialExecutionPlan> p_seq_exec_plan_;
+  std::unique_ptr<WorkStealingExecutionPlan> work_stealing_plan_;
 
   const logging::Logger& logger_;
   profiling::Profiler& profiler_;
@@ -493,18 +538,8 @@ class SessionState {
   // switch for enable memory pattern optimization or not.
   bool enable_mem_pattern_;
 
-  // lock for the mem_patterns_
-  mutable std::mutex mem_patterns_lock_;
   // cache for the generated mem_patterns. key is calculated based on input shapes.
-  // must be a node based container as a pointer is cached.
-  mutable NodeHashMap<int64_t, MemoryPatternGroup> mem_patterns_;
-  // This is mutable under mutex in training scenarios so execution frame would make a copy
-  // of the value when created.
-#ifdef ENABLE_TRAINING
-  mutable NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
-#else
-  NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
-#endif
+  std::unique_ptr<MemoryPatternCache> mem_pattern_cache_;
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
@@ -529,6 +564,9 @@ class SessionState {
   // prepacked_weights_container_ can be nullptr if no caching is required for prepacked weights
   PrepackedWeightsContainer* const prepacked_weights_container_{};
 
+  // Registry of the Environment deduplicating initializers across sessions. nullptr if the session has no Environment.
+  SharedInitializerRegistry* const shared_initializer_registry_{};
+
 #ifdef ENABLE_TRAINING
 // Needed for ORTTrainer. Should be removed along with ORTTrainer code
 #ifndef DISABLE_ABSEIL
@@ -559,6 +597,9 @@ class SessionState {
   // a constant initialized weight was used by the session state
   size_t used_shared_pre_packed_weights_counter_ = 0;
 
+  // Counter for number of times a pre-packed weight loaded from the pre-packed weights cache file was used
+  size_t used_file_pre_packed_weights_counter_ = 0;
+
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
   // Counter for number of times the session graph has been executed
   size_t graph_executions_counter_ = 0;
@@ -428,6 +428,63 @@ common::Status SaveInitializedTensors(
   return common::Status::OK();
 }
 
+common::Status ShareInitializersAcrossSessions(
+    const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
+    const GraphViewer& graph,
+    const OrtValueNameIdxMap& ort_value_name_idx_map,
+    const ExecutionPlanBase& exec_plan,
+    const SessionOptions& session_options,
+    const logging::Logger& logger,
+    SharedInitializerRegistry& registry,
+    InlinedHashMap<std::string, std::shared_ptr<SharedInitializerRegistry::Entry>>& shared_initializers) {
+  constexpr size_t kMinSharedInitializerBytes = 1024;
+
+  size_t num_shared_bytes = 0;
+  for (const auto& entry : graph.GetAllInitializedTensors()) {
+    const std::string& name = entry.first;
+    const ONNX_NAMESPACE::TensorProto& tensor_proto = *entry.second;
+
+    int ort_value_index;
+    if (name.empty() ||
+        !ort_value_name_idx_map.GetIdx(name, ort_value_index).IsOK() ||
+        exec_plan.GetLocation(ort_value_index).Type() != OrtDevice::CPU ||
+        !graph.IsConstantInitializer(name, /* check_outer_scope */ false) ||
+        session_options.initializers_to_share_map.count(name) != 0 ||
+        tensor_proto.data_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING ||
+        utils::HasExternalData(tensor_proto)) {
+      continue;
+    }
+
+#if !defined(DISABLE_SPARSE_TENSORS)
+    if (graph.GetGraph().IsSparseInitializer(name)) {
+      continue;
+    }
+#endif
+
+    size_t size_in_bytes = 0;
+    if (!utils::GetSizeInBytesFromTensorProto<0>(tensor_proto, &size_in_bytes).IsOK() ||
+        size_in_bytes < kMinSharedInitializerBytes) {
+      continue;
+    }
+
+    const DataTypeImpl* const type = DataTypeImpl::TensorTypeFromONNXEnum(tensor_proto.data_type())->GetElementType();
+    auto tensor = std::make_unique<Tensor>(type, utils::GetTensorShapeFromTensorProto(tensor_proto),
+                                           registry.GetAllocator());
+    ORT_RETURN_IF_ERROR(utils::TensorProtoToTensor(env, graph_loc, tensor_proto, *tensor));
+
+    shared_initializers[name] = registry.GetOrAdd(std::move(tensor));
+    num_shared_bytes += size_in_bytes;
+  }
+
+  const auto stats = registry.GetStats();
+  LOGS(logger, INFO) << "Sharing " << shared_initializers.size() << " initializers (" << num_shared_bytes
+                     << " bytes) across sessions. The registry holds " << stats.num_entries << " initializers ("
+                     << stats.num_bytes << " bytes) and has deduplicated " << stats.num_hits << " ("
+                     << stats.num_bytes_deduplicated << " bytes).";
+
+  return Status::OK();
+}
+
 template <typename T>  // T is container of const NodeArg* or NodeArg*
 static bool IsArgNameInInputsOutputs(const std::string& name,
                                      const T& graph_args) {
@@ -8,10 +8,12 @@
 #include <unordered_map>
 
 #include "core/common/const_pointer_container.h"
+#include "core/common/inlined_containers.h"
 #include "core/framework/allocator.h"
 #include "core/framework/tensor.h"
 #include "core/framework/tensor_allocator.h"
 #include "core/framework/session_options.h"
+#include "core/framework/shared_initializer_registry.h"
 #include "core/framework/sequential_execution_plan.h"
 #include "core/platform/path_lib.h"
 
@@ -52,6 +54,23 @@ common::Status SaveInitializedTensors(
     const MemoryProfileFunction& memory_profile_func,
     std::unordered_map<std::string, std::unique_ptr<Tensor>>& buffered_tensors);
 
+/**
+ * Looks up the constant CPU initializers of the graph in the registry by content, adding the ones it doesn't hold.
+ * The entries found or added are returned by initializer name, to be used by the session instead of loading its own
+ * copy of the initializers.
+ * Initializers supplied by the user, with external data or smaller than 1KB are not shared. CPU initializers with
+ * external data are memory mapped, so their pages are shared across sessions already.
+ */
+common::Status ShareInitializersAcrossSessions(
+    const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
+    const GraphViewer& graph,
+    const OrtValueNameIdxMap& ort_value_name_idx_map,
+    const ExecutionPlanBase& exec_plan,
+    const SessionOptions& session_options,
+    const logging::Logger& logger,
+    SharedInitializerRegistry& registry,
+    InlinedHashMap<std::string, std::shared_ptr<SharedInitializerRegistry::Entry>>& shared_initializers);
+
 common::Status AllocateTensor(
     const onnxruntime::MemBuffer* m,
     std::unique_ptr<onnxruntime::Tensor>& p_tensor,
@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shared_initializer_registry.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "core/framework/data_types.h"
+#include "core/framework/murmurhash3.h"
+
+namespace onnxruntime {
+
+namespace {
+uint64_t HashTensorData(const Tensor& tensor) {
+  // MurmurHash3 takes an int length, so larger tensors are hashed in chunks
+  constexpr size_t kMaxChunkSize = size_t{1} << 30;
+
+  const auto* data = static_cast<const uint8_t*>(tensor.DataRaw());
+  const size_t size = tensor.SizeInBytes();
+  uint64_t hash[2] = {0, 0};
+  size_t offset = 0;
+  do {
+    const size_t chunk_size = std::min(size - offset, kMaxChunkSize);
+    MurmurHash3::x86_128(data + offset, static_cast<int>(chunk_size), static_cast<uint32_t>(hash[0]), &hash);
+    offset += chunk_size;
+  } while (offset < size);
+
+  return hash[0];
+}
+
+bool HaveSameContent(const Tensor& a, const Tensor& b) {
+  return a.DataType() == b.DataType() &&
+         a.Shape() == b.Shape() &&
+         std::memcmp(a.DataRaw(), b.DataRaw(), a.SizeInBytes()) == 0;
+}
+}  // namespace
+
+SharedInitializerRegistry::SharedInitializerRegistry()
+    : allocator_(std::make_shared<CPUAllocator>()) {
+}
+
+std::shared_ptr<SharedInitializerRegistry::Entry> SharedInitializerRegistry::GetOrAdd(std::unique_ptr<Tensor> tensor) {
+  const uint64_t hash = HashTensorData(*tensor);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto range = entries_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    auto entry = it->second.lock();
+    if (entry && HaveSameContent(entry->value.Get<Tensor>(), *tensor)) {
+      ++num_hits_;
+      num_bytes_deduplicated_ += tensor->SizeInBytes();
+      return entry;
+    }
+  }
+
+  // drop the entries of the initializers no session uses anymore
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->second.expired()) {
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  auto entry = std::make_shared<Entry>();
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  entry->value.Init(tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+  entries_.emplace(hash, entry);
+  return entry;
+}
+
+SharedInitializerRegistry::Stats SharedInitializerRegistry::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  Stats stats;
+  for (const auto& hash_and_entry : entries_) {
+    if (auto entry = hash_and_entry.second.lock()) {
+      ++stats.num_entries;
+      stats.num_bytes += entry->value.Get<Tensor>().SizeInBytes();
+    }
+  }
+
+  stats.num_hits = num_hits_;
+  stats.num_bytes_deduplicated = num_bytes_deduplicated_;
+  return stats;
+}
+
+}  // namespace onnxruntime
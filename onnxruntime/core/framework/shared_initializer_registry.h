@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/prepacked_weights_container.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+// Deduplicates the constant initializers of the sessions of an Environment by content, so that sessions of models
+// with weights in common, e.g. fine-tuned variants of the same base model, hold one copy of those weights and of
+// their pre-packed forms.
+class SharedInitializerRegistry {
+ public:
+  // An initializer held by the registry. The sessions using it share its ownership, so it is freed once the last of
+  // them is destroyed.
+  struct Entry {
+    OrtValue value;
+    // the pre-packed forms of the initializer, shared by the kernels of all sessions using it
+    PrepackedWeightsContainer prepacked_weights;
+  };
+
+  struct Stats {
+    // initializers currently held, and their size in bytes
+    size_t num_entries = 0;
+    size_t num_bytes = 0;
+    // initializers found in the registry instead of being added to it, and their size in bytes
+    size_t num_hits = 0;
+    size_t num_bytes_deduplicated = 0;
+  };
+
+  SharedInitializerRegistry();
+
+  // Returns the entry holding a tensor with the same type, shape and content as `tensor`, adding one holding `tensor`
+  // if there is none. `tensor` must be a CPU tensor allocated with GetAllocator().
+  std::shared_ptr<Entry> GetOrAdd(std::unique_ptr<Tensor> tensor);
+
+  // Allocator for the tensors passed to GetOrAdd. It doesn't depend on any session, so that the entries can outlive
+  // the session that added them.
+  const AllocatorPtr& GetAllocator() const { return allocator_; }
+
+  Stats GetStats() const;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SharedInitializerRegistry);
+
+ private:
+  const AllocatorPtr allocator_;
+
+  mutable std::mutex mutex_;
+  // key is the hash of the tensor data. the entries are owned by the sessions using them.
+  std::unordered_multimap<uint64_t, std::weak_ptr<Entry>> entries_;
+  size_t num_hits_ = 0;
+  size_t num_bytes_deduplicated_ = 0;
+};
+
+}  // namespace onnxruntime
@@ -30,6 +30,7 @@ StreamExecutionContext::StreamExecutionContext(const SessionState& sess_state,
              device_stream_map,
              sess_state),
       logger_(&sess_logger),
+      node_release_list_(&sess_state.GetExecutionPlan()->node_release_list),
       single_thread_mode_(single_thread_mode),
       device_stream_map_(device_stream_map),
       count_down_barriers_(num_barriers) {
@@ -97,6 +98,7 @@ StreamExecutionContext::StreamExecutionContext(const SessionState& sess_state,
              fetch_allocators,
              sess_state),
       logger_(&sess_logger),
+      node_release_list_(&sess_state.GetExecutionPlan()->node_release_list),
       single_thread_mode_(single_thread_mode) {
 #ifdef _WIN32
 #pragma warning(push)
@@ -163,9 +165,18 @@ void StreamExecutionContext ::SetStatus(Status& status) {
 
 StreamExecutionContext::~StreamExecutionContext() {}
 
+void StreamExecutionContext::SetReleasePlan(const std::vector<std::vector<size_t>>& node_release_list,
+                                            gsl::span<const int> ref_counts) {
+  ORT_ENFORCE(ref_counts.size() == session_state_->GetExecutionPlan()->release_actions.size());
+  node_release_list_ = &node_release_list;
+  for (size_t i = 0; i < ref_counts.size(); ++i) {
+    release_plan_[i] = ref_counts[i];
+  }
+}
+
 void StreamExecutionContext::RecycleNodeInputs(onnxruntime::NodeIndex node_index) {
   auto* execution_plan = session_state_->GetExecutionPlan();
-  for (auto idx : execution_plan->node_release_list[node_index]) {
+  for (auto idx : (*node_release_list_)[node_index]) {
     if (--release_plan_[idx] == 0) {
       ORT_ENFORCE(frame_.ReleaseMLValue(static_cast<int>(execution_plan->release_actions[idx].value_index)).IsOK());
       VLOGS(*logger_, 0) << "ort value " << execution_plan->release_actions[idx].value_index << " released";
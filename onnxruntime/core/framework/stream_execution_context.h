@@ -116,6 +116,11 @@ class StreamExecutionContext {
   // Release the OrtValues after a step, based on the execution plan.
   void RecycleNodeInputs(onnxruntime::NodeIndex node_index);
 
+  // Replace the release plan of the execution plan, for executors that don't run the nodes of a logic stream in
+  // order. Elements of `node_release_list` index SequentialExecutionPlan::release_actions, as does `ref_counts`.
+  // `node_release_list` must outlive the context.
+  void SetReleasePlan(const std::vector<std::vector<size_t>>& node_release_list, gsl::span<const int> ref_counts);
+
 #ifdef ENABLE_TRAINING
   void SetOrtValueCache(OrtValueCachePtr cache) {
     cache_ = std::move(cache);
@@ -156,6 +161,8 @@ class StreamExecutionContext {
 
   std::unique_ptr<std::atomic_int[]> release_plan_;
 
+  const std::vector<std::vector<size_t>>* node_release_list_;
+
   CountDownBarrier remain_tasks_;
 
   Status task_status_{Status::OK()};
@@ -197,6 +197,11 @@ class TunableOp {
     default_id_ = id;
   }
 
+  // set the op name used in the signature instead of the type name, which builds without RTTI require
+  void SetName(std::string name) {
+    name_ = std::move(name);
+  }
+
   void RegisterOp(Op<ParamsT>&& op) {
     this->ops_.emplace_back(std::move(op));
   }
@@ -293,8 +298,11 @@ class TunableOp {
 
  private:
   std::string CreateSignature() {
+    if (!name_.empty()) {
+      return name_;
+    }
 #ifdef ORT_NO_RTTI
-    ORT_THROW("TunableOp must be built with RTTI enabled");
+    ORT_THROW("TunableOp must be built with RTTI enabled or be named with SetName");
 #else
 #ifndef _WIN32
     const auto* name = typeid(*this).name();
@@ -311,6 +319,7 @@ class TunableOp {
 
   mutable std::once_flag signature_init_once_;
   std::string signature_;
+  std::string name_;
 
   // the default impl to use when tuning is disabled
   int default_id_{0};
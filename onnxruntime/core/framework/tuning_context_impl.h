@@ -4,7 +4,8 @@
 // This file contains the implementation of TuningContext. At the moment, there is no necessity to expose these
 // methods as OrtApis. This will cause missing symbols when loading provider dynamic libraries, because the libraries
 // are not whole-archive linked and these symbols are not referenced at framework level. To circumvent this problem,
-// the EP must has and only has one translation unit include this file.
+// the EP must has and only has one translation unit include this file. The CPU EP includes it for onnxruntime itself,
+// so only EPs built as shared libraries need their own copy.
 #ifndef TUNING_CONTEXT_IMPL
 #error define TUNING_CONTEXT_IMPL to use this header (impl) file
 #endif
@@ -0,0 +1,314 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/work_stealing_executor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+
+#include "core/framework/op_kernel.h"
+#include "core/framework/sequential_executor.h"
+#include "core/framework/stream_execution_context.h"
+
+namespace onnxruntime {
+
+std::unique_ptr<WorkStealingExecutionPlan> WorkStealingExecutionPlan::Create(
+    const GraphViewer& graph_viewer,
+    const SequentialExecutionPlan& execution_plan,
+    const OrtValueNameIdxMap& ort_value_name_idx_map,
+    const KernelCreateInfoMap& kernel_create_info_map) {
+  if (execution_plan.NumberOfValidStreams() != 1 ||
+      !execution_plan.notification_owners.empty() ||
+      execution_plan.num_barriers != 0) {
+    return nullptr;
+  }
+
+  size_t stream_idx = 0;
+  while (execution_plan.execution_plan[stream_idx]->steps_.empty()) {
+    ++stream_idx;
+  }
+
+  const auto& logic_stream = execution_plan.execution_plan[stream_idx];
+
+  // kernels on other devices may still be running when Compute returns
+  if (logic_stream->device_.Type() != OrtDevice::CPU) {
+    return nullptr;
+  }
+
+  auto plan = std::make_unique<WorkStealingExecutionPlan>();
+  plan->stream_idx = stream_idx;
+  const auto max_node_index = static_cast<size_t>(graph_viewer.MaxNodeIndex());
+  plan->num_dependencies.resize(max_node_index, 0);
+  plan->dependents.resize(max_node_index);
+  plan->priority.resize(max_node_index, 0);
+  plan->node_release_list.resize(max_node_index);
+  plan->release_ref_counts.resize(execution_plan.release_actions.size(), 0);
+
+  // the steps of a single logic stream are in topological order
+  InlinedVector<NodeIndex> nodes;
+  nodes.reserve(logic_stream->steps_.size());
+  std::vector<bool> is_executed(max_node_index, false);
+  for (const auto& step : logic_stream->steps_) {
+    const NodeIndex node_index = step->GetNodeIndex();
+    if (!is_executed[node_index]) {
+      is_executed[node_index] = true;
+      nodes.push_back(node_index);
+    }
+  }
+  plan->num_nodes = nodes.size();
+
+  // The values re-using a buffer share the release action of the value owning it. An output aliasing an input only
+  // reads the buffer, whereas an in-place update or the reuse of a dead buffer is only safe in the order of the
+  // logic stream.
+  const auto& allocation_plan = execution_plan.allocation_plan;
+  std::vector<OrtValueIndex> root_buffer(allocation_plan.size());
+  for (size_t i = 0; i < allocation_plan.size(); ++i) {
+    OrtValueIndex root = static_cast<OrtValueIndex>(i);
+    while (allocation_plan[root].alloc_kind == AllocKind::kReuse && allocation_plan[root].reused_buffer != root) {
+      root = allocation_plan[root].reused_buffer;
+    }
+    root_buffer[i] = root;
+  }
+
+  const auto num_reused_values = std::count_if(allocation_plan.begin(), allocation_plan.end(),
+                                               [](const AllocPlanPerValue& alloc_plan) {
+                                                 return alloc_plan.alloc_kind == AllocKind::kReuse;
+                                               });
+  int64_t num_aliased_values = 0;
+  for (NodeIndex node_index : nodes) {
+    const Node* node = graph_viewer.GetNode(node_index);
+    const auto& output_defs = node->OutputDefs();
+    for (size_t output_idx = 0; output_idx < output_defs.size(); ++output_idx) {
+      int value_idx;
+      if (!output_defs[output_idx]->Exists() ||
+          !ort_value_name_idx_map.GetIdx(output_defs[output_idx]->Name(), value_idx).IsOK() ||
+          allocation_plan[value_idx].alloc_kind != AllocKind::kReuse) {
+        continue;
+      }
+
+      auto entry = kernel_create_info_map.find(node_index);
+      if (entry == kernel_create_info_map.end() || entry->second->kernel_def == nullptr) {
+        return nullptr;
+      }
+
+      const KernelDef& kernel_def = *entry->second->kernel_def;
+      const auto& alias_map = kernel_def.Alias();
+      const auto& variadic_alias = kernel_def.VariadicAlias();
+      const int output_arg_num = static_cast<int>(output_idx);
+      const bool is_alias =
+          std::any_of(alias_map.begin(), alias_map.end(),
+                      [output_arg_num](const std::pair<int, int>& alias) { return alias.second == output_arg_num; }) ||
+          (variadic_alias.has_value() && output_arg_num >= variadic_alias->second);
+      if (!is_alias) {
+        return nullptr;
+      }
+
+      ++num_aliased_values;
+    }
+  }
+
+  // the other values re-using a buffer aren't produced by a node of the graph
+  if (num_aliased_values != num_reused_values) {
+    return nullptr;
+  }
+
+  for (NodeIndex node_index : nodes) {
+    const Node* node = graph_viewer.GetNode(node_index);
+    InlinedHashSet<NodeIndex> dependencies;
+    // input edges include the control edges and the edges of implicit inputs
+    for (auto it = node->InputEdgesBegin(), end = node->InputEdgesEnd(); it != end; ++it) {
+      const NodeIndex producer = it->GetNode().Index();
+      if (is_executed[producer] && dependencies.insert(producer).second) {
+        plan->dependents[producer].push_back(node_index);
+      }
+    }
+
+    plan->num_dependencies[node_index] = static_cast<int>(dependencies.size());
+  }
+
+  for (auto it = nodes.rbegin(), end = nodes.rend(); it != end; ++it) {
+    size_t longest_path = 0;
+    for (NodeIndex dependent : plan->dependents[*it]) {
+      longest_path = std::max(longest_path, plan->priority[dependent]);
+    }
+
+    plan->priority[*it] = longest_path + 1;
+  }
+
+  const auto by_priority = [&plan](NodeIndex a, NodeIndex b) { return plan->priority[a] > plan->priority[b]; };
+  for (NodeIndex node_index : nodes) {
+    auto& dependents = plan->dependents[node_index];
+    std::stable_sort(dependents.begin(), dependents.end(), by_priority);
+    if (plan->num_dependencies[node_index] == 0) {
+      plan->root_nodes.push_back(node_index);
+    }
+  }
+
+  std::stable_sort(plan->root_nodes.begin(), plan->root_nodes.end(), by_priority);
+
+  // release a buffer once every node consuming a value in it is done
+  std::vector<int> release_action_of_buffer(allocation_plan.size(), -1);
+  for (size_t i = 0; i < execution_plan.release_actions.size(); ++i) {
+    release_action_of_buffer[execution_plan.release_actions[i].value_index] = static_cast<int>(i);
+  }
+
+  for (NodeIndex node_index : nodes) {
+    const Node* node = graph_viewer.GetNode(node_index);
+    auto& release_list = plan->node_release_list[node_index];
+    auto add_consumer = [&](const NodeArg& input, size_t /*arg_idx*/) {
+      if (!input.Exists()) {
+        return Status::OK();
+      }
+
+      int value_idx;
+      ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(input.Name(), value_idx));
+      const int action_idx = release_action_of_buffer[root_buffer[value_idx]];
+      if (action_idx >= 0 &&
+          std::find(release_list.begin(), release_list.end(), static_cast<size_t>(action_idx)) == release_list.end()) {
+        release_list.push_back(static_cast<size_t>(action_idx));
+        ++plan->release_ref_counts[action_idx];
+      }
+
+      return Status::OK();
+    };
+
+    if (!Node::ForEachWithIndex(node->InputDefs(), add_consumer).IsOK() ||
+        !Node::ForEachWithIndex(node->ImplicitInputDefs(), add_consumer).IsOK()) {
+      return nullptr;
+    }
+  }
+
+  return plan;
+}
+
+namespace {
+
+class WorkStealingRun {
+ public:
+  WorkStealingRun(StreamExecutionContext& ctx,
+                  const WorkStealingExecutionPlan& plan,
+                  concurrency::ThreadPool* thread_pool,
+                  SessionScope& session_scope,
+                  const bool& terminate_flag)
+      : ctx_(ctx),
+        plan_(plan),
+        thread_pool_(thread_pool),
+        session_scope_(session_scope),
+        terminate_flag_(terminate_flag),
+        num_pending_dependencies_(std::make_unique<std::atomic_int[]>(plan.num_dependencies.size())),
+        num_remaining_nodes_(plan.num_nodes) {
+    for (size_t i = 0; i < plan.num_dependencies.size(); ++i) {
+      num_pending_dependencies_[i].store(plan.num_dependencies[i], std::memory_order_relaxed);
+    }
+  }
+
+  Status Run() {
+    if (plan_.num_nodes == 0) {
+      return Status::OK();
+    }
+
+    // the calling thread takes the root on the longest path
+    for (size_t i = 1; i < plan_.root_nodes.size(); ++i) {
+      Schedule(plan_.root_nodes[i]);
+    }
+
+    RunFrom(plan_.root_nodes[0]);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this]() { return done_; });
+    return status_;
+  }
+
+ private:
+  void Schedule(NodeIndex node_index) {
+    concurrency::ThreadPool::Schedule(thread_pool_, [this, node_index]() { RunFrom(node_index); });
+  }
+
+  // Runs `node_index` and keeps running the highest priority node it makes ready on the current thread, so that
+  // the critical path doesn't wait in a queue. The other nodes made ready are scheduled.
+  void RunFrom(NodeIndex node_index) {
+    constexpr NodeIndex kNoNode = std::numeric_limits<NodeIndex>::max();
+    while (node_index != kNoNode) {
+      // after a failure the remaining nodes are only counted down, so that Run knows when all are done
+      if (!failed_.load(std::memory_order_relaxed)) {
+        Status status;
+        if (terminate_flag_) {
+          status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+        } else {
+          ORT_TRY {
+            status = ExecuteKernel(ctx_, node_index, plan_.stream_idx, terminate_flag_, session_scope_);
+          }
+          ORT_CATCH(const std::exception& ex) {
+            ORT_HANDLE_EXCEPTION([&]() {
+              status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+            });
+          }
+        }
+
+        if (!status.IsOK()) {
+          SetStatus(std::move(status));
+        }
+      }
+
+      NodeIndex next = kNoNode;
+      for (NodeIndex dependent : plan_.dependents[node_index]) {
+        if (num_pending_dependencies_[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+          if (next == kNoNode) {
+            next = dependent;
+          } else {
+            Schedule(dependent);
+          }
+        }
+      }
+
+      if (num_remaining_nodes_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_ = true;
+        done_cv_.notify_all();
+      }
+
+      node_index = next;
+    }
+  }
+
+  void SetStatus(Status status) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (status_.IsOK()) {
+      status_ = std::move(status);
+    }
+
+    failed_.store(true, std::memory_order_relaxed);
+  }
+
+  StreamExecutionContext& ctx_;
+  const WorkStealingExecutionPlan& plan_;
+  concurrency::ThreadPool* const thread_pool_;
+  SessionScope& session_scope_;
+  const bool& terminate_flag_;
+
+  std::unique_ptr<std::atomic_int[]> num_pending_dependencies_;
+  std::atomic<size_t> num_remaining_nodes_;
+  std::atomic<bool> failed_{false};
+
+  std::mutex mutex_;
+  std::condition_variable done_cv_;
+  bool done_{false};
+  Status status_;
+};
+
+}  // namespace
+
+Status ExecuteWithWorkStealing(StreamExecutionContext& ctx,
+                               const WorkStealingExecutionPlan& plan,
+                               concurrency::ThreadPool* thread_pool,
+                               SessionScope& session_scope,
+                               const bool& terminate_flag) {
+  ctx.SetReleasePlan(plan.node_release_list, plan.release_ref_counts);
+  WorkStealingRun run(ctx, plan, thread_pool, session_scope, terminate_flag);
+  return run.Run();
+}
+
+}  // namespace onnxruntime
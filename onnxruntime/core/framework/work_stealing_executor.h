@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/allocation_planner.h"
+#include "core/framework/ort_value_name_idx_map.h"
+#include "core/framework/sequential_execution_plan.h"
+#include "core/graph/graph_viewer.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+class SessionScope;
+class StreamExecutionContext;
+
+// Dependency information used to run the nodes of a graph as soon as their inputs are ready, instead of in the order
+// of the logic streams of the SequentialExecutionPlan.
+//
+// The release actions of the SequentialExecutionPlan assume that the nodes of a logic stream run in order, so a value
+// is released after the last of its consumers in that order. The ref counts here count every consumer instead, so
+// that a value is released once all of them are done, whatever order they run in. A value aliasing the buffer of
+// another one (e.g. the output of Reshape) counts towards the release of the buffer.
+struct WorkStealingExecutionPlan {
+  // Returns nullptr if the plan can't be run out of order. That is the case if it uses more than one logic stream,
+  // synchronizes with a device or re-uses a buffer for anything else than an output aliasing an input.
+  static std::unique_ptr<WorkStealingExecutionPlan> Create(const GraphViewer& graph_viewer,
+                                                           const SequentialExecutionPlan& execution_plan,
+                                                           const OrtValueNameIdxMap& ort_value_name_idx_map,
+                                                           const KernelCreateInfoMap& kernel_create_info_map);
+
+  // the nodes without dependencies, highest priority first
+  InlinedVector<NodeIndex> root_nodes;
+  // indexed by node index. number of distinct nodes each node depends on.
+  std::vector<int> num_dependencies;
+  // indexed by node index. the nodes that depend on each node, highest priority first.
+  std::vector<InlinedVector<NodeIndex>> dependents;
+  // indexed by node index. number of nodes on the longest path from each node to a graph output, including the node.
+  std::vector<size_t> priority;
+  size_t num_nodes{0};
+  // index of the logic stream holding the nodes
+  size_t stream_idx{0};
+
+  // indexed by node index. elements are indices in SequentialExecutionPlan::release_actions.
+  std::vector<std::vector<size_t>> node_release_list;
+  // indexed like SequentialExecutionPlan::release_actions. number of nodes consuming each value.
+  std::vector<int> release_ref_counts;
+};
+
+// Runs the nodes of `plan` on `thread_pool` in dependency order. Each worker keeps running the highest priority node
+// made ready by the node it finished and schedules the others, which idle workers steal from its queue.
+// The calling thread runs the highest priority root node and then waits for all nodes to be done.
+Status ExecuteWithWorkStealing(StreamExecutionContext& ctx,
+                               const WorkStealingExecutionPlan& plan,
+                               concurrency::ThreadPool* thread_pool,
+                               SessionScope& session_scope,
+                               const bool& terminate_flag);
+
+}  // namespace onnxruntime
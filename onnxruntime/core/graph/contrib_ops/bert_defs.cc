@@ -318,7 +318,11 @@ void BaseGroupQueryAttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceConte
 
 void GroupQueryAttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceContext& ctx, int past_key_index) {
   // TODO(aciddelgado): propagate output shapes depending if kv-share buffer is on or not
-  constexpr int use_max_past_present_buffer = -1;
+  // The present page pools of the paged kv cache have the shape of the past page pools.
+  constexpr size_t block_table_index = 9;
+  const bool has_block_table =
+      ctx.getNumInputs() > block_table_index && ctx.getInputType(block_table_index) != nullptr;
+  const int use_max_past_present_buffer = has_block_table ? 1 : -1;
   BaseGroupQueryAttentionTypeAndShapeInference(ctx, past_key_index, use_max_past_present_buffer);
 }
 
@@ -1049,6 +1053,9 @@ Only supports causal and local attention.
 Supports rotary position embedding for CPU and CUDA.
 Supports packed input for CPU and CUDA.
 Supports continuous decoding for batch_size == 1 for CPU and CUDA.
+Supports paged k-v cache through block_table for CPU. past_key and past_value are then a pool of pages shared by all
+sequences, with shape (num_blocks, kv_num_heads, block_size, head_size), and row b of block_table lists the pages
+holding the tokens of sequence b in order.
 
 )DOC";
 
@@ -1128,6 +1135,13 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                "2D tensor with shape (max_sequence_length, head_size / 2).",
                "T",
                OpSchema::Optional)
+        .Input(9,
+               "block_table",
+               "2D tensor with shape (batch_size, max_blocks_per_sequence) of the pages of past_key and past_value "
+               "used by each sequence. When given, past_key and past_value are the page pools of a paged k-v cache "
+               "with shape (num_blocks, kv_num_heads, block_size, head_size).",
+               "M",
+               OpSchema::Optional)
         .Output(0,
                 "output",
                 "3D output tensor with shape (batch_size, sequence_length, hidden_size)",
@@ -497,9 +497,12 @@ void BeamSearchShapeInference(ONNX_NAMESPACE::InferenceContext& ctx) {
   }
 }
 
-void GreedySearchShapeInference(ONNX_NAMESPACE::InferenceContext& ctx) {
+void GreedySearchShapeInference(ONNX_NAMESPACE::InferenceContext& ctx, bool has_speculative_stats = false) {
   // Type inference
   ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 0);
+  if (has_speculative_stats && ctx.getNumOutputs() > 1) {
+    ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 1);
+  }
 
   // Shape inference
   // input 0 (input_ids) shape: (batch_size, sequence_length)
@@ -534,7 +537,11 @@ void GreedySearchShapeInference(ONNX_NAMESPACE::InferenceContext& ctx) {
   sequences_shape.add_dim()->set_dim_value(max_length_value);
   updateOutputShape(ctx, 0, sequences_shape);
 
-  if (ctx.getNumOutputs() > 1) {
+  if (ctx.getNumOutputs() > 1 && has_speculative_stats) {
+    ONNX_NAMESPACE::TensorShapeProto speculative_stats_shape;
+    speculative_stats_shape.add_dim()->set_dim_value(2);
+    updateOutputShape(ctx, 1, speculative_stats_shape);
+  } else if (ctx.getNumOutputs() > 1) {
     ONNX_NAMESPACE::TensorShapeProto logits_to_debug_shape;
     logits_to_debug_shape.add_dim()->set_dim_value(batch_size);
     logits_to_debug_shape.add_dim();
@@ -1321,6 +1328,13 @@ ONNX_MS_OPERATOR_SET_SCHEMA(GreedySearch, 1,
                                       "This is relevant only for the GPT2 model. If this attribute is missing, the `decoder` subgraph will be used for all decoding runs",
                                       AttributeProto::GRAPH, OPTIONAL_VALUE)
                                 .Attr("decoder", "Decoder subgraph to execute in a loop.", AttributeProto::GRAPH)
+                                .Attr("draft_decoder",
+                                      "Decoder subgraph of a smaller model with the same vocabulary, used for speculative decoding. "
+                                      "It proposes `num_speculative_tokens` tokens, which are verified by one run of the `decoder` subgraph. "
+                                      "This is relevant only for the GPT2 model with batch_size 1 on CPU.",
+                                      AttributeProto::GRAPH, OPTIONAL_VALUE)
+                                .Attr("num_speculative_tokens", "Number of tokens proposed by the `draft_decoder` subgraph for each run of the `decoder` subgraph.",
+                                      AttributeProto::INT, static_cast<int64_t>(4))
                                 .Attr("vocab_size",
                                       "Size of the vocabulary. "
                                       "If not provided, it will be inferred from the decoder subgraph's output shape",
@@ -1333,11 +1347,12 @@ ONNX_MS_OPERATOR_SET_SCHEMA(GreedySearch, 1,
                                 .Input(5, "prefix_vocab_mask", "Mask of vocabulary for first step. Words that masked with 0 are not allowed to be generated, and 1 is allowed. Shape is (batch_size, vocab_size)", "I", OpSchema::Optional)
                                 .Input(6, "attention_mask", "Custom attention mask. Shape is (batch_size, sequence_length)", "I", OpSchema::Optional)
                                 .Output(0, "sequences", "Word IDs of generated sequences. Shape is (batch_size, max_sequence_length)", "I")
+                                .Output(1, "speculative_stats", "Number of tokens proposed by the `draft_decoder` subgraph and number of them accepted by the `decoder` subgraph. Shape is (2)", "I", OpSchema::Optional)
                                 // TODO(wy): support scores if needed.
                                 .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
                                 .TypeConstraint("I", {"tensor(int32)"}, "Constrain to integer types")
                                 .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
-                                  GreedySearchShapeInference(ctx);
+                                  GreedySearchShapeInference(ctx, true);
                                 }));
 
 ONNX_MS_OPERATOR_SET_SCHEMA(Sampling, 1,
@@ -95,6 +95,13 @@ Abstract:
 #endif // ARM64
 #endif // Visual Studio 16 or earlier does not support fp16 intrinsic
 
+#if defined(__linux__) && (defined(MLAS_TARGET_ARM64) || defined(MLAS_TARGET_AMD64))
+// bfloat16 precision GEMM is implemented with NEON BF16 instructions on ARM64,
+// and with AVX512-BF16 or AMX-BF16 instructions on x64. The kernel is chosen at
+// runtime, see MlasBf16AccelerationSupported().
+#define MLAS_SBGEMM_SUPPORTED
+#endif
+
 //
 // Basic Linear Algebra Subprograms (BLAS) types.
 //
@@ -162,6 +169,9 @@ enum MLAS_ACTIVATION_KIND {
     MlasLogisticActivation,
     MlasClipActivation,
     MlasHardSigmoidActivation,
+    MlasGeluActivation,
+    MlasFastGeluActivation,
+    MlasSiluActivation,
     MlasActivationKindCount,
 };
 
@@ -179,6 +189,9 @@ struct MLAS_ACTIVATION {
             float alpha;
             float beta;
         } HardSigmoid;
+        struct {
+            float alpha;
+        } Silu;
         float Values[2];
     } Parameters;
 };
@@ -200,6 +213,23 @@ MlasActivation(
 // op(X) = X or op(X) = transpose(X) or op(X) = conjg(transpose(X))
 //
 
+/**
+ * @brief Operations fused into the stores of a single precision gemm.
+ *
+ * The output is computed as
+ *     C := Activation(alpha * op(A) * op(B) + beta * C + Bias + Residual)
+ * where Bias is a row of N elements broadcast over the rows of C and
+ * Residual is a M x N matrix. Each output tile is finished right after its
+ * last slice of K is accumulated, while the tile is still in the cache,
+ * instead of with a separate pass over C.
+ */
+struct MLAS_SGEMM_EPILOGUE {
+    const float* Bias = nullptr;                /**< Optional bias row of N elements */
+    const float* Residual = nullptr;            /**< Optional M x N matrix added to the output */
+    size_t ldr = 0;                             /**< Supplies the first dimension of matrix Residual */
+    const MLAS_ACTIVATION* Activation = nullptr; /**< Optional activation, nullptr is identity */
+};
+
 /**
  * @brief Supply matrices data information to single precision gemm functions
  */
@@ -213,6 +243,43 @@ struct MLAS_SGEMM_DATA_PARAMS {
     float alpha = 1.0f;       /**< Supplies the scalar alpha multiplier (see SGEMM definition) */
     float beta = 0.0f;        /**< Supplies the scalar beta multiplier (see SGEMM definition) */
     bool BIsPacked = false;   /**< Whether B is pre-packed */
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr; /**< Optional operations applied to the output tiles */
+    bool UseJitKernels = false; /**< Whether kernels specialized for the shape may be generated at runtime */
+};
+
+/**
+ * @brief Whether the platform supports generating SGEMM kernels at runtime,
+ *        see MLAS_SGEMM_DATA_PARAMS::UseJitKernels.
+ *
+ * The generated kernels target the short row blocks (up to four rows of
+ * matrix A) that the static kernels underutilize, such as M=1 inference on
+ * pre-packed weights. Other shapes continue to use the static kernels.
+ */
+bool
+MLASCALL
+MlasJitKernelsSupported(
+    void
+    );
+
+/**
+ * @brief Selects the dimension of matrix C that is partitioned across threads,
+ *        see MLAS_THREADING_PARAMS.
+ */
+enum MLAS_THREAD_PARTITION {
+    MlasThreadPartitionDefault, /**< Heuristic, partitions the larger of M and N */
+    MlasThreadPartitionM,       /**< Partitions the rows of matrix C */
+    MlasThreadPartitionN,       /**< Partitions the columns of matrix C */
+};
+
+/**
+ * @brief Overrides how the GEMM and convolution routines are segmented across
+ *        threads, such as with the partitioning an autotuner measured as
+ *        fastest for a shape. A zero thread count keeps the complexity based
+ *        heuristic. The thread count is still limited by the thread pool.
+ */
+struct MLAS_THREADING_PARAMS {
+    ptrdiff_t ThreadCount = 0;                                    /**< Number of threads for the whole operation */
+    MLAS_THREAD_PARTITION Partition = MlasThreadPartitionDefault; /**< Dimension partitioned across threads */
 };
 
 /**
@@ -228,6 +295,8 @@ struct MLAS_SGEMM_DATA_PARAMS {
  * @param BatchSize  Supplies number of multiplications in this batch
  * @param ThreadPool Supplies the thread pool object to use, else nullptr if the
                      base library threading support should be used.
+ * @param Threading  Optionally overrides how the batch is segmented across
+                     threads.
  */
 void
 MLASCALL
@@ -239,7 +308,8 @@ MlasGemmBatch(
     size_t K,
     const MLAS_SGEMM_DATA_PARAMS* Data,
     size_t BatchSize,
-    MLAS_THREADPOOL* ThreadPool
+    MLAS_THREADPOOL* ThreadPool,
+    const MLAS_THREADING_PARAMS* Threading = nullptr
     );
 
 /**
@@ -609,6 +679,7 @@ struct MLAS_GEMM_QUANT_DATA_PARAMS {
  * @param [IN]  DataParams   Array of data descriptors for the matrices.
  * @param [IN]  BatchN       Size of the parameters array, also number of multiplications to perform
  * @param [IN]  ThreadPool   optional thread pool for parallel processing
+ * @param [IN]  Threading    optionally overrides how the batch is segmented across threads
  */
 void
 MLASCALL
@@ -616,7 +687,8 @@ MlasGemmBatch(
     const MLAS_GEMM_QUANT_SHAPE_PARAMS& Shape,
     const MLAS_GEMM_QUANT_DATA_PARAMS* DataParams,
     const size_t BatchN,
-    MLAS_THREADPOOL* ThreadPool
+    MLAS_THREADPOOL* ThreadPool,
+    const MLAS_THREADING_PARAMS* Threading = nullptr
     );
 
 inline
@@ -675,6 +747,80 @@ MlasSymmQgemmBatch(
     );
 
 
+//
+// Block sparse matrix/matrix multiply routines.
+//
+// The right hand side is a constant weight matrix that is packed once into a
+// block compressed format: the columns of B are split into panels of 16 and
+// only the rows of a panel that contain a nonzero value are stored. Unstructured
+// and N:M structured sparsity are both handled by this format, the speedup over
+// the dense SGEMM depends on the fraction of the 1x16 row blocks that are zero.
+//
+
+/**
+ * @brief Returns the fraction of the 1x16 row blocks of B that are all zero,
+ *        this is the fraction of the work that MlasSparseGemmBatch skips.
+ *
+ * @param N      Number of columns of B
+ * @param K      Number of rows of B
+ * @param B      Address of matrix B, row major, not transposed
+ * @param ldb    Leading dimension of B
+ */
+float
+MLASCALL
+MlasSparseGemmBlockSparsity(
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    );
+
+/**
+ * @brief Returns the size of the buffer needed to pack B in the block sparse
+ *        format, or 0 if the format cannot represent B.
+ */
+size_t
+MLASCALL
+MlasSparseGemmPackBSize(
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    );
+
+void
+MLASCALL
+MlasSparseGemmPackB(
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+/**
+ * @brief Data parameters for block sparse matrix multiplication
+ *        C = A * B, where B was packed by MlasSparseGemmPackB.
+ */
+struct MLAS_SPARSE_GEMM_DATA_PARAMS {
+    const float* A = nullptr;
+    size_t lda = 0;
+    const void* PackedB = nullptr;
+    float* C = nullptr;
+    size_t ldc = 0;
+};
+
+void
+MLASCALL
+MlasSparseGemmBatch(
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SPARSE_GEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Buffer packing routines.
 //
@@ -779,6 +925,8 @@ struct MLAS_CONV_PARAMETERS {
     float Beta;
     MLAS_CONV_ALGORITHM Algorithm;
     ptrdiff_t ThreadCount;
+    bool UseJitKernels;
+    MLAS_THREADING_PARAMS Threading;
     union {
         struct {
             CBLAS_TRANSPOSE TransB;
@@ -806,7 +954,8 @@ MlasConvPrepare(MLAS_CONV_PARAMETERS* Parameters,
                 const MLAS_ACTIVATION* Activation,
                 size_t* WorkingBufferSize,
                 float Beta,
-                MLAS_THREADPOOL* ThreadPool);
+                MLAS_THREADPOOL* ThreadPool,
+                const MLAS_THREADING_PARAMS* Threading = nullptr);
 
 void
 MLASCALL
@@ -1026,6 +1175,64 @@ MlasComputeTanh(
     size_t N
     );
 
+//
+// Vectorized math routines. The maximum errors are 1 ulp for log and pow and
+// 2 ulp for sin and cos with |x| <= 4096; larger sin and cos arguments are
+// evaluated with the C runtime. The square root and reciprocal are correctly
+// rounded. Special values follow the C runtime functions.
+//
+
+void
+MLASCALL
+MlasComputeLog(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeSin(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeCos(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeSqrt(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeReciprocal(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputePow(
+    const float* Base,
+    const float* Exponent,
+    float* Output,
+    size_t N,
+    bool ScalarBase,
+    bool ScalarExponent
+    );
+
 //
 // Transpose routines.
 //
@@ -1643,7 +1850,7 @@ MlasHalfGemmConvertPackB(
     void* PackedB
     );
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
 /**
  * @brief Whether current CPU supports Bfloat16(bf16) acceleration.
  */
@@ -1754,7 +1961,7 @@ MlasSBGemmPackBSize(size_t N, size_t K);
  */
 void MLASCALL
 MlasSBGemmConvertPackB(size_t N, size_t K, const float* B, size_t ldb, void* PackedB);
-#endif
+#endif  // defined(MLAS_SBGEMM_SUPPORTED)
 
 /**
  * @brief Indirect Depthwise convolution for fp16
@@ -1838,6 +2045,18 @@ MlasNhwcAvgPool(
 
 #endif
 
+/**
+ * @brief Precision of the tensors of Flash Attention. The softmax and the
+ *        accumulation of the output are always done in fp32.
+ */
+enum MLAS_FLASH_ATTENTION_TYPE {
+    MlasFlashAttentionFloat32,  /**< Q, K, V and output are fp32 */
+    MlasFlashAttentionFloat16,  /**< Q, K, V and output are fp16 (MLAS_FP16) */
+    MlasFlashAttentionBFloat16, /**< Q, K, V and output are bf16, stored as uint16_t */
+    MlasFlashAttentionInt8QK,   /**< Q, K, V and output are fp32, Q*K' is computed with
+                                     int8 values of Q and K quantized per row */
+};
+
 struct MlasFlashAttentionThreadedArgs {
     int batch_size;
     int num_heads;
@@ -1851,16 +2070,54 @@ struct MlasFlashAttentionThreadedArgs {
     int thread_count;
     float* buffer;
     size_t buffer_size_per_thread;
-    const float* query;
-    const float* key;
-    const float* value;
-    float* output;
+    const void* query;
+    const void* key;
+    const void* value;
+    void* output;
+    MLAS_FLASH_ATTENTION_TYPE type = MlasFlashAttentionFloat32;
+    // query row i attends to the keys up to i + max(0, T - q_sequence_length), where T is the
+    // number of valid keys of the batch (kv_sequence_length unless kv_valid_lengths is set)
+    bool is_causal = false;
+    // number of heads of key and value (grouped query attention), query head i uses the key
+    // and value head i / (num_heads / kv_num_heads). 0 means num_heads.
+    int kv_num_heads = 0;
+    // optional number of valid keys of each batch, kv_sequence_length is then the sequence
+    // length of the key and value buffers
+    const int32_t* kv_valid_lengths = nullptr;
+    // with is_causal, query row i only attends to the local_window_size keys before its
+    // last visible key and that key. -1 disables the window.
+    int local_window_size = -1;
+    // when positive, the scaled scores x are replaced by softcap * tanh(x / softcap)
+    float softcap = 0.0f;
+    // adds a virtual zero score to the softmax of each row
+    bool smooth_softmax = false;
+    // number of elements between the batches of query, 0 means num_heads * q_sequence_length * qk_head_size.
+    // Allows the query to be a slice of packed query, key and value in BxNxSxH format.
+    size_t query_batch_stride = 0;
 };
 
 /**
- * @brief Per-thread worker function for fp32 Flash Attention
- * @param thread_id    Thread index
+ * @brief Returns the size of the per thread buffer of Flash Attention
+ *        (MlasFlashAttentionThreadedArgs::buffer_size_per_thread).
+ */
+size_t
+MLASCALL
+MlasFlashAttentionGetBufferSizePerThread(
+    MLAS_FLASH_ATTENTION_TYPE type,
+    size_t q_block_size,
+    size_t kv_block_size,
+    size_t qk_head_size,
+    size_t v_head_size
+);
+
+/**
+ * @brief Flash Attention for query, key and value in BxNxSxH format, the
+ *        output is in BxSxNxH format. The blocks of query rows are handed out
+ *        to the threads as they finish their previous block, so causal
+ *        attention, where the last blocks of query rows are the most
+ *        expensive, stays balanced.
  * @param args         Arguments
+ * @param ThreadPool   Thread pool, thread_count threads are used
  * @return
 */
 void
@@ -406,6 +406,120 @@ Return Value:
     }
 }
 
+template<MLAS_ACTIVATION_KIND ActivationKind>
+void
+MlasTranscendentalActivation(
+    const MLAS_ACTIVATION* Activation,
+    float* Buffer,
+    const float* Bias,
+    size_t M,
+    size_t N,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the activations that are built from one of the
+    vectorized transcendental routines. The argument of the transcendental
+    function is computed for a block of elements into a local buffer, which
+    stays in the L1 cache, and is then combined with the input.
+
+Arguments:
+
+    Activation - Supplies the parameters for the activation.
+
+    Buffer - Supplies the output matrix.
+
+    Bias - Supplies the optional bias vector.
+
+    M - Supplies the number of elements of the bias vector and the number of
+        rows in the output matrix.
+
+    N - Supplies the number of columns of the output matrix.
+
+    ldc - Supplies the number of elements per row of the output matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t BlockSize = 256;
+
+    MLAS_DECLSPEC_ALIGN(float Temporary[BlockSize], 64);
+
+    if (Bias != nullptr) {
+        MlasActivationKernel<MlasIdentityActivation, true>(Activation, Buffer, Bias, M, N, ldc);
+    }
+
+    while (M-- > 0) {
+
+        for (size_t n = 0; n < N; n += BlockSize) {
+
+            const size_t CountN = std::min(N - n, BlockSize);
+            float* Row = Buffer + n;
+
+            if constexpr (ActivationKind == MlasGeluActivation) {
+
+                //
+                // 0.5 * x * (1 + erf(x / sqrt(2)))
+                //
+
+                for (size_t i = 0; i < CountN; i++) {
+                    Temporary[i] = Row[i] * 0.70710678118654752440f;
+                }
+
+                MlasComputeErf(Temporary, Temporary, CountN);
+
+                for (size_t i = 0; i < CountN; i++) {
+                    Row[i] = 0.5f * Row[i] * (1.0f + Temporary[i]);
+                }
+
+            } else if constexpr (ActivationKind == MlasFastGeluActivation) {
+
+                //
+                // 0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3)))
+                //
+
+                for (size_t i = 0; i < CountN; i++) {
+                    const float x = Row[i];
+                    Temporary[i] = 0.7978845608028654f * (x + 0.044715f * x * x * x);
+                }
+
+                MlasComputeTanh(Temporary, Temporary, CountN);
+
+                for (size_t i = 0; i < CountN; i++) {
+                    Row[i] = 0.5f * Row[i] * (1.0f + Temporary[i]);
+                }
+
+            } else {
+
+                //
+                // x * sigmoid(alpha * x)
+                //
+
+                static_assert(ActivationKind == MlasSiluActivation, "unexpected activation kind");
+
+                const float alpha = Activation->Parameters.Silu.alpha;
+
+                for (size_t i = 0; i < CountN; i++) {
+                    Temporary[i] = alpha * Row[i];
+                }
+
+                MlasComputeLogistic(Temporary, Temporary, CountN);
+
+                for (size_t i = 0; i < CountN; i++) {
+                    Row[i] *= Temporary[i];
+                }
+            }
+        }
+
+        Buffer += ldc;
+    }
+}
+
 void
 MLASCALL
 MlasActivation(
@@ -512,6 +626,24 @@ Return Value:
             break;
         }
 
+        case MlasGeluActivation:
+        {
+            MlasTranscendentalActivation<MlasGeluActivation>(Activation, Buffer, Bias, M, N, ldc);
+            break;
+        }
+
+        case MlasFastGeluActivation:
+        {
+            MlasTranscendentalActivation<MlasFastGeluActivation>(Activation, Buffer, Bias, M, N, ldc);
+            break;
+        }
+
+        case MlasSiluActivation:
+        {
+            MlasTranscendentalActivation<MlasSiluActivation>(Activation, Buffer, Bias, M, N, ldc);
+            break;
+        }
+
         case MlasActivationKindCount:
         {
             MLAS_THROW_EX(std::runtime_error, "bad mlas activation kind");
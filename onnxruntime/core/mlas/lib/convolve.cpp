@@ -592,7 +592,7 @@ Return Value:
 
             MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, CountN,
                 CountK, 1.0f, Filter + k, K, ColumnBuffer, CountN, beta,
-                SegmentOutput, OutputSize);
+                SegmentOutput, OutputSize, nullptr, 0, 0, Parameters->UseJitKernels);
 
             beta = 1.0f;
         }
@@ -712,7 +712,7 @@ Return Value:
 
         MlasSgemmOperation(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount, OutputSize,
                            K, 1.0f, filter, K, input, Parameters->u.GemmDirect.ldb, Beta, output,
-                           OutputSize);
+                           OutputSize, nullptr, 0, 0, Parameters->UseJitKernels);
 
         //
         // Apply the activation with optional bias.
@@ -884,6 +884,10 @@ Return Value:
 
         ptrdiff_t TargetThreadCount = MlasGetMaximumThreadCount(ThreadPool);
 
+        if (Parameters->Threading.ThreadCount > 0 && Parameters->Threading.ThreadCount < TargetThreadCount) {
+            TargetThreadCount = Parameters->Threading.ThreadCount;
+        }
+
         if (size_t(TargetThreadCount) >= BatchGroupCount) {
             TargetThreadCount = ptrdiff_t(BatchGroupCount);
         }
@@ -935,9 +939,18 @@ Return Value:
                     // Invoke the threaded GEMM directly with the input tensor.
                     //
 
-                    MlasGemm(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount, OutputSize,
-                             K, 1.0f, filter, K, Input, Parameters->u.GemmDirect.ldb,
-                             Parameters->Beta, Output, OutputSize, ThreadPool);
+                    MLAS_SGEMM_DATA_PARAMS Data;
+                    Data.A = filter;
+                    Data.lda = K;
+                    Data.B = Input;
+                    Data.ldb = Parameters->u.GemmDirect.ldb;
+                    Data.C = Output;
+                    Data.ldc = OutputSize;
+                    Data.beta = Parameters->Beta;
+                    Data.UseJitKernels = Parameters->UseJitKernels;
+
+                    MlasGemmBatch(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount,
+                                  OutputSize, K, &Data, 1, ThreadPool, &Parameters->Threading);
 
                     //
                     // Apply the activation with optional bias.
@@ -962,9 +975,18 @@ Return Value:
                         MlasConvVol2Col(Parameters, Input, WorkingBuffer, 0, K, 0, OutputSize);
                     }
 
-                    MlasGemm(CblasNoTrans, CblasNoTrans, FilterCount, OutputSize, K, 1.0f, filter,
-                             K, WorkingBuffer, OutputSize, Parameters->Beta, Output, OutputSize,
-                             ThreadPool);
+                    MLAS_SGEMM_DATA_PARAMS Data;
+                    Data.A = filter;
+                    Data.lda = K;
+                    Data.B = WorkingBuffer;
+                    Data.ldb = OutputSize;
+                    Data.C = Output;
+                    Data.ldc = OutputSize;
+                    Data.beta = Parameters->Beta;
+                    Data.UseJitKernels = Parameters->UseJitKernels;
+
+                    MlasGemmBatch(CblasNoTrans, CblasNoTrans, FilterCount, OutputSize, K, &Data,
+                                  1, ThreadPool, &Parameters->Threading);
 
                     //
                     // Apply the activation with optional bias.
@@ -1041,7 +1063,8 @@ MlasConvPrepare(
     const MLAS_ACTIVATION* Activation,
     size_t* WorkingBufferSize,
     float Beta,
-    MLAS_THREADPOOL* ThreadPool
+    MLAS_THREADPOOL* ThreadPool,
+    const MLAS_THREADING_PARAMS* Threading
     )
 /*++
 
@@ -1088,6 +1111,9 @@ Arguments:
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
         base library threading support should be used.
 
+    Threading - Optionally supplies the thread count and partitioning to use
+        instead of the complexity based heuristic.
+
 Return Value:
 
     None.
@@ -1104,6 +1130,8 @@ Return Value:
     Parameters->InputChannels = InputChannels;
     Parameters->FilterCount = FilterCount;
     Parameters->Beta = Beta;
+    Parameters->UseJitKernels = false;
+    Parameters->Threading = (Threading != nullptr) ? *Threading : MLAS_THREADING_PARAMS{};
 
     size_t InputSize = 1;
     size_t OutputSize = 1;
@@ -1256,7 +1284,9 @@ Return Value:
         ptrdiff_t TargetThreadCount;
         double Complexity = double(FilterCount) * double(OutputSize) * double(K);
 
-        if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        if (Threading != nullptr && Threading->ThreadCount > 0) {
+            TargetThreadCount = Threading->ThreadCount;
+        } else if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
             TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
         } else {
             TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
@@ -1,14 +1,210 @@
+#include <atomic>
 #include <numeric>
 
 #include "mlasi.h"
 
+namespace
+{
+
+//
+// Shared state of the threads of one MlasFlashAttention call.
+//
+
+struct MlasFlashAttentionWork {
+    const MlasFlashAttentionThreadedArgs* args;
+    std::atomic<ptrdiff_t> next_task;
+};
+
+//
+// Offsets in bytes of the parts of the per thread buffer.
+//
+
+struct MlasFlashAttentionBufferLayout {
+    size_t l;
+    size_t m;
+    size_t intermediate;
+    size_t temp_output;
+    size_t query;        // fp32 copy of the query rows, fp16/bf16 only
+    size_t key;          // fp32 copy of the key rows, fp16/bf16 only
+    size_t value;        // fp32 copy of the value rows, fp16/bf16 only
+    size_t quant_query;  // int8 transposed query rows, int8 QK only
+    size_t packed_query; // quant_query packed for the QGEMM, int8 QK only
+    size_t quant_key;    // uint8 key rows, int8 QK only
+    size_t scores;       // int32 transposed Q*K', int8 QK only
+    size_t query_scale;  // int8 QK only
+    size_t key_scale;    // int8 QK only
+    size_t total;
+};
+
+MlasFlashAttentionBufferLayout
+MlasFlashAttentionGetBufferLayout(
+    MLAS_FLASH_ATTENTION_TYPE type,
+    size_t q_block_size,
+    size_t kv_block_size,
+    size_t qk_head_size,
+    size_t v_head_size
+)
+{
+    constexpr size_t alignment = 64;
+
+    MlasFlashAttentionBufferLayout layout{};
+    size_t offset = 0;
+    auto allocate = [&](size_t bytes) {
+        const size_t start = offset;
+        offset = (offset + bytes + alignment - 1) & ~(alignment - 1);
+        return start;
+    };
+
+    layout.l = allocate(q_block_size * sizeof(float));
+    layout.m = allocate(q_block_size * sizeof(float));
+    layout.intermediate = allocate(q_block_size * kv_block_size * sizeof(float));
+    layout.temp_output = allocate(q_block_size * v_head_size * sizeof(float));
+
+    if (type == MlasFlashAttentionFloat16 || type == MlasFlashAttentionBFloat16) {
+        layout.query = allocate(q_block_size * qk_head_size * sizeof(float));
+        layout.key = allocate(kv_block_size * qk_head_size * sizeof(float));
+        layout.value = allocate(kv_block_size * v_head_size * sizeof(float));
+    }
+
+    if (type == MlasFlashAttentionInt8QK) {
+        layout.quant_query = allocate(qk_head_size * q_block_size);
+        layout.packed_query = allocate(MlasGemmPackBSize(q_block_size, qk_head_size, false, true));
+        layout.quant_key = allocate(kv_block_size * qk_head_size);
+        layout.scores = allocate(kv_block_size * q_block_size * sizeof(int32_t));
+        layout.query_scale = allocate(q_block_size * sizeof(float));
+        layout.key_scale = allocate(kv_block_size * sizeof(float));
+    }
+
+    layout.total = offset;
+    return layout;
+}
+
+MLAS_FORCEINLINE
+float
+MlasBFloat16ToFloat(
+    uint16_t value
+)
+{
+    const uint32_t bits = uint32_t(value) << 16;
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+MLAS_FORCEINLINE
+uint16_t
+MlasFloatToBFloat16(
+    float value
+)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    if ((bits & 0x7fffffff) > 0x7f800000) {
+        return uint16_t((bits >> 16) | 0x40);  // quiet NaN
+    }
+    // round to nearest even
+    bits += 0x7fff + ((bits >> 16) & 1);
+    return uint16_t(bits >> 16);
+}
+
+/*
+    Converts rows of fp16 or bf16 elements to fp32.
+*/
+void
+MlasFlashAttentionConvertToFloat(
+    MLAS_FLASH_ATTENTION_TYPE type,
+    const void* source,
+    float* destination,
+    size_t count
+)
+{
+    if (type == MlasFlashAttentionFloat16) {
+        MlasConvertHalfToFloatBuffer(static_cast<const MLAS_FP16*>(source), destination, count);
+    } else {
+        const uint16_t* src = static_cast<const uint16_t*>(source);
+        for (size_t i = 0; i < count; i++) {
+            destination[i] = MlasBFloat16ToFloat(src[i]);
+        }
+    }
+}
+
+/*
+    Quantizes each row of a matrix to int8 with a symmetric per row scale,
+    and stores the rows as the columns of the output.
+*/
+void
+MlasFlashAttentionQuantizeRowsTransposed(
+    const float* input,
+    size_t rows,
+    size_t cols,
+    int8_t* output,
+    float* scales
+)
+{
+    for (size_t r = 0; r < rows; r++) {
+        const float* row = input + r * cols;
+
+        float minimum, maximum;
+        MlasFindMinMaxElement(row, &minimum, &maximum, cols);
+        const float scale = std::max(-minimum, maximum) / 127.0f;
+        const float inverse_scale = (scale == 0.0f) ? 0.0f : 1.0f / scale;
+        scales[r] = scale;
+
+        for (size_t c = 0; c < cols; c++) {
+            const int32_t q = static_cast<int32_t>(std::nearbyint(row[c] * inverse_scale));
+            output[c * rows + r] = static_cast<int8_t>(std::min(std::max(q, -127), 127));
+        }
+    }
+}
+
+/*
+    Quantizes each row of a matrix to uint8 with a symmetric per row scale
+    and a zero point of 128.
+*/
+void
+MlasFlashAttentionQuantizeRowsOffset(
+    const float* input,
+    size_t rows,
+    size_t cols,
+    uint8_t* output,
+    float* scales
+)
+{
+    for (size_t r = 0; r < rows; r++) {
+        const float* row = input + r * cols;
+
+        float minimum, maximum;
+        MlasFindMinMaxElement(row, &minimum, &maximum, cols);
+        const float scale = std::max(-minimum, maximum) / 127.0f;
+        scales[r] = scale;
+
+        MlasQuantizeLinear(row, output + r * cols, cols, (scale == 0.0f) ? 1.0f : scale, uint8_t(128));
+    }
+}
+
+}  // namespace
+
+size_t
+MLASCALL
+MlasFlashAttentionGetBufferSizePerThread(
+    MLAS_FLASH_ATTENTION_TYPE type,
+    size_t q_block_size,
+    size_t kv_block_size,
+    size_t qk_head_size,
+    size_t v_head_size
+)
+{
+    return MlasFlashAttentionGetBufferLayout(type, q_block_size, kv_block_size, qk_head_size, v_head_size).total;
+}
+
 void
 MlasFlashAttentionThreaded(
     void* argptr,
     std::ptrdiff_t thread_id
 )
 {
-    const MlasFlashAttentionThreadedArgs* args = reinterpret_cast<MlasFlashAttentionThreadedArgs*>(argptr);
+    MlasFlashAttentionWork* work = reinterpret_cast<MlasFlashAttentionWork*>(argptr);
+    const MlasFlashAttentionThreadedArgs* args = work->args;
     ptrdiff_t q_block_size = static_cast<ptrdiff_t>(args->q_block_size);
     ptrdiff_t kv_block_size = static_cast<ptrdiff_t>(args->kv_block_size);
     ptrdiff_t batch_size = static_cast<ptrdiff_t>(args->batch_size);
@@ -17,51 +213,122 @@ MlasFlashAttentionThreaded(
     ptrdiff_t kv_sequence_length = static_cast<ptrdiff_t>(args->kv_sequence_length);
     ptrdiff_t qk_head_size = static_cast<ptrdiff_t>(args->qk_head_size);
     ptrdiff_t v_head_size = static_cast<ptrdiff_t>(args->v_head_size);
-    float* buffer = args->buffer;
     ptrdiff_t buffer_size_per_thread = static_cast<ptrdiff_t>(args->buffer_size_per_thread);
-    ptrdiff_t thread_count = static_cast<ptrdiff_t>(args->thread_count);
-    const float* query = args->query;
-    const float* key = args->key;
-    const float* value = args->value;
-    float* output = args->output;
+    const MLAS_FLASH_ATTENTION_TYPE type = args->type;
+    const bool low_precision = (type == MlasFlashAttentionFloat16 || type == MlasFlashAttentionBFloat16);
+    const size_t element_size = low_precision ? sizeof(uint16_t) : sizeof(float);
+    const char* query = static_cast<const char*>(args->query);
+    const char* key = static_cast<const char*>(args->key);
+    const char* value = static_cast<const char*>(args->value);
+    char* output = static_cast<char*>(args->output);
+
+    const ptrdiff_t kv_num_heads = args->kv_num_heads > 0 ? static_cast<ptrdiff_t>(args->kv_num_heads) : num_heads;
+    const ptrdiff_t kv_group_size = num_heads / kv_num_heads;
+    const ptrdiff_t query_batch_stride = args->query_batch_stride != 0
+                                             ? static_cast<ptrdiff_t>(args->query_batch_stride)
+                                             : num_heads * q_sequence_length * qk_head_size;
+    const ptrdiff_t local_window_size = args->is_causal ? static_cast<ptrdiff_t>(args->local_window_size) : -1;
+    const float softcap = args->softcap;
+    const float initial_m = args->smooth_softmax ? 0.0f : std::numeric_limits<float>::lowest();
 
 #if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
     auto&& mlas_platform = GetMlasPlatform();
 #endif
 
-    ptrdiff_t q_chunk_count = (q_sequence_length + (q_block_size - 1)) / q_block_size;
+    const MlasFlashAttentionBufferLayout layout = MlasFlashAttentionGetBufferLayout(
+        type, static_cast<size_t>(q_block_size), static_cast<size_t>(kv_block_size),
+        static_cast<size_t>(qk_head_size), static_cast<size_t>(v_head_size));
 
-    ptrdiff_t task_start = 0;
-    ptrdiff_t task_end = 0;
-    ptrdiff_t total_task_count = batch_size * num_heads * q_chunk_count;
-    ptrdiff_t quotient = total_task_count / thread_count;
-    ptrdiff_t remainder = total_task_count % thread_count;
-    if (thread_id < remainder) {
-        task_start = (quotient + 1) * thread_id;
-        task_end = task_start + quotient + 1;
-    } else {
-        task_start = quotient * thread_id + remainder;
-        task_end = task_start + quotient;
-    }
+    char* buffer_current_thread = reinterpret_cast<char*>(args->buffer) + thread_id * buffer_size_per_thread;
+    float* l = reinterpret_cast<float*>(buffer_current_thread + layout.l);
+    float* m = reinterpret_cast<float*>(buffer_current_thread + layout.m);
+    float* intermediate = reinterpret_cast<float*>(buffer_current_thread + layout.intermediate);
+    float* temp_output = reinterpret_cast<float*>(buffer_current_thread + layout.temp_output);
+    float* query_float = reinterpret_cast<float*>(buffer_current_thread + layout.query);
+    float* key_float = reinterpret_cast<float*>(buffer_current_thread + layout.key);
+    float* value_float = reinterpret_cast<float*>(buffer_current_thread + layout.value);
+    int8_t* quant_query = reinterpret_cast<int8_t*>(buffer_current_thread + layout.quant_query);
+    void* packed_query = buffer_current_thread + layout.packed_query;
+    uint8_t* quant_key = reinterpret_cast<uint8_t*>(buffer_current_thread + layout.quant_key);
+    int32_t* scores = reinterpret_cast<int32_t*>(buffer_current_thread + layout.scores);
+    float* query_scale = reinterpret_cast<float*>(buffer_current_thread + layout.query_scale);
+    float* key_scale = reinterpret_cast<float*>(buffer_current_thread + layout.key_scale);
 
-    for (ptrdiff_t task_index = task_start; task_index < task_end; ++task_index) {
-        ptrdiff_t batch_idx = task_index;
-        ptrdiff_t q_idx = (batch_idx % q_chunk_count) * q_block_size;
-        batch_idx /= q_chunk_count;
-        ptrdiff_t head_idx = batch_idx % num_heads;
-        batch_idx /= num_heads;
+    // the QGEMM may not support packing on all platforms
+    const bool pack_query = (type == MlasFlashAttentionInt8QK) &&
+                            MlasGemmPackBSize(static_cast<size_t>(q_block_size), static_cast<size_t>(qk_head_size),
+                                              false, true) != 0;
+
+    const ptrdiff_t q_chunk_count = (q_sequence_length + (q_block_size - 1)) / q_block_size;
+    const ptrdiff_t head_count = batch_size * num_heads;
+    const ptrdiff_t total_task_count = head_count * q_chunk_count;
+
+    for (;;) {
+        //
+        // Hand out the tasks dynamically. The last chunks of query rows are
+        // handed out first since they are the most expensive ones with a
+        // causal mask.
+        //
+
+        const ptrdiff_t task_index = work->next_task.fetch_add(1, std::memory_order_relaxed);
+        if (task_index >= total_task_count) {
+            break;
+        }
+
+        const ptrdiff_t q_idx = (q_chunk_count - 1 - task_index / head_count) * q_block_size;
+        const ptrdiff_t h = task_index % head_count;
+        const ptrdiff_t head_idx = h % num_heads;
+        const ptrdiff_t batch_idx = h / num_heads;
+        const ptrdiff_t kv_h = batch_idx * kv_num_heads + head_idx / kv_group_size;
+
+        const size_t row_size_q_capped = static_cast<size_t>(std::min(q_block_size, q_sequence_length - q_idx));
+
+        const ptrdiff_t kv_valid_length = args->kv_valid_lengths != nullptr
+                                              ? static_cast<ptrdiff_t>(args->kv_valid_lengths[batch_idx])
+                                              : kv_sequence_length;
+
+        // key j is visible to query row i when j <= i + causal_offset
+        const ptrdiff_t causal_offset = std::max<ptrdiff_t>(kv_valid_length - q_sequence_length, 0);
+
+        // Blocks of keys past the last row of the chunk are fully masked and skipped,
+        // so are the blocks before the local window of the first row.
+        const ptrdiff_t kv_end = args->is_causal
+                                     ? std::min(kv_valid_length,
+                                                q_idx + static_cast<ptrdiff_t>(row_size_q_capped) + causal_offset)
+                                     : kv_valid_length;
+        const ptrdiff_t kv_start = local_window_size >= 0
+                                       ? std::max<ptrdiff_t>(q_idx + causal_offset - local_window_size, 0)
+                                       : 0;
 
-        char* buffer_current_thread = reinterpret_cast<char*>(buffer) + thread_id * buffer_size_per_thread;
-        float* l = reinterpret_cast<float*>(buffer_current_thread);
-        float* m = l + q_block_size;
         for (ptrdiff_t t = 0; t < q_block_size; ++t) {
-            m[t] = std::numeric_limits<float>::lowest();
+            m[t] = initial_m;
+            l[t] = args->smooth_softmax ? 1.0f : 0.0f;
         }
-        float* intermediate = m + q_block_size;
-        float* temp_output = intermediate + q_block_size * kv_block_size;
+        std::fill_n(temp_output, row_size_q_capped * static_cast<size_t>(v_head_size), 0.0f);
         float negmax = 0;
 
-        for (ptrdiff_t ir = 0; ir < kv_sequence_length; ir += kv_block_size) {
+        const size_t q_offset =
+            static_cast<size_t>(batch_idx * query_batch_stride + (head_idx * q_sequence_length + q_idx) * qk_head_size);
+        const float* inputQ = reinterpret_cast<const float*>(query + q_offset * element_size);
+        if (low_precision) {
+            MlasFlashAttentionConvertToFloat(type, query + q_offset * element_size, query_float,
+                                             row_size_q_capped * static_cast<size_t>(qk_head_size));
+            inputQ = query_float;
+        } else if (type == MlasFlashAttentionInt8QK) {
+            //
+            // Q*K' is computed transposed, as K*Q', so that the quantized
+            // query rows are packed once for all the blocks of keys.
+            //
+            MlasFlashAttentionQuantizeRowsTransposed(inputQ, row_size_q_capped, static_cast<size_t>(qk_head_size),
+                                                     quant_query, query_scale);
+            if (pack_query) {
+                MlasGemmPackB(row_size_q_capped, static_cast<size_t>(qk_head_size),
+                              reinterpret_cast<const uint8_t*>(quant_query), row_size_q_capped, false, true,
+                              packed_query);
+            }
+        }
+
+        for (ptrdiff_t ir = kv_start; ir < kv_end; ir += kv_block_size) {
             /*
                 S = Q[batch_idx, head_idx, q_idx:q_idx+q_block_size, :] * (K[batch_idx, head_idx, ir:ir+kv_block_size, :]).T
                 old_m = m
@@ -71,27 +338,97 @@ MlasFlashAttentionThreaded(
                 l = exp(diff) * l + rowsum(S)
                 O = diag(exp(diff)) * O + S * V[batch_idx, head_idx, ir:ir+kv_block_size, :]
             */
-            ptrdiff_t h = batch_idx * num_heads + head_idx;
-            const float* inputQ = query + (h * q_sequence_length + q_idx) * qk_head_size;
-            const float* inputK = key + (h * kv_sequence_length + ir) * qk_head_size;
-            const float* inputV = value + (h * kv_sequence_length + ir) * v_head_size;
+            const size_t k_offset = static_cast<size_t>((kv_h * kv_sequence_length + ir) * qk_head_size);
+            const size_t v_offset = static_cast<size_t>((kv_h * kv_sequence_length + ir) * v_head_size);
+            const float* inputK = reinterpret_cast<const float*>(key + k_offset * element_size);
+            const float* inputV = reinterpret_cast<const float*>(value + v_offset * element_size);
 
-            size_t row_size_q_capped = static_cast<size_t>(std::min(q_block_size, q_sequence_length - q_idx));
-            size_t row_size_kv_capped = static_cast<size_t>(std::min(kv_block_size, kv_sequence_length - ir));
+            size_t row_size_kv_capped = static_cast<size_t>(std::min(kv_block_size, kv_end - ir));
 
-            MlasSgemmOperation(CBLAS_TRANSPOSE::CblasNoTrans,
-                     CBLAS_TRANSPOSE::CblasTrans,
-                     row_size_q_capped,
-                     row_size_kv_capped,
-                     static_cast<size_t>(qk_head_size),
-                     args->scale,
-                     inputQ,
-                     static_cast<size_t>(qk_head_size),
-                     inputK,
-                     static_cast<size_t>(qk_head_size),
-                     0.0f,
-                     intermediate,
-                     row_size_kv_capped);
+            if (low_precision) {
+                MlasFlashAttentionConvertToFloat(type, key + k_offset * element_size, key_float,
+                                                 row_size_kv_capped * static_cast<size_t>(qk_head_size));
+                MlasFlashAttentionConvertToFloat(type, value + v_offset * element_size, value_float,
+                                                 row_size_kv_capped * static_cast<size_t>(v_head_size));
+                inputK = key_float;
+                inputV = value_float;
+            }
+
+            if (type == MlasFlashAttentionInt8QK) {
+                MlasFlashAttentionQuantizeRowsOffset(inputK, row_size_kv_capped, static_cast<size_t>(qk_head_size),
+                                                     quant_key, key_scale);
+
+                static const uint8_t zero_point_b = 0;
+
+                MLAS_GEMM_QUANT_SHAPE_PARAMS shape;
+                shape.M = row_size_kv_capped;
+                shape.N = row_size_q_capped;
+                shape.K = static_cast<size_t>(qk_head_size);
+                shape.AIsSigned = false;
+                shape.BIsSigned = true;
+
+                MLAS_GEMM_QUANT_DATA_PARAMS data;
+                data.A = quant_key;
+                data.lda = static_cast<size_t>(qk_head_size);
+                data.ZeroPointA = 128;
+                data.B = pack_query ? packed_query : static_cast<const void*>(quant_query);
+                data.ldb = row_size_q_capped;
+                data.BIsPacked = pack_query;
+                data.ZeroPointB = &zero_point_b;
+                data.C = scores;
+                data.ldc = row_size_q_capped;
+
+                MlasGemmBatch(shape, &data, 1, nullptr);
+
+                for (size_t irow = 0; irow < row_size_q_capped; ++irow) {
+                    const float row_scale = query_scale[irow] * args->scale;
+                    float* p = intermediate + irow * row_size_kv_capped;
+                    for (size_t icol = 0; icol < row_size_kv_capped; ++icol) {
+                        p[icol] = static_cast<float>(scores[icol * row_size_q_capped + irow]) * row_scale * key_scale[icol];
+                    }
+                }
+            } else {
+                MlasSgemmOperation(CBLAS_TRANSPOSE::CblasNoTrans,
+                         CBLAS_TRANSPOSE::CblasTrans,
+                         row_size_q_capped,
+                         row_size_kv_capped,
+                         static_cast<size_t>(qk_head_size),
+                         args->scale,
+                         inputQ,
+                         static_cast<size_t>(qk_head_size),
+                         inputK,
+                         static_cast<size_t>(qk_head_size),
+                         0.0f,
+                         intermediate,
+                         row_size_kv_capped);
+            }
+
+            if (softcap > 0.0f) {
+                float* p = intermediate;
+                for (size_t i = 0; i < row_size_q_capped * row_size_kv_capped; ++i) {
+                    p[i] = softcap * std::tanh(p[i] / softcap);
+                }
+            }
+
+            if (args->is_causal) {
+                // mask the keys of the block past the last visible key of each row,
+                // and the keys before the local window of each row
+                for (size_t irow = 0; irow < row_size_q_capped; ++irow) {
+                    float* p = intermediate + irow * row_size_kv_capped;
+                    const ptrdiff_t first_masked = q_idx + static_cast<ptrdiff_t>(irow) + causal_offset + 1 - ir;
+                    if (first_masked < static_cast<ptrdiff_t>(row_size_kv_capped)) {
+                        std::fill(p + std::max<ptrdiff_t>(first_masked, 0), p + row_size_kv_capped,
+                                  std::numeric_limits<float>::lowest());
+                    }
+                    if (local_window_size >= 0) {
+                        const ptrdiff_t first_visible = first_masked - 1 - local_window_size;
+                        if (first_visible > 0) {
+                            std::fill(p, p + std::min<ptrdiff_t>(first_visible, static_cast<ptrdiff_t>(row_size_kv_capped)),
+                                      std::numeric_limits<float>::lowest());
+                        }
+                    }
+                }
+            }
 
             for (ptrdiff_t irow = 0; irow < static_cast<ptrdiff_t>(row_size_q_capped); ++irow) {
                 float* p = intermediate + irow * row_size_kv_capped;
@@ -101,6 +438,11 @@ MlasFlashAttentionThreaded(
 #else
                 float rowmax = MlasReduceMaximumF32Kernel(p, row_size_kv_capped);
 #endif
+                if (rowmax == std::numeric_limits<float>::lowest()) {
+                    // all the keys of the block are masked for this row
+                    std::fill_n(p, row_size_kv_capped, 0.0f);
+                    continue;
+                }
                 float m_diff = m[irow];
                 m[irow] = std::max(m[irow], rowmax);  // new m
                 negmax = -m[irow];
@@ -112,17 +454,14 @@ MlasFlashAttentionThreaded(
                 float rowsum = MlasComputeSumExpF32Kernel(p, p, row_size_kv_capped, &negmax);
 #endif
 
-                // Note: for ir == 0, there is actually no need to calculate exp_diff
-                if (ir != 0) {
-                    float exp_diff = std::exp(m_diff);
-                    l[irow] = exp_diff * l[irow] + rowsum;
+                float exp_diff = std::exp(m_diff);
+                l[irow] = exp_diff * l[irow] + rowsum;
 
+                if (ir != kv_start) {
+                    // When ir == kv_start, there is no need to scale the old result because it is zero.
                     for (ptrdiff_t icol = 0; icol < v_head_size; ++icol) {
                         temp_output[irow * v_head_size + icol] = exp_diff * temp_output[irow * v_head_size + icol];
                     }
-                } else {
-                    l[irow] = rowsum;
-                    // When ir == 0, there is no need to scale the old result because it is zero.
                 }
             }
             MlasSgemmOperation(CBLAS_TRANSPOSE::CblasNoTrans,
@@ -135,19 +474,36 @@ MlasFlashAttentionThreaded(
                      row_size_kv_capped,
                      inputV,
                      static_cast<size_t>(v_head_size),
-                     ir == 0 ? 0.0f : 1.0f,
+                     1.0f,
                      temp_output,
                      static_cast<size_t>(v_head_size));
         }
 
-        float* output_row = output + ((batch_idx * q_sequence_length + q_idx) * num_heads + head_idx) * v_head_size;
-        ptrdiff_t row_size_q_valid = std::min(q_block_size, q_sequence_length - q_idx);
+        const size_t output_offset =
+            static_cast<size_t>(((batch_idx * q_sequence_length + q_idx) * num_heads + head_idx) * v_head_size);
+        char* output_row = output + output_offset * element_size;
+        const size_t output_row_stride = static_cast<size_t>(num_heads * v_head_size) * element_size;
         // TODO: leverage advanced instruction sets
-        for (ptrdiff_t irow = 0; irow < row_size_q_valid; ++irow) {
-            for (ptrdiff_t icol = 0; icol < v_head_size; ++icol) {
-                output_row[icol] = temp_output[irow * v_head_size + icol] / l[irow];
+        for (size_t irow = 0; irow < row_size_q_capped; ++irow) {
+            float* temp_row = temp_output + irow * v_head_size;
+            // a row without visible keys keeps a zero output
+            if (l[irow] > 0.0f) {
+                for (ptrdiff_t icol = 0; icol < v_head_size; ++icol) {
+                    temp_row[icol] /= l[irow];
+                }
             }
-            output_row += num_heads * v_head_size;
+            if (type == MlasFlashAttentionFloat16) {
+                MlasConvertFloatToHalfBuffer(temp_row, reinterpret_cast<MLAS_FP16*>(output_row),
+                                             static_cast<size_t>(v_head_size));
+            } else if (type == MlasFlashAttentionBFloat16) {
+                uint16_t* output_bf16 = reinterpret_cast<uint16_t*>(output_row);
+                for (ptrdiff_t icol = 0; icol < v_head_size; ++icol) {
+                    output_bf16[icol] = MlasFloatToBFloat16(temp_row[icol]);
+                }
+            } else {
+                std::copy_n(temp_row, v_head_size, reinterpret_cast<float*>(output_row));
+            }
+            output_row += output_row_stride;
         }
     }
 }
@@ -159,9 +515,13 @@ MlasFlashAttention(
     MLAS_THREADPOOL* ThreadPool
 )
 {
+    MlasFlashAttentionWork work;
+    work.args = args;
+    work.next_task = 0;
+
     MlasExecuteThreaded(
         MlasFlashAttentionThreaded,
-        static_cast<void *>(args),
+        static_cast<void *>(&work),
         static_cast<std::ptrdiff_t>(args->thread_count),
         ThreadPool);
 }
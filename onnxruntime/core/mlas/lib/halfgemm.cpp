@@ -28,7 +28,11 @@ MlasFp16AccelerationSupported()
 #ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
     return MLAS_CPUIDINFO::GetCPUIDInfo().HasFp16VectorAcceleration();
 #else
-    return false;
+    //
+    // The half precision GEMM kernels for other architectures are selected
+    // at runtime, see MLAS_PLATFORM::HalfGemmDispatch.
+    //
+    return GetMlasPlatform().HalfGemmDispatch != nullptr;
 #endif
 }
 
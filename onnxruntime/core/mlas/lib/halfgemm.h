@@ -510,6 +510,7 @@ MlasHalfGemmGetDispatch()
 #if defined(MLAS_F16VEC_INTRINSICS_SUPPORTED) && defined(MLAS_TARGET_ARM64)
     return &MlasHalfGemmDispatchNeon;
 #else
-    return &MlasHalfGemmDispatchDefault;
+    const MLAS_HALFGEMM_DISPATCH* dispatch = GetMlasPlatform().HalfGemmDispatch;
+    return (dispatch != nullptr) ? dispatch : &MlasHalfGemmDispatchDefault;
 #endif
 }
@@ -0,0 +1,293 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements half precision GEMM kernel for AVX2/FMA3.
+
+    The processor has no fp16 arithmetic, so the fp16 elements of the
+    matrices are converted to fp32 with F16C instructions as they are
+    loaded, and the products are accumulated in fp32. The output is
+    rounded to fp16 once when it is stored.
+
+--*/
+
+#include <cstring>
+#include <utility>
+
+#include "mlasi.h"
+#include "halfgemm.h"
+
+struct MLAS_HALF_GEMM_KERNEL_AVX2 {
+    static constexpr bool PackNeeded = false;
+    static constexpr size_t KernelMaxM = 6;  // max # rows the vectorized kernel can process
+    static constexpr size_t PackedK = 1;
+
+    static constexpr MLAS_HALF_GEMM_STRIDES Strides{24, 128, 512};
+};
+
+namespace
+{
+
+template <typename IterationFn, size_t... Indices>
+MLAS_FORCEINLINE void
+UnrolledLoopIterations(IterationFn&& f, std::index_sequence<Indices...> /* indices */)
+{
+    (f(Indices), ...);
+}
+
+template <size_t N, typename IterationFn>
+MLAS_FORCEINLINE void
+UnrolledLoop(IterationFn&& f)
+{
+    UnrolledLoopIterations(std::forward<IterationFn>(f), std::make_index_sequence<N>());
+}
+
+MLAS_FORCEINLINE
+void
+CvtFloat2Half(
+    _mlas_fp16_* dest,
+    const float* src,
+    size_t len
+)
+{
+    while (len >= 8) {
+        const __m128i half = _mm256_cvtps_ph(_mm256_loadu_ps(src), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), half);
+        src += 8;
+        dest += 8;
+        len -= 8;
+    }
+
+    while (len > 0) {
+        *dest++ = _cvtss_sh(*src++, _MM_FROUND_TO_NEAREST_INT);
+        len--;
+    }
+}
+
+/**
+ * @brief Convert a 2D matrix from float to fp16
+*/
+MLAS_FORCEINLINE
+void
+CvtFloat2Half2D(
+    _mlas_fp16_* dest,
+    const float* src,
+    size_t stride,
+    size_t CntRow,
+    size_t CntCol
+    )
+{
+    if (stride == CntCol) {
+        CvtFloat2Half(dest, src, CntRow * CntCol);
+        return;
+    }
+    while (CntRow > 0) {
+        CvtFloat2Half(dest, src, CntCol);
+        src += stride;
+        dest += CntCol;
+        CntRow--;
+    }
+}
+
+/**
+ * @brief Load up to 16 fp16 elements as two vectors of fp32, the elements
+ *        past CountN are zero.
+*/
+MLAS_FORCEINLINE
+void
+LoadHalf16(
+    const _mlas_fp16_* src,
+    size_t CountN,
+    __m256& lo,
+    __m256& hi
+    )
+{
+    if (CountN >= 16) {
+        lo = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+        hi = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 8)));
+        return;
+    }
+
+    MLAS_DECLSPEC_ALIGN(_mlas_fp16_ buffer[16], 32) = {};
+    std::memcpy(buffer, src, CountN * sizeof(_mlas_fp16_));
+    lo = _mm256_cvtph_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(buffer)));
+    hi = _mm256_cvtph_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(buffer + 8)));
+}
+
+MLAS_FORCEINLINE
+void
+StoreHalf16(
+    _mlas_fp16_* dest,
+    size_t CountN,
+    __m256 lo,
+    __m256 hi
+    )
+{
+    const __m128i halflo = _mm256_cvtps_ph(lo, _MM_FROUND_TO_NEAREST_INT);
+    const __m128i halfhi = _mm256_cvtps_ph(hi, _MM_FROUND_TO_NEAREST_INT);
+
+    if (CountN >= 16) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), halflo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 8), halfhi);
+        return;
+    }
+
+    MLAS_DECLSPEC_ALIGN(_mlas_fp16_ buffer[16], 32);
+    _mm_store_si128(reinterpret_cast<__m128i*>(buffer), halflo);
+    _mm_store_si128(reinterpret_cast<__m128i*>(buffer + 8), halfhi);
+    std::memcpy(dest, buffer, CountN * sizeof(_mlas_fp16_));
+}
+
+/*
+    This routine computes RowCount rows of C, 16 columns at a time. The
+    partial block of columns at the end of a row is loaded and stored
+    through a local buffer.
+*/
+template <size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernelAvx2Rows(
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    const bool ZeroMode
+    )
+{
+    for (size_t n = 0; n < CountN; n += 16) {
+        const size_t CountCols = std::min(CountN - n, size_t(16));
+
+        __m256 Accumulators[RowCount][2];
+
+        if (ZeroMode) {
+            __m256 bias0 = _mm256_setzero_ps();
+            __m256 bias1 = _mm256_setzero_ps();
+            if (Bias != nullptr) {
+                LoadHalf16(Bias + n, CountCols, bias0, bias1);
+            }
+            UnrolledLoop<RowCount>([&](size_t r) {
+                Accumulators[r][0] = bias0;
+                Accumulators[r][1] = bias1;
+            });
+        } else {
+            UnrolledLoop<RowCount>([&](size_t r) {
+                LoadHalf16(C + r * ldc + n, CountCols, Accumulators[r][0], Accumulators[r][1]);
+            });
+        }
+
+        const _mlas_fp16_* b = B + n;
+
+        for (size_t k = 0; k < CountK; k++) {
+            __m256 b0;
+            __m256 b1;
+            LoadHalf16(b, CountCols, b0, b1);
+
+            UnrolledLoop<RowCount>([&](size_t r) {
+                const __m256 a = _mm256_set1_ps(_cvtsh_ss(A[r * lda + k]));
+                Accumulators[r][0] = _mm256_fmadd_ps(a, b0, Accumulators[r][0]);
+                Accumulators[r][1] = _mm256_fmadd_ps(a, b1, Accumulators[r][1]);
+            });
+
+            b += ldb;
+        }
+
+        UnrolledLoop<RowCount>([&](size_t r) {
+            StoreHalf16(C + r * ldc + n, CountCols, Accumulators[r][0], Accumulators[r][1]);
+        });
+    }
+}
+
+}  // namespace
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackA<MLAS_HALF_GEMM_KERNEL_AVX2>(
+    _mlas_fp16_* D,
+    const float* A,
+    size_t lda,
+    size_t CountM,
+    size_t CountK
+)
+{
+    CvtFloat2Half2D(D, A, lda, CountM, CountK);
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX2>(
+    _mlas_fp16_* D,
+    const float* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK
+)
+{
+    CvtFloat2Half2D(D, B, ldb, CountK, CountN);
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernel<MLAS_HALF_GEMM_KERNEL_AVX2>(
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    const bool ZeroMode)
+{
+    //
+    // Process up to KernelMaxM rows, the driver calls again for the rest.
+    //
+
+    switch (std::min(CountM, MLAS_HALF_GEMM_KERNEL_AVX2::KernelMaxM)) {
+        case 1:
+            MlasHalfGemmKernelAvx2Rows<1>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 2:
+            MlasHalfGemmKernelAvx2Rows<2>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 3:
+            MlasHalfGemmKernelAvx2Rows<3>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 4:
+            MlasHalfGemmKernelAvx2Rows<4>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 5:
+            MlasHalfGemmKernelAvx2Rows<5>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        default:
+            MlasHalfGemmKernelAvx2Rows<6>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+    }
+}
+
+
+const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx2 = {
+    MlasHalfGemmOperation<MLAS_HALF_GEMM_KERNEL_AVX2>,
+    nullptr,
+    MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX2>,
+    MLAS_HALF_GEMM_KERNEL_AVX2::PackedK,
+    MLAS_HALF_GEMM_KERNEL_AVX2::KernelMaxM,
+    0
+};
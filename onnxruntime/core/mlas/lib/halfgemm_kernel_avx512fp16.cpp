@@ -0,0 +1,349 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm_kernel_avx512fp16.cpp
+
+Abstract:
+
+    This module implements half precision GEMM kernel for AVX512_FP16.
+
+    The products are summed with fp16 instructions over short runs of K,
+    and these partial sums are accumulated in fp32.
+
+--*/
+
+#include <utility>
+
+#include "mlasi.h"
+#include "halfgemm.h"
+
+struct MLAS_HALF_GEMM_KERNEL_AVX512FP16 {
+    static constexpr bool PackNeeded = false;
+    static constexpr size_t KernelMaxM = 4;  // max # rows the vectorized kernel can process
+    static constexpr size_t PackedK = 1;
+
+    static constexpr MLAS_HALF_GEMM_STRIDES Strides{16, 128, 512};
+};
+
+namespace
+{
+
+template <typename IterationFn, size_t... Indices>
+MLAS_FORCEINLINE void
+UnrolledLoopIterations(IterationFn&& f, std::index_sequence<Indices...> /* indices */)
+{
+    (f(Indices), ...);
+}
+
+template <size_t N, typename IterationFn>
+MLAS_FORCEINLINE void
+UnrolledLoop(IterationFn&& f)
+{
+    UnrolledLoopIterations(std::forward<IterationFn>(f), std::make_index_sequence<N>());
+}
+
+MLAS_FORCEINLINE
+void
+CvtFloat2Half(
+    _mlas_fp16_* dest,
+    const float* src,
+    size_t len
+)
+{
+    while (len > 0) {
+        const size_t count = std::min(len, size_t(16));
+        const __mmask16 mask = __mmask16((1u << count) - 1);
+        const __m256i half = _mm512_cvtps_ph(_mm512_maskz_loadu_ps(mask, src), _MM_FROUND_TO_NEAREST_INT);
+        _mm256_mask_storeu_epi16(dest, mask, half);
+        src += count;
+        dest += count;
+        len -= count;
+    }
+}
+
+/**
+ * @brief Convert a 2D matrix from float to fp16
+*/
+MLAS_FORCEINLINE
+void
+CvtFloat2Half2D(
+    _mlas_fp16_* dest,
+    const float* src,
+    size_t stride,
+    size_t CntRow,
+    size_t CntCol
+    )
+{
+    if (stride == CntCol) {
+        CvtFloat2Half(dest, src, CntRow * CntCol);
+        return;
+    }
+    while (CntRow > 0) {
+        CvtFloat2Half(dest, src, CntCol);
+        src += stride;
+        dest += CntCol;
+        CntRow--;
+    }
+}
+
+MLAS_FORCEINLINE
+__m512h
+LoadHalf32(
+    const _mlas_fp16_* src,
+    __mmask32 mask
+    )
+{
+    return _mm512_castsi512_ph(_mm512_maskz_loadu_epi16(mask, src));
+}
+
+/**
+ * @brief Load up to 64 fp16 elements as four vectors of fp32, the elements
+ *        past CountN are zero.
+*/
+MLAS_FORCEINLINE
+void
+LoadHalf64AsFloat(
+    const _mlas_fp16_* src,
+    size_t CountN,
+    __m512 dest[4]
+    )
+{
+    for (size_t i = 0; i < 4; i++) {
+        const size_t count = (CountN > i * 16) ? std::min(CountN - i * 16, size_t(16)) : 0;
+        const __mmask16 mask = __mmask16((1u << count) - 1);
+        dest[i] = _mm512_cvtph_ps(_mm256_maskz_loadu_epi16(mask, src + i * 16));
+    }
+}
+
+MLAS_FORCEINLINE
+void
+StoreFloatAsHalf64(
+    _mlas_fp16_* dest,
+    size_t CountN,
+    const __m512 src[4]
+    )
+{
+    for (size_t i = 0; i < 4; i++) {
+        const size_t count = (CountN > i * 16) ? std::min(CountN - i * 16, size_t(16)) : 0;
+        const __mmask16 mask = __mmask16((1u << count) - 1);
+        _mm256_mask_storeu_epi16(dest + i * 16, mask, _mm512_cvtps_ph(src[i], _MM_FROUND_TO_NEAREST_INT));
+    }
+}
+
+MLAS_FORCEINLINE
+__m512
+LowHalfToFloat(
+    __m512h v
+    )
+{
+    return _mm512_cvtxph_ps(_mm512_castph512_ph256(v));
+}
+
+MLAS_FORCEINLINE
+__m512
+HighHalfToFloat(
+    __m512h v
+    )
+{
+    return _mm512_cvtxph_ps(_mm256_castsi256_ph(_mm512_extracti64x4_epi64(_mm512_castph_si512(v), 1)));
+}
+
+/*
+    This routine computes RowCount rows of C for up to 64 columns. The
+    products are summed with fp16 instructions over KChunk elements of K,
+    which keeps the rounding error of the fp16 partial sums small, and the
+    partial sums are then added to fp32 accumulators. The columns past
+    CountN are masked.
+*/
+template <size_t RowCount, bool TwoBlocks>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernelAvx512Fp16Block(
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    const bool ZeroMode
+    )
+{
+    constexpr size_t KChunk = 16;
+
+    const __mmask32 Mask0 = (CountN >= 32) ? __mmask32(~0u) : __mmask32((1u << CountN) - 1);
+    const __mmask32 Mask1 = !TwoBlocks ? __mmask32(0)
+                            : (CountN >= 64) ? __mmask32(~0u)
+                                             : __mmask32((1u << (CountN - 32)) - 1);
+
+    __m512 Accumulators[RowCount][4];
+
+    if (ZeroMode) {
+        __m512 bias[4] = {_mm512_setzero_ps(), _mm512_setzero_ps(), _mm512_setzero_ps(), _mm512_setzero_ps()};
+        if (Bias != nullptr) {
+            LoadHalf64AsFloat(Bias, CountN, bias);
+        }
+        UnrolledLoop<RowCount>([&](size_t r) {
+            UnrolledLoop<4>([&](size_t i) {
+                Accumulators[r][i] = bias[i];
+            });
+        });
+    } else {
+        UnrolledLoop<RowCount>([&](size_t r) {
+            LoadHalf64AsFloat(C + r * ldc, CountN, Accumulators[r]);
+        });
+    }
+
+    for (size_t k = 0; k < CountK; k += KChunk) {
+        const size_t kend = std::min(CountK, k + KChunk);
+
+        __m512h PartialSums[RowCount][2];
+        UnrolledLoop<RowCount>([&](size_t r) {
+            PartialSums[r][0] = _mm512_setzero_ph();
+            PartialSums[r][1] = _mm512_setzero_ph();
+        });
+
+        const _mlas_fp16_* b = B + k * ldb;
+
+        for (size_t kk = k; kk < kend; kk++) {
+            const __m512h b0 = LoadHalf32(b, Mask0);
+            const __m512h b1 = TwoBlocks ? LoadHalf32(b + 32, Mask1) : _mm512_setzero_ph();
+
+            UnrolledLoop<RowCount>([&](size_t r) {
+                const __m512h a = _mm512_castsi512_ph(_mm512_set1_epi16(short(A[r * lda + kk])));
+                PartialSums[r][0] = _mm512_fmadd_ph(a, b0, PartialSums[r][0]);
+                if constexpr (TwoBlocks) {
+                    PartialSums[r][1] = _mm512_fmadd_ph(a, b1, PartialSums[r][1]);
+                }
+            });
+
+            b += ldb;
+        }
+
+        UnrolledLoop<RowCount>([&](size_t r) {
+            Accumulators[r][0] = _mm512_add_ps(Accumulators[r][0], LowHalfToFloat(PartialSums[r][0]));
+            Accumulators[r][1] = _mm512_add_ps(Accumulators[r][1], HighHalfToFloat(PartialSums[r][0]));
+            if constexpr (TwoBlocks) {
+                Accumulators[r][2] = _mm512_add_ps(Accumulators[r][2], LowHalfToFloat(PartialSums[r][1]));
+                Accumulators[r][3] = _mm512_add_ps(Accumulators[r][3], HighHalfToFloat(PartialSums[r][1]));
+            }
+        });
+    }
+
+    UnrolledLoop<RowCount>([&](size_t r) {
+        StoreFloatAsHalf64(C + r * ldc, CountN, Accumulators[r]);
+    });
+}
+
+template <size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernelAvx512Fp16Rows(
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    const bool ZeroMode
+    )
+{
+    for (size_t n = 0; n < CountN; n += 64) {
+        const size_t CountCols = std::min(CountN - n, size_t(64));
+        const _mlas_fp16_* bias = (Bias == nullptr) ? nullptr : Bias + n;
+
+        if (CountCols > 32) {
+            MlasHalfGemmKernelAvx512Fp16Block<RowCount, true>(
+                CountCols, CountK, C + n, ldc, bias, A, lda, B + n, ldb, ZeroMode);
+        } else {
+            MlasHalfGemmKernelAvx512Fp16Block<RowCount, false>(
+                CountCols, CountK, C + n, ldc, bias, A, lda, B + n, ldb, ZeroMode);
+        }
+    }
+}
+
+}  // namespace
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackA<MLAS_HALF_GEMM_KERNEL_AVX512FP16>(
+    _mlas_fp16_* D,
+    const float* A,
+    size_t lda,
+    size_t CountM,
+    size_t CountK
+)
+{
+    CvtFloat2Half2D(D, A, lda, CountM, CountK);
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX512FP16>(
+    _mlas_fp16_* D,
+    const float* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK
+)
+{
+    CvtFloat2Half2D(D, B, ldb, CountK, CountN);
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernel<MLAS_HALF_GEMM_KERNEL_AVX512FP16>(
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    const bool ZeroMode)
+{
+    //
+    // Process up to KernelMaxM rows, the driver calls again for the rest.
+    //
+
+    switch (std::min(CountM, MLAS_HALF_GEMM_KERNEL_AVX512FP16::KernelMaxM)) {
+        case 1:
+            MlasHalfGemmKernelAvx512Fp16Rows<1>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 2:
+            MlasHalfGemmKernelAvx512Fp16Rows<2>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 3:
+            MlasHalfGemmKernelAvx512Fp16Rows<3>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        default:
+            MlasHalfGemmKernelAvx512Fp16Rows<4>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+    }
+}
+
+
+const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx512Fp16 = {
+    MlasHalfGemmOperation<MLAS_HALF_GEMM_KERNEL_AVX512FP16>,
+    nullptr,
+    MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX512FP16>,
+    MLAS_HALF_GEMM_KERNEL_AVX512FP16::PackedK,
+    MLAS_HALF_GEMM_KERNEL_AVX512FP16::KernelMaxM,
+    0
+};
@@ -0,0 +1,350 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    jitcode.h
+
+Abstract:
+
+    This module implements a minimal x86-64 instruction encoder used to emit
+    shape specialized kernels at runtime.
+
+    Only the general purpose and AVX/AVX512F instructions needed by the
+    generated kernels are supported. Memory operands always use a 32-bit
+    displacement, so the EVEX compressed displacement rules never apply.
+
+--*/
+
+#pragma once
+
+#include "mlasi.h"
+
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#endif
+
+enum MLAS_JIT_REG : uint8_t {
+    MlasJitRax = 0,
+    MlasJitRcx = 1,
+    MlasJitRdx = 2,
+    MlasJitRbx = 3,
+    MlasJitRsp = 4,
+    MlasJitRbp = 5,
+    MlasJitRsi = 6,
+    MlasJitRdi = 7,
+    MlasJitR8 = 8,
+    MlasJitR9 = 9,
+    MlasJitR10 = 10,
+    MlasJitR11 = 11,
+    MlasJitNoRegister = 0xFF,
+};
+
+enum MLAS_JIT_VECTOR_WIDTH {
+    MlasJitXmm,
+    MlasJitYmm,
+    MlasJitZmm,
+};
+
+struct MLAS_JIT_MEMORY_OPERAND {
+    uint8_t Base;
+    uint8_t Index;
+    uint8_t Scale;
+    int32_t Displacement;
+};
+
+MLAS_FORCEINLINE
+MLAS_JIT_MEMORY_OPERAND
+MlasJitPtr(
+    MLAS_JIT_REG Base,
+    int32_t Displacement = 0
+    )
+{
+    return {Base, MlasJitNoRegister, 1, Displacement};
+}
+
+MLAS_FORCEINLINE
+MLAS_JIT_MEMORY_OPERAND
+MlasJitPtr(
+    MLAS_JIT_REG Base,
+    MLAS_JIT_REG Index,
+    uint8_t Scale,
+    int32_t Displacement = 0
+    )
+{
+    return {Base, Index, Scale, Displacement};
+}
+
+class MLAS_JIT_CODE_GENERATOR
+{
+public:
+    explicit MLAS_JIT_CODE_GENERATOR(MLAS_JIT_VECTOR_WIDTH VectorWidth) : VectorWidth_(VectorWidth)
+    {
+        Code_.reserve(4096);
+    }
+
+    void SetVectorWidth(MLAS_JIT_VECTOR_WIDTH VectorWidth) { VectorWidth_ = VectorWidth; }
+
+    size_t Label() const { return Code_.size(); }
+
+    //
+    // General purpose instructions.
+    //
+
+    void Mov(MLAS_JIT_REG Reg, const MLAS_JIT_MEMORY_OPERAND& Mem)
+    {
+        EmitRex(true, Reg, Mem);
+        Emit8(0x8B);
+        EmitModRm(Reg, Mem);
+    }
+
+    void Mov(MLAS_JIT_REG Reg, MLAS_JIT_REG Rm)
+    {
+        Emit8(Rex(true, Reg >> 3, 0, Rm >> 3));
+        Emit8(0x8B);
+        EmitModRm(Reg, Rm);
+    }
+
+    void MovImm32(MLAS_JIT_REG Reg, uint32_t Value)
+    {
+        if (Reg >= 8) {
+            Emit8(Rex(false, 0, 0, 1));
+        }
+        Emit8(uint8_t(0xB8 + (Reg & 7)));
+        Emit32(Value);
+    }
+
+    void Lea(MLAS_JIT_REG Reg, const MLAS_JIT_MEMORY_OPERAND& Mem)
+    {
+        EmitRex(true, Reg, Mem);
+        Emit8(0x8D);
+        EmitModRm(Reg, Mem);
+    }
+
+    void AddImm32(MLAS_JIT_REG Reg, int32_t Value)
+    {
+        Emit8(Rex(true, 0, 0, Reg >> 3));
+        Emit8(0x81);
+        EmitModRm(0, Reg);
+        Emit32(uint32_t(Value));
+    }
+
+    void Dec(MLAS_JIT_REG Reg)
+    {
+        Emit8(Rex(true, 0, 0, Reg >> 3));
+        Emit8(0xFF);
+        EmitModRm(1, Reg);
+    }
+
+    void Jnz(size_t Target)
+    {
+        Emit8(0x0F);
+        Emit8(0x85);
+        Emit32(uint32_t(int32_t(ptrdiff_t(Target) - ptrdiff_t(Code_.size() + 4))));
+    }
+
+    void Ret() { Emit8(0xC3); }
+
+    void Vzeroupper()
+    {
+        Emit8(0xC5);
+        Emit8(0xF8);
+        Emit8(0x77);
+    }
+
+    //
+    // Vector instructions. The operand width is selected by SetVectorWidth:
+    // xmm and ymm forms use the VEX encoding, zmm forms use the EVEX encoding.
+    //
+
+    void VBroadcastSs(uint8_t Reg, const MLAS_JIT_MEMORY_OPERAND& Mem)
+    {
+        EmitVectorOp(Map0F38, Prefix66, 0x18, Reg, 0, Mem);
+    }
+
+    void VFmadd231Ps(uint8_t Reg, uint8_t Src1, const MLAS_JIT_MEMORY_OPERAND& Mem)
+    {
+        EmitVectorOp(Map0F38, Prefix66, 0xB8, Reg, Src1, Mem);
+    }
+
+    void VFmadd231Ps(uint8_t Reg, uint8_t Src1, uint8_t Src2)
+    {
+        EmitVectorOp(Map0F38, Prefix66, 0xB8, Reg, Src1, Src2);
+    }
+
+    void VAddPs(uint8_t Reg, uint8_t Src1, uint8_t Src2)
+    {
+        EmitVectorOp(Map0F, PrefixNone, 0x58, Reg, Src1, Src2);
+    }
+
+    void VAddPs(uint8_t Reg, uint8_t Src1, const MLAS_JIT_MEMORY_OPERAND& Mem)
+    {
+        EmitVectorOp(Map0F, PrefixNone, 0x58, Reg, Src1, Mem);
+    }
+
+    void VMulPs(uint8_t Reg, uint8_t Src1, uint8_t Src2)
+    {
+        EmitVectorOp(Map0F, PrefixNone, 0x59, Reg, Src1, Src2);
+    }
+
+    void VZero(uint8_t Reg)
+    {
+        //
+        // The EVEX form of vxorps requires AVX512DQ, so use vpxord instead.
+        //
+
+        if (VectorWidth_ == MlasJitZmm) {
+            EmitVectorOp(Map0F, Prefix66, 0xEF, Reg, Reg, Reg);
+        } else {
+            EmitVectorOp(Map0F, PrefixNone, 0x57, Reg, Reg, Reg);
+        }
+    }
+
+    void VMovUps(uint8_t Reg, const MLAS_JIT_MEMORY_OPERAND& Mem)
+    {
+        EmitVectorOp(Map0F, PrefixNone, 0x10, Reg, 0, Mem);
+    }
+
+    void VMovUps(const MLAS_JIT_MEMORY_OPERAND& Mem, uint8_t Reg)
+    {
+        EmitVectorOp(Map0F, PrefixNone, 0x11, Reg, 0, Mem);
+    }
+
+    //
+    // Copies the generated code to newly allocated executable memory. The
+    // memory is never released, so callers are expected to cache the result.
+    //
+
+    void* Commit() const
+    {
+        const size_t Size = Code_.size();
+
+#if defined(_WIN32)
+        void* Memory = VirtualAlloc(nullptr, Size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+        if (Memory == nullptr) {
+            return nullptr;
+        }
+        std::copy(Code_.begin(), Code_.end(), static_cast<uint8_t*>(Memory));
+        DWORD OldProtect;
+        if (!VirtualProtect(Memory, Size, PAGE_EXECUTE_READ, &OldProtect)) {
+            VirtualFree(Memory, 0, MEM_RELEASE);
+            return nullptr;
+        }
+        FlushInstructionCache(GetCurrentProcess(), Memory, Size);
+#else
+        void* Memory = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (Memory == MAP_FAILED) {
+            return nullptr;
+        }
+        std::copy(Code_.begin(), Code_.end(), static_cast<uint8_t*>(Memory));
+        if (mprotect(Memory, Size, PROT_READ | PROT_EXEC) != 0) {
+            munmap(Memory, Size);
+            return nullptr;
+        }
+#endif
+
+        return Memory;
+    }
+
+private:
+    enum : uint8_t {
+        Map0F = 1,
+        Map0F38 = 2,
+    };
+
+    enum : uint8_t {
+        PrefixNone = 0,
+        Prefix66 = 1,
+    };
+
+    void Emit8(uint8_t Value) { Code_.push_back(Value); }
+
+    void Emit32(uint32_t Value)
+    {
+        for (int i = 0; i < 4; i++) {
+            Code_.push_back(uint8_t(Value >> (i * 8)));
+        }
+    }
+
+    static uint8_t Rex(bool W, unsigned R, unsigned X, unsigned B)
+    {
+        return uint8_t(0x40 | (W ? 8 : 0) | ((R & 1) << 2) | ((X & 1) << 1) | (B & 1));
+    }
+
+    static unsigned IndexExtension(const MLAS_JIT_MEMORY_OPERAND& Mem)
+    {
+        return (Mem.Index == MlasJitNoRegister) ? 0 : (Mem.Index >> 3);
+    }
+
+    void EmitRex(bool W, unsigned Reg, const MLAS_JIT_MEMORY_OPERAND& Mem)
+    {
+        Emit8(Rex(W, Reg >> 3, IndexExtension(Mem), Mem.Base >> 3));
+    }
+
+    void EmitModRm(unsigned RegField, unsigned Rm)
+    {
+        Emit8(uint8_t(0xC0 | ((RegField & 7) << 3) | (Rm & 7)));
+    }
+
+    void EmitModRm(unsigned RegField, const MLAS_JIT_MEMORY_OPERAND& Mem)
+    {
+        //
+        // Always use the [base + index * scale + disp32] form. A base of
+        // rsp or r12 requires a SIB byte even without an index register.
+        //
+
+        const bool NeedSib = (Mem.Index != MlasJitNoRegister) || ((Mem.Base & 7) == 4);
+
+        Emit8(uint8_t(0x80 | ((RegField & 7) << 3) | (NeedSib ? 4 : (Mem.Base & 7))));
+
+        if (NeedSib) {
+            const unsigned ScaleBits = (Mem.Scale == 8) ? 3 : (Mem.Scale == 4) ? 2 : (Mem.Scale == 2) ? 1 : 0;
+            const unsigned IndexBits = (Mem.Index == MlasJitNoRegister) ? 4 : (Mem.Index & 7);
+            Emit8(uint8_t((ScaleBits << 6) | (IndexBits << 3) | (Mem.Base & 7)));
+        }
+
+        Emit32(uint32_t(Mem.Displacement));
+    }
+
+    void EmitPrefix(uint8_t Map, uint8_t Prefix, unsigned Reg, unsigned Vvvv, unsigned B, unsigned X)
+    {
+        if (VectorWidth_ == MlasJitZmm) {
+            Emit8(0x62);
+            Emit8(uint8_t((((~Reg >> 3) & 1) << 7) | ((~X & 1) << 6) | ((~B & 1) << 5) |
+                          (((~Reg >> 4) & 1) << 4) | Map));
+            Emit8(uint8_t(((~Vvvv & 0xF) << 3) | 0x04 | Prefix));
+            Emit8(uint8_t((2 << 5) | (((~Vvvv >> 4) & 1) << 3)));
+        } else {
+            Emit8(0xC4);
+            Emit8(uint8_t((((~Reg >> 3) & 1) << 7) | ((~X & 1) << 6) | ((~B & 1) << 5) | Map));
+            Emit8(uint8_t(((~Vvvv & 0xF) << 3) | ((VectorWidth_ == MlasJitYmm) ? 0x04 : 0) | Prefix));
+        }
+    }
+
+    void EmitVectorOp(uint8_t Map, uint8_t Prefix, uint8_t Opcode, unsigned Reg, unsigned Vvvv, unsigned Rm)
+    {
+        //
+        // For register operands, EVEX.X extends the r/m register to 32 entries.
+        //
+
+        EmitPrefix(Map, Prefix, Reg, Vvvv, Rm >> 3, (VectorWidth_ == MlasJitZmm) ? (Rm >> 4) : 0);
+        Emit8(Opcode);
+        EmitModRm(Reg, Rm);
+    }
+
+    void EmitVectorOp(uint8_t Map, uint8_t Prefix, uint8_t Opcode, unsigned Reg, unsigned Vvvv,
+                      const MLAS_JIT_MEMORY_OPERAND& Mem)
+    {
+        EmitPrefix(Map, Prefix, Reg, Vvvv, Mem.Base >> 3, IndexExtension(Mem));
+        Emit8(Opcode);
+        EmitModRm(Reg, Mem);
+    }
+
+    MLAS_JIT_VECTOR_WIDTH VectorWidth_;
+    std::vector<uint8_t> Code_;
+};
@@ -321,6 +321,12 @@ static_assert(sizeof(MLAS_FP16) == FP16_SIZE);
 #define MLAS_DGEMM_STRIDEN_THREAD_ALIGN             8
 #define MLAS_QGEMM_STRIDEN_THREAD_ALIGN             16
 
+#if defined(MLAS_SBGEMM_SUPPORTED) && defined(MLAS_TARGET_AMD64)
+// bfloat16 values are the upper 16 bits of the fp32 encoding, there is no
+// native type for them in the x64 intrinsic headers of all supported compilers.
+typedef uint16_t bfloat16_t;
+#endif
+
 //
 // Define the prototypes of the platform optimized routines.
 //
@@ -444,6 +450,49 @@ void
     float beta
     );
 
+//
+// Computes up to a kernel specific number of rows of a 16 column panel of a
+// block sparse matrix/matrix multiply. BlockRows holds the row of B of each of
+// the BlockCount nonzero blocks and BlockValues the 16 values of each block.
+// Returns the number of rows of C that were computed.
+//
+
+typedef
+size_t
+(MLASCALL MLAS_SPARSE_GEMM_KERNEL)(
+    const float* A,
+    size_t lda,
+    const uint32_t* BlockRows,
+    const float* BlockValues,
+    size_t BlockCount,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN
+    );
+
+//
+// Computes up to a kernel specific number of rows of C = alpha * A * B +
+// beta * C for small matrices, reading matrix B in place instead of from a
+// packed buffer. Returns the number of rows of C that were computed.
+//
+
+typedef
+size_t
+(MLASCALL MLAS_SGEMM_SMALL_KERNEL)(
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    float alpha,
+    float beta
+    );
+
 typedef
 void
 (MLASCALL MLAS_SGEMM_TRANSPOSE_PACKB_BLOCK_ROUTINE)(
@@ -584,6 +633,17 @@ void
     size_t N
     );
 
+typedef
+void
+(MLASCALL MLAS_COMPUTE_POW_FLOAT_KERNEL)(
+    const float* Base,
+    const float* Exponent,
+    float* Output,
+    size_t N,
+    bool ScalarBase,
+    bool ScalarExponent
+    );
+
 typedef
 float
 (MLASCALL MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL)(
@@ -756,6 +816,7 @@ extern "C" {
 #if defined(MLAS_TARGET_AMD64)
     MLAS_GEMM_FLOAT_KERNEL MlasGemmFloatKernelFma3;
     MLAS_GEMM_FLOAT_KERNEL MlasGemmFloatKernelAvx512F;
+    MLAS_GEMM_FLOAT_KERNEL MlasSgemmJitKernel;
     MLAS_GEMM_DOUBLE_KERNEL MlasGemmDoubleKernelSse;
     MLAS_GEMM_DOUBLE_KERNEL MlasGemmDoubleKernelAvx;
     MLAS_GEMM_DOUBLE_KERNEL MlasGemmDoubleKernelFma3;
@@ -810,6 +871,13 @@ extern "C" {
     MLAS_GEMV_FLOAT_KERNEL MlasGemvFloatKernel;
 #endif
 
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_SPARSE_GEMM_KERNEL MlasSparseGemmKernelAvx2;
+    MLAS_SPARSE_GEMM_KERNEL MlasSparseGemmKernelAvx512F;
+    MLAS_SGEMM_SMALL_KERNEL MlasSgemmSmallKernelAvx2;
+    MLAS_SGEMM_SMALL_KERNEL MlasSgemmSmallKernelAvx512F;
+#endif
+
 #if defined(MLAS_TARGET_AMD64)
     MLAS_SGEMM_TRANSPOSE_PACKB_BLOCK_ROUTINE MlasSgemmTransposePackB16x4Sse;
     MLAS_SGEMM_TRANSPOSE_PACKB_BLOCK_ROUTINE MlasSgemmTransposePackB16x4Avx;
@@ -871,6 +939,12 @@ extern "C" {
     MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasComputeExpF32Kernel;
     MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasLogisticKernel;
     MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasTanhKernel;
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasComputeLogF32Kernel;
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasComputeSinF32Kernel;
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasComputeCosF32Kernel;
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasComputeSqrtF32Kernel;
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasComputeReciprocalF32Kernel;
+    MLAS_COMPUTE_POW_FLOAT_KERNEL MlasComputePowF32Kernel;
     MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL MlasComputeSumExpF32Kernel;
     MLAS_COMPUTE_SOFTMAX_OUTPUT_FLOAT_KERNEL MlasComputeSoftmaxOutputF32Kernel;
     MLAS_COMPUTE_LOGSOFTMAX_OUTPUT_FLOAT_KERNEL MlasComputeLogSoftmaxOutputF32Kernel;
@@ -888,6 +962,18 @@ extern "C" {
     MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasComputeExpF32KernelAvx512F;
     MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasComputeLogisticF32KernelFma3;
     MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasComputeTanhF32KernelFma3;
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasComputeLogF32KernelAvx2;
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasComputeLogF32KernelAvx512F;
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasComputeSinF32KernelAvx2;
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasComputeSinF32KernelAvx512F;
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasComputeCosF32KernelAvx2;
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasComputeCosF32KernelAvx512F;
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasComputeSqrtF32KernelAvx2;
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasComputeSqrtF32KernelAvx512F;
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasComputeReciprocalF32KernelAvx2;
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasComputeReciprocalF32KernelAvx512F;
+    MLAS_COMPUTE_POW_FLOAT_KERNEL MlasComputePowF32KernelAvx2;
+    MLAS_COMPUTE_POW_FLOAT_KERNEL MlasComputePowF32KernelAvx512F;
     MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL MlasComputeSumExpF32KernelFma3;
     MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL MlasComputeSumExpF32KernelAvx512F;
     MLAS_COMPUTE_SOFTMAX_OUTPUT_FLOAT_KERNEL MlasComputeSoftmaxOutputF32KernelAvx;
@@ -945,13 +1031,16 @@ extern "C" {
 #define MLAS_DGEMM_THREAD_COMPLEXITY                (size_t(64) * size_t(1024))
 #define MLAS_QGEMM_THREAD_COMPLEXITY                65536
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
 #define MLAS_SBGEMM_THREAD_COMPLEXITY (size_t(64) * size_t(1024))
 #endif
 
 //
 // Single-threaded single precision matrix/matrix multiply operation.
 //
+// N.B. StartM and StartN supply the position of C in the output described by
+// the optional epilogue.
+//
 
 void
 MlasSgemmOperation(
@@ -967,7 +1056,11 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr,
+    size_t StartM = 0,
+    size_t StartN = 0,
+    bool UseJitKernels = false
     );
 
 //
@@ -1049,6 +1142,30 @@ extern const MLAS_QNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx512;
 
 extern const MLAS_QNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx512vnni;
 
+extern const MLAS_QNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx512vnniAmx;
+
+//
+// Float/bfloat16 matrix/matrix multiply dispatch structure.
+//
+
+struct MLAS_SBGEMM_DISPATCH;
+
+extern const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchNeon;
+
+extern const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAvx512Bf16;
+
+extern const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAmx;
+
+//
+// Half precision matrix/matrix multiply dispatch structure.
+//
+
+struct MLAS_HALFGEMM_DISPATCH;
+
+extern const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx2;
+
+extern const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx512Fp16;
+
 //
 // Quantized depthwise convolution kernels.
 //
@@ -1106,6 +1223,20 @@ struct MLAS_CONV_SYM_POST_PROCESS_PARAMS {
 
 enum MlasCoreType { mlas_core_unknown = 0, mlas_core_little = 2, mlas_core_big = 3 };
 
+#if defined(MLAS_TARGET_AMD64)
+
+//
+// Define the instruction sets supported by the runtime generated kernels.
+//
+
+enum MLAS_JIT_ISA {
+    MlasJitIsaNone = 0,
+    MlasJitIsaAvx2,
+    MlasJitIsaAvx512F,
+};
+
+#endif
+
 
 struct MLAS_PLATFORM {
 
@@ -1164,6 +1295,7 @@ struct MLAS_PLATFORM {
     MLAS_SGEMM_KERNEL_M1_ROUTINE* KernelM1Routine;
     MLAS_SGEMM_KERNEL_M1_ROUTINE* KernelM1TransposeBRoutine;
     MLAS_SGEMM_TRANSPOSE_PACKB_BLOCK_ROUTINE* TransposePackB16x4Routine;
+    MLAS_JIT_ISA JitIsa;
     MLAS_GEMM_DOUBLE_KERNEL* GemmDoubleKernel;
     MLAS_GEMM_U8S8_KERNEL* GemmU8S8Kernel;
     MLAS_GEMM_U8S8_KERNEL* GemmS8S8Kernel;
@@ -1181,6 +1313,12 @@ struct MLAS_PLATFORM {
     MLAS_COMPUTE_UNARY_FLOAT_KERNEL* ComputeExpF32Kernel;
     MLAS_COMPUTE_UNARY_FLOAT_KERNEL* LogisticKernelRoutine;
     MLAS_COMPUTE_UNARY_FLOAT_KERNEL* TanhKernelRoutine;
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL* ComputeLogF32Kernel;
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL* ComputeSinF32Kernel;
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL* ComputeCosF32Kernel;
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL* ComputeSqrtF32Kernel;
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL* ComputeReciprocalF32Kernel;
+    MLAS_COMPUTE_POW_FLOAT_KERNEL* ComputePowF32Kernel;
     MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL* ComputeSumExpF32Kernel;
     MLAS_COMPUTE_SOFTMAX_OUTPUT_FLOAT_KERNEL* ComputeSoftmaxOutputF32Kernel;
     MLAS_COMPUTE_LOGSOFTMAX_OUTPUT_FLOAT_KERNEL* ComputeLogSoftmaxOutputF32Kernel;
@@ -1206,6 +1344,14 @@ struct MLAS_PLATFORM {
 
     const MLAS_QNBIT_GEMM_DISPATCH* QNBitGemmDispatch{nullptr};
 
+    const MLAS_SBGEMM_DISPATCH* SBGemmDispatch{nullptr};
+
+    const MLAS_HALFGEMM_DISPATCH* HalfGemmDispatch{nullptr};
+
+    MLAS_SPARSE_GEMM_KERNEL* SparseGemmKernel{nullptr};
+
+    MLAS_SGEMM_SMALL_KERNEL* SgemmSmallKernel{nullptr};
+
     MLAS_CAST_F16_TO_F32_KERNEL* CastF16ToF32Kernel;
     MLAS_CAST_F32_TO_F16_KERNEL* CastF32ToF16Kernel;
 };
@@ -1287,6 +1433,21 @@ MlasGetMaximumThreadCount(
 #endif
 }
 
+inline
+MLAS_THREAD_PARTITION
+MlasGetThreadPartition(
+    const MLAS_THREADING_PARAMS* Threading,
+    size_t M,
+    size_t N
+    )
+{
+    if (Threading != nullptr && Threading->Partition != MlasThreadPartitionDefault) {
+        return Threading->Partition;
+    }
+
+    return (N > M) ? MlasThreadPartitionN : MlasThreadPartitionM;
+}
+
 inline
 void
 MlasPartitionWork(
@@ -2130,6 +2291,31 @@ MlasDivideFloat32x4(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
 #endif
 }
 
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasSqrtFloat32x4(MLAS_FLOAT32X4 Vector)
+{
+#if defined(MLAS_NEON64_INTRINSICS)
+    return vsqrtq_f32(Vector);
+#elif defined(MLAS_NEON32_INTRINSICS)
+    Vector = vsetq_lane_f32(std::sqrt(vgetq_lane_f32(Vector, 0)), Vector, 0);
+    Vector = vsetq_lane_f32(std::sqrt(vgetq_lane_f32(Vector, 1)), Vector, 1);
+    Vector = vsetq_lane_f32(std::sqrt(vgetq_lane_f32(Vector, 2)), Vector, 2);
+    Vector = vsetq_lane_f32(std::sqrt(vgetq_lane_f32(Vector, 3)), Vector, 3);
+    return Vector;
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_sqrt_ps(Vector);
+#elif defined(MLAS_VSX_INTRINSICS)
+    return vec_sqrt(Vector);
+#elif defined(MLAS_WASM_SIMD_INTRINSICS)
+    return wasm_f32x4_sqrt(Vector);
+#elif defined(MLAS_LSX_INTRINSICS)
+    return __lsx_vfsqrt_s(Vector);
+#else
+    return MLAS_FLOAT32X4{std::sqrt(Vector[0]), std::sqrt(Vector[1]), std::sqrt(Vector[2]), std::sqrt(Vector[3])};
+#endif
+}
+
 MLAS_FORCEINLINE
 MLAS_FLOAT32X4
 MlasGreaterThanFloat32x4(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
@@ -260,6 +260,7 @@ Return Value:
 #if defined(MLAS_TARGET_AMD64)
 
     this->TransposePackB16x4Routine = MlasSgemmTransposePackB16x4Sse;
+    this->JitIsa = MlasJitIsaNone;
     this->GemmDoubleKernel = MlasGemmDoubleKernelSse;
     this->ConvNchwFloatKernel = MlasConvNchwFloatKernelSse;
     this->ConvNchwcFloatKernel = MlasConvNchwcFloatKernelSse;
@@ -272,6 +273,12 @@ Return Value:
     this->LogisticKernelRoutine = MlasLogisticKernel;
     this->TanhKernelRoutine = MlasTanhKernel;
     this->ErfKernelRoutine = MlasErfKernel;
+    this->ComputeLogF32Kernel = MlasComputeLogF32Kernel;
+    this->ComputeSinF32Kernel = MlasComputeSinF32Kernel;
+    this->ComputeCosF32Kernel = MlasComputeCosF32Kernel;
+    this->ComputeSqrtF32Kernel = MlasComputeSqrtF32Kernel;
+    this->ComputeReciprocalF32Kernel = MlasComputeReciprocalF32Kernel;
+    this->ComputePowF32Kernel = MlasComputePowF32Kernel;
     this->ComputeSumExpF32Kernel = MlasComputeSumExpF32Kernel;
     this->ComputeSoftmaxOutputF32Kernel = MlasComputeSoftmaxOutputF32Kernel;
     this->ComputeLogSoftmaxOutputF32Kernel = MlasComputeLogSoftmaxOutputF32Kernel;
@@ -382,6 +389,7 @@ Return Value:
                 this->ConvSymU8S8Dispatch = &MlasConvSymDispatchAvx2;
 
                 this->GemmFloatKernel = MlasGemmFloatKernelFma3;
+                this->JitIsa = MlasJitIsaAvx2;
                 this->GemmDoubleKernel = MlasGemmDoubleKernelFma3;
                 this->ConvNchwFloatKernel = MlasConvNchwFloatKernelFma3;
                 this->ConvNchwcFloatKernel = MlasConvNchwcFloatKernelFma3;
@@ -391,6 +399,12 @@ Return Value:
                 this->LogisticKernelRoutine = MlasComputeLogisticF32KernelFma3;
                 this->TanhKernelRoutine = MlasComputeTanhF32KernelFma3;
                 this->ErfKernelRoutine = MlasErfKernelFma3;
+                this->ComputeLogF32Kernel = MlasComputeLogF32KernelAvx2;
+                this->ComputeSinF32Kernel = MlasComputeSinF32KernelAvx2;
+                this->ComputeCosF32Kernel = MlasComputeCosF32KernelAvx2;
+                this->ComputeSqrtF32Kernel = MlasComputeSqrtF32KernelAvx2;
+                this->ComputeReciprocalF32Kernel = MlasComputeReciprocalF32KernelAvx2;
+                this->ComputePowF32Kernel = MlasComputePowF32KernelAvx2;
                 this->QLinearAddS8Kernel = MlasQLinearAddS8KernelAvx2;
                 this->QLinearAddU8Kernel = MlasQLinearAddU8KernelAvx2;
                 this->ConvDepthwiseU8S8Kernel = MlasConvDepthwiseKernelAvx2<uint8_t, int8_t>;
@@ -401,6 +415,17 @@ Return Value:
                 this->QNBitGemmDispatch = &MlasSQNBitGemmDispatchAvx2;
                 this->CastF16ToF32Kernel = &MlasCastF16ToF32KernelAvx2;
                 this->CastF32ToF16Kernel = &MlasCastF32ToF16KernelAvx2;
+                this->SparseGemmKernel = MlasSparseGemmKernelAvx2;
+                this->SgemmSmallKernel = MlasSgemmSmallKernelAvx2;
+
+                //
+                // Check if the processor supports F16C features for the half
+                // precision GEMM kernel.
+                //
+
+                if ((Cpuid1[2] & 0x20000000) != 0) {
+                    this->HalfGemmDispatch = &MlasHalfGemmDispatchAvx2;
+                }
 
 
                 //
@@ -441,6 +466,9 @@ Return Value:
                 if (((Cpuid7[1] & 0x10000) != 0) && ((xcr0 & 0xE0) == 0xE0)) {
 
                     this->GemmFloatKernel = MlasGemmFloatKernelAvx512F;
+                    this->JitIsa = MlasJitIsaAvx512F;
+                    this->SparseGemmKernel = MlasSparseGemmKernelAvx512F;
+                    this->SgemmSmallKernel = MlasSgemmSmallKernelAvx512F;
                     this->GemmDoubleKernel = MlasGemmDoubleKernelAvx512F;
                     this->ConvNchwFloatKernel = MlasConvNchwFloatKernelAvx512F;
                     this->ConvNchwcFloatKernel = MlasConvNchwcFloatKernelAvx512F;
@@ -451,6 +479,12 @@ Return Value:
                     this->PoolFloatKernel[MlasAveragePoolingIncludePad] = MlasPoolAverageIncludePadFloatKernelAvx512F;
                     this->ComputeExpF32Kernel = MlasComputeExpF32KernelAvx512F;
                     this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelAvx512F;
+                    this->ComputeLogF32Kernel = MlasComputeLogF32KernelAvx512F;
+                    this->ComputeSinF32Kernel = MlasComputeSinF32KernelAvx512F;
+                    this->ComputeCosF32Kernel = MlasComputeCosF32KernelAvx512F;
+                    this->ComputeSqrtF32Kernel = MlasComputeSqrtF32KernelAvx512F;
+                    this->ComputeReciprocalF32Kernel = MlasComputeReciprocalF32KernelAvx512F;
+                    this->ComputePowF32Kernel = MlasComputePowF32KernelAvx512F;
                     this->ReduceMaximumF32Kernel = MlasReduceMaximumF32KernelAvx512F;
                     this->QuantizeLinearS8Kernel = MlasQuantizeLinearS8KernelAvx512F;
                     this->QuantizeLinearU8Kernel = MlasQuantizeLinearU8KernelAvx512F;
@@ -484,6 +518,26 @@ Return Value:
                             this->Q8Q4GemmDispatch = &MlasQ8Q4GemmDispatchAvx512vnni;
                             this->QNBitGemmDispatch = &MlasSQNBitGemmDispatchAvx512vnni;
                         }
+
+#if defined(MLAS_SBGEMM_SUPPORTED) && defined(MLAS_SBGEMM_AVX512BF16_SUPPORTED)
+                        //
+                        // Check if the processor supports AVX512_BF16.
+                        //
+
+                        if ((Cpuid7_1[0] & 0x20) != 0) {
+                            this->SBGemmDispatch = &MlasSBGemmDispatchAvx512Bf16;
+                        }
+#endif
+
+#if defined(MLAS_HALFGEMM_AVX512FP16_SUPPORTED)
+                        //
+                        // Check if the processor supports AVX512_FP16.
+                        //
+
+                        if ((Cpuid7[3] & (0b1 << 23)) != 0 && this->HalfGemmDispatch != nullptr) {
+                            this->HalfGemmDispatch = &MlasHalfGemmDispatchAvx512Fp16;
+                        }
+#endif
                     }
                 }
 
@@ -519,6 +573,21 @@ Return Value:
                     if (MlasInitAMX()) {
                         this->GemmU8U8Dispatch = &MlasGemmU8S8DispatchAmx;
                         this->GemmU8S8Dispatch = &MlasGemmU8S8DispatchAmx;
+
+#if defined(MLAS_SBGEMM_SUPPORTED) && defined(MLAS_SBGEMM_AVX512BF16_SUPPORTED)
+                        //
+                        // The AMX-BF16 kernel converts A with AVX512_BF16
+                        // instructions.
+                        //
+
+                        if ((Cpuid7[3] & 0b1 << 22) != 0 && this->SBGemmDispatch != nullptr) {
+                            this->SBGemmDispatch = &MlasSBGemmDispatchAmx;
+                        }
+#endif
+
+                        if (this->QNBitGemmDispatch == &MlasSQNBitGemmDispatchAvx512vnni) {
+                            this->QNBitGemmDispatch = &MlasSQNBitGemmDispatchAvx512vnniAmx;
+                        }
                     }
                 }
 #endif // __APPLE__
@@ -583,6 +652,13 @@ Return Value:
         this->GemmU8S8Dispatch = &MlasGemmU8X8DispatchUmmla;
         this->GemmS8S8Dispatch = &MlasGemmS8S8DispatchSmmla;
     }
+
+    //
+    // Check if the processor supports BF16 instructions.
+    //
+    if (MLAS_CPUIDINFO::GetCPUIDInfo().HasArmNeon_BF16()) {
+        this->SBGemmDispatch = &MlasSBGemmDispatchNeon;
+    }
 #endif
 
 #if defined(MLAS_F16VEC_INTRINSICS_SUPPORTED)
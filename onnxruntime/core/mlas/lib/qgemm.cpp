@@ -131,7 +131,8 @@ MlasGemmBatch(
     const MLAS_GEMM_QUANT_SHAPE_PARAMS& Shape,
     const MLAS_GEMM_QUANT_DATA_PARAMS* DataParams,
     const size_t BatchN,
-    MLAS_THREADPOOL* ThreadPool)
+    MLAS_THREADPOOL* ThreadPool,
+    const MLAS_THREADING_PARAMS* Threading)
 {
     const size_t M = Shape.M;
     const size_t N = Shape.N;
@@ -146,7 +147,9 @@ MlasGemmBatch(
 
     ptrdiff_t TargetThreadCount;
 
-    if (Complexity < double(MLAS_QGEMM_THREAD_COMPLEXITY * GetMlasPlatform().MaximumThreadCount)) {
+    if (Threading != nullptr && Threading->ThreadCount > 0) {
+        TargetThreadCount = Threading->ThreadCount;
+    } else if (Complexity < double(MLAS_QGEMM_THREAD_COMPLEXITY * GetMlasPlatform().MaximumThreadCount)) {
         TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_QGEMM_THREAD_COMPLEXITY)) + 1;
     } else {
         TargetThreadCount = GetMlasPlatform().MaximumThreadCount;
@@ -172,7 +175,7 @@ MlasGemmBatch(
 
     MLAS_GEMM_QUANT_WORK_BLOCK WorkBlock;
 
-    if (N > M) {
+    if (MlasGetThreadPartition(Threading, M, N) == MlasThreadPartitionN) {
 
         const size_t BlockedN = (N + MLAS_QGEMM_STRIDEN_THREAD_ALIGN - 1) /
             MLAS_QGEMM_STRIDEN_THREAD_ALIGN;
@@ -607,7 +607,12 @@ SQ4BitGemm_CompInt8(
         else if (GetMlasPlatform().QNBitGemmDispatch->SQ4BitGemmKernel_BlkSum_CompInt8 != nullptr)
         {
             const float* b_blk_sum = QuantBBlkSum + n * k_blks;
-            GetMlasPlatform().QNBitGemmDispatch->SQ4BitGemmKernel_BlkSum_CompInt8(
+            const auto* Dispatch = GetMlasPlatform().QNBitGemmDispatch;
+            auto* Kernel = (Dispatch->SQ4BitGemmTileKernel_BlkSum_CompInt8 != nullptr &&
+                            RangeCountM >= Dispatch->SQ4BitGemmTileKernelMinimumM)
+                               ? Dispatch->SQ4BitGemmTileKernel_BlkSum_CompInt8
+                               : Dispatch->SQ4BitGemmKernel_BlkSum_CompInt8;
+            Kernel(
                 BlkLen,
                 QuantA,
                 QuantAScale,
@@ -306,6 +306,14 @@ struct MLAS_QNBIT_GEMM_DISPATCH {
 
     SQ4BitGemmKernel_BlkSum_CompInt8_Fn* SQ4BitGemmKernel_BlkSum_CompInt8 = nullptr;
 
+    /**
+     * @brief Optional tile variant of SQ4BitGemmKernel_BlkSum_CompInt8. The kernel unpacks its columns of B on each
+     *        call, so it is only used when the call covers at least SQ4BitGemmTileKernelMinimumM rows of A.
+     */
+    SQ4BitGemmKernel_BlkSum_CompInt8_Fn* SQ4BitGemmTileKernel_BlkSum_CompInt8 = nullptr;
+
+    size_t SQ4BitGemmTileKernelMinimumM = 0;
+
     /**
      * @brief Multiply quantized 8-bit integer matrix A with quantized 4-bit integer matrix B.
      *        A and B are block quantized and B is column major.
@@ -30,8 +30,6 @@ Abstract:
         MLAS_SBGEMM_STRIDES Strides{128, 128, 256};
 --*/
 
-#if defined(__aarch64__) && defined(__linux__)
-
 #pragma once
 
 #include <cassert>
@@ -39,6 +37,8 @@ Abstract:
 
 #include "mlasi.h"
 
+#if defined(MLAS_SBGEMM_SUPPORTED)
+
 /**
  * @brief Define the default striding parameters for
  *        the bfloat16 precision gemm operation
@@ -71,9 +71,9 @@ MlasSBGemmConvertPackB(
  * @tparam KernelType
  * @param PackedB
  * @param DimN       Total columns of the packing buffer
- * @param DimK       Total rows of the packing buffer
+ * @param DimK       Rows of the K slice starting at StartK
  * @param StartN
- * @param StartK
+ * @param StartK     Start of a K slice, multiple of KernelType::Strides.K
  * @return  Address of PackedB[StartK, StartN]
  */
 template <typename KernelType>
@@ -134,7 +134,9 @@ MlasSBGemmPackedOperation(size_t M, size_t RangeStartN, size_t RangeCountN, size
             bool ZeroMode = (k == 0);
             CountK = std::min(K - k, PackedStrideK);
 
-            const bfloat16_t* pb = (const bfloat16_t*)PackedB + AlignedN * k + CountK * SliceStartN;
+            const bfloat16_t* pb = MlasSBGemmPackedBOffset<KernelType>(
+                (const bfloat16_t*)PackedB, AlignedN, CountK, SliceStartN, k
+            );
             float* c = C + n;
             const float* pbias = ((nullptr == Bias) ? nullptr : Bias + RangeStartN + n);
             MlasSBGemmKernel<KernelType>(M, CountN, CountK, A + k, lda, pb, c, ldc, ZeroMode ? pbias : nullptr, ZeroMode);
@@ -155,14 +157,15 @@ MlasSBGemmNonPackedOperation(size_t M, size_t N, size_t K, const float* A, size_
     //
     // Expand the N stride if K is small or expand the K stride if N is small
     // for better utilization of the B panel. Avoid changing the K stride if
-    // the A panel needs to be used for transposing.
+    // the A panel needs to be used for transposing. The K stride is kept at
+    // least PackedK, as the packed panel is padded to that many rows.
     //
     constexpr MLAS_SBGEMM_STRIDES Strides = KernelType::Strides;
     size_t StrideN = Strides.N;
     size_t StrideK = Strides.K;
 
     if (N >= K) {
-        while (StrideK / 2 >= K) {
+        while (StrideK / 2 >= K && StrideK / 2 >= KernelType::PackedK) {
             StrideN *= 2;
             StrideK /= 2;
         }
@@ -283,117 +286,36 @@ struct MLAS_SBGEMM_DISPATCH {
     size_t BufOverRead;
 };
 
-extern const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchNeon;
+#if defined(MLAS_TARGET_AMD64)
+/**
+ * @brief Convert fp32 matrix B to bf16 and pack it for the x64 bf16 dot
+ *        product instructions. The columns are packed in blocks of 16,
+ *        each holding the elements of consecutive row pairs interleaved.
+ *
+ * @param[out] D         Address of packing buffer
+ * @param[in]  B         Address of source matrix B in fp32
+ * @param[in]  ldb       Leading dimension of B
+ * @param[in]  CountN    # of column to pack
+ * @param[in]  CountK    # of rows to pack
+ * @param[in]  AlignedK  # of rows to pack, padded with zeros, multiple of 2
+ */
+void
+MlasSBGemmConvertCopyPackBAvx512Bf16(
+    bfloat16_t* D, const float* B, size_t ldb, size_t CountN, size_t CountK, size_t AlignedK
+);
+
+/**
+ * @brief Convert a fp32 row of matrix A to bf16, padded with zeros to AlignedK
+ */
+void
+MlasSBGemmConvertCopyARowAvx512Bf16(bfloat16_t* D, const float* A, size_t CountK, size_t AlignedK);
+#endif
 
 MLAS_FORCEINLINE
 const MLAS_SBGEMM_DISPATCH*
 MlasSBGemmGetDispatch()
 {
-#if defined(MLAS_TARGET_ARM64)
-    return &MlasSBGemmDispatchNeon;
-#else
-    std::cerr << "SBGemm Kernel is supported only on ARM64 platform.";
-    exit(1);
-#endif
-}
-
-size_t MLASCALL
-MlasSBGemmPackBSize(size_t N, size_t K)
-{
-    //
-    // Compute the number of bytes required to hold the packed buffer.
-    //
-    const auto* dispatch = MlasSBGemmGetDispatch();
-    if (dispatch == nullptr) return 0;
-
-    const auto padding = dispatch->BufOverRead;
-    const auto PackedK = dispatch->PackedK;
-    const auto PackedN = dispatch->PackedN;
-
-    const size_t AlignedK = (K + PackedK - 1) & ~(PackedK - 1);
-    const size_t AlignedN = (N + PackedN - 1) & ~(PackedN - 1);
-    const size_t BytesRequired = AlignedN * AlignedK * sizeof(bfloat16_t) + padding;
-    const size_t BufferAlignment = MlasGetPreferredBufferAlignment();
-    const size_t AlignedBytesRequired =
-        (BytesRequired + BufferAlignment - 1) & ~(BufferAlignment - 1);
-
-    return AlignedBytesRequired;
-}
-
-void MLASCALL
-MlasSBGemmConvertPackB(size_t N, size_t K, const float* B, size_t ldb, void* PackedB)
-{
-    const auto* dispatch = MlasSBGemmGetDispatch();
-    if (dispatch == nullptr) return;
-
-    dispatch->ConvertPackBRoutine((bfloat16_t*)PackedB, B, ldb, N, K);
+    return GetMlasPlatform().SBGemmDispatch;
 }
 
-void MLASCALL
-MlasSBGemmBatch(const size_t M, const size_t N, const size_t K, const size_t BatchN, const MLAS_SBGEMM_DATA_PARAMS* Data, MLAS_THREADPOOL* ThreadPool)
-{
-    const MLAS_SBGEMM_DISPATCH* dispatch = MlasSBGemmGetDispatch();
-    if (dispatch == nullptr) return;
-
-    MLAS_SBGEMM_OPERATION* operation = dispatch->Operation;
-
-    //
-    // Compute the number of target threads given the complexity of the SGEMM
-    // operation. Small requests should run using the single threaded path.
-    //
-
-    const double Complexity = double(M) * double(N) * double(K);
-
-    ptrdiff_t TargetThreadCount;
-
-    if (Complexity < double(MLAS_SBGEMM_THREAD_COMPLEXITY * GetMlasPlatform().MaximumThreadCount)) {
-        TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
-    } else {
-        TargetThreadCount = GetMlasPlatform().MaximumThreadCount;
-    }
-
-    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
-
-    if (TargetThreadCount >= MaximumThreadCount) {
-        TargetThreadCount = MaximumThreadCount;
-    }
-
-    //
-    // Segment the operation across multiple threads.
-    //
-    // N.B. Currently, the operation is segmented as a 1D partition, which
-    // works okay for operations involving skinny matrices.
-    //
-    ptrdiff_t ThreadsPerGemm = (TargetThreadCount + BatchN - 1) / BatchN;
-    ptrdiff_t ThreadCountM;
-    ptrdiff_t ThreadCountN;
-
-    if (N > M) {
-        const size_t BlockedN =
-            (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) / MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
-
-        if (size_t(ThreadsPerGemm) > BlockedN) {
-            ThreadsPerGemm = ptrdiff_t(BlockedN);
-        }
-
-        ThreadCountM = 1;
-        ThreadCountN = ThreadsPerGemm;
-
-    } else {
-        if (size_t(ThreadsPerGemm) > M) {
-            ThreadsPerGemm = ptrdiff_t(M);
-        }
-
-        ThreadCountM = ThreadsPerGemm;
-        ThreadCountN = 1;
-    }
-
-    MlasTrySimpleParallel(
-        ThreadPool, ThreadsPerGemm * static_cast<ptrdiff_t>(BatchN), [=](ptrdiff_t tid) {
-            ptrdiff_t GemmIdx = tid / ThreadsPerGemm;
-            ptrdiff_t ThreadIdx = tid % ThreadsPerGemm;
-            operation(ThreadCountM, ThreadCountN, M, N, K, &(Data[GemmIdx]), ThreadIdx);
-        }
-    );
-}
-#endif  // defined(__aarch64__) && defined(__linux__)
+#endif  // defined(MLAS_SBGEMM_SUPPORTED)
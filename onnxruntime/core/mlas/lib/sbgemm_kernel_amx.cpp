@@ -0,0 +1,247 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sbgemm_kernel_amx.cpp
+
+Abstract:
+
+    This module implements bfloat16 precision GEMM kernel for AMX-BF16.
+
+    Matrix B is packed like for the AVX512_BF16 kernel, with K padded to
+    the depth of a tile. The rows of matrix A are converted to bf16 with
+    AVX512_BF16 instructions.
+
+--*/
+
+#include <atomic>
+#include <cstring>
+
+#include "mlasi.h"
+#include "sbgemm.h"
+#include "amx_common.h"
+
+#if defined(MLAS_SBGEMM_SUPPORTED)
+
+#define TMM0 0
+#define TMM1 1
+#define TMM2 2
+#define TMM3 3
+#define TMM4 4
+
+#define TILE_M 16
+#define TILE_N 16
+#define TILE_K 32
+
+struct MLAS_SBGEMM_KERNEL_AMX {
+    static constexpr bool PackNeeded = true;
+    static constexpr size_t KernelMaxM = TILE_M;  // max # rows the tile kernel can process
+    static constexpr size_t PackedK = TILE_K;
+    static constexpr size_t PackedN = MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    static constexpr MLAS_SBGEMM_STRIDES Strides{128, 128, 256};  // M:N:K
+};
+
+template <>
+MLAS_FORCEINLINE const bfloat16_t*
+MlasSBGemmPackedBOffset<MLAS_SBGEMM_KERNEL_AMX>(
+    const bfloat16_t* PackedB, size_t DimN, size_t DimK, size_t StartN, size_t StartK
+)
+{
+    //
+    // Each K slice is packed as column blocks of DimK rows padded to PackedK.
+    //
+    constexpr size_t PackedK = MLAS_SBGEMM_KERNEL_AMX::PackedK;
+    const size_t AlignedK = (DimK + PackedK - 1) & ~(PackedK - 1);
+    return PackedB + StartK * DimN + AlignedK * StartN;
+}
+
+template <>
+void
+MlasSBGemmConvertPackB<MLAS_SBGEMM_KERNEL_AMX>(
+    bfloat16_t* PackedB, const float* B, size_t ldb, size_t CountN, size_t CountK
+)
+{
+    constexpr size_t PackedK = MLAS_SBGEMM_KERNEL_AMX::PackedK;
+    const size_t AlignedK = (CountK + PackedK - 1) & ~(PackedK - 1);
+
+    MlasSBGemmConvertCopyPackBAvx512Bf16(PackedB, B, ldb, CountN, CountK, AlignedK);
+}
+
+void
+MlasSBGemmConvertPackBAmx(
+    bfloat16_t* PackedB, const float* B, size_t ldb, size_t CountN, size_t CountK
+)
+{
+    constexpr size_t PackedK = MLAS_SBGEMM_KERNEL_AMX::PackedK;
+    constexpr size_t PackedN = MLAS_SBGEMM_KERNEL_AMX::PackedN;
+    constexpr MLAS_SBGEMM_STRIDES Strides = MLAS_SBGEMM_KERNEL_AMX::Strides;
+
+    const size_t AlignedN = (CountN + PackedN - 1) & ~(PackedN - 1);
+
+    //
+    // Step through each slice of matrix B along the K dimension, the packed
+    // operation steps through the same slices.
+    //
+    size_t K_block_size;
+
+    for (size_t k = 0; k < CountK; k += K_block_size) {
+        K_block_size = std::min(CountK - k, Strides.K);
+        const size_t AlignedK = (K_block_size + PackedK - 1) & ~(PackedK - 1);
+
+        MlasSBGemmConvertPackB<MLAS_SBGEMM_KERNEL_AMX>(PackedB, B + k * ldb, ldb, CountN, K_block_size);
+        PackedB += AlignedN * AlignedK;
+    }
+}
+
+static void
+MlasSBGemmAmxTileConfig()
+{
+    static thread_local struct tileconfig_t tc = {0};
+    struct tileconfig_t current_tc = {0};
+    tile_storeconfig(&current_tc);
+
+    //
+    // Every tile is configured to 16 rows of 64 bytes, like for the QGEMM
+    // kernel, so the configuration is shared between both.
+    //
+
+    if (tc.palette_id == 0 || std::memcmp(&current_tc, &tc, sizeof(tc)) != 0) {
+        tc.palette_id = 1;
+        for (int t = 0; t < 8; t++) {
+            tc.rows[t] = 16;
+            tc.colb[t] = 64;
+        }
+
+        tile_loadconfig(&tc);
+    }
+}
+
+/*
+    This routine loads an accumulator tile with up to 16 columns of the
+    rows of C, or with the bias when ZeroMode is set.
+*/
+MLAS_FORCEINLINE void
+MlasSBGemmAmxInitTile(
+    float* Tile, const float* C, size_t ldc, size_t CountM, size_t CountN, const float* Bias, bool ZeroMode
+)
+{
+    const __mmask16 Mask = __mmask16((1u << CountN) - 1);
+    const __m512 bias = (ZeroMode && Bias != nullptr) ? _mm512_maskz_loadu_ps(Mask, Bias) : _mm512_setzero_ps();
+
+    for (size_t r = 0; r < CountM; r++) {
+        _mm512_store_ps(Tile + r * TILE_N, ZeroMode ? bias : _mm512_maskz_loadu_ps(Mask, C + r * ldc));
+    }
+}
+
+MLAS_FORCEINLINE void
+MlasSBGemmAmxStoreTile(const float* Tile, float* C, size_t ldc, size_t CountM, size_t CountN)
+{
+    const __mmask16 Mask = __mmask16((1u << CountN) - 1);
+
+    for (size_t r = 0; r < CountM; r++) {
+        _mm512_mask_storeu_ps(C + r * ldc, Mask, _mm512_load_ps(Tile + r * TILE_N));
+    }
+}
+
+template <>
+MLAS_FORCEINLINE void
+MlasSBGemmKernel<MLAS_SBGEMM_KERNEL_AMX>(size_t CountM, size_t CountN, size_t CountK, const float* A, size_t lda, const bfloat16_t* B, float* C, size_t ldc, const float* Bias, const bool ZeroMode)
+{
+    constexpr size_t PackedK = MLAS_SBGEMM_KERNEL_AMX::PackedK;
+    constexpr MLAS_SBGEMM_STRIDES Strides = MLAS_SBGEMM_KERNEL_AMX::Strides;
+
+    //
+    // The K stride is expanded up to Strides.K * Strides.N / 16 when N is small.
+    //
+    constexpr size_t MaximumK = Strides.K * Strides.N / 16;
+    MLAS_DECLSPEC_ALIGN(static thread_local bfloat16_t PanelA[TILE_M * MaximumK], 64);
+    MLAS_DECLSPEC_ALIGN(float Tiles[2][TILE_M * TILE_N], 64);
+
+    const size_t AlignedK = (CountK + PackedK - 1) & ~(PackedK - 1);
+    assert(AlignedK <= MaximumK);
+
+    MlasSBGemmAmxTileConfig();
+
+    while (CountM > 0) {
+        const size_t RowsHandled = std::min(CountM, size_t(TILE_M));
+
+        //
+        // The rows of the A tile past RowsHandled only produce rows of the
+        // accumulator tiles that are not stored.
+        //
+
+        for (size_t r = 0; r < RowsHandled; r++) {
+            MlasSBGemmConvertCopyARowAvx512Bf16(PanelA + r * AlignedK, A + r * lda, CountK, AlignedK);
+        }
+
+        for (size_t n = 0; n < CountN; n += 2 * TILE_N) {
+            const size_t CountCols0 = std::min(CountN - n, size_t(TILE_N));
+            const size_t CountCols1 = (CountN - n > TILE_N) ? std::min(CountN - n - TILE_N, size_t(TILE_N)) : 0;
+            const bfloat16_t* b0 = B + n * AlignedK;
+            const bfloat16_t* b1 = b0 + TILE_N * AlignedK;
+            const float* bias = (Bias == nullptr) ? nullptr : Bias + n;
+
+            MlasSBGemmAmxInitTile(Tiles[0], C + n, ldc, RowsHandled, CountCols0, bias, ZeroMode);
+            if (CountCols1 > 0) {
+                MlasSBGemmAmxInitTile(Tiles[1], C + n + TILE_N, ldc, RowsHandled, CountCols1,
+                                      bias == nullptr ? nullptr : bias + TILE_N, ZeroMode);
+            }
+
+            //
+            // The tile instructions access memory through inline assembly
+            // that the compiler does not see.
+            //
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+
+            tile_loadd(TMM0, Tiles[0], TILE_N * sizeof(float));
+            if (CountCols1 > 0) {
+                tile_loadd(TMM1, Tiles[1], TILE_N * sizeof(float));
+            }
+
+            for (size_t k = 0; k < AlignedK; k += TILE_K) {
+                tile_loadd(TMM2, PanelA + k, AlignedK * sizeof(bfloat16_t));
+
+                //
+                // A tile of B holds TILE_K / 2 interleaved row pairs of 16 columns.
+                //
+                tile_loadd(TMM3, b0 + k * TILE_N, TILE_N * 2 * sizeof(bfloat16_t));
+                tile_dpbf16ps(TMM0, TMM2, TMM3);
+
+                if (CountCols1 > 0) {
+                    tile_loadd(TMM4, b1 + k * TILE_N, TILE_N * 2 * sizeof(bfloat16_t));
+                    tile_dpbf16ps(TMM1, TMM2, TMM4);
+                }
+            }
+
+            tile_stored(TMM0, Tiles[0], TILE_N * sizeof(float));
+            if (CountCols1 > 0) {
+                tile_stored(TMM1, Tiles[1], TILE_N * sizeof(float));
+            }
+
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+
+            MlasSBGemmAmxStoreTile(Tiles[0], C + n, ldc, RowsHandled, CountCols0);
+            if (CountCols1 > 0) {
+                MlasSBGemmAmxStoreTile(Tiles[1], C + n + TILE_N, ldc, RowsHandled, CountCols1);
+            }
+        }
+
+        C += ldc * RowsHandled;
+        A += lda * RowsHandled;
+        CountM -= RowsHandled;
+    }
+}
+
+const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAmx = {
+    MlasSBGemmOperation<MLAS_SBGEMM_KERNEL_AMX>,
+    MlasSBGemmConvertPackBAmx,
+    MLAS_SBGEMM_KERNEL_AMX::PackedK,
+    MLAS_SBGEMM_KERNEL_AMX::PackedN,
+    MLAS_SBGEMM_KERNEL_AMX::KernelMaxM,
+    0  // kernel reads within the padded packed buffer
+};
+#endif  // defined(MLAS_SBGEMM_SUPPORTED)
@@ -0,0 +1,320 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sbgemm_kernel_avx512bf16.cpp
+
+Abstract:
+
+    This module implements bfloat16 precision GEMM kernel for AVX512_BF16.
+
+--*/
+
+#include <utility>
+
+#include "mlasi.h"
+#include "sbgemm.h"
+
+#if defined(MLAS_SBGEMM_SUPPORTED)
+
+struct MLAS_SBGEMM_KERNEL_AVX512BF16 {
+    static constexpr bool PackNeeded = true;
+    static constexpr size_t KernelMaxM = 8;  // max # rows the vectorized kernel can process
+    static constexpr size_t PackedK = 2;
+    static constexpr size_t PackedN = MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    static constexpr MLAS_SBGEMM_STRIDES Strides{128, 128, 256};  // M:N:K
+};
+
+//
+// Interleaves the first and the second 16 words of a vector.
+//
+
+MLAS_DECLSPEC_ALIGN(static const uint16_t MlasSBGemmInterleaveIndex[32], 64) = {
+    0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23,
+    8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31,
+};
+
+void
+MlasSBGemmConvertCopyPackBAvx512Bf16(
+    bfloat16_t* D, const float* B, size_t ldb, size_t CountN, size_t CountK, size_t AlignedK
+)
+{
+    const __m512i InterleaveIndex = _mm512_load_si512(MlasSBGemmInterleaveIndex);
+
+    for (size_t n = 0; n < CountN; n += 16) {
+        const size_t CountCols = std::min(CountN - n, size_t(16));
+        const __mmask16 Mask = __mmask16((1u << CountCols) - 1);
+        const float* b = B + n;
+
+        for (size_t k = 0; k < AlignedK; k += 2) {
+            __m512 Row0 = _mm512_setzero_ps();
+            __m512 Row1 = _mm512_setzero_ps();
+
+            if (k < CountK) {
+                Row0 = _mm512_maskz_loadu_ps(Mask, b);
+            }
+            if (k + 1 < CountK) {
+                Row1 = _mm512_maskz_loadu_ps(Mask, b + ldb);
+            }
+
+            //
+            // The first 16 words hold row 0 and the last 16 words row 1.
+            //
+
+            __m512i Rows = (__m512i)_mm512_cvtne2ps_pbh(Row1, Row0);
+            _mm512_storeu_si512(D, _mm512_permutexvar_epi16(InterleaveIndex, Rows));
+
+            D += 32;
+            b += ldb * 2;
+        }
+    }
+}
+
+void
+MlasSBGemmConvertCopyARowAvx512Bf16(bfloat16_t* D, const float* A, size_t CountK, size_t AlignedK)
+{
+    size_t k = 0;
+
+    for (; k + 16 <= CountK; k += 16) {
+        _mm256_storeu_si256((__m256i*)(D + k), (__m256i)_mm512_cvtneps_pbh(_mm512_loadu_ps(A + k)));
+    }
+
+    for (; k < AlignedK; k += 16) {
+        const size_t CountRemaining = (k < CountK) ? CountK - k : 0;
+        const __mmask16 Mask = __mmask16((1u << CountRemaining) - 1);
+        const __m512 a = _mm512_maskz_loadu_ps(Mask, A + k);
+        const __mmask16 StoreMask = __mmask16((1u << std::min(AlignedK - k, size_t(16))) - 1);
+        _mm256_mask_storeu_epi16(D + k, StoreMask, (__m256i)_mm512_cvtneps_pbh(a));
+    }
+}
+
+template <>
+MLAS_FORCEINLINE const bfloat16_t*
+MlasSBGemmPackedBOffset<MLAS_SBGEMM_KERNEL_AVX512BF16>(
+    const bfloat16_t* PackedB, size_t DimN, size_t DimK, size_t StartN, size_t StartK
+)
+{
+    //
+    // Each K slice is packed as column blocks of DimK rows padded to PackedK.
+    //
+    constexpr size_t PackedK = MLAS_SBGEMM_KERNEL_AVX512BF16::PackedK;
+    const size_t AlignedK = (DimK + PackedK - 1) & ~(PackedK - 1);
+    return PackedB + StartK * DimN + AlignedK * StartN;
+}
+
+template <>
+void
+MlasSBGemmConvertPackB<MLAS_SBGEMM_KERNEL_AVX512BF16>(
+    bfloat16_t* PackedB, const float* B, size_t ldb, size_t CountN, size_t CountK
+)
+{
+    constexpr size_t PackedK = MLAS_SBGEMM_KERNEL_AVX512BF16::PackedK;
+    const size_t AlignedK = (CountK + PackedK - 1) & ~(PackedK - 1);
+
+    MlasSBGemmConvertCopyPackBAvx512Bf16(PackedB, B, ldb, CountN, CountK, AlignedK);
+}
+
+void
+MlasSBGemmConvertPackBAvx512Bf16(
+    bfloat16_t* PackedB, const float* B, size_t ldb, size_t CountN, size_t CountK
+)
+{
+    constexpr size_t PackedK = MLAS_SBGEMM_KERNEL_AVX512BF16::PackedK;
+    constexpr size_t PackedN = MLAS_SBGEMM_KERNEL_AVX512BF16::PackedN;
+    constexpr MLAS_SBGEMM_STRIDES Strides = MLAS_SBGEMM_KERNEL_AVX512BF16::Strides;
+
+    const size_t AlignedN = (CountN + PackedN - 1) & ~(PackedN - 1);
+
+    //
+    // Step through each slice of matrix B along the K dimension, the packed
+    // operation steps through the same slices.
+    //
+    size_t K_block_size;
+
+    for (size_t k = 0; k < CountK; k += K_block_size) {
+        K_block_size = std::min(CountK - k, Strides.K);
+        const size_t AlignedK = (K_block_size + PackedK - 1) & ~(PackedK - 1);
+
+        MlasSBGemmConvertPackB<MLAS_SBGEMM_KERNEL_AVX512BF16>(PackedB, B + k * ldb, ldb, CountN, K_block_size);
+        PackedB += AlignedN * AlignedK;
+    }
+}
+
+namespace
+{
+
+template <typename IterationFn, size_t... Indices>
+MLAS_FORCEINLINE void
+UnrolledLoopIterations(IterationFn&& f, std::index_sequence<Indices...> /* indices */)
+{
+    (f(Indices), ...);
+}
+
+template <size_t N, typename IterationFn>
+MLAS_FORCEINLINE void
+UnrolledLoop(IterationFn&& f)
+{
+    UnrolledLoopIterations(std::forward<IterationFn>(f), std::make_index_sequence<N>());
+}
+
+}  // namespace
+
+/*
+    This routine computes RowCount rows of C for 16 or 32 columns, using
+    the bf16 dot product of pairs along K. A points to the rows of matrix A
+    converted to bf16, B to the first packed column block. The columns past
+    CountN are masked.
+*/
+template <size_t RowCount, bool TwoBlocks>
+MLAS_FORCEINLINE void
+MlasSBGemmKernelAvx512Bf16Block(
+    const bfloat16_t* A,
+    const bfloat16_t* B,
+    size_t AlignedK,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    const float* Bias,
+    bool ZeroMode
+)
+{
+    const __mmask16 Mask0 = __mmask16((1u << std::min(CountN, size_t(16))) - 1);
+    const __mmask16 Mask1 = TwoBlocks ? __mmask16((1u << (CountN - 16)) - 1) : 0;
+    const bfloat16_t* B1 = B + 16 * AlignedK;
+
+    __m512 Accumulators[RowCount][2];
+
+    UnrolledLoop<RowCount>([&](size_t r) {
+        if (ZeroMode) {
+            Accumulators[r][0] = (Bias != nullptr) ? _mm512_maskz_loadu_ps(Mask0, Bias) : _mm512_setzero_ps();
+            Accumulators[r][1] = (Bias != nullptr) ? _mm512_maskz_loadu_ps(Mask1, Bias + 16) : _mm512_setzero_ps();
+        } else {
+            Accumulators[r][0] = _mm512_maskz_loadu_ps(Mask0, C + r * ldc);
+            Accumulators[r][1] = _mm512_maskz_loadu_ps(Mask1, C + r * ldc + 16);
+        }
+    });
+
+    //
+    // Each element pair of a row of A is broadcast as a 32-bit value.
+    //
+    const int32_t* a = reinterpret_cast<const int32_t*>(A);
+    const size_t StrideA = AlignedK / 2;
+
+    for (size_t p = 0; p < StrideA; p++) {
+        const __m512bh b0 = (__m512bh)_mm512_loadu_si512(B + p * 32);
+        const __m512bh b1 = TwoBlocks ? (__m512bh)_mm512_loadu_si512(B1 + p * 32) : b0;
+
+        UnrolledLoop<RowCount>([&](size_t r) {
+            const __m512bh ab = (__m512bh)_mm512_set1_epi32(a[r * StrideA + p]);
+            Accumulators[r][0] = _mm512_dpbf16_ps(Accumulators[r][0], ab, b0);
+            if (TwoBlocks) {
+                Accumulators[r][1] = _mm512_dpbf16_ps(Accumulators[r][1], ab, b1);
+            }
+        });
+    }
+
+    UnrolledLoop<RowCount>([&](size_t r) {
+        _mm512_mask_storeu_ps(C + r * ldc, Mask0, Accumulators[r][0]);
+        if (TwoBlocks) {
+            _mm512_mask_storeu_ps(C + r * ldc + 16, Mask1, Accumulators[r][1]);
+        }
+    });
+}
+
+template <size_t RowCount>
+MLAS_FORCEINLINE void
+MlasSBGemmKernelAvx512Bf16Rows(
+    const bfloat16_t* A,
+    const bfloat16_t* B,
+    size_t AlignedK,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    const float* Bias,
+    bool ZeroMode
+)
+{
+    for (size_t n = 0; n < CountN; n += 32) {
+        const size_t CountCols = std::min(CountN - n, size_t(32));
+        const bfloat16_t* b = B + n * AlignedK;
+        const float* bias = (Bias == nullptr) ? nullptr : Bias + n;
+
+        if (CountCols > 16) {
+            MlasSBGemmKernelAvx512Bf16Block<RowCount, true>(A, b, AlignedK, C + n, ldc, CountCols, bias, ZeroMode);
+        } else {
+            MlasSBGemmKernelAvx512Bf16Block<RowCount, false>(A, b, AlignedK, C + n, ldc, CountCols, bias, ZeroMode);
+        }
+    }
+}
+
+template <>
+MLAS_FORCEINLINE void
+MlasSBGemmKernel<MLAS_SBGEMM_KERNEL_AVX512BF16>(size_t CountM, size_t CountN, size_t CountK, const float* A, size_t lda, const bfloat16_t* B, float* C, size_t ldc, const float* Bias, const bool ZeroMode)
+{
+    constexpr size_t KernelMaxM = MLAS_SBGEMM_KERNEL_AVX512BF16::KernelMaxM;
+    constexpr size_t PackedK = MLAS_SBGEMM_KERNEL_AVX512BF16::PackedK;
+    constexpr MLAS_SBGEMM_STRIDES Strides = MLAS_SBGEMM_KERNEL_AVX512BF16::Strides;
+
+    //
+    // The K stride is expanded up to Strides.K * Strides.N / 16 when N is small.
+    //
+    constexpr size_t MaximumK = Strides.K * Strides.N / 16;
+    MLAS_DECLSPEC_ALIGN(static thread_local bfloat16_t PanelA[KernelMaxM * MaximumK], 64);
+
+    const size_t AlignedK = (CountK + PackedK - 1) & ~(PackedK - 1);
+    assert(AlignedK <= MaximumK);
+
+    while (CountM > 0) {
+        //
+        // Process 8 rows at a time, then the remaining rows 4, 2 and 1 at a time.
+        //
+        size_t RowsHandled;
+
+        if (CountM >= 8) {
+            RowsHandled = 8;
+        } else if (CountM >= 4) {
+            RowsHandled = 4;
+        } else if (CountM >= 2) {
+            RowsHandled = 2;
+        } else {
+            RowsHandled = 1;
+        }
+
+        for (size_t r = 0; r < RowsHandled; r++) {
+            MlasSBGemmConvertCopyARowAvx512Bf16(PanelA + r * AlignedK, A + r * lda, CountK, AlignedK);
+        }
+
+        switch (RowsHandled) {
+            case 8:
+                MlasSBGemmKernelAvx512Bf16Rows<8>(PanelA, B, AlignedK, C, ldc, CountN, Bias, ZeroMode);
+                break;
+            case 4:
+                MlasSBGemmKernelAvx512Bf16Rows<4>(PanelA, B, AlignedK, C, ldc, CountN, Bias, ZeroMode);
+                break;
+            case 2:
+                MlasSBGemmKernelAvx512Bf16Rows<2>(PanelA, B, AlignedK, C, ldc, CountN, Bias, ZeroMode);
+                break;
+            default:
+                MlasSBGemmKernelAvx512Bf16Rows<1>(PanelA, B, AlignedK, C, ldc, CountN, Bias, ZeroMode);
+                break;
+        }
+
+        C += ldc * RowsHandled;
+        A += lda * RowsHandled;
+        CountM -= RowsHandled;
+    }
+}
+
+const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAvx512Bf16 = {
+    MlasSBGemmOperation<MLAS_SBGEMM_KERNEL_AVX512BF16>,
+    MlasSBGemmConvertPackBAvx512Bf16,
+    MLAS_SBGEMM_KERNEL_AVX512BF16::PackedK,
+    MLAS_SBGEMM_KERNEL_AVX512BF16::PackedN,
+    MLAS_SBGEMM_KERNEL_AVX512BF16::KernelMaxM,
+    0  // kernel reads within the padded packed buffer
+};
+#endif  // defined(MLAS_SBGEMM_SUPPORTED)
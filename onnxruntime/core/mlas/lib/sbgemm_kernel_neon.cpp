@@ -29,16 +29,6 @@ struct MLAS_SBGEMM_KERNEL_NEON {
     static constexpr MLAS_SBGEMM_STRIDES Strides{128, 128, 256};  // M:N:K
 };
 
-bool MLASCALL
-MlasBf16AccelerationSupported()
-{
-#if defined(MLAS_TARGET_ARM64)
-    return MLAS_CPUIDINFO::GetCPUIDInfo().HasArmNeon_BF16();
-#else
-    return false;
-#endif
-}
-
 /*
     This routine converts fp32 to bf16 and copies elements from the source
      matrix to the destination packed buffer.
@@ -334,6 +324,18 @@ MlasSBGemmConvertPackB(
     }
 }
 
+template <>
+MLAS_FORCEINLINE const bfloat16_t*
+MlasSBGemmPackedBOffset<MLAS_SBGEMM_KERNEL_NEON>(
+    const bfloat16_t* PackedB, size_t DimN, size_t DimK, size_t StartN, size_t StartK
+)
+{
+    //
+    // Each K slice is packed as column blocks of DimK rows.
+    //
+    return PackedB + StartK * DimN + DimK * StartN;
+}
+
 template <>
 MLAS_FORCEINLINE void
 MlasSBGemmKernel<MLAS_SBGEMM_KERNEL_NEON>(size_t CountM, size_t CountN, size_t CountK, const float* A, size_t lda, const bfloat16_t* B, float* C, size_t ldc, const float* Bias, const bool ZeroMode)
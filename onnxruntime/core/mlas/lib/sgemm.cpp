@@ -1003,6 +1003,113 @@ Return Value:
 
 #endif
 
+void
+MlasSgemmApplyEpilogue(
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    float* C,
+    size_t ldc,
+    size_t StartM,
+    size_t StartN,
+    size_t CountM,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the epilogue operations to a tile of the output
+    matrix that has been completely accumulated.
+
+Arguments:
+
+    Epilogue - Supplies the epilogue operations.
+
+    C - Supplies the address of the tile of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    StartM - Supplies the first row of the tile in the output described by
+        the epilogue.
+
+    StartN - Supplies the first column of the tile in the output described by
+        the epilogue.
+
+    CountM - Supplies the number of rows of the tile.
+
+    CountN - Supplies the number of columns of the tile.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float* Bias = Epilogue->Bias;
+    const float* Residual = Epilogue->Residual;
+
+    if (Bias != nullptr || Residual != nullptr) {
+
+        if (Bias != nullptr) {
+            Bias += StartN;
+        }
+
+        if (Residual != nullptr) {
+            Residual += StartM * Epilogue->ldr + StartN;
+        }
+
+        float* c = C;
+
+        for (size_t m = 0; m < CountM; m++) {
+
+            size_t n = 0;
+
+            while (n + 4 <= CountN) {
+
+                MLAS_FLOAT32X4 Value = MlasLoadFloat32x4(c + n);
+
+                if (Bias != nullptr) {
+                    Value = MlasAddFloat32x4(Value, MlasLoadFloat32x4(Bias + n));
+                }
+
+                if (Residual != nullptr) {
+                    Value = MlasAddFloat32x4(Value, MlasLoadFloat32x4(Residual + n));
+                }
+
+                MlasStoreFloat32x4(c + n, Value);
+                n += 4;
+            }
+
+            while (n < CountN) {
+
+                float Value = c[n];
+
+                if (Bias != nullptr) {
+                    Value += Bias[n];
+                }
+
+                if (Residual != nullptr) {
+                    Value += Residual[n];
+                }
+
+                c[n] = Value;
+                n += 1;
+            }
+
+            c += ldc;
+
+            if (Residual != nullptr) {
+                Residual += Epilogue->ldr;
+            }
+        }
+    }
+
+    const MLAS_ACTIVATION* Activation = Epilogue->Activation;
+
+    if (Activation != nullptr && Activation->ActivationKind != MlasIdentityActivation) {
+        MlasActivation(Activation, C, nullptr, CountM, CountN, ldc);
+    }
+}
+
 MLAS_FORCEINLINE
 float*
 MlasSgemmKernelLoop(
@@ -1015,7 +1122,11 @@ MlasSgemmKernelLoop(
     size_t lda,
     size_t ldc,
     float alpha,
-    bool ZeroMode
+    bool ZeroMode,
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    size_t StartM,
+    size_t StartN,
+    bool UseJitKernels
     )
 /*++
 
@@ -1051,18 +1162,43 @@ Arguments:
     ZeroMode - Supplies true if the output matrix must be zero initialized,
         else false if the output matrix is accumulated into.
 
+    Epilogue - Optionally supplies the epilogue operations, which are applied
+        to the rows produced by each call of the kernel. Only supplied for the
+        last slice of the K dimension.
+
+    StartM - Supplies the first row of matrix C in the output described by
+        the epilogue.
+
+    StartN - Supplies the first column of matrix C in the output described by
+        the epilogue.
+
+    UseJitKernels - Supplies true if kernels specialized for the shape may be
+        generated at runtime.
+
 Return Value:
 
     Returns the next address of matrix C.
 
 --*/
 {
+#if (defined(MLAS_TARGET_AMD64_IX86) || defined(MLAS_TARGET_POWER) || defined(MLAS_TARGET_LARCH64)) && !defined(FORCE_GENERIC_ALGORITHMS)
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_GEMM_FLOAT_KERNEL* GemmFloatKernel =
+        UseJitKernels ? MlasSgemmJitKernel : GetMlasPlatform().GemmFloatKernel;
+#else
+    MLAS_UNREFERENCED_PARAMETER(UseJitKernels);
+    MLAS_GEMM_FLOAT_KERNEL* GemmFloatKernel = GetMlasPlatform().GemmFloatKernel;
+#endif
+#else
+    MLAS_UNREFERENCED_PARAMETER(UseJitKernels);
+#endif
+
     while (CountM > 0) {
 
         size_t RowsHandled;
 
 #if (defined(MLAS_TARGET_AMD64_IX86) || defined(MLAS_TARGET_POWER) || defined(MLAS_TARGET_LARCH64)) && !defined(FORCE_GENERIC_ALGORITHMS)
-        RowsHandled = GetMlasPlatform().GemmFloatKernel(A, B, C, CountK, CountM, CountN, lda, ldc, alpha, ZeroMode);
+        RowsHandled = GemmFloatKernel(A, B, C, CountK, CountM, CountN, lda, ldc, alpha, ZeroMode);
 #else
         if (ZeroMode) {
             RowsHandled = MlasSgemmKernelZero(A, B, C, CountK, CountM, CountN, lda, ldc, alpha);
@@ -1071,6 +1207,11 @@ Return Value:
         }
 #endif
 
+        if (Epilogue != nullptr) {
+            MlasSgemmApplyEpilogue(Epilogue, C, ldc, StartM, StartN, RowsHandled, CountN);
+            StartM += RowsHandled;
+        }
+
         C += ldc * RowsHandled;
         A += lda * RowsHandled;
         CountM -= RowsHandled;
@@ -1093,7 +1234,11 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    size_t StartM,
+    size_t StartN,
+    bool UseJitKernels
     )
 /*++
 
@@ -1131,6 +1276,17 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    Epilogue - Optionally supplies the operations applied to the output.
+
+    StartM - Supplies the first row of matrix C in the output described by
+        the epilogue.
+
+    StartN - Supplies the first column of matrix C in the output described by
+        the epilogue.
+
+    UseJitKernels - Supplies true if kernels specialized for the shape may be
+        generated at runtime.
+
 Return Value:
 
     None.
@@ -1147,6 +1303,9 @@ Return Value:
 
     if (K == 0) {
         MlasSgemmMultiplyBeta(C, M, N, ldc, beta);
+        if (Epilogue != nullptr) {
+            MlasSgemmApplyEpilogue(Epilogue, C, ldc, StartM, StartN, M, N);
+        }
         return;
     }
 
@@ -1171,6 +1330,9 @@ Return Value:
 
         if (SgemmKernelM1Routine != nullptr) {
             SgemmKernelM1Routine(A, B, C, K, N, ldb, beta);
+            if (Epilogue != nullptr) {
+                MlasSgemmApplyEpilogue(Epilogue, C, ldc, StartM, StartN, M, N);
+            }
             return;
         }
 
@@ -1178,6 +1340,9 @@ Return Value:
 
         if (TransB == CblasNoTrans) {
             MlasGemvFloatKernel(A, B, C, K, N, ldb, (beta == 0.0f));
+            if (Epilogue != nullptr) {
+                MlasSgemmApplyEpilogue(Epilogue, C, ldc, StartM, StartN, M, N);
+            }
             return;
         }
 
@@ -1207,6 +1372,9 @@ Return Value:
 
         if (SgemmKernelM1Routine != nullptr) {
             SgemmKernelM1Routine(B, A, C, K, M, lda, beta);
+            if (Epilogue != nullptr) {
+                MlasSgemmApplyEpilogue(Epilogue, C, ldc, StartM, StartN, M, N);
+            }
             return;
         }
 
@@ -1269,6 +1437,13 @@ Return Value:
 
             CountK = std::min(K - k, StrideK);
 
+            //
+            // Finish the output tiles with the epilogue operations while
+            // accumulating the last slice of the K dimension.
+            //
+
+            const MLAS_SGEMM_EPILOGUE* SliceEpilogue = (k + CountK == K) ? Epilogue : nullptr;
+
             //
             // Copy or transpose a panel of matrix B to a local packed buffer.
             //
@@ -1287,12 +1462,14 @@ Return Value:
 
             if (TransA == CblasNoTrans) {
 
-                MlasSgemmKernelLoop(A + k, PanelB, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode);
+                MlasSgemmKernelLoop(A + k, PanelB, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode,
+                    SliceEpilogue, StartM, StartN + n, UseJitKernels);
 
             } else {
 
                 const float* a = A + k * lda;
                 size_t RowsRemaining = M;
+                size_t SliceStartM = StartM;
 
                 while (RowsRemaining > 0) {
 
@@ -1311,7 +1488,10 @@ Return Value:
                     // Step through the rows of the local buffer.
                     //
 
-                    c = MlasSgemmKernelLoop(PanelA, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+                    c = MlasSgemmKernelLoop(PanelA, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode,
+                        SliceEpilogue, SliceStartM, StartN + n, UseJitKernels);
+
+                    SliceStartM += RowsTransposed;
                 }
             }
 
@@ -1334,7 +1514,10 @@ MlasSgemmPackedOperation(
     size_t AlignedN,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    size_t StartM,
+    bool UseJitKernels
     )
 /*++
 
@@ -1374,6 +1557,14 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    Epilogue - Optionally supplies the operations applied to the output.
+
+    StartM - Supplies the first row of matrix C in the output described by
+        the epilogue. RangeStartN supplies the first column.
+
+    UseJitKernels - Supplies true if kernels specialized for the shape may be
+        generated at runtime.
+
 Return Value:
 
     None.
@@ -1382,6 +1573,19 @@ Return Value:
 {
     float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_PACKED_STRIDEK];
 
+    //
+    // Handle the special case of K equals zero. Apply the beta multiplier to
+    // the output matrix and exit.
+    //
+
+    if (K == 0) {
+        MlasSgemmMultiplyBeta(C, M, RangeCountN, ldc, beta);
+        if (Epilogue != nullptr) {
+            MlasSgemmApplyEpilogue(Epilogue, C, ldc, StartM, RangeStartN, M, RangeCountN);
+        }
+        return;
+    }
+
     //
     // Step through each slice of matrix B along the N dimension.
     //
@@ -1413,6 +1617,8 @@ Return Value:
 
             CountK = std::min(K - k, size_t(MLAS_SGEMM_PACKED_STRIDEK));
 
+            const MLAS_SGEMM_EPILOGUE* SliceEpilogue = (k + CountK == K) ? Epilogue : nullptr;
+
             //
             // Step through each slice of matrix A along the M dimension.
             //
@@ -1422,12 +1628,14 @@ Return Value:
 
             if (TransA == CblasNoTrans) {
 
-                MlasSgemmKernelLoop(A + k, pb, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode);
+                MlasSgemmKernelLoop(A + k, pb, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode,
+                    SliceEpilogue, StartM, SliceStartN, UseJitKernels);
 
             } else {
 
                 const float* a = A + k * lda;
                 size_t RowsRemaining = M;
+                size_t SliceStartM = StartM;
 
                 while (RowsRemaining > 0) {
 
@@ -1446,7 +1654,10 @@ Return Value:
                     // Step through the rows of the local buffer.
                     //
 
-                    c = MlasSgemmKernelLoop(PanelA, pb, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+                    c = MlasSgemmKernelLoop(PanelA, pb, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode,
+                        SliceEpilogue, SliceStartM, SliceStartN, UseJitKernels);
+
+                    SliceStartM += RowsTransposed;
                 }
             }
 
@@ -1542,7 +1753,8 @@ Return Value:
 
         MlasSgemmPackedOperation(TransA, RangeCountM, RangeStartN, RangeCountN,
             K, DataParams->alpha, A, lda, DataParams->B,
-            BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, DataParams->beta, C, ldc);
+            BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, DataParams->beta, C, ldc,
+            DataParams->Epilogue, RangeStartM, DataParams->UseJitKernels);
 
     } else {
 
@@ -1551,9 +1763,99 @@ Return Value:
         const float* B = (const float*)DataParams->B + RangeStartN * ((TransB == CblasNoTrans) ? 1 : ldb);
 
         MlasSgemmOperation(TransA, TransB, RangeCountM, RangeCountN, K,
-            DataParams->alpha, A, lda, B, ldb, DataParams->beta, C, ldc);
+            DataParams->alpha, A, lda, B, ldb, DataParams->beta, C, ldc,
+            DataParams->Epilogue, RangeStartM, RangeStartN, DataParams->UseJitKernels);
+    }
+}
+void
+MlasSgemmSmallBatchThreaded(
+    const ptrdiff_t ThreadCount,
+    const CBLAS_TRANSPOSE TransA,
+    const CBLAS_TRANSPOSE TransB,
+    const size_t M,
+    const size_t N,
+    const size_t K,
+    const MLAS_SGEMM_DATA_PARAMS* Data,
+    const size_t BatchSize,
+    ptrdiff_t ThreadId
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a range of a batch
+    of small SGEMM operations, each of which is computed by the thread that
+    owns it.
+
+Arguments:
+
+    ThreadCount - Supplies the total thread partition of the batch.
+
+    TransA - Supplies the transpose operation on A matrix
+
+    TransB - Supplies the transpose operation on B matrix
+
+    M, N, K - Supplies the shape of the multiplications
+
+    Data - Supplies the data position and layout of the matrices of each
+        operation of the batch.
+
+    BatchSize - Supplies the number of operations in the batch.
+
+    ThreadId - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    size_t RangeStartBatch;
+    size_t RangeCountBatch;
+
+    MlasPartitionWork(ThreadId, ThreadCount, BatchSize, &RangeStartBatch, &RangeCountBatch);
+
+    //
+    // The small kernel reads matrix B in place, which avoids packing the
+    // panels of matrix B that are used by a few rows of matrix A.
+    //
+
+    MLAS_SGEMM_SMALL_KERNEL* SmallKernel = GetMlasPlatform().SgemmSmallKernel;
+
+    if (TransA != CblasNoTrans || TransB != CblasNoTrans || K == 0) {
+        SmallKernel = nullptr;
+    }
+
+    for (size_t i = RangeStartBatch; i < RangeStartBatch + RangeCountBatch; i++) {
+
+        const MLAS_SGEMM_DATA_PARAMS* DataParams = &Data[i];
+
+        if (SmallKernel == nullptr || DataParams->BIsPacked) {
+            MlasSgemmThreaded(1, 1, TransA, TransB, M, N, K, DataParams, 0);
+            continue;
+        }
+
+        const float* A = DataParams->A;
+        float* C = DataParams->C;
+        size_t RowsRemaining = M;
+
+        while (RowsRemaining > 0) {
+
+            const size_t RowsHandled = SmallKernel(A, DataParams->lda, DataParams->B, DataParams->ldb,
+                C, DataParams->ldc, K, RowsRemaining, N, DataParams->alpha, DataParams->beta);
+
+            if (DataParams->Epilogue != nullptr) {
+                MlasSgemmApplyEpilogue(DataParams->Epilogue, C, DataParams->ldc, M - RowsRemaining,
+                    0, RowsHandled, N);
+            }
+
+            A += RowsHandled * DataParams->lda;
+            C += RowsHandled * DataParams->ldc;
+            RowsRemaining -= RowsHandled;
+        }
     }
 }
+
 #if defined(_MSC_VER) && !defined(__clang__)
 #pragma warning(push)
 // Chance of arithmetic overflow could be reduced
@@ -1569,10 +1871,19 @@ MlasGemmBatch(
     size_t K,
     const MLAS_SGEMM_DATA_PARAMS* Data,
     size_t BatchSize,
-    MLAS_THREADPOOL* ThreadPool
+    MLAS_THREADPOOL* ThreadPool,
+    const MLAS_THREADING_PARAMS* Threading
     )
 {
 
+    //
+    // An empty batch has no work to partition.
+    //
+
+    if (BatchSize == 0) {
+        return;
+    }
+
     //
     // Compute the number of target threads given the complexity of the SGEMM
     // operation. Small requests should run using the single threaded path.
@@ -1582,7 +1893,9 @@ MlasGemmBatch(
 
     ptrdiff_t TargetThreadCount;
 
-    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * GetMlasPlatform().MaximumThreadCount)) {
+    if (Threading != nullptr && Threading->ThreadCount > 0) {
+        TargetThreadCount = Threading->ThreadCount;
+    } else if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * GetMlasPlatform().MaximumThreadCount)) {
         TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
     } else {
         TargetThreadCount = GetMlasPlatform().MaximumThreadCount;
@@ -1594,6 +1907,33 @@ MlasGemmBatch(
         TargetThreadCount = MaximumThreadCount;
     }
 
+    //
+    // Each operation of a batch of small operations runs on a single thread.
+    // Segment the batch into ranges of operations so that the thread count
+    // follows the complexity of the whole batch, instead of dispatching one
+    // work item per operation.
+    //
+
+    if (BatchSize > 1 && Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY)) {
+
+        const double BatchComplexity = Complexity * double(BatchSize);
+
+        ptrdiff_t BatchThreadCount = ptrdiff_t(BatchComplexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+
+        if (Threading != nullptr && Threading->ThreadCount > 0) {
+            BatchThreadCount = Threading->ThreadCount;
+        }
+
+        BatchThreadCount = std::min(BatchThreadCount, MaximumThreadCount);
+        BatchThreadCount = std::min(BatchThreadCount, ptrdiff_t(BatchSize));
+
+        MlasTrySimpleParallel(ThreadPool, BatchThreadCount, [=](ptrdiff_t tid) {
+            MlasSgemmSmallBatchThreaded(BatchThreadCount, TransA, TransB, M, N, K, Data, BatchSize, tid);
+        });
+
+        return;
+    }
+
     //
     // Segment the operation across multiple threads.
     //
@@ -1605,7 +1945,7 @@ MlasGemmBatch(
     ptrdiff_t ThreadCountM;
     ptrdiff_t ThreadCountN;
 
-    if (N > M) {
+    if (MlasGetThreadPartition(Threading, M, N) == MlasThreadPartitionN) {
 
         const size_t BlockedN = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) /
             MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
@@ -1741,3 +2081,32 @@ Return Value:
         PackedB = (float*)PackedB + AlignedN * CountK;
     }
 }
+
+bool
+MLASCALL
+MlasJitKernelsSupported(
+    void
+    )
+/*++
+
+Routine Description:
+
+    This routine returns whether the platform supports generating SGEMM
+    kernels at runtime.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    Returns true if MLAS_SGEMM_DATA_PARAMS::UseJitKernels has an effect.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64) && !defined(FORCE_GENERIC_ALGORITHMS)
+    return GetMlasPlatform().JitIsa != MlasJitIsaNone;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,543 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sgemm_jit.cpp
+
+Abstract:
+
+    This module implements the runtime generated single precision matrix/matrix
+    multiply kernels for AVX2/FMA3 and AVX512F.
+
+    The static kernels use a fixed register blocking of up to 16 columns per
+    accumulator row, so a single row of matrix A produces only one or two
+    dependent FMA chains and the loop is bound by the FMA latency. The
+    generated kernels are specialized for the row count, the number of
+    columns and the depth of the packed panel: all columns of the panel are
+    accumulated at once and the K dimension is split across independent
+    accumulators when there are too few columns to hide the latency.
+
+    Kernels are generated on first use and cached per (rows, columns, depth,
+    zero mode, instruction set) tuple for the lifetime of the process.
+
+--*/
+
+#include "mlasi.h"
+#include "jitcode.h"
+
+#include <mutex>
+#include <unordered_map>
+
+//
+// Define the maximum number of rows handled by a generated kernel. Taller
+// row blocks are handled well by the static kernels.
+//
+
+#define MLAS_SGEMM_JIT_MAXIMUM_ROWS                 4
+
+//
+// Define the maximum number of kernels that may be generated. Shapes beyond
+// this limit use the static kernels.
+//
+
+#define MLAS_SGEMM_JIT_MAXIMUM_KERNELS              1024
+
+//
+// Define the number of independent FMA chains needed to hide the FMA latency.
+//
+
+#define MLAS_SGEMM_JIT_MINIMUM_CHAINS               8
+
+struct MLAS_SGEMM_JIT_KERNEL_PARAMS {
+    const float* A;
+    const float* B;
+    float* C;
+    size_t lda;
+    size_t ldc;
+    float alpha;
+};
+
+typedef
+void
+(MLAS_SGEMM_JIT_KERNEL)(
+    const MLAS_SGEMM_JIT_KERNEL_PARAMS* Params
+    );
+
+struct MLAS_SGEMM_JIT_KERNEL_CACHE {
+    std::mutex Lock;
+    std::unordered_map<uint64_t, MLAS_SGEMM_JIT_KERNEL*> Kernels;
+};
+
+MLAS_SGEMM_JIT_KERNEL*
+MlasSgemmJitGenerateKernel(
+    MLAS_JIT_ISA Isa,
+    size_t Rows,
+    size_t Panels,
+    size_t CountK,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine generates a kernel that multiplies a block of rows of matrix
+    A by full 16 column panels of packed matrix B.
+
+    The generated kernel receives a pointer to MLAS_SGEMM_JIT_KERNEL_PARAMS
+    using the native calling convention and only uses volatile registers,
+    except for xmm6-xmm15 on Windows which are saved and restored.
+
+Arguments:
+
+    Isa - Supplies the instruction set to generate code for.
+
+    Rows - Supplies the number of rows from matrix A and matrix C.
+
+    Panels - Supplies the number of 16 column panels from matrix B.
+
+    CountK - Supplies the number of columns from matrix A and the number of
+        rows from matrix B.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    Returns the generated kernel, else nullptr if executable memory could
+    not be allocated.
+
+--*/
+{
+    const bool IsAvx512F = (Isa == MlasJitIsaAvx512F);
+
+    //
+    // A 16 column panel occupies one zmm or two ymm registers. The last
+    // register holds the broadcast element of matrix A. For multiple rows,
+    // the vectors of matrix B are loaded once per step into the registers
+    // below the broadcast register and shared by all rows, otherwise the
+    // vectors are read directly by the multiply instructions.
+    //
+
+    const size_t VectorsPerPanel = IsAvx512F ? 1 : 2;
+    const size_t VectorBytes = IsAvx512F ? 64 : 32;
+    const size_t RegisterCount = IsAvx512F ? 32 : 16;
+    const uint8_t BroadcastRegister = uint8_t(RegisterCount - 1);
+    const bool LoadB = (Rows > 1);
+
+    const size_t MaximumGroupPanels = (RegisterCount - 1) / ((LoadB ? Rows + 1 : Rows) * VectorsPerPanel);
+
+    const int32_t PanelBytes = int32_t(CountK * 16 * sizeof(float));
+
+    MLAS_JIT_CODE_GENERATOR Gen(IsAvx512F ? MlasJitZmm : MlasJitYmm);
+
+    //
+    // Prologue.
+    //
+
+#if defined(_WIN32)
+    constexpr int32_t SavedRegisterBytes = 10 * 16 + 8;
+
+    Gen.Mov(MlasJitRax, MlasJitRcx);
+    Gen.AddImm32(MlasJitRsp, -SavedRegisterBytes);
+    Gen.SetVectorWidth(MlasJitXmm);
+    for (uint8_t i = 0; i < 10; i++) {
+        Gen.VMovUps(MlasJitPtr(MlasJitRsp, i * 16), uint8_t(6 + i));
+    }
+    Gen.SetVectorWidth(IsAvx512F ? MlasJitZmm : MlasJitYmm);
+#else
+    Gen.Mov(MlasJitRax, MlasJitRdi);
+#endif
+
+    Gen.Mov(MlasJitR11, MlasJitPtr(MlasJitRax, offsetof(MLAS_SGEMM_JIT_KERNEL_PARAMS, lda)));
+
+    //
+    // Split the panels into groups that fit in the accumulator registers.
+    //
+
+    const size_t GroupCount = (Panels + MaximumGroupPanels - 1) / MaximumGroupPanels;
+
+    size_t FirstPanel = 0;
+
+    for (size_t Group = 0; Group < GroupCount; Group++) {
+
+        const size_t GroupPanels = (Panels - FirstPanel) / (GroupCount - Group);
+        const size_t VectorsPerRow = GroupPanels * VectorsPerPanel;
+        const size_t AccumulatorsPerSet = Rows * VectorsPerRow;
+
+        //
+        // Split the K dimension across independent accumulator sets if there
+        // are not enough accumulators to hide the FMA latency.
+        //
+
+        const size_t AccumulatorLimit = RegisterCount - 1 - (LoadB ? VectorsPerRow : 0);
+
+        size_t Sets = (MLAS_SGEMM_JIT_MINIMUM_CHAINS + AccumulatorsPerSet - 1) / AccumulatorsPerSet;
+        Sets = std::min(Sets, AccumulatorLimit / AccumulatorsPerSet);
+        Sets = std::max(std::min(Sets, CountK), size_t(1));
+
+        auto Accumulator = [&](size_t Set, size_t Row, size_t Vector) {
+            return uint8_t((Set * Rows + Row) * VectorsPerRow + Vector);
+        };
+
+        //
+        // Rows 0 through 2 of matrix A are addressed relative to r8, row 3 is
+        // addressed through r10.
+        //
+
+        auto RowOfA = [&](size_t Row, int32_t Displacement) {
+            if (Row == 3) {
+                return MlasJitPtr(MlasJitR10, Displacement);
+            } else if (Row == 0) {
+                return MlasJitPtr(MlasJitR8, Displacement);
+            } else {
+                return MlasJitPtr(MlasJitR8, MlasJitR11, uint8_t(Row), Displacement);
+            }
+        };
+
+        auto VectorOfB = [&](size_t Vector, size_t k) {
+            const int32_t Displacement = int32_t((FirstPanel + Vector / VectorsPerPanel) * PanelBytes +
+                k * 16 * sizeof(float) + (Vector % VectorsPerPanel) * VectorBytes);
+            return MlasJitPtr(MlasJitR9, Displacement);
+        };
+
+        auto EmitStep = [&](size_t Set, size_t k) {
+            if (LoadB) {
+                for (size_t Vector = 0; Vector < VectorsPerRow; Vector++) {
+                    Gen.VMovUps(uint8_t(BroadcastRegister - VectorsPerRow + Vector), VectorOfB(Vector, k));
+                }
+            }
+            for (size_t Row = 0; Row < Rows; Row++) {
+                Gen.VBroadcastSs(BroadcastRegister, RowOfA(Row, int32_t(k * sizeof(float))));
+                for (size_t Vector = 0; Vector < VectorsPerRow; Vector++) {
+                    if (LoadB) {
+                        Gen.VFmadd231Ps(Accumulator(Set, Row, Vector), BroadcastRegister,
+                                        uint8_t(BroadcastRegister - VectorsPerRow + Vector));
+                    } else {
+                        Gen.VFmadd231Ps(Accumulator(Set, Row, Vector), BroadcastRegister, VectorOfB(Vector, k));
+                    }
+                }
+            }
+        };
+
+        Gen.Mov(MlasJitR8, MlasJitPtr(MlasJitRax, offsetof(MLAS_SGEMM_JIT_KERNEL_PARAMS, A)));
+        Gen.Mov(MlasJitR9, MlasJitPtr(MlasJitRax, offsetof(MLAS_SGEMM_JIT_KERNEL_PARAMS, B)));
+
+        if (Rows > 3) {
+            Gen.Lea(MlasJitR10, MlasJitPtr(MlasJitR8, MlasJitR11, 2));
+            Gen.Lea(MlasJitR10, MlasJitPtr(MlasJitR10, MlasJitR11, 1));
+        }
+
+        for (size_t i = 0; i < Sets * AccumulatorsPerSet; i++) {
+            Gen.VZero(uint8_t(i));
+        }
+
+        //
+        // Unroll the K loop to at least four steps per iteration, cycling
+        // through the accumulator sets.
+        //
+
+        const size_t StepsPerIteration = Sets * ((4 + Sets - 1) / Sets);
+        const size_t Iterations = CountK / StepsPerIteration;
+        size_t k = 0;
+
+        if (Iterations == 1) {
+
+            for (size_t Step = 0; Step < StepsPerIteration; Step++) {
+                EmitStep(Step % Sets, Step);
+            }
+
+            k = StepsPerIteration;
+
+        } else if (Iterations > 1) {
+
+            Gen.MovImm32(MlasJitRcx, uint32_t(Iterations));
+
+            const size_t LoopLabel = Gen.Label();
+
+            for (size_t Step = 0; Step < StepsPerIteration; Step++) {
+                EmitStep(Step % Sets, Step);
+            }
+
+            Gen.AddImm32(MlasJitR8, int32_t(StepsPerIteration * sizeof(float)));
+            if (Rows > 3) {
+                Gen.AddImm32(MlasJitR10, int32_t(StepsPerIteration * sizeof(float)));
+            }
+            Gen.AddImm32(MlasJitR9, int32_t(StepsPerIteration * 16 * sizeof(float)));
+            Gen.Dec(MlasJitRcx);
+            Gen.Jnz(LoopLabel);
+        }
+
+        for (size_t Step = 0; Step < CountK % StepsPerIteration; Step++) {
+            EmitStep(Step % Sets, k + Step);
+        }
+
+        //
+        // Reduce the accumulator sets, apply alpha and store the output.
+        //
+
+        for (size_t Set = 1; Set < Sets; Set++) {
+            for (size_t i = 0; i < AccumulatorsPerSet; i++) {
+                Gen.VAddPs(uint8_t(i), uint8_t(i), uint8_t(Set * AccumulatorsPerSet + i));
+            }
+        }
+
+        Gen.VBroadcastSs(BroadcastRegister, MlasJitPtr(MlasJitRax, offsetof(MLAS_SGEMM_JIT_KERNEL_PARAMS, alpha)));
+
+        for (size_t i = 0; i < AccumulatorsPerSet; i++) {
+            Gen.VMulPs(uint8_t(i), uint8_t(i), BroadcastRegister);
+        }
+
+        Gen.Mov(MlasJitRdx, MlasJitPtr(MlasJitRax, offsetof(MLAS_SGEMM_JIT_KERNEL_PARAMS, C)));
+        Gen.Mov(MlasJitRcx, MlasJitPtr(MlasJitRax, offsetof(MLAS_SGEMM_JIT_KERNEL_PARAMS, ldc)));
+
+        if (Rows > 3) {
+            Gen.Lea(MlasJitR10, MlasJitPtr(MlasJitRdx, MlasJitRcx, 2));
+        }
+
+        for (size_t Row = 0; Row < Rows; Row++) {
+            for (size_t Vector = 0; Vector < VectorsPerRow; Vector++) {
+
+                const int32_t Displacement = int32_t(FirstPanel * 16 * sizeof(float) + Vector * VectorBytes);
+
+                MLAS_JIT_MEMORY_OPERAND RowOfC;
+
+                if (Row == 0) {
+                    RowOfC = MlasJitPtr(MlasJitRdx, Displacement);
+                } else if (Row == 3) {
+                    RowOfC = MlasJitPtr(MlasJitR10, MlasJitRcx, 1, Displacement);
+                } else {
+                    RowOfC = MlasJitPtr(MlasJitRdx, MlasJitRcx, uint8_t(Row), Displacement);
+                }
+
+                const uint8_t Acc = Accumulator(0, Row, Vector);
+
+                if (!ZeroMode) {
+                    Gen.VAddPs(Acc, Acc, RowOfC);
+                }
+
+                Gen.VMovUps(RowOfC, Acc);
+            }
+        }
+
+        FirstPanel += GroupPanels;
+    }
+
+    //
+    // Epilogue.
+    //
+
+#if defined(_WIN32)
+    Gen.SetVectorWidth(MlasJitXmm);
+    for (uint8_t i = 0; i < 10; i++) {
+        Gen.VMovUps(uint8_t(6 + i), MlasJitPtr(MlasJitRsp, i * 16));
+    }
+    Gen.AddImm32(MlasJitRsp, SavedRegisterBytes);
+#endif
+
+    Gen.Vzeroupper();
+    Gen.Ret();
+
+    return reinterpret_cast<MLAS_SGEMM_JIT_KERNEL*>(Gen.Commit());
+}
+
+MLAS_SGEMM_JIT_KERNEL*
+MlasSgemmJitGetKernel(
+    size_t Rows,
+    size_t Panels,
+    size_t CountK,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the generated kernel for the supplied shape,
+    generating the kernel on first use.
+
+Arguments:
+
+    Rows - Supplies the number of rows from matrix A and matrix C.
+
+    Panels - Supplies the number of 16 column panels from matrix B.
+
+    CountK - Supplies the number of columns from matrix A and the number of
+        rows from matrix B.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    Returns the kernel, else nullptr if no kernel is available for the shape.
+
+--*/
+{
+    const MLAS_JIT_ISA Isa = GetMlasPlatform().JitIsa;
+
+    if (Isa == MlasJitIsaNone) {
+        return nullptr;
+    }
+
+    const uint64_t Key = uint64_t(Isa) | (uint64_t(ZeroMode) << 4) | (uint64_t(Rows) << 8) |
+        (uint64_t(Panels) << 16) | (uint64_t(CountK) << 32);
+
+    //
+    // Check the per thread cache of recently used kernels before taking the
+    // lock on the shared cache.
+    //
+
+    struct MLAS_SGEMM_JIT_RECENT_KERNEL {
+        uint64_t Key;
+        MLAS_SGEMM_JIT_KERNEL* Kernel;
+    };
+
+    constexpr size_t RecentKernelCount = 4;
+
+    static thread_local MLAS_SGEMM_JIT_RECENT_KERNEL RecentKernels[RecentKernelCount] = {};
+    static thread_local size_t RecentKernelNext = 0;
+
+    for (size_t i = 0; i < RecentKernelCount; i++) {
+        if (RecentKernels[i].Key == Key) {
+            return RecentKernels[i].Kernel;
+        }
+    }
+
+    static MLAS_SGEMM_JIT_KERNEL_CACHE Cache;
+
+    MLAS_SGEMM_JIT_KERNEL* Kernel;
+
+    {
+        std::lock_guard<std::mutex> Lock(Cache.Lock);
+
+        auto it = Cache.Kernels.find(Key);
+
+        if (it != Cache.Kernels.end()) {
+            Kernel = it->second;
+        } else if (Cache.Kernels.size() < MLAS_SGEMM_JIT_MAXIMUM_KERNELS) {
+            Kernel = MlasSgemmJitGenerateKernel(Isa, Rows, Panels, CountK, ZeroMode);
+            Cache.Kernels.emplace(Key, Kernel);
+        } else {
+            Kernel = nullptr;
+        }
+    }
+
+    RecentKernels[RecentKernelNext] = {Key, Kernel};
+    RecentKernelNext = (RecentKernelNext + 1) % RecentKernelCount;
+
+    return Kernel;
+}
+
+size_t
+MLASCALL
+MlasSgemmJitKernel(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows using a generated kernel. The interface matches the static
+    kernels so the routine can be substituted for them.
+
+    Row blocks taller than the generated kernels support and column counts
+    smaller than a panel use the static kernel. Columns past the last full
+    panel are also handled by the static kernel.
+
+Arguments:
+
+    A - Supplies the address of matrix A.
+
+    B - Supplies the address of matrix B. The matrix data has been packed using
+        MlasSgemmCopyPackB or MlasSgemmTransposePackB.
+
+    C - Supplies the address of matrix C.
+
+    CountK - Supplies the number of columns from matrix A and the number of rows
+        from matrix B to iterate over.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to
+        iterate over.
+
+    lda - Supplies the first dimension of matrix A.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    alpha - Supplies the scalar multiplier (see SGEMM definition).
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    MLAS_GEMM_FLOAT_KERNEL* GemmFloatKernel = GetMlasPlatform().GemmFloatKernel;
+
+    const size_t Panels = CountN / 16;
+
+    if (CountM > MLAS_SGEMM_JIT_MAXIMUM_ROWS || Panels == 0 || CountK == 0) {
+        return GemmFloatKernel(A, B, C, CountK, CountM, CountN, lda, ldc, alpha, ZeroMode);
+    }
+
+    MLAS_SGEMM_JIT_KERNEL* Kernel = MlasSgemmJitGetKernel(CountM, Panels, CountK, ZeroMode);
+
+    if (Kernel == nullptr) {
+        return GemmFloatKernel(A, B, C, CountK, CountM, CountN, lda, ldc, alpha, ZeroMode);
+    }
+
+    MLAS_SGEMM_JIT_KERNEL_PARAMS Params;
+
+    Params.A = A;
+    Params.B = B;
+    Params.C = C;
+    Params.lda = lda * sizeof(float);
+    Params.ldc = ldc * sizeof(float);
+    Params.alpha = alpha;
+
+    Kernel(&Params);
+
+    //
+    // Process the columns of the partial panel with the static kernel.
+    //
+
+    const size_t CountNRemaining = CountN % 16;
+
+    if (CountNRemaining > 0) {
+
+        const float* a = A;
+        const float* b = B + Panels * 16 * CountK;
+        float* c = C + Panels * 16;
+        size_t RowsRemaining = CountM;
+
+        while (RowsRemaining > 0) {
+
+            const size_t RowsHandled = GemmFloatKernel(a, b, c, CountK, RowsRemaining, CountNRemaining,
+                lda, ldc, alpha, ZeroMode);
+
+            a += lda * RowsHandled;
+            c += ldc * RowsHandled;
+            RowsRemaining -= RowsHandled;
+        }
+    }
+
+    return CountM;
+}
@@ -0,0 +1,199 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sgemm_small_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the small matrix SGEMM kernel for AVX2/FMA3.
+
+    The kernel reads matrix B in place, so no packed copy of matrix B is
+    made. It computes 6 rows of a 16 column panel of C with two vectors of
+    accumulators per row, the same register blocking as the dense FMA3 SGEMM
+    kernel.
+
+--*/
+
+#include <utility>
+
+#include "mlasi.h"
+
+namespace
+{
+
+template <typename IterationFn, size_t... Indices>
+MLAS_FORCEINLINE void
+UnrolledLoopIterations(IterationFn&& f, std::index_sequence<Indices...> /* indices */)
+{
+    (f(Indices), ...);
+}
+
+template <size_t N, typename IterationFn>
+MLAS_FORCEINLINE void
+UnrolledLoop(IterationFn&& f)
+{
+    UnrolledLoopIterations(std::forward<IterationFn>(f), std::make_index_sequence<N>());
+}
+
+MLAS_FORCEINLINE
+__m256i
+LoadStoreMask8(
+    size_t Count
+    )
+{
+    return _mm256_cmpgt_epi32(_mm256_set1_epi32(int(Count)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+template <size_t RowCount, size_t VectorCount, bool Masked>
+void
+MlasSgemmSmallKernelAvx2Panel(
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    size_t CountK,
+    size_t CountN,
+    float alpha,
+    float beta
+    )
+{
+    __m256 Accumulators[RowCount][VectorCount];
+    __m256i Masks[VectorCount];
+
+    Masks[0] = LoadStoreMask8(CountN);
+    if constexpr (VectorCount > 1) {
+        Masks[1] = LoadStoreMask8(CountN > 8 ? CountN - 8 : 0);
+    }
+
+    UnrolledLoop<RowCount * VectorCount>([&](size_t i) {
+        Accumulators[i / VectorCount][i % VectorCount] = _mm256_setzero_ps();
+    });
+
+    for (size_t k = 0; k < CountK; k++) {
+
+        __m256 Values[VectorCount];
+
+        UnrolledLoop<VectorCount>([&](size_t v) {
+            if constexpr (Masked) {
+                Values[v] = _mm256_maskload_ps(B + v * 8, Masks[v]);
+            } else {
+                Values[v] = _mm256_loadu_ps(B + v * 8);
+            }
+        });
+
+        UnrolledLoop<RowCount>([&](size_t r) {
+            const __m256 ABroadcast = _mm256_broadcast_ss(A + r * lda + k);
+            Accumulators[r][0] = _mm256_fmadd_ps(ABroadcast, Values[0], Accumulators[r][0]);
+            if constexpr (VectorCount > 1) {
+                Accumulators[r][1] = _mm256_fmadd_ps(ABroadcast, Values[1], Accumulators[r][1]);
+            }
+        });
+
+        B += ldb;
+    }
+
+    const __m256 Alpha = _mm256_set1_ps(alpha);
+    const __m256 Beta = _mm256_set1_ps(beta);
+
+    auto StoreVector = [&](float* c, __m256 Accumulator, size_t v) {
+        __m256 Result = _mm256_mul_ps(Accumulator, Alpha);
+        if constexpr (Masked) {
+            if (beta != 0.0f) {
+                Result = _mm256_fmadd_ps(_mm256_maskload_ps(c, Masks[v]), Beta, Result);
+            }
+            _mm256_maskstore_ps(c, Masks[v], Result);
+        } else {
+            if (beta != 0.0f) {
+                Result = _mm256_fmadd_ps(_mm256_loadu_ps(c), Beta, Result);
+            }
+            _mm256_storeu_ps(c, Result);
+        }
+    };
+
+    UnrolledLoop<RowCount>([&](size_t r) {
+        StoreVector(C + r * ldc, Accumulators[r][0], 0);
+        if constexpr (VectorCount > 1) {
+            StoreVector(C + r * ldc + 8, Accumulators[r][1], 1);
+        }
+    });
+}
+
+template <size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasSgemmSmallKernelAvx2Rows(
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    size_t CountK,
+    size_t CountN,
+    float alpha,
+    float beta
+    )
+{
+    size_t n = 0;
+
+    for (; n + 16 <= CountN; n += 16) {
+        MlasSgemmSmallKernelAvx2Panel<RowCount, 2, false>(A, lda, B + n, ldb, C + n, ldc, CountK, 16, alpha, beta);
+    }
+
+    const size_t CountNRemaining = CountN - n;
+
+    if (CountNRemaining > 8) {
+        MlasSgemmSmallKernelAvx2Panel<RowCount, 2, true>(A, lda, B + n, ldb, C + n, ldc, CountK, CountNRemaining, alpha, beta);
+    } else if (CountNRemaining == 8) {
+        MlasSgemmSmallKernelAvx2Panel<RowCount, 1, false>(A, lda, B + n, ldb, C + n, ldc, CountK, 8, alpha, beta);
+    } else if (CountNRemaining > 0) {
+        MlasSgemmSmallKernelAvx2Panel<RowCount, 1, true>(A, lda, B + n, ldb, C + n, ldc, CountK, CountNRemaining, alpha, beta);
+    }
+}
+
+}  // namespace
+
+size_t
+MLASCALL
+MlasSgemmSmallKernelAvx2(
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    float alpha,
+    float beta
+    )
+{
+    switch (CountM) {
+        case 1:
+            MlasSgemmSmallKernelAvx2Rows<1>(A, lda, B, ldb, C, ldc, CountK, CountN, alpha, beta);
+            return 1;
+        case 2:
+            MlasSgemmSmallKernelAvx2Rows<2>(A, lda, B, ldb, C, ldc, CountK, CountN, alpha, beta);
+            return 2;
+        case 3:
+            MlasSgemmSmallKernelAvx2Rows<3>(A, lda, B, ldb, C, ldc, CountK, CountN, alpha, beta);
+            return 3;
+        case 4:
+            MlasSgemmSmallKernelAvx2Rows<4>(A, lda, B, ldb, C, ldc, CountK, CountN, alpha, beta);
+            return 4;
+        case 5:
+            MlasSgemmSmallKernelAvx2Rows<5>(A, lda, B, ldb, C, ldc, CountK, CountN, alpha, beta);
+            return 5;
+        default:
+            MlasSgemmSmallKernelAvx2Rows<6>(A, lda, B, ldb, C, ldc, CountK, CountN, alpha, beta);
+            return 6;
+    }
+}
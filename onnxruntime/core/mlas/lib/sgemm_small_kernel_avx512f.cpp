@@ -0,0 +1,195 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sgemm_small_kernel_avx512f.cpp
+
+Abstract:
+
+    This module implements the small matrix SGEMM kernel for AVX512F.
+
+    The kernel reads matrix B in place, so no packed copy of matrix B is
+    made. It computes 8 rows of a 32 column panel of C with two vectors of
+    accumulators per row.
+
+--*/
+
+#include <utility>
+
+#include "mlasi.h"
+
+namespace
+{
+
+template <typename IterationFn, size_t... Indices>
+MLAS_FORCEINLINE void
+UnrolledLoopIterations(IterationFn&& f, std::index_sequence<Indices...> /* indices */)
+{
+    (f(Indices), ...);
+}
+
+template <size_t N, typename IterationFn>
+MLAS_FORCEINLINE void
+UnrolledLoop(IterationFn&& f)
+{
+    UnrolledLoopIterations(std::forward<IterationFn>(f), std::make_index_sequence<N>());
+}
+
+template <size_t RowCount, size_t VectorCount, bool Masked>
+void
+MlasSgemmSmallKernelAvx512FPanel(
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    size_t CountK,
+    size_t CountN,
+    float alpha,
+    float beta
+    )
+{
+    __m512 Accumulators[RowCount][VectorCount];
+    __mmask16 Masks[VectorCount];
+
+    Masks[0] = __mmask16(CountN >= 16 ? 0xFFFF : (1u << CountN) - 1);
+    if constexpr (VectorCount > 1) {
+        Masks[1] = __mmask16((1u << (CountN - 16)) - 1);
+    }
+
+    UnrolledLoop<RowCount * VectorCount>([&](size_t i) {
+        Accumulators[i / VectorCount][i % VectorCount] = _mm512_setzero_ps();
+    });
+
+    for (size_t k = 0; k < CountK; k++) {
+
+        __m512 Values[VectorCount];
+
+        UnrolledLoop<VectorCount>([&](size_t v) {
+            if constexpr (Masked) {
+                Values[v] = _mm512_maskz_loadu_ps(Masks[v], B + v * 16);
+            } else {
+                Values[v] = _mm512_loadu_ps(B + v * 16);
+            }
+        });
+
+        UnrolledLoop<RowCount>([&](size_t r) {
+            const __m512 ABroadcast = _mm512_set1_ps(A[r * lda + k]);
+            Accumulators[r][0] = _mm512_fmadd_ps(ABroadcast, Values[0], Accumulators[r][0]);
+            if constexpr (VectorCount > 1) {
+                Accumulators[r][1] = _mm512_fmadd_ps(ABroadcast, Values[1], Accumulators[r][1]);
+            }
+        });
+
+        B += ldb;
+    }
+
+    const __m512 Alpha = _mm512_set1_ps(alpha);
+    const __m512 Beta = _mm512_set1_ps(beta);
+
+    auto StoreVector = [&](float* c, __m512 Accumulator, size_t v) {
+        __m512 Result = _mm512_mul_ps(Accumulator, Alpha);
+        if constexpr (Masked) {
+            if (beta != 0.0f) {
+                Result = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(Masks[v], c), Beta, Result);
+            }
+            _mm512_mask_storeu_ps(c, Masks[v], Result);
+        } else {
+            if (beta != 0.0f) {
+                Result = _mm512_fmadd_ps(_mm512_loadu_ps(c), Beta, Result);
+            }
+            _mm512_storeu_ps(c, Result);
+        }
+    };
+
+    UnrolledLoop<RowCount>([&](size_t r) {
+        StoreVector(C + r * ldc, Accumulators[r][0], 0);
+        if constexpr (VectorCount > 1) {
+            StoreVector(C + r * ldc + 16, Accumulators[r][1], 1);
+        }
+    });
+}
+
+template <size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasSgemmSmallKernelAvx512FRows(
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    size_t CountK,
+    size_t CountN,
+    float alpha,
+    float beta
+    )
+{
+    size_t n = 0;
+
+    for (; n + 32 <= CountN; n += 32) {
+        MlasSgemmSmallKernelAvx512FPanel<RowCount, 2, false>(A, lda, B + n, ldb, C + n, ldc, CountK, 32, alpha, beta);
+    }
+
+    const size_t CountNRemaining = CountN - n;
+
+    if (CountNRemaining > 16) {
+        MlasSgemmSmallKernelAvx512FPanel<RowCount, 2, true>(A, lda, B + n, ldb, C + n, ldc, CountK, CountNRemaining, alpha, beta);
+    } else if (CountNRemaining == 16) {
+        MlasSgemmSmallKernelAvx512FPanel<RowCount, 1, false>(A, lda, B + n, ldb, C + n, ldc, CountK, 16, alpha, beta);
+    } else if (CountNRemaining > 0) {
+        MlasSgemmSmallKernelAvx512FPanel<RowCount, 1, true>(A, lda, B + n, ldb, C + n, ldc, CountK, CountNRemaining, alpha, beta);
+    }
+}
+
+}  // namespace
+
+size_t
+MLASCALL
+MlasSgemmSmallKernelAvx512F(
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    float alpha,
+    float beta
+    )
+{
+    switch (CountM) {
+        case 1:
+            MlasSgemmSmallKernelAvx512FRows<1>(A, lda, B, ldb, C, ldc, CountK, CountN, alpha, beta);
+            return 1;
+        case 2:
+            MlasSgemmSmallKernelAvx512FRows<2>(A, lda, B, ldb, C, ldc, CountK, CountN, alpha, beta);
+            return 2;
+        case 3:
+            MlasSgemmSmallKernelAvx512FRows<3>(A, lda, B, ldb, C, ldc, CountK, CountN, alpha, beta);
+            return 3;
+        case 4:
+            MlasSgemmSmallKernelAvx512FRows<4>(A, lda, B, ldb, C, ldc, CountK, CountN, alpha, beta);
+            return 4;
+        case 5:
+            MlasSgemmSmallKernelAvx512FRows<5>(A, lda, B, ldb, C, ldc, CountK, CountN, alpha, beta);
+            return 5;
+        case 6:
+            MlasSgemmSmallKernelAvx512FRows<6>(A, lda, B, ldb, C, ldc, CountK, CountN, alpha, beta);
+            return 6;
+        case 7:
+            MlasSgemmSmallKernelAvx512FRows<7>(A, lda, B, ldb, C, ldc, CountK, CountN, alpha, beta);
+            return 7;
+        default:
+            MlasSgemmSmallKernelAvx512FRows<8>(A, lda, B, ldb, C, ldc, CountK, CountN, alpha, beta);
+            return 8;
+    }
+}
@@ -0,0 +1,517 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sparsegemm.cpp
+
+Abstract:
+
+    This module implements the block sparse single precision matrix/matrix
+    multiply operation.
+
+    The right hand side is packed into a block compressed format. The columns
+    of B are split into panels of 16 columns and each panel stores the rows
+    that contain a nonzero value as a block of 16 values, together with the
+    row index of the block. The kernels compute a panel of C by accumulating
+    the products of the columns of A selected by the row indices with the
+    blocks of the panel, so the zero blocks cost nothing.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the number of columns of a block of the packed matrix.
+//
+
+constexpr size_t MLAS_SPARSE_GEMM_BLOCK_N = 16;
+
+//
+// Define the number of rows of A that are processed for all the panels of a
+// thread before moving to the next rows. This keeps the rows of A in the cache
+// while the blocks of the panels are streamed.
+//
+
+constexpr size_t MLAS_SPARSE_GEMM_STRIDEM = 64;
+
+//
+// Define the layout of the packed buffer, the header is followed by the
+// offset of the first block of each panel, the row index of each block and
+// the aligned block values.
+//
+
+struct MLAS_SPARSE_GEMM_PACKED_HEADER {
+    uint64_t N;
+    uint64_t K;
+    uint64_t PanelCount;
+    uint64_t BlockCount;
+};
+
+constexpr size_t MLAS_SPARSE_GEMM_VALUES_ALIGNMENT = 64;
+
+struct MLAS_SPARSE_GEMM_PACKED_LAYOUT {
+    const uint32_t* PanelOffsets;
+    const uint32_t* BlockRows;
+    const float* BlockValues;
+};
+
+MLAS_FORCEINLINE
+size_t
+MlasSparseGemmValuesOffset(
+    size_t PanelCount,
+    size_t BlockCount
+    )
+{
+    const size_t IndexBytes = sizeof(MLAS_SPARSE_GEMM_PACKED_HEADER) +
+                              (PanelCount + 1 + BlockCount) * sizeof(uint32_t);
+
+    return (IndexBytes + MLAS_SPARSE_GEMM_VALUES_ALIGNMENT - 1) & ~(MLAS_SPARSE_GEMM_VALUES_ALIGNMENT - 1);
+}
+
+MLAS_FORCEINLINE
+bool
+MlasSparseGemmIsZeroBlock(
+    const float* B,
+    size_t CountN
+    )
+{
+    for (size_t n = 0; n < CountN; n++) {
+        if (B[n] != 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t
+MlasSparseGemmCountBlocks(
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    )
+/*++
+
+Routine Description:
+
+    This routine counts the 1x16 row blocks of B that have a nonzero value.
+
+--*/
+{
+    size_t BlockCount = 0;
+
+    for (size_t n = 0; n < N; n += MLAS_SPARSE_GEMM_BLOCK_N) {
+
+        const size_t CountN = std::min(N - n, MLAS_SPARSE_GEMM_BLOCK_N);
+
+        for (size_t k = 0; k < K; k++) {
+            if (!MlasSparseGemmIsZeroBlock(B + k * ldb + n, CountN)) {
+                BlockCount++;
+            }
+        }
+    }
+
+    return BlockCount;
+}
+
+float
+MLASCALL
+MlasSparseGemmBlockSparsity(
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    )
+{
+    const size_t PanelCount = MlasDivRoundup(N, MLAS_SPARSE_GEMM_BLOCK_N);
+    const size_t TotalBlocks = PanelCount * K;
+
+    if (TotalBlocks == 0) {
+        return 0.0f;
+    }
+
+    const size_t BlockCount = MlasSparseGemmCountBlocks(N, K, B, ldb);
+
+    return float(TotalBlocks - BlockCount) / float(TotalBlocks);
+}
+
+size_t
+MLASCALL
+MlasSparseGemmPackBSize(
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    )
+{
+    //
+    // The row indices and the block offsets are stored as 32-bit values.
+    //
+
+    if (K > std::numeric_limits<uint32_t>::max()) {
+        return 0;
+    }
+
+    const size_t PanelCount = MlasDivRoundup(N, MLAS_SPARSE_GEMM_BLOCK_N);
+    const size_t BlockCount = MlasSparseGemmCountBlocks(N, K, B, ldb);
+
+    if (BlockCount > std::numeric_limits<uint32_t>::max()) {
+        return 0;
+    }
+
+    const size_t BytesRequired = MlasSparseGemmValuesOffset(PanelCount, BlockCount) +
+                                 BlockCount * MLAS_SPARSE_GEMM_BLOCK_N * sizeof(float);
+    const size_t BufferAlignment = MlasGetPreferredBufferAlignment();
+
+    return (BytesRequired + BufferAlignment - 1) & ~(BufferAlignment - 1);
+}
+
+void
+MLASCALL
+MlasSparseGemmPackB(
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs B into the block sparse format. The buffer must be
+    MlasSparseGemmPackBSize bytes and aligned to MlasGetPreferredBufferAlignment.
+
+--*/
+{
+    const size_t PanelCount = MlasDivRoundup(N, MLAS_SPARSE_GEMM_BLOCK_N);
+    const size_t BlockCount = MlasSparseGemmCountBlocks(N, K, B, ldb);
+
+    auto* Header = reinterpret_cast<MLAS_SPARSE_GEMM_PACKED_HEADER*>(PackedB);
+    Header->N = N;
+    Header->K = K;
+    Header->PanelCount = PanelCount;
+    Header->BlockCount = BlockCount;
+
+    uint32_t* PanelOffsets = reinterpret_cast<uint32_t*>(Header + 1);
+    uint32_t* BlockRows = PanelOffsets + PanelCount + 1;
+    float* BlockValues = reinterpret_cast<float*>(
+        static_cast<uint8_t*>(PackedB) + MlasSparseGemmValuesOffset(PanelCount, BlockCount));
+
+    size_t BlockIndex = 0;
+
+    for (size_t p = 0; p < PanelCount; p++) {
+
+        const size_t n = p * MLAS_SPARSE_GEMM_BLOCK_N;
+        const size_t CountN = std::min(N - n, MLAS_SPARSE_GEMM_BLOCK_N);
+
+        PanelOffsets[p] = uint32_t(BlockIndex);
+
+        for (size_t k = 0; k < K; k++) {
+
+            const float* b = B + k * ldb + n;
+
+            if (MlasSparseGemmIsZeroBlock(b, CountN)) {
+                continue;
+            }
+
+            //
+            // Zero pad the columns past the end of the matrix so that the
+            // kernels can always use full blocks.
+            //
+
+            float* Values = BlockValues + BlockIndex * MLAS_SPARSE_GEMM_BLOCK_N;
+
+            std::copy_n(b, CountN, Values);
+            std::fill_n(Values + CountN, MLAS_SPARSE_GEMM_BLOCK_N - CountN, 0.0f);
+
+            BlockRows[BlockIndex] = uint32_t(k);
+            BlockIndex++;
+        }
+    }
+
+    PanelOffsets[PanelCount] = uint32_t(BlockIndex);
+}
+
+MLAS_FORCEINLINE
+MLAS_SPARSE_GEMM_PACKED_LAYOUT
+MlasSparseGemmGetPackedLayout(
+    const void* PackedB
+    )
+{
+    const auto* Header = static_cast<const MLAS_SPARSE_GEMM_PACKED_HEADER*>(PackedB);
+
+    MLAS_SPARSE_GEMM_PACKED_LAYOUT Layout;
+    Layout.PanelOffsets = reinterpret_cast<const uint32_t*>(Header + 1);
+    Layout.BlockRows = Layout.PanelOffsets + Header->PanelCount + 1;
+    Layout.BlockValues = reinterpret_cast<const float*>(
+        static_cast<const uint8_t*>(PackedB) +
+        MlasSparseGemmValuesOffset(size_t(Header->PanelCount), size_t(Header->BlockCount)));
+
+    return Layout;
+}
+
+size_t
+MLASCALL
+MlasSparseGemmKernel(
+    const float* A,
+    size_t lda,
+    const uint32_t* BlockRows,
+    const float* BlockValues,
+    size_t BlockCount,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine is the portable implementation of the block sparse kernel,
+    which computes up to 4 rows of a panel of C.
+
+Arguments:
+
+    A - Supplies the address of the first row of A.
+
+    lda - Supplies the leading dimension of A.
+
+    BlockRows - Supplies the row of B of each block of the panel.
+
+    BlockValues - Supplies the 16 values of each block of the panel.
+
+    BlockCount - Supplies the number of blocks of the panel.
+
+    C - Supplies the address of the first column of the panel of C.
+
+    ldc - Supplies the leading dimension of C.
+
+    CountM - Supplies the number of rows of A and C.
+
+    CountN - Supplies the number of columns of the panel, up to 16.
+
+Return Value:
+
+    Returns the number of rows of C that were computed.
+
+--*/
+{
+    constexpr size_t RowCount = 4;
+
+    const size_t Rows = std::min(CountM, RowCount);
+
+    MLAS_FLOAT32X4 Accumulators[RowCount][4];
+
+    for (size_t r = 0; r < RowCount; r++) {
+        for (size_t i = 0; i < 4; i++) {
+            Accumulators[r][i] = MlasZeroFloat32x4();
+        }
+    }
+
+    for (size_t b = 0; b < BlockCount; b++) {
+
+        const float* Values = BlockValues + b * MLAS_SPARSE_GEMM_BLOCK_N;
+        const float* a = A + BlockRows[b];
+
+        MLAS_FLOAT32X4 Values0 = MlasLoadFloat32x4(Values);
+        MLAS_FLOAT32X4 Values1 = MlasLoadFloat32x4(Values + 4);
+        MLAS_FLOAT32X4 Values2 = MlasLoadFloat32x4(Values + 8);
+        MLAS_FLOAT32X4 Values3 = MlasLoadFloat32x4(Values + 12);
+
+        for (size_t r = 0; r < Rows; r++) {
+            MLAS_FLOAT32X4 ABroadcast = MlasBroadcastFloat32x4(a + r * lda);
+            Accumulators[r][0] = MlasMultiplyAddFloat32x4(ABroadcast, Values0, Accumulators[r][0]);
+            Accumulators[r][1] = MlasMultiplyAddFloat32x4(ABroadcast, Values1, Accumulators[r][1]);
+            Accumulators[r][2] = MlasMultiplyAddFloat32x4(ABroadcast, Values2, Accumulators[r][2]);
+            Accumulators[r][3] = MlasMultiplyAddFloat32x4(ABroadcast, Values3, Accumulators[r][3]);
+        }
+    }
+
+    for (size_t r = 0; r < Rows; r++) {
+
+        float* c = C + r * ldc;
+
+        if (CountN == MLAS_SPARSE_GEMM_BLOCK_N) {
+            for (size_t i = 0; i < 4; i++) {
+                MlasStoreFloat32x4(c + i * 4, Accumulators[r][i]);
+            }
+        } else {
+            MLAS_DECLSPEC_ALIGN(float Buffer[MLAS_SPARSE_GEMM_BLOCK_N], 16);
+            for (size_t i = 0; i < 4; i++) {
+                MlasStoreAlignedFloat32x4(Buffer + i * 4, Accumulators[r][i]);
+            }
+            std::copy_n(Buffer, CountN, c);
+        }
+    }
+
+    return Rows;
+}
+
+void
+MlasSparseGemmOperation(
+    const MLAS_SPARSE_GEMM_DATA_PARAMS* Data,
+    size_t StartM,
+    size_t CountM,
+    size_t StartPanel,
+    size_t EndPanel
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a range of rows and panels of C.
+
+--*/
+{
+    MLAS_SPARSE_GEMM_KERNEL* Kernel = GetMlasPlatform().SparseGemmKernel;
+
+    if (Kernel == nullptr) {
+        Kernel = MlasSparseGemmKernel;
+    }
+
+    const auto* Header = static_cast<const MLAS_SPARSE_GEMM_PACKED_HEADER*>(Data->PackedB);
+    const size_t N = size_t(Header->N);
+    const MLAS_SPARSE_GEMM_PACKED_LAYOUT Layout = MlasSparseGemmGetPackedLayout(Data->PackedB);
+
+    const size_t lda = Data->lda;
+    const size_t ldc = Data->ldc;
+
+    for (size_t m = StartM; m < StartM + CountM; m += MLAS_SPARSE_GEMM_STRIDEM) {
+
+        const size_t CountRows = std::min(StartM + CountM - m, MLAS_SPARSE_GEMM_STRIDEM);
+
+        for (size_t p = StartPanel; p < EndPanel; p++) {
+
+            const size_t n = p * MLAS_SPARSE_GEMM_BLOCK_N;
+            const size_t CountN = std::min(N - n, MLAS_SPARSE_GEMM_BLOCK_N);
+            const size_t BlockStart = Layout.PanelOffsets[p];
+            const size_t BlockCount = Layout.PanelOffsets[p + 1] - BlockStart;
+
+            const uint32_t* BlockRows = Layout.BlockRows + BlockStart;
+            const float* BlockValues = Layout.BlockValues + BlockStart * MLAS_SPARSE_GEMM_BLOCK_N;
+
+            const float* a = Data->A + m * lda;
+            float* c = Data->C + m * ldc + n;
+            size_t RowsRemaining = CountRows;
+
+            while (RowsRemaining > 0) {
+
+                const size_t RowsHandled = Kernel(a, lda, BlockRows, BlockValues, BlockCount,
+                                                  c, ldc, RowsRemaining, CountN);
+
+                a += RowsHandled * lda;
+                c += RowsHandled * ldc;
+                RowsRemaining -= RowsHandled;
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasSparseGemmBatch(
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SPARSE_GEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the block sparse matrix/matrix multiply
+    C = A * B for a batch of matrices, where B was packed by
+    MlasSparseGemmPackB for the same N and K.
+
+Arguments:
+
+    M - Supplies the number of rows of A and C.
+
+    N - Supplies the number of columns of B and C.
+
+    K - Supplies the number of columns of A and rows of B.
+
+    Data - Supplies the array of data parameters, one for each multiplication.
+
+    BatchSize - Supplies the number of multiplications.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (M == 0 || N == 0 || BatchSize == 0) {
+        return;
+    }
+
+    MLAS_UNREFERENCED_PARAMETER(K);
+
+    const size_t PanelCount = MlasDivRoundup(N, MLAS_SPARSE_GEMM_BLOCK_N);
+
+    //
+    // Compute the number of target threads given the number of multiply
+    // accumulates that are done for the nonzero blocks. Small requests should
+    // run using the single threaded path.
+    //
+
+    const auto* Header = static_cast<const MLAS_SPARSE_GEMM_PACKED_HEADER*>(Data[0].PackedB);
+    const double Complexity = double(M) * double(Header->BlockCount) *
+                              double(MLAS_SPARSE_GEMM_BLOCK_N) * double(BatchSize);
+
+    ptrdiff_t TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+
+    const ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Split the panels of each multiplication across the threads first, so
+    // that each thread streams its own part of the packed matrix, then split
+    // the rows if there are threads left.
+    //
+
+    size_t ThreadsPerGemm = std::max(size_t(TargetThreadCount) / BatchSize, size_t(1));
+
+    const size_t ThreadCountN = std::min(ThreadsPerGemm, PanelCount);
+    const size_t ThreadCountM = std::min(std::max(ThreadsPerGemm / ThreadCountN, size_t(1)),
+                                         MlasDivRoundup(M, size_t(4)));
+
+    ThreadsPerGemm = ThreadCountM * ThreadCountN;
+
+    const size_t PanelsPerThread = MlasDivRoundup(PanelCount, ThreadCountN);
+    const size_t RowsPerThread = MlasDivRoundup(M, ThreadCountM);
+
+    MlasTrySimpleParallel(ThreadPool, ptrdiff_t(ThreadsPerGemm * BatchSize), [&](ptrdiff_t tid) {
+
+        const size_t GemmIndex = size_t(tid) / ThreadsPerGemm;
+        const size_t BlockIndex = size_t(tid) % ThreadsPerGemm;
+
+        const size_t ThreadIdN = BlockIndex / ThreadCountM;
+        const size_t ThreadIdM = BlockIndex % ThreadCountM;
+
+        const size_t StartM = ThreadIdM * RowsPerThread;
+        const size_t StartPanel = ThreadIdN * PanelsPerThread;
+
+        if (StartM >= M || StartPanel >= PanelCount) {
+            return;
+        }
+
+        const size_t CountM = std::min(M - StartM, RowsPerThread);
+        const size_t EndPanel = std::min(PanelCount, StartPanel + PanelsPerThread);
+
+        MlasSparseGemmOperation(&Data[GemmIndex], StartM, CountM, StartPanel, EndPanel);
+    });
+}
@@ -0,0 +1,138 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sparsegemm_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the block sparse SGEMM kernel for AVX2/FMA3.
+
+    The kernel computes 6 rows of a 16 column panel of C with two vectors of
+    accumulators per row, the same register blocking as the dense FMA3 SGEMM
+    kernel.
+
+--*/
+
+#include <utility>
+
+#include "mlasi.h"
+
+namespace
+{
+
+template <typename IterationFn, size_t... Indices>
+MLAS_FORCEINLINE void
+UnrolledLoopIterations(IterationFn&& f, std::index_sequence<Indices...> /* indices */)
+{
+    (f(Indices), ...);
+}
+
+template <size_t N, typename IterationFn>
+MLAS_FORCEINLINE void
+UnrolledLoop(IterationFn&& f)
+{
+    UnrolledLoopIterations(std::forward<IterationFn>(f), std::make_index_sequence<N>());
+}
+
+MLAS_FORCEINLINE
+__m256i
+StoreMask8(
+    size_t Count
+    )
+{
+    return _mm256_cmpgt_epi32(_mm256_set1_epi32(int(Count)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+template <size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasSparseGemmKernelAvx2Rows(
+    const float* A,
+    size_t lda,
+    const uint32_t* BlockRows,
+    const float* BlockValues,
+    size_t BlockCount,
+    float* C,
+    size_t ldc,
+    size_t CountN
+    )
+{
+    __m256 Accumulators[RowCount][2];
+
+    UnrolledLoop<RowCount>([&](size_t r) {
+        Accumulators[r][0] = _mm256_setzero_ps();
+        Accumulators[r][1] = _mm256_setzero_ps();
+    });
+
+    for (size_t b = 0; b < BlockCount; b++) {
+
+        const __m256 Values0 = _mm256_loadu_ps(BlockValues);
+        const __m256 Values1 = _mm256_loadu_ps(BlockValues + 8);
+        const float* a = A + BlockRows[b];
+
+        UnrolledLoop<RowCount>([&](size_t r) {
+            const __m256 ABroadcast = _mm256_broadcast_ss(a + r * lda);
+            Accumulators[r][0] = _mm256_fmadd_ps(ABroadcast, Values0, Accumulators[r][0]);
+            Accumulators[r][1] = _mm256_fmadd_ps(ABroadcast, Values1, Accumulators[r][1]);
+        });
+
+        BlockValues += 16;
+    }
+
+    if (CountN == 16) {
+        UnrolledLoop<RowCount>([&](size_t r) {
+            _mm256_storeu_ps(C + r * ldc, Accumulators[r][0]);
+            _mm256_storeu_ps(C + r * ldc + 8, Accumulators[r][1]);
+        });
+    } else {
+        const __m256i Mask0 = StoreMask8(CountN);
+        const __m256i Mask1 = StoreMask8(CountN > 8 ? CountN - 8 : 0);
+        UnrolledLoop<RowCount>([&](size_t r) {
+            _mm256_maskstore_ps(C + r * ldc, Mask0, Accumulators[r][0]);
+            _mm256_maskstore_ps(C + r * ldc + 8, Mask1, Accumulators[r][1]);
+        });
+    }
+}
+
+}  // namespace
+
+size_t
+MLASCALL
+MlasSparseGemmKernelAvx2(
+    const float* A,
+    size_t lda,
+    const uint32_t* BlockRows,
+    const float* BlockValues,
+    size_t BlockCount,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN
+    )
+{
+    switch (CountM) {
+        case 1:
+            MlasSparseGemmKernelAvx2Rows<1>(A, lda, BlockRows, BlockValues, BlockCount, C, ldc, CountN);
+            return 1;
+        case 2:
+            MlasSparseGemmKernelAvx2Rows<2>(A, lda, BlockRows, BlockValues, BlockCount, C, ldc, CountN);
+            return 2;
+        case 3:
+            MlasSparseGemmKernelAvx2Rows<3>(A, lda, BlockRows, BlockValues, BlockCount, C, ldc, CountN);
+            return 3;
+        case 4:
+            MlasSparseGemmKernelAvx2Rows<4>(A, lda, BlockRows, BlockValues, BlockCount, C, ldc, CountN);
+            return 4;
+        case 5:
+            MlasSparseGemmKernelAvx2Rows<5>(A, lda, BlockRows, BlockValues, BlockCount, C, ldc, CountN);
+            return 5;
+        default:
+            MlasSparseGemmKernelAvx2Rows<6>(A, lda, BlockRows, BlockValues, BlockCount, C, ldc, CountN);
+            return 6;
+    }
+}
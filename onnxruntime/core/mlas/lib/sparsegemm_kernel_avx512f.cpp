@@ -0,0 +1,113 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sparsegemm_kernel_avx512f.cpp
+
+Abstract:
+
+    This module implements the block sparse SGEMM kernel for AVX512F.
+
+    A block of the packed matrix fills one vector, so the kernel computes 12
+    rows of a 16 column panel of C with one vector of accumulators per row.
+
+--*/
+
+#include <utility>
+
+#include "mlasi.h"
+
+namespace
+{
+
+template <typename IterationFn, size_t... Indices>
+MLAS_FORCEINLINE void
+UnrolledLoopIterations(IterationFn&& f, std::index_sequence<Indices...> /* indices */)
+{
+    (f(Indices), ...);
+}
+
+template <size_t N, typename IterationFn>
+MLAS_FORCEINLINE void
+UnrolledLoop(IterationFn&& f)
+{
+    UnrolledLoopIterations(std::forward<IterationFn>(f), std::make_index_sequence<N>());
+}
+
+template <size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasSparseGemmKernelAvx512FRows(
+    const float* A,
+    size_t lda,
+    const uint32_t* BlockRows,
+    const float* BlockValues,
+    size_t BlockCount,
+    float* C,
+    size_t ldc,
+    size_t CountN
+    )
+{
+    __m512 Accumulators[RowCount];
+
+    UnrolledLoop<RowCount>([&](size_t r) {
+        Accumulators[r] = _mm512_setzero_ps();
+    });
+
+    for (size_t b = 0; b < BlockCount; b++) {
+
+        const __m512 Values = _mm512_loadu_ps(BlockValues);
+        const float* a = A + BlockRows[b];
+
+        UnrolledLoop<RowCount>([&](size_t r) {
+            Accumulators[r] = _mm512_fmadd_ps(_mm512_set1_ps(a[r * lda]), Values, Accumulators[r]);
+        });
+
+        BlockValues += 16;
+    }
+
+    const __mmask16 Mask = __mmask16((1u << CountN) - 1);
+
+    UnrolledLoop<RowCount>([&](size_t r) {
+        _mm512_mask_storeu_ps(C + r * ldc, Mask, Accumulators[r]);
+    });
+}
+
+}  // namespace
+
+size_t
+MLASCALL
+MlasSparseGemmKernelAvx512F(
+    const float* A,
+    size_t lda,
+    const uint32_t* BlockRows,
+    const float* BlockValues,
+    size_t BlockCount,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN
+    )
+{
+    //
+    // Process 12, 8 or 4 rows, the remaining rows are handled one at a time.
+    //
+
+    if (CountM >= 12) {
+        MlasSparseGemmKernelAvx512FRows<12>(A, lda, BlockRows, BlockValues, BlockCount, C, ldc, CountN);
+        return 12;
+    } else if (CountM >= 8) {
+        MlasSparseGemmKernelAvx512FRows<8>(A, lda, BlockRows, BlockValues, BlockCount, C, ldc, CountN);
+        return 8;
+    } else if (CountM >= 4) {
+        MlasSparseGemmKernelAvx512FRows<4>(A, lda, BlockRows, BlockValues, BlockCount, C, ldc, CountN);
+        return 4;
+    } else {
+        MlasSparseGemmKernelAvx512FRows<1>(A, lda, BlockRows, BlockValues, BlockCount, C, ldc, CountN);
+        return 1;
+    }
+}
@@ -0,0 +1,540 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sqnbitgemm_kernel_amx.cpp
+
+Abstract:
+
+    This module implements the float/quantized 4-bit integer matrix
+    multiplication kernel for AMX-INT8, SQNBIT_CompInt8 variant.
+
+    The kernel reads matrix B in the layout packed for the AVX512VNNI kernels.
+    For each call, the 4-bit blocks of the 16 column groups of B are unpacked
+    to int8 tiles, which are then reused by all rows of A. The int32 dot
+    product of each block is scaled by the block scales of A and B and added
+    to float accumulators. The zero points of B are applied afterwards through
+    the block sums, like for the AVX512VNNI kernels.
+
+--*/
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+
+#include "qnbitgemm.h"
+#include "amx_common.h"
+
+#define TMM0 0
+#define TMM1 1
+#define TMM2 2
+#define TMM3 3
+#define TMM4 4
+#define TMM5 5
+#define TMM6 6
+#define TMM7 7
+
+#define TILE_M 16
+#define TILE_N 16
+#define TILE_K 64
+
+namespace
+{
+
+//
+// Offsets of the packed data and scales of matrix B, which follow the layout
+// written by PackQuantB and ComputePackBlkSum for SubBlkLen 128. Columns are
+// interleaved in groups of 4, except for the last partial group.
+//
+
+MLAS_FORCEINLINE size_t
+Q4Int8AmxSubBlkOffset(size_t CountN, size_t n, size_t SubOrBlkCountK, size_t k_sub_or_blk)
+{
+    const size_t T = n / 4, t = n % 4;
+    size_t Offset = T * 4 * SubOrBlkCountK;
+    if (T == CountN / 4) {
+        Offset += t * SubOrBlkCountK + k_sub_or_blk;
+    } else {
+        Offset += k_sub_or_blk * 4 + t;
+    }
+    return Offset;
+}
+
+MLAS_FORCEINLINE size_t
+Q4Int8AmxBlkInSubBlkOffset(size_t CountN, size_t n, size_t BlockCountK, size_t k_blk, size_t BlksPerSub)
+{
+    const size_t T = n / 4, t = n % 4, k_subblk = k_blk / BlksPerSub, b = k_blk % BlksPerSub;
+    size_t Offset = T * 4 * BlockCountK;
+    if (T == CountN / 4) {
+        Offset += t * BlockCountK + k_blk;
+    } else {
+        Offset += k_subblk * BlksPerSub * 4;
+        if (k_subblk == BlockCountK / BlksPerSub) {
+            Offset += b * 4 + t;
+        } else {
+            Offset += t * BlksPerSub + b;
+        }
+    }
+    return Offset;
+}
+
+//
+// The low nibbles of a packed run of bytes hold the first half of the values
+// and the high nibbles hold the second half.
+//
+
+MLAS_FORCEINLINE void
+Q4Int8AmxUnpack64(const std::byte* Src, int8_t* Dst)
+{
+    const __m512i LowMask = _mm512_set1_epi8(0x0F);
+    const __m512i Packed = _mm512_loadu_si512(Src);
+    _mm512_storeu_si512(Dst, _mm512_and_si512(Packed, LowMask));
+    _mm512_storeu_si512(Dst + 64, _mm512_and_si512(_mm512_srli_epi16(Packed, 4), LowMask));
+}
+
+MLAS_FORCEINLINE void
+Q4Int8AmxUnpack32(const std::byte* Src, int8_t* Dst)
+{
+    const __m256i LowMask = _mm256_set1_epi8(0x0F);
+    const __m256i Packed = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Src));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(Dst), _mm256_and_si256(Packed, LowMask));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(Dst + 32), _mm256_and_si256(_mm256_srli_epi16(Packed, 4), LowMask));
+}
+
+MLAS_FORCEINLINE void
+Q4Int8AmxUnpack16(const std::byte* Src, int8_t* Dst)
+{
+    const __m128i LowMask = _mm_set1_epi8(0x0F);
+    const __m128i Packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(Dst), _mm_and_si128(Packed, LowMask));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + 16), _mm_and_si128(_mm_srli_epi16(Packed, 4), LowMask));
+}
+
+MLAS_FORCEINLINE void
+Q4Int8AmxUnpack8(const std::byte* Src, int8_t* Dst)
+{
+    const __m128i LowMask = _mm_set1_epi8(0x0F);
+    const __m128i Packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(Src));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(Dst), _mm_and_si128(Packed, LowMask));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(Dst + 8), _mm_and_si128(_mm_srli_epi16(Packed, 4), LowMask));
+}
+
+/*++
+
+Routine Description:
+
+    This routine unpacks the 4-bit values and block scales of one column of
+    matrix B.
+
+Arguments:
+
+    BlkLen - Supplies the number of values in a block.
+
+    QuantBData - Supplies the packed data of the columns of matrix B.
+
+    QuantBScale - Supplies the packed scales of the columns of matrix B.
+
+    CountN - Supplies the number of columns of matrix B.
+
+    n - Supplies the index of the column to unpack.
+
+    BlockCountK - Supplies the number of blocks in a column.
+
+    Dst - Supplies the output buffer of BlockCountK * BlkLen values.
+
+    DstScale - Supplies the output buffer of BlockCountK scales, which are
+        written with a stride of TILE_N elements.
+
+Return Value:
+
+    None.
+
+--*/
+void
+Q4Int8AmxUnpackColumn(
+    size_t BlkLen,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    size_t CountN,
+    size_t n,
+    size_t BlockCountK,
+    int8_t* Dst,
+    float* DstScale
+)
+{
+    constexpr size_t SubBlkLen = 128;
+    constexpr size_t SubBlkDataSize = SubBlkLen / 2;
+
+    if (BlkLen >= SubBlkLen) {
+        const size_t SubBlkCountK = BlockCountK * BlkLen / SubBlkLen;
+        for (size_t k_subblk = 0; k_subblk < SubBlkCountK; k_subblk++) {
+            const size_t Offset = Q4Int8AmxSubBlkOffset(CountN, n, SubBlkCountK, k_subblk);
+            Q4Int8AmxUnpack64(QuantBData + Offset * SubBlkDataSize, Dst + k_subblk * SubBlkLen);
+        }
+        for (size_t k_blk = 0; k_blk < BlockCountK; k_blk++) {
+            DstScale[k_blk * TILE_N] = QuantBScale[Q4Int8AmxSubBlkOffset(CountN, n, BlockCountK, k_blk)];
+        }
+    } else if (BlkLen == 16) {
+        //
+        // Full sub-blocks of a column are stored contiguously, the blocks of
+        // a trailing partial sub-block are stored one by one.
+        //
+        const std::byte* ColumnData = QuantBData + n * BlockCountK * (BlkLen / 2);
+        const size_t FullSubBlkCountK = BlockCountK * BlkLen / SubBlkLen;
+        for (size_t k_subblk = 0; k_subblk < FullSubBlkCountK; k_subblk++) {
+            Q4Int8AmxUnpack64(ColumnData + k_subblk * SubBlkDataSize, Dst + k_subblk * SubBlkLen);
+        }
+        for (size_t k_blk = FullSubBlkCountK * SubBlkLen / BlkLen; k_blk < BlockCountK; k_blk++) {
+            Q4Int8AmxUnpack8(ColumnData + k_blk * (BlkLen / 2), Dst + k_blk * BlkLen);
+        }
+        for (size_t k_blk = 0; k_blk < BlockCountK; k_blk++) {
+            DstScale[k_blk * TILE_N] = QuantBScale[n * BlockCountK + k_blk];
+        }
+    } else {
+        //
+        // Full sub-blocks are packed as a whole at the offset of their first
+        // block, the blocks of a trailing partial sub-block are packed one by
+        // one.
+        //
+        const size_t BlksPerSub = SubBlkLen / BlkLen;
+        const size_t FullSubBlkCountK = BlockCountK / BlksPerSub;
+        for (size_t k_subblk = 0; k_subblk < FullSubBlkCountK; k_subblk++) {
+            const size_t Offset = Q4Int8AmxBlkInSubBlkOffset(CountN, n, BlockCountK, k_subblk * BlksPerSub, BlksPerSub);
+            Q4Int8AmxUnpack64(QuantBData + Offset * (BlkLen / 2), Dst + k_subblk * SubBlkLen);
+        }
+        for (size_t k_blk = FullSubBlkCountK * BlksPerSub; k_blk < BlockCountK; k_blk++) {
+            const size_t Offset = Q4Int8AmxBlkInSubBlkOffset(CountN, n, BlockCountK, k_blk, BlksPerSub);
+            if (BlkLen == 64) {
+                Q4Int8AmxUnpack32(QuantBData + Offset * (BlkLen / 2), Dst + k_blk * BlkLen);
+            } else {
+                Q4Int8AmxUnpack16(QuantBData + Offset * (BlkLen / 2), Dst + k_blk * BlkLen);
+            }
+        }
+        for (size_t k_blk = 0; k_blk < BlockCountK; k_blk++) {
+            DstScale[k_blk * TILE_N] = QuantBScale[Q4Int8AmxBlkInSubBlkOffset(CountN, n, BlockCountK, k_blk, BlksPerSub)];
+        }
+    }
+}
+
+/*++
+
+Routine Description:
+
+    This routine transposes 16 rows of 64 int8 values into the layout of a B
+    tile, where each row of the tile holds 4 consecutive values of each of the
+    16 columns.
+
+--*/
+MLAS_FORCEINLINE void
+Q4Int8AmxTransposeTile(const int8_t* Src, size_t ldsrc, int8_t* Dst)
+{
+    __m512i r[16];
+    __m512i t[16];
+
+    for (size_t i = 0; i < 16; i++) {
+        r[i] = _mm512_loadu_si512(Src + i * ldsrc);
+    }
+
+    for (size_t i = 0; i < 16; i += 2) {
+        t[i] = _mm512_unpacklo_epi32(r[i], r[i + 1]);
+        t[i + 1] = _mm512_unpackhi_epi32(r[i], r[i + 1]);
+    }
+
+    for (size_t i = 0; i < 16; i += 4) {
+        r[i] = _mm512_unpacklo_epi64(t[i], t[i + 2]);
+        r[i + 1] = _mm512_unpackhi_epi64(t[i], t[i + 2]);
+        r[i + 2] = _mm512_unpacklo_epi64(t[i + 1], t[i + 3]);
+        r[i + 3] = _mm512_unpackhi_epi64(t[i + 1], t[i + 3]);
+    }
+
+    //
+    // Each 128-bit lane L of r[4 * i + j] now holds column 4 * L + j of rows
+    // 4 * i through 4 * i + 3.
+    //
+
+    for (size_t j = 0; j < 4; j++) {
+        const __m512i a = _mm512_shuffle_i32x4(r[j], r[4 + j], 0x88);
+        const __m512i b = _mm512_shuffle_i32x4(r[8 + j], r[12 + j], 0x88);
+        const __m512i c = _mm512_shuffle_i32x4(r[j], r[4 + j], 0xDD);
+        const __m512i d = _mm512_shuffle_i32x4(r[8 + j], r[12 + j], 0xDD);
+        _mm512_store_si512(Dst + j * 64, _mm512_shuffle_i32x4(a, b, 0x88));
+        _mm512_store_si512(Dst + (4 + j) * 64, _mm512_shuffle_i32x4(c, d, 0x88));
+        _mm512_store_si512(Dst + (8 + j) * 64, _mm512_shuffle_i32x4(a, b, 0xDD));
+        _mm512_store_si512(Dst + (12 + j) * 64, _mm512_shuffle_i32x4(c, d, 0xDD));
+    }
+}
+
+void
+Q4Int8AmxTileConfig(size_t TileK)
+{
+    //
+    // Tiles 0-3 accumulate 16x16 int32 outputs, tiles 4-5 hold 16 rows of A
+    // and tiles 6-7 hold TileK / 4 rows of 16 columns of B.
+    //
+
+    struct tileconfig_t tc = {0};
+    tc.palette_id = 1;
+    for (int t = 0; t < 8; t++) {
+        tc.rows[t] = TILE_M;
+        tc.colb[t] = TILE_N * sizeof(int32_t);
+    }
+    for (int t = 4; t < 6; t++) {
+        tc.colb[t] = uint16_t(TileK);
+    }
+    for (int t = 6; t < 8; t++) {
+        tc.rows[t] = uint8_t(TileK / 4);
+    }
+
+    struct tileconfig_t current_tc = {0};
+    tile_storeconfig(&current_tc);
+
+    if (std::memcmp(&current_tc, &tc, sizeof(tc)) != 0) {
+        tile_loadconfig(&tc);
+    }
+}
+
+MLAS_FORCEINLINE void
+Q4Int8AmxAccumulateTile(
+    const int32_t* Tile,
+    const float* QuantAScale,
+    size_t BlockCountK,
+    const float* QuantBScale,
+    float* Acc,
+    size_t CountM
+)
+{
+    const __m512 BScale = _mm512_load_ps(QuantBScale);
+
+    for (size_t r = 0; r < CountM; r++) {
+        const __m512 Product = _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_load_si512(Tile + r * TILE_N)), BScale);
+        float* acc = Acc + r * 2 * TILE_N;
+        _mm512_store_ps(acc, _mm512_fmadd_ps(Product, _mm512_set1_ps(QuantAScale[r * BlockCountK]), _mm512_load_ps(acc)));
+    }
+}
+
+MLAS_FORCEINLINE void
+Q4Int8AmxStoreTile(const float* Acc, float* C, size_t ldc, size_t CountM, size_t CountN, const float* Bias)
+{
+    const __mmask16 Mask = __mmask16((1u << CountN) - 1);
+    const __m512 bias = (Bias != nullptr) ? _mm512_maskz_loadu_ps(Mask, Bias) : _mm512_setzero_ps();
+
+    for (size_t r = 0; r < CountM; r++) {
+        _mm512_mask_storeu_ps(C + r * ldc, Mask, _mm512_add_ps(_mm512_load_ps(Acc + r * 2 * TILE_N), bias));
+    }
+}
+
+}  // namespace
+
+size_t
+SQ4BitGemmKernel_BlkSum_CompInt8_amx(
+    const size_t BlkLen,
+    const std::byte* QuantA,
+    const float* QuantAScale,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* /*QuantBZeroPoint*/,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t /*CountK*/,
+    size_t BlockCountK,
+    const float* Bias,
+    size_t ldc,
+    const float* ABlockSum,
+    const float* QuantBBlkSum
+)
+{
+    const size_t lda = BlockCountK * BlkLen;
+    const size_t AlignedK = (lda + TILE_K - 1) & ~size_t(TILE_K - 1);
+    const size_t TileK = std::min(BlkLen, size_t(TILE_K));
+    const size_t GroupCount = MlasDivRoundup(CountN, TILE_N);
+
+    //
+    // The per thread buffer holds the unpacked tiles of B, the scales of B
+    // arranged by block and column, one group of unpacked columns of B and a
+    // copy of a partial tile of rows of A.
+    //
+
+    const size_t TilesBSize = GroupCount * AlignedK * TILE_N;
+    const size_t ScaleBSize = UpAlignSize(GroupCount * BlockCountK * TILE_N * sizeof(float));
+    const size_t ColumnsBSize = TILE_N * AlignedK;
+    const size_t RowsASize = TILE_M * lda;
+
+    MlasThreadedBufAlloc(TilesBSize + ScaleBSize + ColumnsBSize + RowsASize);
+    int8_t* TilesB = reinterpret_cast<int8_t*>(ThreadedBufHolder.get());
+    float* ScaleB = reinterpret_cast<float*>(TilesB + TilesBSize);
+    int8_t* ColumnsB = reinterpret_cast<int8_t*>(ScaleB) + ScaleBSize;
+    int8_t* RowsA = ColumnsB + ColumnsBSize;
+
+    for (size_t g = 0; g < GroupCount; g++) {
+        const size_t CountCols = std::min(CountN - g * TILE_N, size_t(TILE_N));
+        float* scale = ScaleB + g * BlockCountK * TILE_N;
+
+        if (CountCols < TILE_N) {
+            std::memset(ColumnsB, 0, ColumnsBSize);
+            std::fill_n(scale, BlockCountK * TILE_N, 0.0f);
+        } else if (AlignedK > lda) {
+            for (size_t c = 0; c < TILE_N; c++) {
+                std::memset(ColumnsB + c * AlignedK + lda, 0, AlignedK - lda);
+            }
+        }
+
+        for (size_t c = 0; c < CountCols; c++) {
+            Q4Int8AmxUnpackColumn(BlkLen, QuantBData, QuantBScale, CountN, g * TILE_N + c, BlockCountK,
+                                  ColumnsB + c * AlignedK, scale + c);
+        }
+
+        for (size_t k = 0; k < AlignedK; k += TILE_K) {
+            Q4Int8AmxTransposeTile(ColumnsB + k, AlignedK, TilesB + (g * AlignedK + k) * TILE_N);
+        }
+    }
+
+    Q4Int8AmxTileConfig(TileK);
+
+    MLAS_DECLSPEC_ALIGN(int32_t Tiles[4][TILE_M * TILE_N], 64);
+    MLAS_DECLSPEC_ALIGN(float Acc[2 * TILE_M * 2 * TILE_N], 64);
+
+    for (size_t m = 0; m < CountM; m += 2 * TILE_M) {
+        const size_t CountRows0 = std::min(CountM - m, size_t(TILE_M));
+        const size_t CountRows1 = (CountM - m > TILE_M) ? std::min(CountM - m - TILE_M, size_t(TILE_M)) : 0;
+
+        //
+        // A partial tile of rows is copied so the tile loads stay in bounds.
+        //
+
+        const int8_t* a0 = reinterpret_cast<const int8_t*>(QuantA) + m * lda;
+        const int8_t* a1 = a0 + TILE_M * lda;
+
+        if (CountRows0 < TILE_M) {
+            std::memcpy(RowsA, a0, CountRows0 * lda);
+            std::memset(RowsA + CountRows0 * lda, 0, (TILE_M - CountRows0) * lda);
+            a0 = RowsA;
+        } else if (CountRows1 > 0 && CountRows1 < TILE_M) {
+            std::memcpy(RowsA, a1, CountRows1 * lda);
+            std::memset(RowsA + CountRows1 * lda, 0, (TILE_M - CountRows1) * lda);
+            a1 = RowsA;
+        }
+
+        const float* a_scale0 = QuantAScale + m * BlockCountK;
+        const float* a_scale1 = a_scale0 + TILE_M * BlockCountK;
+
+        for (size_t g = 0; g < GroupCount; g += 2) {
+            const size_t CountCols0 = std::min(CountN - g * TILE_N, size_t(TILE_N));
+            const size_t CountCols1 = (g + 1 < GroupCount) ? std::min(CountN - (g + 1) * TILE_N, size_t(TILE_N)) : 0;
+            const int8_t* b0 = TilesB + g * AlignedK * TILE_N;
+            const int8_t* b1 = b0 + AlignedK * TILE_N;
+            const float* b_scale0 = ScaleB + g * BlockCountK * TILE_N;
+            const float* b_scale1 = b_scale0 + BlockCountK * TILE_N;
+
+            std::fill_n(Acc, 2 * TILE_M * 2 * TILE_N, 0.0f);
+
+            //
+            // The tile instructions access memory through inline assembly
+            // that the compiler does not see.
+            //
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+
+            for (size_t k_blk = 0; k_blk < BlockCountK; k_blk++) {
+                tile_zero(TMM0);
+                if (CountCols1 > 0) {
+                    tile_zero(TMM1);
+                }
+                if (CountRows1 > 0) {
+                    tile_zero(TMM2);
+                    if (CountCols1 > 0) {
+                        tile_zero(TMM3);
+                    }
+                }
+
+                for (size_t k = k_blk * BlkLen; k < (k_blk + 1) * BlkLen; k += TileK) {
+                    tile_loadd(TMM4, a0 + k, lda);
+                    tile_loadd(TMM6, b0 + k * TILE_N, TILE_N * 4);
+                    tile_dpbsud(TMM0, TMM4, TMM6);
+                    if (CountCols1 > 0) {
+                        tile_loadd(TMM7, b1 + k * TILE_N, TILE_N * 4);
+                        tile_dpbsud(TMM1, TMM4, TMM7);
+                    }
+                    if (CountRows1 > 0) {
+                        tile_loadd(TMM5, a1 + k, lda);
+                        tile_dpbsud(TMM2, TMM5, TMM6);
+                        if (CountCols1 > 0) {
+                            tile_dpbsud(TMM3, TMM5, TMM7);
+                        }
+                    }
+                }
+
+                tile_stored(TMM0, Tiles[0], TILE_N * sizeof(int32_t));
+                if (CountCols1 > 0) {
+                    tile_stored(TMM1, Tiles[1], TILE_N * sizeof(int32_t));
+                }
+                if (CountRows1 > 0) {
+                    tile_stored(TMM2, Tiles[2], TILE_N * sizeof(int32_t));
+                    if (CountCols1 > 0) {
+                        tile_stored(TMM3, Tiles[3], TILE_N * sizeof(int32_t));
+                    }
+                }
+
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+
+                Q4Int8AmxAccumulateTile(Tiles[0], a_scale0 + k_blk, BlockCountK, b_scale0 + k_blk * TILE_N,
+                                        Acc, CountRows0);
+                if (CountCols1 > 0) {
+                    Q4Int8AmxAccumulateTile(Tiles[1], a_scale0 + k_blk, BlockCountK, b_scale1 + k_blk * TILE_N,
+                                            Acc + TILE_N, CountRows0);
+                }
+                if (CountRows1 > 0) {
+                    float* acc1 = Acc + TILE_M * 2 * TILE_N;
+                    Q4Int8AmxAccumulateTile(Tiles[2], a_scale1 + k_blk, BlockCountK, b_scale0 + k_blk * TILE_N,
+                                            acc1, CountRows1);
+                    if (CountCols1 > 0) {
+                        Q4Int8AmxAccumulateTile(Tiles[3], a_scale1 + k_blk, BlockCountK, b_scale1 + k_blk * TILE_N,
+                                                acc1 + TILE_N, CountRows1);
+                    }
+                }
+
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+            }
+
+            float* c = C + m * ldc + g * TILE_N;
+            const float* bias = (Bias == nullptr) ? nullptr : Bias + g * TILE_N;
+
+            Q4Int8AmxStoreTile(Acc, c, ldc, CountRows0, CountCols0, bias);
+            if (CountCols1 > 0) {
+                Q4Int8AmxStoreTile(Acc + TILE_N, c + TILE_N, ldc, CountRows0, CountCols1,
+                                   bias == nullptr ? nullptr : bias + TILE_N);
+            }
+            if (CountRows1 > 0) {
+                const float* acc1 = Acc + TILE_M * 2 * TILE_N;
+                Q4Int8AmxStoreTile(acc1, c + TILE_M * ldc, ldc, CountRows1, CountCols0, bias);
+                if (CountCols1 > 0) {
+                    Q4Int8AmxStoreTile(acc1 + TILE_N, c + TILE_M * ldc + TILE_N, ldc, CountRows1, CountCols1,
+                                       bias == nullptr ? nullptr : bias + TILE_N);
+                }
+            }
+        }
+    }
+
+    //
+    // Apply the zero points of B through the block sums of A and B.
+    //
+
+    float* c_blk = C;
+    const float* a_blksum_row = ABlockSum;
+    size_t RowsRemaining = CountM;
+    while (RowsRemaining > 0) {
+        auto RowsHandled = GetMlasPlatform().GemmFloatKernel(
+            a_blksum_row, QuantBBlkSum, c_blk, BlockCountK, RowsRemaining, CountN, BlockCountK, ldc, 1.f, false
+        );
+
+        c_blk += ldc * RowsHandled;
+        a_blksum_row += BlockCountK * RowsHandled;
+        RowsRemaining -= RowsHandled;
+    }
+
+    return CountM;
+}
@@ -355,3 +355,39 @@ const MLAS_QNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx512vnni = []() {
 
     return d;
 }();
+
+#if !defined(__APPLE__)
+
+size_t
+SQ4BitGemmKernel_BlkSum_CompInt8_amx(
+    size_t BlkLen,
+    const std::byte* QuantA,
+    const float* QuantAScale,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK,
+    const float* Bias,
+    size_t ldc,
+    const float* ABlockSum,
+    const float* QuantBBlkSum
+);
+
+//
+// The AMX dispatch shares the packed layout of matrix B with the AVX512VNNI
+// dispatch and adds the tile kernel for calls with many rows of A.
+//
+const MLAS_QNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx512vnniAmx = []() {
+    MLAS_QNBIT_GEMM_DISPATCH d = MlasSQNBitGemmDispatchAvx512vnni;
+
+    d.SQ4BitGemmTileKernel_BlkSum_CompInt8 = SQ4BitGemmKernel_BlkSum_CompInt8_amx;
+    d.SQ4BitGemmTileKernelMinimumM = 16;
+
+    return d;
+}();
+
+#endif
@@ -0,0 +1,446 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    transcendental.cpp
+
+Abstract:
+
+    This module implements routines to compute the log, sine, cosine, square
+    root, reciprocal and power functions.
+
+    The implementation below targets the base instruction set (typically SSE2
+    or NEON) through the MLAS_FLOAT32X4 wrappers, while the AVX2 and AVX512F
+    kernels instantiate the same algorithms from transcendental.h. The power
+    function needs double precision intermediates, which the wrappers do not
+    provide for every platform, so the base kernel evaluates it one element at
+    a time.
+
+--*/
+
+#include "transcendental.h"
+
+struct MLAS_TRANSCENDENTAL_F32_KERNEL_GENERIC {
+    static constexpr size_t Width = 4;
+
+    using FloatVector = MLAS_FLOAT32X4;
+    using IntVector = MLAS_INT32X4;
+    using Mask = MLAS_FLOAT32X4;
+
+    static MLAS_FORCEINLINE FloatVector LoadFloat(const float* Buffer) { return MlasLoadFloat32x4(Buffer); }
+    static MLAS_FORCEINLINE void StoreFloat(float* Buffer, FloatVector Vector) { MlasStoreFloat32x4(Buffer, Vector); }
+    static MLAS_FORCEINLINE FloatVector BroadcastFloat(float Value) { return MlasBroadcastFloat32x4(Value); }
+    static MLAS_FORCEINLINE IntVector BroadcastInt(int32_t Value) { return MlasBroadcastInt32x4(Value); }
+
+    static MLAS_FORCEINLINE FloatVector Add(FloatVector a, FloatVector b) { return MlasAddFloat32x4(a, b); }
+    static MLAS_FORCEINLINE FloatVector Subtract(FloatVector a, FloatVector b) { return MlasSubtractFloat32x4(a, b); }
+    static MLAS_FORCEINLINE FloatVector Multiply(FloatVector a, FloatVector b) { return MlasMultiplyFloat32x4(a, b); }
+    static MLAS_FORCEINLINE FloatVector MultiplyAdd(FloatVector a, FloatVector b, FloatVector c) { return MlasMultiplyAddFloat32x4(a, b, c); }
+    static MLAS_FORCEINLINE FloatVector Divide(FloatVector a, FloatVector b) { return MlasDivideFloat32x4(a, b); }
+    static MLAS_FORCEINLINE FloatVector Sqrt(FloatVector a) { return MlasSqrtFloat32x4(a); }
+    static MLAS_FORCEINLINE FloatVector And(FloatVector a, FloatVector b) { return MlasAndFloat32x4(a, b); }
+    static MLAS_FORCEINLINE FloatVector Xor(FloatVector a, FloatVector b) { return MlasXorFloat32x4(a, b); }
+
+    static MLAS_FORCEINLINE IntVector ReinterpretAsInt(FloatVector a) { return MlasReinterpretAsInt32x4(a); }
+    static MLAS_FORCEINLINE FloatVector ReinterpretAsFloat(IntVector a) { return MlasReinterpretAsFloat32x4(a); }
+    static MLAS_FORCEINLINE FloatVector CastToFloat(IntVector a) { return MlasCastToFloat32x4(a); }
+    static MLAS_FORCEINLINE IntVector IntAnd(IntVector a, IntVector b) { return MlasAndInt32x4(a, b); }
+    static MLAS_FORCEINLINE IntVector IntOr(IntVector a, IntVector b) { return MlasOrInt32x4(a, b); }
+    static MLAS_FORCEINLINE IntVector IntAdd(IntVector a, IntVector b) { return MlasAddInt32x4(a, b); }
+
+    template<unsigned ShiftCount>
+    static MLAS_FORCEINLINE IntVector IntShiftLeft(IntVector a) { return MlasShiftLeftInt32x4<ShiftCount>(a); }
+
+    static MLAS_FORCEINLINE Mask GreaterThan(FloatVector a, FloatVector b) { return MlasGreaterThanFloat32x4(a, b); }
+    static MLAS_FORCEINLINE Mask MaskOr(Mask a, Mask b) { return MlasOrFloat32x4(a, b); }
+    static MLAS_FORCEINLINE Mask MaskNot(Mask a) { return MlasXorFloat32x4(a, ReinterpretAsFloat(BroadcastInt(-1))); }
+    static MLAS_FORCEINLINE FloatVector Blend(FloatVector a, FloatVector b, Mask m) { return MlasBlendFloat32x4(a, b, m); }
+
+    static
+    MLAS_FORCEINLINE
+    Mask
+    MaskFromLowBit(
+        IntVector a
+        )
+    {
+        return ReinterpretAsFloat(MlasSubtractInt32x4(BroadcastInt(0), IntAnd(a, BroadcastInt(1))));
+    }
+
+    static
+    MLAS_FORCEINLINE
+    bool
+    MaskAny(
+        Mask m
+        )
+    {
+        int32_t Lanes[4];
+        MlasStoreInt32x4(Lanes, ReinterpretAsInt(m));
+        return (Lanes[0] | Lanes[1] | Lanes[2] | Lanes[3]) != 0;
+    }
+};
+
+struct MLAS_TRANSCENDENTAL_F64_KERNEL_GENERIC {
+    static constexpr size_t Width = 1;
+
+    using DoubleVector = double;
+    using IntVector = uint64_t;
+    using Mask = bool;
+
+    static MLAS_FORCEINLINE DoubleVector LoadFloat(const float* Buffer) { return double(*Buffer); }
+    static MLAS_FORCEINLINE void StoreFloat(float* Buffer, DoubleVector Vector) { *Buffer = float(Vector); }
+    static MLAS_FORCEINLINE DoubleVector BroadcastDouble(double Value) { return Value; }
+    static MLAS_FORCEINLINE IntVector BroadcastInt(uint64_t Value) { return Value; }
+
+    static MLAS_FORCEINLINE DoubleVector Add(DoubleVector a, DoubleVector b) { return a + b; }
+    static MLAS_FORCEINLINE DoubleVector Subtract(DoubleVector a, DoubleVector b) { return a - b; }
+    static MLAS_FORCEINLINE DoubleVector Multiply(DoubleVector a, DoubleVector b) { return a * b; }
+    static MLAS_FORCEINLINE DoubleVector MultiplyAdd(DoubleVector a, DoubleVector b, DoubleVector c) { return a * b + c; }
+    static MLAS_FORCEINLINE DoubleVector Divide(DoubleVector a, DoubleVector b) { return a / b; }
+    static MLAS_FORCEINLINE DoubleVector Maximum(DoubleVector a, DoubleVector b) { return a > b ? a : b; }
+    static MLAS_FORCEINLINE DoubleVector Minimum(DoubleVector a, DoubleVector b) { return a < b ? a : b; }
+
+    static
+    MLAS_FORCEINLINE
+    IntVector
+    ReinterpretAsInt(
+        DoubleVector a
+        )
+    {
+        IntVector Bits;
+        std::memcpy(&Bits, &a, sizeof(Bits));
+        return Bits;
+    }
+
+    static
+    MLAS_FORCEINLINE
+    DoubleVector
+    ReinterpretAsDouble(
+        IntVector a
+        )
+    {
+        DoubleVector Value;
+        std::memcpy(&Value, &a, sizeof(Value));
+        return Value;
+    }
+
+    static MLAS_FORCEINLINE DoubleVector And(DoubleVector a, DoubleVector b) { return ReinterpretAsDouble(ReinterpretAsInt(a) & ReinterpretAsInt(b)); }
+    static MLAS_FORCEINLINE DoubleVector AndNot(DoubleVector a, DoubleVector b) { return ReinterpretAsDouble(~ReinterpretAsInt(a) & ReinterpretAsInt(b)); }
+    static MLAS_FORCEINLINE DoubleVector Or(DoubleVector a, DoubleVector b) { return ReinterpretAsDouble(ReinterpretAsInt(a) | ReinterpretAsInt(b)); }
+    static MLAS_FORCEINLINE DoubleVector Xor(DoubleVector a, DoubleVector b) { return ReinterpretAsDouble(ReinterpretAsInt(a) ^ ReinterpretAsInt(b)); }
+
+    static MLAS_FORCEINLINE IntVector IntAnd(IntVector a, IntVector b) { return a & b; }
+    static MLAS_FORCEINLINE IntVector IntOr(IntVector a, IntVector b) { return a | b; }
+    static MLAS_FORCEINLINE IntVector IntAdd(IntVector a, IntVector b) { return a + b; }
+    static MLAS_FORCEINLINE IntVector IntSubtract(IntVector a, IntVector b) { return a - b; }
+
+    template<unsigned ShiftCount>
+    static MLAS_FORCEINLINE IntVector IntShiftLeft(IntVector a) { return a << ShiftCount; }
+
+    template<unsigned ShiftCount>
+    static MLAS_FORCEINLINE IntVector IntShiftRight(IntVector a) { return a >> ShiftCount; }
+
+    static MLAS_FORCEINLINE Mask Equal(DoubleVector a, DoubleVector b) { return a == b; }
+    static MLAS_FORCEINLINE Mask GreaterThan(DoubleVector a, DoubleVector b) { return a > b; }
+    static MLAS_FORCEINLINE Mask IsNan(DoubleVector a) { return a != a; }
+    static MLAS_FORCEINLINE Mask MaskAnd(Mask a, Mask b) { return a && b; }
+    static MLAS_FORCEINLINE Mask MaskOr(Mask a, Mask b) { return a || b; }
+    static MLAS_FORCEINLINE Mask MaskNot(Mask a) { return !a; }
+    static MLAS_FORCEINLINE DoubleVector Blend(DoubleVector a, DoubleVector b, Mask m) { return m ? b : a; }
+};
+
+void
+MLASCALL
+MlasComputeLogF32Kernel(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+{
+    using KernelType = MLAS_TRANSCENDENTAL_F32_KERNEL_GENERIC;
+
+    MlasTranscendentalKernel<KernelType, MLAS_LOG_OPERATION<KernelType>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputeSinF32Kernel(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+{
+    using KernelType = MLAS_TRANSCENDENTAL_F32_KERNEL_GENERIC;
+
+    MlasTranscendentalKernel<KernelType, MLAS_SINCOS_OPERATION<KernelType, false>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputeCosF32Kernel(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+{
+    using KernelType = MLAS_TRANSCENDENTAL_F32_KERNEL_GENERIC;
+
+    MlasTranscendentalKernel<KernelType, MLAS_SINCOS_OPERATION<KernelType, true>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputeSqrtF32Kernel(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+{
+    using KernelType = MLAS_TRANSCENDENTAL_F32_KERNEL_GENERIC;
+
+    MlasTranscendentalKernel<KernelType, MLAS_SQRT_OPERATION<KernelType>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputeReciprocalF32Kernel(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+{
+    using KernelType = MLAS_TRANSCENDENTAL_F32_KERNEL_GENERIC;
+
+    MlasTranscendentalKernel<KernelType, MLAS_RECIPROCAL_OPERATION<KernelType>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputePowF32Kernel(
+    const float* Base,
+    const float* Exponent,
+    float* Output,
+    size_t N,
+    bool ScalarBase,
+    bool ScalarExponent
+    )
+{
+    MlasPowKernel<MLAS_TRANSCENDENTAL_F64_KERNEL_GENERIC>(Base, Exponent, Output, N, ScalarBase, ScalarExponent);
+}
+
+void
+MLASCALL
+MlasComputeLog(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the natural logarithm function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    GetMlasPlatform().ComputeLogF32Kernel(Input, Output, N);
+#else
+    MlasComputeLogF32Kernel(Input, Output, N);
+#endif
+}
+
+void
+MLASCALL
+MlasComputeSin(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the sine function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    GetMlasPlatform().ComputeSinF32Kernel(Input, Output, N);
+#else
+    MlasComputeSinF32Kernel(Input, Output, N);
+#endif
+}
+
+void
+MLASCALL
+MlasComputeCos(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the cosine function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    GetMlasPlatform().ComputeCosF32Kernel(Input, Output, N);
+#else
+    MlasComputeCosF32Kernel(Input, Output, N);
+#endif
+}
+
+void
+MLASCALL
+MlasComputeSqrt(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the square root function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    GetMlasPlatform().ComputeSqrtF32Kernel(Input, Output, N);
+#else
+    MlasComputeSqrtF32Kernel(Input, Output, N);
+#endif
+}
+
+void
+MLASCALL
+MlasComputeReciprocal(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the reciprocal function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    GetMlasPlatform().ComputeReciprocalF32Kernel(Input, Output, N);
+#else
+    MlasComputeReciprocalF32Kernel(Input, Output, N);
+#endif
+}
+
+void
+MLASCALL
+MlasComputePow(
+    const float* Base,
+    const float* Exponent,
+    float* Output,
+    size_t N,
+    bool ScalarBase,
+    bool ScalarExponent
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the power function.
+
+Arguments:
+
+    Base - Supplies the base buffer, or a single value if ScalarBase is true.
+
+    Exponent - Supplies the exponent buffer, or a single value if
+        ScalarExponent is true.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    ScalarBase - Supplies true if Base is broadcast to every element.
+
+    ScalarExponent - Supplies true if Exponent is broadcast to every element.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    GetMlasPlatform().ComputePowF32Kernel(Base, Exponent, Output, N, ScalarBase, ScalarExponent);
+#else
+    MlasComputePowF32Kernel(Base, Exponent, Output, N, ScalarBase, ScalarExponent);
+#endif
+}
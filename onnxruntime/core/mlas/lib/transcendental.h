@@ -0,0 +1,671 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    transcendental.h
+
+Abstract:
+
+    This module contains the vectorized implementations of the log, sine,
+    cosine, square root, reciprocal and power functions.
+
+    The algorithms are written once against a kernel type that supplies the
+    vector operations of an instruction set (MLAS_FLOAT32X4 for the generic
+    kernels, AVX2 and AVX512F for the x64 kernels). The tail of a buffer is
+    processed by staging the remaining elements through a local vector so that
+    every element takes the same code path.
+
+    The maximum errors measured against the correctly rounded result are:
+
+        Log         1 ulp
+        Sin, Cos    2 ulp for |x| <= 4096, larger arguments use the C runtime
+        Sqrt        0.5 ulp (correctly rounded)
+        Reciprocal  0.5 ulp (correctly rounded)
+        Pow         1 ulp
+
+    A float kernel type provides:
+
+        Width, FloatVector, IntVector, Mask
+        LoadFloat, StoreFloat, BroadcastFloat, BroadcastInt
+        Add, Subtract, Multiply, MultiplyAdd, Divide, Sqrt, And, Xor
+        ReinterpretAsInt, ReinterpretAsFloat, CastToFloat
+        IntAnd, IntOr, IntAdd, IntShiftLeft<N>
+        GreaterThan, MaskOr, MaskNot, MaskAny, MaskFromLowBit, Blend
+
+    The power function evaluates the logarithm and exponential in double
+    precision, so its kernel type supplies the same operations on a vector of
+    doubles with 64-bit integer lanes, plus loads and stores that convert from
+    and to single precision.
+
+--*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "mlasi.h"
+
+//
+// Log: the argument is reduced to 2^e * m with m in [sqrt(1/2), sqrt(2)) and
+// log(m) is evaluated with the minimax polynomial from Cephes logf.
+//
+
+struct MLAS_LOG_CONSTANTS {
+    static constexpr float MinimumNormal = 1.17549435e-38f;
+    static constexpr float DenormalScale = 8388608.0f;
+    static constexpr float Sqrt2 = 1.41421356f;
+    static constexpr float Log2High = 0.693359375f;
+    static constexpr float Log2Low = -2.12194440e-4f;
+    static constexpr float poly_0 = 7.0376836292e-2f;
+    static constexpr float poly_1 = -1.1514610310e-1f;
+    static constexpr float poly_2 = 1.1676998740e-1f;
+    static constexpr float poly_3 = -1.2420140846e-1f;
+    static constexpr float poly_4 = 1.4249322787e-1f;
+    static constexpr float poly_5 = -1.6668057665e-1f;
+    static constexpr float poly_6 = 2.0000714765e-1f;
+    static constexpr float poly_7 = -2.4999993993e-1f;
+    static constexpr float poly_8 = 3.3333331174e-1f;
+};
+
+//
+// Sin/Cos: the argument is reduced by the nearest multiple of pi/2 using a
+// four part Cody-Waite split. The first three parts have 12 significant bits,
+// so the products with the quadrant index are exact for |x| <= Limit and the
+// reduction does not depend on a fused multiply add.
+//
+
+struct MLAS_SINCOS_CONSTANTS {
+    static constexpr float Limit = 4096.0f;
+    static constexpr float TwoOverPi = 0.636619772f;
+    static constexpr float RoundingBias = MLAS_ROUNDING_BIAS_MAGIC;
+    static constexpr float PiOver2_0 = 0x1.922p+0f;
+    static constexpr float PiOver2_1 = -0x1.2aep-18f;
+    static constexpr float PiOver2_2 = -0x1.dea0p-31f;
+    static constexpr float PiOver2_3 = 0x1.184698p-44f;
+    static constexpr float sin_0 = -1.9515295891e-4f;
+    static constexpr float sin_1 = 8.3321608736e-3f;
+    static constexpr float sin_2 = -1.6666654611e-1f;
+    static constexpr float cos_0 = 2.443315711809948e-5f;
+    static constexpr float cos_1 = -1.388731625493765e-3f;
+    static constexpr float cos_2 = 4.166664568298827e-2f;
+};
+
+//
+// Pow: log2(|x|) is evaluated in double precision from the atanh series of
+// the reduced mantissa, and 2^t from the Taylor series of exp(f * ln(2)) with
+// |f| <= 0.5. Both series are truncated well below the single precision
+// rounding error.
+//
+
+struct MLAS_POW_CONSTANTS {
+    static constexpr double Sqrt2 = 1.4142135623730951;
+    static constexpr double TwoOverLn2 = 2.8853900817779268;
+    static constexpr double Ln2 = 0.69314718055994531;
+    static constexpr double RoundingBias = 6755399441055744.0;
+    static constexpr double ExponentBias = 4503599627371519.0;
+    static constexpr double MaximumExponent = 256.0;
+    static constexpr double MaximumExactFloat = 16777216.0;
+    static constexpr double atanh_1 = 1.0 / 3.0;
+    static constexpr double atanh_2 = 1.0 / 5.0;
+    static constexpr double atanh_3 = 1.0 / 7.0;
+    static constexpr double atanh_4 = 1.0 / 9.0;
+    static constexpr double atanh_5 = 1.0 / 11.0;
+    static constexpr double atanh_6 = 1.0 / 13.0;
+    static constexpr double atanh_7 = 1.0 / 15.0;
+    static constexpr double exp_2 = 1.0 / 2.0;
+    static constexpr double exp_3 = 1.0 / 6.0;
+    static constexpr double exp_4 = 1.0 / 24.0;
+    static constexpr double exp_5 = 1.0 / 120.0;
+    static constexpr double exp_6 = 1.0 / 720.0;
+    static constexpr double exp_7 = 1.0 / 5040.0;
+    static constexpr double exp_8 = 1.0 / 40320.0;
+    static constexpr double exp_9 = 1.0 / 362880.0;
+};
+
+template<typename KernelType>
+struct MLAS_LOG_OPERATION {
+    using FloatVector = typename KernelType::FloatVector;
+    using C = MLAS_LOG_CONSTANTS;
+
+    static constexpr bool RangeLimited = false;
+
+    static
+    MLAS_FORCEINLINE
+    FloatVector
+    Compute(
+        FloatVector Value
+        )
+    {
+        //
+        // Scale denormal inputs into the normal range.
+        //
+
+        const auto Denormal = KernelType::GreaterThan(KernelType::BroadcastFloat(C::MinimumNormal), Value);
+        FloatVector x = KernelType::Blend(Value,
+            KernelType::Multiply(Value, KernelType::BroadcastFloat(C::DenormalScale)), Denormal);
+        FloatVector e = KernelType::Blend(KernelType::BroadcastFloat(-127.0f),
+            KernelType::BroadcastFloat(-150.0f), Denormal);
+
+        //
+        // Split the value into the exponent and the mantissa in [1, 2), then
+        // fold the mantissa to [sqrt(1/2), sqrt(2)).
+        //
+
+        const auto Bits = KernelType::ReinterpretAsInt(x);
+        const auto ExponentBits = KernelType::IntAnd(Bits, KernelType::BroadcastInt(0x7F800000));
+        e = KernelType::MultiplyAdd(KernelType::CastToFloat(ExponentBits), KernelType::BroadcastFloat(1.0f / 8388608.0f), e);
+
+        FloatVector m = KernelType::ReinterpretAsFloat(KernelType::IntOr(
+            KernelType::IntAnd(Bits, KernelType::BroadcastInt(0x007FFFFF)), KernelType::BroadcastInt(0x3F800000)));
+
+        const auto Fold = KernelType::GreaterThan(m, KernelType::BroadcastFloat(C::Sqrt2));
+        m = KernelType::Blend(m, KernelType::Multiply(m, KernelType::BroadcastFloat(0.5f)), Fold);
+        e = KernelType::Blend(e, KernelType::Add(e, KernelType::BroadcastFloat(1.0f)), Fold);
+
+        const FloatVector f = KernelType::Subtract(m, KernelType::BroadcastFloat(1.0f));
+        const FloatVector z = KernelType::Multiply(f, f);
+
+        FloatVector p = KernelType::BroadcastFloat(C::poly_0);
+        p = KernelType::MultiplyAdd(p, f, KernelType::BroadcastFloat(C::poly_1));
+        p = KernelType::MultiplyAdd(p, f, KernelType::BroadcastFloat(C::poly_2));
+        p = KernelType::MultiplyAdd(p, f, KernelType::BroadcastFloat(C::poly_3));
+        p = KernelType::MultiplyAdd(p, f, KernelType::BroadcastFloat(C::poly_4));
+        p = KernelType::MultiplyAdd(p, f, KernelType::BroadcastFloat(C::poly_5));
+        p = KernelType::MultiplyAdd(p, f, KernelType::BroadcastFloat(C::poly_6));
+        p = KernelType::MultiplyAdd(p, f, KernelType::BroadcastFloat(C::poly_7));
+        p = KernelType::MultiplyAdd(p, f, KernelType::BroadcastFloat(C::poly_8));
+
+        FloatVector y = KernelType::Multiply(KernelType::Multiply(f, z), p);
+        y = KernelType::MultiplyAdd(e, KernelType::BroadcastFloat(C::Log2Low), y);
+        y = KernelType::MultiplyAdd(z, KernelType::BroadcastFloat(-0.5f), y);
+        FloatVector Result = KernelType::Add(f, y);
+        Result = KernelType::MultiplyAdd(e, KernelType::BroadcastFloat(C::Log2High), Result);
+
+        //
+        // Fix up +infinity, zero, and negative or NaN inputs. The comparison
+        // against the smallest negative denormal is false for NaNs and true
+        // for both signed zeros.
+        //
+
+        const float Infinity = std::numeric_limits<float>::infinity();
+
+        Result = KernelType::Blend(Result, KernelType::BroadcastFloat(Infinity),
+            KernelType::GreaterThan(Value, KernelType::BroadcastFloat(std::numeric_limits<float>::max())));
+        Result = KernelType::Blend(KernelType::BroadcastFloat(-Infinity), Result,
+            KernelType::GreaterThan(Value, KernelType::BroadcastFloat(0.0f)));
+        Result = KernelType::Blend(Result, KernelType::BroadcastFloat(std::numeric_limits<float>::quiet_NaN()),
+            KernelType::MaskNot(KernelType::GreaterThan(Value,
+                KernelType::BroadcastFloat(-std::numeric_limits<float>::denorm_min()))));
+
+        return Result;
+    }
+};
+
+template<typename KernelType, bool IsCosine>
+struct MLAS_SINCOS_OPERATION {
+    using FloatVector = typename KernelType::FloatVector;
+    using C = MLAS_SINCOS_CONSTANTS;
+
+    static constexpr bool RangeLimited = true;
+
+    static
+    MLAS_FORCEINLINE
+    FloatVector
+    Compute(
+        FloatVector Value
+        )
+    {
+        const auto RoundingBias = KernelType::BroadcastFloat(C::RoundingBias);
+
+        //
+        // Compute the quadrant index j = round(x * 2 / pi). The low bits of the
+        // biased value hold j modulo 4.
+        //
+
+        const FloatVector Biased = KernelType::MultiplyAdd(Value, KernelType::BroadcastFloat(C::TwoOverPi), RoundingBias);
+        const FloatVector j = KernelType::Subtract(Biased, RoundingBias);
+        auto Quadrant = KernelType::ReinterpretAsInt(Biased);
+
+        if (IsCosine) {
+            Quadrant = KernelType::IntAdd(Quadrant, KernelType::BroadcastInt(1));
+        }
+
+        //
+        // The reduced argument is carried as r + rlow. The first product is
+        // subtracted exactly, and the rounding errors of the next two steps
+        // are recovered with Fast2Sum.
+        //
+
+        FloatVector r = KernelType::MultiplyAdd(j, KernelType::BroadcastFloat(-C::PiOver2_0), Value);
+
+        FloatVector Term = KernelType::Multiply(j, KernelType::BroadcastFloat(-C::PiOver2_1));
+        FloatVector Sum = KernelType::Add(r, Term);
+        FloatVector rlow = KernelType::Subtract(Term, KernelType::Subtract(Sum, r));
+        r = Sum;
+
+        Term = KernelType::Multiply(j, KernelType::BroadcastFloat(-C::PiOver2_2));
+        Sum = KernelType::Add(r, Term);
+        rlow = KernelType::Add(rlow, KernelType::Subtract(Term, KernelType::Subtract(Sum, r)));
+        r = Sum;
+
+        rlow = KernelType::MultiplyAdd(j, KernelType::BroadcastFloat(-C::PiOver2_3), rlow);
+        Sum = KernelType::Add(r, rlow);
+        rlow = KernelType::Add(rlow, KernelType::Subtract(r, Sum));
+        r = Sum;
+
+        const FloatVector z = KernelType::Multiply(r, r);
+
+        FloatVector s = KernelType::BroadcastFloat(C::sin_0);
+        s = KernelType::MultiplyAdd(s, z, KernelType::BroadcastFloat(C::sin_1));
+        s = KernelType::MultiplyAdd(s, z, KernelType::BroadcastFloat(C::sin_2));
+        s = KernelType::MultiplyAdd(KernelType::Multiply(s, z), r, r);
+
+        FloatVector c = KernelType::BroadcastFloat(C::cos_0);
+        c = KernelType::MultiplyAdd(c, z, KernelType::BroadcastFloat(C::cos_1));
+        c = KernelType::MultiplyAdd(c, z, KernelType::BroadcastFloat(C::cos_2));
+        c = KernelType::Multiply(KernelType::Multiply(c, z), z);
+        c = KernelType::MultiplyAdd(z, KernelType::BroadcastFloat(-0.5f), c);
+        c = KernelType::Add(c, KernelType::BroadcastFloat(1.0f));
+
+        //
+        // sin(r + rlow) = sin(r) + rlow * cos(r) and
+        // cos(r + rlow) = cos(r) - rlow * sin(r) to first order.
+        //
+
+        const FloatVector SinCorrected = KernelType::MultiplyAdd(rlow, c, s);
+        const FloatVector CosCorrected = KernelType::MultiplyAdd(KernelType::Xor(rlow,
+            KernelType::BroadcastFloat(-0.0f)), s, c);
+        s = SinCorrected;
+        c = CosCorrected;
+
+        //
+        // Odd quadrants use the cosine polynomial and quadrants 2 and 3 negate
+        // the result.
+        //
+
+        FloatVector Result = KernelType::Blend(s, c, KernelType::MaskFromLowBit(Quadrant));
+        const auto Sign = KernelType::template IntShiftLeft<30>(KernelType::IntAnd(Quadrant, KernelType::BroadcastInt(2)));
+
+        return KernelType::Xor(Result, KernelType::ReinterpretAsFloat(Sign));
+    }
+
+    static
+    MLAS_FORCEINLINE
+    typename KernelType::Mask
+    OutOfRange(
+        FloatVector Value
+        )
+    {
+        const FloatVector AbsValue = KernelType::ReinterpretAsFloat(KernelType::IntAnd(
+            KernelType::ReinterpretAsInt(Value), KernelType::BroadcastInt(0x7FFFFFFF)));
+
+        return KernelType::MaskNot(KernelType::GreaterThan(KernelType::BroadcastFloat(C::Limit), AbsValue));
+    }
+
+    static
+    float
+    ComputeScalar(
+        float Value
+        )
+    {
+        return IsCosine ? std::cos(Value) : std::sin(Value);
+    }
+};
+
+template<typename KernelType>
+struct MLAS_SQRT_OPERATION {
+    using FloatVector = typename KernelType::FloatVector;
+
+    static constexpr bool RangeLimited = false;
+
+    static
+    MLAS_FORCEINLINE
+    FloatVector
+    Compute(
+        FloatVector Value
+        )
+    {
+        return KernelType::Sqrt(Value);
+    }
+};
+
+template<typename KernelType>
+struct MLAS_RECIPROCAL_OPERATION {
+    using FloatVector = typename KernelType::FloatVector;
+
+    static constexpr bool RangeLimited = false;
+
+    static
+    MLAS_FORCEINLINE
+    FloatVector
+    Compute(
+        FloatVector Value
+        )
+    {
+        return KernelType::Divide(KernelType::BroadcastFloat(1.0f), Value);
+    }
+};
+
+template<typename KernelType, typename Operation>
+void
+MlasTranscendentalKernel(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the supplied operation to each element of a buffer.
+
+    Operations that are only accurate over a limited range recompute the
+    elements outside of that range with the C runtime.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t Width = KernelType::Width;
+
+    while (N > 0) {
+
+        const size_t Count = std::min(N, Width);
+        typename KernelType::FloatVector Value;
+
+        if (Count == Width) {
+
+            Value = KernelType::LoadFloat(Input);
+            KernelType::StoreFloat(Output, Operation::Compute(Value));
+
+        } else {
+
+            float Buffer[Width] = {};
+
+            std::copy_n(Input, Count, Buffer);
+            Value = KernelType::LoadFloat(Buffer);
+            KernelType::StoreFloat(Buffer, Operation::Compute(Value));
+            std::copy_n(Buffer, Count, Output);
+        }
+
+        if constexpr (Operation::RangeLimited) {
+            if (KernelType::MaskAny(Operation::OutOfRange(Value))) {
+                for (size_t i = 0; i < Count; i++) {
+                    if (!(std::fabs(Input[i]) < MLAS_SINCOS_CONSTANTS::Limit)) {
+                        Output[i] = Operation::ComputeScalar(Input[i]);
+                    }
+                }
+            }
+        }
+
+        Input += Count;
+        Output += Count;
+        N -= Count;
+    }
+}
+
+template<typename KernelType>
+MLAS_FORCEINLINE
+typename KernelType::DoubleVector
+MlasPowVector(
+    typename KernelType::DoubleVector x,
+    typename KernelType::DoubleVector y
+    )
+/*++
+
+Routine Description:
+
+    This routine computes x^y for a vector of single precision values that
+    have been widened to double precision.
+
+Arguments:
+
+    x - Supplies the base values.
+
+    y - Supplies the exponent values.
+
+Return Value:
+
+    Returns the power function of the inputs, following the special cases of
+    the C runtime pow().
+
+--*/
+{
+    using C = MLAS_POW_CONSTANTS;
+    using K = KernelType;
+
+    const double Infinity = std::numeric_limits<double>::infinity();
+    const auto SignMask = K::BroadcastDouble(-0.0);
+    const auto One = K::BroadcastDouble(1.0);
+    const auto RoundingBias = K::BroadcastDouble(C::RoundingBias);
+
+    const auto ax = K::AndNot(SignMask, x);
+    const auto ay = K::AndNot(SignMask, y);
+
+    //
+    // Split |x| into 2^e * m with m in [sqrt(1/2), sqrt(2)). Widened single
+    // precision values are never denormal in double precision.
+    //
+
+    const auto Bits = K::ReinterpretAsInt(ax);
+
+    auto e = K::Subtract(K::ReinterpretAsDouble(K::IntOr(K::template IntShiftRight<52>(Bits),
+        K::ReinterpretAsInt(K::BroadcastDouble(4503599627370496.0)))), K::BroadcastDouble(C::ExponentBias));
+
+    auto m = K::ReinterpretAsDouble(K::IntOr(K::IntAnd(Bits, K::BroadcastInt(0x000FFFFFFFFFFFFFull)),
+        K::BroadcastInt(0x3FF0000000000000ull)));
+
+    const auto Fold = K::GreaterThan(m, K::BroadcastDouble(C::Sqrt2));
+    m = K::Blend(m, K::Multiply(m, K::BroadcastDouble(0.5)), Fold);
+    e = K::Blend(e, K::Add(e, One), Fold);
+
+    //
+    // log2(m) = 2 * atanh(s) / ln(2) with s = (m - 1) / (m + 1).
+    //
+
+    const auto s = K::Divide(K::Subtract(m, One), K::Add(m, One));
+    const auto z = K::Multiply(s, s);
+
+    auto p = K::BroadcastDouble(C::atanh_7);
+    p = K::MultiplyAdd(p, z, K::BroadcastDouble(C::atanh_6));
+    p = K::MultiplyAdd(p, z, K::BroadcastDouble(C::atanh_5));
+    p = K::MultiplyAdd(p, z, K::BroadcastDouble(C::atanh_4));
+    p = K::MultiplyAdd(p, z, K::BroadcastDouble(C::atanh_3));
+    p = K::MultiplyAdd(p, z, K::BroadcastDouble(C::atanh_2));
+    p = K::MultiplyAdd(p, z, K::BroadcastDouble(C::atanh_1));
+    p = K::MultiplyAdd(p, z, One);
+
+    auto Log2x = K::MultiplyAdd(K::Multiply(s, K::BroadcastDouble(C::TwoOverLn2)), p, e);
+    Log2x = K::Blend(Log2x, K::BroadcastDouble(-Infinity), K::Equal(ax, K::BroadcastDouble(0.0)));
+    Log2x = K::Blend(Log2x, K::BroadcastDouble(Infinity), K::Equal(ax, K::BroadcastDouble(Infinity)));
+
+    //
+    // 2^t = 2^n * exp(f * ln(2)) with n = round(t). Clamping t keeps 2^n a
+    // normal double while still overflowing or underflowing single precision.
+    //
+
+    auto t = K::Multiply(y, Log2x);
+    t = K::Maximum(t, K::BroadcastDouble(-C::MaximumExponent));
+    t = K::Minimum(t, K::BroadcastDouble(C::MaximumExponent));
+
+    const auto Biased = K::Add(t, RoundingBias);
+    const auto n = K::Subtract(Biased, RoundingBias);
+    const auto u = K::Multiply(K::Subtract(t, n), K::BroadcastDouble(C::Ln2));
+
+    auto q = K::BroadcastDouble(C::exp_9);
+    q = K::MultiplyAdd(q, u, K::BroadcastDouble(C::exp_8));
+    q = K::MultiplyAdd(q, u, K::BroadcastDouble(C::exp_7));
+    q = K::MultiplyAdd(q, u, K::BroadcastDouble(C::exp_6));
+    q = K::MultiplyAdd(q, u, K::BroadcastDouble(C::exp_5));
+    q = K::MultiplyAdd(q, u, K::BroadcastDouble(C::exp_4));
+    q = K::MultiplyAdd(q, u, K::BroadcastDouble(C::exp_3));
+    q = K::MultiplyAdd(q, u, K::BroadcastDouble(C::exp_2));
+    q = K::MultiplyAdd(q, u, One);
+    q = K::MultiplyAdd(q, u, One);
+
+    const auto Scale = K::ReinterpretAsDouble(K::template IntShiftLeft<52>(K::IntAdd(
+        K::IntSubtract(K::ReinterpretAsInt(Biased), K::ReinterpretAsInt(RoundingBias)), K::BroadcastInt(1023))));
+
+    auto Result = K::Multiply(q, Scale);
+
+    //
+    // Classify the exponent as an integer and as an odd integer. Every single
+    // precision value with a magnitude of at least 2^24 is an even integer.
+    //
+
+    const auto MaximumExactFloat = K::BroadcastDouble(C::MaximumExactFloat);
+    const auto SmallExponent = K::GreaterThan(MaximumExactFloat, ay);
+    const auto IntegerExponent = K::MaskOr(K::MaskNot(SmallExponent),
+        K::Equal(K::Subtract(K::Add(y, RoundingBias), RoundingBias), y));
+    const auto HalfExponent = K::Multiply(y, K::BroadcastDouble(0.5));
+    const auto OddExponent = K::MaskAnd(K::MaskAnd(SmallExponent, IntegerExponent),
+        K::MaskNot(K::Equal(K::Subtract(K::Add(HalfExponent, RoundingBias), RoundingBias), HalfExponent)));
+
+    //
+    // Negative bases (including -0) negate the result for odd integer
+    // exponents. Finite negative bases with a non-integer exponent are NaN.
+    //
+
+    const auto NegativeBase = K::GreaterThan(K::BroadcastDouble(0.0), K::Or(K::And(x, SignMask), One));
+    Result = K::Blend(Result, K::Xor(Result, SignMask), K::MaskAnd(NegativeBase, OddExponent));
+
+    const auto FiniteNegativeBase = K::MaskAnd(K::GreaterThan(K::BroadcastDouble(0.0), x),
+        K::GreaterThan(K::BroadcastDouble(Infinity), ax));
+    Result = K::Blend(Result, K::BroadcastDouble(std::numeric_limits<double>::quiet_NaN()),
+        K::MaskAnd(FiniteNegativeBase, K::MaskNot(IntegerExponent)));
+
+    Result = K::Blend(Result, K::Add(x, y), K::MaskOr(K::IsNan(x), K::IsNan(y)));
+    Result = K::Blend(Result, One, K::MaskAnd(K::Equal(ax, One), K::Equal(ay, K::BroadcastDouble(Infinity))));
+    Result = K::Blend(Result, One, K::MaskOr(K::Equal(x, One), K::Equal(y, K::BroadcastDouble(0.0))));
+
+    return Result;
+}
+
+template<typename KernelType, bool ScalarBase, bool ScalarExponent>
+void
+MlasPowKernelLoop(
+    const float* Base,
+    const float* Exponent,
+    float* Output,
+    size_t N
+    )
+{
+    constexpr size_t Width = KernelType::Width;
+
+    while (N > 0) {
+
+        const size_t Count = std::min(N, Width);
+
+        if (Count == Width) {
+
+            auto x = ScalarBase ? KernelType::BroadcastDouble(*Base) : KernelType::LoadFloat(Base);
+            auto y = ScalarExponent ? KernelType::BroadcastDouble(*Exponent) : KernelType::LoadFloat(Exponent);
+
+            KernelType::StoreFloat(Output, MlasPowVector<KernelType>(x, y));
+
+        } else {
+
+            float BaseBuffer[Width] = {};
+            float ExponentBuffer[Width] = {};
+            float OutputBuffer[Width];
+
+            std::fill_n(BaseBuffer, Count, *Base);
+            std::fill_n(ExponentBuffer, Count, *Exponent);
+
+            if (!ScalarBase) {
+                std::copy_n(Base, Count, BaseBuffer);
+            }
+
+            if (!ScalarExponent) {
+                std::copy_n(Exponent, Count, ExponentBuffer);
+            }
+
+            auto x = KernelType::LoadFloat(BaseBuffer);
+            auto y = KernelType::LoadFloat(ExponentBuffer);
+
+            KernelType::StoreFloat(OutputBuffer, MlasPowVector<KernelType>(x, y));
+            std::copy_n(OutputBuffer, Count, Output);
+        }
+
+        if (!ScalarBase) {
+            Base += Count;
+        }
+
+        if (!ScalarExponent) {
+            Exponent += Count;
+        }
+
+        Output += Count;
+        N -= Count;
+    }
+}
+
+template<typename KernelType>
+void
+MlasPowKernel(
+    const float* Base,
+    const float* Exponent,
+    float* Output,
+    size_t N,
+    bool ScalarBase,
+    bool ScalarExponent
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the power function for each element of a buffer.
+
+Arguments:
+
+    Base - Supplies the base buffer, or a single value if ScalarBase is true.
+
+    Exponent - Supplies the exponent buffer, or a single value if
+        ScalarExponent is true.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    ScalarBase - Supplies true if Base is broadcast to every element.
+
+    ScalarExponent - Supplies true if Exponent is broadcast to every element.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (N == 0) {
+        return;
+    }
+
+    if (ScalarBase && ScalarExponent) {
+        MlasPowKernelLoop<KernelType, true, true>(Base, Exponent, Output, 1);
+        std::fill_n(Output + 1, N - 1, *Output);
+    } else if (ScalarBase) {
+        MlasPowKernelLoop<KernelType, true, false>(Base, Exponent, Output, N);
+    } else if (ScalarExponent) {
+        MlasPowKernelLoop<KernelType, false, true>(Base, Exponent, Output, N);
+    } else {
+        MlasPowKernelLoop<KernelType, false, false>(Base, Exponent, Output, N);
+    }
+}
@@ -0,0 +1,182 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    transcendental_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the log, sine, cosine, square root, reciprocal and
+    power kernels for AVX2/FMA3.
+
+--*/
+
+#include "transcendental.h"
+
+struct MLAS_TRANSCENDENTAL_F32_KERNEL_AVX2 {
+    static constexpr size_t Width = 8;
+
+    using FloatVector = __m256;
+    using IntVector = __m256i;
+    using Mask = __m256;
+
+    static MLAS_FORCEINLINE FloatVector LoadFloat(const float* Buffer) { return _mm256_loadu_ps(Buffer); }
+    static MLAS_FORCEINLINE void StoreFloat(float* Buffer, FloatVector Vector) { _mm256_storeu_ps(Buffer, Vector); }
+    static MLAS_FORCEINLINE FloatVector BroadcastFloat(float Value) { return _mm256_set1_ps(Value); }
+    static MLAS_FORCEINLINE IntVector BroadcastInt(int32_t Value) { return _mm256_set1_epi32(Value); }
+
+    static MLAS_FORCEINLINE FloatVector Add(FloatVector a, FloatVector b) { return _mm256_add_ps(a, b); }
+    static MLAS_FORCEINLINE FloatVector Subtract(FloatVector a, FloatVector b) { return _mm256_sub_ps(a, b); }
+    static MLAS_FORCEINLINE FloatVector Multiply(FloatVector a, FloatVector b) { return _mm256_mul_ps(a, b); }
+    static MLAS_FORCEINLINE FloatVector MultiplyAdd(FloatVector a, FloatVector b, FloatVector c) { return _mm256_fmadd_ps(a, b, c); }
+    static MLAS_FORCEINLINE FloatVector Divide(FloatVector a, FloatVector b) { return _mm256_div_ps(a, b); }
+    static MLAS_FORCEINLINE FloatVector Sqrt(FloatVector a) { return _mm256_sqrt_ps(a); }
+    static MLAS_FORCEINLINE FloatVector And(FloatVector a, FloatVector b) { return _mm256_and_ps(a, b); }
+    static MLAS_FORCEINLINE FloatVector Xor(FloatVector a, FloatVector b) { return _mm256_xor_ps(a, b); }
+
+    static MLAS_FORCEINLINE IntVector ReinterpretAsInt(FloatVector a) { return _mm256_castps_si256(a); }
+    static MLAS_FORCEINLINE FloatVector ReinterpretAsFloat(IntVector a) { return _mm256_castsi256_ps(a); }
+    static MLAS_FORCEINLINE FloatVector CastToFloat(IntVector a) { return _mm256_cvtepi32_ps(a); }
+    static MLAS_FORCEINLINE IntVector IntAnd(IntVector a, IntVector b) { return _mm256_and_si256(a, b); }
+    static MLAS_FORCEINLINE IntVector IntOr(IntVector a, IntVector b) { return _mm256_or_si256(a, b); }
+    static MLAS_FORCEINLINE IntVector IntAdd(IntVector a, IntVector b) { return _mm256_add_epi32(a, b); }
+
+    template<unsigned ShiftCount>
+    static MLAS_FORCEINLINE IntVector IntShiftLeft(IntVector a) { return _mm256_slli_epi32(a, ShiftCount); }
+
+    static MLAS_FORCEINLINE Mask GreaterThan(FloatVector a, FloatVector b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static MLAS_FORCEINLINE Mask MaskOr(Mask a, Mask b) { return _mm256_or_ps(a, b); }
+    static MLAS_FORCEINLINE Mask MaskNot(Mask a) { return _mm256_xor_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(-1))); }
+    static MLAS_FORCEINLINE Mask MaskFromLowBit(IntVector a) { return _mm256_castsi256_ps(_mm256_slli_epi32(a, 31)); }
+    static MLAS_FORCEINLINE bool MaskAny(Mask m) { return _mm256_movemask_ps(m) != 0; }
+    static MLAS_FORCEINLINE FloatVector Blend(FloatVector a, FloatVector b, Mask m) { return _mm256_blendv_ps(a, b, m); }
+};
+
+struct MLAS_TRANSCENDENTAL_F64_KERNEL_AVX2 {
+    static constexpr size_t Width = 4;
+
+    using DoubleVector = __m256d;
+    using IntVector = __m256i;
+    using Mask = __m256d;
+
+    static MLAS_FORCEINLINE DoubleVector LoadFloat(const float* Buffer) { return _mm256_cvtps_pd(_mm_loadu_ps(Buffer)); }
+    static MLAS_FORCEINLINE void StoreFloat(float* Buffer, DoubleVector Vector) { _mm_storeu_ps(Buffer, _mm256_cvtpd_ps(Vector)); }
+    static MLAS_FORCEINLINE DoubleVector BroadcastDouble(double Value) { return _mm256_set1_pd(Value); }
+    static MLAS_FORCEINLINE IntVector BroadcastInt(uint64_t Value) { return _mm256_set1_epi64x(int64_t(Value)); }
+
+    static MLAS_FORCEINLINE DoubleVector Add(DoubleVector a, DoubleVector b) { return _mm256_add_pd(a, b); }
+    static MLAS_FORCEINLINE DoubleVector Subtract(DoubleVector a, DoubleVector b) { return _mm256_sub_pd(a, b); }
+    static MLAS_FORCEINLINE DoubleVector Multiply(DoubleVector a, DoubleVector b) { return _mm256_mul_pd(a, b); }
+    static MLAS_FORCEINLINE DoubleVector MultiplyAdd(DoubleVector a, DoubleVector b, DoubleVector c) { return _mm256_fmadd_pd(a, b, c); }
+    static MLAS_FORCEINLINE DoubleVector Divide(DoubleVector a, DoubleVector b) { return _mm256_div_pd(a, b); }
+    static MLAS_FORCEINLINE DoubleVector Maximum(DoubleVector a, DoubleVector b) { return _mm256_max_pd(a, b); }
+    static MLAS_FORCEINLINE DoubleVector Minimum(DoubleVector a, DoubleVector b) { return _mm256_min_pd(a, b); }
+    static MLAS_FORCEINLINE DoubleVector And(DoubleVector a, DoubleVector b) { return _mm256_and_pd(a, b); }
+    static MLAS_FORCEINLINE DoubleVector AndNot(DoubleVector a, DoubleVector b) { return _mm256_andnot_pd(a, b); }
+    static MLAS_FORCEINLINE DoubleVector Or(DoubleVector a, DoubleVector b) { return _mm256_or_pd(a, b); }
+    static MLAS_FORCEINLINE DoubleVector Xor(DoubleVector a, DoubleVector b) { return _mm256_xor_pd(a, b); }
+
+    static MLAS_FORCEINLINE IntVector ReinterpretAsInt(DoubleVector a) { return _mm256_castpd_si256(a); }
+    static MLAS_FORCEINLINE DoubleVector ReinterpretAsDouble(IntVector a) { return _mm256_castsi256_pd(a); }
+    static MLAS_FORCEINLINE IntVector IntAnd(IntVector a, IntVector b) { return _mm256_and_si256(a, b); }
+    static MLAS_FORCEINLINE IntVector IntOr(IntVector a, IntVector b) { return _mm256_or_si256(a, b); }
+    static MLAS_FORCEINLINE IntVector IntAdd(IntVector a, IntVector b) { return _mm256_add_epi64(a, b); }
+    static MLAS_FORCEINLINE IntVector IntSubtract(IntVector a, IntVector b) { return _mm256_sub_epi64(a, b); }
+
+    template<unsigned ShiftCount>
+    static MLAS_FORCEINLINE IntVector IntShiftLeft(IntVector a) { return _mm256_slli_epi64(a, ShiftCount); }
+
+    template<unsigned ShiftCount>
+    static MLAS_FORCEINLINE IntVector IntShiftRight(IntVector a) { return _mm256_srli_epi64(a, ShiftCount); }
+
+    static MLAS_FORCEINLINE Mask Equal(DoubleVector a, DoubleVector b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+    static MLAS_FORCEINLINE Mask GreaterThan(DoubleVector a, DoubleVector b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+    static MLAS_FORCEINLINE Mask IsNan(DoubleVector a) { return _mm256_cmp_pd(a, a, _CMP_UNORD_Q); }
+    static MLAS_FORCEINLINE Mask MaskAnd(Mask a, Mask b) { return _mm256_and_pd(a, b); }
+    static MLAS_FORCEINLINE Mask MaskOr(Mask a, Mask b) { return _mm256_or_pd(a, b); }
+    static MLAS_FORCEINLINE Mask MaskNot(Mask a) { return _mm256_xor_pd(a, _mm256_castsi256_pd(_mm256_set1_epi64x(-1))); }
+    static MLAS_FORCEINLINE DoubleVector Blend(DoubleVector a, DoubleVector b, Mask m) { return _mm256_blendv_pd(a, b, m); }
+};
+
+void
+MLASCALL
+MlasComputeLogF32KernelAvx2(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+{
+    using KernelType = MLAS_TRANSCENDENTAL_F32_KERNEL_AVX2;
+
+    MlasTranscendentalKernel<KernelType, MLAS_LOG_OPERATION<KernelType>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputeSinF32KernelAvx2(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+{
+    using KernelType = MLAS_TRANSCENDENTAL_F32_KERNEL_AVX2;
+
+    MlasTranscendentalKernel<KernelType, MLAS_SINCOS_OPERATION<KernelType, false>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputeCosF32KernelAvx2(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+{
+    using KernelType = MLAS_TRANSCENDENTAL_F32_KERNEL_AVX2;
+
+    MlasTranscendentalKernel<KernelType, MLAS_SINCOS_OPERATION<KernelType, true>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputeSqrtF32KernelAvx2(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+{
+    using KernelType = MLAS_TRANSCENDENTAL_F32_KERNEL_AVX2;
+
+    MlasTranscendentalKernel<KernelType, MLAS_SQRT_OPERATION<KernelType>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputeReciprocalF32KernelAvx2(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+{
+    using KernelType = MLAS_TRANSCENDENTAL_F32_KERNEL_AVX2;
+
+    MlasTranscendentalKernel<KernelType, MLAS_RECIPROCAL_OPERATION<KernelType>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputePowF32KernelAvx2(
+    const float* Base,
+    const float* Exponent,
+    float* Output,
+    size_t N,
+    bool ScalarBase,
+    bool ScalarExponent
+    )
+{
+    MlasPowKernel<MLAS_TRANSCENDENTAL_F64_KERNEL_AVX2>(Base, Exponent, Output, N, ScalarBase, ScalarExponent);
+}
@@ -0,0 +1,189 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    transcendental_kernel_avx512f.cpp
+
+Abstract:
+
+    This module implements the log, sine, cosine, square root, reciprocal and
+    power kernels for AVX512F.
+
+--*/
+
+#include "transcendental.h"
+
+struct MLAS_TRANSCENDENTAL_F32_KERNEL_AVX512F {
+    static constexpr size_t Width = 16;
+
+    using FloatVector = __m512;
+    using IntVector = __m512i;
+    using Mask = __mmask16;
+
+    static MLAS_FORCEINLINE FloatVector LoadFloat(const float* Buffer) { return _mm512_loadu_ps(Buffer); }
+    static MLAS_FORCEINLINE void StoreFloat(float* Buffer, FloatVector Vector) { _mm512_storeu_ps(Buffer, Vector); }
+    static MLAS_FORCEINLINE FloatVector BroadcastFloat(float Value) { return _mm512_set1_ps(Value); }
+    static MLAS_FORCEINLINE IntVector BroadcastInt(int32_t Value) { return _mm512_set1_epi32(Value); }
+
+    static MLAS_FORCEINLINE FloatVector Add(FloatVector a, FloatVector b) { return _mm512_add_ps(a, b); }
+    static MLAS_FORCEINLINE FloatVector Subtract(FloatVector a, FloatVector b) { return _mm512_sub_ps(a, b); }
+    static MLAS_FORCEINLINE FloatVector Multiply(FloatVector a, FloatVector b) { return _mm512_mul_ps(a, b); }
+    static MLAS_FORCEINLINE FloatVector MultiplyAdd(FloatVector a, FloatVector b, FloatVector c) { return _mm512_fmadd_ps(a, b, c); }
+    static MLAS_FORCEINLINE FloatVector Divide(FloatVector a, FloatVector b) { return _mm512_div_ps(a, b); }
+    static MLAS_FORCEINLINE FloatVector Sqrt(FloatVector a) { return _mm512_sqrt_ps(a); }
+
+    static MLAS_FORCEINLINE IntVector ReinterpretAsInt(FloatVector a) { return _mm512_castps_si512(a); }
+    static MLAS_FORCEINLINE FloatVector ReinterpretAsFloat(IntVector a) { return _mm512_castsi512_ps(a); }
+    static MLAS_FORCEINLINE FloatVector CastToFloat(IntVector a) { return _mm512_cvtepi32_ps(a); }
+    static MLAS_FORCEINLINE IntVector IntAnd(IntVector a, IntVector b) { return _mm512_and_si512(a, b); }
+    static MLAS_FORCEINLINE IntVector IntOr(IntVector a, IntVector b) { return _mm512_or_si512(a, b); }
+    static MLAS_FORCEINLINE IntVector IntAdd(IntVector a, IntVector b) { return _mm512_add_epi32(a, b); }
+
+    //
+    // The floating point logical instructions require AVX512DQ, so use the
+    // integer forms.
+    //
+
+    static MLAS_FORCEINLINE FloatVector And(FloatVector a, FloatVector b) { return ReinterpretAsFloat(IntAnd(ReinterpretAsInt(a), ReinterpretAsInt(b))); }
+    static MLAS_FORCEINLINE FloatVector Xor(FloatVector a, FloatVector b) { return ReinterpretAsFloat(_mm512_xor_si512(ReinterpretAsInt(a), ReinterpretAsInt(b))); }
+
+    template<unsigned ShiftCount>
+    static MLAS_FORCEINLINE IntVector IntShiftLeft(IntVector a) { return _mm512_slli_epi32(a, ShiftCount); }
+
+    static MLAS_FORCEINLINE Mask GreaterThan(FloatVector a, FloatVector b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+    static MLAS_FORCEINLINE Mask MaskOr(Mask a, Mask b) { return Mask(a | b); }
+    static MLAS_FORCEINLINE Mask MaskNot(Mask a) { return Mask(~a); }
+    static MLAS_FORCEINLINE Mask MaskFromLowBit(IntVector a) { return _mm512_test_epi32_mask(a, _mm512_set1_epi32(1)); }
+    static MLAS_FORCEINLINE bool MaskAny(Mask m) { return m != 0; }
+    static MLAS_FORCEINLINE FloatVector Blend(FloatVector a, FloatVector b, Mask m) { return _mm512_mask_blend_ps(m, a, b); }
+};
+
+struct MLAS_TRANSCENDENTAL_F64_KERNEL_AVX512F {
+    static constexpr size_t Width = 8;
+
+    using DoubleVector = __m512d;
+    using IntVector = __m512i;
+    using Mask = __mmask8;
+
+    static MLAS_FORCEINLINE DoubleVector LoadFloat(const float* Buffer) { return _mm512_cvtps_pd(_mm256_loadu_ps(Buffer)); }
+    static MLAS_FORCEINLINE void StoreFloat(float* Buffer, DoubleVector Vector) { _mm256_storeu_ps(Buffer, _mm512_cvtpd_ps(Vector)); }
+    static MLAS_FORCEINLINE DoubleVector BroadcastDouble(double Value) { return _mm512_set1_pd(Value); }
+    static MLAS_FORCEINLINE IntVector BroadcastInt(uint64_t Value) { return _mm512_set1_epi64(int64_t(Value)); }
+
+    static MLAS_FORCEINLINE DoubleVector Add(DoubleVector a, DoubleVector b) { return _mm512_add_pd(a, b); }
+    static MLAS_FORCEINLINE DoubleVector Subtract(DoubleVector a, DoubleVector b) { return _mm512_sub_pd(a, b); }
+    static MLAS_FORCEINLINE DoubleVector Multiply(DoubleVector a, DoubleVector b) { return _mm512_mul_pd(a, b); }
+    static MLAS_FORCEINLINE DoubleVector MultiplyAdd(DoubleVector a, DoubleVector b, DoubleVector c) { return _mm512_fmadd_pd(a, b, c); }
+    static MLAS_FORCEINLINE DoubleVector Divide(DoubleVector a, DoubleVector b) { return _mm512_div_pd(a, b); }
+    static MLAS_FORCEINLINE DoubleVector Maximum(DoubleVector a, DoubleVector b) { return _mm512_max_pd(a, b); }
+    static MLAS_FORCEINLINE DoubleVector Minimum(DoubleVector a, DoubleVector b) { return _mm512_min_pd(a, b); }
+
+    static MLAS_FORCEINLINE IntVector ReinterpretAsInt(DoubleVector a) { return _mm512_castpd_si512(a); }
+    static MLAS_FORCEINLINE DoubleVector ReinterpretAsDouble(IntVector a) { return _mm512_castsi512_pd(a); }
+    static MLAS_FORCEINLINE IntVector IntAnd(IntVector a, IntVector b) { return _mm512_and_si512(a, b); }
+    static MLAS_FORCEINLINE IntVector IntOr(IntVector a, IntVector b) { return _mm512_or_si512(a, b); }
+    static MLAS_FORCEINLINE IntVector IntAdd(IntVector a, IntVector b) { return _mm512_add_epi64(a, b); }
+    static MLAS_FORCEINLINE IntVector IntSubtract(IntVector a, IntVector b) { return _mm512_sub_epi64(a, b); }
+
+    static MLAS_FORCEINLINE DoubleVector And(DoubleVector a, DoubleVector b) { return ReinterpretAsDouble(IntAnd(ReinterpretAsInt(a), ReinterpretAsInt(b))); }
+    static MLAS_FORCEINLINE DoubleVector AndNot(DoubleVector a, DoubleVector b) { return ReinterpretAsDouble(_mm512_andnot_si512(ReinterpretAsInt(a), ReinterpretAsInt(b))); }
+    static MLAS_FORCEINLINE DoubleVector Or(DoubleVector a, DoubleVector b) { return ReinterpretAsDouble(IntOr(ReinterpretAsInt(a), ReinterpretAsInt(b))); }
+    static MLAS_FORCEINLINE DoubleVector Xor(DoubleVector a, DoubleVector b) { return ReinterpretAsDouble(_mm512_xor_si512(ReinterpretAsInt(a), ReinterpretAsInt(b))); }
+
+    template<unsigned ShiftCount>
+    static MLAS_FORCEINLINE IntVector IntShiftLeft(IntVector a) { return _mm512_slli_epi64(a, ShiftCount); }
+
+    template<unsigned ShiftCount>
+    static MLAS_FORCEINLINE IntVector IntShiftRight(IntVector a) { return _mm512_srli_epi64(a, ShiftCount); }
+
+    static MLAS_FORCEINLINE Mask Equal(DoubleVector a, DoubleVector b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+    static MLAS_FORCEINLINE Mask GreaterThan(DoubleVector a, DoubleVector b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+    static MLAS_FORCEINLINE Mask IsNan(DoubleVector a) { return _mm512_cmp_pd_mask(a, a, _CMP_UNORD_Q); }
+    static MLAS_FORCEINLINE Mask MaskAnd(Mask a, Mask b) { return Mask(a & b); }
+    static MLAS_FORCEINLINE Mask MaskOr(Mask a, Mask b) { return Mask(a | b); }
+    static MLAS_FORCEINLINE Mask MaskNot(Mask a) { return Mask(~a); }
+    static MLAS_FORCEINLINE DoubleVector Blend(DoubleVector a, DoubleVector b, Mask m) { return _mm512_mask_blend_pd(m, a, b); }
+};
+
+void
+MLASCALL
+MlasComputeLogF32KernelAvx512F(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+{
+    using KernelType = MLAS_TRANSCENDENTAL_F32_KERNEL_AVX512F;
+
+    MlasTranscendentalKernel<KernelType, MLAS_LOG_OPERATION<KernelType>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputeSinF32KernelAvx512F(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+{
+    using KernelType = MLAS_TRANSCENDENTAL_F32_KERNEL_AVX512F;
+
+    MlasTranscendentalKernel<KernelType, MLAS_SINCOS_OPERATION<KernelType, false>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputeCosF32KernelAvx512F(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+{
+    using KernelType = MLAS_TRANSCENDENTAL_F32_KERNEL_AVX512F;
+
+    MlasTranscendentalKernel<KernelType, MLAS_SINCOS_OPERATION<KernelType, true>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputeSqrtF32KernelAvx512F(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+{
+    using KernelType = MLAS_TRANSCENDENTAL_F32_KERNEL_AVX512F;
+
+    MlasTranscendentalKernel<KernelType, MLAS_SQRT_OPERATION<KernelType>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputeReciprocalF32KernelAvx512F(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+{
+    using KernelType = MLAS_TRANSCENDENTAL_F32_KERNEL_AVX512F;
+
+    MlasTranscendentalKernel<KernelType, MLAS_RECIPROCAL_OPERATION<KernelType>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputePowF32KernelAvx512F(
+    const float* Base,
+    const float* Exponent,
+    float* Output,
+    size_t N,
+    bool ScalarBase,
+    bool ScalarExponent
+    )
+{
+    MlasPowKernel<MLAS_TRANSCENDENTAL_F64_KERNEL_AVX512F>(Base, Exponent, Output, N, ScalarBase, ScalarExponent);
+}
@@ -30,9 +30,14 @@ bool IsFusableActivation(const Node& node) {
          IsSupportedOptypeVersionAndDomain(node, "Softplus", {1}, kOnnxDomain) ||
          IsSupportedOptypeVersionAndDomain(node, "Softsign", {1}, kOnnxDomain) ||
          IsSupportedOptypeVersionAndDomain(node, "Tanh", {6, 13}, kOnnxDomain) ||
+         IsSupportedOptypeVersionAndDomain(node, "Gelu", {20}, kOnnxDomain) ||
 #ifndef DISABLE_CONTRIB_OPS
          IsSupportedOptypeVersionAndDomain(node, "ScaledTanh", {1}, kOnnxDomain) ||
          IsSupportedOptypeVersionAndDomain(node, "ParametricSoftplus", {1}, kOnnxDomain) ||
+         IsSupportedOptypeVersionAndDomain(node, "Gelu", {1}, kMSDomain) ||
+         // FastGelu with the optional bias input is left alone.
+         (IsSupportedOptypeVersionAndDomain(node, "FastGelu", {1}, kMSDomain) && node.InputDefs().size() == 1) ||
+         IsSupportedOptypeVersionAndDomain(node, "QuickGelu", {1}, kMSDomain) ||
 #endif
          IsSupportedOptypeVersionAndDomain(node, "ThresholdedRelu", {1, 10}, kOnnxDomain);
 }
@@ -79,8 +84,14 @@ Status GemmActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph_l
                                      "fused Gemm " + gemm_node.Name() + "with activation " + act_node.OpType(),
                                      gemm_node.MutableInputDefs(), {}, &gemm_node.GetAttributes(), kMSDomain);
 
-    // Add a new attribute to specify the activation type
-    fused_gemm.AddAttribute("activation", act_node.OpType());
+    // Add a new attribute to specify the activation type.
+    // The tanh approximation of ONNX Gelu is the same function as com.microsoft FastGelu.
+    std::string activation_type = act_node.OpType();
+    const auto* approximate = graph_utils::GetNodeAttribute(act_node, "approximate");
+    if (activation_type == "Gelu" && approximate != nullptr && approximate->s() == "tanh") {
+      activation_type = "FastGelu";
+    }
+    fused_gemm.AddAttribute("activation", activation_type);
 
     // Assign provider to this new node. Provider should be same as the provider for old node.
     fused_gemm.SetExecutionProviderType(gemm_node.GetExecutionProviderType());
@@ -88,6 +99,10 @@ Status GemmActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph_l
     // Add optional attributes for activations
     const NodeAttributes& attrs = act_node.GetAttributes();
     for (const auto& attr : attrs) {
+      if (attr.first == "approximate") {
+        // Folded into the activation type above.
+        continue;
+      }
       AttributeProto fused_gemm_attr(attr.second);
       fused_gemm_attr.set_name("activation_" + attr.first);
       fused_gemm.AddAttributeProto(std::move(fused_gemm_attr));
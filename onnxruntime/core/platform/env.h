@@ -149,6 +149,19 @@ class Env {
 
   virtual int GetL2CacheSize() const = 0;
 
+  /// <summary>
+  /// Returns the logical processors of each NUMA node, indexed by node id. Nodes without processors (e.g. memory
+  /// only nodes) have an empty entry.
+  /// </summary>
+  /// <returns>Processors per NUMA node, or an empty vector if the NUMA topology is unknown</returns>
+  virtual std::vector<LogicalProcessors> GetNumaNodeProcessors() const = 0;
+
+  /// <summary>
+  /// Spreads the pages of the given memory range across the NUMA nodes that have processors, so that threads on all
+  /// nodes get the same bandwidth when reading it. Pages only partially inside the range are left as they are.
+  /// </summary>
+  virtual common::Status InterleaveMemoryAcrossNumaNodes(void* addr, size_t size) const = 0;
+
   /// \brief Returns the number of micro-seconds since the Unix epoch.
   virtual uint64_t NowMicros() const {
     return env_time_->NowMicros();
@@ -17,6 +17,7 @@ limitations under the License.
 #include "core/platform/env.h"
 
 #include <assert.h>
+#include <ctype.h>
 #include <dlfcn.h>
 #include <fcntl.h>
 #include <ftw.h>
@@ -31,6 +32,8 @@ limitations under the License.
 #endif
 #include <unistd.h>
 
+#include <climits>
+#include <fstream>
 #include <iostream>
 #include <optional>
 #include <thread>
@@ -124,6 +127,38 @@ struct Freer {
 
 using MallocdStringPtr = std::unique_ptr<char, Freer<char> >;
 
+#if defined(__linux__)
+// Reads the first line of a sysfs file, or returns an empty string if it doesn't exist.
+std::string ReadSysfsLine(const std::string& path) {
+  std::ifstream file(path);
+  std::string line;
+  std::getline(file, line);
+  return line;
+}
+
+// Parses a sysfs id list such as "0-3,8-11" into the ids it contains.
+std::vector<int> ParseSysfsIdList(const std::string& list) {
+  std::vector<int> ids;
+  const char* p = list.c_str();
+  while (isdigit(*p)) {
+    char* end = nullptr;
+    const int first = static_cast<int>(strtol(p, &end, 10));
+    int last = first;
+    if (*end == '-') {
+      last = static_cast<int>(strtol(end + 1, &end, 10));
+    }
+
+    for (int id = first; id <= last; ++id) {
+      ids.push_back(id);
+    }
+
+    p = *end == ',' ? end + 1 : end;
+  }
+
+  return ids;
+}
+#endif
+
 class PosixThread : public EnvThread {
  private:
   struct Param {
@@ -324,6 +359,69 @@ class PosixEnv : public Env {
 #endif
   }
 
+  std::vector<LogicalProcessors> GetNumaNodeProcessors() const override {
+    // the topology is read once as it is queried for every buffer that is interleaved
+    static const std::vector<LogicalProcessors> numa_nodes = []() {
+      std::vector<LogicalProcessors> ret;
+#if defined(__linux__)
+      for (int node : ParseSysfsIdList(ReadSysfsLine("/sys/devices/system/node/online"))) {
+        if (static_cast<size_t>(node) >= ret.size()) {
+          ret.resize(static_cast<size_t>(node) + 1);
+        }
+
+        ret[node] = ParseSysfsIdList(
+            ReadSysfsLine("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+      }
+#endif
+      return ret;
+    }();
+    return numa_nodes;
+  }
+
+  common::Status InterleaveMemoryAcrossNumaNodes(void* addr, size_t size) const override {
+#if defined(__linux__) && defined(SYS_mbind)
+    constexpr size_t kBitsPerLong = sizeof(unsigned long) * CHAR_BIT;
+    // from <linux/mempolicy.h>, which is not available with every toolchain
+    constexpr int kMpolInterleave = 3;
+    constexpr unsigned kMpolMfMove = 1 << 1;
+
+    const auto numa_nodes = GetNumaNodeProcessors();
+    std::vector<unsigned long> node_mask((numa_nodes.size() + kBitsPerLong - 1) / kBitsPerLong, 0);
+    size_t num_nodes = 0;
+    for (size_t node = 0; node < numa_nodes.size(); ++node) {
+      if (!numa_nodes[node].empty()) {
+        node_mask[node / kBitsPerLong] |= 1UL << (node % kBitsPerLong);
+        ++num_nodes;
+      }
+    }
+
+    if (num_nodes < 2) {
+      return Status::OK();
+    }
+
+    // the policy applies to whole pages, so leave out the pages shared with the memory around the range
+    const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const auto begin = (reinterpret_cast<uintptr_t>(addr) + page_size - 1) & ~(page_size - 1);
+    const auto end = (reinterpret_cast<uintptr_t>(addr) + size) & ~(page_size - 1);
+    if (begin >= end) {
+      return Status::OK();
+    }
+
+    // the kernel reads maxnode - 1 bits of the mask
+    if (syscall(SYS_mbind, begin, end - begin, kMpolInterleave, node_mask.data(),
+                node_mask.size() * kBitsPerLong + 1, kMpolMfMove) != 0) {
+      auto [err_no, err_msg] = GetErrnoInfo();
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "mbind failed. error code: ", err_no, " error msg: ", err_msg);
+    }
+
+    return Status::OK();
+#else
+    ORT_UNUSED_PARAMETER(addr);
+    ORT_UNUSED_PARAMETER(size);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Interleaving memory across NUMA nodes is not supported.");
+#endif
+  }
+
   void SleepForMicroseconds(int64_t micros) const override {
     while (micros > 0) {
       timespec sleep_time;
@@ -16,6 +16,7 @@ limitations under the License.
 
 #include "core/platform/windows/env.h"
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <optional>
@@ -307,6 +308,38 @@ int WindowsEnv::GetL2CacheSize() const {
   return l2_cache_size_;
 }
 
+std::vector<LogicalProcessors> WindowsEnv::GetNumaNodeProcessors() const {
+  std::vector<LogicalProcessors> ret;
+  ULONG highest_node_number = 0;
+  if (!GetNumaHighestNodeNumber(&highest_node_number)) {
+    return ret;
+  }
+
+  ret.resize(static_cast<size_t>(highest_node_number) + 1);
+  for (USHORT node = 0; node <= highest_node_number; ++node) {
+    GROUP_AFFINITY group_affinity{};
+    if (!GetNumaNodeProcessorMaskEx(node, &group_affinity)) {
+      continue;
+    }
+
+    for (const auto& [global_processor_id, processor_info] : global_processor_info_map_) {
+      if (processor_info.group_id == group_affinity.Group &&
+          (group_affinity.Mask & (KAFFINITY{1} << processor_info.local_processor_id)) != 0) {
+        ret[node].push_back(global_processor_id);
+      }
+    }
+
+    std::sort(ret[node].begin(), ret[node].end());
+  }
+
+  return ret;
+}
+
+common::Status WindowsEnv::InterleaveMemoryAcrossNumaNodes(void* /*addr*/, size_t /*size*/) const {
+  // the NUMA node of a page can only be chosen when it is allocated, e.g. with VirtualAllocExNuma
+  return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Interleaving memory across NUMA nodes is not supported.");
+}
+
 WindowsEnv& WindowsEnv::Instance() {
   static WindowsEnv default_env;
   return default_env;
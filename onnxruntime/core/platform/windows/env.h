@@ -56,6 +56,8 @@ class WindowsEnv : public Env {
   int GetNumPhysicalCpuCores() const override;
   std::vector<LogicalProcessors> GetDefaultThreadAffinities() const override;
   int GetL2CacheSize() const override;
+  std::vector<LogicalProcessors> GetNumaNodeProcessors() const override;
+  common::Status InterleaveMemoryAcrossNumaNodes(void* addr, size_t size) const override;
   static WindowsEnv& Instance();
   PIDType GetSelfPid() const override;
   Status GetFileLength(_In_z_ const ORTCHAR_T* file_path, size_t& length) const override;
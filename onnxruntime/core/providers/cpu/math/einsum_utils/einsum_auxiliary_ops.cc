@@ -3,6 +3,11 @@
 
 #include "einsum_auxiliary_ops.h"
 
+#include <type_traits>
+#include <vector>
+
+#include "core/mlas/inc/mlas.h"
+
 using namespace onnxruntime::common;
 
 namespace onnxruntime {
@@ -34,14 +39,35 @@ Status MatMul(const T* input_1_data, const T* input_2_data, T* output_data,
               size_t left_stride, size_t right_stride, size_t output_stride,
               size_t num_batches, size_t M, size_t K, size_t N, concurrency::ThreadPool* tp,
               void* /*einsum_cuda_assets*/) {
-  for (size_t i = 0; i < num_batches; ++i) {
-    math::MatMul<T>(
-        static_cast<int>(M),
-        static_cast<int>(N),
-        static_cast<int>(K),
-        input_1_data + i * left_stride,
-        input_2_data + i * right_stride,
-        output_data + i * output_stride, tp);
+  if (num_batches == 0) {
+    return Status::OK();
+  }
+
+  if constexpr (std::is_same_v<T, float>) {
+    // Run all the batches in one MLAS call so that small matrices are
+    // threaded across the batch instead of one matrix at a time.
+    std::vector<MLAS_SGEMM_DATA_PARAMS> data(num_batches);
+    for (size_t i = 0; i < num_batches; ++i) {
+      data[i].A = input_1_data + i * left_stride;
+      data[i].lda = K;
+      data[i].B = input_2_data + i * right_stride;
+      data[i].ldb = N;
+      data[i].C = output_data + i * output_stride;
+      data[i].ldc = N;
+      data[i].alpha = 1.0f;
+      data[i].beta = 0.0f;
+    }
+    MlasGemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, data.data(), num_batches, tp);
+  } else {
+    for (size_t i = 0; i < num_batches; ++i) {
+      math::MatMul<T>(
+          static_cast<int>(M),
+          static_cast<int>(N),
+          static_cast<int>(K),
+          input_1_data + i * left_stride,
+          input_2_data + i * right_stride,
+          output_data + i * output_stride, tp);
+    }
   }
 
   return Status::OK();
@@ -74,6 +74,27 @@ void Exp<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
   float* output_ptr = output + first;
   MlasComputeExp(input + first, output_ptr, static_cast<size_t>(len));
 }
+
+template <>
+void Log<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
+  ptrdiff_t len = last - first;
+  float* output_ptr = output + first;
+  MlasComputeLog(input + first, output_ptr, static_cast<size_t>(len));
+}
+
+template <>
+void Reciprocal<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
+  ptrdiff_t len = last - first;
+  float* output_ptr = output + first;
+  MlasComputeReciprocal(input + first, output_ptr, static_cast<size_t>(len));
+}
+
+template <>
+void Sqrt<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
+  ptrdiff_t len = last - first;
+  float* output_ptr = output + first;
+  MlasComputeSqrt(input + first, output_ptr, static_cast<size_t>(len));
+}
 }  // namespace functors
 
 #define REG_ELEMENTWISE_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS)         \
@@ -586,6 +607,47 @@ void PowImpl(OpKernelContext& context) {
   UntypedBroadcastTwo(context, funcs, 1.0);
 }
 
+template <>
+void PowImpl<float, float>(OpKernelContext& context) {
+  ProcessBroadcastSpanFuncs funcs{
+      [](BroadcastHelper& per_iter_bh) {
+        const float X = per_iter_bh.ScalarInput0<float>();
+        auto Y = per_iter_bh.SpanInput1<float>();
+        auto output = per_iter_bh.OutputSpan<float>();
+
+        MlasComputePow(&X, Y.data(), output.data(), output.size(), true, false);
+      },
+      [](BroadcastHelper& per_iter_bh) {
+        auto X = per_iter_bh.SpanInput0<float>();
+        const float Y = per_iter_bh.ScalarInput1<float>();
+        auto output = per_iter_bh.OutputSpan<float>();
+
+        // optimize for X^2 and X^3
+        if (Y == 2) {
+          std::transform(X.begin(), X.end(), output.begin(),
+                         [](float x) {
+                           return x * x;
+                         });
+        } else if (Y == 3) {
+          std::transform(X.begin(), X.end(), output.begin(),
+                         [](float x) {
+                           return x * x * x;
+                         });
+        } else {
+          MlasComputePow(X.data(), &Y, output.data(), output.size(), false, true);
+        }
+      },
+      [](BroadcastHelper& per_iter_bh) {
+        auto X = per_iter_bh.SpanInput0<float>();
+        auto Y = per_iter_bh.SpanInput1<float>();
+        auto output = per_iter_bh.OutputSpan<float>();
+
+        MlasComputePow(X.data(), Y.data(), output.data(), output.size(), false, false);
+      }};
+
+  UntypedBroadcastTwo(context, funcs, 1.0);
+}
+
 template <typename B>
 Status DispatchOnBase(OpKernelContext& context, const Tensor& Y) {
   namespace on = ONNX_NAMESPACE;
@@ -1332,7 +1394,11 @@ class Sin final : public OpKernel {
   Status Compute(OpKernelContext* context) const override {
     auto& X = *context->Input<Tensor>(0);
     auto& Y = *context->Output(0, X.Shape());
-    MakeEigenArrayMap<T>(Y) = MakeEigenArrayMap<T>(X).sin();
+    if constexpr (std::is_same_v<T, float>) {
+      MlasComputeSin(X.Data<float>(), Y.MutableData<float>(), narrow<size_t>(X.Shape().Size()));
+    } else {
+      MakeEigenArrayMap<T>(Y) = MakeEigenArrayMap<T>(X).sin();
+    }
     return Status::OK();
   }
 };
@@ -1360,7 +1426,7 @@ class Cos final : public OpKernel {
   Status Compute(OpKernelContext* context) const override {
     auto& X = *context->Input<Tensor>(0);
     auto& Y = *context->Output(0, X.Shape());
-    MakeEigenArrayMap<float>(Y) = MakeEigenArrayMap<float>(X).cos();
+    MlasComputeCos(X.Data<float>(), Y.MutableData<float>(), narrow<size_t>(X.Shape().Size()));
     return Status::OK();
   }
 };
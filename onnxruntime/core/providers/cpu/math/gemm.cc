@@ -199,42 +199,54 @@ void Gemm<MLFloat16>::ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans
 
   if (c_data == nullptr)
     beta = onnxruntime::MLFloat16::Zero;
-#ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
-  bool support_mlas = false;
-  if (c_shape == nullptr) {
-    support_mlas = true;
-  } else if (c_shape->NumDimensions() == 1 && (*c_shape)[0] == N) {
-    support_mlas = true;
-  } else if (c_shape->NumDimensions() == 2 && (((*c_shape)[0] == 1 && (*c_shape)[1] == N) || ((*c_shape)[0] == N && (*c_shape)[1] == 1))) {
-    support_mlas = true;
-  }
-  if (trans_a == CblasNoTrans && trans_b == CblasNoTrans && support_mlas && alpha.ToFloat() == 1.0 && beta.ToFloat() == 1.0) {
-    MLAS_HALF_GEMM_DATA_PARAMS data;
-    data.A = a_data;
-    data.lda = K;
-    data.B = b_data;
-    data.ldb = N;
-    data.C = y_data;
-    data.ldc = N;
-    if (c_shape != nullptr) {
-      data.Bias = c_data;
+
+  // MLAS computes A * B + Bias, where the optional bias is broadcast from a row of N elements.
+  if (trans_a == CblasNoTrans && trans_b == CblasNoTrans && alpha.ToFloat() == 1.0f &&
+      MlasFp16AccelerationSupported()) {
+    bool support_mlas = false;
+    const MLFloat16* bias_data = nullptr;
+    if (beta.ToFloat() == 0.0f) {
+      support_mlas = true;
+    } else if (beta.ToFloat() == 1.0f && c_shape != nullptr &&
+               ((c_shape->NumDimensions() == 1 && (*c_shape)[0] == N) ||
+                (c_shape->NumDimensions() == 2 && (*c_shape)[0] == 1 && (*c_shape)[1] == N))) {
+      support_mlas = true;
+      bias_data = c_data;
+    }
+    if (support_mlas) {
+      MLAS_HALF_GEMM_DATA_PARAMS data;
+      data.A = a_data;
+      data.lda = K;
+      data.B = b_data;
+      data.ldb = N;
+      data.C = y_data;
+      data.ldc = N;
+      data.Bias = bias_data;
+      MlasHalfGemmBatch(M, N, K, 1, &data, thread_pool);
+      return;
     }
-    MlasHalfGemmBatch(M, N, K, 1, &data, thread_pool);
-    return;
   }
-#endif
-  // Fallback to Eigen
-  // Broadcast the bias as needed if bias is given
-  GemmBroadcastBias(M, N, beta, c_data, c_shape, y_data);
-#if defined(__GNUC__)
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wstrict-aliasing"
-#endif
-  math::Gemm<Eigen::half>(trans_a, trans_b, M, N, K, *reinterpret_cast<Eigen::half*>(&alpha),
-                          reinterpret_cast<const Eigen::half*>(a_data), reinterpret_cast<const Eigen::half*>(b_data), *reinterpret_cast<Eigen::half*>(&beta), reinterpret_cast<Eigen::half*>(y_data), thread_pool);
-#if defined(__GNUC__)
-#pragma GCC diagnostic pop
-#endif
+  // The other cases run the MLAS float gemm: A, B and the broadcast bias are converted to fp32, and the result is
+  // converted back.
+  const size_t a_size = SafeInt<size_t>(M) * K;
+  const size_t b_size = SafeInt<size_t>(K) * N;
+  const size_t y_size = SafeInt<size_t>(M) * N;
+  std::vector<float> a_float(a_size);
+  std::vector<float> b_float(b_size);
+  std::vector<float> y_float(y_size);
+  MlasConvertHalfToFloatBuffer(a_data, a_float.data(), a_size);
+  MlasConvertHalfToFloatBuffer(b_data, b_float.data(), b_size);
+
+  const float beta_float = beta.ToFloat();
+  if (beta_float != 0.0f) {
+    std::vector<float> c_float(static_cast<size_t>(c_shape->Size()));
+    MlasConvertHalfToFloatBuffer(c_data, c_float.data(), c_float.size());
+    GemmBroadcastBias(M, N, beta_float, c_float.data(), c_shape, y_float.data());
+  }
+
+  math::Gemm<float>(trans_a, trans_b, M, N, K, alpha.ToFloat(), a_float.data(), b_float.data(),
+                    beta_float, y_float.data(), thread_pool);
+  MlasConvertFloatToHalfBuffer(y_float.data(), y_data, y_size);
 }
 
 template void Gemm<float>::ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
@@ -294,6 +306,30 @@ Status Gemm<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prep
   return Status::OK();
 }
 
+template <typename T>
+int Gemm<T>::GetPrePackFormatVersion(int /*input_idx*/) const {
+  return 0;
+}
+
+template <>
+int Gemm<float>::GetPrePackFormatVersion(int input_idx) const {
+  return input_idx == 1 ? 1 : 0;
+}
+
+template <typename T>
+Status Gemm<T>::RestorePrePackState(const Tensor& /*tensor*/, int /*input_idx*/) {
+  ORT_NOT_IMPLEMENTED(__FUNCTION__, " is not implemented");
+}
+
+template <>
+Status Gemm<float>::RestorePrePackState(const Tensor& tensor, int input_idx) {
+  if (input_idx == 1) {
+    b_shape_ = tensor.Shape();
+  }
+
+  return Status::OK();
+}
+
 template <typename T>
 void Gemm<T>::ComputeActivation(_Inout_updates_(y_size) T* y_data, ptrdiff_t y_size, _Inout_opt_ concurrency::ThreadPool* thread_pool) const {
   if (activation_) {
@@ -418,25 +454,69 @@ Status Gemm<float>::Compute(OpKernelContext* context) const {
   const float* c_data = C != nullptr ? C->Data<float>() : nullptr;
   const TensorShape* c_shape = C != nullptr ? &C->Shape() : nullptr;
 
-  if (B) {
+  // MLAS adds a bias of N elements or a M x N bias, and applies the fused activation, to the
+  // output tiles in the SGEMM epilogue. This saves the passes over Y that broadcast the bias
+  // before the multiplication and apply the activation after it.
+  MLAS_SGEMM_EPILOGUE epilogue;
+  if (c_data != nullptr && beta_ == 1.0f) {
+    if (c_shape->Size() == N &&
+        (c_shape->NumDimensions() == 1 || (c_shape->NumDimensions() == 2 && (*c_shape)[0] == 1))) {
+      epilogue.Bias = c_data;
+    } else if (c_shape->NumDimensions() == 2 && (*c_shape)[0] == M && (*c_shape)[1] == N) {
+      epilogue.Residual = c_data;
+      epilogue.ldr = static_cast<size_t>(N);
+    }
+  }
+  if (epilogue_activation_.has_value()) {
+    epilogue.Activation = &*epilogue_activation_;
+  }
+
+  if (epilogue.Bias != nullptr || epilogue.Residual != nullptr || epilogue.Activation != nullptr) {
+    float beta = 0.0f;
+    if (epilogue.Bias == nullptr && epilogue.Residual == nullptr && c_data != nullptr) {
+      // The bias is broadcast along the columns or is a scalar, add it in the multiplication.
+      GemmBroadcastBias(M, N, beta_, c_data, c_shape, y_data);
+      beta = beta_;
+    }
+
+    MLAS_SGEMM_DATA_PARAMS data;
+    data.A = A->Data<float>();
+    data.lda = static_cast<size_t>(trans_A_ != CblasNoTrans ? M : K);
+    if (B) {
+      data.B = B->Data<float>();
+      data.ldb = static_cast<size_t>(trans_B_ != CblasNoTrans ? K : N);
+    } else {
+      data.B = static_cast<const float*>(packed_b_.get());
+      data.BIsPacked = true;
+    }
+    data.C = y_data;
+    data.ldc = static_cast<size_t>(N);
+    data.alpha = alpha_;
+    data.beta = beta;
+    data.Epilogue = &epilogue;
+    data.UseJitKernels = use_jit_kernels_;
+
+    MlasGemmBatch(trans_A_, trans_B_, static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K),
+                  &data, 1, thread_pool);
+  } else if (B) {
     ComputeGemm(trans_A_, trans_B_, M, N, K, alpha_, A->Data<float>(), B->Data<float>(), beta_,
                 c_data, c_shape, y_data, thread_pool);
   } else {
     GemmBroadcastBias(M, N, beta_, c_data, c_shape, y_data);
     if (K > 0) {
-      MlasGemm(
-          trans_A_,
-          static_cast<size_t>(M),
-          static_cast<size_t>(N),
-          static_cast<size_t>(K),
-          alpha_,
-          A->Data<float>(),
-          static_cast<size_t>(trans_A_ != CblasNoTrans ? M : K),
-          packed_b_.get(),
-          c_data != nullptr ? beta_ : 0.0f,
-          y_data,
-          static_cast<size_t>(N),
-          thread_pool);
+      MLAS_SGEMM_DATA_PARAMS data;
+      data.A = A->Data<float>();
+      data.lda = static_cast<size_t>(trans_A_ != CblasNoTrans ? M : K);
+      data.B = static_cast<const float*>(packed_b_.get());
+      data.BIsPacked = true;
+      data.C = y_data;
+      data.ldc = static_cast<size_t>(N);
+      data.alpha = alpha_;
+      data.beta = c_data != nullptr ? beta_ : 0.0f;
+      data.UseJitKernels = use_jit_kernels_;
+
+      MlasGemmBatch(trans_A_, CblasNoTrans, static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K),
+                    &data, 1, thread_pool);
     } else if (beta_ == 0 || c_data == nullptr) {
       EigenMatrixMapRowMajor<float> dest(y_data, narrow<Eigen::Index>(M), narrow<Eigen::Index>(N));
       dest.setZero();
@@ -5,10 +5,14 @@
 
 #include "gemm_base.h"
 
+#include <optional>
+
 #include "core/framework/op_kernel.h"
 #include "core/common/common.h"
 #include "core/util/math.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/providers/cpu/activation/activations.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
 
@@ -16,6 +20,8 @@ template <typename T>
 class Gemm : protected GemmBase, public OpKernel {
  public:
   Gemm(const OpKernelInfo& info) : GemmBase(info), OpKernel(info) {
+    use_jit_kernels_ = info.GetConfigOptions().GetConfigEntry(kOrtSessionOptionsMlasEnableJitKernels) == "1" &&
+                       MlasJitKernelsSupported();
   }
 
   Status Compute(OpKernelContext* context) const override;
@@ -28,6 +34,10 @@ class Gemm : protected GemmBase, public OpKernel {
                                    int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  int GetPrePackFormatVersion(int input_idx) const override;
+
+  Status RestorePrePackState(const Tensor& tensor, int input_idx) override;
+
   static void ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
                           ptrdiff_t M, ptrdiff_t N, ptrdiff_t K,
                           T alpha,
@@ -44,6 +54,12 @@ class Gemm : protected GemmBase, public OpKernel {
   // For fused gemm + activation
   std::unique_ptr<functors::ElementWiseRangedTransform<T>> activation_;
 
+  // For fused gemm + activation, when MLAS applies the activation in the SGEMM epilogue
+  std::optional<MLAS_ACTIVATION> epilogue_activation_;
+
+  // Use the MLAS SGEMM kernels generated at runtime for the packed weights
+  bool use_jit_kernels_{false};
+
   void ComputeActivation(_Inout_updates_(y_size) T* y_data, ptrdiff_t y_size, _Inout_opt_ concurrency::ThreadPool* thread_pool) const;
 };
 
@@ -4,6 +4,7 @@
 #include "core/providers/cpu/math/matmul.h"
 #include "core/providers/cpu/math/gemm_matmul_common.h"
 #include "core/providers/cpu/math/matmul_helper.h"
+#include "core/providers/cpu/tunable/gemm.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 
@@ -88,6 +89,30 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
         .TypeConstraint("T", BuildKernelDefConstraints<int64_t, uint64_t>()),
     MatMul<int64_t>);
 
+// The MLFloat16 kernels are only registered when MlasFp16AccelerationSupported() is true,
+// see RegisterFp16MathKernels in cpu_execution_provider.cc.
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    MatMul,
+    1, 8,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    MatMul<MLFloat16>);
+
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    MatMul,
+    9,
+    12,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    MatMul<MLFloat16>);
+
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    MatMul,
+    13,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    MatMul<MLFloat16>);
+
 template <typename T>
 Status MatMul<T>::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
@@ -133,7 +158,53 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
 
   return Status::OK();
 }
-#if defined(__aarch64__) && defined(__linux__)
+template <>
+Status MatMul<MLFloat16>::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  const auto* a = ctx->Input<Tensor>(0);
+  const auto* b = ctx->Input<Tensor>(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+
+  // Bail out early if the output is going to be empty
+  if (y->Shape().Size() == 0)
+    return Status::OK();
+
+  auto* y_data = y->MutableData<MLFloat16>();
+
+  if (helper.K() == 0) {
+    // When we have (M, 0, N) then the inputs are empty, but the output should
+    // be filled out with zeros.
+    std::fill_n(y_data, narrow<size_t>(y->Shape().Size()), MLFloat16::Zero);
+    return Status::OK();
+  }
+
+  const auto* a_data = a->Data<MLFloat16>();
+  const auto* b_data = b->Data<MLFloat16>();
+
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+  const size_t max_len = helper.OutputOffsets().size();
+
+  std::vector<MLAS_HALF_GEMM_DATA_PARAMS> data(max_len);
+  for (size_t i = 0; i < max_len; i++) {
+    data[i].A = a_data + helper.LeftOffsets()[i];
+    data[i].lda = K;
+    data[i].B = b_data + helper.RightOffsets()[i];
+    data[i].ldb = N;
+    data[i].C = y_data + helper.OutputOffsets()[i];
+    data[i].ldc = N;
+  }
+  MlasHalfGemmBatch(M, N, K, max_len, data.data(), thread_pool);
+
+  return Status::OK();
+}
+
+#if defined(MLAS_SBGEMM_SUPPORTED)
 bool GemmPackBBfloat16(AllocatorPtr& alloc,
                        const Tensor& tensor_b,
                        bool trans_b,
@@ -172,6 +243,43 @@ bool GemmPackBBfloat16(AllocatorPtr& alloc,
 }
 #endif
 
+bool GemmPackBSparse(AllocatorPtr& alloc,
+                     const Tensor& tensor_b,
+                     float sparsity_threshold,
+                     IAllocatorUniquePtr<void>& packed_b,
+                     size_t& packed_b_size,
+                     TensorShape& b_shape) {
+  // Only handle a 2D weight matrix that is not transposed.
+  if (tensor_b.Shape().NumDimensions() != 2) {
+    return false;
+  }
+
+  const size_t K = static_cast<size_t>(tensor_b.Shape()[0]);
+  const size_t N = static_cast<size_t>(tensor_b.Shape()[1]);
+  const float* b_data = tensor_b.Data<float>();
+
+  if (MlasSparseGemmBlockSparsity(N, K, b_data, N) < sparsity_threshold) {
+    return false;
+  }
+
+  packed_b_size = MlasSparseGemmPackBSize(N, K, b_data, N);
+  if (packed_b_size == 0) {
+    return false;
+  }
+
+  b_shape = tensor_b.Shape();
+
+  packed_b = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size, true);
+  auto* packed_b_data = packed_b.get();
+
+  // Initialize memory to 0 as there could be some padding associated with pre-packed
+  // buffer memory and we do not want it uninitialized and generate different hashes
+  // if and when we try to cache this pre-packed buffer for sharing between sessions.
+  memset(packed_b_data, 0, packed_b_size);
+  MlasSparseGemmPackB(N, K, b_data, N, packed_b_data);
+  return true;
+}
+
 Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ AllocatorPtr alloc,
                               /*out*/ bool& is_packed,
                               /*out*/ PrePackedWeights* prepacked_weights) {
@@ -180,7 +288,7 @@ Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ Alloc
   // only pack Matrix B
   if (input_idx == 1) {
     size_t packed_b_size;
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
     size_t dim1 = 0;
     size_t dim2 = 0;
     TensorShape b_shape = tensor.Shape();
@@ -195,13 +303,31 @@ Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ Alloc
     } else
 #endif
     {
-      is_packed = GemmPackBFp32(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
+      // the block sparse kernel neither transposes nor scales the product
+      if (trans_a_attr_ == 0 && trans_b_attr_ == 0 && alpha_attr_ == 1.0f) {
+        sparse_packed_b_ = GemmPackBSparse(alloc, tensor, kSparseGemmBlockSparsityThreshold,
+                                           packed_b_, packed_b_size, b_shape_);
+        is_packed = sparse_packed_b_;
+      }
+      if (!is_packed) {
+        is_packed = GemmPackBFp32(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
+      }
     }
 
     bool share_prepacked_weights = (prepacked_weights != nullptr);
     if (is_packed && share_prepacked_weights) {
+      // B is shared in the first buffer when packed for the dense kernels, and in the second one when packed in the
+      // block sparse format, so that the format is restored along with the buffers.
+      if (sparse_packed_b_) {
+        prepacked_weights->buffers_.push_back(nullptr);
+        prepacked_weights->buffer_sizes_.push_back(0);
+      }
       prepacked_weights->buffers_.push_back(std::move(packed_b_));
       prepacked_weights->buffer_sizes_.push_back(packed_b_size);
+      if (!sparse_packed_b_) {
+        prepacked_weights->buffers_.push_back(nullptr);
+        prepacked_weights->buffer_sizes_.push_back(0);
+      }
     }
   }
   return Status::OK();
@@ -214,7 +340,17 @@ Status MatMul<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& pr
 
   if (input_idx == 1) {
     used_shared_buffers = true;
-    packed_b_ = std::move(prepacked_buffers[0]);
+    sparse_packed_b_ = prepacked_buffers[0] == nullptr;
+    packed_b_ = std::move(prepacked_buffers[sparse_packed_b_ ? 1 : 0]);
+  }
+
+  return Status::OK();
+}
+
+Status MatMul<float>::RestorePrePackState(const Tensor& tensor, int input_idx) {
+  // every packed format of B records its shape, the format itself is restored with the buffers
+  if (input_idx == 1) {
+    b_shape_ = tensor.Shape();
   }
 
   return Status::OK();
@@ -258,7 +394,20 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   const size_t K = static_cast<size_t>(helper.K());
   const size_t lda = helper.Lda(trans_a);
   const size_t ldb = helper.Ldb(trans_b);
-#if defined(__aarch64__) && defined(__linux__)
+  if (sparse_packed_b_ && packed_b_) {
+    std::vector<MLAS_SPARSE_GEMM_DATA_PARAMS> data(max_len);
+    for (size_t i = 0; i < max_len; i++) {
+      data[i].A = a_data + helper.LeftOffsets()[i];
+      data[i].lda = lda;
+      data[i].PackedB = packed_b_.get();
+      data[i].C = y_data + helper.OutputOffsets()[i];
+      data[i].ldc = N;
+    }
+    MlasSparseGemmBatch(M, N, K, data.data(), max_len, thread_pool);
+    return Status::OK();
+  }
+
+#if defined(MLAS_SBGEMM_SUPPORTED)
   if (use_fastmath_mode_ && !trans_b && ((N * K) >= kFastMathModeKernelsizeThreshold)) {
     std::vector<MLAS_SBGEMM_DATA_PARAMS> data(max_len);
     for (size_t i = 0; i < max_len; i++) {
@@ -288,9 +437,12 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
       data[i].ldc = N;
       data[i].alpha = alpha_attr_;
       data[i].beta = 0.0f;
+      data[i].UseJitKernels = use_jit_kernels_;
     }
-    MlasGemmBatch(trans_a ? CblasTrans : CblasNoTrans, trans_b ? CblasTrans : CblasNoTrans,
-                  M, N, K, data.data(), max_len, thread_pool);
+    ORT_RETURN_IF_ERROR(cpu::tunable::SgemmBatch(tuning_ctx_,
+                                                 trans_a ? CblasTrans : CblasNoTrans,
+                                                 trans_b ? CblasTrans : CblasNoTrans,
+                                                 M, N, K, data.data(), max_len, thread_pool));
   }
   return Status::OK();
 }
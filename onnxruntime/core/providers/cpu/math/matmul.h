@@ -5,6 +5,7 @@
 
 #include "core/framework/op_kernel.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/tunable/cpu_tunable.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
@@ -30,10 +31,20 @@ class MatMul<float> final : public OpKernel {
     trans_batch_a_ = trans_batch_a_attr != 0;
     trans_batch_b_ = trans_batch_b_attr != 0;
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
+#if defined(__aarch64__)
     auto config_ops = info.GetConfigOptions().GetConfigEntry(kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16);
-    use_fastmath_mode_ = (config_ops == "1") && MlasBf16AccelerationSupported();
+#else
+    auto config_ops = info.GetConfigOptions().GetConfigEntry(kOrtSessionOptionsMlasGemmFastMathX64Bfloat16);
 #endif
+    // the sbgemm path neither transposes A nor scales the product, which FusedMatMul may ask for
+    use_fastmath_mode_ = (config_ops == "1") && MlasBf16AccelerationSupported() &&
+                         trans_a_attr_ == 0 && alpha_attr_ == 1.0f;
+#endif
+
+    use_jit_kernels_ = info.GetConfigOptions().GetConfigEntry(kOrtSessionOptionsMlasEnableJitKernels) == "1" &&
+                       MlasJitKernelsSupported();
+    tuning_ctx_ = cpu::tunable::GetCpuTuningContext(info);
   }
 
   Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
@@ -43,11 +54,20 @@ class MatMul<float> final : public OpKernel {
   Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  int GetPrePackFormatVersion(int input_idx) const override { return input_idx == 1 ? 1 : 0; }
+
+  Status RestorePrePackState(const Tensor& tensor, int input_idx) override;
+
   Status Compute(OpKernelContext* context) const override;
 
  private:
   TensorShape b_shape_;
   IAllocatorUniquePtr<void> packed_b_;
+  // packed_b_ holds B in the MLAS block sparse format
+  bool sparse_packed_b_{false};
+  // the block sparse kernel is faster than the dense SGEMM once about half of the
+  // 1x16 row blocks of B are zero, below that the index overhead dominates
+  const float kSparseGemmBlockSparsityThreshold = 0.5f;
 
   // For FusedMatMul contrib ops
   float alpha_attr_;
@@ -55,8 +75,12 @@ class MatMul<float> final : public OpKernel {
   int64_t trans_b_attr_;
   bool trans_batch_a_;
   bool trans_batch_b_;
+  // use the MLAS SGEMM kernels generated at runtime for the packed weights
+  bool use_jit_kernels_{false};
+  // tunes the thread partitioning of the SGEMM when TunableOp is enabled for the CPU EP
+  cpu::tunable::CpuTuningContext* tuning_ctx_{nullptr};
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
   // fastmath mode state
   bool use_fastmath_mode_;
   // sbgemm kernel is implemented as 8x8 blocks with weights pre-packed to 4 blocks of 4x2
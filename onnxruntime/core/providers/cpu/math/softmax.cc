@@ -108,6 +108,54 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
     Softmax<double>);
 
+// The MLFloat16 kernels compute in fp32 and are only registered when MlasFp16AccelerationSupported()
+// is true, see RegisterFp16MathKernels in cpu_execution_provider.cc.
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    Softmax,
+    1,
+    10,
+    MLFloat16,
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Softmax<MLFloat16>);
+
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    Softmax,
+    11,
+    12,
+    MLFloat16,
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Softmax<MLFloat16>);
+
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    Softmax,
+    13,
+    MLFloat16,
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Softmax<MLFloat16>);
+
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    LogSoftmax,
+    1,
+    10,
+    MLFloat16,
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Softmax<MLFloat16>);
+
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    LogSoftmax,
+    11,
+    12,
+    MLFloat16,
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Softmax<MLFloat16>);
+
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    LogSoftmax,
+    13,
+    MLFloat16,
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Softmax<MLFloat16>);
+
 // opset-12 and below
 template <typename T>
 Status Softmax<T>::ComputeImpl(const Tensor& input, Tensor& output, size_t axis,
@@ -24,6 +24,7 @@
 #include <cmath>
 #include <gsl/gsl>
 
+#include "core/common/safeint.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "core/mlas/inc/mlas.h"
@@ -103,4 +104,21 @@ common::Status SoftmaxCPU<float>(size_t N,
   return Status::OK();
 }
 
+template <>
+common::Status SoftmaxCPU<MLFloat16>(size_t N,
+                                     size_t D,
+                                     const MLFloat16* Xdata,
+                                     MLFloat16* Ydata,
+                                     bool logarithmic,
+                                     onnxruntime::concurrency::ThreadPool* thread_pool) {
+  // Softmax is computed in fp32, the input and the result are converted in place in one buffer.
+  const size_t count = SafeInt<size_t>(N) * D;
+  std::vector<float> buffer(count);
+
+  MlasConvertHalfToFloatBuffer(Xdata, buffer.data(), count);
+  MlasComputeSoftmax(buffer.data(), buffer.data(), N, D, logarithmic, false, thread_pool);
+  MlasConvertFloatToHalfBuffer(buffer.data(), Ydata, count);
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
@@ -19,6 +19,7 @@
 
 #include "core/common/narrow.h"
 #include "core/common/safeint.h"
+#include "core/providers/cpu/tunable/conv.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -214,36 +215,29 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
   concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
 
   if (kernel_rank >= 1 && kernel_rank <= 3) {
-    MLAS_CONV_PARAMETERS Parameters;
-    size_t WorkingBufferSize;
-    MlasConvPrepare(&Parameters,
-                    kernel_rank,
-                    narrow<size_t>(N),
-                    narrow<size_t>(conv_attrs_.group),
-                    narrow<size_t>(C / conv_attrs_.group),
-                    input_shape.GetDims().data(),
-                    kernel_shape.data(),
-                    dilations.data(),
-                    pads.data(),
-                    strides.data(),
-                    output_shape.GetDims().data(),
-                    narrow<size_t>(M / conv_attrs_.group),
-                    &activation_,
-                    &WorkingBufferSize,
-                    Beta,
-                    thread_pool);
-
-    auto* working_data = WorkingBufferSize > 0 ? alloc->Alloc(sizeof(float) * SafeInt<size_t>(WorkingBufferSize))
-                                               : nullptr;
-    BufferUniquePtr working_buffer(working_data, BufferDeleter(std::move(alloc)));
-
-    MlasConv(&Parameters,
-             Xdata.data(),
-             W->Data<float>(),
-             Bdata,
-             static_cast<float*>(working_buffer.get()),
-             Ydata.data(),
-             thread_pool);
+    cpu::tunable::ConvParams params;
+    params.dimensions = kernel_rank;
+    params.batch_count = narrow<size_t>(N);
+    params.group_count = narrow<size_t>(conv_attrs_.group);
+    params.input_channels = narrow<size_t>(C / conv_attrs_.group);
+    params.input_shape = input_shape.GetDims().data();
+    params.kernel_shape = kernel_shape.data();
+    params.dilation_shape = dilations.data();
+    params.padding = pads.data();
+    params.stride_shape = strides.data();
+    params.output_shape = output_shape.GetDims().data();
+    params.filter_count = narrow<size_t>(M / conv_attrs_.group);
+    params.activation = &activation_;
+    params.beta = Beta;
+    params.use_jit_kernels = use_jit_kernels_;
+    params.input = Xdata.data();
+    params.filter = W->Data<float>();
+    params.bias = Bdata;
+    params.output = Ydata.data();
+    params.allocator = std::move(alloc);
+    params.thread_pool = thread_pool;
+
+    ORT_RETURN_IF_ERROR(cpu::tunable::Conv(tuning_ctx_, params));
   } else {
     const int64_t input_image_size = input_shape.Size();
     const int64_t output_image_size = output_shape.Size();
@@ -6,6 +6,8 @@
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/nn/conv_attributes.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/tunable/cpu_tunable.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
 
@@ -26,6 +28,9 @@ class Conv<float> : public OpKernel {
  public:
   Conv(const OpKernelInfo& info) : OpKernel(info), conv_attrs_(info) {
     activation_.ActivationKind = MlasIdentityActivation;
+    use_jit_kernels_ = info.GetConfigOptions().GetConfigEntry(kOrtSessionOptionsMlasEnableJitKernels) == "1" &&
+                       MlasJitKernelsSupported();
+    tuning_ctx_ = cpu::tunable::GetCpuTuningContext(info);
   }
 
   Status Compute(OpKernelContext* context) const override;
@@ -34,6 +39,12 @@ class Conv<float> : public OpKernel {
   MLAS_ACTIVATION activation_;
 
   ConvAttributes conv_attrs_;
+
+  // Use the MLAS SGEMM kernels generated at runtime for the short output channel blocks
+  bool use_jit_kernels_{false};
+
+  // Tunes the thread partitioning of the convolution when TunableOp is enabled for the CPU EP
+  cpu::tunable::CpuTuningContext* tuning_ctx_{nullptr};
 };
 
 }  // namespace onnxruntime
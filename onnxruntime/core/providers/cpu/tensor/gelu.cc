@@ -19,12 +19,21 @@ namespace onnxruntime {
 
 // May revisit the implementations to support inplace computation, if needed.
 
-ONNX_CPU_OPERATOR_KERNEL(
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Gelu,
     20,
+    float,
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Gelu<float>);
 
+// Only registered when MlasFp16AccelerationSupported() is true, see RegisterFp16MathKernels.
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    Gelu,
+    20,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Gelu<MLFloat16>);
+
 #ifndef DISABLE_CONTRIB_OPS
 namespace contrib {
 ONNX_OPERATOR_KERNEL_EX(
@@ -37,6 +46,40 @@ ONNX_OPERATOR_KERNEL_EX(
 }
 #endif
 
+namespace {
+
+// FastGelu uses approximation for Gelu. The formula is 0.5 * (1 + Tanh(x * (C * x * x + B))) * x.
+void ComputeGeluTanh(const float* input, float* output, size_t count) {
+  static constexpr float B = 0.7978845608028654f;    // sqrt(2.0 / M_PI)
+  static constexpr float C = 0.035677408136300125f;  // 0.044715 * sqrt(2.0 / M_PI)
+
+  for (size_t i = 0; i < count; i++) {
+    float value = input[i];
+    output[i] = value * (C * value * value + B);
+  }
+
+  MlasComputeTanh(output, output, count);
+
+  for (size_t i = 0; i < count; i++) {
+    output[i] = 0.5f * input[i] * (output[i] + 1.0f);
+  }
+}
+
+void ComputeGeluErf(const float* input, float* output, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    float value = input[i];
+    output[i] = value * static_cast<float>(M_SQRT1_2);
+  }
+
+  MlasComputeErf(output, output, count);
+
+  for (size_t i = 0; i < count; i++) {
+    output[i] = 0.5f * input[i] * (output[i] + 1.0f);
+  }
+}
+
+}  // namespace
+
 template <typename T>
 Status Gelu<T>::Compute(OpKernelContext* context) const {
   const Tensor* input = context->Input<Tensor>(0);
@@ -54,28 +97,12 @@ Status Gelu<T>::Compute(OpKernelContext* context) const {
     // FastGelu allows optional bias. Here we split input data into chunks. Each chunk
     // has N elements (except the last chunk), and use thread pool to parallel chunks.
     // N = 4096 is selected based on performance test results on input shape 1x128x768.
-    // FastGelu uses approximation for Gelu. The formula is 0.5 * (1 + Tanh(x * (C * x * x + B))) * x.
-    static constexpr float B = 0.7978845608028654f;    // sqrt(2.0 / M_PI)
-    static constexpr float C = 0.035677408136300125f;  // 0.044715 * sqrt(2.0 / M_PI)
-
     concurrency::ThreadPool::TryBatchParallelFor(
         tp, static_cast<int32_t>(task_count),
         [&](ptrdiff_t task_idx) {
           const auto start = task_idx * length_per_task;
-          const T* p_input = input_data + start;
-          T* p_output = output_data + start;
           int64_t count = std::min(length_per_task, elem_count - start);
-
-          for (int64_t i = 0; i < count; i++) {
-            T value = p_input[i];
-            p_output[i] = value * (static_cast<T>(C) * value * value + static_cast<T>(B));
-          }
-
-          MlasComputeTanh(p_output, p_output, narrow<size_t>(count));
-
-          for (int64_t i = 0; i < count; i++) {
-            p_output[i] = 0.5f * p_input[i] * (p_output[i] + 1.0f);
-          }
+          ComputeGeluTanh(input_data + start, output_data + start, narrow<size_t>(count));
         },
         0);
     return Status::OK();
@@ -84,20 +111,8 @@ Status Gelu<T>::Compute(OpKernelContext* context) const {
         tp, static_cast<int32_t>(task_count),
         [&](ptrdiff_t task_idx) {
           const auto start = task_idx * length_per_task;
-          const T* p_input = input_data + start;
-          T* p_output = output_data + start;
           int64_t count = std::min(length_per_task, elem_count - start);
-
-          for (int64_t i = 0; i < count; i++) {
-            T value = p_input[i];
-            p_output[i] = value * static_cast<T>(M_SQRT1_2);
-          }
-
-          MlasComputeErf(p_output, p_output, narrow<size_t>(count));
-
-          for (int64_t i = 0; i < count; i++) {
-            p_output[i] = 0.5f * p_input[i] * (p_output[i] + 1.0f);
-          }
+          ComputeGeluErf(input_data + start, output_data + start, narrow<size_t>(count));
         },
         0);
     return Status::OK();
@@ -105,4 +120,45 @@ Status Gelu<T>::Compute(OpKernelContext* context) const {
   return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Unsupported approximation_algorithm: ", approximation_algorithm_);
 }
 
+// The fp16 kernel converts each chunk to fp32, computes it with the fp32 routines and converts the result back.
+template <>
+Status Gelu<MLFloat16>::Compute(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+  const MLFloat16* input_data = input->Data<MLFloat16>();
+
+  Tensor* output = context->Output(0, input->Shape());
+  MLFloat16* output_data = output->MutableData<MLFloat16>();
+
+  const bool use_tanh = approximation_algorithm_ == "tanh";
+  if (!use_tanh && approximation_algorithm_ != "none") {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Unsupported approximation_algorithm: ", approximation_algorithm_);
+  }
+
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
+  int64_t elem_count = input->Shape().Size();
+  constexpr int64_t length_per_task = 4096;  // this number comes from FastGelu.
+  int64_t task_count = (elem_count + length_per_task - 1) / length_per_task;
+
+  concurrency::ThreadPool::TryBatchParallelFor(
+      tp, static_cast<int32_t>(task_count),
+      [&](ptrdiff_t task_idx) {
+        const auto start = task_idx * length_per_task;
+        const size_t count = narrow<size_t>(std::min(length_per_task, elem_count - start));
+
+        std::vector<float> buffer(count * 2);
+        float* input_fp32 = buffer.data();
+        float* output_fp32 = buffer.data() + count;
+
+        MlasConvertHalfToFloatBuffer(input_data + start, input_fp32, count);
+        if (use_tanh) {
+          ComputeGeluTanh(input_fp32, output_fp32, count);
+        } else {
+          ComputeGeluErf(input_fp32, output_fp32, count);
+        }
+        MlasConvertFloatToHalfBuffer(output_fp32, output_data + start, count);
+      },
+      0);
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
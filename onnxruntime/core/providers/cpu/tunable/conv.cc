@@ -0,0 +1,192 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/tunable/conv.h"
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/safeint.h"
+#include "core/framework/buffer_deleter.h"
+#include "core/providers/cpu/tunable/util.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+namespace {
+
+// The thread counts tried for each partitioning. Tuning results store the index of the candidate and the candidates
+// are registered for each thread count in turn, so entries may only be appended.
+constexpr ptrdiff_t kCandidateThreadCounts[] = {1, 2, 4, 6, 8, 12, 16, 24, 32, 48, 64, 96, 128, 192, 256};
+
+void PrepareConv(const ConvParams* params, const MLAS_THREADING_PARAMS* threading,
+                 MLAS_CONV_PARAMETERS& parameters, size_t& working_buffer_size) {
+  MlasConvPrepare(&parameters,
+                  params->dimensions,
+                  params->batch_count,
+                  params->group_count,
+                  params->input_channels,
+                  params->input_shape,
+                  params->kernel_shape,
+                  params->dilation_shape,
+                  params->padding,
+                  params->stride_shape,
+                  params->output_shape,
+                  params->filter_count,
+                  params->activation,
+                  &working_buffer_size,
+                  params->beta,
+                  params->thread_pool,
+                  threading);
+}
+
+// MLAS only partitions the output of the convolution across threads when it runs the threaded GEMM, for the other
+// algorithms only the thread count applies.
+bool IsGemmPartitioned(const ConvParams* params) {
+  MLAS_CONV_PARAMETERS parameters;
+  size_t working_buffer_size;
+  PrepareConv(params, nullptr, parameters, working_buffer_size);
+  if (parameters.Algorithm == MlasConvAlgorithmGemmDirect) {
+    // Batches and groups of direct GEMMs run on one thread each.
+    return params->batch_count == 1 && params->group_count == 1;
+  }
+  return parameters.Algorithm == MlasConvAlgorithmExpandThenGemm;
+}
+
+Status RunConv(const ConvParams* params, const MLAS_THREADING_PARAMS* threading) {
+  MLAS_CONV_PARAMETERS parameters;
+  size_t working_buffer_size;
+  PrepareConv(params, threading, parameters, working_buffer_size);
+  parameters.UseJitKernels = params->use_jit_kernels;
+
+  auto* working_data = working_buffer_size > 0
+                           ? params->allocator->Alloc(sizeof(float) * SafeInt<size_t>(working_buffer_size))
+                           : nullptr;
+  BufferUniquePtr working_buffer(working_data, BufferDeleter(params->allocator));
+
+  MlasConv(&parameters,
+           params->input,
+           params->filter,
+           params->bias,
+           static_cast<float*>(working_buffer.get()),
+           params->output,
+           params->thread_pool);
+  return Status::OK();
+}
+
+class ConvOp {
+ public:
+  explicit ConvOp(const MLAS_THREADING_PARAMS& threading) : threading_(threading) {}
+
+  Status operator()(const ConvParams* params) const {
+    return RunConv(params, threading_.ThreadCount > 0 ? &threading_ : nullptr);
+  }
+
+  Status IsSupported(const ConvParams* params) const {
+    const ptrdiff_t degree_of_parallelism = concurrency::ThreadPool::DegreeOfParallelism(params->thread_pool);
+    TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(threading_.ThreadCount > degree_of_parallelism,
+                                              "thread count ", threading_.ThreadCount,
+                                              " exceeds the degree of parallelism ", degree_of_parallelism);
+
+    // Each thread count is tried with the M and N partitions of the threaded GEMM, or once for the other algorithms.
+    if (threading_.ThreadCount > 0) {
+      const bool partitioned = threading_.Partition != MlasThreadPartitionDefault;
+      TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(partitioned != IsGemmPartitioned(params),
+                                                "partition ", static_cast<int>(threading_.Partition),
+                                                " does not apply to the convolution algorithm");
+    }
+    return Status::OK();
+  }
+
+ private:
+  MLAS_THREADING_PARAMS threading_;
+};
+
+// Tuning runs the candidates repeatedly, so the output is redirected to a scratch buffer. Otherwise the Conv/Sum
+// fusion, which accumulates into the output, would add the sum tensor once per run.
+struct ConvTuningParams : ConvParams {
+  std::vector<float> scratch_output;
+};
+
+size_t OutputElementCount(const ConvParams* params) {
+  size_t output_size = 1;
+  for (size_t i = 0; i < params->dimensions; i++) {
+    output_size *= static_cast<size_t>(params->output_shape[i]);
+  }
+  return params->batch_count * params->group_count * params->filter_count * output_size;
+}
+
+class ConvTunableOp : public TunableOp<ConvParams> {
+ public:
+  ConvTunableOp() {
+    SetName("ConvTunableOp");
+
+    // The MLAS heuristic is the default for shapes that are not tuned.
+    RegisterOp(ConvOp{MLAS_THREADING_PARAMS{}});
+
+    for (auto thread_count : kCandidateThreadCounts) {
+      for (auto partition : {MlasThreadPartitionDefault, MlasThreadPartitionM, MlasThreadPartitionN}) {
+        MLAS_THREADING_PARAMS threading;
+        threading.ThreadCount = thread_count;
+        threading.Partition = partition;
+        RegisterOp(ConvOp{threading});
+      }
+    }
+  }
+
+  const ConvParams* PreTuning(const ConvParams* params) override {
+    auto* proxy = new ConvTuningParams();
+    static_cast<ConvParams&>(*proxy) = *params;
+
+    const size_t output_count = OutputElementCount(params);
+    proxy->scratch_output.assign(params->output, params->output + output_count);
+    proxy->output = proxy->scratch_output.data();
+    return proxy;
+  }
+
+  void PostTuning(const ConvParams* params) override {
+    delete static_cast<const ConvTuningParams*>(params);
+  }
+};
+
+template <typename T>
+void AppendDims(std::ostringstream& oss, const char* name, const T* dims, size_t count) {
+  oss << "_" << name;
+  for (size_t i = 0; i < count; i++) {
+    oss << (i == 0 ? "" : "x") << dims[i];
+  }
+}
+
+}  // namespace
+
+std::string ConvParams::Signature() const {
+  std::ostringstream oss;
+  oss << "N" << batch_count << "_G" << group_count << "_C" << input_channels << "_M" << filter_count;
+  AppendDims(oss, "I", input_shape, dimensions);
+  AppendDims(oss, "K", kernel_shape, dimensions);
+  AppendDims(oss, "D", dilation_shape, dimensions);
+  AppendDims(oss, "P", padding, dimensions * 2);
+  AppendDims(oss, "S", stride_shape, dimensions);
+  oss << "_threads" << concurrency::ThreadPool::DegreeOfParallelism(thread_pool);
+  return oss.str();
+}
+
+Status Conv(CpuTuningContext* tuning_ctx, const ConvParams& params) {
+  if (tuning_ctx == nullptr || !tuning_ctx->IsTunableOpEnabled()) {
+    return RunConv(&params, nullptr);
+  }
+
+  ConvParams tunable_params = params;
+  tunable_params.tuning_ctx = tuning_ctx;
+  tunable_params.stream = nullptr;
+
+  static ConvTunableOp conv{};
+  return conv(&tunable_params);
+}
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
@@ -0,0 +1,51 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include "core/framework/allocator.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/tunable/cpu_tunable.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+// The arguments of MlasConvPrepare and MlasConv.
+struct ConvParams : OpParams {
+  std::string Signature() const override;
+
+  size_t dimensions;
+  size_t batch_count;
+  size_t group_count;
+  size_t input_channels;
+  const int64_t* input_shape;
+  const int64_t* kernel_shape;
+  const int64_t* dilation_shape;
+  const int64_t* padding;
+  const int64_t* stride_shape;
+  const int64_t* output_shape;
+  size_t filter_count;
+  const MLAS_ACTIVATION* activation;
+  float beta;
+  bool use_jit_kernels;
+
+  const float* input;
+  const float* filter;
+  const float* bias;
+  float* output;
+  AllocatorPtr allocator;
+  concurrency::ThreadPool* thread_pool;
+};
+
+// Runs MlasConvPrepare and MlasConv. When TunableOp is enabled for the CPU EP, the convolution is segmented across
+// threads with the partitioning tuned for the shape instead of the MLAS heuristic. tuning_ctx is nullptr for
+// kernels that are not run by the CPU EP.
+Status Conv(CpuTuningContext* tuning_ctx, const ConvParams& params);
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/framework/op_kernel_info.h"
+#include "core/framework/tunable.h"
+#include "core/graph/constants.h"
+#include "core/providers/cpu/tunable/cpu_tuning_context.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+// CPU kernels do not run on a stream, the handle is always nullptr.
+using OpParams = OpParams<CpuTuningContext, void*>;
+
+template <typename ParamsT>
+using Op = Op<ParamsT>;
+
+class Timer;
+template <typename ParamsT>
+using TunableOp = TunableOp<ParamsT, Timer>;
+
+// Returns the tuning context of the CPU EP running the kernel, nullptr if the kernel is run by another EP.
+inline CpuTuningContext* GetCpuTuningContext(const OpKernelInfo& info) {
+  const auto* ep = info.GetExecutionProvider();
+  if (ep == nullptr || ep->Type() != kCpuExecutionProvider) {
+    return nullptr;
+  }
+  return static_cast<CpuTuningContext*>(ep->GetTuningContext());
+}
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include "core/framework/tuning_context.h"
+
+namespace onnxruntime {
+
+class CPUExecutionProvider;
+
+namespace cpu {
+
+struct TunableOpInfo {
+  bool enable{false};
+  bool tuning_enable{false};
+  int max_tuning_duration_ms{};
+};
+
+namespace tunable {
+
+// The fastest thread partitioning depends on the instruction set and the core count of the machine, so tuning
+// results are only loaded on matching machines. The intra-op thread count is part of the params signature.
+class CpuTuningResultsValidator : public TuningResultsValidator {
+ public:
+  CpuTuningResultsValidator();
+
+ protected:
+  std::string GetCpuIsa() const;
+  Status ValidateCpuIsa(const std::string& value) const;
+
+  std::string GetCpuCores() const;
+  Status ValidateCpuCores(const std::string& value) const;
+};
+
+class CpuTuningContext : public ITuningContext {
+ public:
+  explicit CpuTuningContext(CPUExecutionProvider* ep, TunableOpInfo* info);
+
+  void EnableTunableOp() override;
+  void DisableTunableOp() override;
+  bool IsTunableOpEnabled() const override;
+
+  void EnableTuning() override;
+  void DisableTuning() override;
+  bool IsTuningEnabled() const override;
+
+  void SetMaxTuningDurationMs(int max_duration_ms) override;
+  int GetMaxTuningDurationMs() const override;
+
+  TuningResultsManager& GetTuningResultsManager() override;
+  const TuningResultsManager& GetTuningResultsManager() const override;
+
+  const TuningResultsValidator& GetTuningResultsValidator() const override;
+
+ private:
+  TunableOpInfo* info_;  // non-owning handle
+  TuningResultsManager manager_;
+  CpuTuningResultsValidator validator_;
+};
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
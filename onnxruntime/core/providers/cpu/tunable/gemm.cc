@@ -0,0 +1,140 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/tunable/gemm.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/providers/cpu/tunable/util.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+namespace {
+
+// The thread counts tried for each partitioned dimension. Tuning results store the index of the candidate and the
+// candidates are registered for each thread count in turn, so entries may only be appended.
+constexpr ptrdiff_t kCandidateThreadCounts[] = {1, 2, 4, 6, 8, 12, 16, 24, 32, 48, 64, 96, 128, 192, 256};
+
+class SgemmOp {
+ public:
+  explicit SgemmOp(const MLAS_THREADING_PARAMS& threading) : threading_(threading) {}
+
+  Status operator()(const SgemmParams* params) const {
+    MlasGemmBatch(params->trans_a, params->trans_b, params->m, params->n, params->k,
+                  params->data, params->batch, params->thread_pool,
+                  threading_.ThreadCount > 0 ? &threading_ : nullptr);
+    return Status::OK();
+  }
+
+  Status IsSupported(const SgemmParams* params) const {
+    const ptrdiff_t degree_of_parallelism = concurrency::ThreadPool::DegreeOfParallelism(params->thread_pool);
+    TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(threading_.ThreadCount > degree_of_parallelism,
+                                              "thread count ", threading_.ThreadCount,
+                                              " exceeds the degree of parallelism ", degree_of_parallelism);
+
+    // Larger thread counts are clamped by MLAS to the same partitioning, skip them.
+    const size_t partitioned = threading_.Partition == MlasThreadPartitionM ? params->m : params->n;
+    TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(
+        threading_.ThreadCount > 1 && size_t(threading_.ThreadCount) > partitioned * params->batch,
+        "thread count ", threading_.ThreadCount, " exceeds the partitioned dimension");
+    return Status::OK();
+  }
+
+ private:
+  MLAS_THREADING_PARAMS threading_;
+};
+
+// Tuning runs the candidates repeatedly, so the output is redirected to a scratch buffer. Otherwise a nonzero beta
+// or an epilogue that reads the output would accumulate into the real output.
+struct SgemmTuningParams : SgemmParams {
+  std::vector<MLAS_SGEMM_DATA_PARAMS> scratch_data;
+  std::vector<float> scratch_c;
+};
+
+class SgemmTunableOp : public TunableOp<SgemmParams> {
+ public:
+  SgemmTunableOp() {
+    SetName("SgemmTunableOp");
+
+    // The MLAS heuristic is the default for shapes that are not tuned.
+    RegisterOp(SgemmOp{MLAS_THREADING_PARAMS{}});
+
+    for (auto thread_count : kCandidateThreadCounts) {
+      for (auto partition : {MlasThreadPartitionM, MlasThreadPartitionN}) {
+        MLAS_THREADING_PARAMS threading;
+        threading.ThreadCount = thread_count;
+        threading.Partition = partition;
+        RegisterOp(SgemmOp{threading});
+      }
+    }
+  }
+
+  const SgemmParams* PreTuning(const SgemmParams* params) override {
+    auto* proxy = new SgemmTuningParams();
+    static_cast<SgemmParams&>(*proxy) = *params;
+
+    proxy->scratch_data.assign(params->data, params->data + params->batch);
+    size_t c_size = 0;
+    for (const auto& data : proxy->scratch_data) {
+      c_size += (params->m - 1) * data.ldc + params->n;
+    }
+    proxy->scratch_c.resize(c_size);
+
+    float* c = proxy->scratch_c.data();
+    for (auto& data : proxy->scratch_data) {
+      const size_t size = (params->m - 1) * data.ldc + params->n;
+      std::copy_n(data.C, size, c);
+      data.C = c;
+      c += size;
+    }
+    proxy->data = proxy->scratch_data.data();
+    return proxy;
+  }
+
+  void PostTuning(const SgemmParams* params) override {
+    delete static_cast<const SgemmTuningParams*>(params);
+  }
+};
+
+}  // namespace
+
+std::string SgemmParams::Signature() const {
+  return MakeString(trans_a == CblasTrans ? "T" : "N", trans_b == CblasTrans ? "T" : "N",
+                    "_", m, "_", n, "_", k, "_B", batch,
+                    data->BIsPacked ? "_packed" : "",
+                    "_threads", concurrency::ThreadPool::DegreeOfParallelism(thread_pool));
+}
+
+Status SgemmBatch(CpuTuningContext* tuning_ctx,
+                  CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
+                  size_t m, size_t n, size_t k,
+                  const MLAS_SGEMM_DATA_PARAMS* data, size_t batch,
+                  concurrency::ThreadPool* thread_pool) {
+  if (tuning_ctx == nullptr || !tuning_ctx->IsTunableOpEnabled() || m == 0 || n == 0 || batch == 0) {
+    MlasGemmBatch(trans_a, trans_b, m, n, k, data, batch, thread_pool);
+    return Status::OK();
+  }
+
+  SgemmParams params;
+  params.tuning_ctx = tuning_ctx;
+  params.stream = nullptr;
+  params.trans_a = trans_a;
+  params.trans_b = trans_b;
+  params.m = m;
+  params.n = n;
+  params.k = k;
+  params.data = data;
+  params.batch = batch;
+  params.thread_pool = thread_pool;
+
+  static SgemmTunableOp sgemm{};
+  return sgemm(&params);
+}
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
@@ -0,0 +1,40 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/tunable/cpu_tunable.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+struct SgemmParams : OpParams {
+  std::string Signature() const override;
+
+  CBLAS_TRANSPOSE trans_a;
+  CBLAS_TRANSPOSE trans_b;
+  size_t m;
+  size_t n;
+  size_t k;
+  const MLAS_SGEMM_DATA_PARAMS* data;
+  size_t batch;
+  concurrency::ThreadPool* thread_pool;
+};
+
+// Runs MlasGemmBatch. When TunableOp is enabled for the CPU EP, the batch is segmented across threads with the
+// partitioning tuned for the shape instead of the MLAS heuristic. tuning_ctx is nullptr for kernels that are not
+// run by the CPU EP.
+Status SgemmBatch(CpuTuningContext* tuning_ctx,
+                  CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
+                  size_t m, size_t n, size_t k,
+                  const MLAS_SGEMM_DATA_PARAMS* data, size_t batch,
+                  concurrency::ThreadPool* thread_pool);
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
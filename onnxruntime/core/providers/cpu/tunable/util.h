@@ -0,0 +1,40 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+
+#include "core/providers/cpu/tunable/cpu_tunable.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+// CPU kernels complete before returning, so the wall clock time between Start() and End() is the duration.
+class Timer : public ITimer<void*> {
+ public:
+  using TimerBase = ITimer<void*>;
+
+  explicit Timer(void* stream) : TimerBase(stream) {}
+
+  void Start() override {
+    start_ = std::chrono::steady_clock::now();
+  }
+
+  void End() override {
+    end_ = std::chrono::steady_clock::now();
+  }
+
+  float Duration() override {
+    return std::chrono::duration<float, std::milli>(end_ - start_).count();
+  }
+
+ private:
+  std::chrono::steady_clock::time_point start_;
+  std::chrono::steady_clock::time_point end_;
+};
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
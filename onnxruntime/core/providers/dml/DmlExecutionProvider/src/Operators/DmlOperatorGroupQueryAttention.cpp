@@ -314,5 +314,11 @@ public:
     }
 };
 
+void CALLBACK QueryGroupQueryAttention(IMLOperatorSupportQueryContextPrivate* context, /*out*/ bool* isSupported)
+{
+    // `block_table` input tensor (paged kv cache) is only supported on CPU
+    *isSupported = !context->IsInputValid(9);
+}
+
 DML_OP_DEFINE_CREATION_FUNCTION(GroupQueryAttention, DmlOperatorGroupQueryAttention);
 } // namespace Dml
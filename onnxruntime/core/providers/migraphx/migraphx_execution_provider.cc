@@ -624,6 +624,14 @@ static bool IsNodeSupported(const std::set<std::string>& op_set,
     return false;
   }
 
+  // the paged kv cache of GroupQueryAttention (block_table) is only supported on CPU
+  if (optype == "GroupQueryAttention") {
+    const auto& input_defs = node->InputDefs();
+    if (input_defs.size() > 9 && input_defs[9]->Exists()) {
+      return false;
+    }
+  }
+
   // check that some modes might not be supported in migraphx for some operators
   if (domain == kOnnxDomain && IsUnsupportedOpMode(graph_viewer, node)) {
     // not supported, then check the constant folding capability of migraphx
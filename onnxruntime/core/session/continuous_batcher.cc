@@ -0,0 +1,400 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/continuous_batcher.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "core/common/safeint.h"
+#include "core/framework/data_types.h"
+#include "core/framework/tensor.h"
+#include "core/graph/node_arg.h"
+#include "core/graph/onnx_protobuf.h"
+
+namespace onnxruntime {
+
+namespace {
+constexpr const char* kInputIdsName = "input_ids";
+constexpr const char* kAttentionMaskName = "attention_mask";
+constexpr const char* kPositionIdsName = "position_ids";
+constexpr const char* kLogitsName = "logits";
+constexpr const char* kPastPrefix = "past_key_values.";
+constexpr const char* kPresentPrefix = "present.";
+}  // namespace
+
+ContinuousBatcher::ContinuousBatcher(const ContinuousBatchingParameters& parameters, RunFn run_fn,
+                                     AllocatorPtr allocator)
+    : parameters_(parameters), run_fn_(std::move(run_fn)), allocator_(std::move(allocator)) {
+}
+
+Status ContinuousBatcher::Create(const ContinuousBatchingParameters& parameters,
+                                 gsl::span<const NodeArg* const> model_inputs,
+                                 gsl::span<const NodeArg* const> model_outputs,
+                                 RunFn run_fn,
+                                 AllocatorPtr allocator,
+                                 std::unique_ptr<ContinuousBatcher>& batcher) {
+  ORT_RETURN_IF(parameters.max_slots <= 0, "max_slots shall be positive, got ", parameters.max_slots);
+  ORT_RETURN_IF(parameters.max_length <= 1, "max_length shall be larger than 1, got ", parameters.max_length);
+  ORT_RETURN_IF(!run_fn || allocator == nullptr, "run_fn and allocator are required");
+
+  std::unique_ptr<ContinuousBatcher> result(new ContinuousBatcher(parameters, std::move(run_fn), std::move(allocator)));
+  ORT_RETURN_IF_ERROR(result->ValidateModel(model_inputs, model_outputs));
+
+  const size_t cache_bytes = SafeInt<size_t>(parameters.max_slots) * result->kv_num_heads_ * parameters.max_length *
+                             result->head_size_ * result->kv_type_->Size();
+  result->kv_cache_.reserve(result->past_names_.size());
+  for (size_t i = 0; i < result->past_names_.size(); i++) {
+    auto buffer = IAllocator::MakeUniquePtr<void>(result->allocator_, cache_bytes);
+    memset(buffer.get(), 0, cache_bytes);
+    result->kv_cache_.push_back(std::move(buffer));
+  }
+
+  result->sequences_.resize(SafeInt<size_t>(parameters.max_slots) * parameters.max_length);
+  result->sequence_lengths_.resize(parameters.max_slots);
+  result->slots_.resize(parameters.max_slots);
+
+  batcher = std::move(result);
+  return Status::OK();
+}
+
+Status ContinuousBatcher::ValidateModel(gsl::span<const NodeArg* const> model_inputs,
+                                        gsl::span<const NodeArg* const> model_outputs) {
+  constexpr auto int32_type = ONNX_NAMESPACE::TensorProto_DataType::TensorProto_DataType_INT32;
+  constexpr auto int64_type = ONNX_NAMESPACE::TensorProto_DataType::TensorProto_DataType_INT64;
+  constexpr auto float32_type = ONNX_NAMESPACE::TensorProto_DataType::TensorProto_DataType_FLOAT;
+  constexpr auto float16_type = ONNX_NAMESPACE::TensorProto_DataType::TensorProto_DataType_FLOAT16;
+
+  bool has_input_ids = false;
+  bool has_attention_mask = false;
+  int kv_elem_type = 0;
+  for (const NodeArg* input : model_inputs) {
+    const std::string& name = input->Name();
+    const auto elem_type = input->TypeAsProto()->tensor_type().elem_type();
+
+    if (name == kInputIdsName || name == kAttentionMaskName || name == kPositionIdsName) {
+      ORT_RETURN_IF(elem_type != int32_type && elem_type != int64_type,
+                    "model input ", name, " shall have int32 or int64 type");
+      const bool is_int64 = elem_type == int64_type;
+      if (name == kInputIdsName) {
+        has_input_ids = true;
+        input_ids_int64_ = is_int64;
+      } else if (name == kAttentionMaskName) {
+        has_attention_mask = true;
+        attention_mask_int64_ = is_int64;
+      } else {
+        has_position_ids_ = true;
+        position_ids_int64_ = is_int64;
+      }
+    } else if (name.rfind(kPastPrefix, 0) == 0) {
+      // Past state shape is like (batch_size, kv_num_heads, past_sequence_length, head_size).
+      const ONNX_NAMESPACE::TensorShapeProto* past_shape = input->Shape();
+      ORT_RETURN_IF(past_shape == nullptr || past_shape->dim_size() != 4,
+                    "model input ", name, " is expected to have 4 dimensions");
+      ORT_RETURN_IF(!past_shape->dim(1).has_dim_value() || past_shape->dim(1).dim_value() <= 0,
+                    "model input ", name, " dimension 1 shall have a positive value for number of heads");
+      ORT_RETURN_IF(!past_shape->dim(3).has_dim_value() || past_shape->dim(3).dim_value() <= 0,
+                    "model input ", name, " dimension 3 shall have a positive value for head size");
+      ORT_RETURN_IF(elem_type != float32_type && elem_type != float16_type,
+                    "model input ", name, " shall be float or float16 data type");
+
+      if (past_names_.empty()) {
+        kv_num_heads_ = past_shape->dim(1).dim_value();
+        head_size_ = past_shape->dim(3).dim_value();
+        kv_elem_type = elem_type;
+      } else {
+        ORT_RETURN_IF(kv_num_heads_ != past_shape->dim(1).dim_value() || head_size_ != past_shape->dim(3).dim_value() ||
+                          kv_elem_type != elem_type,
+                      "model input ", name, " shall have the type and shape of ", past_names_[0]);
+      }
+
+      past_names_.push_back(name);
+      present_names_.push_back(kPresentPrefix + name.substr(strlen(kPastPrefix)));
+    } else {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "unexpected model input ", name,
+                             " for continuous batching");
+    }
+  }
+
+  ORT_RETURN_IF(!has_input_ids, "the model has no input named ", kInputIdsName);
+  ORT_RETURN_IF(!has_attention_mask, "the model has no input named ", kAttentionMaskName);
+  ORT_RETURN_IF(past_names_.empty(), "the model has no past state input named ", kPastPrefix, "*");
+  kv_type_ = DataTypeImpl::TensorTypeFromONNXEnum(kv_elem_type)->GetElementType();
+
+  auto find_output = [&](const std::string& name) -> const NodeArg* {
+    auto it = std::find_if(model_outputs.begin(), model_outputs.end(),
+                           [&](const NodeArg* output) { return output->Name() == name; });
+    return it == model_outputs.end() ? nullptr : *it;
+  };
+
+  const NodeArg* logits = find_output(kLogitsName);
+  ORT_RETURN_IF(logits == nullptr, "the model has no output named ", kLogitsName);
+  const auto logits_type = logits->TypeAsProto()->tensor_type().elem_type();
+  ORT_RETURN_IF(logits_type != float32_type && logits_type != float16_type,
+                "model output ", kLogitsName, " shall be float or float16 data type");
+
+  for (const std::string& name : present_names_) {
+    ORT_RETURN_IF(find_output(name) == nullptr, "the model has no output named ", name);
+  }
+
+  feed_names_ = {kInputIdsName, kAttentionMaskName};
+  if (has_position_ids_) {
+    feed_names_.push_back(kPositionIdsName);
+  }
+  feed_names_.insert(feed_names_.end(), past_names_.begin(), past_names_.end());
+
+  fetch_names_ = {kLogitsName};
+  fetch_names_.insert(fetch_names_.end(), present_names_.begin(), present_names_.end());
+
+  return Status::OK();
+}
+
+Status ContinuousBatcher::Enqueue(gsl::span<const int32_t> prompt, int max_new_tokens,
+                                  int64_t& request_id) {
+  ORT_RETURN_IF(prompt.empty(), "the prompt shall not be empty");
+  ORT_RETURN_IF(prompt.size() >= static_cast<size_t>(parameters_.max_length),
+                "the prompt length ", prompt.size(), " shall be less than max_length ", parameters_.max_length);
+  ORT_RETURN_IF(max_new_tokens <= 0, "max_new_tokens shall be positive, got ", max_new_tokens);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  request_id = next_request_id_++;
+  queue_.push_back(Request{request_id, std::vector<int32_t>(prompt.begin(), prompt.end()), max_new_tokens});
+  return Status::OK();
+}
+
+void ContinuousBatcher::Cancel(int64_t request_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = std::find_if(queue_.begin(), queue_.end(),
+                         [request_id](const Request& request) { return request.id == request_id; });
+  if (it != queue_.end()) {
+    queue_.erase(it);
+  } else if (request_id < next_request_id_) {
+    cancelled_.insert(request_id);
+  }
+}
+
+size_t ContinuousBatcher::NumRequests() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return queue_.size() + num_active_;
+}
+
+Status ContinuousBatcher::Step(std::vector<ContinuousBatchingToken>& tokens) {
+  tokens.clear();
+
+  {
+    // Cancelled requests leave their slots. The other cancelled ids are requests that finished in the meantime.
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!cancelled_.empty()) {
+      for (int slot = 0; slot < parameters_.max_slots; slot++) {
+        if (slots_[slot].request_id >= 0 && cancelled_.count(slots_[slot].request_id) != 0) {
+          FreeSlot(slot);
+        }
+      }
+      cancelled_.clear();
+    }
+  }
+
+  // A slot freed by the decoding step already has its token for this step: it is only reused by the next step, so
+  // that a step returns at most one token per slot.
+  std::vector<bool> decoded(parameters_.max_slots);
+  for (int slot = 0; slot < parameters_.max_slots; slot++) {
+    decoded[slot] = slots_[slot].decoding;
+  }
+
+  ORT_RETURN_IF_ERROR(Decode(tokens));
+
+  // Admit queued requests into the free slots. The lowest slots are used first so that the rows of the next decoding
+  // steps stay few.
+  for (int slot = 0; slot < parameters_.max_slots; slot++) {
+    if (slots_[slot].request_id >= 0 || decoded[slot]) {
+      continue;
+    }
+
+    Request request;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (queue_.empty()) {
+        break;
+      }
+      request = std::move(queue_.front());
+      queue_.pop_front();
+      ++num_active_;
+    }
+
+    Status status = Prefill(slot, request, tokens);
+    if (!status.IsOK()) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --num_active_;
+      return status;
+    }
+  }
+
+  return Status::OK();
+}
+
+gsl::span<const int32_t> ContinuousBatcher::GetSlotSequence(int slot) const {
+  return gsl::make_span(sequences_.data() + SafeInt<size_t>(slot) * parameters_.max_length,
+                        static_cast<size_t>(sequence_lengths_[slot]));
+}
+
+void ContinuousBatcher::CreateIdsTensor(bool is_int64, int64_t rows, int64_t columns,
+                                        gsl::span<const int64_t> values, OrtValue& ort_value) const {
+  if (is_int64) {
+    Tensor::InitOrtValue(DataTypeImpl::GetType<int64_t>(), TensorShape({rows, columns}), allocator_, ort_value);
+    std::copy(values.begin(), values.end(), ort_value.GetMutable<Tensor>()->MutableData<int64_t>());
+  } else {
+    Tensor::InitOrtValue(DataTypeImpl::GetType<int32_t>(), TensorShape({rows, columns}), allocator_, ort_value);
+    std::transform(values.begin(), values.end(), ort_value.GetMutable<Tensor>()->MutableData<int32_t>(),
+                   [](int64_t value) { return static_cast<int32_t>(value); });
+  }
+}
+
+void ContinuousBatcher::AddKVCache(int first_slot, int num_slots, std::vector<OrtValue>& feeds,
+                                   std::vector<OrtValue>& fetches) const {
+  const TensorShape shape({num_slots, kv_num_heads_, parameters_.max_length, head_size_});
+  const size_t slot_bytes = SafeInt<size_t>(kv_num_heads_) * parameters_.max_length * head_size_ * kv_type_->Size();
+  for (const auto& cache : kv_cache_) {
+    OrtValue state;
+    Tensor::InitOrtValue(kv_type_, shape, static_cast<char*>(cache.get()) + first_slot * slot_bytes,
+                         allocator_->Info(), state);
+    feeds.push_back(state);
+    fetches.push_back(state);
+  }
+}
+
+int32_t ContinuousBatcher::ArgMaxLastPosition(const Tensor& logits, int64_t row) const {
+  const int64_t vocab_size = logits.Shape().GetDims().back();
+  const int64_t row_size = logits.Shape().SizeFromDimension(1);
+  const int64_t offset = row * row_size + row_size - vocab_size;
+
+  if (logits.IsDataType<float>()) {
+    const float* scores = logits.Data<float>() + offset;
+    return static_cast<int32_t>(std::max_element(scores, scores + vocab_size) - scores);
+  }
+
+  const MLFloat16* scores = logits.Data<MLFloat16>() + offset;
+  int32_t best = 0;
+  float best_score = scores[0].ToFloat();
+  for (int64_t i = 1; i < vocab_size; i++) {
+    const float score = scores[i].ToFloat();
+    if (score > best_score) {
+      best_score = score;
+      best = static_cast<int32_t>(i);
+    }
+  }
+  return best;
+}
+
+Status ContinuousBatcher::Prefill(int slot, const Request& request,
+                                  std::vector<ContinuousBatchingToken>& tokens) {
+  const int64_t length = static_cast<int64_t>(request.prompt.size());
+
+  std::vector<int64_t> values(request.prompt.begin(), request.prompt.end());
+  std::vector<OrtValue> feeds(has_position_ids_ ? 3 : 2);
+  CreateIdsTensor(input_ids_int64_, 1, length, values, feeds[0]);
+
+  std::fill(values.begin(), values.end(), int64_t{1});
+  CreateIdsTensor(attention_mask_int64_, 1, length, values, feeds[1]);
+
+  if (has_position_ids_) {
+    for (int64_t i = 0; i < length; i++) {
+      values[i] = i;
+    }
+    CreateIdsTensor(position_ids_int64_, 1, length, values, feeds[2]);
+  }
+
+  std::vector<OrtValue> fetches(1);
+  AddKVCache(slot, 1, feeds, fetches);
+  ORT_RETURN_IF_ERROR(run_fn_(feed_names_, feeds, fetch_names_, fetches));
+
+  Slot& state = slots_[slot];
+  state.request_id = request.id;
+  state.max_new_tokens = request.max_new_tokens;
+  state.new_tokens = 0;
+  std::copy(request.prompt.begin(), request.prompt.end(),
+            sequences_.begin() + SafeInt<size_t>(slot) * parameters_.max_length);
+  sequence_lengths_[slot] = static_cast<int>(request.prompt.size());
+
+  AddToken(slot, ArgMaxLastPosition(fetches[0].Get<Tensor>(), 0), tokens);
+  return Status::OK();
+}
+
+Status ContinuousBatcher::Decode(std::vector<ContinuousBatchingToken>& tokens) {
+  // Only the slots up to the last decoding one are run. The free slots below it get a padding row, which writes
+  // to the KV cache of its slot only.
+  int num_rows = 0;
+  int64_t total_length = 0;
+  for (int slot = 0; slot < parameters_.max_slots; slot++) {
+    if (slots_[slot].decoding) {
+      num_rows = slot + 1;
+      total_length = std::max<int64_t>(total_length, sequence_lengths_[slot]);
+    }
+  }
+
+  if (num_rows == 0) {
+    return Status::OK();
+  }
+
+  // The last token of each sequence is the input of the step, the tokens before it are in the KV cache.
+  std::vector<int64_t> input_ids(num_rows, parameters_.pad_token_id);
+  std::vector<int64_t> attention_mask(SafeInt<size_t>(num_rows) * total_length, 0);
+  std::vector<int64_t> position_ids(num_rows, 0);
+  for (int slot = 0; slot < num_rows; slot++) {
+    int64_t length = 1;
+    if (slots_[slot].decoding) {
+      gsl::span<const int32_t> sequence = GetSlotSequence(slot);
+      length = static_cast<int64_t>(sequence.size());
+      input_ids[slot] = sequence.back();
+      position_ids[slot] = length - 1;
+    }
+    std::fill_n(attention_mask.begin() + slot * total_length, length, int64_t{1});
+  }
+
+  std::vector<OrtValue> feeds(has_position_ids_ ? 3 : 2);
+  CreateIdsTensor(input_ids_int64_, num_rows, 1, input_ids, feeds[0]);
+  CreateIdsTensor(attention_mask_int64_, num_rows, total_length, attention_mask, feeds[1]);
+  if (has_position_ids_) {
+    CreateIdsTensor(position_ids_int64_, num_rows, 1, position_ids, feeds[2]);
+  }
+
+  std::vector<OrtValue> fetches(1);
+  AddKVCache(0, num_rows, feeds, fetches);
+  ORT_RETURN_IF_ERROR(run_fn_(feed_names_, feeds, fetch_names_, fetches));
+
+  const Tensor& logits = fetches[0].Get<Tensor>();
+  for (int slot = 0; slot < num_rows; slot++) {
+    if (slots_[slot].decoding) {
+      AddToken(slot, ArgMaxLastPosition(logits, slot), tokens);
+    }
+  }
+
+  return Status::OK();
+}
+
+void ContinuousBatcher::AddToken(int slot, int32_t token, std::vector<ContinuousBatchingToken>& tokens) {
+  Slot& state = slots_[slot];
+  sequences_[SafeInt<size_t>(slot) * parameters_.max_length + sequence_lengths_[slot]] = token;
+  ++sequence_lengths_[slot];
+  ++state.new_tokens;
+
+  // The next decoding step needs a free position in the KV cache for the token.
+  const bool finished = token == parameters_.eos_token_id ||
+                        state.new_tokens >= state.max_new_tokens ||
+                        sequence_lengths_[slot] >= parameters_.max_length;
+  tokens.push_back(ContinuousBatchingToken{state.request_id, token, finished});
+
+  if (finished) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FreeSlot(slot);
+  } else {
+    state.decoding = true;
+  }
+}
+
+void ContinuousBatcher::FreeSlot(int slot) {
+  slots_[slot] = Slot{};
+  sequence_lengths_[slot] = 0;
+  --num_active_;
+}
+
+}  // namespace onnxruntime
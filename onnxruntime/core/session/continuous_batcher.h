@@ -0,0 +1,166 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <gsl/gsl>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+class NodeArg;
+
+struct ContinuousBatchingParameters {
+  int max_slots = 0;      // maximum number of sequences decoded together
+  int max_length = 0;     // maximum number of tokens of a sequence, prompt included
+  int eos_token_id = -1;  // the generation of a sequence stops after this token, -1 if there is none
+  int pad_token_id = 0;   // input id of the rows of the slots that are not decoded in a step
+};
+
+// A token generated for a request by ContinuousBatcher::Step.
+struct ContinuousBatchingToken {
+  int64_t request_id;
+  int32_t token;
+  bool finished;  // the last token of the request, whose slot is free for the next request
+};
+
+// Greedy generation with continuous batching for decoder-only models with a static KV cache shared between the
+// past and present state, as GroupQueryAttention supports it. The model is run by a session, see
+// OrtApi::CreateContinuousBatcher.
+//
+// Requests are queued by Enqueue and join the decode loop in the first step that starts with a free slot: Step
+// decodes one token for all the active slots in one batch, then runs the prompt of each request admitted into a free
+// slot on its own, which fills the rows of the slot in the KV cache and yields the first token. A request leaves its
+// slot as soon as it is finished or cancelled, so a long generation never holds the other requests back.
+//
+// The model inputs are
+//   input_ids                  (batch_size, sequence_length) int32 or int64
+//   attention_mask             (batch_size, total_sequence_length) int32 or int64
+//   position_ids               (batch_size, sequence_length) int32 or int64, optional
+//   past_key_values.<i>.key    (batch_size, kv_num_heads, past_sequence_length, head_size) float or float16
+//   past_key_values.<i>.value  as past_key_values.<i>.key
+// and the model outputs
+//   logits                     (batch_size, sequence_length, vocab_size) float or float16
+//   present.<i>.key            bound to the buffer of past_key_values.<i>.key
+//   present.<i>.value          bound to the buffer of past_key_values.<i>.value
+// The attention mask of each row is right padded: its sum is the number of valid tokens of the slot.
+class ContinuousBatcher {
+ public:
+  // Runs the model. The fetches are either pre-allocated or allocated by the call.
+  using RunFn = std::function<Status(gsl::span<const std::string> feed_names,
+                                     gsl::span<const OrtValue> feeds,
+                                     gsl::span<const std::string> fetch_names,
+                                     std::vector<OrtValue>& fetches)>;
+
+  // Validates the model inputs and outputs, and allocates the KV cache of all the slots with `allocator`.
+  static Status Create(const ContinuousBatchingParameters& parameters,
+                       gsl::span<const NodeArg* const> model_inputs,
+                       gsl::span<const NodeArg* const> model_outputs,
+                       RunFn run_fn,
+                       AllocatorPtr allocator,
+                       std::unique_ptr<ContinuousBatcher>& batcher);
+
+  // Queues a prompt. Thread safe.
+  Status Enqueue(gsl::span<const int32_t> prompt, int max_new_tokens, int64_t& request_id);
+
+  // Removes a queued request, or frees the slot of an active request at the start of the next step. Thread safe.
+  void Cancel(int64_t request_id);
+
+  // Number of queued and active requests. Thread safe.
+  size_t NumRequests() const;
+
+  // Decodes one token for the active slots, then admits queued requests into the free slots.
+  // Returns at most one token per slot. Must not be called concurrently.
+  Status Step(std::vector<ContinuousBatchingToken>& tokens);
+
+  // Sequence generated so far (prompt included) by the request in a slot.
+  gsl::span<const int32_t> GetSlotSequence(int slot) const;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ContinuousBatcher);
+
+ private:
+  struct Request {
+    int64_t id;
+    std::vector<int32_t> prompt;
+    int max_new_tokens;
+  };
+
+  struct Slot {
+    int64_t request_id = -1;  // -1 for a free slot
+    int max_new_tokens = 0;
+    int new_tokens = 0;
+    // the last token of the sequence is not in the KV cache yet, it is the input of the next decoding step
+    bool decoding = false;
+  };
+
+  ContinuousBatcher(const ContinuousBatchingParameters& parameters, RunFn run_fn, AllocatorPtr allocator);
+
+  Status ValidateModel(gsl::span<const NodeArg* const> model_inputs, gsl::span<const NodeArg* const> model_outputs);
+
+  // Creates a tensor of input_ids, attention_mask or position_ids with the element type of the model input.
+  void CreateIdsTensor(bool is_int64, int64_t rows, int64_t columns, gsl::span<const int64_t> values,
+                       OrtValue& ort_value) const;
+
+  // Adds the past state of the slots [first_slot, first_slot + num_slots) to the feeds and binds the present state
+  // to the same buffers.
+  void AddKVCache(int first_slot, int num_slots, std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches) const;
+
+  // Returns the token with the largest logit of the last position of a row.
+  int32_t ArgMaxLastPosition(const Tensor& logits, int64_t row) const;
+
+  // Runs the prompt of a request in a free slot and returns its first token.
+  Status Prefill(int slot, const Request& request, std::vector<ContinuousBatchingToken>& tokens);
+
+  // Decodes one token for all the slots that are decoding.
+  Status Decode(std::vector<ContinuousBatchingToken>& tokens);
+
+  // Appends the token to the sequence of the slot and frees the slot if the request is finished.
+  void AddToken(int slot, int32_t token, std::vector<ContinuousBatchingToken>& tokens);
+
+  // Requires mutex_ to be held.
+  void FreeSlot(int slot);
+
+  const ContinuousBatchingParameters parameters_;
+  const RunFn run_fn_;
+  const AllocatorPtr allocator_;
+
+  // model inputs and outputs
+  bool input_ids_int64_ = false;
+  bool attention_mask_int64_ = false;
+  bool has_position_ids_ = false;
+  bool position_ids_int64_ = false;
+  MLDataType kv_type_ = nullptr;
+  int64_t kv_num_heads_ = 0;
+  int64_t head_size_ = 0;
+  std::vector<std::string> past_names_;
+  std::vector<std::string> present_names_;
+  std::vector<std::string> feed_names_;
+  std::vector<std::string> fetch_names_;
+
+  // KV cache of each past input, with shape (max_slots, kv_num_heads, max_length, head_size).
+  std::vector<IAllocatorUniquePtr<void>> kv_cache_;
+
+  // sequence of each slot with shape (max_slots, max_length), and its length
+  std::vector<int32_t> sequences_;
+  std::vector<int> sequence_lengths_;
+  std::vector<Slot> slots_;
+
+  mutable std::mutex mutex_;
+  std::deque<Request> queue_;
+  std::unordered_set<int64_t> cancelled_;
+  int64_t next_request_id_ = 0;
+  size_t num_active_ = 0;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,481 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/dynamic_batcher.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "core/framework/error_code_helper.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+namespace {
+// Number of rows along `axis` if all feeds are CPU tensors that can be concatenated along it, 0 otherwise.
+int64_t GetBatchRows(gsl::span<const OrtValue* const> feeds, int64_t axis) {
+  int64_t num_rows = 0;
+  for (const OrtValue* feed : feeds) {
+    if (feed == nullptr || !feed->IsTensor()) {
+      return 0;
+    }
+
+    const Tensor& tensor = feed->Get<Tensor>();
+    const auto& shape = tensor.Shape();
+    if (tensor.IsDataTypeString() || tensor.Location().device.Type() != OrtDevice::CPU ||
+        static_cast<int64_t>(shape.NumDimensions()) <= axis) {
+      return 0;
+    }
+
+    const int64_t rows = shape[gsl::narrow_cast<size_t>(axis)];
+    if (rows <= 0 || (num_rows != 0 && rows != num_rows)) {
+      return 0;
+    }
+
+    num_rows = rows;
+  }
+
+  return num_rows;
+}
+
+std::string GetBatchKey(const RunOptions* run_options,
+                        gsl::span<const char* const> feed_names,
+                        gsl::span<const OrtValue* const> feeds,
+                        gsl::span<const char* const> fetch_names,
+                        int64_t axis) {
+  std::string key;
+  key.append(reinterpret_cast<const char*>(&run_options), sizeof(run_options));
+  for (const char* name : feed_names) {
+    key.append(name).push_back('\0');
+  }
+
+  key.push_back('\0');
+  for (const char* name : fetch_names) {
+    key.append(name).push_back('\0');
+  }
+
+  for (const OrtValue* feed : feeds) {
+    const Tensor& tensor = feed->Get<Tensor>();
+    const auto* type = tensor.DataType();
+    key.append(reinterpret_cast<const char*>(&type), sizeof(type));
+    const auto dims = tensor.Shape().GetDims();
+    for (size_t i = 0; i < dims.size(); ++i) {
+      const int64_t dim = static_cast<int64_t>(i) == axis ? -1 : dims[i];
+      key.append(reinterpret_cast<const char*>(&dim), sizeof(dim));
+    }
+  }
+
+  return key;
+}
+
+// Splits the shape into the number of blocks before the axis and the number of bytes per row within a block.
+void GetBlockLayout(const Tensor& tensor, int64_t axis, size_t& num_blocks, size_t& row_bytes) {
+  const auto& shape = tensor.Shape();
+  const size_t axis_idx = gsl::narrow<size_t>(axis);
+  num_blocks = gsl::narrow<size_t>(shape.SizeToDimension(axis_idx));
+  row_bytes = gsl::narrow<size_t>(shape.SizeFromDimension(axis_idx + 1)) * tensor.DataType()->Size();
+}
+
+size_t QueueDelayBucket(int64_t delay_us) {
+  size_t bucket = 0;
+  while (delay_us > 0 && bucket + 1 < DynamicBatchingStats::kNumQueueDelayBuckets) {
+    delay_us >>= 1;
+    ++bucket;
+  }
+
+  return bucket;
+}
+}  // namespace
+
+DynamicBatcher::DynamicBatcher(const DynamicBatchingConfig& config, RunFn run_fn, ScheduleFn schedule_fn,
+                               AllocatorPtr allocator, profiling::Profiler& profiler,
+                               const logging::Logger& logger)
+    : config_(config),
+      run_fn_(std::move(run_fn)),
+      schedule_fn_(std::move(schedule_fn)),
+      allocator_(std::move(allocator)),
+      profiler_(profiler),
+      logger_(logger) {
+  ORT_ENFORCE(config_.max_batch_size > 0, "Maximum batch size must be positive.");
+  ORT_ENFORCE(config_.max_queue_delay_us >= 0, "Maximum queue delay must not be negative.");
+  ORT_ENFORCE(config_.batch_axis >= 0, "Batch axis must not be negative.");
+
+  stats_.batch_size_histogram.resize(gsl::narrow<size_t>(config_.max_batch_size) + 1);
+  dispatch_thread_ = std::thread([this]() { DispatchLoop(); });
+}
+
+DynamicBatcher::~DynamicBatcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+
+  queue_cv_.notify_all();
+  dispatch_thread_.join();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  in_flight_cv_.wait(lock, [this]() { return num_in_flight_ == 0; });
+}
+
+Status DynamicBatcher::Submit(const RunOptions* run_options,
+                              gsl::span<const char* const> feed_names,
+                              gsl::span<const OrtValue* const> feeds,
+                              gsl::span<const char* const> fetch_names,
+                              gsl::span<OrtValue*> fetches,
+                              RunAsyncCallbackFn callback,
+                              void* user_data) {
+  auto request = std::make_unique<Request>();
+  request->run_options = run_options;
+  request->feed_names = feed_names;
+  request->feeds = feeds;
+  request->fetch_names = fetch_names;
+  request->fetches = fetches;
+  request->callback = callback;
+  request->user_data = user_data;
+  request->num_rows = feeds.empty() ? 0 : GetBatchRows(feeds, config_.batch_axis);
+  if (request->num_rows != 0) {
+    request->batch_key = GetBatchKey(run_options, feed_names, feeds, fetch_names, config_.batch_axis);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (shutdown_) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The dynamic batcher is shutting down.");
+    }
+
+    if (request->num_rows != 0 && unsplittable_batch_keys_.count(request->batch_key) != 0) {
+      request->num_rows = 0;
+    }
+
+    request->enqueue_time = Clock::now();
+    queue_.push_back(std::move(request));
+  }
+
+  queue_cv_.notify_one();
+  return Status::OK();
+}
+
+DynamicBatchingStats DynamicBatcher::GetStats() const {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  return stats_;
+}
+
+int64_t DynamicBatcher::CompatibleRowsQueued(const Request& request) const {
+  int64_t num_rows = 0;
+  for (const auto& queued : queue_) {
+    if (queued->num_rows != 0 && queued->batch_key == request.batch_key) {
+      num_rows += queued->num_rows;
+    }
+  }
+
+  return num_rows;
+}
+
+DynamicBatcher::Batch DynamicBatcher::TakeBatch() {
+  Batch batch;
+  batch.push_back(std::move(queue_.front()));
+  queue_.pop_front();
+
+  const Request& first = *batch.front();
+  if (first.num_rows == 0) {
+    return batch;
+  }
+
+  int64_t num_rows = first.num_rows;
+  for (auto it = queue_.begin(); it != queue_.end() && num_rows < config_.max_batch_size;) {
+    Request& queued = **it;
+    if (queued.num_rows != 0 && queued.batch_key == first.batch_key &&
+        num_rows + queued.num_rows <= config_.max_batch_size) {
+      num_rows += queued.num_rows;
+      batch.push_back(std::move(*it));
+      it = queue_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  return batch;
+}
+
+void DynamicBatcher::DispatchLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    queue_cv_.wait(lock, [this]() { return shutdown_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      // shutting down and all requests have been dispatched
+      break;
+    }
+
+    // wait for more requests to fill up the batch of the oldest request, unless it can't be batched
+    const Request* oldest = queue_.front().get();
+    if (oldest->num_rows != 0) {
+      const auto deadline = oldest->enqueue_time + std::chrono::microseconds(config_.max_queue_delay_us);
+      queue_cv_.wait_until(lock, deadline, [this, oldest]() {
+        return shutdown_ || CompatibleRowsQueued(*oldest) >= config_.max_batch_size;
+      });
+    }
+
+    auto batch = std::make_shared<Batch>(TakeBatch());
+    ++num_in_flight_;
+    lock.unlock();
+
+    schedule_fn_([this, batch]() {
+      RunBatch(*batch);
+
+      std::lock_guard<std::mutex> in_flight_lock(mutex_);
+      if (--num_in_flight_ == 0) {
+        in_flight_cv_.notify_all();
+      }
+    });
+
+    lock.lock();
+  }
+}
+
+void DynamicBatcher::RunBatch(Batch& batch) {
+  const auto start_time = Clock::now();
+  TimePoint profiling_start;
+  if (profiler_.IsEnabled()) {
+    profiling_start = profiler_.Start();
+  }
+
+  int64_t total_rows = 0;
+  for (const auto& request : batch) {
+    total_rows += request->num_rows;
+  }
+
+  RecordStats(batch, total_rows, start_time);
+
+  if (batch.size() == 1) {
+    RunRequest(*batch.front());
+  } else {
+    Status status;
+    bool unsplittable = false;
+    ORT_TRY {
+      status = RunBatchedRequests(batch, total_rows, unsplittable);
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+      });
+    }
+
+    if (status.IsOK() && unsplittable) {
+      {
+        // don't batch the queued and later requests with the same key anymore
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::string& batch_key = batch.front()->batch_key;
+        unsplittable_batch_keys_.insert(batch_key);
+        for (auto& queued : queue_) {
+          if (queued->batch_key == batch_key) {
+            queued->num_rows = 0;
+          }
+        }
+      }
+
+      LOGS(logger_, WARNING) << "The outputs of a batch of " << batch.size()
+                             << " requests can't be split along the batch axis " << config_.batch_axis
+                             << ". The requests are run on their own.";
+      RecordUnbatched(batch, total_rows);
+      for (auto& request : batch) {
+        RunRequest(*request);
+      }
+    } else if (!status.IsOK()) {
+      // a callback may have thrown after the callbacks of the requests before it were invoked
+      LOGS(logger_, WARNING) << "Running a batch of " << batch.size() << " requests failed: "
+                             << status.ErrorMessage();
+      for (auto& request : batch) {
+        if (!request->delivered) {
+          request->delivered = true;
+          request->callback(request->user_data, request->fetches.data(), 0, ToOrtStatus(status));
+        }
+      }
+    }
+  }
+
+  if (profiler_.IsEnabled()) {
+    profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "DynamicBatcher_RunBatch", profiling_start,
+                                    {{"num_requests", std::to_string(batch.size())},
+                                     {"batch_size", std::to_string(total_rows)}});
+  }
+}
+
+void DynamicBatcher::RunRequest(Request& request) {
+  Status status = Run(request.run_options, request.feed_names, request.feeds, request.fetch_names, request.fetches);
+  request.delivered = true;
+  request.callback(request.user_data, request.fetches.data(), status.IsOK() ? request.fetches.size() : 0,
+                   ToOrtStatus(status));
+}
+
+Status DynamicBatcher::Run(const RunOptions* run_options,
+                           gsl::span<const char* const> feed_names,
+                           gsl::span<const OrtValue* const> feeds,
+                           gsl::span<const char* const> fetch_names,
+                           gsl::span<OrtValue*> fetches) {
+  Status status;
+  ORT_TRY {
+    if (run_options) {
+      status = run_fn_(*run_options, feed_names, feeds, fetch_names, fetches);
+    } else {
+      RunOptions default_run_options;
+      status = run_fn_(default_run_options, feed_names, feeds, fetch_names, fetches);
+    }
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+    });
+  }
+  ORT_CATCH(...) {
+    status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, "unknown exception");
+  }
+
+  return status;
+}
+
+Status DynamicBatcher::RunBatchedRequests(Batch& batch, int64_t total_rows, bool& unsplittable) {
+  const Request& first = *batch.front();
+  const int64_t axis = config_.batch_axis;
+
+  // concatenate the inputs along the batch axis
+  std::vector<OrtValue> batched_feeds(first.feeds.size());
+  std::vector<const OrtValue*> batched_feed_ptrs(first.feeds.size());
+  for (size_t i = 0; i < first.feeds.size(); ++i) {
+    const Tensor& first_input = first.feeds[i]->Get<Tensor>();
+    TensorShape shape = first_input.Shape();
+    shape[gsl::narrow<size_t>(axis)] = total_rows;
+    Tensor::InitOrtValue(first_input.DataType(), shape, allocator_, batched_feeds[i]);
+
+    Tensor& batched_input = *batched_feeds[i].GetMutable<Tensor>();
+    size_t num_blocks = 0;
+    size_t batched_row_bytes = 0;
+    GetBlockLayout(batched_input, axis, num_blocks, batched_row_bytes);
+    const size_t batched_block_bytes = batched_row_bytes * gsl::narrow<size_t>(total_rows);
+
+    auto* dst = static_cast<char*>(batched_input.MutableDataRaw());
+    size_t block_offset = 0;
+    for (const auto& request : batch) {
+      const Tensor& input = request->feeds[i]->Get<Tensor>();
+      const auto* src = static_cast<const char*>(input.DataRaw());
+      const size_t block_bytes = batched_row_bytes * gsl::narrow<size_t>(request->num_rows);
+      for (size_t block = 0; block < num_blocks; ++block) {
+        std::memcpy(dst + block * batched_block_bytes + block_offset, src + block * block_bytes, block_bytes);
+      }
+
+      block_offset += block_bytes;
+    }
+
+    batched_feed_ptrs[i] = &batched_feeds[i];
+  }
+
+  // let the session allocate the batched outputs. they are owned here once the run succeeded.
+  std::vector<OrtValue*> batched_fetch_ptrs(first.fetch_names.size(), nullptr);
+  ORT_RETURN_IF_ERROR(Run(first.run_options, first.feed_names, batched_feed_ptrs, first.fetch_names,
+                          batched_fetch_ptrs));
+
+  std::vector<std::unique_ptr<OrtValue>> batched_fetches;
+  batched_fetches.reserve(batched_fetch_ptrs.size());
+  for (OrtValue* fetch : batched_fetch_ptrs) {
+    batched_fetches.emplace_back(fetch);
+  }
+
+  for (size_t i = 0; i < batched_fetches.size(); ++i) {
+    const OrtValue& fetch = *batched_fetches[i];
+    const Tensor* output = fetch.IsTensor() ? &fetch.Get<Tensor>() : nullptr;
+    if (output == nullptr || output->IsDataTypeString() || output->Location().device.Type() != OrtDevice::CPU ||
+        static_cast<int64_t>(output->Shape().NumDimensions()) <= axis ||
+        output->Shape()[gsl::narrow<size_t>(axis)] != total_rows) {
+      LOGS(logger_, INFO) << "Output " << first.fetch_names[i]
+                          << " is not a non-string CPU tensor with the batch size " << total_rows
+                          << " along the batch axis " << axis << ".";
+      unsplittable = true;
+      return Status::OK();
+    }
+  }
+
+  // split the outputs along the batch axis. the outputs of all requests are created before any callback is invoked
+  // so that a failure can still be reported for the whole batch.
+  std::vector<std::vector<std::unique_ptr<OrtValue>>> request_fetches(batch.size());
+  int64_t row_offset = 0;
+  for (size_t r = 0; r < batch.size(); ++r) {
+    Request& request = *batch[r];
+    auto& fetches = request_fetches[r];
+    fetches.resize(batched_fetches.size());
+
+    for (size_t i = 0; i < batched_fetches.size(); ++i) {
+      const Tensor& output = batched_fetches[i]->Get<Tensor>();
+      TensorShape shape = output.Shape();
+      shape[gsl::narrow<size_t>(axis)] = request.num_rows;
+
+      Tensor* request_output = nullptr;
+      if (request.fetches[i] != nullptr) {
+        // preallocated by the caller
+        ORT_RETURN_IF_NOT(request.fetches[i]->IsTensor(), "Preallocated output ", request.fetch_names[i],
+                          " is not a tensor.");
+        request_output = request.fetches[i]->GetMutable<Tensor>();
+        ORT_RETURN_IF(request_output->DataType() != output.DataType() || request_output->Shape() != shape ||
+                          request_output->Location().device.Type() != OrtDevice::CPU,
+                      "Preallocated output ", request.fetch_names[i], " doesn't match the expected CPU tensor of shape ",
+                      shape, ".");
+      } else {
+        fetches[i] = std::make_unique<OrtValue>();
+        Tensor::InitOrtValue(output.DataType(), shape, allocator_, *fetches[i]);
+        request_output = fetches[i]->GetMutable<Tensor>();
+      }
+
+      size_t num_blocks = 0;
+      size_t batched_row_bytes = 0;
+      GetBlockLayout(output, axis, num_blocks, batched_row_bytes);
+      const size_t batched_block_bytes = batched_row_bytes * gsl::narrow<size_t>(total_rows);
+      const size_t block_bytes = batched_row_bytes * gsl::narrow<size_t>(request.num_rows);
+      const size_t block_offset = batched_row_bytes * gsl::narrow<size_t>(row_offset);
+
+      const auto* src = static_cast<const char*>(output.DataRaw());
+      auto* dst = static_cast<char*>(request_output->MutableDataRaw());
+      for (size_t block = 0; block < num_blocks; ++block) {
+        std::memcpy(dst + block * block_bytes, src + block * batched_block_bytes + block_offset, block_bytes);
+      }
+    }
+
+    row_offset += request.num_rows;
+  }
+
+  for (size_t r = 0; r < batch.size(); ++r) {
+    Request& request = *batch[r];
+    for (size_t i = 0; i < request_fetches[r].size(); ++i) {
+      if (request_fetches[r][i]) {
+        request.fetches[i] = request_fetches[r][i].release();
+      }
+    }
+
+    request.delivered = true;
+    request.callback(request.user_data, request.fetches.data(), request.fetches.size(), nullptr);
+  }
+
+  return Status::OK();
+}
+
+void DynamicBatcher::RecordStats(const Batch& batch, int64_t total_rows, Clock::time_point start_time) {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  stats_.num_requests += static_cast<int64_t>(batch.size());
+  if (total_rows == 0) {
+    stats_.num_unbatched_requests += static_cast<int64_t>(batch.size());
+  } else {
+    ++stats_.num_batches;
+    ++stats_.batch_size_histogram[gsl::narrow<size_t>(std::min(total_rows, config_.max_batch_size))];
+  }
+
+  for (const auto& request : batch) {
+    const auto delay = std::chrono::duration_cast<std::chrono::microseconds>(start_time - request->enqueue_time);
+    ++stats_.queue_delay_histogram[QueueDelayBucket(delay.count())];
+  }
+}
+
+void DynamicBatcher::RecordUnbatched(const Batch& batch, int64_t total_rows) {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  stats_.num_unbatched_requests += static_cast<int64_t>(batch.size());
+  --stats_.num_batches;
+  --stats_.batch_size_histogram[gsl::narrow<size_t>(std::min(total_rows, config_.max_batch_size))];
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,166 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <gsl/gsl>
+
+#include "core/common/common.h"
+#include "core/common/logging/logging.h"
+#include "core/common/profiler.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/run_options.h"
+#include "core/session/onnxruntime_c_api.h"
+
+namespace onnxruntime {
+
+struct DynamicBatchingConfig {
+  // maximum number of rows along the batch axis in a batch. 0 disables dynamic batching.
+  int64_t max_batch_size = 0;
+  // maximum time the oldest queued request waits for more requests before its batch is run.
+  int64_t max_queue_delay_us = 1000;
+  // axis along which the inputs and outputs of the requests are concatenated and split.
+  int64_t batch_axis = 0;
+};
+
+struct DynamicBatchingStats {
+  static constexpr size_t kNumQueueDelayBuckets = 25;
+
+  int64_t num_requests = 0;
+  int64_t num_batches = 0;
+  // requests that could not be batched (e.g. non-tensor inputs) and were run on their own.
+  int64_t num_unbatched_requests = 0;
+  // batch_size_histogram[n] is the number of batches with n rows along the batch axis.
+  // a single request larger than the maximum batch size is counted in the last bucket.
+  std::vector<int64_t> batch_size_histogram;
+  // queue_delay_histogram[0] is the number of requests that waited less than 1us before their batch started and
+  // queue_delay_histogram[i] the number of requests that waited [2^(i-1), 2^i) us. the last bucket holds all
+  // longer delays.
+  std::array<int64_t, kNumQueueDelayBuckets> queue_delay_histogram{};
+};
+
+// Collects requests submitted via RunAsync, concatenates the ones with compatible inputs along the batch axis and
+// runs them as one batch once the maximum batch size is reached or the oldest request has waited for the maximum
+// queue delay. The outputs of the batch are split along the batch axis and handed to the callback of each request.
+//
+// Requests are compatible if they use the same RunOptions instance, the same input and output names, and inputs of
+// the same type and shape apart from the batch axis. Batching is done for CPU tensors only. Other requests are
+// run on their own. If an output of a batch can't be split along the batch axis, the requests of the batch are run
+// on their own and later requests with the same inputs and outputs are not batched anymore.
+class DynamicBatcher {
+ public:
+  using RunFn = std::function<Status(const RunOptions& run_options,
+                                     gsl::span<const char* const> feed_names,
+                                     gsl::span<const OrtValue* const> feeds,
+                                     gsl::span<const char* const> fetch_names,
+                                     gsl::span<OrtValue*> fetches)>;
+  using ScheduleFn = std::function<void(std::function<void()>)>;
+
+  // `run_fn` runs a batch and allocates the outputs that are nullptr, `schedule_fn` runs a batch asynchronously.
+  // `allocator` is used for the batched inputs and the outputs of the requests.
+  DynamicBatcher(const DynamicBatchingConfig& config, RunFn run_fn, ScheduleFn schedule_fn, AllocatorPtr allocator,
+                 profiling::Profiler& profiler, const logging::Logger& logger);
+
+  // Runs the queued requests and waits until all batches are done.
+  ~DynamicBatcher();
+
+  // Queues a request. The arguments must stay valid until `callback` is invoked, as for InferenceSession::RunAsync.
+  Status Submit(const RunOptions* run_options,
+                gsl::span<const char* const> feed_names,
+                gsl::span<const OrtValue* const> feeds,
+                gsl::span<const char* const> fetch_names,
+                gsl::span<OrtValue*> fetches,
+                RunAsyncCallbackFn callback,
+                void* user_data);
+
+  DynamicBatchingStats GetStats() const;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(DynamicBatcher);
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Request {
+    const RunOptions* run_options;
+    gsl::span<const char* const> feed_names;
+    gsl::span<const OrtValue* const> feeds;
+    gsl::span<const char* const> fetch_names;
+    gsl::span<OrtValue*> fetches;
+    RunAsyncCallbackFn callback;
+    void* user_data;
+
+    Clock::time_point enqueue_time;
+    // rows along the batch axis, or 0 if the request can't be batched
+    int64_t num_rows = 0;
+    // requests can be batched together if their keys match
+    std::string batch_key;
+    // set once the callback has been invoked
+    bool delivered = false;
+  };
+
+  using Batch = std::vector<std::unique_ptr<Request>>;
+
+  void DispatchLoop();
+
+  // Returns the number of rows queued that can be batched with `request`. Requires mutex_ to be held.
+  int64_t CompatibleRowsQueued(const Request& request) const;
+
+  // Removes the oldest request and the queued requests compatible with it from the queue. Requires mutex_ to be held.
+  Batch TakeBatch();
+
+  void RunBatch(Batch& batch);
+
+  // Runs a request on its own and invokes its callback.
+  void RunRequest(Request& request);
+
+  Status Run(const RunOptions* run_options,
+             gsl::span<const char* const> feed_names,
+             gsl::span<const OrtValue* const> feeds,
+             gsl::span<const char* const> fetch_names,
+             gsl::span<OrtValue*> fetches);
+
+  // Concatenates the inputs of the requests, runs them as one batch, splits the outputs and invokes the callbacks.
+  // `unsplittable` is set and no callback is invoked if an output doesn't have the batch axis.
+  Status RunBatchedRequests(Batch& batch, int64_t total_rows, bool& unsplittable);
+
+  void RecordStats(const Batch& batch, int64_t total_rows, Clock::time_point start_time);
+
+  // Counts the requests of a batch recorded by RecordStats as unbatched.
+  void RecordUnbatched(const Batch& batch, int64_t total_rows);
+
+  const DynamicBatchingConfig config_;
+  const RunFn run_fn_;
+  const ScheduleFn schedule_fn_;
+  const AllocatorPtr allocator_;
+  profiling::Profiler& profiler_;
+  const logging::Logger& logger_;
+
+  std::mutex mutex_;
+  std::condition_variable queue_cv_;
+  std::condition_variable in_flight_cv_;
+  std::deque<std::unique_ptr<Request>> queue_;
+  size_t num_in_flight_ = 0;
+  bool shutdown_ = false;
+  // batch keys of the requests with outputs that can't be split
+  std::unordered_set<std::string> unsplittable_batch_keys_;
+
+  mutable std::mutex stats_mutex_;
+  DynamicBatchingStats stats_;
+
+  std::thread dispatch_thread_;
+};
+
+}  // namespace onnxruntime
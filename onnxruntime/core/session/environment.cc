@@ -4,6 +4,7 @@
 #include "core/session/environment.h"
 #include "core/session/allocator_adapters.h"
 #include "core/framework/allocator_utils.h"
+#include "core/framework/shared_initializer_registry.h"
 #include "core/graph/constants.h"
 #include "core/graph/op.h"
 
@@ -131,6 +132,8 @@ Status Environment::CreateAndRegisterAllocator(const OrtMemoryInfo& mem_info, co
     int max_dead_bytes_per_chunk = -1;
     int initial_growth_chunk_size_bytes = -1;
     int64_t max_power_of_two_extend_bytes = -1L;
+    int64_t thread_cache_max_block_size = -1L;
+    int64_t idle_shrink_ms = -1L;
 
     // override with values from the user supplied arena_cfg object
     if (arena_cfg) {
@@ -148,10 +151,13 @@ Status Environment::CreateAndRegisterAllocator(const OrtMemoryInfo& mem_info, co
       max_dead_bytes_per_chunk = arena_cfg->max_dead_bytes_per_chunk;
       initial_growth_chunk_size_bytes = arena_cfg->initial_growth_chunk_size_bytes;
       max_power_of_two_extend_bytes = arena_cfg->max_power_of_two_extend_bytes;
+      thread_cache_max_block_size = arena_cfg->thread_cache_max_block_size;
+      idle_shrink_ms = arena_cfg->idle_shrink_ms;
     }
 
     OrtArenaCfg l_arena_cfg{max_mem, arena_extend_strategy, initial_chunk_size_bytes, max_dead_bytes_per_chunk,
-                            initial_growth_chunk_size_bytes, max_power_of_two_extend_bytes};
+                            initial_growth_chunk_size_bytes, max_power_of_two_extend_bytes,
+                            thread_cache_max_block_size, idle_shrink_ms};
     AllocatorCreationInfo alloc_creation_info{
         [mem_info](int) { return std::make_unique<CPUAllocator>(mem_info); },
         0,
@@ -186,6 +192,15 @@ Status Environment::UnregisterAllocator(const OrtMemoryInfo& mem_info) {
   return Status::OK();
 }
 
+SharedInitializerRegistry& Environment::GetSharedInitializerRegistry() const {
+  std::lock_guard<std::mutex> lock(shared_initializer_registry_mutex_);
+  if (!shared_initializer_registry_) {
+    shared_initializer_registry_ = std::make_shared<SharedInitializerRegistry>();
+  }
+
+  return *shared_initializer_registry_;
+}
+
 Status Environment::Initialize(std::unique_ptr<logging::LoggingManager> logging_manager,
                                const OrtThreadingOptions* tp_options,
                                bool create_global_thread_pools) {
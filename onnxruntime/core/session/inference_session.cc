@@ -444,6 +444,7 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         to.auto_set_affinity = to.thread_pool_size == 0 &&
                                session_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL &&
                                to.affinity_str.empty();
+        to.numa_aware = session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigNumaAware, "0") == "1";
 
         if (to.custom_create_thread_fn) {
           ORT_ENFORCE(to.custom_join_thread_fn, "custom join thread function not set for intra op thread pool");
@@ -713,6 +714,9 @@ InferenceSession::InferenceSession(const SessionOptions& session_options, const
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 InferenceSession::~InferenceSession() {
+  // finish the queued requests while the session is still intact
+  dynamic_batcher_.reset();
+
   if (session_options_.enable_profiling) {
     ORT_TRY {
       EndProfiling();
@@ -1381,6 +1385,12 @@ Status InferenceSession::LoadOrtModel(const PathString& model_uri) {
   return LoadOrtModelWithLoader(
       [&]() {
         model_location_ = model_uri;
+        if (GetSessionOptions().config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMapORTModelFile, "0") == "1") {
+          ORT_RETURN_IF_ERROR(MappedOrtModelFile::Get(model_location_, ort_format_model_file_));
+          ort_format_model_bytes_ = ort_format_model_file_->Bytes();
+          return Status::OK();
+        }
+
         ORT_RETURN_IF_ERROR(
             LoadOrtModelBytes(model_location_, ort_format_model_bytes_, ort_format_model_bytes_data_holder_));
         return Status::OK();
@@ -1488,11 +1498,13 @@ Status InferenceSession::LoadOrtModelWithLoader(std::function<Status()> load_ort
   // provided an existing buffer of bytes when creating the InferenceSession, ort_format_model_bytes_data_holder_
   // will be empty.
   // if that is the case we also allow creating initializers that directly use those bytes.
+  // the bytes of a memory mapped model file are always used directly by the initializers.
   const auto& config_options = session_options_.config_options;
   using_ort_model_bytes_for_initializers_ =
       load_options.can_use_flatbuffer_for_initializers =
-          ort_format_model_bytes_data_holder_.empty() &&
-          config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseORTModelBytesForInitializers, "0") == "1";
+          ort_format_model_file_ != nullptr ||
+          (ort_format_model_bytes_data_holder_.empty() &&
+           config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseORTModelBytesForInitializers, "0") == "1");
 
   // need to go from unique_ptr to shared_ptr when moving into model_
   std::unique_ptr<Model> tmp_model;
@@ -1778,7 +1790,9 @@ common::Status InferenceSession::Initialize() {
         *session_logger_,
         session_profiler_,
         session_options_,
-        prepacked_weights_container_);
+        prepacked_weights_container_,
+        nullptr,
+        &environment_.GetSharedInitializerRegistry());
 
     bool use_env_allocators =
         session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseEnvAllocators, "0") == "1";
@@ -1794,6 +1808,21 @@ common::Status InferenceSession::Initialize() {
       }
     }
 
+    // The other EPs configure TunableOp with their provider options, the CPU EP with session options.
+    auto* cpu_ep = execution_providers_.Get(onnxruntime::kCpuExecutionProvider);
+    auto* cpu_tuning_ctx = cpu_ep != nullptr ? cpu_ep->GetTuningContext() : nullptr;
+    if (nullptr != cpu_tuning_ctx) {
+      const auto& config_options = session_options_.config_options;
+      if (config_options.GetConfigOrDefault(kOrtSessionOptionsCpuTunableOpEnable, "0") == "1") {
+        cpu_tuning_ctx->EnableTunableOp();
+      }
+      if (config_options.GetConfigOrDefault(kOrtSessionOptionsCpuTunableOpTuningEnable, "0") == "1") {
+        cpu_tuning_ctx->EnableTuning();
+      }
+      cpu_tuning_ctx->SetMaxTuningDurationMs(ParseStringWithClassicLocale<int>(
+          config_options.GetConfigOrDefault(kOrtSessionOptionsCpuTunableOpMaxTuningDurationMs, "0")));
+    }
+
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
     // Don't want to pollute SessionState constructor since memory profile is enabled optionally.
     session_state_->SetMemoryProfiler(&memory_profiler_);
@@ -2121,6 +2150,8 @@ common::Status InferenceSession::Initialize() {
     // Resolve memory pattern flags of the main graph and subgraph session states
     ResolveMemoryPatternFlags(*session_state_);
 
+    ORT_RETURN_IF_ERROR_SESSIONID_(CreateDynamicBatcher());
+
     is_inited_ = true;
 
     if (!using_ort_model_bytes_for_initializers_) {
@@ -2823,6 +2854,11 @@ common::Status InferenceSession::RunAsync(const RunOptions* run_options,
   if (!tp || concurrency::ThreadPool::DegreeOfParallelism(tp) < 2) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "intra op thread pool must have at least one thread for RunAsync");
   }
+
+  if (dynamic_batcher_) {
+    return dynamic_batcher_->Submit(run_options, feed_names, feeds, fetch_names, fetches, callback, user_data);
+  }
+
   std::function<void()> run_fn = [run_options, feed_names, feeds, fetch_names, fetches, num_fetches,
                                   callback, user_data, this]() {
     Status status = Status::OK();
@@ -2848,6 +2884,67 @@ common::Status InferenceSession::RunAsync(const RunOptions* run_options,
   return Status::OK();
 }
 
+common::Status InferenceSession::CreateDynamicBatcher() {
+  const auto& config_options = session_options_.config_options;
+  DynamicBatchingConfig config;
+  config.max_batch_size = ParseStringWithClassicLocale<int64_t>(
+      config_options.GetConfigOrDefault(kOrtSessionOptionsDynamicBatchingMaxBatchSize, "0"));
+  if (config.max_batch_size <= 0) {
+    return Status::OK();
+  }
+
+  config.max_queue_delay_us = ParseStringWithClassicLocale<int64_t>(
+      config_options.GetConfigOrDefault(kOrtSessionOptionsDynamicBatchingMaxQueueDelayUs, "1000"));
+  config.batch_axis = ParseStringWithClassicLocale<int64_t>(
+      config_options.GetConfigOrDefault(kOrtSessionOptionsDynamicBatchingBatchAxis, "0"));
+  ORT_RETURN_IF(config.max_queue_delay_us < 0, "Invalid maximum queue delay for dynamic batching: ",
+                config.max_queue_delay_us);
+  ORT_RETURN_IF(config.batch_axis < 0, "Invalid batch axis for dynamic batching: ", config.batch_axis);
+
+  auto run_fn = [this](const RunOptions& run_options,
+                       gsl::span<const char* const> feed_names,
+                       gsl::span<const OrtValue* const> feeds,
+                       gsl::span<const char* const> fetch_names,
+                       gsl::span<OrtValue*> fetches) {
+    return Run(run_options, feed_names, feeds, fetch_names, fetches);
+  };
+
+  auto schedule_fn = [this](std::function<void()> fn) {
+    concurrency::ThreadPool::Schedule(GetIntraOpThreadPoolToUse(), std::move(fn));
+  };
+
+  dynamic_batcher_ = std::make_unique<DynamicBatcher>(config, std::move(run_fn), std::move(schedule_fn),
+                                                      session_state_->GetAllocator(OrtDevice()),
+                                                      session_profiler_, *session_logger_);
+  LOGS(*session_logger_, INFO) << "Dynamic batching enabled. Maximum batch size: " << config.max_batch_size
+                               << ", maximum queue delay: " << config.max_queue_delay_us
+                               << "us, batch axis: " << config.batch_axis;
+  return Status::OK();
+}
+
+common::Status InferenceSession::GetDynamicBatchingStats(DynamicBatchingStats& stats) const {
+  if (!dynamic_batcher_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Dynamic batching is not enabled for this session.");
+  }
+
+  stats = dynamic_batcher_->GetStats();
+  return Status::OK();
+}
+
+common::Status InferenceSession::EstimatePeakMemory(const InlinedHashMap<std::string, TensorShape>& input_shapes,
+                                                    PeakMemoryEstimate& estimate,
+                                                    size_t num_largest_values) const {
+  {
+    std::lock_guard<std::mutex> l(session_mutex_);
+    if (!is_inited_) {
+      LOGS(*session_logger_, ERROR) << "Session was not initialized";
+      return common::Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+    }
+  }
+
+  return onnxruntime::EstimatePeakMemory(*session_state_, input_shapes, num_largest_values, estimate);
+}
+
 common::Status InferenceSession::Run(const NameMLValMap& feeds, gsl::span<const std::string> output_names,
                                      std::vector<OrtValue>* p_fetches) {
   return Run(RunOptions(), feeds, output_names, p_fetches);
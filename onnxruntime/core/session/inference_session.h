@@ -20,11 +20,14 @@
 #include "core/framework/iexecutor.h"
 #include "core/framework/external_data_loader_manager.h"
 #include "core/framework/kernel_registry_manager.h"
+#include "core/framework/peak_memory_estimator.h"
 #include "core/framework/prepacked_weights_container.h"
 #include "core/framework/session_state.h"
 #include "core/framework/tuning_results.h"
 #include "core/framework/framework_provider_common.h"
 #include "core/framework/session_options.h"
+#include "core/session/dynamic_batcher.h"
+#include "core/session/mapped_ort_model_file.h"
 #include "core/graph/basic_types.h"
 #include "core/optimizer/graph_transformer_level.h"
 #include "core/optimizer/graph_transformer_mgr.h"
@@ -352,6 +355,25 @@ class InferenceSession {
                                         RunAsyncCallbackFn callback,
                                         void* user_data = nullptr);
 
+  /**
+   * Get the queueing delay and batch size histograms of the requests batched by RunAsync.
+   * Dynamic batching is enabled with the kOrtSessionOptionsDynamicBatchingMaxBatchSize session config entry.
+   * @return FAIL if dynamic batching is not enabled.
+   */
+  [[nodiscard]] common::Status GetDynamicBatchingStats(DynamicBatchingStats& stats) const;
+
+  /**
+   * Estimate the peak memory used by the activations and outputs of the model for inputs of the given shapes,
+   * per device and per node, without running the model. See EstimatePeakMemory in peak_memory_estimator.h.
+   * @param input_shapes the shape of each graph input.
+   * @param estimate the estimate.
+   * @param num_largest_values the maximum number of values reported in estimate.largest_values.
+   * @return OK if success.
+   */
+  [[nodiscard]] common::Status EstimatePeakMemory(const InlinedHashMap<std::string, TensorShape>& input_shapes,
+                                                   PeakMemoryEstimate& estimate,
+                                                   size_t num_largest_values = 10) const;
+
   /**
    * Run a pre-loaded and pre-intialized model.
    * Multiple threads are allowed to run this function; hence its thread-safe.
@@ -601,6 +623,11 @@ class InferenceSession {
   /// convenience pointer to logger. should always be the same as session_state_.Logger();
   const logging::Logger* session_logger_;
 
+  // The ORT format model file mapped into memory if the session is created from its path and
+  // "session.map_ort_model_file" is "1". Shared with the other sessions of the process that load the same file.
+  // Declared before model_ and session_state_ as their initializers point into the mapping.
+  std::shared_ptr<const MappedOrtModelFile> ort_format_model_file_;
+
   // The model served by this inference session instance.
   // Currently this has to be a shared ptr because the Model::Load method
   // returns a shared_ptr only. Ideally factory functions should always return
@@ -615,6 +642,9 @@ class InferenceSession {
   ExecutionProviders execution_providers_;
 
  private:
+  // Creates dynamic_batcher_ if dynamic batching is enabled in the session options.
+  [[nodiscard]] common::Status CreateDynamicBatcher();
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(InferenceSession);
   void SetLoggingManager(const SessionOptions& session_options,
                          const Environment& session_env);
@@ -744,6 +774,10 @@ class InferenceSession {
   // It has a dependency on execution_providers_.
   std::unique_ptr<SessionState> session_state_;
 
+  // Batches the requests of RunAsync if enabled. Reset first in the destructor so that the queued requests are run
+  // while the rest of the session is still valid.
+  std::unique_ptr<DynamicBatcher> dynamic_batcher_;
+
   // Threadpools per session. These are initialized and used for the entire duration of the session
   // when use_per_session_threads is true.
   std::basic_string<ORTCHAR_T> thread_pool_name_;
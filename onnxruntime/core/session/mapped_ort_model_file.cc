@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/mapped_ort_model_file.h"
+
+#include <mutex>
+
+#include "core/common/inlined_containers.h"
+
+namespace onnxruntime {
+
+Status MappedOrtModelFile::Get(const PathString& model_uri, std::shared_ptr<const MappedOrtModelFile>& mapped_file) {
+  const auto& env = Env::Default();
+
+  PathString canonical_path;
+  ORT_RETURN_IF_ERROR(env.GetCanonicalPath(model_uri, canonical_path));
+
+  size_t length = 0;
+  ORT_RETURN_IF_ERROR(env.GetFileLength(canonical_path.c_str(), length));
+
+  // the mappings are owned by the sessions using them and unmapped once the last of them is gone
+  static std::mutex mutex;
+  static InlinedHashMap<PathString, std::weak_ptr<const MappedOrtModelFile>> mapped_files;
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  auto it = mapped_files.find(canonical_path);
+  if (it != mapped_files.end()) {
+    auto existing = it->second.lock();
+    // a file with a different length has been written in place of the one mapped
+    if (existing && existing->length_ == length) {
+      mapped_file = std::move(existing);
+      return Status::OK();
+    }
+  }
+
+  Env::MappedMemoryPtr mapped_memory;
+  ORT_RETURN_IF_ERROR(env.MapFileIntoMemory(canonical_path.c_str(), 0, length, mapped_memory));
+
+  std::shared_ptr<const MappedOrtModelFile> new_mapped_file(new MappedOrtModelFile(std::move(mapped_memory), length));
+
+  for (auto entry = mapped_files.begin(); entry != mapped_files.end();) {
+    if (entry->second.expired()) {
+      mapped_files.erase(entry++);
+    } else {
+      ++entry;
+    }
+  }
+
+  mapped_files[canonical_path] = new_mapped_file;
+  mapped_file = std::move(new_mapped_file);
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
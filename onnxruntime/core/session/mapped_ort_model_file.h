@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+
+#include <gsl/gsl>
+
+#include "core/common/common.h"
+#include "core/common/path_string.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+// An ORT format model file mapped into memory. The sessions of the process that load the same file share the mapping,
+// so the pages of the file are held once in the page cache instead of once per session in a heap buffer.
+//
+// The file must not be modified while a session using it exists.
+class MappedOrtModelFile {
+ public:
+  // Returns the mapping of `model_uri`, creating it if no session of the process currently holds one.
+  static Status Get(const PathString& model_uri, std::shared_ptr<const MappedOrtModelFile>& mapped_file);
+
+  gsl::span<const uint8_t> Bytes() const {
+    return gsl::span<const uint8_t>(reinterpret_cast<const uint8_t*>(mapped_memory_.get()), length_);
+  }
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MappedOrtModelFile);
+
+ private:
+  MappedOrtModelFile(Env::MappedMemoryPtr mapped_memory, size_t length)
+      : mapped_memory_(std::move(mapped_memory)), length_(length) {}
+
+  Env::MappedMemoryPtr mapped_memory_;
+  size_t length_;
+};
+
+}  // namespace onnxruntime
@@ -10,6 +10,7 @@
 #include "core/framework/execution_provider.h"
 #include "core/framework/tensor_type_and_shape.h"
 #include "core/framework/utils.h"
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <functional>
@@ -40,6 +41,7 @@
 #include "core/common/string_helper.h"
 
 #include "core/session/lora_adapters.h"
+#include "core/session/continuous_batcher.h"
 
 #ifdef USE_CUDA
 #include "core/providers/cuda/cuda_provider_factory.h"
@@ -865,6 +867,116 @@ ORT_API_STATUS_IMPL(OrtApis::SetEpDynamicOptions, _Inout_ OrtSession* sess,
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::CreateContinuousBatcher, _In_ OrtSession* sess, _In_ size_t max_slots,
+                    _In_ size_t max_length, _In_ int64_t eos_token_id, _Outptr_ OrtContinuousBatcher** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  const auto inputs = session->GetModelInputs();
+  ORT_API_RETURN_IF_STATUS_NOT_OK(inputs.first);
+  const auto outputs = session->GetModelOutputs();
+  ORT_API_RETURN_IF_STATUS_NOT_OK(outputs.first);
+
+  // the KV cache slots come from the session's CPU allocator so they follow its arena settings
+  auto allocator = session->GetAllocator(OrtMemoryInfo(onnxruntime::CPU, OrtDeviceAllocator));
+  if (!allocator) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "The session has no CPU allocator.");
+  }
+
+  onnxruntime::ContinuousBatchingParameters parameters;
+  parameters.max_slots = onnxruntime::narrow<int>(max_slots);
+  parameters.max_length = onnxruntime::narrow<int>(max_length);
+  parameters.eos_token_id = onnxruntime::narrow<int>(eos_token_id);
+
+  auto run_fn = [session](gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                          gsl::span<const std::string> fetch_names, std::vector<OrtValue>& fetches) {
+    onnxruntime::RunOptions run_options;
+    return session->Run(run_options, feed_names, feeds, fetch_names, &fetches);
+  };
+
+  std::unique_ptr<onnxruntime::ContinuousBatcher> batcher;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(onnxruntime::ContinuousBatcher::Create(
+      parameters, *inputs.second, *outputs.second, std::move(run_fn), std::move(allocator), batcher));
+  *out = reinterpret_cast<OrtContinuousBatcher*>(batcher.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API(void, OrtApis::ReleaseContinuousBatcher, _Frees_ptr_opt_ OrtContinuousBatcher* batcher) {
+  delete reinterpret_cast<onnxruntime::ContinuousBatcher*>(batcher);
+}
+
+ORT_API_STATUS_IMPL(OrtApis::ContinuousBatcherEnqueue, _Inout_ OrtContinuousBatcher* batcher,
+                    _In_reads_(prompt_length) const int32_t* prompt, _In_ size_t prompt_length,
+                    _In_ size_t max_new_tokens, _Out_ int64_t* request_id) {
+  API_IMPL_BEGIN
+  auto continuous_batcher = reinterpret_cast<onnxruntime::ContinuousBatcher*>(batcher);
+  ORT_API_RETURN_IF_STATUS_NOT_OK(continuous_batcher->Enqueue(gsl::make_span(prompt, prompt_length),
+                                                              onnxruntime::narrow<int>(max_new_tokens),
+                                                              *request_id));
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::ContinuousBatcherCancel, _Inout_ OrtContinuousBatcher* batcher,
+                    _In_ int64_t request_id) {
+  API_IMPL_BEGIN
+  reinterpret_cast<onnxruntime::ContinuousBatcher*>(batcher)->Cancel(request_id);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::ContinuousBatcherStep, _Inout_ OrtContinuousBatcher* batcher,
+                    _Out_ int64_t* request_ids, _Out_ int32_t* tokens, _Out_ int* finished,
+                    _Out_ size_t* num_tokens) {
+  API_IMPL_BEGIN
+  auto continuous_batcher = reinterpret_cast<onnxruntime::ContinuousBatcher*>(batcher);
+  std::vector<onnxruntime::ContinuousBatchingToken> step_tokens;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(continuous_batcher->Step(step_tokens));
+  for (size_t i = 0; i < step_tokens.size(); i++) {
+    request_ids[i] = step_tokens[i].request_id;
+    tokens[i] = step_tokens[i].token;
+    finished[i] = step_tokens[i].finished ? 1 : 0;
+  }
+  *num_tokens = step_tokens.size();
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::ContinuousBatcherGetRequestCount, _In_ const OrtContinuousBatcher* batcher,
+                    _Out_ size_t* out) {
+  API_IMPL_BEGIN
+  *out = reinterpret_cast<const onnxruntime::ContinuousBatcher*>(batcher)->NumRequests();
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionGetDynamicBatchingStats, _In_ const OrtSession* sess,
+                    _Out_ int64_t* num_requests, _Out_ int64_t* num_batches, _Out_ int64_t* num_unbatched_requests,
+                    _Out_writes_(batch_size_histogram_length) int64_t* batch_size_histogram,
+                    _In_ size_t batch_size_histogram_length,
+                    _Out_writes_(queue_delay_histogram_length) int64_t* queue_delay_histogram,
+                    _In_ size_t queue_delay_histogram_length) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  onnxruntime::DynamicBatchingStats stats;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->GetDynamicBatchingStats(stats));
+
+  *num_requests = stats.num_requests;
+  *num_batches = stats.num_batches;
+  *num_unbatched_requests = stats.num_unbatched_requests;
+
+  const auto copy_histogram = [](gsl::span<const int64_t> histogram, int64_t* out, size_t out_length) {
+    const size_t num_copied = std::min(histogram.size(), out_length);
+    std::copy_n(histogram.begin(), num_copied, out);
+    std::fill(out + num_copied, out + out_length, int64_t{0});
+  };
+  copy_histogram(stats.batch_size_histogram, batch_size_histogram, batch_size_histogram_length);
+  copy_histogram(stats.queue_delay_histogram, queue_delay_histogram, queue_delay_histogram_length);
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
                     _In_reads_(input_len) const char* const* input_names,
                     _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
@@ -2302,6 +2414,10 @@ ORT_API_STATUS_IMPL(OrtApis::CreateArenaCfgV2, _In_reads_(num_keys) const char*
       cfg->initial_growth_chunk_size_bytes = static_cast<int>(arena_config_values[i]);
     } else if (strcmp(arena_config_keys[i], "max_power_of_two_extend_bytes") == 0) {
       cfg->max_power_of_two_extend_bytes = static_cast<int64_t>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "thread_cache_max_block_size") == 0) {
+      cfg->thread_cache_max_block_size = static_cast<int64_t>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "idle_shrink_ms") == 0) {
+      cfg->idle_shrink_ms = static_cast<int64_t>(arena_config_values[i]);
     } else {
       std::ostringstream oss;
       oss << "Invalid key found: " << arena_config_keys[i];
@@ -2809,6 +2925,15 @@ static constexpr OrtApi ort_api_1_to_21 = {
     &OrtApis::RunOptionsAddActiveLoraAdapter,
 
     &OrtApis::SetEpDynamicOptions,
+
+    &OrtApis::CreateContinuousBatcher,
+    &OrtApis::ReleaseContinuousBatcher,
+    &OrtApis::ContinuousBatcherEnqueue,
+    &OrtApis::ContinuousBatcherCancel,
+    &OrtApis::ContinuousBatcherStep,
+    &OrtApis::ContinuousBatcherGetRequestCount,
+
+    &OrtApis::SessionGetDynamicBatchingStats,
 };
 
 // OrtApiBase can never change as there is no way to know what version of OrtApiBase is returned by OrtGetApiBase.
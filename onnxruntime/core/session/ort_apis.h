@@ -533,4 +533,22 @@ ORT_API_STATUS_IMPL(RunOptionsAddActiveLoraAdapter, _Inout_ OrtRunOptions* optio
 
 ORT_API_STATUS_IMPL(SetEpDynamicOptions, _Inout_ OrtSession* sess, _In_reads_(kv_len) const char* const* keys,
                     _In_reads_(kv_len) const char* const* values, _In_ size_t kv_len);
+
+ORT_API_STATUS_IMPL(CreateContinuousBatcher, _In_ OrtSession* session, _In_ size_t max_slots, _In_ size_t max_length,
+                    _In_ int64_t eos_token_id, _Outptr_ OrtContinuousBatcher** out);
+ORT_API(void, ReleaseContinuousBatcher, _Frees_ptr_opt_ OrtContinuousBatcher*);
+ORT_API_STATUS_IMPL(ContinuousBatcherEnqueue, _Inout_ OrtContinuousBatcher* batcher,
+                    _In_reads_(prompt_length) const int32_t* prompt, _In_ size_t prompt_length,
+                    _In_ size_t max_new_tokens, _Out_ int64_t* request_id);
+ORT_API_STATUS_IMPL(ContinuousBatcherCancel, _Inout_ OrtContinuousBatcher* batcher, _In_ int64_t request_id);
+ORT_API_STATUS_IMPL(ContinuousBatcherStep, _Inout_ OrtContinuousBatcher* batcher, _Out_ int64_t* request_ids,
+                    _Out_ int32_t* tokens, _Out_ int* finished, _Out_ size_t* num_tokens);
+ORT_API_STATUS_IMPL(ContinuousBatcherGetRequestCount, _In_ const OrtContinuousBatcher* batcher, _Out_ size_t* out);
+
+ORT_API_STATUS_IMPL(SessionGetDynamicBatchingStats, _In_ const OrtSession* session, _Out_ int64_t* num_requests,
+                    _Out_ int64_t* num_batches, _Out_ int64_t* num_unbatched_requests,
+                    _Out_writes_(batch_size_histogram_length) int64_t* batch_size_histogram,
+                    _In_ size_t batch_size_histogram_length,
+                    _Out_writes_(queue_delay_histogram_length) int64_t* queue_delay_histogram,
+                    _In_ size_t queue_delay_histogram_length);
 }  // namespace OrtApis
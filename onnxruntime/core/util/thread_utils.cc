@@ -4,6 +4,7 @@
 #include "core/util/thread_utils.h"
 
 #include <algorithm>
+#include <string_view>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -22,6 +23,7 @@ std::ostream& operator<<(std::ostream& os, const OrtThreadPoolParams& params) {
   os << " dynamic_block_base_: " << params.dynamic_block_base_;
   os << " stack_size: " << params.stack_size;
   os << " affinity_str: " << params.affinity_str;
+  os << " numa_aware: " << params.numa_aware;
   // os << " name: " << (params.name ? params.name : L"nullptr");
   os << " set_denormal_as_zero: " << params.set_denormal_as_zero;
   // os << " custom_create_thread_fn: " << (params.custom_create_thread_fn ? "set" : "nullptr");
@@ -35,6 +37,8 @@ namespace onnxruntime {
 namespace concurrency {
 
 #if !defined(ORT_MINIMAL_BUILD) && !defined(ORT_EXTENDED_MINIMAL_BUILD)
+static constexpr std::string_view kNumaNodePrefix = "numa:";
+
 // Extract affinity from affinity string.
 // Processor id from affinity string starts from 1,
 // but internally, processor id starts from 0, so here we minus the id by 1
@@ -47,7 +51,18 @@ static std::vector<LogicalProcessors> ReadThreadAffinityConfig(const std::string
       LogicalProcessors logical_processors;
       auto processor_interval = utils::SplitString(affinity, "-");
 
-      if (processor_interval.size() == 2) {
+      if (affinity.substr(0, kNumaNodePrefix.size()) == kNumaNodePrefix) {
+        const auto node_str = affinity.substr(kNumaNodePrefix.size());
+        ORT_ENFORCE(!node_str.empty() && std::all_of(node_str.begin(), node_str.end(), ::isdigit),
+                    std::string{"NUMA node id must consist of only digits: "} + std::string{affinity});
+
+        const auto numa_nodes = Env::Default().GetNumaNodeProcessors();
+        const auto node = static_cast<size_t>(std::stoi(std::string{node_str}));
+        ORT_ENFORCE(node < numa_nodes.size() && !numa_nodes[node].empty(),
+                    std::string{"NUMA node does not exist or has no processors: "} + std::string{affinity});
+
+        logical_processors = numa_nodes[node];
+      } else if (processor_interval.size() == 2) {
         ORT_ENFORCE(std::all_of(processor_interval[0].begin(), processor_interval[0].end(), ::isdigit) &&
                         std::all_of(processor_interval[1].begin(), processor_interval[1].end(), ::isdigit),
                     std::string{"Processor id must consist of only digits: "} + std::string{affinity});
@@ -89,6 +104,29 @@ static std::vector<LogicalProcessors> ReadThreadAffinityConfig(const std::string
 }
 #endif
 
+// Splits the threads of the pool into one contiguous partition per NUMA node that has processors. Parallel loops hand
+// neighbouring iterations to threads with neighbouring indices, so those mostly share a node and its memory.
+// Each thread is attached to all processors of its node. Returns an empty vector if there are less than two nodes.
+static std::vector<LogicalProcessors> GetNumaThreadAffinities(int thread_pool_size) {
+  auto numa_nodes = Env::Default().GetNumaNodeProcessors();
+  numa_nodes.erase(std::remove_if(numa_nodes.begin(), numa_nodes.end(),
+                                  [](const LogicalProcessors& processors) { return processors.empty(); }),
+                   numa_nodes.end());
+  if (numa_nodes.size() < 2) {
+    return {};
+  }
+
+  std::vector<LogicalProcessors> affinities;
+  affinities.reserve(thread_pool_size);
+  for (size_t i = 0, num_threads = static_cast<size_t>(thread_pool_size); i < num_threads; ++i) {
+    affinities.push_back(numa_nodes[i * numa_nodes.size() / num_threads]);
+  }
+
+  // the first entry is for the main thread, whose affinity onnxruntime doesn't set
+  affinities.front().clear();
+  return affinities;
+}
+
 static std::unique_ptr<ThreadPool>
 CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
   ThreadOptions to;
@@ -123,6 +161,12 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
   if (options.thread_pool_size <= 1) {
     return nullptr;
   }
+  if (options.numa_aware && options.affinity_str.empty()) {
+    auto numa_affinities = GetNumaThreadAffinities(options.thread_pool_size);
+    if (!numa_affinities.empty()) {
+      to.affinities = std::move(numa_affinities);
+    }
+  }
   // override affinity setting if specified from customer
   if (!options.affinity_str.empty()) {
 #if defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
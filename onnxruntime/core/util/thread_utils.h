@@ -35,8 +35,15 @@ struct OrtThreadPoolParams {
   // or
   // 1-8
   // meaning ith thread will be attached to first 8 logical processors
+  // or
+  // numa:1
+  // meaning ith thread attach to the logical processors of NUMA node 1 (NUMA node ids start from 0)
   std::string affinity_str;
 
+  // If it is true and affinity_str is empty, the threads are split into one partition per NUMA node and
+  // each thread is attached to the logical processors of its node.
+  bool numa_aware = false;
+
   const ORTCHAR_T* name = nullptr;
 
   // Set or unset denormal as zero
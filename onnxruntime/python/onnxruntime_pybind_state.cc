@@ -1601,6 +1601,10 @@ void addObjectMethods(py::module& m, ExecutionProviderRegistrationFn ep_registra
             ort_arena_cfg->initial_growth_chunk_size_bytes = kvp.second.cast<int>();
           } else if (key == "max_power_of_two_extend_bytes") {
             ort_arena_cfg->max_power_of_two_extend_bytes = kvp.second.cast<int>();
+          } else if (key == "thread_cache_max_block_size") {
+            ort_arena_cfg->thread_cache_max_block_size = kvp.second.cast<int64_t>();
+          } else if (key == "idle_shrink_ms") {
+            ort_arena_cfg->idle_shrink_ms = kvp.second.cast<int64_t>();
           } else {
             ORT_THROW("Invalid OrtArenaCfg option: ", key);
           }
@@ -1612,7 +1616,9 @@ void addObjectMethods(py::module& m, ExecutionProviderRegistrationFn ep_registra
       .def_readwrite("initial_chunk_size_bytes", &OrtArenaCfg::initial_chunk_size_bytes)
       .def_readwrite("max_dead_bytes_per_chunk", &OrtArenaCfg::max_dead_bytes_per_chunk)
       .def_readwrite("initial_growth_chunk_size_bytes", &OrtArenaCfg::initial_growth_chunk_size_bytes)
-      .def_readwrite("max_power_of_two_extend_bytes", &OrtArenaCfg::max_power_of_two_extend_bytes);
+      .def_readwrite("max_power_of_two_extend_bytes", &OrtArenaCfg::max_power_of_two_extend_bytes)
+      .def_readwrite("thread_cache_max_block_size", &OrtArenaCfg::thread_cache_max_block_size)
+      .def_readwrite("idle_shrink_ms", &OrtArenaCfg::idle_shrink_ms);
 
   py::class_<OrtMemoryInfo> ort_memory_info_binding(m, "OrtMemoryInfo");
   ort_memory_info_binding.def(py::init([](const char* name, OrtAllocatorType type, int id, OrtMemType mem_type) {
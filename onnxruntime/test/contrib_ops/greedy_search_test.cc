@@ -1,12 +1,16 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <memory>
+#include <string>
 #include <vector>
 #include "gtest/gtest.h"
 #include <gsl/gsl>
+#include "core/graph/model.h"
 #include "core/session/onnxruntime_cxx_api.h"
 #include "test/common/cuda_op_test_utils.h"
+#include "test/util/include/asserts.h"
 
 #ifdef USE_CUDA
 #include "core/providers/cuda/cuda_provider_options.h"
@@ -183,5 +187,142 @@ TEST(GreedySearchTest, GptGreedySearchFp32) {
   }
 }
 
+namespace {
+
+// Adds the decoder subgraph as the draft_decoder subgraph of the GreedySearch node, and the speculative_stats
+// output. When negate_draft_logits is true, the draft_decoder subgraph outputs the negated logits, so its proposed
+// tokens are rejected.
+void CreateSpeculativeDecodingModel(bool negate_draft_logits, std::string& model_data) {
+  ONNX_NAMESPACE::ModelProto model_proto;
+  ASSERT_STATUS_OK(Model::Load(ORT_TSTR("testdata/transformers/tiny_gpt2_greedysearch_with_init_decoder.onnx"),
+                               model_proto));
+
+  auto* graph = model_proto.mutable_graph();
+  auto node = std::find_if(graph->mutable_node()->begin(), graph->mutable_node()->end(),
+                           [](const ONNX_NAMESPACE::NodeProto& n) { return n.op_type() == "GreedySearch"; });
+  ASSERT_NE(node, graph->mutable_node()->end());
+  ASSERT_EQ(node->output_size(), 1);
+
+  auto decoder = std::find_if(node->attribute().begin(), node->attribute().end(),
+                              [](const ONNX_NAMESPACE::AttributeProto& a) { return a.name() == "decoder"; });
+  ASSERT_NE(decoder, node->attribute().end());
+  ONNX_NAMESPACE::AttributeProto draft_decoder = *decoder;
+  draft_decoder.set_name("draft_decoder");
+
+  if (negate_draft_logits) {
+    auto* draft_graph = draft_decoder.mutable_g();
+    const std::string logits_name = draft_graph->output(0).name();
+    auto producer = std::find_if(draft_graph->mutable_node()->begin(), draft_graph->mutable_node()->end(),
+                                 [&logits_name](const ONNX_NAMESPACE::NodeProto& n) {
+                                   return std::find(n.output().begin(), n.output().end(), logits_name) !=
+                                          n.output().end();
+                                 });
+    ASSERT_NE(producer, draft_graph->mutable_node()->end());
+    for (auto& output : *producer->mutable_output()) {
+      if (output == logits_name) {
+        output = logits_name + "_draft";
+      }
+    }
+
+    auto* negate = draft_graph->add_node();
+    negate->set_op_type("Neg");
+    negate->set_name("NegateDraftLogits");
+    negate->add_input(logits_name + "_draft");
+    negate->add_output(logits_name);
+  }
+  *node->add_attribute() = draft_decoder;
+
+  auto* num_speculative_tokens = node->add_attribute();
+  num_speculative_tokens->set_name("num_speculative_tokens");
+  num_speculative_tokens->set_type(ONNX_NAMESPACE::AttributeProto_AttributeType_INT);
+  num_speculative_tokens->set_i(3);
+
+  node->add_output("speculative_stats");
+  auto* stats_output = graph->add_output();
+  stats_output->set_name("speculative_stats");
+  stats_output->mutable_type()->mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_INT32);
+  stats_output->mutable_type()->mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  ASSERT_TRUE(model_proto.SerializeToString(&model_data));
+}
+
+// Runs the model with and without the draft_decoder subgraph, checks that the sequences are the same and returns
+// the number of proposed and accepted draft tokens.
+void RunSpeculativeDecoding(bool negate_draft_logits, std::vector<int32_t>& stats) {
+  std::string speculative_model_data;
+  CreateSpeculativeDecodingModel(negate_draft_logits, speculative_model_data);
+  ASSERT_FALSE(speculative_model_data.empty());
+
+  std::vector<int64_t> input_ids_shape{1, 4};
+  std::vector<int32_t> input_ids{0, 0, 195, 731};
+
+  std::vector<int64_t> parameter_shape{1};
+  std::vector<int32_t> max_length{12};
+  std::vector<int32_t> min_length{1};
+  std::vector<float> repetition_penalty{1.0f};
+
+  Ort::MemoryInfo info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
+  auto create_inputs = [&]() {
+    std::vector<Ort::Value> ort_inputs;
+    ort_inputs.push_back(Ort::Value::CreateTensor(
+        info, input_ids.data(), input_ids.size(), input_ids_shape.data(), input_ids_shape.size()));
+    ort_inputs.push_back(Ort::Value::CreateTensor(
+        info, max_length.data(), max_length.size(), parameter_shape.data(), parameter_shape.size()));
+    ort_inputs.push_back(Ort::Value::CreateTensor(
+        info, min_length.data(), min_length.size(), parameter_shape.data(), parameter_shape.size()));
+    ort_inputs.push_back(Ort::Value::CreateTensor(
+        info, repetition_penalty.data(), repetition_penalty.size(), parameter_shape.data(), parameter_shape.size()));
+    return ort_inputs;
+  };
+  const char* input_names[] = {"input_ids", "max_length", "min_length", "repetition_penalty"};
+  const char* const output_names[] = {"sequences", "speculative_stats"};
+
+  Ort::SessionOptions session_options;
+  Ort::Session session(*ort_env, ORT_TSTR("testdata/transformers/tiny_gpt2_greedysearch_with_init_decoder.onnx"),
+                       session_options);
+  auto ort_inputs = create_inputs();
+  auto expected_outputs = session.Run(Ort::RunOptions{}, input_names, ort_inputs.data(), ort_inputs.size(),
+                                      output_names, 1);
+
+  Ort::Session speculative_session(*ort_env, speculative_model_data.data(), speculative_model_data.size(),
+                                   session_options);
+  auto speculative_inputs = create_inputs();
+  auto ort_outputs = speculative_session.Run(Ort::RunOptions{}, input_names, speculative_inputs.data(),
+                                             speculative_inputs.size(), output_names, 2);
+  ASSERT_EQ(ort_outputs.size(), 2U);
+
+  const auto expected_shape = expected_outputs[0].GetTensorTypeAndShapeInfo().GetShape();
+  ASSERT_EQ(expected_shape, ort_outputs[0].GetTensorTypeAndShapeInfo().GetShape());
+  const auto expected_sequences = gsl::make_span(expected_outputs[0].GetTensorData<int32_t>(),
+                                                 static_cast<size_t>(expected_shape[0] * expected_shape[1]));
+  const auto sequences = gsl::make_span(ort_outputs[0].GetTensorData<int32_t>(), expected_sequences.size());
+  ASSERT_TRUE(std::equal(expected_sequences.begin(), expected_sequences.end(), sequences.begin(), sequences.end()));
+
+  ASSERT_EQ(ort_outputs[1].GetTensorTypeAndShapeInfo().GetShape(), std::vector<int64_t>{2});
+  stats.assign(ort_outputs[1].GetTensorData<int32_t>(), ort_outputs[1].GetTensorData<int32_t>() + 2);
+}
+
+}  // namespace
+
+TEST(GreedySearchTest, GptGreedySearchSpeculativeDecoding) {
+  // Use the decoder subgraph as the draft_decoder subgraph: all the proposed tokens are accepted,
+  // and the sequences are the same as without speculative decoding.
+  std::vector<int32_t> stats;
+  RunSpeculativeDecoding(false, stats);
+  ASSERT_EQ(stats.size(), 2U);
+  EXPECT_GT(stats[0], 0);
+  EXPECT_EQ(stats[1], stats[0]);
+}
+
+TEST(GreedySearchTest, GptGreedySearchSpeculativeDecodingRejectedTokens) {
+  // The draft_decoder subgraph proposes the least likely tokens: they are rejected and the past state of both
+  // subgraphs is rolled back, and the sequences are still the same as without speculative decoding.
+  std::vector<int32_t> stats;
+  RunSpeculativeDecoding(true, stats);
+  ASSERT_EQ(stats.size(), 2U);
+  EXPECT_GT(stats[0], 0);
+  EXPECT_LT(stats[1], stats[0]);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
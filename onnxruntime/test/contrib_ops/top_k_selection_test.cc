@@ -0,0 +1,134 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "contrib_ops/cpu/transformers/top_k_selection.h"
+
+namespace onnxruntime {
+namespace test {
+
+using contrib::transformers::SelectTopK;
+using contrib::transformers::SelectTopKRows;
+using contrib::transformers::SelectTopP;
+
+namespace {
+
+// Indices of the row in descending order of score, ascending order of index for equal scores.
+std::vector<int32_t> SortedIndices(const std::vector<float>& scores) {
+  std::vector<int32_t> indices(scores.size());
+  std::iota(indices.begin(), indices.end(), 0);
+  std::stable_sort(indices.begin(), indices.end(), [&scores](int32_t a, int32_t b) { return scores[a] > scores[b]; });
+  return indices;
+}
+
+std::vector<float> RandomScores(size_t size, int num_distinct_values, uint32_t seed) {
+  std::default_random_engine generator(seed);
+  std::uniform_int_distribution<int> distribution(0, num_distinct_values - 1);
+  std::vector<float> scores(size);
+  for (auto& score : scores) {
+    score = static_cast<float>(distribution(generator)) / static_cast<float>(num_distinct_values);
+  }
+  return scores;
+}
+
+std::vector<float> Softmax(const std::vector<float>& scores) {
+  const float max_score = *std::max_element(scores.begin(), scores.end());
+  std::vector<float> probs(scores.size());
+  float sum = 0.0f;
+  for (size_t i = 0; i < scores.size(); i++) {
+    probs[i] = std::exp(scores[i] - max_score);
+    sum += probs[i];
+  }
+  for (auto& prob : probs) {
+    prob /= sum;
+  }
+  return probs;
+}
+
+// Number of tokens kept by top-p filtering of the whole sorted row.
+size_t ReferenceTopP(const std::vector<float>& probs, const std::vector<int32_t>& sorted, float top_p, bool keep_equal,
+                     size_t min_tokens_to_keep) {
+  float cumulative_prob = 0.0f;
+  size_t num_kept = 0;
+  for (; num_kept < sorted.size(); num_kept++) {
+    if (keep_equal ? cumulative_prob > top_p : cumulative_prob >= top_p) {
+      break;
+    }
+    cumulative_prob += probs[sorted[num_kept]];
+  }
+  return std::max(num_kept, std::min(min_tokens_to_keep, probs.size()));
+}
+
+}  // namespace
+
+TEST(TopKSelectionTest, SelectTopK) {
+  for (size_t size : {1, 7, 100, 4096, 50257}) {
+    // Few distinct values to have ties at the k-th score.
+    for (int num_distinct_values : {3, 1000, 1 << 20}) {
+      const std::vector<float> scores = RandomScores(size, num_distinct_values, static_cast<uint32_t>(size));
+      const std::vector<int32_t> expected = SortedIndices(scores);
+      for (size_t k : {size_t{1}, size_t{2}, size_t{8}, size_t{64}, size / 3, size}) {
+        k = std::min(std::max(k, size_t{1}), size);
+        std::vector<int32_t> indices(size);
+        SelectTopK<float>(scores, k, indices);
+        ASSERT_TRUE(std::equal(expected.begin(), expected.begin() + k, indices.begin()))
+            << "size=" << size << ", k=" << k << ", num_distinct_values=" << num_distinct_values;
+      }
+    }
+  }
+}
+
+TEST(TopKSelectionTest, SelectTopKRows) {
+  constexpr int64_t rows = 3;
+  constexpr int64_t cols = 8192;
+  constexpr size_t k = 8;
+  const std::vector<float> scores = RandomScores(rows * cols, 1 << 16, 0);
+
+  std::vector<float> top_scores(rows * k);
+  std::vector<int64_t> top_indices(rows * k);
+  SelectTopKRows<float>(scores.data(), rows, cols, k, nullptr, top_scores.data(), top_indices.data());
+
+  for (int64_t row = 0; row < rows; row++) {
+    const std::vector<float> row_scores(scores.begin() + row * cols, scores.begin() + (row + 1) * cols);
+    const std::vector<int32_t> expected = SortedIndices(row_scores);
+    for (size_t i = 0; i < k; i++) {
+      EXPECT_EQ(top_indices[row * k + i], expected[i]);
+      EXPECT_EQ(top_scores[row * k + i], row_scores[expected[i]]);
+    }
+  }
+}
+
+TEST(TopKSelectionTest, SelectTopP) {
+  for (size_t size : {2, 100, 32000}) {
+    for (float temperature : {0.01f, 0.1f, 1.0f}) {
+      std::vector<float> scores = RandomScores(size, 1 << 20, 1);
+      for (auto& score : scores) {
+        score /= temperature;
+      }
+      const std::vector<float> probs = Softmax(scores);
+      const std::vector<int32_t> sorted = SortedIndices(probs);
+
+      for (float top_p : {0.0f, 0.5f, 0.9f, 1.0f}) {
+        for (bool keep_equal : {false, true}) {
+          for (size_t min_tokens_to_keep : {size_t{0}, size_t{1}, size_t{100}}) {
+            std::vector<int32_t> indices(size);
+            const size_t num_kept = SelectTopP<float>(probs, top_p, keep_equal, min_tokens_to_keep, indices);
+            ASSERT_EQ(num_kept, ReferenceTopP(probs, sorted, top_p, keep_equal, min_tokens_to_keep))
+                << "size=" << size << ", temperature=" << temperature << ", top_p=" << top_p
+                << ", keep_equal=" << keep_equal << ", min_tokens_to_keep=" << min_tokens_to_keep;
+            ASSERT_TRUE(std::equal(sorted.begin(), sorted.begin() + num_kept, indices.begin()));
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -6,7 +6,11 @@
 #include "core/framework/allocator_utils.h"
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
+#include <chrono>
 #include <cstdlib>
+#include <cstring>
+#include <set>
+#include <thread>
 #include "core/framework/stream_handles.h"
 
 namespace onnxruntime {
@@ -307,6 +311,182 @@ TEST(BFCArenaTest, TestShrink) {
   EXPECT_EQ(stats.total_allocated_bytes, 10 * 1024 * 1024) << "Expect 10M bytes but actually " << stats.total_allocated_bytes << " bytes";
 }
 
+TEST(BFCArenaTest, ReleaseIdleRegions) {
+  // the window is long enough for the background thread not to interfere
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             BFCArena::DEFAULT_THREAD_CACHE_MAX_BLOCK_SIZE, 60 * 60 * 1000);
+  void* p1k = a.Alloc(1024);
+  void* p10M = a.Alloc(10 * 1024 * 1024);
+  a.Free(p1k);
+
+  // p1k's region was used during the current window
+  AllocatorStats stats;
+  EXPECT_EQ(a.ReleaseIdleRegions(), Status::OK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_arena_extensions, 2);
+  EXPECT_EQ(stats.num_idle_region_releases, 0);
+  EXPECT_EQ(stats.recent_max_bytes_in_use, 1024 + 10 * 1024 * 1024);
+
+  // it has been idle for a whole window now. p10M's region is still in use.
+  EXPECT_EQ(a.ReleaseIdleRegions(), Status::OK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_arena_extensions, 1);
+  EXPECT_EQ(stats.num_idle_region_releases, 1);
+  EXPECT_EQ(stats.idle_released_bytes, 1024);
+  EXPECT_EQ(stats.total_allocated_bytes, 10 * 1024 * 1024);
+  EXPECT_EQ(stats.recent_max_bytes_in_use, 10 * 1024 * 1024);
+
+  // a region that is freed and re-used in every window is kept
+  a.Free(p10M);
+  for (int i = 0; i < 3; ++i) {
+    p10M = a.Alloc(10 * 1024 * 1024);
+    a.Free(p10M);
+    EXPECT_EQ(a.ReleaseIdleRegions(), Status::OK());
+  }
+
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_arena_extensions, 1);
+  EXPECT_EQ(stats.num_idle_region_releases, 1);
+}
+
+TEST(BFCArenaTest, ReleaseIdleRegionsInBackground) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             BFCArena::DEFAULT_THREAD_CACHE_MAX_BLOCK_SIZE, 10);
+  a.Free(a.Alloc(1024 * 1024));
+
+  AllocatorStats stats;
+  for (int i = 0; i < 500; ++i) {
+    a.GetStats(&stats);
+    if (stats.num_idle_region_releases != 0) {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  EXPECT_EQ(stats.num_idle_region_releases, 1);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+}
+
+TEST(BFCArenaTest, ThreadCacheReusesBlocks) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, BFCArena::DEFAULT_ARENA_EXTEND_STRATEGY,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             4096);
+
+  void* p = a.Alloc(100);
+  ASSERT_NE(p, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 64, 0u);
+  EXPECT_EQ(a.AllocatedSize(p), 128u);
+  memset(p, 0xcd, 100);
+  a.Free(p);
+
+  // the block is reused from the magazine of this thread
+  void* p2 = a.Alloc(128);
+  EXPECT_EQ(p2, p);
+  a.Free(p2);
+
+  // larger requests bypass the cache
+  void* large = a.Alloc(8192);
+  EXPECT_EQ(a.AllocatedSize(large), 8192u);
+  a.Free(large);
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_thread_cache_misses, 1);
+  EXPECT_EQ(stats.num_thread_cache_hits, 1);
+}
+
+TEST(BFCArenaTest, ThreadCacheMultipleThreads) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, BFCArena::DEFAULT_ARENA_EXTEND_STRATEGY,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             64 * 1024);
+
+  constexpr int kNumThreads = 4;
+  constexpr int kNumIterations = 2000;
+
+  // blocks allocated by one thread are freed by the next one to exercise returning blocks to other threads' caches
+  std::vector<std::vector<void*>> allocated(kNumThreads);
+  auto alloc_fn = [&a, &allocated](int thread_idx) {
+    for (int i = 0; i < kNumIterations; ++i) {
+      size_t size = 1 + (i * 37) % (64 * 1024);
+      auto* p = static_cast<uint8_t*>(a.Alloc(size));
+      ASSERT_NE(p, nullptr);
+      p[0] = static_cast<uint8_t>(thread_idx);
+      p[size - 1] = static_cast<uint8_t>(thread_idx);
+      allocated[thread_idx].push_back(p);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back(alloc_fn, t);
+  }
+
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  // no block may have been handed out twice
+  std::set<void*> unique_ptrs;
+  for (const auto& ptrs : allocated) {
+    unique_ptrs.insert(ptrs.begin(), ptrs.end());
+  }
+
+  ASSERT_EQ(unique_ptrs.size(), static_cast<size_t>(kNumThreads * kNumIterations));
+
+  threads.clear();
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&a, &allocated, t]() {
+      for (void* p : allocated[(t + 1) % kNumThreads]) {
+        a.Free(p);
+      }
+    });
+  }
+
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_thread_cache_hits + stats.num_thread_cache_misses, kNumThreads * kNumIterations);
+}
+
+TEST(BFCArenaTest, ThreadCacheReleasedOnThreadExit) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30);
+  ArenaThreadCache cache(a, 4096);
+
+  constexpr int kNumThreads = 8;
+  std::set<void*> blocks;
+  for (int t = 0; t < kNumThreads; ++t) {
+    std::thread([&cache, &blocks]() {
+      void* p = cache.Alloc(100);
+      ASSERT_NE(p, nullptr);
+      blocks.insert(p);
+      cache.Free(p);
+    }).join();
+  }
+
+  // the cache of each thread is released when it exits and its blocks are reused by the next thread
+  EXPECT_EQ(cache.NumThreadCaches(), 0u);
+  EXPECT_EQ(blocks.size(), 1u);
+
+  AllocatorStats stats;
+  cache.GetStats(stats);
+  EXPECT_EQ(stats.num_thread_cache_misses, kNumThreads);
+  EXPECT_EQ(stats.num_thread_cache_hits, 0);
+
+  void* p = cache.Alloc(100);
+  EXPECT_EQ(blocks.count(p), 1u);
+  EXPECT_EQ(cache.NumThreadCaches(), 1u);
+  cache.Free(p);
+}
+
 class BadAllocator : public IAllocator {
  public:
   BadAllocator() : IAllocator(OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator)) {}
@@ -0,0 +1,332 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "core/framework/allocator.h"
+#include "core/framework/tensor.h"
+#include "core/graph/node_arg.h"
+#include "core/graph/onnx_protobuf.h"
+#include "core/session/continuous_batcher.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+constexpr int64_t kVocabSize = 11;
+constexpr int64_t kKvNumHeads = 2;
+constexpr int64_t kHeadSize = 3;
+
+ONNX_NAMESPACE::TypeProto MakeTensorType(int32_t elem_type, const std::vector<int64_t>& dims) {
+  ONNX_NAMESPACE::TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(elem_type);
+  auto* shape = type.mutable_tensor_type()->mutable_shape();
+  for (int64_t dim : dims) {
+    if (dim > 0) {
+      shape->add_dim()->set_dim_value(dim);
+    } else {
+      shape->add_dim()->set_dim_param("dynamic");
+    }
+  }
+  return type;
+}
+
+// A decoder-only model with one layer whose next token is the sum of the tokens in its KV cache modulo the vocabulary
+// size. The token of each position is written to the KV cache, so the tokens generated for a request are only right
+// if every step reads and writes the rows of the slot of the request.
+struct FakeModel {
+  explicit FakeModel(bool with_position_ids = true) {
+    constexpr auto int32_type = ONNX_NAMESPACE::TensorProto_DataType_INT32;
+    constexpr auto int64_type = ONNX_NAMESPACE::TensorProto_DataType_INT64;
+    constexpr auto float_type = ONNX_NAMESPACE::TensorProto_DataType_FLOAT;
+    const auto kv_type = MakeTensorType(float_type, {-1, kKvNumHeads, -1, kHeadSize});
+
+    AddArg(inputs, "input_ids", MakeTensorType(int32_type, {-1, -1}));
+    AddArg(inputs, "attention_mask", MakeTensorType(int64_type, {-1, -1}));
+    if (with_position_ids) {
+      AddArg(inputs, "position_ids", MakeTensorType(int64_type, {-1, -1}));
+    }
+    AddArg(inputs, "past_key_values.0.key", kv_type);
+    AddArg(inputs, "past_key_values.0.value", kv_type);
+    AddArg(outputs, "logits", MakeTensorType(float_type, {-1, -1, kVocabSize}));
+    AddArg(outputs, "present.0.key", kv_type);
+    AddArg(outputs, "present.0.value", kv_type);
+  }
+
+  void AddArg(std::vector<const NodeArg*>& args, const std::string& name, const ONNX_NAMESPACE::TypeProto& type) {
+    node_args.push_back(std::make_unique<NodeArg>(name, &type));
+    args.push_back(node_args.back().get());
+  }
+
+  Status Run(gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+             gsl::span<const std::string> fetch_names, std::vector<OrtValue>& fetches) {
+    std::map<std::string, const Tensor*> inputs_by_name;
+    for (size_t i = 0; i < feed_names.size(); i++) {
+      inputs_by_name[feed_names[i]] = &feeds[i].Get<Tensor>();
+    }
+    EXPECT_EQ(fetch_names[0], "logits");
+    EXPECT_EQ(fetch_names[1], "present.0.key");
+
+    const Tensor& input_ids = *inputs_by_name.at("input_ids");
+    const Tensor& attention_mask = *inputs_by_name.at("attention_mask");
+    const Tensor& past_key = *inputs_by_name.at("past_key_values.0.key");
+    const int64_t batch_size = input_ids.Shape()[0];
+    const int64_t sequence_length = input_ids.Shape()[1];
+    const int64_t total_length = attention_mask.Shape()[1];
+    const int64_t max_length = past_key.Shape()[2];
+
+    // The present state is bound to the buffer of the past state.
+    Tensor& present_key = *fetches[1].GetMutable<Tensor>();
+    EXPECT_EQ(present_key.DataRaw(), past_key.DataRaw());
+    EXPECT_EQ(past_key.Shape()[0], batch_size);
+    float* cache = present_key.MutableData<float>();
+
+    Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape({batch_size, sequence_length, kVocabSize}),
+                         allocator, fetches[0]);
+    float* logits = fetches[0].GetMutable<Tensor>()->MutableData<float>();
+    std::fill_n(logits, batch_size * sequence_length * kVocabSize, 0.0f);
+
+    for (int64_t b = 0; b < batch_size; b++) {
+      const int64_t* mask = attention_mask.Data<int64_t>() + b * total_length;
+      const int64_t valid_length = std::accumulate(mask, mask + total_length, int64_t{0});
+      EXPECT_GE(valid_length, sequence_length);
+      const int64_t past_length = valid_length - sequence_length;
+
+      // Row b, head 0, position p, element 0 of the cache holds the token of position p.
+      float* row_cache = cache + b * kKvNumHeads * max_length * kHeadSize;
+      for (int64_t s = 0; s < sequence_length; s++) {
+        const int64_t position = past_length + s;
+        if (inputs_by_name.count("position_ids") != 0) {
+          EXPECT_EQ(inputs_by_name.at("position_ids")->Data<int64_t>()[b * sequence_length + s], position);
+        }
+        row_cache[position * kHeadSize] = static_cast<float>(input_ids.Data<int32_t>()[b * sequence_length + s]);
+      }
+
+      int64_t sum = 0;
+      for (int64_t p = 0; p < valid_length; p++) {
+        sum += static_cast<int64_t>(row_cache[p * kHeadSize]);
+      }
+      logits[(b * sequence_length + sequence_length - 1) * kVocabSize + sum % kVocabSize] = 1.0f;
+    }
+
+    ++num_runs;
+    max_batch_size = std::max(max_batch_size, batch_size);
+    return Status::OK();
+  }
+
+  // The tokens the model generates for a prompt on its own.
+  static std::vector<int32_t> Generate(std::vector<int32_t> sequence, int max_new_tokens, int eos_token_id,
+                                       int max_length) {
+    std::vector<int32_t> tokens;
+    while (static_cast<int>(tokens.size()) < max_new_tokens) {
+      const int64_t sum = std::accumulate(sequence.begin(), sequence.end(), int64_t{0});
+      const int32_t token = static_cast<int32_t>(sum % kVocabSize);
+      tokens.push_back(token);
+      sequence.push_back(token);
+      if (token == eos_token_id || static_cast<int>(sequence.size()) >= max_length) {
+        break;
+      }
+    }
+    return tokens;
+  }
+
+  std::vector<std::unique_ptr<NodeArg>> node_args;
+  std::vector<const NodeArg*> inputs;
+  std::vector<const NodeArg*> outputs;
+  AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+  int num_runs = 0;
+  int64_t max_batch_size = 0;
+};
+
+std::unique_ptr<ContinuousBatcher> CreateBatcher(FakeModel& model, int max_slots, int max_length,
+                                                 int eos_token_id) {
+  ContinuousBatchingParameters parameters;
+  parameters.max_slots = max_slots;
+  parameters.max_length = max_length;
+  parameters.eos_token_id = eos_token_id;
+
+  std::unique_ptr<ContinuousBatcher> batcher;
+  auto status = ContinuousBatcher::Create(
+      parameters, model.inputs, model.outputs,
+      [&model](gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+               gsl::span<const std::string> fetch_names, std::vector<OrtValue>& fetches) {
+        return model.Run(feed_names, feeds, fetch_names, fetches);
+      },
+      model.allocator, batcher);
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+  return batcher;
+}
+
+}  // namespace
+
+TEST(ContinuousBatcherTest, RequestsJoinAndLeaveSlots) {
+  constexpr int max_slots = 2;
+  constexpr int max_length = 16;
+  constexpr int eos_token_id = -1;
+  FakeModel model;
+  auto batcher = CreateBatcher(model, max_slots, max_length, eos_token_id);
+  ASSERT_NE(batcher, nullptr);
+
+  const std::vector<std::vector<int32_t>> prompts = {{3, 1, 4}, {1, 5}, {9, 2, 6, 5}, {3}};
+  const std::vector<int> max_new_tokens = {2, 6, 4, 20};
+  std::vector<int64_t> request_ids(prompts.size());
+  for (size_t i = 0; i < prompts.size(); i++) {
+    ASSERT_TRUE(batcher->Enqueue(prompts[i], max_new_tokens[i], request_ids[i]).IsOK());
+  }
+  EXPECT_EQ(batcher->NumRequests(), prompts.size());
+
+  std::map<int64_t, std::vector<int32_t>> generated;
+  std::map<int64_t, int> finished_count;
+  std::vector<ContinuousBatchingToken> tokens;
+  int steps = 0;
+  while (batcher->NumRequests() > 0) {
+    ASSERT_TRUE(batcher->Step(tokens).IsOK());
+    ASSERT_LE(tokens.size(), static_cast<size_t>(max_slots));
+    for (const auto& token : tokens) {
+      ASSERT_EQ(finished_count[token.request_id], 0) << "token after the end of request " << token.request_id;
+      generated[token.request_id].push_back(token.token);
+      finished_count[token.request_id] += token.finished ? 1 : 0;
+    }
+    ASSERT_LT(++steps, 100);
+  }
+
+  for (size_t i = 0; i < prompts.size(); i++) {
+    EXPECT_EQ(generated[request_ids[i]], FakeModel::Generate(prompts[i], max_new_tokens[i], eos_token_id, max_length))
+        << "request " << i;
+    EXPECT_EQ(finished_count[request_ids[i]], 1);
+  }
+  EXPECT_LE(model.max_batch_size, max_slots);
+
+  // The third request joins the slot of the first one in the step after it finishes, the third step.
+  EXPECT_LT(steps, 3 + 20);
+}
+
+TEST(ContinuousBatcherTest, SlotSequence) {
+  FakeModel model(false);
+  auto batcher = CreateBatcher(model, 3, 8, -1);
+  ASSERT_NE(batcher, nullptr);
+
+  int64_t request_id = 0;
+  const std::vector<int32_t> prompt = {2, 7};
+  ASSERT_TRUE(batcher->Enqueue(prompt, 10, request_id).IsOK());
+
+  std::vector<ContinuousBatchingToken> tokens;
+  ASSERT_TRUE(batcher->Step(tokens).IsOK());
+  ASSERT_EQ(tokens.size(), 1u);
+  ASSERT_TRUE(batcher->Step(tokens).IsOK());
+  ASSERT_EQ(tokens.size(), 1u);
+
+  auto sequence = batcher->GetSlotSequence(0);
+  const auto expected = FakeModel::Generate(prompt, 2, -1, 8);
+  ASSERT_EQ(sequence.size(), 4u);
+  EXPECT_EQ(sequence[0], 2);
+  EXPECT_EQ(sequence[1], 7);
+  EXPECT_EQ(sequence[2], expected[0]);
+  EXPECT_EQ(sequence[3], expected[1]);
+  EXPECT_TRUE(batcher->GetSlotSequence(1).empty());
+
+  // The sequence stops at max_length.
+  while (batcher->NumRequests() > 0) {
+    ASSERT_TRUE(batcher->Step(tokens).IsOK());
+  }
+  ASSERT_EQ(tokens.size(), 1u);
+  EXPECT_TRUE(tokens[0].finished);
+  EXPECT_TRUE(batcher->GetSlotSequence(0).empty());
+}
+
+TEST(ContinuousBatcherTest, EosToken) {
+  const std::vector<int32_t> prompt = {4, 4};
+  // The first generated token is 8, the second one 16 % 11 = 5.
+  constexpr int eos_token_id = 5;
+  FakeModel model;
+  auto batcher = CreateBatcher(model, 2, 16, eos_token_id);
+  ASSERT_NE(batcher, nullptr);
+
+  int64_t request_id = 0;
+  ASSERT_TRUE(batcher->Enqueue(prompt, 10, request_id).IsOK());
+
+  std::vector<int32_t> generated;
+  std::vector<ContinuousBatchingToken> tokens;
+  while (batcher->NumRequests() > 0) {
+    ASSERT_TRUE(batcher->Step(tokens).IsOK());
+    for (const auto& token : tokens) {
+      generated.push_back(token.token);
+    }
+  }
+  EXPECT_EQ(generated, (std::vector<int32_t>{8, eos_token_id}));
+  EXPECT_TRUE(tokens.back().finished);
+}
+
+TEST(ContinuousBatcherTest, Cancel) {
+  FakeModel model;
+  auto batcher = CreateBatcher(model, 1, 32, -1);
+  ASSERT_NE(batcher, nullptr);
+
+  const std::vector<int32_t> prompt = {1, 2, 3};
+  int64_t first = 0, second = 0, third = 0;
+  ASSERT_TRUE(batcher->Enqueue(prompt, 20, first).IsOK());
+  ASSERT_TRUE(batcher->Enqueue(prompt, 20, second).IsOK());
+  ASSERT_TRUE(batcher->Enqueue(prompt, 3, third).IsOK());
+  EXPECT_EQ(batcher->NumRequests(), 3u);
+
+  std::vector<ContinuousBatchingToken> tokens;
+  ASSERT_TRUE(batcher->Step(tokens).IsOK());
+  ASSERT_EQ(tokens.size(), 1u);
+  EXPECT_EQ(tokens[0].request_id, first);
+
+  // A queued request is removed at once, an active one frees its slot at the next step.
+  batcher->Cancel(second);
+  EXPECT_EQ(batcher->NumRequests(), 2u);
+  batcher->Cancel(first);
+  ASSERT_TRUE(batcher->Step(tokens).IsOK());
+  ASSERT_EQ(tokens.size(), 1u);
+  EXPECT_EQ(tokens[0].request_id, third);
+
+  std::vector<int32_t> generated = {tokens[0].token};
+  while (batcher->NumRequests() > 0) {
+    ASSERT_TRUE(batcher->Step(tokens).IsOK());
+    for (const auto& token : tokens) {
+      EXPECT_EQ(token.request_id, third);
+      generated.push_back(token.token);
+    }
+  }
+  EXPECT_EQ(generated, FakeModel::Generate(prompt, 3, -1, 32));
+}
+
+TEST(ContinuousBatcherTest, InvalidArguments) {
+  FakeModel model;
+  auto batcher = CreateBatcher(model, 2, 4, -1);
+  ASSERT_NE(batcher, nullptr);
+
+  int64_t request_id = 0;
+  EXPECT_FALSE(batcher->Enqueue(std::vector<int32_t>{}, 1, request_id).IsOK());
+  EXPECT_FALSE(batcher->Enqueue(std::vector<int32_t>{1, 2, 3, 4}, 1, request_id).IsOK());
+  EXPECT_FALSE(batcher->Enqueue(std::vector<int32_t>{1}, 0, request_id).IsOK());
+
+  // The model needs an attention mask.
+  FakeModel no_mask_model;
+  no_mask_model.inputs.erase(no_mask_model.inputs.begin() + 1);
+  ContinuousBatchingParameters parameters;
+  parameters.max_slots = 2;
+  parameters.max_length = 4;
+  std::unique_ptr<ContinuousBatcher> invalid;
+  auto run_fn = [](gsl::span<const std::string>, gsl::span<const OrtValue>, gsl::span<const std::string>,
+                   std::vector<OrtValue>&) { return Status::OK(); };
+  EXPECT_FALSE(ContinuousBatcher::Create(parameters, no_mask_model.inputs, no_mask_model.outputs, run_fn,
+                                         no_mask_model.allocator, invalid)
+                   .IsOK());
+
+  parameters.max_slots = 0;
+  EXPECT_FALSE(ContinuousBatcher::Create(parameters, model.inputs, model.outputs, run_fn, model.allocator, invalid)
+                   .IsOK());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
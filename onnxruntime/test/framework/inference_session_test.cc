@@ -7,7 +7,9 @@
 #include <algorithm>
 #include <cfloat>
 #include <functional>
+#include <future>
 #include <iterator>
+#include <numeric>
 #include <thread>
 #include <fstream>
 
@@ -18,6 +20,7 @@
 #include "core/common/profiler.h"
 #include "core/framework/compute_capability.h"
 #include "core/framework/data_transfer_manager.h"
+#include "core/framework/error_code_helper.h"
 #include "core/framework/execution_provider.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/op_kernel.h"
@@ -48,6 +51,7 @@
 #include "core/session/inference_session_utils.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/session/onnxruntime_run_options_config_keys.h"
+#include "core/session/ort_apis.h"
 #include "dummy_provider.h"
 #include "test_utils.h"
 #include "test/capturing_sink.h"
@@ -56,6 +60,7 @@
 #include "test/optimizer/dummy_graph_transformer.h"
 #include "test/util/include/default_providers.h"
 #include "test/util/include/inference_session_wrapper.h"
+#include "test/util/include/temp_dir.h"
 
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
@@ -3036,5 +3041,306 @@ TEST(InferenceSessionTests, InterThreadPoolWithDenormalAsZero) {
 }
 #endif
 
+
+namespace {
+struct DynamicBatchingRequest {
+  std::vector<float> input;
+  OrtValue input_value;
+  const OrtValue* feeds[1];
+  OrtValue* fetches[1] = {nullptr};
+  std::vector<int64_t> output_dims;
+  std::vector<float> output;
+  Status status;
+  std::promise<void> done;
+};
+
+void DynamicBatchingCallback(void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatusPtr status_ptr) {
+  auto* request = static_cast<DynamicBatchingRequest*>(user_data);
+  if (status_ptr != nullptr) {
+    request->status = ToStatus(status_ptr);
+    OrtApis::ReleaseStatus(status_ptr);
+  } else if (num_outputs == 1) {
+    std::unique_ptr<OrtValue> output(outputs[0]);
+    const auto& tensor = output->Get<Tensor>();
+    const auto dims = tensor.Shape().GetDims();
+    request->output_dims.assign(dims.begin(), dims.end());
+    request->output.assign(tensor.Data<float>().begin(), tensor.Data<float>().end());
+  }
+
+  request->done.set_value();
+}
+}  // namespace
+
+TEST(InferenceSessionTests, DynamicBatchingRunAsync) {
+  SessionOptions so;
+  so.session_logid = "DynamicBatchingRunAsync";
+  so.intra_op_param.thread_pool_size = 2;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsDynamicBatchingMaxBatchSize, "4"));
+  // long enough for the batch to be completed by the maximum batch size instead of the delay
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsDynamicBatchingMaxQueueDelayUs, "10000000"));
+
+  InferenceSession session_object{so, GetEnvironment()};
+  // input 'x' and output 'y' have the shape {Dim1, Dim2, 5}
+  ASSERT_STATUS_OK(session_object.Load(ORT_TSTR("testdata/abs_free_dimensions.onnx")));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  auto allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  const std::vector<int64_t> num_rows = {1, 3};
+  std::vector<std::unique_ptr<DynamicBatchingRequest>> requests;
+  for (size_t r = 0; r < num_rows.size(); ++r) {
+    auto request = std::make_unique<DynamicBatchingRequest>();
+    const std::vector<int64_t> dims = {num_rows[r], 2, 5};
+    for (int64_t i = 0; i < num_rows[r] * 10; ++i) {
+      request->input.push_back(-static_cast<float>(r * 100 + i));
+    }
+
+    CreateMLValue<float>(allocator, dims, request->input, &request->input_value);
+    request->feeds[0] = &request->input_value;
+    requests.push_back(std::move(request));
+  }
+
+  const char* feed_names[] = {"x"};
+  const char* fetch_names[] = {"y"};
+  for (auto& request : requests) {
+    ASSERT_STATUS_OK(session_object.RunAsync(nullptr, feed_names, request->feeds, fetch_names, request->fetches,
+                                             DynamicBatchingCallback, request.get()));
+  }
+
+  for (size_t r = 0; r < requests.size(); ++r) {
+    auto& request = *requests[r];
+    ASSERT_EQ(request.done.get_future().wait_for(std::chrono::seconds(30)), std::future_status::ready);
+    ASSERT_STATUS_OK(request.status);
+    EXPECT_EQ(request.output_dims, (std::vector<int64_t>{num_rows[r], 2, 5}));
+    ASSERT_EQ(request.output.size(), request.input.size());
+    for (size_t i = 0; i < request.input.size(); ++i) {
+      EXPECT_EQ(request.output[i], -request.input[i]);
+    }
+  }
+
+  DynamicBatchingStats stats;
+  ASSERT_STATUS_OK(session_object.GetDynamicBatchingStats(stats));
+  EXPECT_EQ(stats.num_requests, 2);
+  EXPECT_EQ(stats.num_batches, 1);
+  EXPECT_EQ(stats.num_unbatched_requests, 0);
+  ASSERT_EQ(stats.batch_size_histogram.size(), 5u);
+  EXPECT_EQ(stats.batch_size_histogram[4], 1);
+}
+
+// The output of ReduceSum over all axes doesn't have the batch axis, so the requests are run on their own.
+TEST(InferenceSessionTests, DynamicBatchingUnsplittableOutput) {
+  onnxruntime::Model model("unsplittable_output", false, ModelMetaData(), PathString(),
+                           IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 13}}, {},
+                           DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto x_type;
+  x_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("N");
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  ONNX_NAMESPACE::TypeProto y_type;
+  y_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+
+  auto& x = graph.GetOrCreateNodeArg("x", &x_type);
+  auto& y = graph.GetOrCreateNodeArg("y", &y_type);
+  auto& reduce = graph.AddNode("reduce", "ReduceSum", "", {&x}, {&y});
+  reduce.AddAttribute("keepdims", static_cast<int64_t>(0));
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  SessionOptions so;
+  so.session_logid = "DynamicBatchingUnsplittableOutput";
+  so.intra_op_param.thread_pool_size = 2;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsDynamicBatchingMaxBatchSize, "4"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsDynamicBatchingMaxQueueDelayUs, "10000000"));
+  InferenceSession session_object{so, GetEnvironment()};
+
+  std::string model_bytes;
+  model.ToProto().SerializeToString(&model_bytes);
+  std::stringstream model_stream(model_bytes);
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  auto allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  const std::vector<int64_t> num_rows = {1, 3};
+  std::vector<std::unique_ptr<DynamicBatchingRequest>> requests;
+  for (size_t r = 0; r < num_rows.size(); ++r) {
+    auto request = std::make_unique<DynamicBatchingRequest>();
+    for (int64_t i = 0; i < num_rows[r] * 2; ++i) {
+      request->input.push_back(static_cast<float>(r * 100 + i));
+    }
+
+    CreateMLValue<float>(allocator, {num_rows[r], 2}, request->input, &request->input_value);
+    request->feeds[0] = &request->input_value;
+    requests.push_back(std::move(request));
+  }
+
+  const char* feed_names[] = {"x"};
+  const char* fetch_names[] = {"y"};
+  for (auto& request : requests) {
+    ASSERT_STATUS_OK(session_object.RunAsync(nullptr, feed_names, request->feeds, fetch_names, request->fetches,
+                                             DynamicBatchingCallback, request.get()));
+  }
+
+  for (auto& request : requests) {
+    ASSERT_EQ(request->done.get_future().wait_for(std::chrono::seconds(30)), std::future_status::ready);
+    ASSERT_STATUS_OK(request->status);
+    EXPECT_TRUE(request->output_dims.empty());
+    ASSERT_EQ(request->output.size(), 1u);
+    EXPECT_EQ(request->output[0], std::accumulate(request->input.begin(), request->input.end(), 0.0f));
+  }
+
+  int64_t num_requests = 0;
+  int64_t num_batches = 0;
+  int64_t num_unbatched_requests = 0;
+  std::vector<int64_t> batch_size_histogram(5, -1);
+  ASSERT_EQ(OrtApis::SessionGetDynamicBatchingStats(reinterpret_cast<const OrtSession*>(&session_object),
+                                                    &num_requests, &num_batches, &num_unbatched_requests,
+                                                    batch_size_histogram.data(), batch_size_histogram.size(),
+                                                    nullptr, 0),
+            nullptr);
+  EXPECT_EQ(num_requests, 2);
+  EXPECT_EQ(num_batches, 0);
+  EXPECT_EQ(num_unbatched_requests, 2);
+  EXPECT_EQ(batch_size_histogram, std::vector<int64_t>(5, 0));
+}
+
+TEST(InferenceSessionTests, EstimatePeakMemory) {
+  // x -> Abs -> a -> Abs -> b -> Abs -> y, with x of shape {N, 1024}
+  onnxruntime::Model model("peak_memory", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("N");
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1024);
+
+  auto& x = graph.GetOrCreateNodeArg("x", &float_tensor);
+  auto& a = graph.GetOrCreateNodeArg("a", &float_tensor);
+  auto& b = graph.GetOrCreateNodeArg("b", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("y", &float_tensor);
+  graph.AddNode("abs_0", "Abs", "", {&x}, {&a});
+  graph.AddNode("abs_1", "Abs", "", {&a}, {&b});
+  graph.AddNode("abs_2", "Abs", "", {&b}, {&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.EstimatePeakMemory";
+  // every value gets its own buffer
+  so.enable_mem_reuse = false;
+  InferenceSession session_object{so, GetEnvironment()};
+
+  std::string model_bytes;
+  model.ToProto().SerializeToString(&model_bytes);
+  std::stringstream model_stream(model_bytes);
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  PeakMemoryEstimate estimate;
+  auto status = session_object.EstimatePeakMemory({}, estimate);
+  ASSERT_FALSE(status.IsOK());
+  EXPECT_THAT(status.ErrorMessage(), testing::HasSubstr("No shape was given for graph input x"));
+
+  ASSERT_STATUS_OK(session_object.EstimatePeakMemory({{"x", TensorShape({8, 1024})}}, estimate, 2));
+  constexpr size_t kValueBytes = 8 * 1024 * sizeof(float);
+
+  // 'a' is released after abs_1 and 'b' after abs_2
+  ASSERT_EQ(estimate.nodes.size(), 3u);
+  EXPECT_EQ(estimate.nodes[0].node_name, "abs_0");
+  EXPECT_EQ(estimate.nodes[0].live_bytes, kValueBytes);
+  EXPECT_EQ(estimate.nodes[1].live_bytes, 2 * kValueBytes);
+  EXPECT_EQ(estimate.nodes[2].live_bytes, 2 * kValueBytes);
+
+  ASSERT_EQ(estimate.devices.size(), 1u);
+  EXPECT_EQ(estimate.devices[0].device.Type(), OrtDevice::CPU);
+  EXPECT_EQ(estimate.devices[0].initializer_bytes, 0u);
+  EXPECT_EQ(estimate.devices[0].peak_live_bytes, 2 * kValueBytes);
+  EXPECT_GE(estimate.devices[0].planned_peak_bytes, 2 * kValueBytes);
+
+  ASSERT_EQ(estimate.largest_values.size(), 2u);
+  EXPECT_EQ(estimate.largest_values[0].bytes, kValueBytes);
+  EXPECT_TRUE(estimate.unresolved_values.empty());
+}
+
+// A real kernel sets up more than its pre-packed buffers in PrePack(): MatMul needs the shape of B to run on the
+// pre-packed weight mapped from the cache file.
+TEST(InferenceSessionTests, PrePackedWeightsCacheFileWithMatMul) {
+  constexpr int64_t M = 2, K = 8, N = 16;
+
+  onnxruntime::Model model("prepacked_matmul", false, ModelMetaData(), PathString(),
+                           IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 13}}, {},
+                           DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto a_type;
+  a_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  a_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(M);
+  a_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(K);
+  ONNX_NAMESPACE::TypeProto b_type;
+  b_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  b_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(K);
+  b_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(N);
+  ONNX_NAMESPACE::TypeProto y_type;
+  y_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+
+  auto& a = graph.GetOrCreateNodeArg("a", &a_type);
+  auto& b = graph.GetOrCreateNodeArg("b", &b_type);
+  auto& y = graph.GetOrCreateNodeArg("y", &y_type);
+  graph.AddNode("matmul", "MatMul", "", {&a, &b}, {&y});
+
+  std::vector<float> a_values(M * K);
+  std::vector<float> b_values(K * N);
+  for (size_t i = 0; i < a_values.size(); ++i) {
+    a_values[i] = static_cast<float>(i % 5) - 2.f;
+  }
+  for (size_t i = 0; i < b_values.size(); ++i) {
+    b_values[i] = static_cast<float>(i % 7) * 0.5f + 1.f;
+  }
+  ONNX_NAMESPACE::TensorProto b_tensor;
+  b_tensor.set_name("b");
+  b_tensor.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  b_tensor.add_dims(K);
+  b_tensor.add_dims(N);
+  for (float value : b_values) {
+    b_tensor.add_float_data(value);
+  }
+  graph.AddInitializedTensor(b_tensor);
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  // the model is loaded from a file, so the pre-packed weight is looked up by the model path rather than its contents
+  TemporaryDirectory tmp_dir(ORT_TSTR("prepacked_weights_cache_file_matmul_test"));
+  const PathString model_file = tmp_dir.Path() + ORT_TSTR("/matmul.onnx");
+  const PathString cache_file = tmp_dir.Path() + ORT_TSTR("/prepacked_weights.bin");
+  ASSERT_STATUS_OK(Model::Save(model, model_file));
+
+  std::vector<float> expected_y(M * N, 0.f);
+  for (int64_t m = 0; m < M; ++m) {
+    for (int64_t n = 0; n < N; ++n) {
+      for (int64_t k = 0; k < K; ++k) {
+        expected_y[m * N + n] += a_values[m * K + k] * b_values[k * N + n];
+      }
+    }
+  }
+
+  // the first session writes the cache file, the second one uses the pre-packed weight mapped from it
+  for (size_t used_file_weights : {0u, 1u}) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.PrePackedWeightsCacheFileWithMatMul";
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsPrepackedWeightsCacheFile,
+                                                      PathToUTF8String(cache_file).c_str()));
+    InferenceSessionWrapper session_object{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(model_file));
+    ASSERT_STATUS_OK(session_object.Initialize());
+    ASSERT_EQ(session_object.GetSessionState().GetUsedFilePrePackedWeightCounter(), used_file_weights);
+
+    OrtValue a_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {M, K}, a_values, &a_value);
+    NameMLValMap feeds{{"a", a_value}};
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(RunOptions{}, feeds, {"y"}, &fetches));
+    ASSERT_EQ(fetches.size(), 1u);
+    VerifyOutputs(fetches[0].Get<Tensor>(), {M, N}, expected_y);
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
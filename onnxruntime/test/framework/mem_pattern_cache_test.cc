@@ -0,0 +1,128 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+
+#include "core/framework/allocator.h"
+#include "core/framework/mem_pattern_planner.h"
+#include "core/framework/tensor.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+OrtValue CreateInput(const std::vector<int64_t>& dims) {
+  static AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+  OrtValue value;
+  Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape(dims), allocator, value);
+  return value;
+}
+
+MemoryPatternCache::Entry CreateEntry(size_t peak_size) {
+  MemPatternPlanner planner{/*using_counters*/ false};
+  planner.TraceAllocation(0, peak_size);
+
+  MemoryPatternCache::Entry entry;
+  entry.patterns.locations.emplace_back();
+  entry.patterns.patterns.push_back(planner.GenerateMemPattern());
+  return entry;
+}
+}  // namespace
+
+TEST(MemoryPatternCacheTest, ExactShapes) {
+  MemoryPatternCache cache(/*capacity*/ 0, /*shape_bucket_size*/ 0);
+  EXPECT_FALSE(cache.UsesShapeBuckets());
+
+  std::vector<OrtValue> a{CreateInput({2, 3})};
+  std::vector<OrtValue> b{CreateInput({3, 2})};
+  std::vector<OrtValue> c{CreateInput({2, 3})};
+  EXPECT_NE(cache.CalculateKey(a), cache.CalculateKey(b));
+  EXPECT_EQ(cache.CalculateKey(a), cache.CalculateKey(c));
+
+  // the rank of each input is part of the key
+  std::vector<OrtValue> split{CreateInput({2}), CreateInput({3, 4})};
+  std::vector<OrtValue> merged{CreateInput({2, 3}), CreateInput({4})};
+  EXPECT_NE(cache.CalculateKey(split), cache.CalculateKey(merged));
+}
+
+TEST(MemoryPatternCacheTest, ShapeBuckets) {
+  MemoryPatternCache cache(/*capacity*/ 0, /*shape_bucket_size*/ 16);
+  EXPECT_TRUE(cache.UsesShapeBuckets());
+
+  std::vector<OrtValue> seq_17{CreateInput({1, 17})};
+  std::vector<OrtValue> seq_32{CreateInput({1, 32})};
+  std::vector<OrtValue> seq_33{CreateInput({1, 33})};
+  EXPECT_EQ(cache.CalculateKey(seq_17), cache.CalculateKey(seq_32));
+  EXPECT_NE(cache.CalculateKey(seq_32), cache.CalculateKey(seq_33));
+
+  bool needs_replan = true;
+  EXPECT_EQ(cache.Find(cache.CalculateKey(seq_17), needs_replan), nullptr);
+  EXPECT_FALSE(needs_replan);
+  cache.Insert(cache.CalculateKey(seq_17), CreateEntry(1024));
+
+  auto entry = cache.Find(cache.CalculateKey(seq_32), needs_replan);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_FALSE(needs_replan);
+  EXPECT_EQ(entry->patterns.patterns[0].PeakSize(), 1024u);
+
+  const auto stats = cache.GetStats();
+  EXPECT_EQ(stats.num_hits, 1);
+  EXPECT_EQ(stats.num_misses, 1);
+  EXPECT_EQ(stats.num_entries, 1u);
+}
+
+TEST(MemoryPatternCacheTest, LruEviction) {
+  MemoryPatternCache cache(/*capacity*/ 2, /*shape_bucket_size*/ 0);
+  bool needs_replan = false;
+
+  cache.Insert(1, CreateEntry(64));
+  cache.Insert(2, CreateEntry(128));
+
+  // use 1 so that 2 is the least recently used entry
+  auto entry_1 = cache.Find(1, needs_replan);
+  ASSERT_NE(entry_1, nullptr);
+  auto entry_2 = cache.Find(2, needs_replan);
+  ASSERT_NE(entry_2, nullptr);
+  ASSERT_NE(cache.Find(1, needs_replan), nullptr);
+
+  cache.Insert(3, CreateEntry(256));
+  EXPECT_NE(cache.Find(1, needs_replan), nullptr);
+  EXPECT_EQ(cache.Find(2, needs_replan), nullptr);
+  EXPECT_NE(cache.Find(3, needs_replan), nullptr);
+
+  // an evicted entry stays valid while it is in use
+  EXPECT_EQ(entry_2->patterns.patterns[0].PeakSize(), 128u);
+
+  const auto stats = cache.GetStats();
+  EXPECT_EQ(stats.num_evictions, 1);
+  EXPECT_EQ(stats.num_entries, 2u);
+}
+
+TEST(MemoryPatternCacheTest, Replan) {
+  MemoryPatternCache cache(/*capacity*/ 0, /*shape_bucket_size*/ 8);
+  bool needs_replan = false;
+
+  cache.Insert(1, CreateEntry(64));
+
+  // an existing entry is not replaced unless it was marked for re-planning
+  cache.Insert(1, CreateEntry(128));
+  auto entry = cache.Find(1, needs_replan);
+  EXPECT_FALSE(needs_replan);
+  EXPECT_EQ(entry->patterns.patterns[0].PeakSize(), 64u);
+
+  cache.MarkForReplan(1);
+  entry = cache.Find(1, needs_replan);
+  EXPECT_TRUE(needs_replan);
+  EXPECT_EQ(entry->patterns.patterns[0].PeakSize(), 64u);
+
+  auto replanned = cache.Insert(1, CreateEntry(128));
+  EXPECT_EQ(replanned->patterns.patterns[0].PeakSize(), 128u);
+  entry = cache.Find(1, needs_replan);
+  EXPECT_FALSE(needs_replan);
+  EXPECT_EQ(entry, replanned);
+  EXPECT_EQ(cache.GetStats().num_replans, 1);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
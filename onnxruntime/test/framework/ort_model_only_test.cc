@@ -9,6 +9,7 @@
 #include "core/graph/onnx_protobuf.h"
 #include "core/session/onnxruntime_cxx_api.h"
 #include "core/session/inference_session.h"
+#include "core/session/mapped_ort_model_file.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test_utils.h"
 #include "test/common/tensor_op_test_utils.h"
@@ -557,6 +558,33 @@ TEST(OrtModelOnlyTests, LoadOrtFormatModelFromBufferNoCopyInitializersUseBuffer)
   RunOrtModel(test_info);
 }
 
+// Map the model file into memory and use the mapped bytes for the initializers
+TEST(OrtModelOnlyTests, LoadOrtFormatModelMapped) {
+  OrtModelTestInfo test_info = GetTestInfoForLoadOrtFormatModel();
+  test_info.configs.push_back(std::make_pair(kOrtSessionOptionsConfigMapORTModelFile, "1"));
+  RunOrtModel(test_info);
+}
+
+// The sessions loading the same file share its mapping while any of them holds it
+TEST(OrtModelOnlyTests, MappedOrtModelFileIsShared) {
+  const PathString model_filename = ORT_TSTR("testdata/ort_github_issue_4031.onnx.ort");
+
+  std::shared_ptr<const MappedOrtModelFile> mapped_file_1;
+  ASSERT_STATUS_OK(MappedOrtModelFile::Get(model_filename, mapped_file_1));
+  std::shared_ptr<const MappedOrtModelFile> mapped_file_2;
+  ASSERT_STATUS_OK(MappedOrtModelFile::Get(ORT_TSTR("./") + model_filename, mapped_file_2));
+  ASSERT_EQ(mapped_file_1, mapped_file_2);
+
+  size_t num_bytes = 0;
+  ASSERT_STATUS_OK(Env::Default().GetFileLength(model_filename.c_str(), num_bytes));
+  ASSERT_EQ(mapped_file_1->Bytes().size(), num_bytes);
+
+  OrtModelTestInfo test_info = GetTestInfoForLoadOrtFormatModel();
+  test_info.configs.push_back(std::make_pair(kOrtSessionOptionsConfigMapORTModelFile, "1"));
+  RunOrtModel(test_info);
+  ASSERT_EQ(mapped_file_1.use_count(), 2);
+}
+
 // regression test for 2 issues covered by PR #17000 (internally reported issue).
 // 1) allocation planner broke in minimal build when subgraph had no nodes.
 // 2) usage of a sequence data type caused an exception due to IsSparseTensor() throwing
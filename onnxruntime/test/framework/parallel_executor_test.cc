@@ -1,9 +1,18 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
 #include "core/framework/data_types.h"
 #include "core/framework/op_kernel.h"
+#include "core/graph/model.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+#include "test/util/include/inference_session_wrapper.h"
 #include "test_utils.h"
 #include "core/session/inference_session.h"
 
@@ -143,6 +152,202 @@ TEST_P(ParallelExecutorThreadPoolTest, TestNullInterOpThreadPool) {
   tester.Run(so, OpTester::ExpectResult::kExpectSuccess, {}, {kTensorrtExecutionProvider}, nullptr, nullptr);
 }
 
+// test that the status from TestOp is correctly returned when the nodes are run by the work stealing executor
+TEST(ParallelExecutor, WorkStealingStatusPropagation) {
+  auto registry = std::make_shared<CustomRegistry>();
+  std::vector<OpSchema> schemas{TestOp::OpSchema()};
+  Status status;
+  ASSERT_TRUE((status = registry->RegisterOpSet(schemas, TestOp::OpDomain, 10, 11)).IsOK()) << status;
+  KernelCreateFn kernel_create_fn = [](FuncManager&, const OpKernelInfo& info, std::unique_ptr<OpKernel>& out) { out = std::make_unique<typename TestOp::OpKernelImpl>(info); return Status::OK(); };
+  auto kernel_def = TestOp::KernelDef();
+  ASSERT_TRUE((status = registry->RegisterCustomKernel(kernel_def, kernel_create_fn)).IsOK()) << status;
+
+  onnxruntime::SessionOptions so;
+  so.session_logid = "WorkStealingStatusPropagation";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  so.intra_op_param.thread_pool_size = 4;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigUseWorkStealingExecutor, "1"));
+
+  for (int64_t action : {0, 1, 2}) {
+    OpTester tester{"TestOp", 10, TestOp::OpDomain};
+    tester.AddCustomOpRegistry(registry);
+
+    tester.AddInput<int64_t>("action", {1}, {action});
+    tester.AddOutput<int64_t>("action_out", {1}, {0});
+    if (action == 0) {
+      tester.Run(so, OpTester::ExpectResult::kExpectSuccess, {}, {kTensorrtExecutionProvider}, nullptr, nullptr);
+    } else {
+      tester.Run(so, OpTester::ExpectResult::kExpectFailure, action == 1 ? "Action was 1" : "Throwing as action was 2",
+                 {kTensorrtExecutionProvider}, nullptr, nullptr);
+    }
+  }
+}
+
+// X -> Relu -> Neg -> Abs -> Sum -> Y
+// X -> Neg -------------------^
+TEST(ParallelExecutor, WorkStealingExecutionPlan) {
+  onnxruntime::Model model("test", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& x = graph.GetOrCreateNodeArg("X", &tensor_float);
+  auto& relu_out = graph.GetOrCreateNodeArg("relu_out", &tensor_float);
+  auto& neg_out = graph.GetOrCreateNodeArg("neg_out", &tensor_float);
+  auto& abs_out = graph.GetOrCreateNodeArg("abs_out", &tensor_float);
+  auto& short_out = graph.GetOrCreateNodeArg("short_out", &tensor_float);
+  auto& y = graph.GetOrCreateNodeArg("Y", &tensor_float);
+  graph.AddNode("relu", "Relu", "", {&x}, {&relu_out});
+  graph.AddNode("neg", "Neg", "", {&relu_out}, {&neg_out});
+  graph.AddNode("abs", "Abs", "", {&neg_out}, {&abs_out});
+  graph.AddNode("short", "Neg", "", {&x}, {&short_out});
+  graph.AddNode("sum", "Sum", "", {&abs_out, &short_out}, {&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  SessionOptions so;
+  so.session_logid = "WorkStealingExecutionPlan";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  so.graph_optimization_level = TransformerLevel::Default;
+  so.intra_op_param.thread_pool_size = 4;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigUseWorkStealingExecutor, "1"));
+  InferenceSessionWrapper session{so, GetEnvironment()};
+
+  std::string model_str;
+  model.ToProto().SerializeToString(&model_str);
+  std::stringstream model_stream(model_str);
+  ASSERT_STATUS_OK(session.Load(model_stream));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  const auto* plan = session.GetSessionState().GetWorkStealingExecutionPlan();
+  ASSERT_NE(plan, nullptr);
+  const auto& session_graph = session.GetSessionState().GetGraphViewer();
+  auto node_index = [&session_graph](const std::string& name) {
+    for (const auto& node : session_graph.Nodes()) {
+      if (node.Name() == name) {
+        return node.Index();
+      }
+    }
+
+    return std::numeric_limits<NodeIndex>::max();
+  };
+
+  EXPECT_EQ(plan->num_nodes, 5u);
+  // the root on the longer branch comes first
+  ASSERT_EQ(plan->root_nodes.size(), 2u);
+  EXPECT_EQ(plan->root_nodes[0], node_index("relu"));
+  EXPECT_EQ(plan->root_nodes[1], node_index("short"));
+  EXPECT_EQ(plan->priority[node_index("relu")], 4u);
+  EXPECT_EQ(plan->priority[node_index("short")], 2u);
+  EXPECT_EQ(plan->num_dependencies[node_index("sum")], 2);
+
+  std::vector<float> x_values{-2.f, -1.f, 0.f, 1.f, 2.f, 3.f};
+  OrtValue x_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {2, 3}, x_values, &x_value);
+  NameMLValMap feeds{{"X", x_value}};
+  std::vector<std::string> output_names{"Y"};
+
+  for (int i = 0; i < 10; ++i) {
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session.Run(RunOptions{}, feeds, output_names, &fetches));
+    ASSERT_EQ(fetches.size(), 1u);
+    auto y_values = fetches[0].Get<Tensor>().DataAsSpan<float>();
+    ASSERT_EQ(y_values.size(), x_values.size());
+    for (size_t j = 0; j < x_values.size(); ++j) {
+      // |-relu(x)| - x
+      EXPECT_EQ(y_values[j], std::max(x_values[j], 0.f) - x_values[j]);
+    }
+  }
+}
+
+// X -> Relu -> Reshape -> Neg -> Y
+//        \---> Abs --------------> Z
+// the output of Reshape aliases the output of Relu, whose buffer is released once Reshape, Neg and Abs are done
+TEST(ParallelExecutor, WorkStealingExecutionPlanWithAlias) {
+  onnxruntime::Model model("test", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 14}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  TypeProto tensor_int64;
+  tensor_int64.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  auto& x = graph.GetOrCreateNodeArg("X", &tensor_float);
+  auto& shape = graph.GetOrCreateNodeArg("shape", &tensor_int64);
+  auto& relu_out = graph.GetOrCreateNodeArg("relu_out", &tensor_float);
+  auto& reshape_out = graph.GetOrCreateNodeArg("reshape_out", &tensor_float);
+  auto& y = graph.GetOrCreateNodeArg("Y", &tensor_float);
+  auto& z = graph.GetOrCreateNodeArg("Z", &tensor_float);
+  graph.AddNode("relu", "Relu", "", {&x}, {&relu_out});
+  graph.AddNode("reshape", "Reshape", "", {&relu_out, &shape}, {&reshape_out});
+  graph.AddNode("neg", "Neg", "", {&reshape_out}, {&y});
+  graph.AddNode("abs", "Abs", "", {&relu_out}, {&z});
+
+  ONNX_NAMESPACE::TensorProto shape_tensor;
+  shape_tensor.add_dims(1);
+  shape_tensor.add_int64_data(-1);
+  shape_tensor.set_data_type(TensorProto_DataType_INT64);
+  shape_tensor.set_name("shape");
+  graph.AddInitializedTensor(shape_tensor);
+  graph.SetInputs({&x});
+  graph.SetOutputs({&y, &z});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  SessionOptions so;
+  so.session_logid = "WorkStealingExecutionPlanWithAlias";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  so.graph_optimization_level = TransformerLevel::Default;
+  so.intra_op_param.thread_pool_size = 4;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigUseWorkStealingExecutor, "1"));
+  InferenceSessionWrapper session{so, GetEnvironment()};
+
+  std::string model_str;
+  model.ToProto().SerializeToString(&model_str);
+  std::stringstream model_stream(model_str);
+  ASSERT_STATUS_OK(session.Load(model_stream));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  const auto& session_state = session.GetSessionState();
+  const auto* plan = session_state.GetWorkStealingExecutionPlan();
+  ASSERT_NE(plan, nullptr);
+
+  int relu_out_idx;
+  int reshape_out_idx;
+  ASSERT_STATUS_OK(session_state.GetOrtValueNameIdxMap().GetIdx("relu_out", relu_out_idx));
+  ASSERT_STATUS_OK(session_state.GetOrtValueNameIdxMap().GetIdx("reshape_out", reshape_out_idx));
+  const auto& execution_plan = *session_state.GetExecutionPlan();
+  ASSERT_EQ(execution_plan.allocation_plan[reshape_out_idx].alloc_kind, AllocKind::kReuse);
+  EXPECT_EQ(execution_plan.allocation_plan[reshape_out_idx].reused_buffer, relu_out_idx);
+
+  const auto& release_actions = execution_plan.release_actions;
+  auto action = std::find_if(release_actions.begin(), release_actions.end(),
+                             [relu_out_idx](const SequentialExecutionPlan::ReleaseAction& release_action) {
+                               return release_action.value_index == static_cast<size_t>(relu_out_idx);
+                             });
+  ASSERT_NE(action, release_actions.end());
+  const size_t action_idx = static_cast<size_t>(action - release_actions.begin());
+  EXPECT_EQ(plan->release_ref_counts[action_idx], 3);
+
+  std::vector<float> x_values{-2.f, -1.f, 0.f, 1.f, 2.f, 3.f};
+  OrtValue x_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {2, 3}, x_values, &x_value);
+  NameMLValMap feeds{{"X", x_value}};
+  std::vector<std::string> output_names{"Y", "Z"};
+
+  for (int i = 0; i < 10; ++i) {
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session.Run(RunOptions{}, feeds, output_names, &fetches));
+    ASSERT_EQ(fetches.size(), 2u);
+    EXPECT_EQ(fetches[0].Get<Tensor>().Shape(), TensorShape({6}));
+    auto y_values = fetches[0].Get<Tensor>().DataAsSpan<float>();
+    auto z_values = fetches[1].Get<Tensor>().DataAsSpan<float>();
+    ASSERT_EQ(y_values.size(), x_values.size());
+    ASSERT_EQ(z_values.size(), x_values.size());
+    for (size_t j = 0; j < x_values.size(); ++j) {
+      EXPECT_EQ(y_values[j], -std::max(x_values[j], 0.f));
+      EXPECT_EQ(z_values[j], std::max(x_values[j], 0.f));
+    }
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(ParallelExecutorThreadPoolTests, ParallelExecutorThreadPoolTest,
                          testing::Values(1, 0));
 }  // namespace test
@@ -22,6 +22,7 @@
 #include "gtest/gtest.h"
 #include "test/test_environment.h"
 #include "test/util/include/default_providers.h"
+#include "test/util/include/temp_dir.h"
 #include "core/optimizer/layout_transformation/layout_transformation.h"
 
 using namespace ONNX_NAMESPACE;
@@ -394,8 +395,19 @@ class PrePackingTestOpKernel : public OpKernel {
     return Status::OK();
   }
 
+  int GetPrePackFormatVersion(int /*input_idx*/) const override { return 1; }
+
+  Status RestorePrePackState(const Tensor& tensor, int input_idx) override {
+    ORT_UNUSED_PARAMETER(tensor);
+    ORT_UNUSED_PARAMETER(input_idx);
+
+    ++restore_pre_pack_state_calls_count;
+    return Status::OK();
+  }
+
   int prepack_calls_count = 0;
   int store_pre_packed_weight_calls_count = 0;
+  int restore_pre_pack_state_calls_count = 0;
   IAllocatorUniquePtr<void> weight_packed_;
 };
 
@@ -999,6 +1011,170 @@ TEST_F(SessionStateTestSharedInitalizersWithPrePacking, test4) {
   ASSERT_EQ(if_node_branches_shared_prepack_counter_2, static_cast<size_t>(2));
 }
 
+// Pre-packing enabled + pre-packed weights cache file = later sessions use the pre-packed weights from the file
+TEST_F(SessionStateTestSharedInitalizersWithPrePacking, PrePackedWeightsCacheFile) {
+  TemporaryDirectory tmp_dir(ORT_TSTR("prepacked_weights_cache_file_test"));
+  const PathString cache_file = tmp_dir.Path() + ORT_TSTR("/prepacked_weights.bin");
+
+  SessionOptions sess_options;
+  sess_options.enable_mem_pattern = true;
+  sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  sess_options.use_deterministic_compute = false;
+  sess_options.enable_mem_reuse = true;
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigDisablePrepacking] = "0";
+  sess_options.config_options.configurations[kOrtSessionOptionsPrepackedWeightsCacheFile] =
+      PathToUTF8String(cache_file);
+
+  auto create_session_state = [&](Model& model) {
+    CreateSimpleGraph(model.MainGraph());
+    PlaceAllNodesToCPUEP(model.MainGraph());
+    return std::make_unique<SessionState>(model.MainGraph(),
+                                          execution_providers,
+                                          tp.get(),
+                                          nullptr, /*inter_op_thread_pool*/
+                                          dtm,
+                                          edlm,
+                                          DefaultLoggingManager().DefaultLogger(),
+                                          profiler,
+                                          sess_options);
+  };
+
+  // First session/model - the weight is pre-packed and written to the file
+  Model model_1("graph_main", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                domain_to_version, std::vector<ONNX_NAMESPACE::FunctionProto>(),
+                DefaultLoggingManager().DefaultLogger());
+  auto session_state_1 = create_session_state(model_1);
+  ASSERT_STATUS_OK(session_state_1->FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                         kernel_registry_manager));
+
+  const auto* kernel = reinterpret_cast<const PrePackingTestOpKernel*>(session_state_1->GetKernel(0));
+  ASSERT_EQ(kernel->prepack_calls_count, 1);
+  ASSERT_EQ(kernel->store_pre_packed_weight_calls_count, 1);
+  ASSERT_EQ(kernel->restore_pre_pack_state_calls_count, 0);
+  ASSERT_EQ(session_state_1->GetUsedFilePrePackedWeightCounter(), static_cast<size_t>(0));
+
+  // Second session/model - the weight is mapped from the file and PrePack() is not called
+  Model model_2("graph_main", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                domain_to_version, std::vector<ONNX_NAMESPACE::FunctionProto>(),
+                DefaultLoggingManager().DefaultLogger());
+  auto session_state_2 = create_session_state(model_2);
+  ASSERT_STATUS_OK(session_state_2->FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                         kernel_registry_manager));
+
+  kernel = reinterpret_cast<const PrePackingTestOpKernel*>(session_state_2->GetKernel(0));
+  ASSERT_EQ(kernel->prepack_calls_count, 0);
+  ASSERT_EQ(kernel->store_pre_packed_weight_calls_count, 1);
+  ASSERT_EQ(kernel->restore_pre_pack_state_calls_count, 1);
+  ASSERT_EQ(session_state_2->GetUsedFilePrePackedWeightCounter(), static_cast<size_t>(1));
+  ASSERT_TRUE(session_state_2->GetConstantInitializedTensors().empty());
+
+  const float* packed = reinterpret_cast<const float*>(kernel->weight_packed_.get());
+  ASSERT_EQ(packed[0], 1.2345f);
+  ASSERT_EQ(packed[1], 1.2345f * 2.f);
+}
+
+// Pre-packing enabled + initializers shared across sessions = identical initializers and their pre-packed weights
+// are held once by the registry
+TEST_F(SessionStateTestSharedInitalizersWithPrePacking, ShareInitializersAcrossSessions) {
+  SessionOptions sess_options;
+  sess_options.enable_mem_pattern = true;
+  sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  sess_options.use_deterministic_compute = false;
+  sess_options.enable_mem_reuse = true;
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigDisablePrepacking] = "0";
+  sess_options.config_options.configurations[kOrtSessionOptionsShareInitializersAcrossSessions] = "1";
+
+  SharedInitializerRegistry registry;
+
+  // the initializers smaller than 1KB are not shared, so use a larger one than CreateSimpleGraph
+  auto create_session_state = [&](Model& model, float initializer_value) {
+    Graph& graph = model.MainGraph();
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(512);
+
+    auto& input_0_arg = graph.GetOrCreateNodeArg("node_0_input_0", &type);
+    auto& input_1_arg = graph.GetOrCreateNodeArg("node_0_input_1", &type);
+    auto& output_arg = graph.GetOrCreateNodeArg("node_0_output_0", &type);
+    graph.AddNode("node_0", "PrePackingTest", "node 0", {&input_0_arg, &input_1_arg}, {&output_arg});
+
+    ONNX_NAMESPACE::TensorProto tensor;
+    tensor.add_dims(512);
+    for (int i = 0; i < 512; ++i) {
+      tensor.add_float_data(initializer_value);
+    }
+    tensor.set_data_type(TensorProto_DataType_FLOAT);
+    tensor.set_name("node_0_input_1");
+    graph.AddInitializedTensor(tensor);
+    EXPECT_STATUS_OK(graph.Resolve());
+
+    PlaceAllNodesToCPUEP(graph);
+    return std::make_unique<SessionState>(graph,
+                                          execution_providers,
+                                          tp.get(),
+                                          nullptr, /*inter_op_thread_pool*/
+                                          dtm,
+                                          edlm,
+                                          DefaultLoggingManager().DefaultLogger(),
+                                          profiler,
+                                          sess_options,
+                                          nullptr, /*prepacked_weights_container*/
+                                          nullptr, /*parent_allocators*/
+                                          &registry);
+  };
+
+  auto create_model = [&]() {
+    return std::make_unique<Model>("graph_main", false, ModelMetaData(), PathString(),
+                                   IOnnxRuntimeOpSchemaRegistryList(), domain_to_version,
+                                   std::vector<ONNX_NAMESPACE::FunctionProto>(),
+                                   DefaultLoggingManager().DefaultLogger());
+  };
+
+  // First session/model - the initializer and its pre-packed weight are added to the registry
+  auto model_1 = create_model();
+  auto session_state_1 = create_session_state(*model_1, 1.f);
+  ASSERT_STATUS_OK(session_state_1->FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                         kernel_registry_manager));
+  ASSERT_EQ(session_state_1->GetUsedSharedPrePackedWeightCounter(), static_cast<size_t>(0));
+
+  auto stats = registry.GetStats();
+  ASSERT_EQ(stats.num_entries, static_cast<size_t>(1));
+  ASSERT_EQ(stats.num_bytes, static_cast<size_t>(512 * sizeof(float)));
+  ASSERT_EQ(stats.num_hits, static_cast<size_t>(0));
+
+  // Second session/model with the same initializer - it and its pre-packed weight are found in the registry
+  auto model_2 = create_model();
+  auto session_state_2 = create_session_state(*model_2, 1.f);
+  ASSERT_STATUS_OK(session_state_2->FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                         kernel_registry_manager));
+  ASSERT_EQ(session_state_2->GetUsedSharedPrePackedWeightCounter(), static_cast<size_t>(1));
+
+  const auto* kernel_1 = reinterpret_cast<const PrePackingTestOpKernel*>(session_state_1->GetKernel(0));
+  const auto* kernel_2 = reinterpret_cast<const PrePackingTestOpKernel*>(session_state_2->GetKernel(0));
+  ASSERT_EQ(kernel_2->store_pre_packed_weight_calls_count, 1);
+  ASSERT_EQ(kernel_1->weight_packed_.get(), kernel_2->weight_packed_.get());
+
+  stats = registry.GetStats();
+  ASSERT_EQ(stats.num_entries, static_cast<size_t>(1));
+  ASSERT_EQ(stats.num_hits, static_cast<size_t>(1));
+  ASSERT_EQ(stats.num_bytes_deduplicated, static_cast<size_t>(512 * sizeof(float)));
+
+  // Third session/model with a different initializer - it is added to the registry
+  auto model_3 = create_model();
+  auto session_state_3 = create_session_state(*model_3, 2.f);
+  ASSERT_STATUS_OK(session_state_3->FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                         kernel_registry_manager));
+  ASSERT_EQ(session_state_3->GetUsedSharedPrePackedWeightCounter(), static_cast<size_t>(0));
+  ASSERT_EQ(registry.GetStats().num_entries, static_cast<size_t>(2));
+
+  // the initializers are freed with the last session using them
+  session_state_1.reset();
+  ASSERT_EQ(registry.GetStats().num_entries, static_cast<size_t>(2));
+  session_state_2.reset();
+  session_state_3.reset();
+  ASSERT_EQ(registry.GetStats().num_entries, static_cast<size_t>(0));
+}
+
 INSTANTIATE_TEST_SUITE_P(SessionStateTests,
                          SessionStatePrepackingTest,
                          testing::Values(PrepackingTestParam{false, false},
@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+#include "core/platform/env.h"
+#include "core/util/thread_utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+static const std::vector<std::string> flashattn_bench_arg_names = {"B", "N", "S", "H"};
+
+void FLASHATTN(benchmark::State& state, MLAS_FLASH_ATTENTION_TYPE type, bool causal) {
+  if (state.range(0) <= 0) throw std::invalid_argument("B must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("S must greater than 0!");
+  if (state.range(3) <= 0) throw std::invalid_argument("H must greater than 0!");
+  const int batch_size = static_cast<int>(state.range(0));
+  const int num_heads = static_cast<int>(state.range(1));
+  const int sequence_length = static_cast<int>(state.range(2));
+  const int head_size = static_cast<int>(state.range(3));
+
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = 8;
+  tpo.auto_set_affinity = true;
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> tp(
+      onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                 tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP));
+
+  // The block sizes are chosen as in the MultiHeadAttention CPU kernel.
+  const int l2_cache_size = std::max(onnxruntime::Env::Default().GetL2CacheSize(), 256 * 1024);
+
+  MlasFlashAttentionThreadedArgs args;
+  args.batch_size = batch_size;
+  args.num_heads = num_heads;
+  args.q_sequence_length = sequence_length;
+  args.kv_sequence_length = sequence_length;
+  args.qk_head_size = head_size;
+  args.v_head_size = head_size;
+  args.kv_block_size = std::max(l2_cache_size / (static_cast<int>(sizeof(float)) * 4 * (2 * head_size)), 1);
+  args.q_block_size = std::min(std::min(args.kv_block_size, 2 * head_size), sequence_length);
+  args.kv_block_size = std::min(args.kv_block_size, sequence_length);
+  args.scale = 1.0f / std::sqrt(static_cast<float>(head_size));
+  args.thread_count = onnxruntime::concurrency::ThreadPool::DegreeOfParallelism(tp.get());
+  args.type = type;
+  args.is_causal = causal;
+  args.buffer_size_per_thread = MlasFlashAttentionGetBufferSizePerThread(
+      type, static_cast<size_t>(args.q_block_size), static_cast<size_t>(args.kv_block_size),
+      static_cast<size_t>(head_size), static_cast<size_t>(head_size));
+
+  const size_t element_count = static_cast<size_t>(batch_size) * num_heads * sequence_length * head_size;
+  const auto input = RandomVectorUniform(element_count, -1.0f, 1.0f);
+  std::vector<float> output(element_count);
+  std::vector<float> buffer(args.buffer_size_per_thread * args.thread_count / sizeof(float));
+  args.buffer = buffer.data();
+
+  // fp16 and bf16 inputs only need to be valid numbers, half of an fp32 value is one
+  std::vector<uint16_t> input16(element_count);
+  std::vector<uint16_t> output16(element_count);
+  for (size_t i = 0; i < element_count; i++) {
+    input16[i] = static_cast<uint16_t>(type == MlasFlashAttentionBFloat16 ? 0x3c00 + (i % 0x200)
+                                                                           : 0x3400 + (i % 0x400));
+  }
+
+  if (type == MlasFlashAttentionFloat16 || type == MlasFlashAttentionBFloat16) {
+    args.query = input16.data();
+    args.key = input16.data();
+    args.value = input16.data();
+    args.output = output16.data();
+  } else {
+    args.query = input.data();
+    args.key = input.data();
+    args.value = input.data();
+    args.output = output.data();
+  }
+
+  MlasFlashAttention(&args, tp.get());
+
+  for (auto _ : state) {
+    MlasFlashAttention(&args, tp.get());
+  }
+}
+
+static void FlashAttnSequenceLengths(benchmark::internal::Benchmark* b) {
+  b->ArgNames(flashattn_bench_arg_names);
+  b->ArgsProduct({{1}, {16}, {128, 512, 1024, 2048, 4096}, {64, 128}});
+}
+
+BENCHMARK_CAPTURE(FLASHATTN, FP32, MlasFlashAttentionFloat32, false)->Apply(FlashAttnSequenceLengths)->UseRealTime();
+BENCHMARK_CAPTURE(FLASHATTN, FP16, MlasFlashAttentionFloat16, false)->Apply(FlashAttnSequenceLengths)->UseRealTime();
+BENCHMARK_CAPTURE(FLASHATTN, BF16, MlasFlashAttentionBFloat16, false)->Apply(FlashAttnSequenceLengths)->UseRealTime();
+BENCHMARK_CAPTURE(FLASHATTN, INT8QK, MlasFlashAttentionInt8QK, false)->Apply(FlashAttnSequenceLengths)->UseRealTime();
+BENCHMARK_CAPTURE(FLASHATTN, FP32_Causal, MlasFlashAttentionFloat32, true)->Apply(FlashAttnSequenceLengths)->UseRealTime();
+BENCHMARK_CAPTURE(FLASHATTN, INT8QK_Causal, MlasFlashAttentionInt8QK, true)->Apply(FlashAttnSequenceLengths)->UseRealTime();
@@ -38,8 +38,7 @@ static const std::vector<std::string>& ArgNamesForConv(size_t rank) {
   return rank_to_args_name[rank];
 }
 
-// dummy for some strange build error when using Bench capture
-void SCONV_NCHW(benchmark::State& state, const char* /*dummy*/) {
+static void SconvNchw(benchmark::State& state, bool use_jit) {
   const int64_t rank = state.range(0);                       // Rank
   const int64_t batch_size = state.range(1);                 // N
   const int64_t groups = state.range(2);                     // G
@@ -111,6 +110,7 @@ void SCONV_NCHW(benchmark::State& state, const char* /*dummy*/) {
                   &WorkingBufferSize,
                   0.0f,
                   nullptr);
+  Parameters.UseJitKernels = use_jit;
 
   auto X = RandomVectorUniform(x_shape, -2.0, 2.0);
   auto F = RandomVectorUniform(f_shape, -1.0, 1.0);
@@ -138,6 +138,16 @@ void SCONV_NCHW(benchmark::State& state, const char* /*dummy*/) {
   }
 }
 
+// dummy for some strange build error when using Bench capture
+void SCONV_NCHW(benchmark::State& state, const char* /*dummy*/) {
+  SconvNchw(state, false);
+}
+
+// Same as SCONV_NCHW, with the runtime generated SGEMM kernels enabled.
+void SCONV_NCHW_JIT(benchmark::State& state, const char* /*dummy*/) {
+  SconvNchw(state, true);
+}
+
 static void ResNet50(benchmark::internal::Benchmark* b) {
   b->ArgNames(ArgNamesForConv(2));
 
@@ -221,6 +231,7 @@ static void TeamsModel(benchmark::internal::Benchmark* b) {
 }
 
 BENCHMARK_CAPTURE(SCONV_NCHW, TeamsModel, "")->Apply(TeamsModel)->UseRealTime();
+BENCHMARK_CAPTURE(SCONV_NCHW_JIT, TeamsModel, "")->Apply(TeamsModel)->UseRealTime();
 
 static void General_Conv2d(benchmark::internal::Benchmark* b) {
   b->ArgNames(ArgNamesForConv(2));
@@ -245,3 +256,4 @@ static void General_Conv2d(benchmark::internal::Benchmark* b) {
 }
 
 BENCHMARK_CAPTURE(SCONV_NCHW, 2d, "")->Apply(General_Conv2d)->UseRealTime();
+BENCHMARK_CAPTURE(SCONV_NCHW_JIT, 2d, "")->Apply(General_Conv2d)->UseRealTime();
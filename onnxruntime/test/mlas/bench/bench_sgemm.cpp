@@ -6,6 +6,7 @@
 #include "core/util/thread_utils.h"
 
 #include <stdexcept>
+#include <memory>
 #include <numeric>
 
 static const std::vector<std::string> sgemm_bench_arg_names = {"M", "N", "K"};
@@ -132,3 +133,116 @@ static void GemmLLMSizeProducts(benchmark::internal::Benchmark* b) {
 }
 
 BENCHMARK_CAPTURE(SGEMM, LLM, false, false, true)->Apply(GemmLLMSizeProducts)->UseRealTime();
+
+//
+// Small M with pre-packed B, such as single row inference through the dense
+// layers of a recommendation model. Compares the static kernels with the
+// runtime generated kernels.
+//
+
+void SGEMM_PACKB_SMALL_M(benchmark::State& state, bool use_jit) {
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+
+  auto A = RandomVectorUniform(static_cast<size_t>(M * K), -1.0f, 1.0f);
+  auto B = RandomVectorUniform(static_cast<size_t>(N * K), -1.0f, 1.0f);
+  std::vector<float> C(static_cast<size_t>(M * N));
+
+  // The static AVX512F kernel expects the packed buffer to be 64 byte aligned.
+  size_t pack_b_size = MlasGemmPackBSize(N, K);
+  std::vector<uint8_t> B_packed_buffer(pack_b_size + 64);
+  void* B_packed = B_packed_buffer.data();
+  size_t B_packed_space = B_packed_buffer.size();
+  std::align(64, pack_b_size, B_packed, B_packed_space);
+  MlasGemmPackB(CblasNoTrans, N, K, B.data(), N, B_packed);
+
+  MLAS_SGEMM_DATA_PARAMS data;
+  data.A = A.data();
+  data.lda = K;
+  data.B = static_cast<const float*>(B_packed);
+  data.BIsPacked = true;
+  data.C = C.data();
+  data.ldc = N;
+  data.UseJitKernels = use_jit;
+
+  MlasGemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, &data, 1, nullptr);
+
+  for (auto _ : state) {
+    MlasGemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, &data, 1, nullptr);
+  }
+}
+
+static void GemmSmallMSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames(sgemm_bench_arg_names);
+  b->ArgsProduct({{1, 2, 4}, {16, 64, 128, 256, 1024}, {64, 256, 1024}});
+}
+
+BENCHMARK_CAPTURE(SGEMM_PACKB_SMALL_M, Static, false)->Apply(GemmSmallMSizes)->UseRealTime();
+BENCHMARK_CAPTURE(SGEMM_PACKB_SMALL_M, Jit, true)->Apply(GemmSmallMSizes)->UseRealTime();
+
+//
+// Batches of small matrices, such as the attention heads of a short sequence
+// or the contractions of an Einsum. Compares one batched call with one call
+// per matrix.
+//
+
+static const std::vector<std::string> sgemm_batch_bench_arg_names = {"Batch", "M", "N", "K"};
+
+void SGEMM_SMALL_BATCH(benchmark::State& state, bool batched) {
+  const size_t Batch = static_cast<size_t>(state.range(0));
+  const size_t M = static_cast<size_t>(state.range(1));
+  const size_t N = static_cast<size_t>(state.range(2));
+  const size_t K = static_cast<size_t>(state.range(3));
+
+  auto A = RandomVectorUniform(static_cast<size_t>(Batch * M * K), -1.0f, 1.0f);
+  auto B = RandomVectorUniform(static_cast<size_t>(Batch * N * K), -1.0f, 1.0f);
+  std::vector<float> C(static_cast<size_t>(Batch * M * N));
+
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = 8;
+  tpo.auto_set_affinity = true;
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> tp(
+      onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                 tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP));
+
+  std::vector<MLAS_SGEMM_DATA_PARAMS> data(Batch);
+  for (size_t i = 0; i < Batch; i++) {
+    data[i].A = A.data() + i * M * K;
+    data[i].lda = K;
+    data[i].B = B.data() + i * N * K;
+    data[i].ldb = N;
+    data[i].C = C.data() + i * M * N;
+    data[i].ldc = N;
+  }
+
+  auto run = [&]() {
+    if (batched) {
+      MlasGemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, data.data(), Batch, tp.get());
+    } else {
+      for (size_t i = 0; i < Batch; i++) {
+        MlasGemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, &data[i], 1, tp.get());
+      }
+    }
+  };
+
+  run();
+
+  for (auto _ : state) {
+    run();
+  }
+}
+
+static void GemmSmallBatchSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames(sgemm_batch_bench_arg_names);
+  b->Args({12, 16, 16, 64});
+  b->Args({12, 64, 64, 64});
+  b->Args({32, 32, 32, 32});
+  b->Args({96, 8, 8, 64});
+  b->Args({96, 16, 64, 16});
+  b->Args({256, 4, 4, 4});
+  b->Args({256, 16, 16, 16});
+}
+
+BENCHMARK_CAPTURE(SGEMM_SMALL_BATCH, Batched, true)->Apply(GemmSmallBatchSizes)->UseRealTime();
+BENCHMARK_CAPTURE(SGEMM_SMALL_BATCH, PerMatrix, false)->Apply(GemmSmallBatchSizes)->UseRealTime();
@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+#include "core/util/thread_utils.h"
+
+#include <memory>
+#include <random>
+#include <stdexcept>
+
+static const std::vector<std::string> sparse_gemm_bench_arg_names = {"M", "N", "K", "Sparsity"};
+
+//
+// Returns a random K x N matrix where the given percentage of the 1x16 row
+// blocks are zero, which is the sparsity that MlasSparseGemmBatch exploits.
+//
+static std::vector<float> RandomBlockSparseMatrix(size_t N, size_t K, int64_t sparsity) {
+  auto B = RandomVectorUniform(N * K, -1.0f, 1.0f);
+
+  std::default_random_engine generator(static_cast<unsigned>(N * 31 + K));
+  std::uniform_int_distribution<int64_t> distribution(0, 99);
+
+  for (size_t k = 0; k < K; k++) {
+    for (size_t n = 0; n < N; n += 16) {
+      if (distribution(generator) < sparsity) {
+        std::fill_n(B.data() + k * N + n, std::min(N - n, size_t(16)), 0.0f);
+      }
+    }
+  }
+
+  return B;
+}
+
+//
+// Returns a 64 byte aligned pointer into the buffer, the packed matrices are
+// read with aligned loads.
+//
+static void* AlignedPackBuffer(std::vector<uint8_t>& buffer, size_t size) {
+  constexpr size_t alignment = 64;
+  buffer.resize(size + alignment);
+  void* ptr = buffer.data();
+  size_t space = buffer.size();
+  return std::align(alignment, size, ptr, space);
+}
+
+void SPARSE_GEMM(benchmark::State& state, bool sparse) {
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("K must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+  const int64_t sparsity = state.range(3);
+
+  auto A = RandomVectorUniform(M * K, -1.0f, 1.0f);
+  auto B = RandomBlockSparseMatrix(N, K, sparsity);
+  std::vector<float> C(M * N);
+
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = 8;
+  tpo.auto_set_affinity = true;
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> tp(
+      onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                 tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP));
+
+  if (sparse) {
+    const size_t pack_b_size = MlasSparseGemmPackBSize(N, K, B.data(), N);
+    if (pack_b_size == 0) throw std::invalid_argument("B cannot be packed in the block sparse format!");
+    std::vector<uint8_t> buffer;
+    void* B_packed = AlignedPackBuffer(buffer, pack_b_size);
+    MlasSparseGemmPackB(N, K, B.data(), N, B_packed);
+
+    MLAS_SPARSE_GEMM_DATA_PARAMS data;
+    data.A = A.data();
+    data.lda = K;
+    data.PackedB = B_packed;
+    data.C = C.data();
+    data.ldc = N;
+
+    MlasSparseGemmBatch(M, N, K, &data, 1, tp.get());
+
+    for (auto _ : state) {
+      MlasSparseGemmBatch(M, N, K, &data, 1, tp.get());
+    }
+
+  } else {
+    const size_t pack_b_size = MlasGemmPackBSize(N, K);
+    std::vector<uint8_t> buffer;
+    void* B_packed = AlignedPackBuffer(buffer, pack_b_size);
+    MlasGemmPackB(CblasNoTrans, N, K, B.data(), N, B_packed);
+
+    MlasGemm(CblasNoTrans, M, N, K, 1.0f, A.data(), K, B_packed, 0.0f, C.data(), N, tp.get());
+
+    for (auto _ : state) {
+      MlasGemm(CblasNoTrans, M, N, K, 1.0f, A.data(), K, B_packed, 0.0f, C.data(), N, tp.get());
+    }
+  }
+}
+
+static void SparseGemmSizeProducts(benchmark::internal::Benchmark* b) {
+  b->ArgNames(sparse_gemm_bench_arg_names);
+  b->ArgsProduct({{1, 64, 512}, {1024, 4096}, {1024, 4096}, {0, 50, 70, 80, 90, 95}});
+}
+
+BENCHMARK_CAPTURE(SPARSE_GEMM, SPARSE, true)->Apply(SparseGemmSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(SPARSE_GEMM, DENSE_PACKB, false)->Apply(SparseGemmSizeProducts)->UseRealTime();
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 #include <iomanip>
+#include <vector>
 #include "test_util.h"
 
 class MlasActivationTest : public MlasTestBase {
@@ -204,7 +205,7 @@ class MlasActivationTest : public MlasTestBase {
     MLAS_ACTIVATION Activation;
     AliasedValue Buffer[_countof(TestData)];
 
-    for (unsigned kind = 0; kind < unsigned(MlasActivationKindCount); kind++) {
+    for (unsigned kind = 0; kind < unsigned(_countof(TestData[0])); kind++) {
       Activation.ActivationKind = MLAS_ACTIVATION_KIND(kind);
 
       if (Activation.ActivationKind == MlasLeakyReluActivation) {
@@ -253,6 +254,60 @@ class MlasActivationTest : public MlasTestBase {
             << std::setw(8) << std::setfill('0') << std::hex << TestData[i][kind].u;
       }
     }
+
+    ExecuteTranscendental();
+  }
+
+  //
+  // The activations built from the transcendental routines are compared to
+  // the standard library with a tolerance.
+  //
+
+  void ExecuteTranscendental(void) {
+    constexpr size_t M = 3;
+    constexpr size_t N = 300;
+    constexpr size_t ldc = N + 5;
+
+    std::vector<float> Input(M * ldc);
+    for (size_t i = 0; i < Input.size(); i++) {
+      Input[i] = -8.0f + 16.0f * float(i) / float(Input.size());
+    }
+    const float Bias[M] = {0.5f, -0.25f, 0.0f};
+
+    const MLAS_ACTIVATION_KIND Kinds[] = {MlasGeluActivation, MlasFastGeluActivation, MlasSiluActivation};
+
+    for (auto kind : Kinds) {
+      MLAS_ACTIVATION Activation;
+      Activation.ActivationKind = kind;
+      Activation.Parameters.Silu.alpha = 1.702f;
+
+      std::vector<float> Buffer(Input);
+      MlasActivation(&Activation, Buffer.data(), Bias, M, N, ldc);
+
+      for (size_t m = 0; m < M; m++) {
+        for (size_t n = 0; n < ldc; n++) {
+          const float x = Input[m * ldc + n];
+          const float value = Buffer[m * ldc + n];
+          if (n >= N) {
+            EXPECT_EQ(value, x) << "padding modified, kind=" << int(kind);
+            continue;
+          }
+
+          const float v = x + Bias[m];
+          float expected;
+          if (kind == MlasGeluActivation) {
+            expected = 0.5f * v * (1.0f + std::erf(v * 0.70710678118654752440f));
+          } else if (kind == MlasFastGeluActivation) {
+            expected = 0.5f * v * (1.0f + std::tanh(0.7978845608028654f * (v + 0.044715f * v * v * v)));
+          } else {
+            expected = v / (1.0f + std::exp(-1.702f * v));
+          }
+
+          EXPECT_NEAR(value, expected, 1e-5f + 1e-5f * std::fabs(expected))
+              << "kind=" << int(kind) << ", m=" << m << ", n=" << n << ", x=" << v;
+        }
+      }
+    }
   }
 };
 
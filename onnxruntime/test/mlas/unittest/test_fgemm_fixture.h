@@ -70,6 +70,11 @@ class FgemmShortExecuteTest : public MlasTestFixture<MlasFgemmTest<T, Packed, Th
     test_registered += RegisterTestTransposeABProduct(128, 3072, 768, 1, 1.0f, 0.0f);
     test_registered += RegisterTestTransposeABProduct(128, 768, 3072, 1, 1.0f, 0.0f);
     test_registered += RegisterTestTransposeABProduct(25, 81, 79, 7, 1.0f, 0.0f);
+
+    // Batches of small matrices, which are distributed across the batch.
+    test_registered += RegisterTestTransposeABProduct(16, 16, 64, 24, 1.0f, 0.0f);
+    test_registered += RegisterTestTransposeABProduct(33, 47, 32, 12, 1.0f, 0.0f);
+    test_registered += RegisterTestTransposeABProduct(7, 70, 9, 16, 0.5f, 1.0f);
     return test_registered;
   }
 
@@ -0,0 +1,362 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_fp16.h"
+
+#include <cstring>
+
+//
+// Tests MlasFlashAttention for each input precision, with and without the
+// causal mask, against a direct implementation of softmax(Q*K'*scale)*V.
+//
+
+template <MLAS_FLASH_ATTENTION_TYPE Type, bool Causal>
+class MlasFlashAttentionTest : public MlasTestBase {
+ private:
+  static uint16_t FloatToBFloat16(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    bits += 0x7fff + ((bits >> 16) & 1);
+    return static_cast<uint16_t>(bits >> 16);
+  }
+
+  static float BFloat16ToFloat(uint16_t value) {
+    const uint32_t bits = static_cast<uint32_t>(value) << 16;
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+  }
+
+  //
+  // Stores the values in the precision of the test, and rounds the values to
+  // that precision so that the reference sees the same inputs.
+  //
+  static std::vector<uint16_t> Encode(std::vector<float>& values) {
+    std::vector<uint16_t> encoded(values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+      if (Type == MlasFlashAttentionFloat16) {
+        encoded[i] = MLAS_Float2Half(values[i]);
+        values[i] = MLAS_Half2Float(encoded[i]);
+      } else if (Type == MlasFlashAttentionBFloat16) {
+        encoded[i] = FloatToBFloat16(values[i]);
+        values[i] = BFloat16ToFloat(encoded[i]);
+      }
+    }
+    return encoded;
+  }
+
+  static float Decode(const void* output, size_t index) {
+    if (Type == MlasFlashAttentionFloat16) {
+      return MLAS_Half2Float(static_cast<const uint16_t*>(output)[index]);
+    } else if (Type == MlasFlashAttentionBFloat16) {
+      return BFloat16ToFloat(static_cast<const uint16_t*>(output)[index]);
+    }
+    return static_cast<const float*>(output)[index];
+  }
+
+  void Test(int batch_size, int num_heads, int q_sequence_length, int kv_sequence_length,
+            int qk_head_size, int v_head_size, int q_block_size, int kv_block_size, int thread_count) {
+    const size_t q_size = size_t(batch_size) * num_heads * q_sequence_length * qk_head_size;
+    const size_t k_size = size_t(batch_size) * num_heads * kv_sequence_length * qk_head_size;
+    const size_t v_size = size_t(batch_size) * num_heads * kv_sequence_length * v_head_size;
+    const size_t output_size = size_t(batch_size) * q_sequence_length * num_heads * v_head_size;
+
+    std::default_random_engine generator(static_cast<unsigned>(q_sequence_length * 131 + kv_sequence_length));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    std::vector<float> query(q_size), key(k_size), value(v_size);
+    for (auto& v : query) v = distribution(generator);
+    for (auto& v : key) v = distribution(generator);
+    for (auto& v : value) v = distribution(generator);
+
+    const bool low_precision = (Type == MlasFlashAttentionFloat16 || Type == MlasFlashAttentionBFloat16);
+    std::vector<uint16_t> query_encoded = Encode(query);
+    std::vector<uint16_t> key_encoded = Encode(key);
+    std::vector<uint16_t> value_encoded = Encode(value);
+    std::vector<float> output(output_size);
+    std::vector<uint16_t> output_encoded(output_size);
+
+    const float scale = 1.0f / std::sqrt(static_cast<float>(qk_head_size));
+
+    MlasFlashAttentionThreadedArgs args;
+    args.batch_size = batch_size;
+    args.num_heads = num_heads;
+    args.q_sequence_length = q_sequence_length;
+    args.kv_sequence_length = kv_sequence_length;
+    args.qk_head_size = qk_head_size;
+    args.v_head_size = v_head_size;
+    args.q_block_size = q_block_size;
+    args.kv_block_size = kv_block_size;
+    args.scale = scale;
+    args.thread_count = thread_count;
+    args.type = Type;
+    args.is_causal = Causal;
+    args.buffer_size_per_thread = MlasFlashAttentionGetBufferSizePerThread(
+        Type, size_t(q_block_size), size_t(kv_block_size), size_t(qk_head_size), size_t(v_head_size));
+    float* buffer = BufferWorkspace.GetBuffer(args.buffer_size_per_thread * thread_count / sizeof(float));
+    args.buffer = buffer;
+    if (low_precision) {
+      args.query = query_encoded.data();
+      args.key = key_encoded.data();
+      args.value = value_encoded.data();
+      args.output = output_encoded.data();
+    } else {
+      args.query = query.data();
+      args.key = key.data();
+      args.value = value.data();
+      args.output = output.data();
+    }
+
+    MlasFlashAttention(&args, threadpool_);
+
+    const void* result = low_precision ? static_cast<const void*>(output_encoded.data()) : output.data();
+
+    //
+    // The int8 quantization of Q and K perturbs the scores by about 1%, the
+    // other errors come from rounding the output.
+    //
+
+    float tolerance = 1e-4f;
+    if (Type == MlasFlashAttentionFloat16) {
+      tolerance = 2e-3f;
+    } else if (Type == MlasFlashAttentionBFloat16) {
+      tolerance = 1e-2f;
+    } else if (Type == MlasFlashAttentionInt8QK) {
+      tolerance = 2e-2f;
+    }
+
+    std::vector<double> scores(kv_sequence_length);
+    for (int b = 0; b < batch_size; b++) {
+      for (int n = 0; n < num_heads; n++) {
+        const size_t h = size_t(b) * num_heads + n;
+        for (int i = 0; i < q_sequence_length; i++) {
+          const int visible = Causal ? std::min(kv_sequence_length, i + kv_sequence_length - q_sequence_length + 1)
+                                     : kv_sequence_length;
+          double maximum = -std::numeric_limits<double>::infinity();
+          for (int j = 0; j < visible; j++) {
+            double dot = 0.0;
+            for (int d = 0; d < qk_head_size; d++) {
+              dot += double(query[(h * q_sequence_length + i) * qk_head_size + d]) *
+                     double(key[(h * kv_sequence_length + j) * qk_head_size + d]);
+            }
+            scores[j] = dot * scale;
+            maximum = std::max(maximum, scores[j]);
+          }
+          double sum = 0.0;
+          for (int j = 0; j < visible; j++) {
+            scores[j] = std::exp(scores[j] - maximum);
+            sum += scores[j];
+          }
+          for (int d = 0; d < v_head_size; d++) {
+            double expected = 0.0;
+            for (int j = 0; j < visible; j++) {
+              expected += scores[j] * double(value[(h * kv_sequence_length + j) * v_head_size + d]);
+            }
+            expected /= sum;
+
+            const size_t index = ((size_t(b) * q_sequence_length + i) * num_heads + n) * v_head_size + d;
+            ASSERT_NEAR(Decode(result, index), expected, tolerance)
+                << " @[" << b << "," << i << "," << n << "," << d << "], S=" << q_sequence_length
+                << ", T=" << kv_sequence_length << ", Br=" << q_block_size << ", Bc=" << kv_block_size
+                << ", threads=" << thread_count;
+          }
+        }
+      }
+    }
+  }
+
+  MatrixGuardBuffer<float> BufferWorkspace;
+  MLAS_THREADPOOL* threadpool_;
+
+ public:
+  MlasFlashAttentionTest() : threadpool_(GetMlasThreadPool()) {}
+
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(
+        std::string("FlashAttention") +
+        (Type == MlasFlashAttentionFloat16    ? "_Fp16"
+         : Type == MlasFlashAttentionBFloat16 ? "_Bf16"
+         : Type == MlasFlashAttentionInt8QK   ? "_Int8QK"
+                                              : "_Fp32") +
+        (Causal ? "_Causal" : ""));
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    static const int SequenceLengths[] = {1, 7, 32, 65};
+    static const int BlockSizes[][2] = {{1, 1}, {4, 16}, {16, 8}, {64, 64}};
+
+    for (int q_sequence_length : SequenceLengths) {
+      for (int kv_sequence_length : SequenceLengths) {
+        if (Causal && kv_sequence_length < q_sequence_length) {
+          continue;
+        }
+        for (const auto& block_size : BlockSizes) {
+          const int q_block_size = std::min(block_size[0], q_sequence_length);
+          const int kv_block_size = std::min(block_size[1], kv_sequence_length);
+          Test(2, 3, q_sequence_length, kv_sequence_length, 32, 16, q_block_size, kv_block_size, 1);
+          Test(1, 2, q_sequence_length, kv_sequence_length, 24, 40, q_block_size, kv_block_size, 3);
+        }
+      }
+    }
+  }
+};
+
+//
+// Tests the grouped query attention options of MlasFlashAttention: shared key
+// and value heads, per batch number of valid keys, local window, softcap,
+// smooth softmax and the query as a slice of packed QKV.
+//
+
+class MlasFlashAttentionGqaTest : public MlasTestBase {
+ private:
+  void Test(int batch_size, int num_heads, int kv_num_heads, int q_sequence_length, int kv_sequence_length,
+            int head_size, int local_window_size, float softcap, bool smooth_softmax, bool packed_query,
+            int q_block_size, int kv_block_size) {
+    // packed QKV holds the new keys and values after the query heads of each batch
+    const size_t query_batch_stride = size_t(packed_query ? num_heads + 2 * kv_num_heads : num_heads) *
+                                      q_sequence_length * head_size;
+    const size_t kv_size = size_t(batch_size) * kv_num_heads * kv_sequence_length * head_size;
+    const size_t output_size = size_t(batch_size) * q_sequence_length * num_heads * head_size;
+
+    std::default_random_engine generator(static_cast<unsigned>(q_sequence_length * 257 + kv_sequence_length));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    std::vector<float> query(query_batch_stride * batch_size), key(kv_size), value(kv_size), output(output_size);
+    for (auto& v : query) v = distribution(generator);
+    for (auto& v : key) v = distribution(generator) * 4.0f;
+    for (auto& v : value) v = distribution(generator);
+
+    // the first batch is padded, as the first prompt of grouped query attention
+    std::vector<int32_t> kv_valid_lengths(batch_size);
+    for (int b = 0; b < batch_size; b++) {
+      kv_valid_lengths[b] = std::max(1, kv_sequence_length - (b == 0 ? kv_sequence_length / 3 : 0));
+    }
+
+    const float scale = 1.0f / std::sqrt(static_cast<float>(head_size));
+    const int thread_count = 2;
+
+    MlasFlashAttentionThreadedArgs args;
+    args.batch_size = batch_size;
+    args.num_heads = num_heads;
+    args.q_sequence_length = q_sequence_length;
+    args.kv_sequence_length = kv_sequence_length;
+    args.qk_head_size = head_size;
+    args.v_head_size = head_size;
+    args.q_block_size = q_block_size;
+    args.kv_block_size = kv_block_size;
+    args.scale = scale;
+    args.thread_count = thread_count;
+    args.is_causal = true;
+    args.kv_num_heads = kv_num_heads;
+    args.kv_valid_lengths = kv_valid_lengths.data();
+    args.local_window_size = local_window_size;
+    args.softcap = softcap;
+    args.smooth_softmax = smooth_softmax;
+    args.query_batch_stride = query_batch_stride;
+    args.buffer_size_per_thread = MlasFlashAttentionGetBufferSizePerThread(
+        MlasFlashAttentionFloat32, size_t(q_block_size), size_t(kv_block_size), size_t(head_size), size_t(head_size));
+    args.buffer = BufferWorkspace.GetBuffer(args.buffer_size_per_thread * thread_count / sizeof(float));
+    args.query = query.data();
+    args.key = key.data();
+    args.value = value.data();
+    args.output = output.data();
+
+    MlasFlashAttention(&args, threadpool_);
+
+    std::vector<double> scores(kv_sequence_length);
+    for (int b = 0; b < batch_size; b++) {
+      const int total = kv_valid_lengths[b];
+      const int offset = std::max(total - q_sequence_length, 0);
+      for (int n = 0; n < num_heads; n++) {
+        const size_t kv_h = size_t(b) * kv_num_heads + n / (num_heads / kv_num_heads);
+        for (int i = 0; i < q_sequence_length; i++) {
+          const int last = std::min(i + offset, total - 1);
+          const int first = local_window_size >= 0 ? std::max(i + offset - local_window_size, 0) : 0;
+          double maximum = smooth_softmax ? 0.0 : -std::numeric_limits<double>::infinity();
+          for (int j = first; j <= last; j++) {
+            double dot = 0.0;
+            for (int d = 0; d < head_size; d++) {
+              dot += double(query[b * query_batch_stride + (size_t(n) * q_sequence_length + i) * head_size + d]) *
+                     double(key[(kv_h * kv_sequence_length + j) * head_size + d]);
+            }
+            scores[j] = dot * scale;
+            if (softcap > 0.0f) {
+              scores[j] = softcap * std::tanh(scores[j] / softcap);
+            }
+            maximum = std::max(maximum, scores[j]);
+          }
+          double sum = smooth_softmax ? std::exp(-maximum) : 0.0;
+          for (int j = first; j <= last; j++) {
+            scores[j] = std::exp(scores[j] - maximum);
+            sum += scores[j];
+          }
+          for (int d = 0; d < head_size; d++) {
+            double expected = 0.0;
+            for (int j = first; j <= last; j++) {
+              expected += scores[j] * double(value[(kv_h * kv_sequence_length + j) * head_size + d]);
+            }
+            // a padding row past the local window of the valid keys has no visible keys and a zero output
+            if (sum > 0.0) {
+              expected /= sum;
+            }
+
+            const size_t index = ((size_t(b) * q_sequence_length + i) * num_heads + n) * head_size + d;
+            ASSERT_NEAR(output[index], expected, 1e-4f)
+                << " @[" << b << "," << i << "," << n << "," << d << "], S=" << q_sequence_length
+                << ", T=" << kv_sequence_length << ", Nkv=" << kv_num_heads << ", local=" << local_window_size
+                << ", softcap=" << softcap << ", smooth=" << smooth_softmax << ", Br=" << q_block_size
+                << ", Bc=" << kv_block_size;
+          }
+        }
+      }
+    }
+  }
+
+  MatrixGuardBuffer<float> BufferWorkspace;
+  MLAS_THREADPOOL* threadpool_;
+
+ public:
+  MlasFlashAttentionGqaTest() : threadpool_(GetMlasThreadPool()) {}
+
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("FlashAttention_GQA");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    static const int SequenceLengths[][2] = {{1, 1}, {1, 33}, {7, 7}, {5, 40}, {32, 32}, {65, 65}};
+    static const int BlockSizes[][2] = {{1, 1}, {4, 16}, {16, 8}};
+
+    for (const auto& sequence_length : SequenceLengths) {
+      for (const auto& block_size : BlockSizes) {
+        const int q_block_size = std::min(block_size[0], sequence_length[0]);
+        const int kv_block_size = std::min(block_size[1], sequence_length[1]);
+        for (int local_window_size : {-1, 0, 5}) {
+          Test(2, 4, 2, sequence_length[0], sequence_length[1], 16, local_window_size, 0.0f, false, false,
+               q_block_size, kv_block_size);
+          Test(2, 6, 3, sequence_length[0], sequence_length[1], 8, local_window_size, 0.0f, false, true,
+               q_block_size, kv_block_size);
+        }
+        Test(2, 4, 1, sequence_length[0], sequence_length[1], 16, -1, 2.0f, false, true, q_block_size, kv_block_size);
+        Test(2, 2, 2, sequence_length[0], sequence_length[1], 16, 3, 0.0f, true, false, q_block_size, kv_block_size);
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<MlasFlashAttentionFloat32, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<MlasFlashAttentionFloat32, true>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<MlasFlashAttentionFloat16, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<MlasFlashAttentionFloat16, true>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<MlasFlashAttentionBFloat16, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<MlasFlashAttentionBFloat16, true>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<MlasFlashAttentionInt8QK, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<MlasFlashAttentionInt8QK, true>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasFlashAttentionGqaTest>::RegisterShortExecute();
+  }
+  return count;
+});
@@ -133,8 +133,14 @@ class MlasHalfGemmTest : public MlasTestBase {
               sum = float(Bias[n]);
             }
             for (size_t kk = 0; kk < std::min(KStride, K - k); kk++) {
+#if defined(MLAS_TARGET_AMD64_IX86)
+              // the AVX2 kernel accumulates in fp32. The AVX512-FP16 kernel sums runs of 16 products in fp16
+              // and accumulates these partial sums in fp32, which stays within the tolerance of the check.
+              sum += float(*b) * float(*a);
+#else
               MLFp16 down(float(*b) * float(*a) + sum);
               sum = float(down);
+#endif
               b += N;
               a += 1;
             }
@@ -0,0 +1,186 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+//
+// Tests the epilogue operations of MLAS_SGEMM_DATA_PARAMS against a plain
+// SGEMM followed by a reference implementation of the epilogue.
+//
+
+template <bool Packed, bool Threaded>
+class MlasSgemmEpilogueTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<uint8_t> BufferBPacked;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferResidual;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+  MLAS_THREADPOOL* threadpool_;
+
+  static float ReferenceActivation(const MLAS_ACTIVATION& Activation, float x) {
+    switch (Activation.ActivationKind) {
+      case MlasReluActivation:
+        return std::max(x, 0.0f);
+      case MlasGeluActivation:
+        return 0.5f * x * (1.0f + std::erf(x * 0.70710678118654752440f));
+      case MlasFastGeluActivation:
+        return 0.5f * x * (1.0f + std::tanh(0.7978845608028654f * (x + 0.044715f * x * x * x)));
+      case MlasSiluActivation:
+        return x / (1.0f + std::exp(-Activation.Parameters.Silu.alpha * x));
+      default:
+        return x;
+    }
+  }
+
+  void Test(CBLAS_TRANSPOSE TransA, CBLAS_TRANSPOSE TransB, size_t M, size_t N, size_t K,
+            float alpha, float beta, bool UseBias, bool UseResidual, const MLAS_ACTIVATION* Activation) {
+    const size_t lda = (TransA == CblasNoTrans) ? K : M;
+    const size_t ldb = (TransB == CblasNoTrans) ? N : K;
+    const size_t ldc = N + 3;
+    const size_t ldr = N + 1;
+
+    float* A = BufferA.GetBuffer(M * K);
+    float* B = BufferB.GetBuffer(N * K);
+    float* Bias = BufferBias.GetBuffer(N);
+    float* Residual = BufferResidual.GetBuffer(M * ldr);
+    float* C = BufferC.GetBuffer(M * ldc);
+    float* CReference = BufferCReference.GetBuffer(M * ldc);
+
+    //
+    // Keep the values of the output small so that the activations are not
+    // saturated.
+    //
+
+    std::default_random_engine generator(static_cast<unsigned>(M * 131 + N * 7 + K));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    const float scale = 2.0f / std::sqrt(float(std::max(K, size_t(1))));
+    for (size_t i = 0; i < M * K; i++) {
+      A[i] = distribution(generator) * scale;
+    }
+    for (size_t i = 0; i < N * K; i++) {
+      B[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < N; i++) {
+      Bias[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < M * ldr; i++) {
+      Residual[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < M * ldc; i++) {
+      C[i] = CReference[i] = distribution(generator);
+    }
+
+    MLAS_SGEMM_EPILOGUE Epilogue;
+    Epilogue.Bias = UseBias ? Bias : nullptr;
+    Epilogue.Residual = UseResidual ? Residual : nullptr;
+    Epilogue.ldr = ldr;
+    Epilogue.Activation = Activation;
+
+    MLAS_SGEMM_DATA_PARAMS Data;
+    Data.A = A;
+    Data.lda = lda;
+    Data.B = B;
+    Data.ldb = ldb;
+    Data.C = C;
+    Data.ldc = ldc;
+    Data.alpha = alpha;
+    Data.beta = beta;
+    Data.Epilogue = &Epilogue;
+
+    if (Packed) {
+      const size_t PackedBSize = MlasGemmPackBSize(N, K);
+      if (PackedBSize == 0) {
+        return;
+      }
+      void* PackedB = BufferBPacked.GetBuffer(PackedBSize, true);
+      MlasGemmPackB(TransB, N, K, B, ldb, PackedB);
+      Data.B = static_cast<const float*>(PackedB);
+      Data.BIsPacked = true;
+    }
+
+    MlasGemmBatch(TransA, TransB, M, N, K, &Data, 1, threadpool_);
+
+    MlasGemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, CReference, ldc, nullptr);
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < ldc; n++) {
+        float expected = CReference[m * ldc + n];
+        if (n < N) {
+          if (UseBias) {
+            expected += Bias[n];
+          }
+          if (UseResidual) {
+            expected += Residual[m * ldr + n];
+          }
+          if (Activation != nullptr) {
+            expected = ReferenceActivation(*Activation, expected);
+          }
+        }
+        const float value = C[m * ldc + n];
+        ASSERT_NEAR(value, expected, 1e-4f + 1e-4f * std::fabs(expected))
+            << " @[" << m << "," << n << "], M=" << M << ", N=" << N << ", K=" << K
+            << ", TransA=" << TransA << ", TransB=" << TransB << ", alpha=" << alpha << ", beta=" << beta
+            << ", Bias=" << UseBias << ", Residual=" << UseResidual
+            << ", Activation=" << (Activation != nullptr ? int(Activation->ActivationKind) : -1);
+      }
+    }
+  }
+
+ public:
+  MlasSgemmEpilogueTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(std::string("SgemmEpilogue") +
+                                        (Packed ? "_Packed" : "_NoPack") +
+                                        (Threaded ? "_Threaded" : "_SingleThread"));
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    MLAS_ACTIVATION Activations[4];
+    Activations[0].ActivationKind = MlasReluActivation;
+    Activations[1].ActivationKind = MlasGeluActivation;
+    Activations[2].ActivationKind = MlasFastGeluActivation;
+    Activations[3].ActivationKind = MlasSiluActivation;
+    Activations[3].Parameters.Silu.alpha = 1.702f;
+
+    static const size_t Ms[] = {1, 2, 5, 16, 33};
+    static const size_t Ns[] = {1, 3, 16, 17, 300};
+    static const size_t Ks[] = {0, 1, 7, 600};
+
+    for (size_t M : Ms) {
+      for (size_t N : Ns) {
+        for (size_t K : Ks) {
+          for (int trans = 0; trans < 4; trans++) {
+            const CBLAS_TRANSPOSE TransA = (trans & 1) ? CblasTrans : CblasNoTrans;
+            const CBLAS_TRANSPOSE TransB = (trans & 2) ? CblasTrans : CblasNoTrans;
+
+            Test(TransA, TransB, M, N, K, 1.0f, 0.0f, true, false, nullptr);
+            Test(TransA, TransB, M, N, K, 1.0f, 1.0f, false, true, nullptr);
+            Test(TransA, TransB, M, N, K, 0.5f, 0.25f, true, true, &Activations[0]);
+
+            for (const auto& Activation : Activations) {
+              Test(TransA, TransB, M, N, K, 1.0f, 0.0f, true, false, &Activation);
+            }
+          }
+        }
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasSgemmEpilogueTest<false, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasSgemmEpilogueTest<true, false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasSgemmEpilogueTest<false, true>>::RegisterShortExecute();
+      count += MlasDirectShortExecuteTests<MlasSgemmEpilogueTest<true, true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
@@ -0,0 +1,124 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+//
+// Tests the runtime generated SGEMM kernels against the static kernels. When
+// the platform does not support generated kernels, MLAS_SGEMM_DATA_PARAMS::
+// UseJitKernels is ignored and the test compares the static kernels with
+// themselves.
+//
+
+template <bool Packed>
+class MlasSgemmJitTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<uint8_t> BufferBPacked;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+
+  void Test(CBLAS_TRANSPOSE TransA, CBLAS_TRANSPOSE TransB, size_t M, size_t N, size_t K,
+            float alpha, float beta) {
+    const size_t lda = (TransA == CblasNoTrans) ? K + 1 : M + 1;
+    const size_t ldb = (TransB == CblasNoTrans) ? N : K;
+    const size_t ldc = N + 3;
+
+    float* A = BufferA.GetBuffer(lda * std::max(M, K));
+    float* B = BufferB.GetBuffer(N * K);
+    float* C = BufferC.GetBuffer(M * ldc);
+    float* CReference = BufferCReference.GetBuffer(M * ldc);
+
+    std::default_random_engine generator(static_cast<unsigned>(M * 131 + N * 7 + K));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    for (size_t i = 0; i < lda * std::max(M, K); i++) {
+      A[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < N * K; i++) {
+      B[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < M * ldc; i++) {
+      C[i] = CReference[i] = distribution(generator);
+    }
+
+    MLAS_SGEMM_DATA_PARAMS Data;
+    Data.A = A;
+    Data.lda = lda;
+    Data.B = B;
+    Data.ldb = ldb;
+    Data.alpha = alpha;
+    Data.beta = beta;
+    Data.ldc = ldc;
+
+    if (Packed) {
+      const size_t PackedBSize = MlasGemmPackBSize(N, K);
+      if (PackedBSize == 0) {
+        return;
+      }
+      void* PackedB = BufferBPacked.GetBuffer(PackedBSize, true);
+      MlasGemmPackB(TransB, N, K, B, ldb, PackedB);
+      Data.B = static_cast<const float*>(PackedB);
+      Data.BIsPacked = true;
+    }
+
+    Data.C = CReference;
+    Data.UseJitKernels = false;
+    MlasGemmBatch(TransA, TransB, M, N, K, &Data, 1, nullptr);
+
+    Data.C = C;
+    Data.UseJitKernels = true;
+    MlasGemmBatch(TransA, TransB, M, N, K, &Data, 1, nullptr);
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < ldc; n++) {
+        const float expected = CReference[m * ldc + n];
+        const float value = C[m * ldc + n];
+        if (n < N) {
+          ASSERT_NEAR(value, expected, 1e-4f * (1.0f + std::sqrt(float(K))))
+              << " @[" << m << "," << n << "], M=" << M << ", N=" << N << ", K=" << K
+              << ", TransA=" << TransA << ", TransB=" << TransB << ", alpha=" << alpha << ", beta=" << beta;
+        } else {
+          ASSERT_EQ(value, expected) << " padding modified @[" << m << "," << n << "], M=" << M
+                                     << ", N=" << N << ", K=" << K;
+        }
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(std::string("SgemmJit") + (Packed ? "_Packed" : "_NoPack"));
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    static const size_t Ms[] = {1, 2, 3, 4, 5, 9};
+    static const size_t Ns[] = {1, 15, 16, 17, 48, 112, 128, 129, 300};
+    static const size_t Ks[] = {1, 3, 4, 5, 8, 17, 255, 256, 257, 600};
+
+    for (size_t M : Ms) {
+      for (size_t N : Ns) {
+        for (size_t K : Ks) {
+          for (int trans = 0; trans < 4; trans++) {
+            const CBLAS_TRANSPOSE TransA = (trans & 1) ? CblasTrans : CblasNoTrans;
+            const CBLAS_TRANSPOSE TransB = (trans & 2) ? CblasTrans : CblasNoTrans;
+
+            Test(TransA, TransB, M, N, K, 1.0f, 0.0f);
+            Test(TransA, TransB, M, N, K, 0.5f, 1.0f);
+            Test(TransA, TransB, M, N, K, 1.5f, 0.25f);
+          }
+        }
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasSgemmJitTest<false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasSgemmJitTest<true>>::RegisterShortExecute();
+  }
+  return count;
+});
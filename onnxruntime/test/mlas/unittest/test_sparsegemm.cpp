@@ -0,0 +1,155 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+//
+// Tests the block sparse SGEMM against the dense SGEMM for matrices with a
+// range of unstructured, block and 2:4 structured sparsity.
+//
+
+template <bool Threaded>
+class MlasSparseGemmTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<uint8_t> BufferBPacked;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+  MLAS_THREADPOOL* threadpool_;
+
+  enum SparsityPattern {
+    Unstructured,
+    RowBlocks,
+    TwoOfFour,
+  };
+
+  void Test(size_t BatchSize, size_t M, size_t N, size_t K, SparsityPattern Pattern, float Sparsity) {
+    const size_t lda = K + 1;
+    const size_t ldb = N;
+    const size_t ldc = N + 3;
+
+    float* A = BufferA.GetBuffer(BatchSize * M * lda);
+    float* B = BufferB.GetBuffer(K * ldb);
+    float* C = BufferC.GetBuffer(BatchSize * M * ldc);
+    float* CReference = BufferCReference.GetBuffer(BatchSize * M * ldc);
+
+    std::default_random_engine generator(static_cast<unsigned>(M * 131 + N * 7 + K + Pattern));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> selector(0.0f, 1.0f);
+
+    for (size_t i = 0; i < BatchSize * M * lda; i++) {
+      A[i] = distribution(generator);
+    }
+
+    for (size_t k = 0; k < K; k++) {
+      const bool ZeroRow = (Pattern == RowBlocks) && selector(generator) < Sparsity;
+      for (size_t n = 0; n < N; n++) {
+        bool Zero;
+        switch (Pattern) {
+          case Unstructured:
+            Zero = selector(generator) < Sparsity;
+            break;
+          case RowBlocks:
+            Zero = ZeroRow;
+            break;
+          default:
+            Zero = ((k + n) % 4) < 2;
+            break;
+        }
+        B[k * ldb + n] = Zero ? 0.0f : distribution(generator);
+      }
+    }
+
+    for (size_t i = 0; i < BatchSize * M * ldc; i++) {
+      C[i] = CReference[i] = -0.5f;
+    }
+
+    const size_t PackedBSize = MlasSparseGemmPackBSize(N, K, B, ldb);
+    ASSERT_GT(PackedBSize, size_t(0));
+    void* PackedB = BufferBPacked.GetBuffer(PackedBSize, true);
+    MlasSparseGemmPackB(N, K, B, ldb, PackedB);
+
+    std::vector<MLAS_SPARSE_GEMM_DATA_PARAMS> Data(BatchSize);
+    for (size_t i = 0; i < BatchSize; i++) {
+      Data[i].A = A + i * M * lda;
+      Data[i].lda = lda;
+      Data[i].PackedB = PackedB;
+      Data[i].C = C + i * M * ldc;
+      Data[i].ldc = ldc;
+
+      MlasGemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A + i * M * lda, lda, B, ldb, 0.0f,
+               CReference + i * M * ldc, ldc, nullptr);
+    }
+
+    MlasSparseGemmBatch(M, N, K, Data.data(), BatchSize, threadpool_);
+
+    for (size_t i = 0; i < BatchSize * M * ldc; i++) {
+      ASSERT_NEAR(C[i], CReference[i], 1e-4f + 1e-4f * std::fabs(CReference[i]))
+          << " @" << i << ", Batch=" << BatchSize << ", M=" << M << ", N=" << N << ", K=" << K
+          << ", Pattern=" << Pattern << ", Sparsity=" << Sparsity;
+    }
+  }
+
+ public:
+  MlasSparseGemmTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(std::string("SparseGemm") + (Threaded ? "_Threaded" : "_SingleThread"));
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    static const size_t Ms[] = {1, 3, 5, 12, 13, 70};
+    static const size_t Ns[] = {1, 15, 16, 17, 100};
+    static const size_t Ks[] = {0, 1, 7, 64, 300};
+    static const float Sparsities[] = {0.0f, 0.5f, 0.9f, 1.0f};
+
+    for (size_t M : Ms) {
+      for (size_t N : Ns) {
+        for (size_t K : Ks) {
+          for (float Sparsity : Sparsities) {
+            Test(1, M, N, K, Unstructured, Sparsity);
+            Test(1, M, N, K, RowBlocks, Sparsity);
+          }
+          Test(1, M, N, K, TwoOfFour, 0.5f);
+          Test(3, M, N, K, RowBlocks, 0.7f);
+        }
+      }
+    }
+  }
+};
+
+class MlasSparseGemmPackTest : public MlasTestBase {
+ public:
+  static const char* GetTestSuiteName() {
+    return "SparseGemmPack";
+  }
+
+  void ExecuteShort(void) override {
+    //
+    // A 3x20 matrix has 2 panels, the first row is zero, the second row has a
+    // nonzero value only in the second panel.
+    //
+
+    std::vector<float> B(3 * 20, 0.0f);
+    B[1 * 20 + 18] = 1.0f;
+    B[2 * 20 + 0] = 2.0f;
+    B[2 * 20 + 19] = 3.0f;
+
+    ASSERT_FLOAT_EQ(MlasSparseGemmBlockSparsity(20, 3, B.data(), 20), 0.5f);
+    ASSERT_FLOAT_EQ(MlasSparseGemmBlockSparsity(20, 0, nullptr, 20), 0.0f);
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasSparseGemmPackTest>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasSparseGemmTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasSparseGemmTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
@@ -0,0 +1,202 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+//
+// Tests the vectorized math routines against the double precision C runtime
+// functions, using the error bounds documented in mlas.h.
+//
+
+enum MlasTranscendentalFunction {
+  MlasTranscendentalLog,
+  MlasTranscendentalSin,
+  MlasTranscendentalCos,
+  MlasTranscendentalSqrt,
+  MlasTranscendentalReciprocal,
+  MlasTranscendentalPow,
+};
+
+template <MlasTranscendentalFunction Function>
+class MlasTranscendentalTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferExponent;
+  MatrixGuardBuffer<float> BufferOutput;
+
+  static double UlpError(float Value, double Expected) {
+    if (std::isnan(Expected)) {
+      return std::isnan(Value) ? 0.0 : std::numeric_limits<double>::infinity();
+    }
+    if (std::isinf(static_cast<float>(Expected)) || Expected == 0.0) {
+      return Value == static_cast<float>(Expected) ? 0.0 : std::numeric_limits<double>::infinity();
+    }
+    int exponent;
+    std::frexp(Expected, &exponent);
+    const double ulp = std::ldexp(1.0, std::max(exponent - 24, -149));
+    return std::fabs(static_cast<double>(Value) - Expected) / ulp;
+  }
+
+  static double Reference(float Value, float Exponent) {
+    const double x = static_cast<double>(Value);
+    switch (Function) {
+      case MlasTranscendentalLog:
+        return std::log(x);
+      case MlasTranscendentalSin:
+        return std::sin(x);
+      case MlasTranscendentalCos:
+        return std::cos(x);
+      case MlasTranscendentalSqrt:
+        return std::sqrt(x);
+      case MlasTranscendentalReciprocal:
+        return 1.0 / x;
+      default:
+        return std::pow(x, static_cast<double>(Exponent));
+    }
+  }
+
+  static double MaximumUlpError() {
+    switch (Function) {
+      case MlasTranscendentalLog:
+      case MlasTranscendentalPow:
+        return 1.0;
+      case MlasTranscendentalSin:
+      case MlasTranscendentalCos:
+        return 2.0;
+      default:
+        return 0.5;
+    }
+  }
+
+  void Compute(const float* Input, const float* Exponent, float* Output, size_t N,
+               bool ScalarBase, bool ScalarExponent) {
+    switch (Function) {
+      case MlasTranscendentalLog:
+        MlasComputeLog(Input, Output, N);
+        break;
+      case MlasTranscendentalSin:
+        MlasComputeSin(Input, Output, N);
+        break;
+      case MlasTranscendentalCos:
+        MlasComputeCos(Input, Output, N);
+        break;
+      case MlasTranscendentalSqrt:
+        MlasComputeSqrt(Input, Output, N);
+        break;
+      case MlasTranscendentalReciprocal:
+        MlasComputeReciprocal(Input, Output, N);
+        break;
+      default:
+        MlasComputePow(Input, Exponent, Output, N, ScalarBase, ScalarExponent);
+        break;
+    }
+  }
+
+  void Test(size_t N, float MinimumValue, float MaximumValue, bool ScalarBase = false, bool ScalarExponent = false) {
+    float* Input = BufferInput.GetBuffer(N);
+    float* Exponent = BufferExponent.GetBuffer(N);
+    float* Output = BufferOutput.GetBuffer(N);
+
+    std::default_random_engine generator(static_cast<unsigned>(N));
+    std::uniform_real_distribution<float> distribution(MinimumValue, MaximumValue);
+    std::uniform_real_distribution<float> exponent_distribution(-4.0f, 4.0f);
+
+    for (size_t n = 0; n < N; n++) {
+      Input[n] = distribution(generator);
+      Exponent[n] = exponent_distribution(generator);
+    }
+
+    Compute(Input, Exponent, Output, N, ScalarBase, ScalarExponent);
+
+    for (size_t n = 0; n < N; n++) {
+      const float x = ScalarBase ? Input[0] : Input[n];
+      const float y = ScalarExponent ? Exponent[0] : Exponent[n];
+      const double expected = Reference(x, y);
+      ASSERT_LE(UlpError(Output[n], expected), MaximumUlpError())
+          << " @" << n << " of " << N << ", input: " << x << ", exponent: " << y
+          << ", got: " << Output[n] << ", expecting: " << expected;
+    }
+  }
+
+  void TestSpecialValues() {
+    static const float SpecialValues[] = {
+        0.0f, -0.0f, 1.0f, -1.0f, 0.5f, -0.5f, 2.0f, -2.0f, 3.0f, -3.0f,
+        std::numeric_limits<float>::denorm_min(), -std::numeric_limits<float>::denorm_min(),
+        std::numeric_limits<float>::min(), std::numeric_limits<float>::max(),
+        std::numeric_limits<float>::lowest(), 16777216.0f, 5000.0f, -1.0e30f,
+        std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+        std::numeric_limits<float>::quiet_NaN()};
+    constexpr size_t Count = sizeof(SpecialValues) / sizeof(SpecialValues[0]);
+
+    const size_t N = Count * Count;
+    float* Input = BufferInput.GetBuffer(N);
+    float* Exponent = BufferExponent.GetBuffer(N);
+    float* Output = BufferOutput.GetBuffer(N);
+
+    for (size_t i = 0; i < Count; i++) {
+      for (size_t j = 0; j < Count; j++) {
+        Input[i * Count + j] = SpecialValues[i];
+        Exponent[i * Count + j] = SpecialValues[j];
+      }
+    }
+
+    Compute(Input, Exponent, Output, N, false, false);
+
+    for (size_t n = 0; n < N; n++) {
+      const double expected = Reference(Input[n], Exponent[n]);
+      ASSERT_LE(UlpError(Output[n], expected), MaximumUlpError())
+          << " @" << n << ", input: " << Input[n] << ", exponent: " << Exponent[n]
+          << ", got: " << Output[n] << ", expecting: " << expected;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(
+        Function == MlasTranscendentalLog          ? "Transcendental_Log"
+        : Function == MlasTranscendentalSin        ? "Transcendental_Sin"
+        : Function == MlasTranscendentalCos        ? "Transcendental_Cos"
+        : Function == MlasTranscendentalSqrt       ? "Transcendental_Sqrt"
+        : Function == MlasTranscendentalReciprocal ? "Transcendental_Reciprocal"
+                                                   : "Transcendental_Pow");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t n = 1; n < 128; n++) {
+      if (Function == MlasTranscendentalSin || Function == MlasTranscendentalCos) {
+        Test(n, -10.f, 10.f);
+      } else {
+        Test(n, 1e-3f, 100.f);
+      }
+    }
+
+    if (Function == MlasTranscendentalSin || Function == MlasTranscendentalCos) {
+      // Arguments beyond the range reduction limit use the C runtime.
+      Test(1000, -5000.f, 5000.f);
+      Test(1000, -1e6f, 1e6f);
+    } else if (Function == MlasTranscendentalPow) {
+      Test(1000, -8.f, 8.f);
+      Test(61, 0.f, 16.f, true, false);
+      Test(61, 0.f, 16.f, false, true);
+      Test(61, 0.f, 16.f, true, true);
+    } else {
+      Test(1000, 1e-30f, 1e30f);
+    }
+
+    TestSpecialValues();
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasTranscendentalTest<MlasTranscendentalLog>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasTranscendentalTest<MlasTranscendentalSin>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasTranscendentalTest<MlasTranscendentalCos>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasTranscendentalTest<MlasTranscendentalSqrt>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasTranscendentalTest<MlasTranscendentalReciprocal>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasTranscendentalTest<MlasTranscendentalPow>>::RegisterShortExecute();
+  }
+  return count;
+});
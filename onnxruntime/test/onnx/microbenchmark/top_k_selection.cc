@@ -0,0 +1,114 @@
+#include "common.h"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "contrib_ops/cpu/transformers/top_k_selection.h"
+
+using onnxruntime::contrib::transformers::SelectTopK;
+using onnxruntime::contrib::transformers::SelectTopP;
+
+// Probabilities of a row of the vocabulary. The logits are normally distributed with the given standard deviation:
+// the larger it is, the fewer tokens hold most of the probability, as in the output of a language model.
+static std::vector<float> GenerateProbs(size_t vocab_size, float logit_stddev) {
+  std::default_random_engine generator(static_cast<uint32_t>(vocab_size));
+  std::normal_distribution<float> distribution(0.0f, logit_stddev);
+  std::vector<float> probs(vocab_size);
+  for (auto& prob : probs) {
+    prob = distribution(generator);
+  }
+
+  const float max_logit = *std::max_element(probs.begin(), probs.end());
+  float sum = 0.0f;
+  for (auto& prob : probs) {
+    prob = std::exp(prob - max_logit);
+    sum += prob;
+  }
+  for (auto& prob : probs) {
+    prob /= sum;
+  }
+  return probs;
+}
+
+// Sort of the whole row, as top-p sampling used to do.
+static void BM_TopPFullSort(benchmark::State& state) {
+  const size_t vocab_size = static_cast<size_t>(state.range(0));
+  const std::vector<float> probs = GenerateProbs(vocab_size, static_cast<float>(state.range(1)));
+  std::vector<int32_t> indices(vocab_size);
+  constexpr float top_p = 0.9f;
+
+  for (auto _ : state) {
+    std::iota(indices.begin(), indices.end(), 0);
+    std::sort(indices.begin(), indices.end(), [&probs](int32_t a, int32_t b) { return probs[a] > probs[b]; });
+    float cumulative_prob = 0.0f;
+    size_t num_kept = 0;
+    while (num_kept < vocab_size && cumulative_prob < top_p) {
+      cumulative_prob += probs[indices[num_kept++]];
+    }
+    benchmark::DoNotOptimize(num_kept);
+  }
+}
+
+static void BM_TopPSelection(benchmark::State& state) {
+  const size_t vocab_size = static_cast<size_t>(state.range(0));
+  const std::vector<float> probs = GenerateProbs(vocab_size, static_cast<float>(state.range(1)));
+  std::vector<int32_t> indices(vocab_size);
+
+  for (auto _ : state) {
+    const size_t num_kept = SelectTopP<float>(probs, 0.9f, false, 1, indices);
+    benchmark::DoNotOptimize(num_kept);
+  }
+}
+
+static void BM_TopKFullSort(benchmark::State& state) {
+  const size_t vocab_size = static_cast<size_t>(state.range(0));
+  const size_t k = static_cast<size_t>(state.range(1));
+  const std::vector<float> probs = GenerateProbs(vocab_size, 4.0f);
+  std::vector<int32_t> indices(vocab_size);
+
+  for (auto _ : state) {
+    std::iota(indices.begin(), indices.end(), 0);
+    std::sort(indices.begin(), indices.end(), [&probs](int32_t a, int32_t b) { return probs[a] > probs[b]; });
+    benchmark::DoNotOptimize(indices[k - 1]);
+  }
+}
+
+static void BM_TopKSelection(benchmark::State& state) {
+  const size_t vocab_size = static_cast<size_t>(state.range(0));
+  const size_t k = static_cast<size_t>(state.range(1));
+  const std::vector<float> probs = GenerateProbs(vocab_size, 4.0f);
+  std::vector<int32_t> indices(vocab_size);
+
+  for (auto _ : state) {
+    SelectTopK<float>(probs, k, indices);
+    benchmark::DoNotOptimize(indices[k - 1]);
+  }
+}
+
+// Vocabulary sizes of LLaMA 2, GPT-2, LLaMA 3, Qwen 2 and Gemma.
+static constexpr int64_t kVocabSizes[] = {32000, 50257, 128256, 152064, 256000};
+
+static void VocabSizesAndLogitStddev(benchmark::internal::Benchmark* b) {
+  for (int64_t vocab_size : kVocabSizes) {
+    for (int64_t logit_stddev : {1, 4}) {
+      b->Args({vocab_size, logit_stddev});
+    }
+  }
+}
+
+static void VocabSizesAndK(benchmark::internal::Benchmark* b) {
+  for (int64_t vocab_size : kVocabSizes) {
+    for (int64_t k : {8, 50}) {
+      b->Args({vocab_size, k});
+    }
+  }
+}
+
+BENCHMARK(BM_TopPFullSort)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond)->Apply(VocabSizesAndLogitStddev);
+BENCHMARK(BM_TopPSelection)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond)->Apply(VocabSizesAndLogitStddev);
+BENCHMARK(BM_TopKFullSort)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond)->Apply(VocabSizesAndK);
+BENCHMARK(BM_TopKSelection)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond)->Apply(VocabSizesAndK);
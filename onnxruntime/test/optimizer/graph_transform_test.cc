@@ -2767,6 +2767,49 @@ TEST_F(GraphTransformationTests, Gemm_LeakyRelu_Fusion) {
   ASSERT_TRUE(op_to_count["Gemm"] == 0);
   ASSERT_TRUE(op_to_count["com.microsoft.FusedGemm"] == 1);
 }
+
+// The Gelu family of activations is applied by MLAS in the SGEMM epilogue of FusedGemm.
+TEST_F(GraphTransformationTests, Gemm_Gelu_Fusion) {
+  struct TestCase {
+    std::string op_type;
+    std::string domain;
+    std::string approximate;
+    std::vector<int64_t> bias_shape;
+  };
+  const std::vector<TestCase> test_cases = {
+      {"Gelu", kOnnxDomain, "none", {16}},
+      {"Gelu", kOnnxDomain, "tanh", {1, 16}},
+      {"Gelu", kMSDomain, "", {8, 16}},
+      {"FastGelu", kMSDomain, "", {16}},
+      {"QuickGelu", kMSDomain, "", {16}},
+      {"Relu", kOnnxDomain, "", {8, 1}},
+  };
+
+  for (const auto& test_case : test_cases) {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<float>({8, 32}, -1.f, 1.f);
+      auto* weight_arg = builder.MakeInitializer<float>({32, 16}, -0.5f, 0.5f);
+      auto* bias_arg = builder.MakeInitializer<float>(test_case.bias_shape, -1.f, 1.f);
+      auto* gemm_out_arg = builder.MakeIntermediate();
+      auto* output_arg = builder.MakeOutput();
+
+      builder.AddNode("Gemm", {input_arg, weight_arg, bias_arg}, {gemm_out_arg});
+      auto& act_node = builder.AddNode(test_case.op_type, {gemm_out_arg}, {output_arg}, test_case.domain);
+      if (!test_case.approximate.empty()) {
+        act_node.AddAttribute("approximate", test_case.approximate);
+      }
+    };
+
+    auto check_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["Gemm"], 0);
+      EXPECT_EQ(op_to_count["com.microsoft.FusedGemm"], 1);
+    };
+
+    TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 20,
+                      1e-5, 1e-5);
+  }
+}
 #endif
 
 // (A')'B' = AB'
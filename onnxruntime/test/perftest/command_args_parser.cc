@@ -49,12 +49,17 @@ namespace perftest {
       "\t-S: Given random seed, to produce the same input data. This defaults to -1(no initialize).\n"
       "\t-v: Show verbose information.\n"
       "\t-x [intra_op_num_threads]: Sets the number of threads used to parallelize the execution within nodes, A value of 0 means ORT will pick a default. Must >=0.\n"
+      "\t-N: Split the intra-op thread pool across the NUMA nodes and interleave the large weights across them. "
+      "Compare with the results without -N and of -x with the number of cores of one node to measure the scaling "
+      "across sockets.\n"
       "\t-y [inter_op_num_threads]: Sets the number of threads used to parallelize the execution of the graph (across nodes), A value of 0 means ORT will pick a default. Must >=0.\n"
       "\t-f [free_dimension_override]: Specifies a free dimension by name to override to a specific value for performance optimization. "
       "Syntax is [dimension_name:override_value]. override_value must > 0\n"
       "\t-F [free_dimension_override]: Specifies a free dimension by denotation to override to a specific value for performance optimization. "
       "Syntax is [dimension_denotation:override_value]. override_value must > 0\n"
       "\t-P: Use parallel executor instead of sequential executor.\n"
+      "\t-W: Use the work stealing executor, which runs the nodes on the intra-op thread pool as soon as their inputs "
+      "are ready. Implies -P. Compare with the results of -P and of the sequential executor.\n"
       "\t-o [optimization level]: Default is 99 (all). Valid values are 0 (disable), 1 (basic), 2 (extended), 99 (all).\n"
       "\t\tPlease see onnxruntime_c_api.h (enum GraphOptimizationLevel) for the full list of all optimization levels.\n"
       "\t-u [optimized_model_path]: Specify the optimized model path for saving.\n"
@@ -210,7 +215,7 @@ static bool ParseSessionConfigs(const std::string& configs_string,
 
 /*static*/ bool CommandLineParser::ParseArguments(PerformanceTestConfig& test_config, int argc, ORTCHAR_T* argv[]) {
   int ch;
-  while ((ch = getopt(argc, argv, ORT_TSTR("m:e:r:t:p:x:y:c:d:o:u:i:f:F:S:T:C:AMPIDZvhsqznlR:"))) != -1) {
+  while ((ch = getopt(argc, argv, ORT_TSTR("m:e:r:t:p:x:y:c:d:o:u:i:f:F:S:T:C:AMPWNIDZvhsqznlR:"))) != -1) {
     switch (ch) {
       case 'f': {
         std::basic_string<ORTCHAR_T> dim_name;
@@ -328,6 +333,13 @@ static bool ParseSessionConfigs(const std::string& configs_string,
       case 'P':
         test_config.run_config.execution_mode = ExecutionMode::ORT_PARALLEL;
         break;
+      case 'W':
+        test_config.run_config.execution_mode = ExecutionMode::ORT_PARALLEL;
+        test_config.run_config.use_work_stealing_executor = true;
+        break;
+      case 'N':
+        test_config.run_config.numa_aware = true;
+        break;
       case 'c':
         test_config.run_config.concurrent_session_runs =
             static_cast<size_t>(OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr));
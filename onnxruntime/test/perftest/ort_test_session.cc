@@ -693,6 +693,18 @@ select from 'TF8', 'TF16', 'UINT8', 'FLOAT', 'ITENSOR'. \n)");
     session_options.RegisterCustomOpsLibrary(performance_test_config.run_config.register_custom_op_path.c_str());
   }
 
+  if (performance_test_config.run_config.use_work_stealing_executor) {
+    warn_dup_config_entry(kOrtSessionOptionsConfigUseWorkStealingExecutor);
+    fprintf(stdout, "Using the work stealing executor\n");
+    session_options.AddConfigEntry(kOrtSessionOptionsConfigUseWorkStealingExecutor, "1");
+  }
+
+  if (performance_test_config.run_config.numa_aware) {
+    warn_dup_config_entry(kOrtSessionOptionsConfigNumaAware);
+    fprintf(stdout, "Splitting the intra-op thread pool across the NUMA nodes\n");
+    session_options.AddConfigEntry(kOrtSessionOptionsConfigNumaAware, "1");
+  }
+
   if (performance_test_config.run_config.execution_mode == ExecutionMode::ORT_PARALLEL && performance_test_config.run_config.inter_op_num_threads > 0) {
     fprintf(stdout, "Setting inter_op_num_threads to %d\n", performance_test_config.run_config.inter_op_num_threads);
     session_options.SetInterOpNumThreads(performance_test_config.run_config.inter_op_num_threads);
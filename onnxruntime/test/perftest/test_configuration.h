@@ -50,7 +50,9 @@ struct RunConfig {
   bool enable_cpu_mem_arena{true};
   bool generate_model_input_binding{false};
   ExecutionMode execution_mode{ExecutionMode::ORT_SEQUENTIAL};
+  bool use_work_stealing_executor{false};
   int intra_op_num_threads{0};
+  bool numa_aware{false};
   int inter_op_num_threads{0};
   GraphOptimizationLevel optimization_level{ORT_ENABLE_ALL};
   std::basic_string<ORTCHAR_T> optimized_model_path;
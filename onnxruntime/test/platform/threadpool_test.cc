@@ -613,6 +613,34 @@ TEST(ThreadPoolTest, TestAffinityStringWellShaped) {
   }
 }
 
+TEST(ThreadPoolTest, TestNumaAffinityString) {
+  const auto numa_nodes = onnxruntime::Env::Default().GetNumaNodeProcessors();
+  if (numa_nodes.empty() || numa_nodes[0].empty()) {
+    return;
+  }
+
+  OrtThreadPoolParams tp_params;
+  tp_params.thread_pool_size = 3;
+  tp_params.affinity_str = "numa:0;numa:0";
+  auto tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                          tp_params,
+                                          concurrency::ThreadPoolType::INTRA_OP);
+  auto DOP = concurrency::ThreadPool::DegreeOfParallelism(tp.get());
+  ASSERT_TRUE(DOP >= 3 && DOP % 3 == 0);
+
+#ifndef ORT_NO_EXCEPTIONS
+  const std::string missing_node = "numa:" + std::to_string(numa_nodes.size());
+  const std::string wrong_formats[] = {"numa:;numa:0", "numa:a;numa:0", "numa:0;" + missing_node};
+  for (const auto& wrong_format : wrong_formats) {
+    tp_params.affinity_str = wrong_format;
+    ASSERT_THROW(concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                               tp_params,
+                                               concurrency::ThreadPoolType::INTRA_OP),
+                 std::exception);
+  }
+#endif
+}
+
 #ifdef _WIN32
 TEST(ThreadPoolTest, TestDefaultAffinity) {
   test::CpuGroup cpu_group = {{0, 1},
@@ -723,6 +723,33 @@ TEST_F(ActivationOpTest, ONNX_Gelu) {
       {},
       {{"approximate", "tanh"}}, true, 20);
 }
+
+// The CPU EP computes fp16 Gelu in fp32 when MlasFp16AccelerationSupported(), otherwise the graph is run
+// in fp32 with Cast nodes around it.
+TEST_F(ActivationOpTest, ONNX_Gelu_fp16) {
+  const std::vector<float> X{-6.0f, -3.0f, -1.5f, -0.5f, -0.125f, 0.0f, 0.125f, 0.5f, 1.5f, 3.0f, 6.0f, 10.0f};
+  std::vector<int64_t> dims{(int64_t)X.size()};
+
+  for (const char* approximate : {"none", "tanh"}) {
+    SCOPED_TRACE(approximate);
+
+    std::vector<float> Y;
+    for (float x : X) {
+      Y.push_back(approximate[0] == 'n'
+                      ? 0.5f * x * (1.0f + std::erf(x * static_cast<float>(M_SQRT1_2)))
+                      : 0.5f * x * (1.0f + std::tanh(std::sqrt(2.0f / static_cast<float>(M_PI)) *
+                                                     (x + 0.044715f * x * x * x))));
+    }
+
+    OpTester test("Gelu", 20);
+    test.AddAttribute("approximate", std::string(approximate));
+    test.AddInput<MLFloat16>("X", dims, FloatsToMLFloat16s(X));
+    test.AddOutput<MLFloat16>("Y", dims, FloatsToMLFloat16s(Y));
+    test.SetOutputTolerance(0.005f);
+    test.ConfigEp(DefaultCpuExecutionProvider())
+        .RunWithConfig();
+  }
+}
 #endif
 
 }  // namespace test
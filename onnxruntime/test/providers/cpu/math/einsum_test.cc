@@ -264,6 +264,15 @@ TEST(Einsum, ExplicitEinsumAsBatchedMatmulWithBroadcasting_1) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", ExcludeTrtOnA100());
 }
 
+TEST(Einsum, ExplicitEinsumAsBatchedMatmulWithEmptyBatch) {
+  OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
+  test.AddAttribute<std::string>("equation", "bij,bjk->bik");
+  test.AddInput<float>("x", {0, 2, 2}, {});
+  test.AddInput<float>("y", {0, 2, 2}, {});
+  test.AddOutput<float>("o", {0, 2, 2}, {});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 TEST(Einsum, ExplicitEinsumAsMatmul_OutputTransposed) {
   OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
   test.AddAttribute<std::string>("equation", "ij,jk->ki");
@@ -172,6 +172,64 @@ TEST(GemmOpTest, GemmTransB_f16) {
   }
 }
 
+// The CPU EP runs Gemm in fp16 when MlasFp16AccelerationSupported(). The MLAS half precision gemm handles
+// alpha == 1 without transposes and with no bias or a row of N biases, the other cases run the MLAS float gemm.
+TEST(GemmOpTest, GemmFloat16Cpu) {
+  constexpr int64_t M = 3, K = 5, N = 20;
+
+  std::vector<float> A(M * K), B(K * N), C(M * N);
+  for (size_t i = 0; i < A.size(); i++) A[i] = static_cast<float>(static_cast<int>(i % 7) - 3);
+  for (size_t i = 0; i < B.size(); i++) B[i] = static_cast<float>(static_cast<int>(i % 5) - 2);
+  for (size_t i = 0; i < C.size(); i++) C[i] = static_cast<float>(static_cast<int>(i % 3) - 1);
+
+  auto run_test = [&](bool trans_b, float alpha, float beta, const std::vector<int64_t>& c_dims) {
+    SCOPED_TRACE(MakeString("trans_b: ", trans_b, " alpha: ", alpha, " beta: ", beta, " c_dims: ",
+                            TensorShape(c_dims)));
+
+    // the values are small integers, so the fp16 results are exact
+    std::vector<float> Y(M * N);
+    for (int64_t m = 0; m < M; m++) {
+      for (int64_t n = 0; n < N; n++) {
+        float sum = 0.0f;
+        for (int64_t k = 0; k < K; k++) {
+          sum += A[m * K + k] * (trans_b ? B[n * K + k] : B[k * N + n]);
+        }
+        float bias = 0.0f;
+        if (!c_dims.empty()) {
+          const int64_t c_size = TensorShape(c_dims).Size();
+          bias = c_size == 1 ? C[0] : (c_size == N ? C[n] : C[m * N + n]);
+        }
+        Y[m * N + n] = alpha * sum + beta * bias;
+      }
+    }
+
+    OpTester test("Gemm", 13);
+    test.AddAttribute("transA", (int64_t)0);
+    test.AddAttribute("transB", (int64_t)(trans_b ? 1 : 0));
+    test.AddAttribute("alpha", alpha);
+    test.AddAttribute("beta", beta);
+    test.AddInput<MLFloat16>("A", {M, K}, FloatsToMLFloat16s(A));
+    test.AddInput<MLFloat16>("B", trans_b ? std::vector<int64_t>{N, K} : std::vector<int64_t>{K, N},
+                             FloatsToMLFloat16s(B));
+    if (!c_dims.empty()) {
+      std::vector<float> c(C.begin(), C.begin() + TensorShape(c_dims).Size());
+      test.AddInput<MLFloat16>("C", c_dims, FloatsToMLFloat16s(c));
+    }
+    test.AddOutput<MLFloat16>("Y", {M, N}, FloatsToMLFloat16s(Y));
+    test.ConfigEp(DefaultCpuExecutionProvider())
+        .RunWithConfig();
+  };
+
+  run_test(false, 1.0f, 1.0f, {});
+  run_test(false, 1.0f, 1.0f, {N});
+  run_test(false, 1.0f, 1.0f, {1, N});
+  run_test(false, 1.0f, 0.0f, {M, N});
+  run_test(false, 1.0f, 1.0f, {M, N});
+  run_test(false, 1.0f, 0.5f, {1});
+  run_test(false, 2.0f, 1.0f, {N});
+  run_test(true, 1.0f, 1.0f, {N});
+}
+
 #if defined(USE_CUDA) || defined(USE_ROCM) || defined(USE_DNNL)
 TEST(GemmOpTest, GemmNoTrans_bfloat16) {
 #ifdef USE_CUDA
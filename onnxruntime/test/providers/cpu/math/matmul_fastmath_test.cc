@@ -2,6 +2,7 @@
 // Copyright 2023 Amazon.com, Inc. or its affiliates. All Rights Reserved.
 // Licensed under the MIT License.
 
+#include "core/mlas/inc/mlas.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
@@ -11,13 +12,19 @@
 #include "test/common/tensor_op_test_utils.h"
 #include "default_providers.h"
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
 
 namespace onnxruntime {
 namespace test {
 
 namespace {
 
+#if defined(__aarch64__)
+const char* const kFastMathConfigKey = kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16;
+#else
+const char* const kFastMathConfigKey = kOrtSessionOptionsMlasGemmFastMathX64Bfloat16;
+#endif
+
 const onnxruntime::RunOptions run_options = []() {
   onnxruntime::RunOptions options{};
   ORT_THROW_IF_ERROR(options.config_options.AddConfigEntry(kOpTesterRunOptionsConfigTestTunableOp, "true"));
@@ -145,7 +152,7 @@ void RunMatMulTest(int32_t opset_version, bool is_a_constant, bool is_b_constant
 
     SessionOptions so;
     ASSERT_STATUS_OK(so.config_options.AddConfigEntry(
-        kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16, "1"));
+        kFastMathConfigKey, "1"));
 
     test.ConfigExcludeEps(excluded_providers)
         .Config(run_with_tunable_op)
@@ -154,7 +161,7 @@ void RunMatMulTest(int32_t opset_version, bool is_a_constant, bool is_b_constant
 
     if (disable_fastmath) {
       ASSERT_STATUS_OK(so.config_options.AddConfigEntry(
-          kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16, "0"));
+          kFastMathConfigKey, "0"));
 
       test.ConfigExcludeEps(excluded_providers)
           .Config(run_with_tunable_op)
@@ -237,7 +244,7 @@ TEST(MathOpTest, MatMulSharedPrepackedWeights_FastMath) {
   // Set up B as a shared initializer to be shared between sessions
   ASSERT_EQ(so.AddInitializer("B", &b), Status::OK());
   ASSERT_STATUS_OK(so.config_options.AddConfigEntry(
-      kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16, "1"));
+      kFastMathConfigKey, "1"));
 
   // We want all sessions running using this OpTester to be able to share pre-packed weights if applicable
   test.EnableSharingOfPrePackedWeightsAcrossSessions();
@@ -302,4 +309,4 @@ TEST(MathOpTest, MatMulUint64Type_DisableFastMath) {
 
 }  // namespace test
 }  // namespace onnxruntime
-#endif  // defined(__aarch64__) && defined(__linux__)
+#endif  // defined(MLAS_SBGEMM_SUPPORTED)
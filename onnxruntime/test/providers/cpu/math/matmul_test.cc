@@ -229,6 +229,26 @@ TEST(MathOpTest, MatMulFloat16) {
 }
 #endif
 
+// The CPU EP runs MatMul in fp16 when MlasFp16AccelerationSupported(), otherwise the graph is run in fp32
+// with Cast nodes around it. Both must give the same results for the small integers of the test cases.
+TEST(MathOpTest, MatMulFloat16Cpu) {
+  for (auto t : GenerateTestCases<MLFloat16>()) {
+    SCOPED_TRACE("test case: " + t.name);
+
+    OpTester test("MatMul", 13);
+
+    int64_t size0 = TensorShape::FromExistingBuffer(t.input0_dims).SizeHelper(0, t.input0_dims.size());
+    test.AddInput<MLFloat16>("A", t.input0_dims, ValueRange<MLFloat16>(size0));
+
+    int64_t size1 = TensorShape::FromExistingBuffer(t.input1_dims).SizeHelper(0, t.input1_dims.size());
+    test.AddInput<MLFloat16>("B", t.input1_dims, ValueRange<MLFloat16>(size1));
+
+    test.AddOutput<MLFloat16>("Y", t.expected_dims, t.expected_vals);
+    test.ConfigEp(DefaultCpuExecutionProvider())
+        .RunWithConfig();
+  }
+}
+
 TEST(MathOpTest, MatMulDoubleType) {
   RunMatMulTest<double>(7);
 }
@@ -430,6 +450,56 @@ TEST(MathOpTest, MatMulSharedPrepackedWeights) {
   }
 }
 
+// B is pre-packed in the block sparse format when most of its rows are zero.
+TEST(MathOpTest, MatMulBlockSparseWeights) {
+  constexpr int64_t batch = 2, M = 5, K = 12, N = 20;
+
+  std::vector<float> a_values(batch * M * K);
+  for (size_t i = 0; i < a_values.size(); i++) {
+    a_values[i] = static_cast<float>(static_cast<int>(i % 7) - 3);
+  }
+
+  // only rows 2 and 9 of B have nonzero values, and row 9 only in the second panel of 16 columns
+  std::vector<float> b_values(K * N, 0.0f);
+  for (int64_t n = 0; n < N; n++) {
+    b_values[2 * N + n] = static_cast<float>(n % 5) - 2.0f;
+  }
+  b_values[9 * N + 17] = 3.0f;
+
+  std::vector<float> y_values(batch * M * N, 0.0f);
+  for (int64_t m = 0; m < batch * M; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      for (int64_t k = 0; k < K; k++) {
+        y_values[m * N + n] += a_values[m * K + k] * b_values[k * N + n];
+      }
+    }
+  }
+
+  OpTester test("MatMul");
+  test.AddInput<float>("A", {batch, M, K}, a_values);
+  test.AddInput<float>("B", {K, N}, b_values, true);
+  test.AddOutput<float>("Y", {batch, M, N}, y_values);
+  test.ConfigEp(DefaultCpuExecutionProvider())
+      .RunWithConfig();
+
+  // The block sparse format is restored along with the pre-packed buffers shared between sessions.
+  OrtValue b;
+  Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape({K, N}),
+                       b_values.data(), OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator), b);
+  SessionOptions so;
+  ASSERT_EQ(so.AddInitializer("B", &b), Status::OK());
+  test.EnableSharingOfPrePackedWeightsAcrossSessions();
+
+  size_t number_of_pre_packed_weights_counter = 0;
+  size_t number_of_shared_pre_packed_weights_counter = 0;
+  for (size_t session = 0; session < 2; session++) {
+    test.Config(so)
+        .ConfigEp(DefaultCpuExecutionProvider())
+        .RunWithConfig(&number_of_pre_packed_weights_counter, &number_of_shared_pre_packed_weights_counter);
+  }
+  ASSERT_EQ(number_of_shared_pre_packed_weights_counter, number_of_pre_packed_weights_counter);
+}
+
 #endif
 
 }  // namespace test
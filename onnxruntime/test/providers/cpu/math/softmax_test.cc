@@ -177,6 +177,49 @@ TEST(SoftmaxOperator, ThreeAndFourDimsAxis0) {
           {kTensorrtExecutionProvider, kOpenVINOExecutionProvider, kDnnlExecutionProvider});
 }
 
+// The CPU EP computes fp16 Softmax in fp32 when MlasFp16AccelerationSupported(), otherwise the graph is run
+// in fp32 with Cast nodes around it.
+TEST(SoftmaxOperator, ThreeDims_fp16) {
+  // softmax along `axis` of the {3, 4, 5} input with the opset-13 semantics
+  auto reference = [](size_t axis, bool logarithmic) {
+    const size_t dims[] = {3, 4, 5};
+    size_t outer = 1, inner = 1;
+    for (size_t i = 0; i < axis; i++) outer *= dims[i];
+    for (size_t i = axis + 1; i < 3; i++) inner *= dims[i];
+
+    std::vector<float> y(input_vals_60.size());
+    for (size_t o = 0; o < outer; o++) {
+      for (size_t i = 0; i < inner; i++) {
+        const size_t base = o * dims[axis] * inner + i;
+        float max = input_vals_60[base];
+        for (size_t d = 0; d < dims[axis]; d++) max = std::max(max, input_vals_60[base + d * inner]);
+        float sum = 0.0f;
+        for (size_t d = 0; d < dims[axis]; d++) sum += std::exp(input_vals_60[base + d * inner] - max);
+        for (size_t d = 0; d < dims[axis]; d++) {
+          const float x = input_vals_60[base + d * inner] - max;
+          y[base + d * inner] = logarithmic ? x - std::log(sum) : std::exp(x) / sum;
+        }
+      }
+    }
+    return y;
+  };
+
+  for (const char* op : {"Softmax", "LogSoftmax"}) {
+    for (int64_t axis : {1, 2}) {
+      SCOPED_TRACE(MakeString(op, " axis: ", axis));
+
+      OpTester test(op, 13);
+      test.AddAttribute("axis", axis);
+      test.AddInput<MLFloat16>("X", three_dimensions, FloatsToMLFloat16s(input_vals_60));
+      test.AddOutput<MLFloat16>("Y", three_dimensions,
+                                FloatsToMLFloat16s(reference(static_cast<size_t>(axis), op[0] == 'L')));
+      test.SetOutputTolerance(0.005f);
+      test.ConfigEp(DefaultCpuExecutionProvider())
+          .RunWithConfig();
+    }
+  }
+}
+
 TEST(SoftmaxOperator, ThreeAndFourDimsSecondLastAxis) {
   // x = <see input_vals_60>
   // node = onnx.helper.make_node('Softmax', inputs = ['x'], outputs = ['y'], axis = 1)
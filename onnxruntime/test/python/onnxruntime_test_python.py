@@ -684,6 +684,35 @@ class TestInferenceSession(unittest.TestCase):
         if "ROCMExecutionProvider" in onnxrt.get_available_providers():
             do_test_get_and_set_tuning_results("ROCMExecutionProvider")
 
+        do_test_get_and_set_tuning_results("CPUExecutionProvider")
+
+    def test_cpu_tunable_op(self):
+        so = onnxrt.SessionOptions()
+        so.add_session_config_entry("session.cpu_tunable_op_enable", "1")
+        so.add_session_config_entry("session.cpu_tunable_op_tuning_enable", "1")
+        sess = onnxrt.InferenceSession(get_name("matmul_1.onnx"), so, providers=["CPUExecutionProvider"])
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        output_expected = np.array([[5.0], [11.0], [17.0]], dtype=np.float32)
+        for _ in range(2):
+            res = sess.run(["Y"], {"X": x})
+            np.testing.assert_allclose(output_expected, res[0], rtol=1e-05, atol=1e-08)
+
+        tuning_results = [t for t in sess.get_tuning_results() if t.get("ep") == "CPUExecutionProvider"]
+        self.assertEqual(len(tuning_results), 1)
+        self.assertIn("CPU_ISA", tuning_results[0]["validators"])
+        self.assertIn("CPU_CORES", tuning_results[0]["validators"])
+        sgemm_results = [r for op_sig, r in tuning_results[0]["results"].items() if "SgemmTunableOp" in op_sig]
+        self.assertEqual(len(sgemm_results), 1)
+        self.assertEqual(len(sgemm_results[0]), 1)
+
+        # the tuned partitioning is reused by a session that does not tune
+        so = onnxrt.SessionOptions()
+        so.add_session_config_entry("session.cpu_tunable_op_enable", "1")
+        sess = onnxrt.InferenceSession(get_name("matmul_1.onnx"), so, providers=["CPUExecutionProvider"])
+        sess.set_tuning_results(tuning_results, error_on_invalid=True)
+        res = sess.run(["Y"], {"X": x})
+        np.testing.assert_allclose(output_expected, res[0], rtol=1e-05, atol=1e-08)
+
     def test_run_model_with_optional_sequence_input(self):
         sess = onnxrt.InferenceSession(get_name("identity_opt.onnx"))
         x = [np.array([1, 2, 3, 4, 5]).astype(np.float32)]
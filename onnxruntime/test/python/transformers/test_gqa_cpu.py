@@ -506,6 +506,96 @@ def create_group_query_attention_graph_past(
     return model.SerializeToString()
 
 
+def create_group_query_attention_graph_paged(
+    config,
+    num_blocks,
+    block_size,
+    max_blocks_per_sequence,
+    local_window_size=-1,
+    packed=False,
+):
+    nodes = [
+        helper.make_node(
+            "GroupQueryAttention",
+            [
+                "query",
+                "key" if not packed else "",
+                "value" if not packed else "",
+                "past_key",
+                "past_value",
+                "seqlens_k",
+                "total_sequence_length",
+                "",
+                "",
+                "block_table",
+            ],
+            ["output", "present_key", "present_value"],
+            "GroupQueryAttention_0",
+            num_heads=config.num_heads,
+            kv_num_heads=config.kv_num_heads,
+            local_window_size=local_window_size,
+            domain="com.microsoft",
+        ),
+    ]
+
+    pool_shape = [num_blocks, config.kv_num_heads, block_size, config.head_size]
+    graph_input = [
+        helper.make_tensor_value_info(
+            "query",
+            ORT_TYPE,
+            [
+                config.batch_size,
+                config.sequence_length,
+                (
+                    (config.num_heads * config.head_size)
+                    if not packed
+                    else (config.num_heads * config.head_size + 2 * config.kv_num_heads * config.head_size)
+                ),
+            ],
+        ),
+        helper.make_tensor_value_info("past_key", ORT_TYPE, pool_shape),
+        helper.make_tensor_value_info("past_value", ORT_TYPE, pool_shape),
+        helper.make_tensor_value_info("seqlens_k", TensorProto.INT32, [config.batch_size]),
+        helper.make_tensor_value_info("total_sequence_length", TensorProto.INT32, [1]),
+        helper.make_tensor_value_info(
+            "block_table", TensorProto.INT32, [config.batch_size, max_blocks_per_sequence]
+        ),
+    ]
+    if not packed:
+        graph_input += [
+            helper.make_tensor_value_info(
+                "key",
+                ORT_TYPE,
+                [config.batch_size, config.sequence_length, config.kv_num_heads * config.head_size],
+            ),
+            helper.make_tensor_value_info(
+                "value",
+                ORT_TYPE,
+                [config.batch_size, config.sequence_length, config.kv_num_heads * config.head_size],
+            ),
+        ]
+
+    graph_output = [
+        helper.make_tensor_value_info(
+            "output",
+            ORT_TYPE,
+            [config.batch_size, config.sequence_length, config.num_heads * config.head_size],
+        ),
+        helper.make_tensor_value_info("present_key", ORT_TYPE, pool_shape),
+        helper.make_tensor_value_info("present_value", ORT_TYPE, pool_shape),
+    ]
+
+    graph = helper.make_graph(
+        nodes,
+        "GroupQueryAttention_Graph",
+        graph_input,
+        graph_output,
+    )
+
+    model = helper.make_model(graph)
+    return model.SerializeToString()
+
+
 def generate_random_padding_mask(max_seqlen, batch_size, device, mode="random"):
     assert mode in ["full", "random", "third"]
     if mode == "full":
@@ -1896,6 +1986,185 @@ def parity_check_gqa_past_no_buff(
     return all_close
 
 
+def parity_check_gqa_paged(
+    config,
+    block_size,
+    local=False,
+    packed=False,
+    prompt=False,
+    rtol=RTOL,
+    atol=ATOL,
+):
+    # config.kv_sequence_length is the capacity of each sequence, a multiple of block_size
+    max_blocks_per_sequence = config.kv_sequence_length // block_size
+    num_blocks = config.batch_size * max_blocks_per_sequence + 3
+    q = torch.randn(
+        config.batch_size, config.sequence_length, config.num_heads, config.head_size, device="cpu", dtype=TORCH_TYPE
+    )
+    new_k = torch.randn(
+        config.batch_size, config.sequence_length, config.kv_num_heads, config.head_size, device="cpu", dtype=TORCH_TYPE
+    )
+    new_v = torch.randn(
+        config.batch_size, config.sequence_length, config.kv_num_heads, config.head_size, device="cpu", dtype=TORCH_TYPE
+    )
+    # contiguous caches in BNSH format
+    k = torch.randn(
+        config.batch_size,
+        config.kv_num_heads,
+        config.kv_sequence_length,
+        config.head_size,
+        device="cpu",
+        dtype=TORCH_TYPE,
+    )
+    v = torch.randn(
+        config.batch_size,
+        config.kv_num_heads,
+        config.kv_sequence_length,
+        config.head_size,
+        device="cpu",
+        dtype=TORCH_TYPE,
+    )
+    if prompt:
+        cache_seqlens = torch.zeros(config.batch_size, dtype=torch.int32, device="cpu")
+    else:
+        cache_seqlens = torch.randint(
+            0,
+            config.kv_sequence_length - config.sequence_length + 1,
+            (config.batch_size,),
+            dtype=torch.int32,
+            device="cpu",
+        )
+
+    window_size = (-1, 0)
+    left_window_size = -1
+    if local:
+        left_window_size = random.randint(1, config.kv_sequence_length)
+        window_size = (left_window_size, 0)
+
+    # Pytorch to compare
+    k_cache_ref = k.clone().transpose(1, 2)
+    v_cache_ref = v.clone().transpose(1, 2)
+    arange = rearrange(torch.arange(config.kv_sequence_length, device="cpu"), "s -> 1 s")
+    cache_seqlens_expanded = rearrange(cache_seqlens, "b -> b 1")
+    update_mask = torch.logical_and(
+        cache_seqlens_expanded <= arange, arange < cache_seqlens_expanded + config.sequence_length
+    )
+    k_cache_ref[update_mask] = rearrange(new_k, "b s ... -> (b s) ...")
+    v_cache_ref[update_mask] = rearrange(new_v, "b s ... -> (b s) ...")
+    k_cache_rep = repeat(k_cache_ref, "b s h d -> b s (h g) d", g=config.num_heads // config.kv_num_heads)
+    v_cache_rep = repeat(v_cache_ref, "b s h d -> b s (h g) d", g=config.num_heads // config.kv_num_heads)
+    key_padding_mask = arange < cache_seqlens_expanded + config.sequence_length
+    out_ref, _ = attention_ref(
+        q,
+        k_cache_rep,
+        v_cache_rep,
+        None,
+        key_padding_mask,
+        0.0,
+        None,
+        causal=True,
+        window_size=window_size,
+    )
+    out_ref = out_ref.detach().cpu().numpy()
+    k_cache_ref = k_cache_ref.transpose(1, 2).detach().cpu().numpy()
+    v_cache_ref = v_cache_ref.transpose(1, 2).detach().cpu().numpy()
+
+    # Scatter the caches to pages of the pools in random order
+    block_table = (
+        torch.randperm(num_blocks)[: config.batch_size * max_blocks_per_sequence]
+        .reshape(config.batch_size, max_blocks_per_sequence)
+        .to(torch.int32)
+    )
+    k_pool = torch.randn(num_blocks, config.kv_num_heads, block_size, config.head_size, dtype=TORCH_TYPE)
+    v_pool = torch.randn(num_blocks, config.kv_num_heads, block_size, config.head_size, dtype=TORCH_TYPE)
+    for b in range(config.batch_size):
+        for i in range(max_blocks_per_sequence):
+            k_pool[block_table[b, i]] = k[b, :, i * block_size : (i + 1) * block_size, :]
+            v_pool[block_table[b, i]] = v[b, :, i * block_size : (i + 1) * block_size, :]
+
+    # ORT function
+    onnx_model_str = create_group_query_attention_graph_paged(
+        config, num_blocks, block_size, max_blocks_per_sequence, left_window_size, packed
+    )
+    if packed:
+        query = torch.concatenate([q, new_k, new_v], dim=2)
+    else:
+        query = q
+    query = torch.reshape(query, (config.batch_size, config.sequence_length, -1)).detach().cpu().numpy()
+    past_key = OrtValue.ortvalue_from_numpy(k_pool.detach().cpu().numpy(), "cpu", 0)
+    past_value = OrtValue.ortvalue_from_numpy(v_pool.detach().cpu().numpy(), "cpu", 0)
+    seqlens_k = (cache_seqlens + config.sequence_length - 1).detach().cpu().numpy().astype(numpy.int32)
+    total_sequence_length = numpy.array([int(cache_seqlens.max()) + config.sequence_length], dtype=numpy.int32)
+    block_table_np = block_table.detach().cpu().numpy()
+
+    ort_session = InferenceSession(onnx_model_str, SessionOptions(), providers=["CPUExecutionProvider"])
+    io_binding = ort_session.io_binding()
+    io_binding.bind_cpu_input("query", query)
+    if not packed:
+        io_binding.bind_cpu_input(
+            "key", torch.reshape(new_k, (config.batch_size, config.sequence_length, -1)).detach().cpu().numpy()
+        )
+        io_binding.bind_cpu_input(
+            "value", torch.reshape(new_v, (config.batch_size, config.sequence_length, -1)).detach().cpu().numpy()
+        )
+    io_binding.bind_ortvalue_input("past_key", past_key)
+    io_binding.bind_ortvalue_input("past_value", past_value)
+    io_binding.bind_cpu_input("seqlens_k", seqlens_k)
+    io_binding.bind_cpu_input("total_sequence_length", total_sequence_length)
+    io_binding.bind_cpu_input("block_table", block_table_np)
+    io_binding.bind_output("output")
+    io_binding.bind_ortvalue_output("present_key", past_key)
+    io_binding.bind_ortvalue_output("present_value", past_value)
+    ort_session.run_with_iobinding(io_binding)
+    out = io_binding.copy_outputs_to_cpu()[0]
+    out = numpy.reshape(out, (config.batch_size, config.sequence_length, config.num_heads, config.head_size))
+
+    # Gather the pages of each sequence to check the new tokens are written in place
+    def gather_pages(pool):
+        return numpy.stack(
+            [
+                pool[block_table_np[b]]
+                .transpose(1, 0, 2, 3)
+                .reshape(config.kv_num_heads, config.kv_sequence_length, config.head_size)
+                for b in range(config.batch_size)
+            ]
+        )
+
+    assert numpy.allclose(gather_pages(past_key.numpy()), k_cache_ref, rtol=rtol, atol=atol, equal_nan=True)
+    assert numpy.allclose(gather_pages(past_value.numpy()), v_cache_ref, rtol=rtol, atol=atol, equal_nan=True)
+
+    # Compare results
+    all_close = numpy.allclose(out, out_ref, rtol=rtol, atol=atol, equal_nan=True)
+    correct = GREEN + "True" + RESET if all_close else RED + "False" + RESET
+    print(
+        "Paged KV-cache",
+        " block size:",
+        block_size,
+        " prompt:",
+        prompt,
+        " packed:",
+        packed,
+        " local:",
+        local,
+        " B:",
+        config.batch_size,
+        " S:",
+        config.sequence_length,
+        " kv S:",
+        config.kv_sequence_length,
+        " N:",
+        config.num_heads,
+        " kv N:",
+        config.kv_num_heads,
+        " h:",
+        config.head_size,
+        " Mean Error:",
+        numpy.mean(numpy.abs(out - out_ref)),
+        correct,
+    )
+    return all_close
+
+
 class TestGQA(unittest.TestCase):
     def test_gqa_no_past(self):
         torch.manual_seed(69)
@@ -2069,6 +2338,30 @@ class TestGQA(unittest.TestCase):
                                     )
                                     self.assertTrue(all_close)
 
+    def test_gqa_paged_kv_cache(self):
+        print("-------- TEST GQA PAGED KV CACHE ---------")
+        # (batch size, sequence length, capacity per sequence, prompt)
+        seqs = [(3, 1, 128, False), (2, 64, 128, True)]
+        num_h = [(9, 3)] if pipeline_mode else [(6, 6), (6, 3), (9, 9), (9, 3), (32, 8)]
+        h_sizes = [64] if pipeline_mode else [32, 64, 128]
+        block_sizes = [16, 32] if pipeline_mode else [1, 16, 32, 128]
+        random.seed(69)
+        for b, s, s2, prompt in seqs:
+            for n, n2 in num_h:
+                for h in h_sizes:
+                    for block_size in block_sizes:
+                        for local in [False, True]:
+                            for packed in [False, True]:
+                                config = Config(b, s, s2, -1, n, n2, h)
+                                all_close = parity_check_gqa_paged(
+                                    config,
+                                    block_size,
+                                    local=local,
+                                    packed=packed,
+                                    prompt=prompt,
+                                )
+                                self.assertTrue(all_close)
+
 
 if __name__ == "__main__":
     unittest.main()